@@ -25,6 +25,7 @@
 #include "TelepathyQt/_gen/abstract-interface.moc.hpp"
 
 #include "TelepathyQt/debug-internal.h"
+#include "TelepathyQt/peer-transport-internal.h"
 
 #include <TelepathyQt/Constants>
 #include <TelepathyQt/DBusProxy>
@@ -70,8 +71,8 @@ AbstractInterface::AbstractInterface(const QString &busName,
 }
 
 AbstractInterface::AbstractInterface(DBusProxy *parent, const QLatin1String &interface)
-    : QDBusAbstractInterface(parent->busName(), parent->objectPath(),
-            interface.latin1(), parent->dbusConnection(), parent),
+    : QDBusAbstractInterface(PeerTransport::serviceFor(parent), parent->objectPath(),
+            interface.latin1(), PeerTransport::connectionFor(parent), parent),
       mPriv(new Private)
 {
     connect(parent, SIGNAL(invalidated(Tp::DBusProxy*,QString,QString)),
@@ -176,7 +177,7 @@ void AbstractInterface::setMonitorProperties(bool monitorProperties)
     }
 
     if (!success) {
-        warning() << "Connection or disconnection to " << TP_QT_IFACE_PROPERTIES <<
+        tpWarning(logGeneral) << "Connection or disconnection to " << TP_QT_IFACE_PROPERTIES <<
                 ".PropertiesChanged failed.";
     }
 }
@@ -35,6 +35,7 @@
 #include <TelepathyQt/PendingAccount>
 #include <TelepathyQt/PendingComposite>
 #include <TelepathyQt/PendingReady>
+#include <TelepathyQt/PendingSuccess>
 #include <TelepathyQt/ReadinessHelper>
 
 #include <QQueue>
@@ -81,6 +82,7 @@ struct TP_QT_NO_EXPORT AccountManager::Private
     // Introspection
     int reintrospectionRetries;
     bool gotInitialAccounts;
+    bool lazyAccounts;
     QHash<QString, AccountPtr> incompleteAccounts;
     QHash<QString, AccountPtr> accounts;
     QStringList supportedAccountProperties;
@@ -101,20 +103,24 @@ AccountManager::Private::Private(AccountManager *parent,
       chanFactory(chanFactory),
       contactFactory(contactFactory),
       reintrospectionRetries(0),
-      gotInitialAccounts(false)
+      gotInitialAccounts(false),
+      lazyAccounts(false)
 {
-    debug() << "Creating new AccountManager:" << parent->busName();
+    tpDebug(logAccounts) << "Creating new AccountManager:" << parent->busName();
 
     if (accFactory->dbusConnection().name() != parent->dbusConnection().name()) {
-        warning() << "  The D-Bus connection in the account factory is not the proxy connection";
+        tpWarning(logAccounts) <<
+            "  The D-Bus connection in the account factory is not the proxy connection";
     }
 
     if (connFactory->dbusConnection().name() != parent->dbusConnection().name()) {
-        warning() << "  The D-Bus connection in the connection factory is not the proxy connection";
+        tpWarning(logAccounts) <<
+            "  The D-Bus connection in the connection factory is not the proxy connection";
     }
 
     if (chanFactory->dbusConnection().name() != parent->dbusConnection().name()) {
-        warning() << "  The D-Bus connection in the channel factory is not the proxy connection";
+        tpWarning(logAccounts) <<
+            "  The D-Bus connection in the channel factory is not the proxy connection";
     }
 
     ReadinessHelper::Introspectables introspectables;
@@ -155,7 +161,7 @@ void AccountManager::Private::init()
 
 void AccountManager::Private::introspectMain(AccountManager::Private *self)
 {
-    debug() << "Calling Properties::GetAll(AccountManager)";
+    tpDebug(logAccounts) << "Calling Properties::GetAll(AccountManager)";
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
             self->properties->GetAll(
                 TP_QT_IFACE_ACCOUNT_MANAGER),
@@ -185,7 +191,7 @@ QSet<QString> AccountManager::Private::getAccountPathsFromProp(
          * an array of object paths? */
         QStringList wronglyTypedPaths = qdbus_cast<QStringList>(prop);
         if (wronglyTypedPaths.size() > 0) {
-            warning() << "AccountManager returned wrong type for"
+            tpWarning(logAccounts) << "AccountManager returned wrong type for"
                 "Valid/InvalidAccounts (expected 'ao', got 'as'); "
                 "working around it";
             foreach (QString path, wronglyTypedPaths) {
@@ -223,6 +229,20 @@ void AccountManager::Private::addAccountForPath(const QString &path)
     AccountPtr account(AccountPtr::qObjectCast(readyOp->proxy()));
     Q_ASSERT(!account.isNull());
 
+    if (lazyAccounts) {
+        // The account is exposed right away, without waiting for the factory to make it
+        // ready. It stays a stub proxy until then, or until the application makes it ready
+        // (see prefetchAccounts())
+        parent->connect(readyOp,
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(onLazyAccountReady(Tp::PendingOperation*)));
+        accounts.insert(path, account);
+        if (parent->isReady(FeatureCore)) {
+            emit parent->newAccount(account);
+        }
+        return;
+    }
+
     parent->connect(readyOp,
             SIGNAL(finished(Tp::PendingOperation*)),
             SLOT(onAccountReady(Tp::PendingOperation*)));
@@ -236,6 +256,12 @@ void AccountManager::Private::addAccountForPath(const QString &path)
  *
  * \brief The AccountManager class represents a Telepathy account manager.
  *
+ * Every account is made ready with the features of the AccountFactory used by
+ * the account manager before FeatureCore completes, which costs several
+ * D-Bus round trips per account. Applications that only need a few of the
+ * accounts, such as a tool listing account names or a UI showing the visible
+ * ones, can enable lazy accounts with setLazyAccountsEnabled() instead.
+ *
  * The remote object accessor functions on this object (allAccounts(),
  * validAccounts(), and so on) don't make any D-Bus calls; instead, they return/use
  * values cached from a previous introspection run. The introspection process
@@ -250,8 +276,8 @@ void AccountManager::Private::addAccountForPath(const QString &path)
  * with the desired set of features as an argument (currently only AccountManager::FeatureCore is
  * supported), and waiting for the resulting PendingOperation to finish.
  *
- * All accounts returned by AccountManager are guaranteed to have the features set in the
- * AccountFactory used by it ready.
+ * Unless lazy accounts are enabled, all accounts returned by AccountManager are guaranteed to
+ * have the features set in the AccountFactory used by it ready.
  *
  * A signal is emitted to indicate that accounts are added. See newCreated() for more details.
  *
@@ -507,6 +533,49 @@ ContactFactoryConstPtr AccountManager::contactFactory() const
     return mPriv->contactFactory;
 }
 
+/**
+ * Return whether the accounts are exposed before they are ready.
+ *
+ * \return \c true if lazy accounts are enabled, \c false otherwise.
+ * \sa setLazyAccountsEnabled()
+ */
+bool AccountManager::isLazyAccountsEnabled() const
+{
+    return mPriv->lazyAccounts;
+}
+
+/**
+ * Set whether the accounts should be exposed before they are ready.
+ *
+ * By default, every account is made ready with the features of the AccountFactory
+ * used by this account manager before FeatureCore completes and before newAccount()
+ * is emitted for it.
+ *
+ * When this is enabled, the accounts are still built by the AccountFactory, but
+ * FeatureCore completes as soon as the list of accounts is known, and newAccount() is
+ * emitted as soon as an account appears. Together with an AccountFactory with no
+ * features, this saves the introspection of the accounts the application is not
+ * interested in: the Account objects are then stub proxies until they are made
+ * ready, for example in batches with prefetchAccounts(). Note that the account sets
+ * filtering on account properties, such as validAccounts() or enabledAccounts(), only
+ * see the accounts which were made ready with Account::FeatureCore.
+ *
+ * This must be set before FeatureCore is made ready.
+ *
+ * \param enabled Whether to enable lazy accounts.
+ * \sa isLazyAccountsEnabled()
+ */
+void AccountManager::setLazyAccountsEnabled(bool enabled)
+{
+    if (mPriv->gotInitialAccounts) {
+        tpWarning(logAccounts) << "AccountManager::setLazyAccountsEnabled() called after "
+            "the accounts were retrieved, ignoring";
+        return;
+    }
+
+    mPriv->lazyAccounts = enabled;
+}
+
 /**
  * Return a list containing all accounts.
  *
@@ -623,7 +692,8 @@ AccountSetPtr AccountManager::offlineAccounts() const
 AccountSetPtr AccountManager::textChatAccounts() const
 {
     if (!accountFactory()->features().contains(Account::FeatureCapabilities)) {
-        warning() << "Account filtering by capabilities can only be used with an AccountFactory"
+        tpWarning(logAccounts) <<
+            "Account filtering by capabilities can only be used with an AccountFactory"
             << "which makes Account::FeatureCapabilities ready";
         return filterAccounts(AccountFilterConstPtr());
     }
@@ -647,7 +717,8 @@ AccountSetPtr AccountManager::textChatAccounts() const
 AccountSetPtr AccountManager::textChatroomAccounts() const
 {
     if (!accountFactory()->features().contains(Account::FeatureCapabilities)) {
-        warning() << "Account filtering by capabilities can only be used with an AccountFactory"
+        tpWarning(logAccounts) <<
+            "Account filtering by capabilities can only be used with an AccountFactory"
             << "which makes Account::FeatureCapabilities ready";
         return filterAccounts(AccountFilterConstPtr());
     }
@@ -671,7 +742,8 @@ AccountSetPtr AccountManager::textChatroomAccounts() const
 AccountSetPtr AccountManager::audioCallAccounts() const
 {
     if (!accountFactory()->features().contains(Account::FeatureCapabilities)) {
-        warning() << "Account filtering by capabilities can only be used with an AccountFactory"
+        tpWarning(logAccounts) <<
+            "Account filtering by capabilities can only be used with an AccountFactory"
             << "which makes Account::FeatureCapabilities ready";
         return filterAccounts(AccountFilterConstPtr());
     }
@@ -695,7 +767,8 @@ AccountSetPtr AccountManager::audioCallAccounts() const
 AccountSetPtr AccountManager::videoCallAccounts() const
 {
     if (!accountFactory()->features().contains(Account::FeatureCapabilities)) {
-        warning() << "Account filtering by capabilities can only be used with an AccountFactory"
+        tpWarning(logAccounts) <<
+            "Account filtering by capabilities can only be used with an AccountFactory"
             << "which makes Account::FeatureCapabilities ready";
         return filterAccounts(AccountFilterConstPtr());
     }
@@ -719,7 +792,8 @@ AccountSetPtr AccountManager::videoCallAccounts() const
 AccountSetPtr AccountManager::streamedMediaCallAccounts() const
 {
     if (!accountFactory()->features().contains(Account::FeatureCapabilities)) {
-        warning() << "Account filtering by capabilities can only be used with an AccountFactory"
+        tpWarning(logAccounts) <<
+            "Account filtering by capabilities can only be used with an AccountFactory"
             << "which makes Account::FeatureCapabilities ready";
         return filterAccounts(AccountFilterConstPtr());
     }
@@ -743,7 +817,8 @@ AccountSetPtr AccountManager::streamedMediaCallAccounts() const
 AccountSetPtr AccountManager::streamedMediaAudioCallAccounts() const
 {
     if (!accountFactory()->features().contains(Account::FeatureCapabilities)) {
-        warning() << "Account filtering by capabilities can only be used with an AccountFactory"
+        tpWarning(logAccounts) <<
+            "Account filtering by capabilities can only be used with an AccountFactory"
             << "which makes Account::FeatureCapabilities ready";
         return filterAccounts(AccountFilterConstPtr());
     }
@@ -767,7 +842,8 @@ AccountSetPtr AccountManager::streamedMediaAudioCallAccounts() const
 AccountSetPtr AccountManager::streamedMediaVideoCallAccounts() const
 {
     if (!accountFactory()->features().contains(Account::FeatureCapabilities)) {
-        warning() << "Account filtering by capabilities can only be used with an AccountFactory"
+        tpWarning(logAccounts) <<
+            "Account filtering by capabilities can only be used with an AccountFactory"
             << "which makes Account::FeatureCapabilities ready";
         return filterAccounts(AccountFilterConstPtr());
     }
@@ -791,7 +867,8 @@ AccountSetPtr AccountManager::streamedMediaVideoCallAccounts() const
 AccountSetPtr AccountManager::streamedMediaVideoCallWithAudioAccounts() const
 {
     if (!accountFactory()->features().contains(Account::FeatureCapabilities)) {
-        warning() << "Account filtering by capabilities can only be used with an AccountFactory"
+        tpWarning(logAccounts) <<
+            "Account filtering by capabilities can only be used with an AccountFactory"
             << "which makes Account::FeatureCapabilities ready";
         return filterAccounts(AccountFilterConstPtr());
     }
@@ -816,7 +893,8 @@ AccountSetPtr AccountManager::streamedMediaVideoCallWithAudioAccounts() const
 AccountSetPtr AccountManager::fileTransferAccounts() const
 {
     if (!accountFactory()->features().contains(Account::FeatureCapabilities)) {
-        warning() << "Account filtering by capabilities can only be used with an AccountFactory"
+        tpWarning(logAccounts) <<
+            "Account filtering by capabilities can only be used with an AccountFactory"
             << "which makes Account::FeatureCapabilities ready";
         return filterAccounts(AccountFilterConstPtr());
     }
@@ -839,7 +917,7 @@ AccountSetPtr AccountManager::accountsByProtocol(
         const QString &protocolName) const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "Account filtering requires AccountManager to be ready";
+        tpWarning(logAccounts) << "Account filtering requires AccountManager to be ready";
         return filterAccounts(AccountFilterConstPtr());
     }
 
@@ -865,7 +943,7 @@ AccountSetPtr AccountManager::accountsByProtocol(
 AccountSetPtr AccountManager::filterAccounts(const AccountFilterConstPtr &filter) const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "Account filtering requires AccountManager to be ready";
+        tpWarning(logAccounts) << "Account filtering requires AccountManager to be ready";
         return AccountSetPtr(new AccountSet(AccountManagerPtr(
                         (AccountManager *) this), AccountFilterConstPtr()));
     }
@@ -921,7 +999,7 @@ AccountSetPtr AccountManager::filterAccounts(const AccountFilterConstPtr &filter
 AccountSetPtr AccountManager::filterAccounts(const QVariantMap &filter) const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "Account filtering requires AccountManager to be ready";
+        tpWarning(logAccounts) << "Account filtering requires AccountManager to be ready";
         return AccountSetPtr(new AccountSet(AccountManagerPtr(
                         (AccountManager *) this), QVariantMap()));
     }
@@ -991,6 +1069,40 @@ QList<AccountPtr> AccountManager::accountsForPaths(const QStringList &paths) con
     return accountsForObjectPaths(paths);
 }
 
+/**
+ * Make \a accounts ready with \a features, in addition to the features set in
+ * the AccountFactory used by this account manager.
+ *
+ * The introspection of all the accounts is started at once, so that their D-Bus
+ * round trips overlap. This is mainly useful with lazy accounts (see
+ * setLazyAccountsEnabled()), to only introspect the accounts the application is
+ * interested in, such as the ones it is about to display.
+ *
+ * \param accounts The accounts to make ready.
+ * \param features The account features to make ready.
+ * \return A PendingOperation which will emit PendingOperation::finished
+ *         when all the accounts are ready or failed to become ready.
+ */
+PendingOperation *AccountManager::prefetchAccounts(const QList<AccountPtr> &accounts,
+        const Features &features)
+{
+    Features requested = accountFactory()->features();
+    requested.unite(features);
+
+    QList<PendingOperation *> ops;
+    foreach (const AccountPtr &account, accounts) {
+        if (account && !account->isReady(requested)) {
+            ops.append(account->becomeReady(requested));
+        }
+    }
+
+    if (ops.isEmpty()) {
+        return new PendingSuccess(AccountManagerPtr(this));
+    }
+
+    return new PendingComposite(ops, false, AccountManagerPtr(this));
+}
+
 /**
  * Return a list of the fully qualified names of properties that can be set
  * when calling createAccount().
@@ -1057,7 +1169,7 @@ void AccountManager::gotMainProperties(QDBusPendingCallWatcher *watcher)
     if (!reply.isError()) {
         mPriv->gotInitialAccounts = true;
 
-        debug() << "Got reply to Properties.GetAll(AccountManager)";
+        tpDebug(logAccounts) << "Got reply to Properties.GetAll(AccountManager)";
         props = reply.value();
 
         if (props.contains(QLatin1String("Interfaces"))) {
@@ -1084,7 +1196,7 @@ void AccountManager::gotMainProperties(QDBusPendingCallWatcher *watcher)
             }
             QTimer::singleShot(retryInterval, this, SLOT(introspectMain()));
         } else {
-            warning() << "GetAll(AccountManager) failed with" <<
+            tpWarning(logAccounts) << "GetAll(AccountManager) failed with" <<
                 reply.error().name() << ":" << reply.error().message();
             mPriv->readinessHelper->setIntrospectCompleted(FeatureCore,
                     false, reply.error());
@@ -1121,6 +1233,15 @@ void AccountManager::onAccountReady(Tp::PendingOperation *op)
     mPriv->checkIntrospectionCompleted();
 }
 
+void AccountManager::onLazyAccountReady(Tp::PendingOperation *op)
+{
+    if (op->isError()) {
+        PendingReady *pr = qobject_cast<PendingReady*>(op);
+        tpWarning(logAccounts) << "Making account" << pr->proxy()->objectPath() <<
+            "ready using the factory failed:" << op->errorName() << op->errorMessage();
+    }
+}
+
 void AccountManager::onAccountValidityChanged(const QDBusObjectPath &objectPath,
         bool valid)
 {
@@ -1132,7 +1253,7 @@ void AccountManager::onAccountValidityChanged(const QDBusObjectPath &objectPath,
 
     if (!mPriv->incompleteAccounts.contains(path) &&
         !mPriv->accounts.contains(path)) {
-        debug() << "New account" << path;
+        tpDebug(logAccounts) << "New account" << path;
         mPriv->addAccountForPath(path);
     }
 }
@@ -1150,17 +1271,17 @@ void AccountManager::onAccountRemoved(const QDBusObjectPath &objectPath)
         mPriv->accounts.remove(path);
 
         if (isReady(FeatureCore)) {
-            debug() << "Account" << path << "removed";
+            tpDebug(logAccounts) << "Account" << path << "removed";
         } else {
-            debug() << "Account" << path << "removed while the AM "
+            tpDebug(logAccounts) << "Account" << path << "removed while the AM "
                 "was not completely introspected";
         }
     } else if (mPriv->incompleteAccounts.contains(path)) {
         mPriv->incompleteAccounts.remove(path);
-        debug() << "Account" << path << "was removed, but it was "
+        tpDebug(logAccounts) << "Account" << path << "was removed, but it was "
             "not completely introspected, ignoring";
     } else {
-        debug() << "Got AccountRemoved for unknown account" << path << ", ignoring";
+        tpDebug(logAccounts) << "Got AccountRemoved for unknown account" << path << ", ignoring";
     }
 }
 
@@ -49,6 +49,7 @@ namespace Tp
 {
 
 class PendingAccount;
+class PendingOperation;
 
 class TP_QT_EXPORT AccountManager : public StatelessDBusProxy,
                 public OptionalInterfaceFactory<AccountManager>
@@ -83,6 +84,9 @@ public:
     ChannelFactoryConstPtr channelFactory() const;
     ContactFactoryConstPtr contactFactory() const;
 
+    bool isLazyAccountsEnabled() const;
+    void setLazyAccountsEnabled(bool enabled);
+
     QList<AccountPtr> allAccounts() const;
 
     AccountSetPtr validAccounts() const;
@@ -117,6 +121,9 @@ public:
     QList<AccountPtr> accountsForObjectPaths(const QStringList &paths) const;
     TP_QT_DEPRECATED QList<AccountPtr> accountsForPaths(const QStringList &paths) const;
 
+    PendingOperation *prefetchAccounts(const QList<AccountPtr> &accounts,
+            const Features &features = Account::FeatureCore);
+
     QStringList supportedAccountProperties() const;
     PendingAccount *createAccount(const QString &connectionManager,
             const QString &protocol, const QString &displayName,
@@ -140,6 +147,7 @@ private Q_SLOTS:
     TP_QT_NO_EXPORT void introspectMain();
     TP_QT_NO_EXPORT void gotMainProperties(QDBusPendingCallWatcher *watcher);
     TP_QT_NO_EXPORT void onAccountReady(Tp::PendingOperation *op);
+    TP_QT_NO_EXPORT void onLazyAccountReady(Tp::PendingOperation *op);
     TP_QT_NO_EXPORT void onAccountValidityChanged(const QDBusObjectPath &objectPath,
             bool valid);
     TP_QT_NO_EXPORT void onAccountRemoved(const QDBusObjectPath &objectPath);
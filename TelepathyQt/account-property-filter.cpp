@@ -81,7 +81,7 @@ bool AccountPropertyFilter::isValid() const
     while (i != end) {
         QString propertyName = i.key();
         if (!mPriv->supportedAccountProperties.contains(propertyName)) {
-            warning() << "Invalid filter key" << propertyName <<
+            tpWarning(logAccounts) << "Invalid filter key" << propertyName <<
                 "while filtering account by properties";
             return false;
         }
@@ -28,7 +28,9 @@
 
 #include "TelepathyQt/debug-internal.h"
 
+#include "TelepathyQt/completion-queue-internal.h"
 #include "TelepathyQt/connection-internal.h"
+#include "TelepathyQt/shared-data-registry-internal.h"
 
 #include <TelepathyQt/AccountManager>
 #include <TelepathyQt/Channel>
@@ -51,7 +53,6 @@
 #include <QQueue>
 #include <QRegExp>
 #include <QSharedPointer>
-#include <QTimer>
 #include <QPointer>
 
 #include <string.h>
@@ -503,12 +504,14 @@ QVariantMap contactSearchRequest(const ConnectionCapabilities &capabilities,
         request.insert(TP_QT_IFACE_CHANNEL_TYPE_CONTACT_SEARCH + QLatin1String(".Server"),
                        server);
     } else if (!server.isEmpty()) {
-        warning() << "Ignoring Server parameter for contact search, since the protocol does not support it.";
+        tpWarning(logAccounts) <<
+            "Ignoring Server parameter for contact search, since the protocol does not support it.";
     }
     if (capabilities.contactSearchesWithLimit()) {
         request.insert(TP_QT_IFACE_CHANNEL_TYPE_CONTACT_SEARCH + QLatin1String(".Limit"), limit);
     } else if (limit > 0) {
-        warning() << "Ignoring Limit parameter for contact search, since the protocol does not support it.";
+        tpWarning(logAccounts) <<
+            "Ignoring Limit parameter for contact search, since the protocol does not support it.";
     }
     return request;
 }
@@ -529,7 +532,69 @@ struct TP_QT_NO_EXPORT Account::Private
     static void introspectProtocolInfo(Private *self);
     static void introspectCapabilities(Private *self);
 
+    enum PropertyId {
+        PropertyInterfaces = 0,
+        PropertyService,
+        PropertyDisplayName,
+        PropertyIcon,
+        PropertyNickname,
+        PropertyNormalizedName,
+        PropertyValid,
+        PropertyEnabled,
+        PropertyConnectAutomatically,
+        PropertyHasBeenOnline,
+        PropertyParameters,
+        PropertyAutomaticPresence,
+        PropertyCurrentPresence,
+        PropertyRequestedPresence,
+        PropertyChangingPresence,
+        PropertyConnection,
+        PropertyConnectionStatus,
+        PropertyConnectionStatusReason,
+        PropertyConnectionError,
+        PropertyConnectionErrorDetails,
+        PropertyUnknown
+    };
+
+    // The properties present in an AccountPropertyChanged delta or GetAll reply, demarshalled
+    struct PropertyUpdate
+    {
+        PropertyUpdate()
+            : present(0), valid(false), enabled(false), connectsAutomatically(false),
+              hasBeenOnline(false), changingPresence(false), connectionStatus(0),
+              connectionStatusReason(0)
+        {
+        }
+
+        bool has(PropertyId id) const { return present & (1u << id); }
+
+        quint32 present;
+        QStringList interfaces;
+        QString serviceName;
+        QString displayName;
+        QString iconName;
+        QString nickname;
+        QString normalizedName;
+        bool valid;
+        bool enabled;
+        bool connectsAutomatically;
+        bool hasBeenOnline;
+        bool changingPresence;
+        QVariantMap parameters;
+        SimplePresence automaticPresence;
+        SimplePresence currentPresence;
+        SimplePresence requestedPresence;
+        QString connectionObjectPath;
+        uint connectionStatus;
+        uint connectionStatusReason;
+        QString connectionError;
+        QVariantMap connectionErrorDetails;
+    };
+
+    static PropertyId propertyId(const QString &name);
+    static PropertyUpdate decodeProperties(const QVariantMap &props);
     void updateProperties(const QVariantMap &props);
+    void applyPropertyUpdate(const PropertyUpdate &update);
     void retrieveAvatar();
     bool processConnQueue();
 
@@ -583,6 +648,11 @@ struct TP_QT_NO_EXPORT Account::Private
     bool usingConnectionCaps;
     ConnectionCapabilities customCaps;
 
+    // AccountPropertyChanged deltas received in this mainloop iteration, merged, and the
+    // position of the queued call processing them
+    QVariantMap pendingProperties;
+    qint64 pendingPropertiesPosition;
+
     // The contexts should never be removed from the map, to guarantee O(1) CD introspections per bus
     struct DispatcherContext;
     static QHash<QString, QSharedPointer<DispatcherContext> > dispatcherContexts;
@@ -631,6 +701,7 @@ Account::Private::Private(Account *parent, const ConnectionFactoryConstPtr &conn
       connectionStatus(ConnectionStatusDisconnected),
       connectionStatusReason(ConnectionStatusReasonNoneSpecified),
       usingConnectionCaps(false),
+      pendingPropertiesPosition(-1),
       dispatcherContext(dispatcherContexts.value(parent->dbusConnection().name()))
 {
     // FIXME: QRegExp probably isn't the most efficient possible way to parse
@@ -645,7 +716,7 @@ Account::Private::Private(Account *parent, const ConnectionFactoryConstPtr &conn
         cmName = rx.cap(1);
         protocolName = rx.cap(2).replace(QLatin1Char('_'), QLatin1Char('-'));
     } else {
-        warning() << "Account object path is not spec-compliant, "
+        tpWarning(logAccounts) << "Account object path is not spec-compliant, "
             "trying again with a different account-specific part check";
 
         rx = QRegExp(QLatin1String("^") + TP_QT_ACCOUNT_OBJECT_PATH_BASE +
@@ -657,7 +728,7 @@ Account::Private::Private(Account *parent, const ConnectionFactoryConstPtr &conn
             cmName = rx.cap(1);
             protocolName = rx.cap(2).replace(QLatin1Char('_'), QLatin1Char('-'));
         } else {
-            warning() << "Not a valid Account object path:" <<
+            tpWarning(logAccounts) << "Not a valid Account object path:" <<
                 parent->objectPath();
         }
     }
@@ -700,12 +771,14 @@ Account::Private::Private(Account *parent, const ConnectionFactoryConstPtr &conn
     readinessHelper->addIntrospectables(introspectables);
 
     if (connFactory->dbusConnection().name() != parent->dbusConnection().name()) {
-        warning() << "  The D-Bus connection in the conn factory is not the proxy connection for"
+        tpWarning(logAccounts) <<
+            "  The D-Bus connection in the conn factory is not the proxy connection for"
             << parent->objectPath();
     }
 
     if (chanFactory->dbusConnection().name() != parent->dbusConnection().name()) {
-        warning() << "  The D-Bus connection in the channel factory is not the proxy connection for"
+        tpWarning(logAccounts) <<
+            "  The D-Bus connection in the channel factory is not the proxy connection for"
             << parent->objectPath();
     }
 
@@ -790,6 +863,14 @@ QHash<QString, QSharedPointer<Account::Private::DispatcherContext> > Account::Pr
  * As an addition to accessors, signals are emitted to indicate that properties have
  * changed, for example displayNameChanged(), iconNameChanged(), etc.
  *
+ * Property changes signalled by the account manager are not applied as soon as they
+ * are received. All the changes received in the same mainloop iteration are merged and
+ * applied together once control returns to the mainloop, through the same queue which
+ * emits PendingOperation::finished(). Each changed property is then signalled once,
+ * with its latest value, and the accessors keep returning the previous values until
+ * then. Changes of the connection and of the connection status are the exception:
+ * every one of them is applied and signalled in turn.
+ *
  * Convenience methods to create channels using the channel dispatcher such as
  * ensureTextChat(), createFileTransfer() are also provided.
  *
@@ -1010,6 +1091,10 @@ Account::Account(const QDBusConnection &bus,
  */
 Account::~Account()
 {
+    if (mPriv->pendingPropertiesPosition >= 0) {
+        CompletionQueue::cancelQueued(this, mPriv->pendingPropertiesPosition);
+    }
+
     delete mPriv;
 }
 
@@ -1231,12 +1316,12 @@ PendingOperation *Account::setServiceName(const QString &value)
 ProfilePtr Account::profile() const
 {
     if (!isReady(FeatureProfile)) {
-        warning() << "Account::profile() requires Account::FeatureProfile to be ready";
+        tpWarning(logAccounts) << "Account::profile() requires Account::FeatureProfile to be ready";
         return ProfilePtr();
     }
 
     if (!mPriv->profile) {
-        mPriv->profile = Profile::createForServiceName(serviceName());
+        mPriv->profile = SharedDataRegistry::instance()->profile(serviceName());
         if (!mPriv->profile->isValid()) {
             if (protocolInfo().isValid()) {
                 mPriv->profile = ProfilePtr(new Profile(
@@ -1245,7 +1330,8 @@ ProfilePtr Account::profile() const
                             mPriv->protocolName,
                             protocolInfo()));
             } else {
-                warning() << "Cannot create profile as neither a .profile is installed for service" <<
+                tpWarning(logAccounts) <<
+                    "Cannot create profile as neither a .profile is installed for service" <<
                     serviceName() << "nor protocol info can be retrieved";
             }
         }
@@ -1417,7 +1503,7 @@ AvatarSpec Account::avatarRequirements() const
 const Avatar &Account::avatar() const
 {
     if (!isReady(Features() << FeatureAvatar)) {
-        warning() << "Trying to retrieve avatar from account, but "
+        tpWarning(logAccounts) << "Trying to retrieve avatar from account, but "
                      "avatar is not supported or was not requested. "
                      "Use becomeReady(FeatureAvatar)";
     }
@@ -1502,7 +1588,7 @@ PendingStringList *Account::updateParameters(const QVariantMap &set,
 ProtocolInfo Account::protocolInfo() const
 {
     if (!isReady(Features() << FeatureProtocolInfo)) {
-        warning() << "Trying to retrieve protocol info from account, but "
+        tpWarning(logAccounts) << "Trying to retrieve protocol info from account, but "
                      "protocol info is not supported or was not requested. "
                      "Use becomeReady(FeatureProtocolInfo)";
         return ProtocolInfo();
@@ -1529,7 +1615,7 @@ ProtocolInfo Account::protocolInfo() const
 ConnectionCapabilities Account::capabilities() const
 {
     if (!isReady(FeatureCapabilities)) {
-        warning() << "Trying to retrieve capabilities from account, but "
+        tpWarning(logAccounts) << "Trying to retrieve capabilities from account, but "
                      "FeatureCapabilities was not requested. "
                      "Use becomeReady(FeatureCapabilities)";
         return ConnectionCapabilities();
@@ -4204,7 +4290,7 @@ void Account::Private::introspectMain(Account::Private *self)
     }
 
     if (!self->dispatcherContext->introspectOp) {
-        debug() << "Discovering if the Channel Dispatcher supports request hints";
+        tpDebug(logAccounts) << "Discovering if the Channel Dispatcher supports request hints";
         self->dispatcherContext->introspectOp =
             self->dispatcherContext->iface->requestPropertySupportsRequestHints();
     }
@@ -4217,7 +4303,7 @@ void Account::Private::introspectMain(Account::Private *self)
 
 void Account::Private::introspectAvatar(Account::Private *self)
 {
-    debug() << "Calling GetAvatar(Account)";
+    tpDebug(logAccounts) << "Calling GetAvatar(Account)";
     // we already checked if avatar interface exists, so bypass avatar interface
     // checking
     Client::AccountInterfaceAvatarInterface *iface =
@@ -4237,7 +4323,8 @@ void Account::Private::introspectProtocolInfo(Account::Private *self)
 {
     Q_ASSERT(!self->cm);
 
-    self->cm = ConnectionManager::create(
+    // accounts on the same CM share the ConnectionManager and its protocol information
+    self->cm = SharedDataRegistry::instance()->connectionManager(
             self->parent->dbusConnection(), self->cmName,
             self->connFactory, self->chanFactory, self->contactFactory);
     self->parent->connect(self->cm->becomeReady(),
@@ -4258,23 +4345,156 @@ void Account::Private::introspectCapabilities(Account::Private *self)
             SLOT(onConnectionReady(Tp::PendingOperation*)));
 }
 
+Account::Private::PropertyId Account::Private::propertyId(const QString &name)
+{
+    static QHash<QString, PropertyId> ids;
+    if (ids.isEmpty()) {
+        static const struct {
+            const char *name;
+            PropertyId id;
+        } table[] = {
+            { "Interfaces", PropertyInterfaces },
+            { "Service", PropertyService },
+            { "DisplayName", PropertyDisplayName },
+            { "Icon", PropertyIcon },
+            { "Nickname", PropertyNickname },
+            { "NormalizedName", PropertyNormalizedName },
+            { "Valid", PropertyValid },
+            { "Enabled", PropertyEnabled },
+            { "ConnectAutomatically", PropertyConnectAutomatically },
+            { "HasBeenOnline", PropertyHasBeenOnline },
+            { "Parameters", PropertyParameters },
+            { "AutomaticPresence", PropertyAutomaticPresence },
+            { "CurrentPresence", PropertyCurrentPresence },
+            { "RequestedPresence", PropertyRequestedPresence },
+            { "ChangingPresence", PropertyChangingPresence },
+            { "Connection", PropertyConnection },
+            { "ConnectionStatus", PropertyConnectionStatus },
+            { "ConnectionStatusReason", PropertyConnectionStatusReason },
+            { "ConnectionError", PropertyConnectionError },
+            { "ConnectionErrorDetails", PropertyConnectionErrorDetails },
+        };
+
+        for (uint i = 0; i < sizeof(table) / sizeof(table[0]); ++i) {
+            ids.insert(QLatin1String(table[i].name), table[i].id);
+        }
+    }
+
+    return ids.value(name, PropertyUnknown);
+}
+
+/*
+ * Demarshall the known properties in props in a single pass, so that applying them does
+ * not need any further lookups or casts.
+ */
+Account::Private::PropertyUpdate Account::Private::decodeProperties(const QVariantMap &props)
+{
+    PropertyUpdate update;
+
+    QVariantMap::const_iterator i = props.constBegin();
+    for (; i != props.constEnd(); ++i) {
+        PropertyId id = propertyId(i.key());
+        const QVariant &value = i.value();
+
+        switch (id) {
+            case PropertyInterfaces:
+                update.interfaces = qdbus_cast<QStringList>(value);
+                break;
+            case PropertyService:
+                update.serviceName = qdbus_cast<QString>(value);
+                break;
+            case PropertyDisplayName:
+                update.displayName = qdbus_cast<QString>(value);
+                break;
+            case PropertyIcon:
+                update.iconName = qdbus_cast<QString>(value);
+                break;
+            case PropertyNickname:
+                update.nickname = qdbus_cast<QString>(value);
+                break;
+            case PropertyNormalizedName:
+                update.normalizedName = qdbus_cast<QString>(value);
+                break;
+            case PropertyValid:
+                update.valid = qdbus_cast<bool>(value);
+                break;
+            case PropertyEnabled:
+                update.enabled = qdbus_cast<bool>(value);
+                break;
+            case PropertyConnectAutomatically:
+                update.connectsAutomatically = qdbus_cast<bool>(value);
+                break;
+            case PropertyHasBeenOnline:
+                update.hasBeenOnline = qdbus_cast<bool>(value);
+                break;
+            case PropertyParameters:
+                update.parameters = qdbus_cast<QVariantMap>(value);
+                break;
+            case PropertyAutomaticPresence:
+                update.automaticPresence = qdbus_cast<SimplePresence>(value);
+                break;
+            case PropertyCurrentPresence:
+                update.currentPresence = qdbus_cast<SimplePresence>(value);
+                break;
+            case PropertyRequestedPresence:
+                update.requestedPresence = qdbus_cast<SimplePresence>(value);
+                break;
+            case PropertyChangingPresence:
+                update.changingPresence = qdbus_cast<bool>(value);
+                break;
+            case PropertyConnection:
+                update.connectionObjectPath = qdbus_cast<QDBusObjectPath>(value).path();
+                if (update.connectionObjectPath.isEmpty()) {
+                    tpDebug(logAccounts) <<
+                        " The map contains \"Connection\" but it's empty as a QDBusObjectPath!";
+                    tpDebug(logAccounts) <<
+                        " Trying QString (known bug in some MC/dbus-glib versions)";
+                    update.connectionObjectPath = qdbus_cast<QString>(value);
+                }
+                break;
+            case PropertyConnectionStatus:
+                update.connectionStatus = qdbus_cast<uint>(value);
+                break;
+            case PropertyConnectionStatusReason:
+                update.connectionStatusReason = qdbus_cast<uint>(value);
+                break;
+            case PropertyConnectionError:
+                update.connectionError = qdbus_cast<QString>(value);
+                break;
+            case PropertyConnectionErrorDetails:
+                update.connectionErrorDetails = qdbus_cast<QVariantMap>(value);
+                break;
+            case PropertyUnknown:
+                continue;
+        }
+
+        update.present |= (1u << id);
+    }
+
+    return update;
+}
+
 void Account::Private::updateProperties(const QVariantMap &props)
 {
-    debug() << "Account::updateProperties: changed:";
+    applyPropertyUpdate(decodeProperties(props));
+}
+
+void Account::Private::applyPropertyUpdate(const PropertyUpdate &update)
+{
+    tpDebug(logAccounts) << "Account::updateProperties: changed:";
 
-    if (props.contains(QLatin1String("Interfaces"))) {
-        parent->setInterfaces(qdbus_cast<QStringList>(props[QLatin1String("Interfaces")]));
-        debug() << " Interfaces:" << parent->interfaces();
+    if (update.has(PropertyInterfaces)) {
+        parent->setInterfaces(update.interfaces);
+        tpDebug(logAccounts) << " Interfaces:" << parent->interfaces();
     }
 
     QString oldIconName = parent->iconName();
     bool serviceNameChanged = false;
     bool profileChanged = false;
-    if (props.contains(QLatin1String("Service")) &&
-        serviceName != qdbus_cast<QString>(props[QLatin1String("Service")])) {
+    if (update.has(PropertyService) && serviceName != update.serviceName) {
         serviceNameChanged = true;
-        serviceName = qdbus_cast<QString>(props[QLatin1String("Service")]);
-        debug() << " Service Name:" << parent->serviceName();
+        serviceName = update.serviceName;
+        tpDebug(logAccounts) << " Service Name:" << parent->serviceName();
         /* use parent->serviceName() here as if the service name is empty we are going to use the
          * protocol name */
         emit parent->serviceNameChanged(parent->serviceName());
@@ -4290,77 +4510,68 @@ void Account::Private::updateProperties(const QVariantMap &props)
         }
     }
 
-    if (props.contains(QLatin1String("DisplayName")) &&
-        displayName != qdbus_cast<QString>(props[QLatin1String("DisplayName")])) {
-        displayName = qdbus_cast<QString>(props[QLatin1String("DisplayName")]);
-        debug() << " Display Name:" << displayName;
+    if (update.has(PropertyDisplayName) && displayName != update.displayName) {
+        displayName = update.displayName;
+        tpDebug(logAccounts) << " Display Name:" << displayName;
         emit parent->displayNameChanged(displayName);
         parent->notify("displayName");
     }
 
-    if ((props.contains(QLatin1String("Icon")) &&
-         oldIconName != qdbus_cast<QString>(props[QLatin1String("Icon")])) ||
+    if ((update.has(PropertyIcon) && oldIconName != update.iconName) ||
         serviceNameChanged) {
 
-        if (props.contains(QLatin1String("Icon"))) {
-            iconName = qdbus_cast<QString>(props[QLatin1String("Icon")]);
+        if (update.has(PropertyIcon)) {
+            iconName = update.iconName;
         }
 
         QString newIconName = parent->iconName();
         if (oldIconName != newIconName) {
-            debug() << " Icon:" << newIconName;
+            tpDebug(logAccounts) << " Icon:" << newIconName;
             emit parent->iconNameChanged(newIconName);
             parent->notify("iconName");
         }
     }
 
-    if (props.contains(QLatin1String("Nickname")) &&
-        nickname != qdbus_cast<QString>(props[QLatin1String("Nickname")])) {
-        nickname = qdbus_cast<QString>(props[QLatin1String("Nickname")]);
-        debug() << " Nickname:" << nickname;
+    if (update.has(PropertyNickname) && nickname != update.nickname) {
+        nickname = update.nickname;
+        tpDebug(logAccounts) << " Nickname:" << nickname;
         emit parent->nicknameChanged(nickname);
         parent->notify("nickname");
     }
 
-    if (props.contains(QLatin1String("NormalizedName")) &&
-        normalizedName != qdbus_cast<QString>(props[QLatin1String("NormalizedName")])) {
-        normalizedName = qdbus_cast<QString>(props[QLatin1String("NormalizedName")]);
-        debug() << " Normalized Name:" << normalizedName;
+    if (update.has(PropertyNormalizedName) && normalizedName != update.normalizedName) {
+        normalizedName = update.normalizedName;
+        tpDebug(logAccounts) << " Normalized Name:" << normalizedName;
         emit parent->normalizedNameChanged(normalizedName);
         parent->notify("normalizedName");
     }
 
-    if (props.contains(QLatin1String("Valid")) &&
-        valid != qdbus_cast<bool>(props[QLatin1String("Valid")])) {
-        valid = qdbus_cast<bool>(props[QLatin1String("Valid")]);
-        debug() << " Valid:" << (valid ? "true" : "false");
+    if (update.has(PropertyValid) && valid != update.valid) {
+        valid = update.valid;
+        tpDebug(logAccounts) << " Valid:" << (valid ? "true" : "false");
         emit parent->validityChanged(valid);
         parent->notify("valid");
     }
 
-    if (props.contains(QLatin1String("Enabled")) &&
-        enabled != qdbus_cast<bool>(props[QLatin1String("Enabled")])) {
-        enabled = qdbus_cast<bool>(props[QLatin1String("Enabled")]);
-        debug() << " Enabled:" << (enabled ? "true" : "false");
+    if (update.has(PropertyEnabled) && enabled != update.enabled) {
+        enabled = update.enabled;
+        tpDebug(logAccounts) << " Enabled:" << (enabled ? "true" : "false");
         emit parent->stateChanged(enabled);
         parent->notify("enabled");
     }
 
-    if (props.contains(QLatin1String("ConnectAutomatically")) &&
-        connectsAutomatically !=
-                qdbus_cast<bool>(props[QLatin1String("ConnectAutomatically")])) {
-        connectsAutomatically =
-                qdbus_cast<bool>(props[QLatin1String("ConnectAutomatically")]);
-        debug() << " Connects Automatically:" << (connectsAutomatically ? "true" : "false");
+    if (update.has(PropertyConnectAutomatically) &&
+        connectsAutomatically != update.connectsAutomatically) {
+        connectsAutomatically = update.connectsAutomatically;
+        tpDebug(logAccounts) << " Connects Automatically:" <<
+            (connectsAutomatically ? "true" : "false");
         emit parent->connectsAutomaticallyPropertyChanged(connectsAutomatically);
         parent->notify("connectsAutomatically");
     }
 
-    if (props.contains(QLatin1String("HasBeenOnline")) &&
-        !hasBeenOnline &&
-        qdbus_cast<bool>(props[QLatin1String("HasBeenOnline")])) {
+    if (update.has(PropertyHasBeenOnline) && !hasBeenOnline && update.hasBeenOnline) {
         hasBeenOnline = true;
-        debug() << " HasBeenOnline changed to true";
+        tpDebug(logAccounts) << " HasBeenOnline changed to true";
         // don't emit firstOnline unless we're already ready, that would be
         // misleading - we'd emit it just before any already-used account
         // became ready
@@ -4370,30 +4581,25 @@ void Account::Private::updateProperties(const QVariantMap &props)
         parent->notify("hasBeenOnline");
     }
 
-    if (props.contains(QLatin1String("Parameters")) &&
-        parameters != qdbus_cast<QVariantMap>(props[QLatin1String("Parameters")])) {
-        parameters = qdbus_cast<QVariantMap>(props[QLatin1String("Parameters")]);
+    if (update.has(PropertyParameters) && parameters != update.parameters) {
+        parameters = update.parameters;
         emit parent->parametersChanged(parameters);
         parent->notify("parameters");
     }
 
-    if (props.contains(QLatin1String("AutomaticPresence")) &&
-        automaticPresence.barePresence() != qdbus_cast<SimplePresence>(
-                props[QLatin1String("AutomaticPresence")])) {
-        automaticPresence = Presence(qdbus_cast<SimplePresence>(
-                props[QLatin1String("AutomaticPresence")]));
-        debug() << " Automatic Presence:" << automaticPresence.type() <<
+    if (update.has(PropertyAutomaticPresence) &&
+        automaticPresence.barePresence() != update.automaticPresence) {
+        automaticPresence = Presence(update.automaticPresence);
+        tpDebug(logAccounts) << " Automatic Presence:" << automaticPresence.type() <<
             "-" << automaticPresence.status();
         emit parent->automaticPresenceChanged(automaticPresence);
         parent->notify("automaticPresence");
     }
 
-    if (props.contains(QLatin1String("CurrentPresence")) &&
-        currentPresence.barePresence() != qdbus_cast<SimplePresence>(
-                props[QLatin1String("CurrentPresence")])) {
-        currentPresence = Presence(qdbus_cast<SimplePresence>(
-                props[QLatin1String("CurrentPresence")]));
-        debug() << " Current Presence:" << currentPresence.type() <<
+    if (update.has(PropertyCurrentPresence) &&
+        currentPresence.barePresence() != update.currentPresence) {
+        currentPresence = Presence(update.currentPresence);
+        tpDebug(logAccounts) << " Current Presence:" << currentPresence.type() <<
             "-" << currentPresence.status();
         emit parent->currentPresenceChanged(currentPresence);
         parent->notify("currentPresence");
@@ -4401,36 +4607,26 @@ void Account::Private::updateProperties(const QVariantMap &props)
         parent->notify("online");
     }
 
-    if (props.contains(QLatin1String("RequestedPresence")) &&
-        requestedPresence.barePresence() != qdbus_cast<SimplePresence>(
-                props[QLatin1String("RequestedPresence")])) {
-        requestedPresence = Presence(qdbus_cast<SimplePresence>(
-                props[QLatin1String("RequestedPresence")]));
-        debug() << " Requested Presence:" << requestedPresence.type() <<
+    if (update.has(PropertyRequestedPresence) &&
+        requestedPresence.barePresence() != update.requestedPresence) {
+        requestedPresence = Presence(update.requestedPresence);
+        tpDebug(logAccounts) << " Requested Presence:" << requestedPresence.type() <<
             "-" << requestedPresence.status();
         emit parent->requestedPresenceChanged(requestedPresence);
         parent->notify("requestedPresence");
     }
 
-    if (props.contains(QLatin1String("ChangingPresence")) &&
-        changingPresence != qdbus_cast<bool>(
-                props[QLatin1String("ChangingPresence")])) {
-        changingPresence = qdbus_cast<bool>(
-                props[QLatin1String("ChangingPresence")]);
-        debug() << " Changing Presence:" << changingPresence;
+    if (update.has(PropertyChangingPresence) &&
+        changingPresence != update.changingPresence) {
+        changingPresence = update.changingPresence;
+        tpDebug(logAccounts) << " Changing Presence:" << changingPresence;
         emit parent->changingPresence(changingPresence);
         parent->notify("changingPresence");
     }
 
-    if (props.contains(QLatin1String("Connection"))) {
-        QString path = qdbus_cast<QDBusObjectPath>(props[QLatin1String("Connection")]).path();
-        if (path.isEmpty()) {
-            debug() << " The map contains \"Connection\" but it's empty as a QDBusObjectPath!";
-            debug() << " Trying QString (known bug in some MC/dbus-glib versions)";
-            path = qdbus_cast<QString>(props[QLatin1String("Connection")]);
-        }
-
-        debug() << " Connection Object Path:" << path;
+    if (update.has(PropertyConnection)) {
+        QString path = update.connectionObjectPath;
+        tpDebug(logAccounts) << " Connection Object Path:" << path;
         if (path == QLatin1String("/")) {
             path = QString();
         }
@@ -4446,27 +4642,23 @@ void Account::Private::updateProperties(const QVariantMap &props)
     }
 
     bool connectionStatusChanged = false;
-    if (props.contains(QLatin1String("ConnectionStatus")) ||
-        props.contains(QLatin1String("ConnectionStatusReason")) ||
-        props.contains(QLatin1String("ConnectionError")) ||
-        props.contains(QLatin1String("ConnectionErrorDetails"))) {
+    if (update.has(PropertyConnectionStatus) ||
+        update.has(PropertyConnectionStatusReason) ||
+        update.has(PropertyConnectionError) ||
+        update.has(PropertyConnectionErrorDetails)) {
         ConnectionStatus oldConnectionStatus = connectionStatus;
 
-        if (props.contains(QLatin1String("ConnectionStatus")) &&
-            connectionStatus != ConnectionStatus(
-                    qdbus_cast<uint>(props[QLatin1String("ConnectionStatus")]))) {
-            connectionStatus = ConnectionStatus(
-                    qdbus_cast<uint>(props[QLatin1String("ConnectionStatus")]));
-            debug() << " Connection Status:" << connectionStatus;
+        if (update.has(PropertyConnectionStatus) &&
+            connectionStatus != ConnectionStatus(update.connectionStatus)) {
+            connectionStatus = ConnectionStatus(update.connectionStatus);
+            tpDebug(logAccounts) << " Connection Status:" << connectionStatus;
             connectionStatusChanged = true;
         }
 
-        if (props.contains(QLatin1String("ConnectionStatusReason")) &&
-            connectionStatusReason != ConnectionStatusReason(
-                    qdbus_cast<uint>(props[QLatin1String("ConnectionStatusReason")]))) {
-            connectionStatusReason = ConnectionStatusReason(
-                    qdbus_cast<uint>(props[QLatin1String("ConnectionStatusReason")]));
-            debug() << " Connection StatusReason:" << connectionStatusReason;
+        if (update.has(PropertyConnectionStatusReason) &&
+            connectionStatusReason != ConnectionStatusReason(update.connectionStatusReason)) {
+            connectionStatusReason = ConnectionStatusReason(update.connectionStatusReason);
+            tpDebug(logAccounts) << " Connection StatusReason:" << connectionStatusReason;
             connectionStatusChanged = true;
         }
 
@@ -4475,21 +4667,18 @@ void Account::Private::updateProperties(const QVariantMap &props)
             parent->notify("connectionStatusReason");
         }
 
-        if (props.contains(QLatin1String("ConnectionError")) &&
-            connectionError != qdbus_cast<QString>(
-                props[QLatin1String("ConnectionError")])) {
-            connectionError = qdbus_cast<QString>(
-                    props[QLatin1String("ConnectionError")]);
-            debug() << " Connection Error:" << connectionError;
+        if (update.has(PropertyConnectionError) &&
+            connectionError != update.connectionError) {
+            connectionError = update.connectionError;
+            tpDebug(logAccounts) << " Connection Error:" << connectionError;
             connectionStatusChanged = true;
         }
 
-        if (props.contains(QLatin1String("ConnectionErrorDetails")) &&
-            connectionErrorDetails.allDetails() != qdbus_cast<QVariantMap>(
-                props[QLatin1String("ConnectionErrorDetails")])) {
-            connectionErrorDetails = Connection::ErrorDetails(qdbus_cast<QVariantMap>(
-                    props[QLatin1String("ConnectionErrorDetails")]));
-            debug() << " Connection Error Details:" << connectionErrorDetails.allDetails();
+        if (update.has(PropertyConnectionErrorDetails) &&
+            connectionErrorDetails.allDetails() != update.connectionErrorDetails) {
+            connectionErrorDetails = Connection::ErrorDetails(update.connectionErrorDetails);
+            tpDebug(logAccounts) << " Connection Error Details:" <<
+                connectionErrorDetails.allDetails();
             connectionStatusChanged = true;
         }
 
@@ -4543,7 +4732,7 @@ bool Account::Private::processConnQueue()
         QString path = connObjPathQueue.head();
         if (path.isEmpty()) {
             if (!connection.isNull()) {
-                debug() << "Dropping connection for account" << parent->objectPath();
+                tpDebug(logAccounts) << "Dropping connection for account" << parent->objectPath();
 
                 connection.reset();
                 emit parent->connectionChanged(connection);
@@ -4553,10 +4742,11 @@ bool Account::Private::processConnQueue()
 
             connObjPathQueue.dequeue();
         } else {
-            debug() << "Building connection" << path << "for account" << parent->objectPath();
+            tpDebug(logAccounts) << "Building connection" << path << "for account" <<
+                parent->objectPath();
 
             if (connection && connection->objectPath() == path) {
-                debug() << "  Connection already built";
+                tpDebug(logAccounts) << "  Connection already built";
                 connObjPathQueue.dequeue();
                 continue;
             }
@@ -4587,13 +4777,14 @@ void Account::onDispatcherIntrospected(Tp::PendingOperation *op)
 
         if (pv->isValid()) {
             mPriv->dispatcherContext->supportsHints = qdbus_cast<bool>(pv->result());
-            debug() << "Discovered channel dispatcher support for request hints: "
+            tpDebug(logAccounts) << "Discovered channel dispatcher support for request hints: "
                 << mPriv->dispatcherContext->supportsHints;
         } else {
             if (pv->errorName() == TP_QT_ERROR_NOT_IMPLEMENTED) {
-                debug() << "Channel Dispatcher does not implement support for request hints";
+                tpDebug(logAccounts) <<
+                    "Channel Dispatcher does not implement support for request hints";
             } else {
-                warning() << "(Too old?) Channel Dispatcher failed to tell us whether"
+                tpWarning(logAccounts) << "(Too old?) Channel Dispatcher failed to tell us whether"
                     << "it supports request hints, assuming it doesn't:"
                     << pv->errorName() << ':' << pv->errorMessage();
             }
@@ -4601,7 +4792,7 @@ void Account::onDispatcherIntrospected(Tp::PendingOperation *op)
         }
     }
 
-    debug() << "Calling Properties::GetAll(Account) on " << objectPath();
+    tpDebug(logAccounts) << "Calling Properties::GetAll(Account) on " << objectPath();
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
             mPriv->properties->GetAll(
                 TP_QT_IFACE_ACCOUNT), this);
@@ -4615,23 +4806,26 @@ void Account::gotMainProperties(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<QVariantMap> reply = *watcher;
 
     if (!reply.isError()) {
-        debug() << "Got reply to Properties.GetAll(Account) for" << objectPath();
+        tpDebug(logAccounts) << "Got reply to Properties.GetAll(Account) for" << objectPath();
+        // changes signalled before the reply are older than it
+        processPendingProperties();
         mPriv->updateProperties(reply.value());
 
         mPriv->readinessHelper->setInterfaces(interfaces());
         mPriv->mayFinishCore = true;
 
         if (mPriv->connObjPathQueue.isEmpty()) {
-            debug() << "Account basic functionality is ready";
+            tpDebug(logAccounts) << "Account basic functionality is ready";
             mPriv->coreFinished = true;
             mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, true);
         } else {
-            debug() << "Deferring finishing Account::FeatureCore until the connection is built";
+            tpDebug(logAccounts) <<
+                "Deferring finishing Account::FeatureCore until the connection is built";
         }
     } else {
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false, reply.error());
 
-        warning().nospace() <<
+        tpWarning(logAccounts).nospace() <<
             "GetAll(Account) failed: " <<
             reply.error().name() << ": " << reply.error().message();
     }
@@ -4644,7 +4838,7 @@ void Account::gotAvatar(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<QVariant> reply = *watcher;
 
     if (!reply.isError()) {
-        debug() << "Got reply to GetAvatar(Account)";
+        tpDebug(logAccounts) << "Got reply to GetAvatar(Account)";
         mPriv->avatar = qdbus_cast<Avatar>(reply);
 
         // It could be in either of actual or missing from the first time in corner cases like the
@@ -4667,7 +4861,7 @@ void Account::gotAvatar(QDBusPendingCallWatcher *watcher)
             mPriv->readinessHelper->setIntrospectCompleted(FeatureAvatar, false, reply.error());
         }
 
-        warning().nospace() <<
+        tpWarning(logAccounts).nospace() <<
             "GetAvatar(Account) failed: " <<
             reply.error().name() << ": " << reply.error().message();
     }
@@ -4677,7 +4871,7 @@ void Account::gotAvatar(QDBusPendingCallWatcher *watcher)
 
 void Account::onAvatarChanged()
 {
-    debug() << "Avatar changed, retrieving it";
+    tpDebug(logAccounts) << "Avatar changed, retrieving it";
     mPriv->retrieveAvatar();
 }
 
@@ -4692,7 +4886,8 @@ void Account::onConnectionManagerReady(PendingOperation *operation)
         mPriv->readinessHelper->setIntrospectCompleted(FeatureProtocolInfo, true);
     }
     else {
-        warning() << "Failed to find the protocol in the CM protocols for account" << objectPath();
+        tpWarning(logAccounts) << "Failed to find the protocol in the CM protocols for account" <<
+            objectPath();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureProtocolInfo, false,
                 operation->errorName(), operation->errorMessage());
     }
@@ -4714,7 +4909,45 @@ void Account::onConnectionReady(PendingOperation *op)
 
 void Account::onPropertyChanged(const QVariantMap &delta)
 {
-    mPriv->updateProperties(delta);
+    // Connection changes and status transitions are never collapsed, each one is signalled
+    static const QString connectionKey = QLatin1String("Connection");
+    static const QString connectionStatusKey = QLatin1String("ConnectionStatus");
+    if ((delta.contains(connectionKey) && mPriv->pendingProperties.contains(connectionKey)) ||
+        (delta.contains(connectionStatusKey) &&
+         mPriv->pendingProperties.contains(connectionStatusKey))) {
+        processPendingProperties();
+    }
+
+    // Merge all the deltas received in this mainloop iteration and process them at once,
+    // later values for the same property replacing earlier ones. This goes through the same
+    // queue as PendingOperation::finished() so that operations finishing after the change was
+    // signalled still see the new values.
+    if (mPriv->pendingPropertiesPosition < 0) {
+        mPriv->pendingPropertiesPosition =
+            CompletionQueue::forCurrentThread()->enqueue(this, "processPendingProperties");
+    }
+
+    QVariantMap::const_iterator i = delta.constBegin();
+    for (; i != delta.constEnd(); ++i) {
+        mPriv->pendingProperties.insert(i.key(), i.value());
+    }
+}
+
+void Account::processPendingProperties()
+{
+    // When called directly, the queued call has nothing left to do
+    if (mPriv->pendingPropertiesPosition >= 0) {
+        CompletionQueue::cancelQueued(this, mPriv->pendingPropertiesPosition);
+        mPriv->pendingPropertiesPosition = -1;
+    }
+
+    if (mPriv->pendingProperties.isEmpty()) {
+        return;
+    }
+
+    QVariantMap props = mPriv->pendingProperties;
+    mPriv->pendingProperties.clear();
+    mPriv->updateProperties(props);
 }
 
 void Account::onRemoved()
@@ -4732,7 +4965,8 @@ void Account::onConnectionBuilt(PendingOperation *op)
     Q_ASSERT(readyOp != NULL);
 
     if (op->isError()) {
-        warning() << "Building connection" << mPriv->connObjPathQueue.head() << "failed with" <<
+        tpWarning(logAccounts) << "Building connection" << mPriv->connObjPathQueue.head() <<
+            "failed with" <<
             op->errorName() << "-" << op->errorMessage();
 
         if (!mPriv->connection.isNull()) {
@@ -4750,7 +4984,8 @@ void Account::onConnectionBuilt(PendingOperation *op)
 
         mPriv->connection->setProperty("accountUID", uniqueIdentifier());
 
-        debug() << "Connection" << mPriv->connectionObjectPath() << "built for" << objectPath();
+        tpDebug(logAccounts) << "Connection" << mPriv->connectionObjectPath() << "built for" <<
+            objectPath();
 
         if (prevConn != mPriv->connection) {
             notify("connection");
@@ -4765,7 +5000,8 @@ void Account::onConnectionBuilt(PendingOperation *op)
     mPriv->connObjPathQueue.dequeue();
 
     if (mPriv->processConnQueue() && !mPriv->coreFinished && mPriv->mayFinishCore) {
-        debug() << "Account" << objectPath() << "basic functionality is ready (connections built)";
+        tpDebug(logAccounts) << "Account" << objectPath() <<
+            "basic functionality is ready (connections built)";
         mPriv->coreFinished = true;
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, true);
     }
@@ -593,6 +593,7 @@ private Q_SLOTS:
     TP_QT_NO_EXPORT void onConnectionManagerReady(Tp::PendingOperation *);
     TP_QT_NO_EXPORT void onConnectionReady(Tp::PendingOperation *);
     TP_QT_NO_EXPORT void onPropertyChanged(const QVariantMap &delta);
+    TP_QT_NO_EXPORT void processPendingProperties();
     TP_QT_NO_EXPORT void onRemoved();
     TP_QT_NO_EXPORT void onConnectionBuilt(Tp::PendingOperation *);
 
@@ -28,6 +28,11 @@
 #include <TelepathyQt/Types>
 #include "TelepathyQt/debug-internal.h"
 
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMultiMap>
+#include <QTimer>
+
 
 namespace Tp
 {
@@ -133,4 +138,37 @@ public:
     Service::CallContentInterfaceDTMFAdaptor *mAdaptor;
 };
 
+class TP_QT_NO_EXPORT BaseCallContentDTMFInterface::ToneScheduler : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(ToneScheduler)
+
+public:
+    // Shared by all the DTMF interfaces of the process, and deleted with the last of them
+    static ToneScheduler *acquire();
+    static void release();
+
+    void schedule(BaseCallContentDTMFInterface::Private *tones, uint msecs);
+    void cancel(BaseCallContentDTMFInterface::Private *tones);
+
+private Q_SLOTS:
+    void onTimeout();
+
+private:
+    ToneScheduler();
+    ~ToneScheduler();
+
+    void restartTimer();
+
+    QElapsedTimer mClock;
+    QTimer mTimer;
+    QMultiMap<qint64, BaseCallContentDTMFInterface::Private*> mDeadlines;
+    QHash<BaseCallContentDTMFInterface::Private*, qint64> mScheduled;
+    QList<BaseCallContentDTMFInterface::Private*> mExpired;
+    bool mDispatching;
+
+    static ToneScheduler *mInstance;
+    static int mRefCount;
+};
+
 }
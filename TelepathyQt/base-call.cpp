@@ -62,7 +62,7 @@ BaseCallContent::Adaptee::Adaptee(const QDBusConnection &dbusConnection,
     : QObject(content),
       mContent(content)
 {
-    debug() << "Creating service::CallContentAdaptor for " << content->dbusObject();
+    tpDebug(logService) << "Creating service::CallContentAdaptor for " << content->dbusObject();
     mAdaptor = new Service::CallContentAdaptor(dbusConnection, this, content->dbusObject());
 }
 
@@ -176,14 +176,15 @@ bool BaseCallContent::registerObject(DBusError *error)
     QString busName = mPriv->channel->busName();
     QString objectPath = QString(QLatin1String("%1/%2"))
                          .arg(mPriv->channel->objectPath(), name);
-    debug() << "Registering Content: busName: " << busName << " objectName: " << objectPath;
+    tpDebug(logService) << "Registering Content: busName: " << busName << " objectName: " <<
+        objectPath;
     DBusError _error;
 
-    debug() << "CallContent: registering interfaces  at " << dbusObject();
+    tpDebug(logService) << "CallContent: registering interfaces  at " << dbusObject();
     foreach(const AbstractCallContentInterfacePtr & iface, mPriv->interfaces) {
         if (!iface->registerInterface(dbusObject())) {
             // lets not fail if an optional interface fails registering, lets warn only
-            warning() << "Unable to register interface" << iface->interfaceName();
+            tpWarning(logService) << "Unable to register interface" << iface->interfaceName();
         }
     }
 
@@ -211,24 +212,27 @@ QList<AbstractCallContentInterfacePtr> BaseCallContent::interfaces() const
 bool BaseCallContent::plugInterface(const AbstractCallContentInterfacePtr &interface)
 {
     if (isRegistered()) {
-        warning() << "Unable to plug protocol interface " << interface->interfaceName() <<
+        tpWarning(logService) << "Unable to plug protocol interface " <<
+            interface->interfaceName() <<
                   "- protocol already registered";
         return false;
     }
 
     if (interface->isRegistered()) {
-        warning() << "Unable to plug protocol interface" << interface->interfaceName() <<
+        tpWarning(logService) << "Unable to plug protocol interface" <<
+            interface->interfaceName() <<
                   "- interface already registered";
         return false;
     }
 
     if (mPriv->interfaces.contains(interface->interfaceName())) {
-        warning() << "Unable to plug protocol interface" << interface->interfaceName() <<
+        tpWarning(logService) << "Unable to plug protocol interface" <<
+            interface->interfaceName() <<
                   "- another interface with same name already plugged";
         return false;
     }
 
-    debug() << "Interface" << interface->interfaceName() << "plugged";
+    tpDebug(logService) << "Interface" << interface->interfaceName() << "plugged";
     mPriv->interfaces.insert(interface->interfaceName(), interface);
     return true;
 }
@@ -353,61 +357,402 @@ BaseCallContentDTMFInterface::Adaptee::~Adaptee()
 }
 
 struct TP_QT_NO_EXPORT BaseCallContentDTMFInterface::Private {
+    enum TonePhase {
+        PhaseIdle,
+        PhaseTone,
+        PhaseGap,
+        PhasePause
+    };
+
     Private(BaseCallContentDTMFInterface *parent)
         : currentlySendingTones(false),
+          toneDuration(250),
+          gapDuration(100),
+          pauseDuration(3000),
+          queueMultipleTones(false),
+          phase(PhaseIdle),
+          nextTone(0),
+          scheduler(ToneScheduler::acquire()),
           adaptee(new BaseCallContentDTMFInterface::Adaptee(parent)) {
     }
 
+    ~Private() {
+        scheduler->cancel(this);
+        ToneScheduler::release();
+    }
+
+    bool schedulesTones() const {
+        return !multipleTonesCB.isValid() && startToneCB.isValid();
+    }
+
+    static bool isValidToneString(const QString &tones);
+    static int eventForTone(QChar tone);
+
+    void sendTones(const QString &tones);
+    void playNextTone();
+    void stopCurrentTone();
+    void finishTones(bool cancelled);
+    void onToneTimerExpired();
+
     StartToneCallback startToneCB;
     StopToneCallback stopToneCB;
     MultipleTonesCallback multipleTonesCB;
     bool currentlySendingTones;
     QString deferredTones;
+
+    // Built-in MultipleTones scheduling, used when no MultipleTones callback is set
+    uint toneDuration;
+    uint gapDuration;
+    uint pauseDuration;
+    bool queueMultipleTones;
+    TonePhase phase;
+    QString pendingTones;
+    int nextTone;
+    QStringList queuedTones;
+    ToneScheduler *scheduler;
+
     BaseCallContentDTMFInterface::Adaptee *adaptee;
 };
 
+static const char dtmfEventTones[] = "0123456789*#ABCD";
+
+bool BaseCallContentDTMFInterface::Private::isValidToneString(const QString &tones)
+{
+    if (tones.isEmpty()) {
+        return false;
+    }
+
+    foreach (QChar tone, tones) {
+        switch (tone.toUpper().unicode()) {
+        case 'P':
+        case 'X':
+        case ',':
+        case 'W':
+            break;
+        default:
+            if (eventForTone(tone) < 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int BaseCallContentDTMFInterface::Private::eventForTone(QChar tone)
+{
+    char c = tone.toUpper().toLatin1();
+    for (int i = 0; c != 0 && dtmfEventTones[i] != 0; ++i) {
+        if (dtmfEventTones[i] == c) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void BaseCallContentDTMFInterface::Private::sendTones(const QString &tones)
+{
+    deferredTones.clear();
+    currentlySendingTones = true;
+    pendingTones = tones;
+    nextTone = 0;
+    QMetaObject::invokeMethod(adaptee, "sendingTones", Q_ARG(QString, tones)); //Can simply use emit in Qt5
+    playNextTone();
+}
+
+void BaseCallContentDTMFInterface::Private::playNextTone()
+{
+    if (nextTone >= pendingTones.size()) {
+        if (!queuedTones.isEmpty()) {
+            sendTones(queuedTones.takeFirst());
+            return;
+        }
+        finishTones(false);
+        return;
+    }
+
+    QChar tone = pendingTones.at(nextTone++);
+    switch (tone.toUpper().unicode()) {
+    case 'W': {
+        // Everything not yet played, including queued sequences, waits for the user
+        QString rest = pendingTones.mid(nextTone) + queuedTones.join(QString());
+        queuedTones.clear();
+        if (!rest.isEmpty()) {
+            deferredTones = rest;
+            QMetaObject::invokeMethod(adaptee, "tonesDeferred", Q_ARG(QString, rest)); //Can simply use emit in Qt5
+        }
+        finishTones(false);
+        return;
+    }
+    case 'P':
+    case 'X':
+    case ',':
+        phase = PhasePause;
+        scheduler->schedule(this, pauseDuration);
+        return;
+    default:
+        break;
+    }
+
+    DBusError error;
+    startToneCB(static_cast<uchar>(eventForTone(tone)), &error);
+    if (error.isValid()) {
+        tpWarning(logService).nospace() << "Starting DTMF tone " << tone << " failed with " <<
+            error.name() << ": " << error.message() << ", dropping remaining tones";
+        queuedTones.clear();
+        finishTones(false);
+        return;
+    }
+
+    phase = PhaseTone;
+    scheduler->schedule(this, toneDuration);
+}
+
+void BaseCallContentDTMFInterface::Private::stopCurrentTone()
+{
+    if (!stopToneCB.isValid()) {
+        return;
+    }
+
+    DBusError error;
+    stopToneCB(&error);
+    if (error.isValid()) {
+        tpWarning(logService).nospace() << "Stopping DTMF tone failed with " <<
+            error.name() << ": " << error.message();
+    }
+}
+
+void BaseCallContentDTMFInterface::Private::finishTones(bool cancelled)
+{
+    if (phase != PhaseIdle) {
+        scheduler->cancel(this);
+    }
+    phase = PhaseIdle;
+    pendingTones.clear();
+    nextTone = 0;
+    currentlySendingTones = false;
+    QMetaObject::invokeMethod(adaptee, "stoppedTones", Q_ARG(bool, cancelled)); //Can simply use emit in Qt5
+}
+
+void BaseCallContentDTMFInterface::Private::onToneTimerExpired()
+{
+    switch (phase) {
+    case PhaseTone:
+        stopCurrentTone();
+        phase = PhaseGap;
+        scheduler->schedule(this, gapDuration);
+        break;
+    case PhaseGap:
+    case PhasePause:
+        phase = PhaseIdle;
+        playNextTone();
+        break;
+    case PhaseIdle:
+        break;
+    }
+}
+
+BaseCallContentDTMFInterface::ToneScheduler *BaseCallContentDTMFInterface::ToneScheduler::mInstance = 0;
+int BaseCallContentDTMFInterface::ToneScheduler::mRefCount = 0;
+
+BaseCallContentDTMFInterface::ToneScheduler *BaseCallContentDTMFInterface::ToneScheduler::acquire()
+{
+    if (mRefCount++ == 0) {
+        mInstance = new ToneScheduler();
+    }
+    return mInstance;
+}
+
+void BaseCallContentDTMFInterface::ToneScheduler::release()
+{
+    Q_ASSERT(mRefCount > 0);
+    if (--mRefCount > 0) {
+        return;
+    }
+
+    // The last DTMF interface may go away from one of the callbacks run by onTimeout()
+    if (mInstance->mDispatching) {
+        mInstance->deleteLater();
+    } else {
+        delete mInstance;
+    }
+    mInstance = 0;
+}
+
+BaseCallContentDTMFInterface::ToneScheduler::ToneScheduler()
+    : mDispatching(false)
+{
+    mClock.start();
+    mTimer.setSingleShot(true);
+#if QT_VERSION >= 0x050000
+    mTimer.setTimerType(Qt::PreciseTimer);
+#endif
+    connect(&mTimer, SIGNAL(timeout()), SLOT(onTimeout()));
+}
+
+BaseCallContentDTMFInterface::ToneScheduler::~ToneScheduler()
+{
+}
+
+void BaseCallContentDTMFInterface::ToneScheduler::schedule(
+        BaseCallContentDTMFInterface::Private *tones, uint msecs)
+{
+    cancel(tones);
+
+    qint64 deadline = mClock.elapsed() + msecs;
+    mDeadlines.insert(deadline, tones);
+    mScheduled.insert(tones, deadline);
+    if (mDeadlines.constBegin().key() == deadline) {
+        restartTimer();
+    }
+}
+
+void BaseCallContentDTMFInterface::ToneScheduler::cancel(
+        BaseCallContentDTMFInterface::Private *tones)
+{
+    mExpired.removeOne(tones);
+
+    QHash<BaseCallContentDTMFInterface::Private*, qint64>::iterator it = mScheduled.find(tones);
+    if (it == mScheduled.end()) {
+        return;
+    }
+
+    mDeadlines.remove(it.value(), tones);
+    mScheduled.erase(it);
+    if (mDeadlines.isEmpty()) {
+        mTimer.stop();
+    }
+}
+
+void BaseCallContentDTMFInterface::ToneScheduler::restartTimer()
+{
+    if (mDeadlines.isEmpty()) {
+        mTimer.stop();
+        return;
+    }
+
+    qint64 timeout = mDeadlines.constBegin().key() - mClock.elapsed();
+    mTimer.start(static_cast<int>(qMax(timeout, Q_INT64_C(0))));
+}
+
+void BaseCallContentDTMFInterface::ToneScheduler::onTimeout()
+{
+    // All the calls sharing this timer are served from one timeout; collect the expired ones
+    // first as handling them reschedules their next step. The callbacks run by a handler may
+    // cancel, reschedule or destroy the contents that come after it, which all go through
+    // cancel() and so drop them from mExpired before they are reached.
+    qint64 now = mClock.elapsed();
+    QMultiMap<qint64, BaseCallContentDTMFInterface::Private*>::iterator it = mDeadlines.begin();
+    while (it != mDeadlines.end() && it.key() <= now) {
+        mExpired.append(it.value());
+        mScheduled.remove(it.value());
+        it = mDeadlines.erase(it);
+    }
+
+    mDispatching = true;
+    while (!mExpired.isEmpty()) {
+        mExpired.takeFirst()->onToneTimerExpired();
+    }
+    mDispatching = false;
+
+    restartTimer();
+}
+
 void BaseCallContentDTMFInterface::Adaptee::startTone(uchar event, const Tp::Service::CallContentInterfaceDTMFAdaptor::StartToneContextPtr &context)
 {
-    if (!mInterface->mPriv->startToneCB.isValid()) {
+    BaseCallContentDTMFInterface::Private *priv = mInterface->mPriv;
+    if (!priv->startToneCB.isValid()) {
         context->setFinishedWithError(TP_QT_ERROR_NOT_IMPLEMENTED, QLatin1String("Not implemented"));
         return;
     }
 
+    bool scheduling = priv->schedulesTones();
+    if (scheduling && priv->phase != Private::PhaseIdle) {
+        context->setFinishedWithError(TP_QT_ERROR_SERVICE_BUSY,
+                QLatin1String("DTMF tones are already being played"));
+        return;
+    }
+
     DBusError error;
-    mInterface->mPriv->startToneCB(event, &error);
+    priv->startToneCB(event, &error);
     if (error.isValid()) {
         context->setFinishedWithError(error.name(), error.message());
         return;
     }
+
+    if (scheduling) {
+        priv->deferredTones.clear();
+        priv->currentlySendingTones = true;
+        QString tone = event < sizeof(dtmfEventTones) - 1 ?
+            QString(QLatin1Char(dtmfEventTones[event])) : QString();
+        QMetaObject::invokeMethod(this, "sendingTones", Q_ARG(QString, tone)); //Can simply use emit in Qt5
+    }
     context->setFinished();
 }
 
 void BaseCallContentDTMFInterface::Adaptee::stopTone(const Tp::Service::CallContentInterfaceDTMFAdaptor::StopToneContextPtr &context)
 {
-    if (!mInterface->mPriv->stopToneCB.isValid()) {
+    BaseCallContentDTMFInterface::Private *priv = mInterface->mPriv;
+    if (priv->schedulesTones() && priv->phase != Private::PhaseIdle) {
+        // Interrupt the MultipleTones sequence being played, dropping queued sequences too
+        if (priv->phase == Private::PhaseTone) {
+            priv->stopCurrentTone();
+        }
+        priv->queuedTones.clear();
+        priv->finishTones(true);
+        context->setFinished();
+        return;
+    }
+
+    if (!priv->stopToneCB.isValid()) {
         context->setFinishedWithError(TP_QT_ERROR_NOT_IMPLEMENTED, QLatin1String("Not implemented"));
         return;
     }
 
     DBusError error;
-    mInterface->mPriv->stopToneCB(&error);
+    priv->stopToneCB(&error);
     if (error.isValid()) {
         context->setFinishedWithError(error.name(), error.message());
         return;
     }
+
+    if (priv->schedulesTones() && priv->currentlySendingTones) {
+        priv->finishTones(true);
+    }
     context->setFinished();
 }
 
 
 void BaseCallContentDTMFInterface::Adaptee::multipleTones(const QString& tones, const Tp::Service::CallContentInterfaceDTMFAdaptor::MultipleTonesContextPtr &context)
 {
-    if (!mInterface->mPriv->multipleTonesCB.isValid()) {
+    BaseCallContentDTMFInterface::Private *priv = mInterface->mPriv;
+    if (priv->schedulesTones()) {
+        if (!Private::isValidToneString(tones)) {
+            context->setFinishedWithError(TP_QT_ERROR_INVALID_ARGUMENT,
+                    QLatin1String("Invalid DTMF tone string"));
+            return;
+        }
+
+        if (priv->currentlySendingTones) {
+            if (!priv->queueMultipleTones || priv->phase == Private::PhaseIdle) {
+                context->setFinishedWithError(TP_QT_ERROR_SERVICE_BUSY,
+                        QLatin1String("DTMF tones are already being played"));
+                return;
+            }
+            priv->queuedTones.append(tones);
+        } else {
+            priv->sendTones(tones);
+        }
+        context->setFinished();
+        return;
+    }
+
+    if (!priv->multipleTonesCB.isValid()) {
         context->setFinishedWithError(TP_QT_ERROR_NOT_IMPLEMENTED, QLatin1String("Not implemented"));
         return;
     }
 
     DBusError error;
-    mInterface->mPriv->multipleTonesCB(tones, &error);
+    priv->multipleTonesCB(tones, &error);
     if (error.isValid()) {
         context->setFinishedWithError(error.name(), error.message());
         return;
@@ -422,6 +767,11 @@ void BaseCallContentDTMFInterface::Adaptee::multipleTones(const QString& tones,
  *
  * \brief Base class for implementations of Call.Content.Interface.DTMF
  *
+ * If a start tone callback is set but no multiple tones callback, this class implements
+ * MultipleTones itself: it plays each tone with the start and stop tone callbacks for
+ * toneDuration() milliseconds, separated by gapDuration() milliseconds, handles pauses and
+ * the 'w' character, and emits SendingTones, TonesDeferred and StoppedTones as appropriate.
+ * The timing of all the contents in the process is driven by a single shared timer.
  */
 
 /**
@@ -470,6 +820,108 @@ void BaseCallContentDTMFInterface::setMultipleTonesCallback(const MultipleTonesC
     mPriv->multipleTonesCB = cb;
 }
 
+/**
+ * Return the duration of each tone played by the built-in MultipleTones implementation.
+ *
+ * \return The tone duration in milliseconds.
+ * \sa setToneDuration()
+ */
+uint BaseCallContentDTMFInterface::toneDuration() const
+{
+    return mPriv->toneDuration;
+}
+
+/**
+ * Set the duration of each tone played by the built-in MultipleTones implementation.
+ *
+ * The default is 250 milliseconds.
+ *
+ * \param msecs The tone duration in milliseconds.
+ * \sa toneDuration(), setGapDuration()
+ */
+void BaseCallContentDTMFInterface::setToneDuration(uint msecs)
+{
+    mPriv->toneDuration = msecs;
+}
+
+/**
+ * Return the gap left after each tone by the built-in MultipleTones implementation.
+ *
+ * \return The gap duration in milliseconds.
+ * \sa setGapDuration()
+ */
+uint BaseCallContentDTMFInterface::gapDuration() const
+{
+    return mPriv->gapDuration;
+}
+
+/**
+ * Set the gap left after each tone by the built-in MultipleTones implementation.
+ *
+ * The default is 100 milliseconds.
+ *
+ * \param msecs The gap duration in milliseconds.
+ * \sa gapDuration(), setToneDuration()
+ */
+void BaseCallContentDTMFInterface::setGapDuration(uint msecs)
+{
+    mPriv->gapDuration = msecs;
+}
+
+/**
+ * Return the duration of the pause characters ('p', 'x' and ',') in the built-in
+ * MultipleTones implementation.
+ *
+ * \return The pause duration in milliseconds.
+ * \sa setPauseDuration()
+ */
+uint BaseCallContentDTMFInterface::pauseDuration() const
+{
+    return mPriv->pauseDuration;
+}
+
+/**
+ * Set the duration of the pause characters ('p', 'x' and ',') in the built-in
+ * MultipleTones implementation.
+ *
+ * The default is 3 seconds.
+ *
+ * \param msecs The pause duration in milliseconds.
+ * \sa pauseDuration()
+ */
+void BaseCallContentDTMFInterface::setPauseDuration(uint msecs)
+{
+    mPriv->pauseDuration = msecs;
+}
+
+/**
+ * Return whether the built-in MultipleTones implementation queues tone strings received
+ * while tones are being played.
+ *
+ * \return \c true if tone strings are queued, \c false if such calls fail.
+ * \sa setQueueMultipleTones()
+ */
+bool BaseCallContentDTMFInterface::queuesMultipleTones() const
+{
+    return mPriv->queueMultipleTones;
+}
+
+/**
+ * Set whether the built-in MultipleTones implementation queues tone strings received
+ * while tones are being played.
+ *
+ * By default, as required by the specification, such calls fail with
+ * #TP_QT_ERROR_SERVICE_BUSY. When queueing is enabled, they are played in order once the
+ * current sequence is over, and StopTone drops them along with the current sequence.
+ *
+ * \param queue Whether to queue tone strings.
+ * \sa queuesMultipleTones()
+ */
+void BaseCallContentDTMFInterface::setQueueMultipleTones(bool queue)
+{
+    mPriv->queueMultipleTones = queue;
+}
+
 /**
  * Class destructor.
  */
@@ -172,6 +172,15 @@ public:
     void setStopToneCallback(const StopToneCallback &cb);
     typedef Callback2<void, const QString&, DBusError*> MultipleTonesCallback;
     void setMultipleTonesCallback(const MultipleTonesCallback &cb);
+
+    uint toneDuration() const;
+    void setToneDuration(uint msecs);
+    uint gapDuration() const;
+    void setGapDuration(uint msecs);
+    uint pauseDuration() const;
+    void setPauseDuration(uint msecs);
+    bool queuesMultipleTones() const;
+    void setQueueMultipleTones(bool queue);
 Q_SIGNALS:
 
 private:
@@ -180,6 +189,8 @@ private:
 
     class Adaptee;
     friend class Adaptee;
+    class ToneScheduler;
+    friend class ToneScheduler;
     struct Private;
     friend struct Private;
     Private *mPriv;
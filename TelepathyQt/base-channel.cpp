@@ -40,9 +40,11 @@
 #include <TelepathyQt/AbstractProtocolInterface>
 
 #include <QDateTime>
+#include <QQueue>
 #include <QString>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QTimer>
 #include <QVariantMap>
 
 namespace Tp
@@ -94,7 +96,7 @@ BaseChannel::Adaptee::Adaptee(const QDBusConnection &dbusConnection,
     : QObject(channel),
       mChannel(channel)
 {
-    debug() << "Creating service::channelAdaptor for " << channel->dbusObject();
+    tpDebug(logService) << "Creating service::channelAdaptor for " << channel->dbusObject();
     mAdaptor = new Service::ChannelAdaptor(dbusConnection, this, channel->dbusObject());
 }
 
@@ -173,14 +175,15 @@ bool BaseChannel::registerObject(DBusError *error)
     //        .arg(mPriv->connection->busName(),name);
     QString objectPath = QString(QLatin1String("%1/%2"))
                          .arg(mPriv->connection->objectPath(), name);
-    debug() << "Registering channel: busName: " << busName << " objectName: " << objectPath;
+    tpDebug(logService) << "Registering channel: busName: " << busName << " objectName: " <<
+        objectPath;
     DBusError _error;
 
-    debug() << "Channel: registering interfaces  at " << dbusObject();
+    tpDebug(logService) << "Channel: registering interfaces  at " << dbusObject();
     foreach(const AbstractChannelInterfacePtr & iface, mPriv->interfaces) {
         if (!iface->registerInterface(dbusObject())) {
             // lets not fail if an optional interface fails registering, lets warn only
-            warning() << "Unable to register interface" << iface->interfaceName();
+            tpWarning(logService) << "Unable to register interface" << iface->interfaceName();
         }
     }
 
@@ -336,24 +339,27 @@ AbstractChannelInterfacePtr BaseChannel::interface(const QString &interfaceName)
 bool BaseChannel::plugInterface(const AbstractChannelInterfacePtr &interface)
 {
     if (isRegistered()) {
-        warning() << "Unable to plug protocol interface " << interface->interfaceName() <<
+        tpWarning(logService) << "Unable to plug protocol interface " <<
+            interface->interfaceName() <<
                   "- protocol already registered";
         return false;
     }
 
     if (interface->isRegistered()) {
-        warning() << "Unable to plug protocol interface" << interface->interfaceName() <<
+        tpWarning(logService) << "Unable to plug protocol interface" <<
+            interface->interfaceName() <<
                   "- interface already registered";
         return false;
     }
 
     if (mPriv->interfaces.contains(interface->interfaceName())) {
-        warning() << "Unable to plug protocol interface" << interface->interfaceName() <<
+        tpWarning(logService) << "Unable to plug protocol interface" <<
+            interface->interfaceName() <<
                   "- another interface with same name already plugged";
         return false;
     }
 
-    debug() << "Interface" << interface->interfaceName() << "plugged";
+    tpDebug(logService) << "Interface" << interface->interfaceName() << "plugged";
     mPriv->interfaces.insert(interface->interfaceName(), interface);
     interface->setBaseChannel(this);
     return true;
@@ -399,7 +405,7 @@ BaseChannelTextType::Adaptee::~Adaptee()
 void BaseChannelTextType::Adaptee::acknowledgePendingMessages(const Tp::UIntList &IDs,
         const Tp::Service::ChannelTypeTextAdaptor::AcknowledgePendingMessagesContextPtr &context)
 {
-    debug() << "BaseConnectionContactsInterface::acknowledgePendingMessages " << IDs;
+    tpDebug(logService) << "BaseConnectionContactsInterface::acknowledgePendingMessages " << IDs;
     DBusError error;
     mInterface->acknowledgePendingMessages(IDs, &error);
     if (error.isValid()) {
@@ -474,13 +480,13 @@ void BaseChannelTextType::addReceivedMessage(const Tp::MessagePartList &msg)
 {
     MessagePartList message = msg;
     if (msg.empty()) {
-        warning() << "empty message: not sent";
+        tpWarning(logService) << "empty message: not sent";
         return;
     }
     MessagePart &header = message.front();
 
     if (header.count(QLatin1String("pending-message-id")))
-        warning() << "pending-message-id will be overwritten";
+        tpWarning(logService) << "pending-message-id will be overwritten";
 
     /* Add pending-message-id to header */
     uint pendingMessageId = mPriv->pendingMessagesId++;
@@ -788,7 +794,7 @@ QString BaseChannelMessagesInterface::sendMessage(const Tp::MessagePartList &mes
                               Q_ARG(QString, token));
 
     if (message.empty()) {
-        warning() << "Sending empty message";
+        tpWarning(logService) << "Sending empty message";
         return token;
     }
 
@@ -958,7 +964,7 @@ void BaseChannelFileTransferType::Adaptee::setUri(const QString &uri)
 void BaseChannelFileTransferType::Adaptee::acceptFile(uint addressType, uint accessControl, const QDBusVariant &accessControlParam, qulonglong offset,
         const Tp::Service::ChannelTypeFileTransferAdaptor::AcceptFileContextPtr &context)
 {
-    debug() << "BaseChannelFileTransferType::Adaptee::acceptFile";
+    tpDebug(logService) << "BaseChannelFileTransferType::Adaptee::acceptFile";
 
     if (mInterface->mPriv->device) {
         context->setFinishedWithError(TP_QT_ERROR_NOT_AVAILABLE, QLatin1String("File transfer can only be started once in the same channel"));
@@ -986,7 +992,7 @@ void BaseChannelFileTransferType::Adaptee::acceptFile(uint addressType, uint acc
 void BaseChannelFileTransferType::Adaptee::provideFile(uint addressType, uint accessControl, const QDBusVariant &accessControlParam,
         const Tp::Service::ChannelTypeFileTransferAdaptor::ProvideFileContextPtr &context)
 {
-    debug() << "BaseChannelFileTransferType::Adaptee::provideFile";
+    tpDebug(logService) << "BaseChannelFileTransferType::Adaptee::provideFile";
 
     DBusError error;
     mInterface->createSocket(addressType, accessControl, accessControlParam, &error);
@@ -1174,7 +1180,8 @@ void BaseChannelFileTransferType::setClientSocket(QIODevice *socket)
     mPriv->clientSocket = socket;
 
     if (!socket) {
-        warning() << "BaseChannelFileTransferType::setClientSocket() called with a null socket.";
+        tpWarning(logService) <<
+            "BaseChannelFileTransferType::setClientSocket() called with a null socket.";
         return;
     }
 
@@ -1378,13 +1385,15 @@ QString BaseChannelFileTransferType::uri() const
 void BaseChannelFileTransferType::setUri(const QString &uri)
 {
     if (mPriv->direction == Outgoing) {
-        warning() << "BaseChannelFileTransferType::setUri(): Failed to set URI property for outgoing transfer.";
+        tpWarning(logService) <<
+            "BaseChannelFileTransferType::setUri(): Failed to set URI property for outgoing transfer.";
         return;
     }
 
     // The property can be written only before AcceptFile.
     if (state() != FileTransferStatePending) {
-        warning() << "BaseChannelFileTransferType::setUri(): Failed to set URI property after AcceptFile call.";
+        tpWarning(logService) <<
+            "BaseChannelFileTransferType::setUri(): Failed to set URI property after AcceptFile call.";
         return;
     }
 
@@ -1459,7 +1468,8 @@ bool BaseChannelFileTransferType::remoteAcceptFile(QIODevice *output, qulonglong
 
     if (!errorText.isEmpty()) {
         errorLabel:
-        warning() << "BaseChannelFileTransferType::remoteAcceptFile(): Invalid call:" << errorText;
+        tpWarning(logService) << "BaseChannelFileTransferType::remoteAcceptFile(): Invalid call:" <<
+            errorText;
         setState(Tp::FileTransferStateCancelled, Tp::FileTransferStateChangeReasonLocalError);
 
         return false;
@@ -1543,7 +1553,8 @@ bool BaseChannelFileTransferType::remoteProvideFile(QIODevice *input, qulonglong
 
     if (!errorText.isEmpty()) {
         errorLabel:
-        warning() << "BaseChannelFileTransferType::remoteProvideFile(): Invalid call:" << errorText;
+        tpWarning(logService) <<
+            "BaseChannelFileTransferType::remoteProvideFile(): Invalid call:" << errorText;
         setState(Tp::FileTransferStateCancelled, Tp::FileTransferStateChangeReasonLocalError);
 
         return false;
@@ -1594,12 +1605,17 @@ struct TP_QT_NO_EXPORT BaseChannelRoomListType::Private {
             const QString &server)
         : server(server),
           listingRooms(false),
+          listingFinishedPending(false),
+          maxRoomsPerSignal(500),
           adaptee(new BaseChannelRoomListType::Adaptee(parent))
     {
     }
 
     QString server;
     bool listingRooms;
+    bool listingFinishedPending;
+    uint maxRoomsPerSignal;
+    QQueue<RoomInfoList> pendingRooms;
     ListRoomsCallback listRoomsCB;
     StopListingCallback stopListingCB;
     BaseChannelRoomListType::Adaptee *adaptee;
@@ -1629,7 +1645,7 @@ void BaseChannelRoomListType::Adaptee::getListingRooms(
 void BaseChannelRoomListType::Adaptee::listRooms(
         const Tp::Service::ChannelTypeRoomListAdaptor::ListRoomsContextPtr &context)
 {
-    debug() << "BaseChannelRoomListType::Adaptee::listRooms";
+    tpDebug(logService) << "BaseChannelRoomListType::Adaptee::listRooms";
     DBusError error;
     mInterface->listRooms(&error);
     if (error.isValid()) {
@@ -1642,7 +1658,7 @@ void BaseChannelRoomListType::Adaptee::listRooms(
 void BaseChannelRoomListType::Adaptee::stopListing(
         const Tp::Service::ChannelTypeRoomListAdaptor::StopListingContextPtr &context)
 {
-    debug() << "BaseChannelRoomListType::Adaptee::stopListing";
+    tpDebug(logService) << "BaseChannelRoomListType::Adaptee::stopListing";
     DBusError error;
     mInterface->stopListing(&error);
     if (error.isValid()) {
@@ -1716,6 +1732,15 @@ void BaseChannelRoomListType::setListingRooms(bool listing)
     }
 
     mPriv->listingRooms = listing;
+
+    // ListingRooms(False) must come after the last GotRooms, so delay it until all the
+    // queued rooms are out. ListingRooms(True) is never delayed, and cancels a delayed stop.
+    mPriv->listingFinishedPending = false;
+    if (!listing && !mPriv->pendingRooms.isEmpty()) {
+        mPriv->listingFinishedPending = true;
+        return;
+    }
+
     QMetaObject::invokeMethod(mPriv->adaptee, "listingRooms", Q_ARG(bool, listing)); //Can simply use emit in Qt5
 }
 
@@ -1744,12 +1769,92 @@ void BaseChannelRoomListType::stopListing(DBusError *error)
         error->set(TP_QT_ERROR_NOT_IMPLEMENTED, QLatin1String("Not implemented"));
         return;
     }
-    return mPriv->stopListingCB(error);
+    mPriv->stopListingCB(error);
+    if (!error->isValid()) {
+        mPriv->pendingRooms.clear();
+        if (mPriv->listingFinishedPending) {
+            mPriv->listingFinishedPending = false;
+            QMetaObject::invokeMethod(mPriv->adaptee, "listingRooms", Q_ARG(bool, false)); //Can simply use emit in Qt5
+        }
+    }
 }
 
+/**
+ * Signal information about \a rooms to the clients.
+ *
+ * Lists longer than maxRoomsPerSignal() are split into several GotRooms signals, one of them
+ * being emitted per main loop iteration, so that listing a large server neither produces huge
+ * D-Bus messages nor blocks the connection manager. A call to setListingRooms(false) made
+ * while rooms are still queued takes effect after the last of them has been signalled.
+ *
+ * \param rooms The rooms to signal.
+ * \sa setMaxRoomsPerSignal()
+ */
 void BaseChannelRoomListType::gotRooms(const Tp::RoomInfoList &rooms)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee, "gotRooms", Q_ARG(Tp::RoomInfoList, rooms)); //Can simply use emit in Qt5
+    uint max = mPriv->maxRoomsPerSignal;
+    if (mPriv->pendingRooms.isEmpty() &&
+        (max == 0 || static_cast<uint>(rooms.size()) <= max)) {
+        QMetaObject::invokeMethod(mPriv->adaptee, "gotRooms", Q_ARG(Tp::RoomInfoList, rooms)); //Can simply use emit in Qt5
+        return;
+    }
+
+    bool wasIdle = mPriv->pendingRooms.isEmpty();
+    if (max == 0) {
+        mPriv->pendingRooms.enqueue(rooms);
+    } else {
+        for (int i = 0; i < rooms.size(); i += max) {
+            mPriv->pendingRooms.enqueue(rooms.mid(i, max));
+        }
+    }
+
+    if (wasIdle) {
+        emitNextRooms();
+    }
+}
+
+/**
+ * Return the maximum number of rooms signalled in a single GotRooms signal.
+ *
+ * \return The maximum number of rooms per signal, or 0 if lists are never split.
+ * \sa setMaxRoomsPerSignal(), gotRooms()
+ */
+uint BaseChannelRoomListType::maxRoomsPerSignal() const
+{
+    return mPriv->maxRoomsPerSignal;
+}
+
+/**
+ * Set the maximum number of rooms signalled in a single GotRooms signal.
+ *
+ * The default is 500.
+ *
+ * \param count The maximum number of rooms per signal, or 0 to never split lists.
+ * \sa maxRoomsPerSignal(), gotRooms()
+ */
+void BaseChannelRoomListType::setMaxRoomsPerSignal(uint count)
+{
+    mPriv->maxRoomsPerSignal = count;
+}
+
+void BaseChannelRoomListType::emitNextRooms()
+{
+    if (mPriv->pendingRooms.isEmpty()) {
+        return;
+    }
+
+    QMetaObject::invokeMethod(mPriv->adaptee, "gotRooms",
+            Q_ARG(Tp::RoomInfoList, mPriv->pendingRooms.dequeue())); //Can simply use emit in Qt5
+
+    if (!mPriv->pendingRooms.isEmpty()) {
+        QTimer::singleShot(0, this, SLOT(emitNextRooms()));
+        return;
+    }
+
+    if (mPriv->listingFinishedPending) {
+        mPriv->listingFinishedPending = false;
+        QMetaObject::invokeMethod(mPriv->adaptee, "listingRooms", Q_ARG(bool, false)); //Can simply use emit in Qt5
+    }
 }
 
 //Chan.T.ServerAuthentication
@@ -1875,7 +1980,7 @@ QVariantMap BaseChannelCaptchaAuthenticationInterface::Adaptee::captchaErrorDeta
 
 void BaseChannelCaptchaAuthenticationInterface::Adaptee::getCaptchas(const Tp::Service::ChannelInterfaceCaptchaAuthenticationAdaptor::GetCaptchasContextPtr &context)
 {
-    debug() << "BaseChannelCaptchaAuthenticationInterface::Adaptee::getCaptchas";
+    tpDebug(logService) << "BaseChannelCaptchaAuthenticationInterface::Adaptee::getCaptchas";
     DBusError error;
     Tp::CaptchaInfoList captchaInfo;
     uint numberRequired;
@@ -1890,7 +1995,8 @@ void BaseChannelCaptchaAuthenticationInterface::Adaptee::getCaptchas(const Tp::S
 
 void BaseChannelCaptchaAuthenticationInterface::Adaptee::getCaptchaData(uint ID, const QString& mimeType, const Tp::Service::ChannelInterfaceCaptchaAuthenticationAdaptor::GetCaptchaDataContextPtr &context)
 {
-    debug() << "BaseChannelCaptchaAuthenticationInterface::Adaptee::getCaptchaData " << ID << mimeType;
+    tpDebug(logService) << "BaseChannelCaptchaAuthenticationInterface::Adaptee::getCaptchaData " <<
+        ID << mimeType;
     DBusError error;
     QByteArray captchaData = mInterface->mPriv->getCaptchaDataCB(ID, mimeType, &error);
     if (error.isValid()) {
@@ -1902,7 +2008,7 @@ void BaseChannelCaptchaAuthenticationInterface::Adaptee::getCaptchaData(uint ID,
 
 void BaseChannelCaptchaAuthenticationInterface::Adaptee::answerCaptchas(const Tp::CaptchaAnswers& answers, const Tp::Service::ChannelInterfaceCaptchaAuthenticationAdaptor::AnswerCaptchasContextPtr &context)
 {
-    debug() << "BaseChannelCaptchaAuthenticationInterface::Adaptee::answerCaptchas";
+    tpDebug(logService) << "BaseChannelCaptchaAuthenticationInterface::Adaptee::answerCaptchas";
     DBusError error;
     mInterface->mPriv->answerCaptchasCB(answers, &error);
     if (error.isValid()) {
@@ -1914,7 +2020,7 @@ void BaseChannelCaptchaAuthenticationInterface::Adaptee::answerCaptchas(const Tp
 
 void BaseChannelCaptchaAuthenticationInterface::Adaptee::cancelCaptcha(uint reason, const QString& debugMessage, const Tp::Service::ChannelInterfaceCaptchaAuthenticationAdaptor::CancelCaptchaContextPtr &context)
 {
-    debug() << "BaseChannelCaptchaAuthenticationInterface::Adaptee::cancelCaptcha "
+    tpDebug(logService) << "BaseChannelCaptchaAuthenticationInterface::Adaptee::cancelCaptcha "
              << reason << " " << debugMessage;
     DBusError error;
     mInterface->mPriv->cancelCaptchaCB(reason, debugMessage, &error);
@@ -2115,7 +2221,7 @@ bool BaseChannelSASLAuthenticationInterface::Adaptee::maySaveResponse() const
 void BaseChannelSASLAuthenticationInterface::Adaptee::startMechanism(const QString &mechanism,
         const Tp::Service::ChannelInterfaceSASLAuthenticationAdaptor::StartMechanismContextPtr &context)
 {
-    debug() << "BaseChannelSASLAuthenticationInterface::Adaptee::startMechanism";
+    tpDebug(logService) << "BaseChannelSASLAuthenticationInterface::Adaptee::startMechanism";
     DBusError error;
     mInterface->startMechanism(mechanism, &error);
     if (error.isValid()) {
@@ -2128,7 +2234,8 @@ void BaseChannelSASLAuthenticationInterface::Adaptee::startMechanism(const QStri
 void BaseChannelSASLAuthenticationInterface::Adaptee::startMechanismWithData(const QString &mechanism, const QByteArray &initialData,
         const Tp::Service::ChannelInterfaceSASLAuthenticationAdaptor::StartMechanismWithDataContextPtr &context)
 {
-    debug() << "BaseChannelSASLAuthenticationInterface::Adaptee::startMechanismWithData";
+    tpDebug(logService) <<
+        "BaseChannelSASLAuthenticationInterface::Adaptee::startMechanismWithData";
     DBusError error;
     mInterface->startMechanismWithData(mechanism, initialData, &error);
     if (error.isValid()) {
@@ -2141,7 +2248,7 @@ void BaseChannelSASLAuthenticationInterface::Adaptee::startMechanismWithData(con
 void BaseChannelSASLAuthenticationInterface::Adaptee::respond(const QByteArray &responseData,
         const Tp::Service::ChannelInterfaceSASLAuthenticationAdaptor::RespondContextPtr &context)
 {
-    debug() << "BaseChannelSASLAuthenticationInterface::Adaptee::respond";
+    tpDebug(logService) << "BaseChannelSASLAuthenticationInterface::Adaptee::respond";
     DBusError error;
     mInterface->respond(responseData, &error);
     if (error.isValid()) {
@@ -2154,7 +2261,7 @@ void BaseChannelSASLAuthenticationInterface::Adaptee::respond(const QByteArray &
 void BaseChannelSASLAuthenticationInterface::Adaptee::acceptSasl(
         const Tp::Service::ChannelInterfaceSASLAuthenticationAdaptor::AcceptSASLContextPtr &context)
 {
-    debug() << "BaseChannelSASLAuthenticationInterface::Adaptee::acceptSasl";
+    tpDebug(logService) << "BaseChannelSASLAuthenticationInterface::Adaptee::acceptSasl";
     DBusError error;
     mInterface->acceptSasl(&error);
     if (error.isValid()) {
@@ -2167,7 +2274,7 @@ void BaseChannelSASLAuthenticationInterface::Adaptee::acceptSasl(
 void BaseChannelSASLAuthenticationInterface::Adaptee::abortSasl(uint reason, const QString &debugMessage,
         const Tp::Service::ChannelInterfaceSASLAuthenticationAdaptor::AbortSASLContextPtr &context)
 {
-    debug() << "BaseChannelSASLAuthenticationInterface::Adaptee::abortSasl";
+    tpDebug(logService) << "BaseChannelSASLAuthenticationInterface::Adaptee::abortSasl";
     DBusError error;
     mInterface->abortSasl(reason, debugMessage, &error);
     if (error.isValid()) {
@@ -2514,7 +2621,7 @@ Tp::ChatStateMap BaseChannelChatStateInterface::Adaptee::chatStates() const
 void BaseChannelChatStateInterface::Adaptee::setChatState(uint state,
         const Tp::Service::ChannelInterfaceChatStateAdaptor::SetChatStateContextPtr &context)
 {
-    debug() << "BaseChannelChatStateInterface::Adaptee::setChatState";
+    tpDebug(logService) << "BaseChannelChatStateInterface::Adaptee::setChatState";
     DBusError error;
     mInterface->setChatState(state, &error);
     if (error.isValid()) {
@@ -3604,7 +3711,7 @@ bool BaseChannelRoomConfigInterface::Adaptee::configurationRetrieved() const
 void BaseChannelRoomConfigInterface::Adaptee::updateConfiguration(const QVariantMap &properties,
         const Tp::Service::ChannelInterfaceRoomConfigAdaptor::UpdateConfigurationContextPtr &context)
 {
-    debug() << "BaseChannelRoomConfigInterface::Adaptee::updateConfiguration";
+    tpDebug(logService) << "BaseChannelRoomConfigInterface::Adaptee::updateConfiguration";
     DBusError error;
     mInterface->updateConfiguration(properties, &error);
     if (error.isValid()) {
@@ -336,9 +336,15 @@ public:
 
     void gotRooms(const Tp::RoomInfoList &rooms);
 
+    uint maxRoomsPerSignal() const;
+    void setMaxRoomsPerSignal(uint count);
+
 protected:
     BaseChannelRoomListType(const QString &server);
 
+private Q_SLOTS:
+    TP_QT_NO_EXPORT void emitNextRooms();
+
 private:
     void createAdaptor();
 
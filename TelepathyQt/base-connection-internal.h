@@ -27,6 +27,8 @@
 #include <TelepathyQt/Types>
 #include "TelepathyQt/debug-internal.h"
 
+#include <QDBusAbstractAdaptor>
+
 namespace Tp
 {
 
@@ -92,6 +94,30 @@ private:
     Service::ConnectionAdaptor *mAdaptor;
 };
 
+// Not generated from the spec: the interface is a draft only known to TelepathyQt on both ends
+class TP_QT_NO_EXPORT BaseConnectionPeerToPeerAdaptor : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.Telepathy.Connection.Interface.PeerToPeer.DRAFT")
+    Q_CLASSINFO("D-Bus Introspection", ""
+"  <interface name=\"org.freedesktop.Telepathy.Connection.Interface.PeerToPeer.DRAFT\" >\n"
+"    <property name=\"Address\" type=\"s\" access=\"read\" />\n"
+"  </interface>\n"
+        "")
+
+    Q_PROPERTY(QString Address READ Address)
+
+public:
+    BaseConnectionPeerToPeerAdaptor(BaseConnection *connection, QObject *parent);
+    virtual ~BaseConnectionPeerToPeerAdaptor();
+
+public: // Properties
+    QString Address() const;
+
+private:
+    BaseConnection *mConnection;
+};
+
 class TP_QT_NO_EXPORT BaseConnectionRequestsInterface::Adaptee : public QObject
 {
     Q_OBJECT
@@ -103,7 +129,7 @@ public:
     ~Adaptee();
     Tp::ChannelDetailsList channels() const;
     Tp::RequestableChannelClassList requestableChannelClasses() const {
-        debug() << "BaseConnectionRequestsInterface::requestableChannelClasses";
+        tpDebug(logService) << "BaseConnectionRequestsInterface::requestableChannelClasses";
         return mInterface->requestableChannelClasses;
     }
 
@@ -27,12 +27,17 @@
 #include "TelepathyQt/_gen/base-connection-internal.moc.hpp"
 
 #include "TelepathyQt/debug-internal.h"
+#include "TelepathyQt/peer-transport-internal.h"
 
 #include <TelepathyQt/BaseChannel>
 #include <TelepathyQt/DBusObject>
 #include <TelepathyQt/Utils>
 #include <TelepathyQt/AbstractProtocolInterface>
+#include <QDBusServer>
+#include <QDir>
+#include <QFile>
 #include <QString>
+#include <QTimer>
 #include <QVariantMap>
 
 namespace Tp
@@ -48,10 +53,16 @@ struct TP_QT_NO_EXPORT BaseConnection::Private {
           parameters(parameters),
           selfHandle(0),
           status(Tp::ConnectionStatusDisconnected),
-          adaptee(new BaseConnection::Adaptee(dbusConnection, connection))
+          adaptee(new BaseConnection::Adaptee(dbusConnection, connection)),
+          peerToPeerEnabled(false),
+          peerServer(0)
     {
     }
 
+    bool listenForPeers(DBusError *error);
+    void exportToPeer(QDBusConnection peer, const BaseChannelPtr &channel);
+    void prunePeers();
+
     BaseConnection *connection;
     QString cmName;
     QString protocolName;
@@ -66,8 +77,79 @@ struct TP_QT_NO_EXPORT BaseConnection::Private {
     InspectHandlesCallback inspectHandlesCB;
     RequestHandlesCallback requestHandlesCB;
     BaseConnection::Adaptee *adaptee;
+
+    bool peerToPeerEnabled;
+    QDBusServer *peerServer;
+    QList<QDBusConnection> peers;
 };
 
+bool BaseConnection::Private::listenForPeers(DBusError *error)
+{
+    // Peers are only accepted once they pass D-Bus' EXTERNAL authentication, which checks that
+    // they run as the same user; that is what restricts access to the socket. Still, prefer the
+    // per-user runtime directory for it, and a filesystem socket rather than an abstract one, so
+    // other users can't even reach it.
+    QString dir = QFile::decodeName(qgetenv("XDG_RUNTIME_DIR"));
+    if (dir.isEmpty()) {
+        dir = QDir::tempPath();
+    }
+
+    peerServer = new QDBusServer(QLatin1String("unix:dir=") + dir, connection);
+    if (!peerServer->isConnected()) {
+        error->set(peerServer->lastError().name(), peerServer->lastError().message());
+        delete peerServer;
+        peerServer = 0;
+        return false;
+    }
+
+    new BaseConnectionPeerToPeerAdaptor(connection, connection->dbusObject());
+
+    connection->connect(peerServer,
+            SIGNAL(newConnection(QDBusConnection)),
+            SLOT(onPeerConnected(QDBusConnection)));
+
+    tpDebug(logService) << "Connection listening for peers at" << peerServer->address();
+    return true;
+}
+
+void BaseConnection::Private::exportToPeer(QDBusConnection peer, const BaseChannelPtr &channel)
+{
+    // Objects unregister themselves from every connection when destroyed, so closed channels
+    // need no explicit cleanup here
+    peer.registerObject(channel->objectPath(), channel->dbusObject());
+}
+
+void BaseConnection::Private::prunePeers()
+{
+    QList<QDBusConnection>::iterator i = peers.begin();
+    while (i != peers.end()) {
+        if (!i->isConnected()) {
+            tpDebug(logService) << "Peer" << i->name() << "of" << connection->objectPath() <<
+                "went away";
+            QDBusConnection::disconnectFromPeer(i->name());
+            i = peers.erase(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+BaseConnectionPeerToPeerAdaptor::BaseConnectionPeerToPeerAdaptor(BaseConnection *connection,
+        QObject *parent)
+    : QDBusAbstractAdaptor(parent),
+      mConnection(connection)
+{
+}
+
+BaseConnectionPeerToPeerAdaptor::~BaseConnectionPeerToPeerAdaptor()
+{
+}
+
+QString BaseConnectionPeerToPeerAdaptor::Address() const
+{
+    return mConnection->peerToPeerAddress();
+}
+
 BaseConnection::Adaptee::Adaptee(const QDBusConnection &dbusConnection,
                                  BaseConnection *connection)
     : QObject(connection),
@@ -86,6 +168,9 @@ QStringList BaseConnection::Adaptee::interfaces() const
     foreach(const AbstractConnectionInterfacePtr &iface, mConnection->interfaces()) {
         ret << iface->interfaceName();
     }
+    if (mConnection->mPriv->peerServer) {
+        ret << TP_QT_IFACE_CONNECTION_INTERFACE_PEER_TO_PEER_DRAFT;
+    }
     return ret;
 }
 
@@ -129,7 +214,7 @@ void BaseConnection::Adaptee::connect(const Tp::Service::ConnectionAdaptor::Conn
 
 void BaseConnection::Adaptee::disconnect(const Tp::Service::ConnectionAdaptor::DisconnectContextPtr &context)
 {
-    debug() << "BaseConnection::Adaptee::disconnect";
+    tpDebug(logService) << "BaseConnection::Adaptee::disconnect";
 
     foreach(const BaseChannelPtr &channel, mConnection->mPriv->channels) {
         /* BaseChannel::closed() signal triggers removeChannel() method call with proper cleanup */
@@ -192,7 +277,7 @@ void BaseConnection::Adaptee::listChannels(const Service::ConnectionAdaptor::Lis
 void BaseConnection::Adaptee::requestChannel(const QString &type, uint handleType, uint handle, bool suppressHandler,
         const Tp::Service::ConnectionAdaptor::RequestChannelContextPtr &context)
 {
-    debug() << "BaseConnection::Adaptee::requestChannel (deprecated)";
+    tpDebug(logService) << "BaseConnection::Adaptee::requestChannel (deprecated)";
     DBusError error;
 
     QVariantMap request;
@@ -262,6 +347,10 @@ BaseConnection::~BaseConnection()
         channel->close();
     }
 
+    foreach (const QDBusConnection &peer, mPriv->peers) {
+        QDBusConnection::disconnectFromPeer(peer.name());
+    }
+
     delete mPriv;
 }
 
@@ -358,13 +447,14 @@ void BaseConnection::setSelfContact(uint selfHandle, const QString &selfID)
 
 uint BaseConnection::status() const
 {
-    debug() << "BaseConnection::status = " << mPriv->status << " " << this;
+    tpDebug(logService) << "BaseConnection::status = " << mPriv->status << " " << this;
     return mPriv->status;
 }
 
 void BaseConnection::setStatus(uint newStatus, uint reason)
 {
-    debug() << "BaseConnection::setStatus " << newStatus << " " << reason << " " << this;
+    tpDebug(logService) << "BaseConnection::setStatus " << newStatus << " " << reason << " " <<
+        this;
     bool changed = (newStatus != mPriv->status);
     mPriv->status = newStatus;
     if (changed)
@@ -403,10 +493,12 @@ Tp::BaseChannelPtr BaseConnection::createChannel(const QVariantMap &request, boo
     if ((channel->targetHandle() != 0) && targetID.isEmpty()) {
         QStringList list = mPriv->inspectHandlesCB(channel->targetHandleType(),  UIntList() << channel->targetHandle(), error);
         if (error->isValid()) {
-            debug() << "BaseConnection::createChannel: could not resolve handle " << channel->targetHandle();
+            tpDebug(logService) << "BaseConnection::createChannel: could not resolve handle " <<
+                channel->targetHandle();
             return BaseChannelPtr();
         } else {
-            debug() << "BaseConnection::createChannel: found targetID " << *list.begin();
+            tpDebug(logService) << "BaseConnection::createChannel: found targetID " <<
+                *list.begin();
             targetID = *list.begin();
         }
         channel->setTargetID(targetID);
@@ -420,10 +512,12 @@ Tp::BaseChannelPtr BaseConnection::createChannel(const QVariantMap &request, boo
     if ((channel->initiatorHandle() != 0) && initiatorID.isEmpty()) {
         QStringList list = mPriv->inspectHandlesCB(HandleTypeContact, UIntList() << channel->initiatorHandle(), error);
         if (error->isValid()) {
-            debug() << "BaseConnection::createChannel: could not resolve handle " << channel->initiatorHandle();
+            tpDebug(logService) << "BaseConnection::createChannel: could not resolve handle " <<
+                channel->initiatorHandle();
             return BaseChannelPtr();
         } else {
-            debug() << "BaseConnection::createChannel: found initiatorID " << *list.begin();
+            tpDebug(logService) << "BaseConnection::createChannel: found initiatorID " <<
+                *list.begin();
             initiatorID = *list.begin();
         }
         channel->setInitiatorID(initiatorID);
@@ -474,7 +568,7 @@ Tp::UIntList BaseConnection::requestHandles(uint handleType, const QStringList &
 
 Tp::ChannelInfoList BaseConnection::channelsInfo()
 {
-    debug() << "BaseConnection::channelsInfo:";
+    tpDebug(logService) << "BaseConnection::channelsInfo:";
     Tp::ChannelInfoList list;
     foreach(const BaseChannelPtr & c, mPriv->channels) {
         Tp::ChannelInfo info;
@@ -482,7 +576,7 @@ Tp::ChannelInfoList BaseConnection::channelsInfo()
         info.channelType = c->channelType();
         info.handle = c->targetHandle();
         info.handleType = c->targetHandleType();
-        debug() << "BaseConnection::channelsInfo " << info.channel.path();
+        tpDebug(logService) << "BaseConnection::channelsInfo " << info.channel.path();
         list << info;
     }
     return list;
@@ -575,7 +669,7 @@ Tp::BaseChannelPtr BaseConnection::ensureChannel(const QVariantMap &request, boo
 void BaseConnection::addChannel(BaseChannelPtr channel, bool suppressHandler)
 {
     if (mPriv->channels.contains(channel)) {
-        warning() << "BaseConnection::addChannel: Channel already added.";
+        tpWarning(logService) << "BaseConnection::addChannel: Channel already added.";
         return;
     }
 
@@ -603,6 +697,13 @@ void BaseConnection::addChannel(BaseChannelPtr channel, bool suppressHandler)
     QObject::connect(channel.data(),
                      SIGNAL(closed()),
                      SLOT(removeChannel()));
+
+    if (channel->isRegistered()) {
+        mPriv->prunePeers();
+        foreach (const QDBusConnection &peer, mPriv->peers) {
+            mPriv->exportToPeer(peer, channel);
+        }
+    }
 }
 
 void BaseConnection::removeChannel()
@@ -666,24 +767,27 @@ AbstractConnectionInterfacePtr BaseConnection::interface(const QString &interfac
 bool BaseConnection::plugInterface(const AbstractConnectionInterfacePtr &interface)
 {
     if (isRegistered()) {
-        warning() << "Unable to plug protocol interface " << interface->interfaceName() <<
+        tpWarning(logService) << "Unable to plug protocol interface " <<
+            interface->interfaceName() <<
                   "- protocol already registered";
         return false;
     }
 
     if (interface->isRegistered()) {
-        warning() << "Unable to plug protocol interface" << interface->interfaceName() <<
+        tpWarning(logService) << "Unable to plug protocol interface" <<
+            interface->interfaceName() <<
                   "- interface already registered";
         return false;
     }
 
     if (mPriv->interfaces.contains(interface->interfaceName())) {
-        warning() << "Unable to plug protocol interface" << interface->interfaceName() <<
+        tpWarning(logService) << "Unable to plug protocol interface" <<
+            interface->interfaceName() <<
                   "- another interface with same name already plugged";
         return false;
     }
 
-    debug() << "Interface" << interface->interfaceName() << "plugged";
+    tpDebug(logService) << "Interface" << interface->interfaceName() << "plugged";
     mPriv->interfaces.insert(interface->interfaceName(), interface);
     interface->setBaseConnection(this);
     return true;
@@ -712,36 +816,131 @@ bool BaseConnection::registerObject(DBusError *error)
             error->set(TP_QT_ERROR_INVALID_ARGUMENT,
                        mPriv->protocolName + QLatin1String("is not a valid protocol name"));
         }
-        debug() << "Unable to register connection - invalid protocol name";
+        tpDebug(logService) << "Unable to register connection - invalid protocol name";
         return false;
     }
 
     QString escapedProtocolName = mPriv->protocolName;
     escapedProtocolName.replace(QLatin1Char('-'), QLatin1Char('_'));
     QString name = uniqueName();
-    debug() << "cmName: " << mPriv->cmName << " escapedProtocolName: " << escapedProtocolName << " name:" << name;
+    tpDebug(logService) << "cmName: " << mPriv->cmName << " escapedProtocolName: " <<
+        escapedProtocolName << " name:" << name;
     QString busName = QString(QLatin1String("%1%2.%3.%4"))
                       .arg(TP_QT_CONNECTION_BUS_NAME_BASE, mPriv->cmName, escapedProtocolName, name);
     QString objectPath = QString(QLatin1String("%1%2/%3/%4"))
                          .arg(TP_QT_CONNECTION_OBJECT_PATH_BASE, mPriv->cmName, escapedProtocolName, name);
-    debug() << "busName: " << busName << " objectName: " << objectPath;
+    tpDebug(logService) << "busName: " << busName << " objectName: " << objectPath;
     DBusError _error;
 
-    debug() << "Connection: registering interfaces  at " << dbusObject();
+    tpDebug(logService) << "Connection: registering interfaces  at " << dbusObject();
     foreach(const AbstractConnectionInterfacePtr & iface, mPriv->interfaces) {
         if (!iface->registerInterface(dbusObject())) {
             // lets not fail if an optional interface fails registering, lets warn only
-            warning() << "Unable to register interface" << iface->interfaceName();
+            tpWarning(logService) << "Unable to register interface" << iface->interfaceName();
+        }
+    }
+
+    if (mPriv->peerToPeerEnabled) {
+        DBusError peerError;
+        if (!mPriv->listenForPeers(&peerError)) {
+            // The bus keeps working, so a connection without the direct socket is still usable
+            tpWarning(logService) << "Unable to listen for peers:" << peerError.name() <<
+                peerError.message();
         }
     }
 
     bool ret = registerObject(busName, objectPath, &_error);
+    if (!ret && mPriv->peerServer) {
+        delete mPriv->peerServer;
+        mPriv->peerServer = 0;
+    }
     if (!ret && error) {
         error->set(_error.name(), _error.message());
     }
     return ret;
 }
 
+/**
+ * Return whether this connection will also accept direct peer-to-peer D-Bus connections.
+ *
+ * \return \c true if peer-to-peer mode is enabled, \c false otherwise.
+ * \sa setPeerToPeerEnabled(), peerToPeerAddress()
+ */
+bool BaseConnection::isPeerToPeerEnabled() const
+{
+    return mPriv->peerToPeerEnabled;
+}
+
+/**
+ * Set whether this connection should also accept direct peer-to-peer D-Bus connections.
+ *
+ * When enabled, registerObject() opens a private socket next to the bus registration and
+ * advertises its address through the
+ * <tt>org.freedesktop.Telepathy.Connection.Interface.PeerToPeer.DRAFT</tt> interface.
+ * Clients running as the same user may then connect to it and make method calls on, and
+ * receive signals from, this connection and its channels without going through the bus
+ * daemon. The objects stay registered on the bus as usual, so other clients are unaffected.
+ *
+ * This must be called before registerObject(); later calls have no effect.
+ *
+ * \param enabled Whether peer-to-peer mode should be enabled.
+ * \sa isPeerToPeerEnabled(), peerToPeerAddress()
+ */
+void BaseConnection::setPeerToPeerEnabled(bool enabled)
+{
+    if (isRegistered()) {
+        tpWarning(logService) << "Unable to change peer-to-peer mode - connection already registered";
+        return;
+    }
+
+    mPriv->peerToPeerEnabled = enabled;
+}
+
+/**
+ * Return the D-Bus address clients can use to connect directly to this connection.
+ *
+ * This is only valid after this connection has been registered with peer-to-peer mode
+ * enabled.
+ *
+ * \return The peer-to-peer address, or an empty string if not listening for peers.
+ * \sa setPeerToPeerEnabled()
+ */
+QString BaseConnection::peerToPeerAddress() const
+{
+    return mPriv->peerServer ? mPriv->peerServer->address() : QString();
+}
+
+void BaseConnection::onPeerConnected(const QDBusConnection &peer)
+{
+    tpDebug(logService) << "Peer connected to" << objectPath() << "as" << peer.name();
+
+    QDBusConnection conn(peer);
+    conn.registerObject(objectPath(), dbusObject());
+    foreach (const BaseChannelPtr &channel, mPriv->channels) {
+        if (channel->isRegistered()) {
+            mPriv->exportToPeer(conn, channel);
+        }
+    }
+
+    mPriv->peers.append(conn);
+
+    // Forget about the peer once it goes away, rather than when the next channel is exported
+    conn.connect(QString(), QLatin1String("/org/freedesktop/DBus/Local"),
+            QLatin1String("org.freedesktop.DBus.Local"), QLatin1String("Disconnected"),
+            this, SLOT(onPeerDisconnected()));
+}
+
+void BaseConnection::onPeerDisconnected()
+{
+    // The connection may only be marked as disconnected once the signal has been delivered
+    QTimer::singleShot(0, this, SLOT(prunePeers()));
+}
+
+void BaseConnection::prunePeers()
+{
+    mPriv->prunePeers();
+}
+
 /**
  * Return a unique name for this connection.
  *
@@ -1019,7 +1218,7 @@ void BaseConnectionContactsInterface::Adaptee::getContactAttributes(const Tp::UI
 void BaseConnectionContactsInterface::Adaptee::getContactByID(const QString &identifier, const QStringList &interfaces,
         const Tp::Service::ConnectionInterfaceContactsAdaptor::GetContactByIDContextPtr &context)
 {
-    debug() << "BaseConnectionContactsInterface::Adaptee::getContactByID";
+    tpDebug(logService) << "BaseConnectionContactsInterface::Adaptee::getContactByID";
     DBusError error;
     uint handle;
     QVariantMap attributes;
@@ -1160,7 +1359,7 @@ QStringList BaseConnectionRoomsInterface::Adaptee::roomAttributeInterfaces() con
 void BaseConnectionRoomsInterface::Adaptee::getRoomAttributes(const Tp::UIntList &handles, const QStringList &interfaces,
         const Tp::Service::ConnectionInterfaceRoomsAdaptor::GetRoomAttributesContextPtr &context)
 {
-    debug() << "BaseConnectionRoomsInterface::Adaptee::getRoomAttributes";
+    tpDebug(logService) << "BaseConnectionRoomsInterface::Adaptee::getRoomAttributes";
     DBusError error;
     Tp::RoomAttributesMap attributes = mInterface->getRoomAttributes(handles, interfaces, &error);
     if (error.isValid()) {
@@ -1173,7 +1372,7 @@ void BaseConnectionRoomsInterface::Adaptee::getRoomAttributes(const Tp::UIntList
 void BaseConnectionRoomsInterface::Adaptee::getRoomByID(const QString &identifier, const QStringList &interfaces,
         const Tp::Service::ConnectionInterfaceRoomsAdaptor::GetRoomByIDContextPtr &context)
 {
-    debug() << "BaseConnectionRoomsInterface::Adaptee::getRoomByID" << identifier;
+    tpDebug(logService) << "BaseConnectionRoomsInterface::Adaptee::getRoomByID" << identifier;
     DBusError error;
     uint handle;
     QVariantMap attributes;
@@ -1424,14 +1623,15 @@ void BaseConnectionSimplePresenceInterface::Adaptee::setPresence(const QString &
 
     SimpleStatusSpecMap::Iterator i = mInterface->mPriv->statuses.find(status);
     if (i == mInterface->mPriv->statuses.end()) {
-        warning() << "BaseConnectionSimplePresenceInterface::Adaptee::setPresence: status is not in statuses";
+        tpWarning(logService) <<
+            "BaseConnectionSimplePresenceInterface::Adaptee::setPresence: status is not in statuses";
         context->setFinishedWithError(TP_QT_ERROR_INVALID_ARGUMENT, QLatin1String("status not in statuses"));
         return;
     }
 
     QString statusMessage = statusMessage_;
     if ((uint)statusMessage.length() > mInterface->mPriv->maximumStatusMessageLength) {
-        debug() << "BaseConnectionSimplePresenceInterface::Adaptee::setPresence: "
+        tpDebug(logService) << "BaseConnectionSimplePresenceInterface::Adaptee::setPresence: "
                 << "truncating status to " << mInterface->mPriv->maximumStatusMessageLength;
         statusMessage = statusMessage.left(mInterface->mPriv->maximumStatusMessageLength);
     }
@@ -1529,7 +1729,7 @@ bool BaseConnectionContactListInterface::Adaptee::downloadAtConnection() const
 void BaseConnectionContactListInterface::Adaptee::getContactListAttributes(const QStringList &interfaces, bool hold,
         const Tp::Service::ConnectionInterfaceContactListAdaptor::GetContactListAttributesContextPtr &context)
 {
-    debug() << "BaseConnectionContactListInterface::Adaptee::getContactListAttributes";
+    tpDebug(logService) << "BaseConnectionContactListInterface::Adaptee::getContactListAttributes";
     DBusError error;
     Tp::ContactAttributesMap attributes = mInterface->getContactListAttributes(interfaces, hold, &error);
     if (error.isValid()) {
@@ -1542,7 +1742,7 @@ void BaseConnectionContactListInterface::Adaptee::getContactListAttributes(const
 void BaseConnectionContactListInterface::Adaptee::requestSubscription(const Tp::UIntList &contacts, const QString &message,
         const Tp::Service::ConnectionInterfaceContactListAdaptor::RequestSubscriptionContextPtr &context)
 {
-    debug() << "BaseConnectionContactListInterface::Adaptee::requestSubscription";
+    tpDebug(logService) << "BaseConnectionContactListInterface::Adaptee::requestSubscription";
     DBusError error;
     mInterface->requestSubscription(contacts, message, &error);
     if (error.isValid()) {
@@ -1555,7 +1755,7 @@ void BaseConnectionContactListInterface::Adaptee::requestSubscription(const Tp::
 void BaseConnectionContactListInterface::Adaptee::authorizePublication(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceContactListAdaptor::AuthorizePublicationContextPtr &context)
 {
-    debug() << "BaseConnectionContactListInterface::Adaptee::authorizePublication";
+    tpDebug(logService) << "BaseConnectionContactListInterface::Adaptee::authorizePublication";
     DBusError error;
     mInterface->authorizePublication(contacts, &error);
     if (error.isValid()) {
@@ -1568,7 +1768,7 @@ void BaseConnectionContactListInterface::Adaptee::authorizePublication(const Tp:
 void BaseConnectionContactListInterface::Adaptee::removeContacts(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceContactListAdaptor::RemoveContactsContextPtr &context)
 {
-    debug() << "BaseConnectionContactListInterface::Adaptee::removeContacts";
+    tpDebug(logService) << "BaseConnectionContactListInterface::Adaptee::removeContacts";
     DBusError error;
     mInterface->removeContacts(contacts, &error);
     if (error.isValid()) {
@@ -1581,7 +1781,7 @@ void BaseConnectionContactListInterface::Adaptee::removeContacts(const Tp::UIntL
 void BaseConnectionContactListInterface::Adaptee::unsubscribe(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceContactListAdaptor::UnsubscribeContextPtr &context)
 {
-    debug() << "BaseConnectionContactListInterface::Adaptee::unsubscribe";
+    tpDebug(logService) << "BaseConnectionContactListInterface::Adaptee::unsubscribe";
     DBusError error;
     mInterface->unsubscribe(contacts, &error);
     if (error.isValid()) {
@@ -1594,7 +1794,7 @@ void BaseConnectionContactListInterface::Adaptee::unsubscribe(const Tp::UIntList
 void BaseConnectionContactListInterface::Adaptee::unpublish(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceContactListAdaptor::UnpublishContextPtr &context)
 {
-    debug() << "BaseConnectionContactListInterface::Adaptee::unpublish";
+    tpDebug(logService) << "BaseConnectionContactListInterface::Adaptee::unpublish";
     DBusError error;
     mInterface->unpublish(contacts, &error);
     if (error.isValid()) {
@@ -1607,7 +1807,7 @@ void BaseConnectionContactListInterface::Adaptee::unpublish(const Tp::UIntList &
 void BaseConnectionContactListInterface::Adaptee::download(
         const Tp::Service::ConnectionInterfaceContactListAdaptor::DownloadContextPtr &context)
 {
-    debug() << "BaseConnectionContactListInterface::Adaptee::download";
+    tpDebug(logService) << "BaseConnectionContactListInterface::Adaptee::download";
     DBusError error;
     mInterface->download(&error);
     if (error.isValid()) {
@@ -1870,7 +2070,7 @@ QStringList BaseConnectionContactGroupsInterface::Adaptee::groups() const
 void BaseConnectionContactGroupsInterface::Adaptee::setContactGroups(uint contact, const QStringList &groups,
         const Tp::Service::ConnectionInterfaceContactGroupsAdaptor::SetContactGroupsContextPtr &context)
 {
-    debug() << "BaseConnectionContactGroupsInterface::Adaptee::setContactGroups";
+    tpDebug(logService) << "BaseConnectionContactGroupsInterface::Adaptee::setContactGroups";
     DBusError error;
     mInterface->setContactGroups(contact, groups, &error);
     if (error.isValid()) {
@@ -1883,7 +2083,7 @@ void BaseConnectionContactGroupsInterface::Adaptee::setContactGroups(uint contac
 void BaseConnectionContactGroupsInterface::Adaptee::setGroupMembers(const QString &group, const Tp::UIntList &members,
         const Tp::Service::ConnectionInterfaceContactGroupsAdaptor::SetGroupMembersContextPtr &context)
 {
-    debug() << "BaseConnectionContactGroupsInterface::Adaptee::setGroupMembers";
+    tpDebug(logService) << "BaseConnectionContactGroupsInterface::Adaptee::setGroupMembers";
     DBusError error;
     mInterface->setGroupMembers(group, members, &error);
     if (error.isValid()) {
@@ -1896,7 +2096,7 @@ void BaseConnectionContactGroupsInterface::Adaptee::setGroupMembers(const QStrin
 void BaseConnectionContactGroupsInterface::Adaptee::addToGroup(const QString &group, const Tp::UIntList &members,
         const Tp::Service::ConnectionInterfaceContactGroupsAdaptor::AddToGroupContextPtr &context)
 {
-    debug() << "BaseConnectionContactGroupsInterface::Adaptee::addToGroup";
+    tpDebug(logService) << "BaseConnectionContactGroupsInterface::Adaptee::addToGroup";
     DBusError error;
     mInterface->addToGroup(group, members, &error);
     if (error.isValid()) {
@@ -1909,7 +2109,7 @@ void BaseConnectionContactGroupsInterface::Adaptee::addToGroup(const QString &gr
 void BaseConnectionContactGroupsInterface::Adaptee::removeFromGroup(const QString &group, const Tp::UIntList &members,
         const Tp::Service::ConnectionInterfaceContactGroupsAdaptor::RemoveFromGroupContextPtr &context)
 {
-    debug() << "BaseConnectionContactGroupsInterface::Adaptee::removeFromGroup";
+    tpDebug(logService) << "BaseConnectionContactGroupsInterface::Adaptee::removeFromGroup";
     DBusError error;
     mInterface->removeFromGroup(group, members, &error);
     if (error.isValid()) {
@@ -1922,7 +2122,7 @@ void BaseConnectionContactGroupsInterface::Adaptee::removeFromGroup(const QStrin
 void BaseConnectionContactGroupsInterface::Adaptee::removeGroup(const QString &group,
         const Tp::Service::ConnectionInterfaceContactGroupsAdaptor::RemoveGroupContextPtr &context)
 {
-    debug() << "BaseConnectionContactGroupsInterface::Adaptee::removeGroup";
+    tpDebug(logService) << "BaseConnectionContactGroupsInterface::Adaptee::removeGroup";
     DBusError error;
     mInterface->removeGroup(group, &error);
     if (error.isValid()) {
@@ -1935,7 +2135,7 @@ void BaseConnectionContactGroupsInterface::Adaptee::removeGroup(const QString &g
 void BaseConnectionContactGroupsInterface::Adaptee::renameGroup(const QString &oldName, const QString &newName,
         const Tp::Service::ConnectionInterfaceContactGroupsAdaptor::RenameGroupContextPtr &context)
 {
-    debug() << "BaseConnectionContactGroupsInterface::Adaptee::renameGroup";
+    tpDebug(logService) << "BaseConnectionContactGroupsInterface::Adaptee::renameGroup";
     DBusError error;
     mInterface->renameGroup(oldName, newName, &error);
     if (error.isValid()) {
@@ -2169,7 +2369,7 @@ Tp::FieldSpecs BaseConnectionContactInfoInterface::Adaptee::supportedFields() co
 void BaseConnectionContactInfoInterface::Adaptee::getContactInfo(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceContactInfoAdaptor::GetContactInfoContextPtr &context)
 {
-    debug() << "BaseConnectionContactInfoInterface::Adaptee::getContactInfo";
+    tpDebug(logService) << "BaseConnectionContactInfoInterface::Adaptee::getContactInfo";
     DBusError error;
     Tp::ContactInfoMap contactInfo = mInterface->getContactInfo(contacts, &error);
     if (error.isValid()) {
@@ -2182,7 +2382,7 @@ void BaseConnectionContactInfoInterface::Adaptee::getContactInfo(const Tp::UIntL
 void BaseConnectionContactInfoInterface::Adaptee::refreshContactInfo(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceContactInfoAdaptor::RefreshContactInfoContextPtr &context)
 {
-    debug() << "BaseConnectionContactInfoInterface::Adaptee::refreshContactInfo";
+    tpDebug(logService) << "BaseConnectionContactInfoInterface::Adaptee::refreshContactInfo";
     DBusError error;
     mInterface->refreshContactInfo(contacts, &error);
     if (error.isValid()) {
@@ -2195,7 +2395,7 @@ void BaseConnectionContactInfoInterface::Adaptee::refreshContactInfo(const Tp::U
 void BaseConnectionContactInfoInterface::Adaptee::requestContactInfo(uint contact,
         const Tp::Service::ConnectionInterfaceContactInfoAdaptor::RequestContactInfoContextPtr &context)
 {
-    debug() << "BaseConnectionContactInfoInterface::Adaptee::requestContactInfo";
+    tpDebug(logService) << "BaseConnectionContactInfoInterface::Adaptee::requestContactInfo";
     DBusError error;
     Tp::ContactInfoFieldList contactInfo = mInterface->requestContactInfo(contact, &error);
     if (error.isValid()) {
@@ -2208,7 +2408,7 @@ void BaseConnectionContactInfoInterface::Adaptee::requestContactInfo(uint contac
 void BaseConnectionContactInfoInterface::Adaptee::setContactInfo(const Tp::ContactInfoFieldList &contactInfo,
         const Tp::Service::ConnectionInterfaceContactInfoAdaptor::SetContactInfoContextPtr &context)
 {
-    debug() << "BaseConnectionContactInfoInterface::Adaptee::setContactInfo";
+    tpDebug(logService) << "BaseConnectionContactInfoInterface::Adaptee::setContactInfo";
     DBusError error;
     mInterface->setContactInfo(contactInfo, &error);
     if (error.isValid()) {
@@ -2511,7 +2711,7 @@ BaseConnectionAliasingInterface::Adaptee::~Adaptee()
 void BaseConnectionAliasingInterface::Adaptee::getAliasFlags(
         const Tp::Service::ConnectionInterfaceAliasingAdaptor::GetAliasFlagsContextPtr &context)
 {
-    debug() << "BaseConnectionAliasingInterface::Adaptee::getAliasFlags";
+    tpDebug(logService) << "BaseConnectionAliasingInterface::Adaptee::getAliasFlags";
     DBusError error;
     Tp::ConnectionAliasFlags aliasFlags = mInterface->getAliasFlags(&error);
     if (error.isValid()) {
@@ -2524,7 +2724,7 @@ void BaseConnectionAliasingInterface::Adaptee::getAliasFlags(
 void BaseConnectionAliasingInterface::Adaptee::requestAliases(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceAliasingAdaptor::RequestAliasesContextPtr &context)
 {
-    debug() << "BaseConnectionAliasingInterface::Adaptee::requestAliases";
+    tpDebug(logService) << "BaseConnectionAliasingInterface::Adaptee::requestAliases";
     DBusError error;
     QStringList aliases = mInterface->requestAliases(contacts, &error);
     if (error.isValid()) {
@@ -2537,7 +2737,7 @@ void BaseConnectionAliasingInterface::Adaptee::requestAliases(const Tp::UIntList
 void BaseConnectionAliasingInterface::Adaptee::getAliases(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceAliasingAdaptor::GetAliasesContextPtr &context)
 {
-    debug() << "BaseConnectionAliasingInterface::Adaptee::getAliases";
+    tpDebug(logService) << "BaseConnectionAliasingInterface::Adaptee::getAliases";
     DBusError error;
     Tp::AliasMap aliases = mInterface->getAliases(contacts, &error);
     if (error.isValid()) {
@@ -2550,7 +2750,7 @@ void BaseConnectionAliasingInterface::Adaptee::getAliases(const Tp::UIntList &co
 void BaseConnectionAliasingInterface::Adaptee::setAliases(const Tp::AliasMap &aliases,
         const Tp::Service::ConnectionInterfaceAliasingAdaptor::SetAliasesContextPtr &context)
 {
-    debug() << "BaseConnectionAliasingInterface::Adaptee::setAliases";
+    tpDebug(logService) << "BaseConnectionAliasingInterface::Adaptee::setAliases";
     DBusError error;
     mInterface->setAliases(aliases, &error);
     if (error.isValid()) {
@@ -2736,7 +2936,7 @@ uint BaseConnectionAvatarsInterface::Adaptee::maximumAvatarBytes() const
 void BaseConnectionAvatarsInterface::Adaptee::getKnownAvatarTokens(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceAvatarsAdaptor::GetKnownAvatarTokensContextPtr &context)
 {
-    debug() << "BaseConnectionAvatarsInterface::Adaptee::getKnownAvatarTokens";
+    tpDebug(logService) << "BaseConnectionAvatarsInterface::Adaptee::getKnownAvatarTokens";
     DBusError error;
     Tp::AvatarTokenMap tokens = mInterface->getKnownAvatarTokens(contacts, &error);
     if (error.isValid()) {
@@ -2749,7 +2949,7 @@ void BaseConnectionAvatarsInterface::Adaptee::getKnownAvatarTokens(const Tp::UIn
 void BaseConnectionAvatarsInterface::Adaptee::requestAvatars(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceAvatarsAdaptor::RequestAvatarsContextPtr &context)
 {
-    debug() << "BaseConnectionAvatarsInterface::Adaptee::requestAvatars";
+    tpDebug(logService) << "BaseConnectionAvatarsInterface::Adaptee::requestAvatars";
     DBusError error;
     mInterface->requestAvatars(contacts, &error);
     if (error.isValid()) {
@@ -2762,7 +2962,7 @@ void BaseConnectionAvatarsInterface::Adaptee::requestAvatars(const Tp::UIntList
 void BaseConnectionAvatarsInterface::Adaptee::setAvatar(const QByteArray &avatar, const QString &mimeType,
         const Tp::Service::ConnectionInterfaceAvatarsAdaptor::SetAvatarContextPtr &context)
 {
-    debug() << "BaseConnectionAvatarsInterface::Adaptee::setAvatar";
+    tpDebug(logService) << "BaseConnectionAvatarsInterface::Adaptee::setAvatar";
     DBusError error;
     QString token = mInterface->setAvatar(avatar, mimeType, &error);
     if (error.isValid()) {
@@ -2775,7 +2975,7 @@ void BaseConnectionAvatarsInterface::Adaptee::setAvatar(const QByteArray &avatar
 void BaseConnectionAvatarsInterface::Adaptee::clearAvatar(
         const Tp::Service::ConnectionInterfaceAvatarsAdaptor::ClearAvatarContextPtr &context)
 {
-    debug() << "BaseConnectionAvatarsInterface::Adaptee::clearAvatar";
+    tpDebug(logService) << "BaseConnectionAvatarsInterface::Adaptee::clearAvatar";
     DBusError error;
     mInterface->clearAvatar(&error);
     if (error.isValid()) {
@@ -2932,7 +3132,7 @@ BaseConnectionClientTypesInterface::Adaptee::~Adaptee()
 void BaseConnectionClientTypesInterface::Adaptee::getClientTypes(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceClientTypesAdaptor::GetClientTypesContextPtr &context)
 {
-    debug() << "BaseConnectionClientTypesInterface::Adaptee::getClientTypes";
+    tpDebug(logService) << "BaseConnectionClientTypesInterface::Adaptee::getClientTypes";
     DBusError error;
     Tp::ContactClientTypes clientTypes = mInterface->getClientTypes(contacts, &error);
     if (error.isValid()) {
@@ -2945,7 +3145,7 @@ void BaseConnectionClientTypesInterface::Adaptee::getClientTypes(const Tp::UIntL
 void BaseConnectionClientTypesInterface::Adaptee::requestClientTypes(uint contact,
         const Tp::Service::ConnectionInterfaceClientTypesAdaptor::RequestClientTypesContextPtr &context)
 {
-    debug() << "BaseConnectionClientTypesInterface::Adaptee::requestClientTypes";
+    tpDebug(logService) << "BaseConnectionClientTypesInterface::Adaptee::requestClientTypes";
     DBusError error;
     QStringList clientTypes = mInterface->requestClientTypes(contact, &error);
     if (error.isValid()) {
@@ -3059,7 +3259,8 @@ BaseConnectionContactCapabilitiesInterface::Adaptee::~Adaptee()
 void BaseConnectionContactCapabilitiesInterface::Adaptee::updateCapabilities(const Tp::HandlerCapabilitiesList &handlerCapabilities,
         const Tp::Service::ConnectionInterfaceContactCapabilitiesAdaptor::UpdateCapabilitiesContextPtr &context)
 {
-    debug() << "BaseConnectionContactCapabilitiesInterface::Adaptee::updateCapabilities";
+    tpDebug(logService) <<
+        "BaseConnectionContactCapabilitiesInterface::Adaptee::updateCapabilities";
     DBusError error;
     mInterface->updateCapabilities(handlerCapabilities, &error);
     if (error.isValid()) {
@@ -3072,7 +3273,8 @@ void BaseConnectionContactCapabilitiesInterface::Adaptee::updateCapabilities(con
 void BaseConnectionContactCapabilitiesInterface::Adaptee::getContactCapabilities(const Tp::UIntList &handles,
         const Tp::Service::ConnectionInterfaceContactCapabilitiesAdaptor::GetContactCapabilitiesContextPtr &context)
 {
-    debug() << "BaseConnectionContactCapabilitiesInterface::Adaptee::getContactCapabilities";
+    tpDebug(logService) <<
+        "BaseConnectionContactCapabilitiesInterface::Adaptee::getContactCapabilities";
     DBusError error;
     Tp::ContactCapabilitiesMap contactCapabilities = mInterface->getContactCapabilities(handles, &error);
     if (error.isValid()) {
@@ -109,6 +109,10 @@ public:
     bool plugInterface(const AbstractConnectionInterfacePtr &interface);
     bool registerObject(DBusError *error = NULL);
 
+    bool isPeerToPeerEnabled() const;
+    void setPeerToPeerEnabled(bool enabled);
+    QString peerToPeerAddress() const;
+
     virtual QString uniqueName() const;
 
 Q_SIGNALS:
@@ -116,6 +120,9 @@ Q_SIGNALS:
 
 private Q_SLOTS:
     TP_QT_NO_EXPORT void removeChannel();
+    TP_QT_NO_EXPORT void onPeerConnected(const QDBusConnection &peer);
+    TP_QT_NO_EXPORT void onPeerDisconnected();
+    TP_QT_NO_EXPORT void prunePeers();
 
 protected:
     BaseConnection(const QDBusConnection &dbusConnection,
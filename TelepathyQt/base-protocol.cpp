@@ -274,7 +274,8 @@ QStringList BaseProtocol::connectionInterfaces() const
 void BaseProtocol::setConnectionInterfaces(const QStringList &connInterfaces)
 {
     if (isRegistered()) {
-        warning() << "BaseProtocol::setConnectionInterfaces: cannot change property after "
+        tpWarning(logService) <<
+            "BaseProtocol::setConnectionInterfaces: cannot change property after "
             "registration, immutable property";
         return;
     }
@@ -312,7 +313,7 @@ ProtocolParameterList BaseProtocol::parameters() const
 void BaseProtocol::setParameters(const ProtocolParameterList &parameters)
 {
     if (isRegistered()) {
-        warning() << "BaseProtocol::setParameters: cannot change property after "
+        tpWarning(logService) << "BaseProtocol::setParameters: cannot change property after "
             "registration, immutable property";
         return;
     }
@@ -352,7 +353,8 @@ RequestableChannelClassSpecList BaseProtocol::requestableChannelClasses() const
 void BaseProtocol::setRequestableChannelClasses(const RequestableChannelClassSpecList &rccSpecs)
 {
     if (isRegistered()) {
-        warning() << "BaseProtocol::setRequestableChannelClasses: cannot change property after "
+        tpWarning(logService) <<
+            "BaseProtocol::setRequestableChannelClasses: cannot change property after "
             "registration, immutable property";
         return;
     }
@@ -393,7 +395,7 @@ QString BaseProtocol::vcardField() const
 void BaseProtocol::setVCardField(const QString &vcardField)
 {
     if (isRegistered()) {
-        warning() << "BaseProtocol::setVCardField: cannot change property after "
+        tpWarning(logService) << "BaseProtocol::setVCardField: cannot change property after "
             "registration, immutable property";
         return;
     }
@@ -435,7 +437,7 @@ QString BaseProtocol::englishName() const
 void BaseProtocol::setEnglishName(const QString &englishName)
 {
     if (isRegistered()) {
-        warning() << "BaseProtocol::setEnglishName: cannot change property after "
+        tpWarning(logService) << "BaseProtocol::setEnglishName: cannot change property after "
             "registration, immutable property";
         return;
     }
@@ -473,7 +475,7 @@ QString BaseProtocol::iconName() const
 void BaseProtocol::setIconName(const QString &iconName)
 {
     if (isRegistered()) {
-        warning() << "BaseProtocol::setIconName: cannot change property after "
+        tpWarning(logService) << "BaseProtocol::setIconName: cannot change property after "
             "registration, immutable property";
         return;
     }
@@ -514,7 +516,8 @@ QStringList BaseProtocol::authenticationTypes() const
 void BaseProtocol::setAuthenticationTypes(const QStringList &authenticationTypes)
 {
     if (isRegistered()) {
-        warning() << "BaseProtocol::setAuthenticationTypes: cannot change property after "
+        tpWarning(logService) <<
+            "BaseProtocol::setAuthenticationTypes: cannot change property after "
             "registration, immutable property";
         return;
     }
@@ -666,24 +669,27 @@ AbstractProtocolInterfacePtr BaseProtocol::interface(const QString &interfaceNam
 bool BaseProtocol::plugInterface(const AbstractProtocolInterfacePtr &interface)
 {
     if (isRegistered()) {
-        warning() << "Unable to plug protocol interface " << interface->interfaceName() <<
+        tpWarning(logService) << "Unable to plug protocol interface " <<
+            interface->interfaceName() <<
             "- protocol already registered";
         return false;
     }
 
     if (interface->isRegistered()) {
-        warning() << "Unable to plug protocol interface" << interface->interfaceName() <<
+        tpWarning(logService) << "Unable to plug protocol interface" <<
+            interface->interfaceName() <<
             "- interface already registered";
         return false;
     }
 
     if (mPriv->interfaces.contains(interface->interfaceName())) {
-        warning() << "Unable to plug protocol interface" << interface->interfaceName() <<
+        tpWarning(logService) << "Unable to plug protocol interface" <<
+            interface->interfaceName() <<
             "- another interface with same name already plugged";
         return false;
     }
 
-    debug() << "Interface" << interface->interfaceName() << "plugged";
+    tpDebug(logService) << "Interface" << interface->interfaceName() << "plugged";
     mPriv->interfaces.insert(interface->interfaceName(), interface);
     return true;
 }
@@ -701,7 +707,7 @@ bool BaseProtocol::registerObject(const QString &busName, const QString &objectP
     foreach (const AbstractProtocolInterfacePtr &iface, mPriv->interfaces) {
         if (!iface->registerInterface(dbusObject())) {
             // lets not fail if an optional interface fails registering, lets warn only
-            warning() << "Unable to register interface" << iface->interfaceName() <<
+            tpWarning(logService) << "Unable to register interface" << iface->interfaceName() <<
                 "for protocol" << mPriv->name;
         }
     }
@@ -1114,7 +1120,8 @@ AvatarSpec BaseProtocolAvatarsInterface::avatarDetails() const
 void BaseProtocolAvatarsInterface::setAvatarDetails(const AvatarSpec &details)
 {
     if (isRegistered()) {
-        warning() << "BaseProtocolAvatarsInterface::setAvatarDetails: cannot change property after "
+        tpWarning(logService) <<
+            "BaseProtocolAvatarsInterface::setAvatarDetails: cannot change property after "
             "registration, immutable property";
         return;
     }
@@ -1228,7 +1235,8 @@ PresenceSpecList BaseProtocolPresenceInterface::statuses() const
 void BaseProtocolPresenceInterface::setStatuses(const PresenceSpecList &statuses)
 {
     if (isRegistered()) {
-        warning() << "BaseProtocolPresenceInterface::setStatuses: cannot change property after "
+        tpWarning(logService) <<
+            "BaseProtocolPresenceInterface::setStatuses: cannot change property after "
             "registration, immutable property";
         return;
     }
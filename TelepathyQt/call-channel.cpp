@@ -47,9 +47,15 @@ struct TP_QT_NO_EXPORT CallChannel::Private
     static void introspectCallMembers(Private *self);
     static void introspectContents(Private *self);
     static void introspectLocalHoldState(Private *self);
+    static void introspectLazyContents(Private *self);
 
     void processCallMembersChanged();
 
+    void startContentsIntrospection();
+    void checkContentsIntrospectionCompleted();
+    void failContentsIntrospection(const QString &errorName, const QString &errorMessage);
+    bool contentsReady() const;
+
     struct CallMembersChangedInfo;
 
     // Public object
@@ -81,6 +87,11 @@ struct TP_QT_NO_EXPORT CallChannel::Private
     bool mutableContents;
     CallContents contents;
     CallContents incompleteContents;
+    bool contentsIntrospectionStarted;
+    bool gotContentsList;
+    bool introspectingContents;
+    bool introspectingLazyContents;
+    int pendingContentStreams;
 
     uint localHoldState;
     uint localHoldStateReason;
@@ -127,6 +138,11 @@ CallChannel::Private::Private(CallChannel *parent)
       initialAudio(false),
       initialVideo(false),
       mutableContents(false),
+      contentsIntrospectionStarted(false),
+      gotContentsList(false),
+      introspectingContents(false),
+      introspectingLazyContents(false),
+      pendingContentStreams(0),
       localHoldState(LocalHoldStateUnheld),
       localHoldStateReason(LocalHoldStateReasonNone)
 {
@@ -172,6 +188,14 @@ CallChannel::Private::Private(CallChannel *parent)
         this);
     introspectables[FeatureLocalHoldState] = introspectableLocalHoldState;
 
+    ReadinessHelper::Introspectable introspectableLazyContents(
+        QSet<uint>() << 0,                                                         // makesSenseForStatuses
+        Features() << CallChannel::FeatureCore,                                    // dependsOnFeatures (core)
+        QStringList(),                                                             // dependsOnInterfaces
+        (ReadinessHelper::IntrospectFunc) &Private::introspectLazyContents,
+        this);
+    introspectables[FeatureLazyContents] = introspectableLazyContents;
+
     readinessHelper->addIntrospectables(introspectables);
 }
 
@@ -204,7 +228,7 @@ void CallChannel::Private::introspectCore(CallChannel::Private *self)
     }
 
     if (needIntrospectMainProps) {
-        debug() << "Introspecting immutable properties of CallChannel";
+        tpDebug(logChannels) << "Introspecting immutable properties of CallChannel";
 
         parent->connect(self->callInterface->requestAllProperties(),
                 SIGNAL(finished(Tp::PendingOperation*)),
@@ -257,20 +281,89 @@ void CallChannel::Private::introspectCallMembers(CallChannel::Private *self)
 
 void CallChannel::Private::introspectContents(CallChannel::Private *self)
 {
-    CallChannel *parent = self->parent;
+    self->introspectingContents = true;
 
-    parent->connect(self->callInterface,
+    if (!self->contentsIntrospectionStarted) {
+        self->startContentsIntrospection();
+        return;
+    }
+
+    // FeatureLazyContents got here first, make the streams of the existing contents ready
+    foreach (const CallContentPtr &content, self->contents) {
+        self->parent->readyContentStreams(content);
+    }
+    foreach (const CallContentPtr &content, self->incompleteContents) {
+        self->parent->readyContentStreams(content);
+    }
+    self->checkContentsIntrospectionCompleted();
+}
+
+void CallChannel::Private::introspectLazyContents(CallChannel::Private *self)
+{
+    self->introspectingLazyContents = true;
+
+    if (!self->contentsIntrospectionStarted) {
+        self->startContentsIntrospection();
+        return;
+    }
+
+    self->checkContentsIntrospectionCompleted();
+}
+
+void CallChannel::Private::startContentsIntrospection()
+{
+    contentsIntrospectionStarted = true;
+
+    parent->connect(callInterface,
             SIGNAL(ContentAdded(QDBusObjectPath)),
             SLOT(onContentAdded(QDBusObjectPath)));
-    parent->connect(self->callInterface,
+    parent->connect(callInterface,
             SIGNAL(ContentRemoved(QDBusObjectPath,Tp::CallStateReason)),
             SLOT(onContentRemoved(QDBusObjectPath,Tp::CallStateReason)));
 
-    parent->connect(self->callInterface->requestPropertyContents(),
+    parent->connect(callInterface->requestPropertyContents(),
             SIGNAL(finished(Tp::PendingOperation*)),
             SLOT(gotContents(Tp::PendingOperation*)));
 }
 
+void CallChannel::Private::checkContentsIntrospectionCompleted()
+{
+    if (!gotContentsList || !incompleteContents.isEmpty()) {
+        return;
+    }
+
+    if (introspectingLazyContents) {
+        introspectingLazyContents = false;
+        readinessHelper->setIntrospectCompleted(FeatureLazyContents, true);
+    }
+
+    if (introspectingContents && pendingContentStreams == 0) {
+        introspectingContents = false;
+        readinessHelper->setIntrospectCompleted(FeatureContents, true);
+    }
+}
+
+void CallChannel::Private::failContentsIntrospection(const QString &errorName,
+        const QString &errorMessage)
+{
+    if (introspectingLazyContents) {
+        introspectingLazyContents = false;
+        readinessHelper->setIntrospectCompleted(FeatureLazyContents, false,
+                errorName, errorMessage);
+    }
+
+    if (introspectingContents) {
+        introspectingContents = false;
+        readinessHelper->setIntrospectCompleted(FeatureContents, false,
+                errorName, errorMessage);
+    }
+}
+
+bool CallChannel::Private::contentsReady() const
+{
+    return parent->isReady(FeatureContents) || parent->isReady(FeatureLazyContents);
+}
+
 void CallChannel::Private::introspectLocalHoldState(CallChannel::Private *self)
 {
     CallChannel *parent = self->parent;
@@ -375,6 +468,21 @@ const Feature CallChannel::FeatureContents = Feature(QLatin1String(CallChannel::
  */
 const Feature CallChannel::FeatureLocalHoldState = Feature(QLatin1String(CallChannel::staticMetaObject.className()), 4);
 
+/**
+ * Feature used in order to access content specific methods without introspecting the
+ * media streams of each content.
+ *
+ * When this feature is ready, contents() and the other content specific methods can be used
+ * as with CallChannel::FeatureContents, and each content has its properties introspected,
+ * but the CallStream objects returned by CallContent::streams() are only introspected when
+ * CallStream::becomeReady() is called on them. For calls with many contents and streams,
+ * this makes the channel usable after a single round trip per content instead of waiting for
+ * every stream.
+ *
+ * Requesting CallChannel::FeatureContents later makes the streams of all contents ready.
+ */
+const Feature CallChannel::FeatureLazyContents = Feature(QLatin1String(CallChannel::staticMetaObject.className()), 5);
+
 /**
  * Create a new CallChannel object.
  *
@@ -430,7 +538,7 @@ CallChannel::~CallChannel()
 CallState CallChannel::callState() const
 {
     if (!isReady(FeatureCallState)) {
-        warning() << "CallChannel::callState() used with FeatureCallState not ready";
+        tpWarning(logChannels) << "CallChannel::callState() used with FeatureCallState not ready";
     }
 
     return (CallState) mPriv->state;
@@ -448,7 +556,7 @@ CallState CallChannel::callState() const
 CallFlags CallChannel::callFlags() const
 {
     if (!isReady(FeatureCallState)) {
-        warning() << "CallChannel::callFlags() used with FeatureCallState not ready";
+        tpWarning(logChannels) << "CallChannel::callFlags() used with FeatureCallState not ready";
     }
 
     return (CallFlags) mPriv->flags;
@@ -465,7 +573,8 @@ CallFlags CallChannel::callFlags() const
 CallStateReason CallChannel::callStateReason() const
 {
     if (!isReady(FeatureCallState)) {
-        warning() << "CallChannel::callStateReason() used with FeatureCallState not ready";
+        tpWarning(logChannels) <<
+            "CallChannel::callStateReason() used with FeatureCallState not ready";
     }
 
     return mPriv->stateReason;
@@ -484,7 +593,8 @@ CallStateReason CallChannel::callStateReason() const
 QVariantMap CallChannel::callStateDetails() const
 {
     if (!isReady(FeatureCallState)) {
-        warning() << "CallChannel::callStateDetails() used with FeatureCallState not ready";
+        tpWarning(logChannels) <<
+            "CallChannel::callStateDetails() used with FeatureCallState not ready";
     }
 
     return mPriv->stateDetails;
@@ -501,7 +611,8 @@ QVariantMap CallChannel::callStateDetails() const
 Contacts CallChannel::remoteMembers() const
 {
     if (!isReady(FeatureCallMembers)) {
-        warning() << "CallChannel::remoteMembers() used with FeatureCallMembers not ready";
+        tpWarning(logChannels) <<
+            "CallChannel::remoteMembers() used with FeatureCallMembers not ready";
         return Contacts();
     }
 
@@ -520,7 +631,8 @@ Contacts CallChannel::remoteMembers() const
 CallMemberFlags CallChannel::remoteMemberFlags(const ContactPtr &member) const
 {
     if (!isReady(FeatureCallMembers)) {
-        warning() << "CallChannel::remoteMemberFlags() used with FeatureCallMembers not ready";
+        tpWarning(logChannels) <<
+            "CallChannel::remoteMemberFlags() used with FeatureCallMembers not ready";
         return (CallMemberFlags) 0;
     }
 
@@ -674,15 +786,16 @@ PendingOperation *CallChannel::hangup(CallStateChangeReason reason,
 /**
  * Return a list of media contents in this channel.
  *
- * This methods requires CallChannel::FeatureContents to be enabled.
+ * This methods requires CallChannel::FeatureContents or
+ * CallChannel::FeatureLazyContents to be enabled.
  *
  * \return The contents in this channel.
  * \sa contentAdded(), contentRemoved(), contentsForType(), contentByName(), requestContent()
  */
 CallContents CallChannel::contents() const
 {
-    if (!isReady(FeatureContents)) {
-        warning() << "CallChannel::contents() used with FeatureContents not ready";
+    if (!mPriv->contentsReady()) {
+        tpWarning(logChannels) << "CallChannel::contents() used with FeatureContents not ready";
         return CallContents();
     }
 
@@ -700,8 +813,8 @@ CallContents CallChannel::contents() const
  */
 CallContents CallChannel::contentsForType(MediaStreamType type) const
 {
-    if (!isReady(FeatureContents)) {
-        warning() << "CallChannel::contents() used with FeatureContents not ready";
+    if (!mPriv->contentsReady()) {
+        tpWarning(logChannels) << "CallChannel::contents() used with FeatureContents not ready";
         return CallContents();
     }
 
@@ -725,8 +838,9 @@ CallContents CallChannel::contentsForType(MediaStreamType type) const
  */
 CallContentPtr CallChannel::contentByName(const QString &contentName) const
 {
-    if (!isReady(FeatureContents)) {
-        warning() << "CallChannel::contentByName() used with FeatureContents not ready";
+    if (!mPriv->contentsReady()) {
+        tpWarning(logChannels) <<
+            "CallChannel::contentByName() used with FeatureContents not ready";
         return CallContentPtr();
     }
 
@@ -765,9 +879,10 @@ PendingCallContent *CallChannel::requestContent(const QString &name,
 LocalHoldState CallChannel::localHoldState() const
 {
     if (!isReady(FeatureLocalHoldState)) {
-        warning() << "CallChannel::localHoldState() used with FeatureLocalHoldState not ready";
+        tpWarning(logChannels) <<
+            "CallChannel::localHoldState() used with FeatureLocalHoldState not ready";
     } else if (!hasInterface(TP_QT_IFACE_CHANNEL_INTERFACE_HOLD)) {
-        warning() << "CallChannel::localHoldStateReason() used with no hold interface";
+        tpWarning(logChannels) << "CallChannel::localHoldStateReason() used with no hold interface";
     }
 
     return (LocalHoldState) mPriv->localHoldState;
@@ -784,9 +899,10 @@ LocalHoldState CallChannel::localHoldState() const
 LocalHoldStateReason CallChannel::localHoldStateReason() const
 {
     if (!isReady(FeatureLocalHoldState)) {
-        warning() << "CallChannel::localHoldStateReason() used with FeatureLocalHoldState not ready";
+        tpWarning(logChannels) <<
+            "CallChannel::localHoldStateReason() used with FeatureLocalHoldState not ready";
     } else if (!hasInterface(TP_QT_IFACE_CHANNEL_INTERFACE_HOLD)) {
-        warning() << "CallChannel::localHoldStateReason() used with no hold interface";
+        tpWarning(logChannels) << "CallChannel::localHoldStateReason() used with no hold interface";
     }
 
     return (LocalHoldStateReason) mPriv->localHoldStateReason;
@@ -827,7 +943,7 @@ LocalHoldStateReason CallChannel::localHoldStateReason() const
 PendingOperation *CallChannel::requestHold(bool hold)
 {
     if (!hasInterface(TP_QT_IFACE_CHANNEL_INTERFACE_HOLD)) {
-        warning() << "CallChannel::requestHold() used with no hold interface";
+        tpWarning(logChannels) << "CallChannel::requestHold() used with no hold interface";
         return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("CallChannel does not support hold interface"),
                 CallChannelPtr(this));
@@ -841,14 +957,14 @@ PendingOperation *CallChannel::requestHold(bool hold)
 void CallChannel::gotMainProperties(PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "CallInterface::requestAllProperties() failed with " <<
+        tpWarning(logChannels).nospace() << "CallInterface::requestAllProperties() failed with " <<
             op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
             op->errorName(), op->errorMessage());
         return;
     }
 
-    debug() << "Got reply to CallInterface::requestAllProperties()";
+    tpDebug(logChannels) << "Got reply to CallInterface::requestAllProperties()";
 
     PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
     Q_ASSERT(pvm);
@@ -869,14 +985,14 @@ void CallChannel::gotMainProperties(PendingOperation *op)
 void CallChannel::gotCallState(PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "CallInterface::requestAllProperties() failed with " <<
+        tpWarning(logChannels).nospace() << "CallInterface::requestAllProperties() failed with " <<
             op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCallState, false,
             op->errorName(), op->errorMessage());
         return;
     }
 
-    debug() << "Got reply to CallInterface::requestAllProperties()";
+    tpDebug(logChannels) << "Got reply to CallInterface::requestAllProperties()";
 
     PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
     Q_ASSERT(pvm);
@@ -920,14 +1036,14 @@ void CallChannel::onCallStateChanged(uint state, uint flags,
 void CallChannel::gotCallMembers(PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "CallInterface::requestAllProperties() failed with " <<
+        tpWarning(logChannels).nospace() << "CallInterface::requestAllProperties() failed with " <<
             op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCallMembers, false,
             op->errorName(), op->errorMessage());
         return;
     }
 
-    debug() << "Got reply to CallInterface::requestAllProperties()";
+    tpDebug(logChannels) << "Got reply to CallInterface::requestAllProperties()";
 
     PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
     Q_ASSERT(pvm);
@@ -947,7 +1063,7 @@ void CallChannel::gotCallMembersContacts(PendingOperation *op)
     PendingContacts *pc = qobject_cast<PendingContacts *>(op);
 
     if (!pc->isValid()) {
-        warning().nospace() << "Getting contacts failed with " <<
+        tpWarning(logChannels).nospace() << "Getting contacts failed with " <<
             pc->errorName() << ":" << pc->errorMessage() << ", ignoring";
         mPriv->currentCallMembersChangedInfo.clear();
         mPriv->processCallMembersChanged();
@@ -1023,11 +1139,12 @@ void CallChannel::onCallMembersChanged(const CallMemberMap &updates,
         const CallStateReason &reason)
 {
     if (updates.isEmpty() && removed.isEmpty()) {
-        debug() << "Received Call::CallMembersChanged with 0 removals and updates, skipping it";
+        tpDebug(logChannels) <<
+            "Received Call::CallMembersChanged with 0 removals and updates, skipping it";
         return;
     }
 
-    debug() << "Received Call::CallMembersChanged with" << updates.size() <<
+    tpDebug(logChannels) << "Received Call::CallMembersChanged with" << updates.size() <<
         "updated and" << removed.size() << "removed";
     mPriv->callMembersChangedQueue.enqueue(
             Private::CallMembersChangedInfo::create(updates, identifiers, removed, reason));
@@ -1037,37 +1154,38 @@ void CallChannel::onCallMembersChanged(const CallMemberMap &updates,
 void CallChannel::gotContents(PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "CallInterface::requestPropertyContents() failed with " <<
+        tpWarning(logChannels).nospace() <<
+            "CallInterface::requestPropertyContents() failed with " <<
             op->errorName() << ": " << op->errorMessage();
-        mPriv->readinessHelper->setIntrospectCompleted(FeatureContents, false,
-            op->errorName(), op->errorMessage());
+        mPriv->failContentsIntrospection(op->errorName(), op->errorMessage());
         return;
     }
 
-    debug() << "Got reply to CallInterface::requestPropertyContents()";
+    tpDebug(logChannels) << "Got reply to CallInterface::requestPropertyContents()";
 
     PendingVariant *pv = qobject_cast<PendingVariant*>(op);
     Q_ASSERT(pv);
 
+    // all contents are introspected in parallel, the channel does not wait for one content
+    // to be ready before introspecting the next one
     ObjectPathList contentsPaths = qdbus_cast<ObjectPathList>(pv->result());
-    if (contentsPaths.size() > 0) {
-        foreach (const QDBusObjectPath &contentPath, contentsPaths) {
-            CallContentPtr content = lookupContent(contentPath);
-            if (!content) {
-                addContent(contentPath);
-            }
+    foreach (const QDBusObjectPath &contentPath, contentsPaths) {
+        CallContentPtr content = lookupContent(contentPath);
+        if (!content) {
+            addContent(contentPath);
         }
-    } else {
-        mPriv->readinessHelper->setIntrospectCompleted(FeatureContents, true);
     }
+
+    mPriv->gotContentsList = true;
+    mPriv->checkContentsIntrospectionCompleted();
 }
 
 void CallChannel::onContentAdded(const QDBusObjectPath &contentPath)
 {
-    debug() << "Received Call::ContentAdded for content" << contentPath.path();
+    tpDebug(logChannels) << "Received Call::ContentAdded for content" << contentPath.path();
 
     if (lookupContent(contentPath)) {
-        debug() << "Content already exists, ignoring";
+        tpDebug(logChannels) << "Content already exists, ignoring";
         return;
     }
 
@@ -1077,11 +1195,11 @@ void CallChannel::onContentAdded(const QDBusObjectPath &contentPath)
 void CallChannel::onContentRemoved(const QDBusObjectPath &contentPath,
         const CallStateReason &reason)
 {
-    debug() << "Received Call::ContentRemoved for content" << contentPath.path();
+    tpDebug(logChannels) << "Received Call::ContentRemoved for content" << contentPath.path();
 
     CallContentPtr content = lookupContent(contentPath);
     if (!content) {
-        debug() << "Content does not exist, ignoring";
+        tpDebug(logChannels) << "Content does not exist, ignoring";
         return;
     }
 
@@ -1092,16 +1210,12 @@ void CallChannel::onContentRemoved(const QDBusObjectPath &contentPath,
         mPriv->contents.removeOne(content);
     }
 
-    if (isReady(FeatureContents) && !incomplete) {
+    if (mPriv->contentsReady() && !incomplete) {
         emit contentRemoved(content, reason);
     }
 
     // the content was added/removed before become ready
-    if (!isReady(FeatureContents) &&
-        mPriv->contents.size() == 0 &&
-        mPriv->incompleteContents.size() == 0) {
-        mPriv->readinessHelper->setIntrospectCompleted(FeatureContents, true);
-    }
+    mPriv->checkContentsIntrospectionCompleted();
 }
 
 void CallChannel::onContentReady(PendingOperation *op)
@@ -1111,47 +1225,53 @@ void CallChannel::onContentReady(PendingOperation *op)
 
     if (op->isError()) {
         mPriv->incompleteContents.removeOne(content);
-        if (!isReady(FeatureContents) && mPriv->incompleteContents.size() == 0) {
-            // let's not fail because a content could not become ready
-            mPriv->readinessHelper->setIntrospectCompleted(FeatureContents, true);
-        }
+        // let's not fail because a content could not become ready
+        mPriv->checkContentsIntrospectionCompleted();
         return;
     }
 
     // the content was removed before become ready
     if (!mPriv->incompleteContents.contains(content)) {
-        if (!isReady(FeatureContents) &&
-            mPriv->incompleteContents.size() == 0) {
-            mPriv->readinessHelper->setIntrospectCompleted(FeatureContents, true);
-        }
+        mPriv->checkContentsIntrospectionCompleted();
         return;
     }
 
     mPriv->incompleteContents.removeOne(content);
     mPriv->contents.append(content);
 
-    if (isReady(FeatureContents)) {
+    if (mPriv->contentsReady()) {
         emit contentAdded(content);
     }
 
-    if (!isReady(FeatureContents) && mPriv->incompleteContents.size() == 0) {
-        mPriv->readinessHelper->setIntrospectCompleted(FeatureContents, true);
+    mPriv->checkContentsIntrospectionCompleted();
+}
+
+void CallChannel::onContentStreamReady(PendingOperation *op)
+{
+    if (op->isError()) {
+        // let's not fail because a stream could not become ready
+        tpWarning(logChannels).nospace() << "Making call stream ready failed with " <<
+            op->errorName() << ": " << op->errorMessage();
     }
+
+    Q_ASSERT(mPriv->pendingContentStreams > 0);
+    --mPriv->pendingContentStreams;
+    mPriv->checkContentsIntrospectionCompleted();
 }
 
 void CallChannel::gotLocalHoldState(QDBusPendingCallWatcher *watcher)
 {
     QDBusPendingReply<uint, uint> reply = *watcher;
     if (reply.isError()) {
-        warning().nospace() << "Call::Hold::GetHoldState() failed with " <<
+        tpWarning(logChannels).nospace() << "Call::Hold::GetHoldState() failed with " <<
             reply.error().name() << ": " << reply.error().message();
-        debug() << "Ignoring error getting hold state and assuming we're not on hold";
+        tpDebug(logChannels) << "Ignoring error getting hold state and assuming we're not on hold";
         onLocalHoldStateChanged(mPriv->localHoldState, mPriv->localHoldStateReason);
         watcher->deleteLater();
         return;
     }
 
-    debug() << "Got reply to Call::Hold::GetHoldState()";
+    tpDebug(logChannels) << "Got reply to Call::Hold::GetHoldState()";
     onLocalHoldStateChanged(reply.argumentAt<0>(), reply.argumentAt<1>());
     watcher->deleteLater();
 }
@@ -1179,8 +1299,10 @@ void CallChannel::onLocalHoldStateChanged(uint localHoldState, uint localHoldSta
 
 CallContentPtr CallChannel::addContent(const QDBusObjectPath &contentPath)
 {
+    // only introspect the content streams upfront if someone asked for them
+    bool lazyStreams = !mPriv->readinessHelper->requestedFeatures().contains(FeatureContents);
     CallContentPtr content = CallContentPtr(
-            new CallContent(CallChannelPtr(this), contentPath));
+            new CallContent(CallChannelPtr(this), contentPath, lazyStreams));
     mPriv->incompleteContents.append(content);
     connect(content->becomeReady(),
             SIGNAL(finished(Tp::PendingOperation*)),
@@ -1188,6 +1310,20 @@ CallContentPtr CallChannel::addContent(const QDBusObjectPath &contentPath)
     return content;
 }
 
+void CallChannel::readyContentStreams(const CallContentPtr &content)
+{
+    if (!content->hasLazyStreams()) {
+        return;
+    }
+
+    foreach (PendingOperation *op, content->readyStreams()) {
+        ++mPriv->pendingContentStreams;
+        connect(op,
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(onContentStreamReady(Tp::PendingOperation*)));
+    }
+}
+
 CallContentPtr CallChannel::lookupContent(const QDBusObjectPath &contentPath) const
 {
     foreach (const CallContentPtr &content, mPriv->contents) {
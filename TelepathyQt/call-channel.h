@@ -43,6 +43,7 @@ public:
     static const Feature FeatureCallMembers;
     static const Feature FeatureContents;
     static const Feature FeatureLocalHoldState;
+    static const Feature FeatureLazyContents;
 
     static CallChannelPtr create(const ConnectionPtr &connection,
             const QString &objectPath, const QVariantMap &immutableProperties);
@@ -73,7 +74,7 @@ public:
     Contacts remoteMembers() const;
     CallMemberFlags remoteMemberFlags(const ContactPtr &member) const;
 
-    // FeatureContents
+    // FeatureContents / FeatureLazyContents
     CallContents contents() const;
     CallContents contentsForType(MediaStreamType type) const;
     CallContentPtr contentByName(const QString &contentName) const;
@@ -97,7 +98,7 @@ Q_SIGNALS:
     void remoteMembersRemoved(const Tp::Contacts &remoteMembers,
             const Tp::CallStateReason &reason);
 
-    // FeatureContents
+    // FeatureContents / FeatureLazyContents
     void contentAdded(const Tp::CallContentPtr &content);
     void contentRemoved(const Tp::CallContentPtr &content, const Tp::CallStateReason &reason);
 
@@ -128,6 +129,7 @@ private Q_SLOTS:
     TP_QT_NO_EXPORT void onContentRemoved(const QDBusObjectPath &contentPath,
             const Tp::CallStateReason &reason);
     TP_QT_NO_EXPORT void onContentReady(Tp::PendingOperation *op);
+    TP_QT_NO_EXPORT void onContentStreamReady(Tp::PendingOperation *op);
 
     TP_QT_NO_EXPORT void gotLocalHoldState(QDBusPendingCallWatcher *);
     TP_QT_NO_EXPORT void onLocalHoldStateChanged(uint, uint);
@@ -137,6 +139,7 @@ private:
 
     TP_QT_NO_EXPORT CallContentPtr addContent(const QDBusObjectPath &contentPath);
     TP_QT_NO_EXPORT CallContentPtr lookupContent(const QDBusObjectPath &contentPath) const;
+    TP_QT_NO_EXPORT void readyContentStreams(const CallContentPtr &content);
 
     struct Private;
     friend struct Private;
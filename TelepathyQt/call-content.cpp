@@ -42,7 +42,7 @@ namespace Tp
 /* ====== CallContent ====== */
 struct TP_QT_NO_EXPORT CallContent::Private
 {
-    Private(CallContent *parent, const CallChannelPtr &channel);
+    Private(CallContent *parent, const CallChannelPtr &channel, bool lazyStreams);
 
     static void introspectMainProperties(Private *self);
     void checkIntrospectionCompleted();
@@ -66,13 +66,18 @@ struct TP_QT_NO_EXPORT CallContent::Private
     uint disposition;
     CallStreams streams;
     CallStreams incompleteStreams;
+
+    // Whether streams are added without being introspected, see CallChannel::FeatureLazyContents
+    bool lazyStreams;
 };
 
-CallContent::Private::Private(CallContent *parent, const CallChannelPtr &channel)
+CallContent::Private::Private(CallContent *parent, const CallChannelPtr &channel,
+        bool lazyStreams)
     : parent(parent),
       channel(channel.data()),
       contentInterface(parent->interface<Client::CallContentInterface>()),
-      readinessHelper(parent->readinessHelper())
+      readinessHelper(parent->readinessHelper()),
+      lazyStreams(lazyStreams)
 {
     ReadinessHelper::Introspectables introspectables;
 
@@ -114,6 +119,16 @@ void CallContent::Private::checkIntrospectionCompleted()
 
 CallStreamPtr CallContent::Private::addStream(const QDBusObjectPath &streamPath)
 {
+    if (lazyStreams) {
+        CallStreamPtr stream = CallStreamPtr(
+                new CallStream(CallContentPtr(parent), streamPath, false));
+        streams.append(stream);
+        if (parent->isReady(FeatureCore)) {
+            emit parent->streamAdded(stream);
+        }
+        return stream;
+    }
+
     CallStreamPtr stream = CallStreamPtr(
             new CallStream(CallContentPtr(parent), streamPath));
     incompleteStreams.append(stream);
@@ -169,12 +184,14 @@ const Feature CallContent::FeatureCore = Feature(QLatin1String(CallContent::stat
  *
  * \param channel The channel owning this media content.
  * \param name The object path of this media content.
+ * \param lazyStreams Whether streams are added without being introspected.
  */
-CallContent::CallContent(const CallChannelPtr &channel, const QDBusObjectPath &objectPath)
+CallContent::CallContent(const CallChannelPtr &channel, const QDBusObjectPath &objectPath,
+        bool lazyStreams)
     : StatefulDBusProxy(channel->dbusConnection(), channel->busName(),
             objectPath.path(), FeatureCore),
       OptionalInterfaceFactory<CallContent>(this),
-      mPriv(new Private(this, channel))
+      mPriv(new Private(this, channel, lazyStreams))
 {
 }
 
@@ -229,6 +246,10 @@ CallContentDisposition CallContent::disposition() const
 /**
  * Return the media streams of this media content.
  *
+ * If this content was introspected through CallChannel::FeatureLazyContents only, the
+ * returned streams may not be ready yet, and CallStream::becomeReady() should be called
+ * before using them.
+ *
  * \return A list of media streams of this media content.
  * \sa streamAdded(), streamRemoved()
  */
@@ -280,7 +301,7 @@ bool CallContent::supportsDTMF() const
 PendingOperation *CallContent::startDTMFTone(DTMFEvent event)
 {
     if (!supportsDTMF()) {
-        warning() << "CallContent::startDTMFTone() used with no dtmf interface";
+        tpWarning(logChannels) << "CallContent::startDTMFTone() used with no dtmf interface";
         return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("This CallContent does not support the dtmf interface"),
                 CallContentPtr(this));
@@ -309,7 +330,7 @@ PendingOperation *CallContent::startDTMFTone(DTMFEvent event)
 PendingOperation *CallContent::stopDTMFTone()
 {
     if (!supportsDTMF()) {
-        warning() << "CallContent::stopDTMFTone() used with no dtmf interface";
+        tpWarning(logChannels) << "CallContent::stopDTMFTone() used with no dtmf interface";
         return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("This CallContent does not support the dtmf interface"),
                 CallContentPtr(this));
@@ -323,14 +344,15 @@ PendingOperation *CallContent::stopDTMFTone()
 void CallContent::gotMainProperties(PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "CallContentInterface::requestAllProperties() failed with" <<
+        tpWarning(logChannels).nospace() <<
+            "CallContentInterface::requestAllProperties() failed with" <<
             op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
             op->errorName(), op->errorMessage());
         return;
     }
 
-    debug() << "Got reply to CallContentInterface::requestAllProperties()";
+    tpDebug(logChannels) << "Got reply to CallContentInterface::requestAllProperties()";
 
     PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
     Q_ASSERT(pvm);
@@ -343,25 +365,43 @@ void CallContent::gotMainProperties(PendingOperation *op)
     setInterfaces(qdbus_cast<QStringList>(props[QLatin1String("Interfaces")]));
 
     ObjectPathList streamsPaths = qdbus_cast<ObjectPathList>(props[QLatin1String("Streams")]);
-    if (streamsPaths.size() != 0) {
-        foreach (const QDBusObjectPath &streamPath, streamsPaths) {
-            CallStreamPtr stream = mPriv->lookupStream(streamPath);
-            if (!stream) {
-                mPriv->addStream(streamPath);
-            }
+    foreach (const QDBusObjectPath &streamPath, streamsPaths) {
+        CallStreamPtr stream = mPriv->lookupStream(streamPath);
+        if (!stream) {
+            mPriv->addStream(streamPath);
+        }
+    }
+
+    mPriv->checkIntrospectionCompleted();
+}
+
+bool CallContent::hasLazyStreams() const
+{
+    return mPriv->lazyStreams;
+}
+
+QList<PendingOperation*> CallContent::readyStreams()
+{
+    // Streams added from now on are introspected before being signalled, as usual
+    mPriv->lazyStreams = false;
+
+    QList<PendingOperation*> ops;
+    foreach (const CallStreamPtr &stream, mPriv->streams) {
+        if (!stream->isReady()) {
+            ops.append(stream->becomeReady());
         }
-    } else {
-        mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, true);
     }
+    return ops;
 }
 
 void CallContent::onStreamsAdded(const ObjectPathList &streamsPaths)
 {
     foreach (const QDBusObjectPath &streamPath, streamsPaths) {
-        debug() << "Received Call::Content::StreamAdded for stream" << streamPath.path();
+        tpDebug(logChannels) << "Received Call::Content::StreamAdded for stream" <<
+            streamPath.path();
 
         if (mPriv->lookupStream(streamPath)) {
-            debug() << "Stream already exists, ignoring";
+            tpDebug(logChannels) << "Stream already exists, ignoring";
             return;
         }
 
@@ -373,11 +413,12 @@ void CallContent::onStreamsRemoved(const ObjectPathList &streamsPaths,
         const CallStateReason &reason)
 {
     foreach (const QDBusObjectPath &streamPath, streamsPaths) {
-        debug() << "Received Call::Content::StreamRemoved for stream" << streamPath.path();
+        tpDebug(logChannels) << "Received Call::Content::StreamRemoved for stream" <<
+            streamPath.path();
 
         CallStreamPtr stream = mPriv->lookupStream(streamPath);
         if (!stream) {
-            debug() << "Stream does not exist, ignoring";
+            tpDebug(logChannels) << "Stream does not exist, ignoring";
             return;
         }
 
@@ -486,7 +527,7 @@ void PendingCallContent::gotContent(QDBusPendingCallWatcher *watcher)
 {
     QDBusPendingReply<QDBusObjectPath> reply = *watcher;
     if (reply.isError()) {
-        warning().nospace() << "Call::AddContent failed with " <<
+        tpWarning(logChannels).nospace() << "Call::AddContent failed with " <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
         watcher->deleteLater();
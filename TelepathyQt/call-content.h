@@ -76,7 +76,10 @@ private:
     TP_QT_NO_EXPORT static const Feature FeatureCore;
 
     TP_QT_NO_EXPORT CallContent(const CallChannelPtr &channel,
-            const QDBusObjectPath &contentPath);
+            const QDBusObjectPath &contentPath, bool lazyStreams = false);
+
+    TP_QT_NO_EXPORT bool hasLazyStreams() const;
+    TP_QT_NO_EXPORT QList<PendingOperation*> readyStreams();
 
     struct Private;
     friend struct Private;
@@ -44,7 +44,7 @@ namespace Tp
 
 struct TP_QT_NO_EXPORT CallStream::Private
 {
-    Private(CallStream *parent, const CallContentPtr &content);
+    Private(CallStream *parent, const CallContentPtr &content, bool introspect);
 
     static void introspectMainProperties(Private *self);
 
@@ -101,7 +101,8 @@ struct TP_QT_NO_EXPORT CallStream::Private::RemoteMembersChangedInfo
     CallStateReason reason;
 };
 
-CallStream::Private::Private(CallStream *parent, const CallContentPtr &content)
+CallStream::Private::Private(CallStream *parent, const CallContentPtr &content,
+        bool introspect)
     : parent(parent),
       content(content.data()),
       streamInterface(parent->interface<Client::CallStreamInterface>()),
@@ -120,7 +121,9 @@ CallStream::Private::Private(CallStream *parent, const CallContentPtr &content)
     introspectables[FeatureCore] = introspectableCore;
 
     readinessHelper->addIntrospectables(introspectables);
-    readinessHelper->becomeReady(FeatureCore);
+    if (introspect) {
+        readinessHelper->becomeReady(FeatureCore);
+    }
 }
 
 void CallStream::Private::introspectMainProperties(CallStream::Private *self)
@@ -191,6 +194,9 @@ void CallStream::Private::processRemoteMembersChanged()
  * Instances of this class cannot be constructed directly; the only way to get
  * one is via CallContent.
  *
+ * Streams of contents introspected through CallChannel::FeatureLazyContents are
+ * not made ready automatically; call becomeReady() before using them.
+ *
  * See \ref async_model
  */
 
@@ -211,12 +217,14 @@ const Feature CallStream::FeatureCore = Feature(QLatin1String(CallStream::static
  *
  * \param content The content owning this call stream.
  * \param objectPath The object path of this call stream.
+ * \param introspect Whether to start introspecting the stream right away.
  */
-CallStream::CallStream(const CallContentPtr &content, const QDBusObjectPath &objectPath)
+CallStream::CallStream(const CallContentPtr &content, const QDBusObjectPath &objectPath,
+        bool introspect)
     : StatefulDBusProxy(content->dbusConnection(), content->busName(),
             objectPath.path(), FeatureCore),
       OptionalInterfaceFactory<CallStream>(this),
-      mPriv(new Private(this, content))
+      mPriv(new Private(this, content, introspect))
 {
 }
 
@@ -337,14 +345,15 @@ PendingOperation *CallStream::requestReceiving(const ContactPtr &contact, bool r
 void CallStream::gotMainProperties(PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "CallStreamInterface::requestAllProperties() failed with " <<
+        tpWarning(logChannels).nospace() <<
+            "CallStreamInterface::requestAllProperties() failed with " <<
             op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
             op->errorName(), op->errorMessage());
         return;
     }
 
-    debug() << "Got reply to CallStreamInterface::requestAllProperties()";
+    tpDebug(logChannels) << "Got reply to CallStreamInterface::requestAllProperties()";
 
     PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
     Q_ASSERT(pvm);
@@ -369,7 +378,7 @@ void CallStream::gotRemoteMembersContacts(PendingOperation *op)
     PendingContacts *pc = qobject_cast<PendingContacts *>(op);
 
     if (!pc->isValid()) {
-        warning().nospace() << "Getting contacts failed with " <<
+        tpWarning(logChannels).nospace() << "Getting contacts failed with " <<
             pc->errorName() << ":" << pc->errorMessage() << ", ignoring";
         mPriv->currentRemoteMembersChangedInfo.clear();
         mPriv->processRemoteMembersChanged();
@@ -452,12 +461,12 @@ void CallStream::onRemoteMembersChanged(const ContactSendingStateMap &updates,
         const CallStateReason &reason)
 {
     if (updates.isEmpty() && removed.isEmpty()) {
-        debug() << "Received Call::Stream::RemoteMembersChanged with 0 removals and "
+        tpDebug(logChannels) << "Received Call::Stream::RemoteMembersChanged with 0 removals and "
             "updates, skipping it";
         return;
     }
 
-    debug() << "Received Call::Stream::RemoteMembersChanged with" << updates.size() <<
+    tpDebug(logChannels) << "Received Call::Stream::RemoteMembersChanged with" << updates.size() <<
         "updated and" << removed.size() << "removed";
     mPriv->remoteMembersChangedQueue.enqueue(
             Private::RemoteMembersChangedInfo::create(updates, identifiers, removed, reason));
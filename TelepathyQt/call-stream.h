@@ -86,7 +86,8 @@ private:
 
     TP_QT_NO_EXPORT static const Feature FeatureCore;
 
-    TP_QT_NO_EXPORT CallStream(const CallContentPtr &content, const QDBusObjectPath &streamPath);
+    TP_QT_NO_EXPORT CallStream(const CallContentPtr &content, const QDBusObjectPath &streamPath,
+            bool introspect = true);
 
     struct Private;
     friend struct Private;
@@ -0,0 +1,86 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2026 agent <agent@local>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _TelepathyQt_capabilities_base_internal_h_HEADER_GUARD_
+#define _TelepathyQt_capabilities_base_internal_h_HEADER_GUARD_
+
+#include <TelepathyQt/CapabilitiesBase>
+
+#include <QSet>
+#include <QSharedData>
+#include <QStringList>
+
+namespace Tp
+{
+
+struct TP_QT_NO_EXPORT CapabilitiesBase::Private : public QSharedData
+{
+    Private(bool specificToContact);
+    Private(const RequestableChannelClassSpecList &rccSpecs, bool specificToContact);
+
+    // The well-known capabilities, checked once against the class specs whenever they are set
+    // so that the accessors don't need to compare them against the spec of each capability
+    enum Capability {
+        TextChats = 1 << 0,
+        AudioCalls = 1 << 1,
+        VideoCalls = 1 << 2,
+        VideoCallsWithAudio = 1 << 3,
+        UpgradingCalls = 1 << 4,
+        StreamedMediaCalls = 1 << 5,
+        StreamedMediaAudioCalls = 1 << 6,
+        StreamedMediaVideoCalls = 1 << 7,
+        StreamedMediaVideoCallsWithAudio = 1 << 8,
+        UpgradingStreamedMediaCalls = 1 << 9,
+        FileTransfers = 1 << 10,
+        TextChatrooms = 1 << 11,
+        ConferenceStreamedMediaCalls = 1 << 12,
+        ConferenceStreamedMediaCallsWithInvitees = 1 << 13,
+        ConferenceTextChats = 1 << 14,
+        ConferenceTextChatsWithInvitees = 1 << 15,
+        ConferenceTextChatrooms = 1 << 16,
+        ConferenceTextChatroomsWithInvitees = 1 << 17,
+        ContactSearches = 1 << 18,
+        ContactSearchesWithSpecificServer = 1 << 19,
+        ContactSearchesWithLimit = 1 << 20,
+        DBusTubes = 1 << 21,
+        StreamTubes = 1 << 22
+    };
+
+    void updateCapabilities();
+
+    bool has(Capability capability) const { return (capabilities & capability) != 0; }
+
+    RequestableChannelClassSpecList rccSpecs;
+    bool specificToContact;
+
+    uint capabilities;
+
+    // Tube services advertised for contacts, and the ones among them for which the tube
+    // spec of the service is supported
+    QStringList dbusTubeServices;
+    QSet<QString> supportedDBusTubeServices;
+    QStringList streamTubeServices;
+    QSet<QString> supportedStreamTubeServices;
+};
+
+} // Tp
+
+#endif
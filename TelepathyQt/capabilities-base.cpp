@@ -21,6 +21,7 @@
  */
 
 #include <TelepathyQt/CapabilitiesBase>
+#include "TelepathyQt/capabilities-base-internal.h"
 
 #include <TelepathyQt/Constants>
 #include <TelepathyQt/Types>
@@ -28,25 +29,111 @@
 namespace Tp
 {
 
-struct TP_QT_NO_EXPORT CapabilitiesBase::Private : public QSharedData
-{
-    Private(bool specificToContact);
-    Private(const RequestableChannelClassSpecList &rccSpecs, bool specificToContact);
-
-    RequestableChannelClassSpecList rccSpecs;
-    bool specificToContact;
-};
-
 CapabilitiesBase::Private::Private(bool specificToContact)
-    : specificToContact(specificToContact)
+    : specificToContact(specificToContact),
+      capabilities(0)
 {
 }
 
 CapabilitiesBase::Private::Private(const RequestableChannelClassSpecList &rccSpecs,
         bool specificToContact)
     : rccSpecs(rccSpecs),
-      specificToContact(specificToContact)
+      specificToContact(specificToContact),
+      capabilities(0)
 {
+    updateCapabilities();
+}
+
+void CapabilitiesBase::Private::updateCapabilities()
+{
+    static const QString callMutableContents =
+        TP_QT_IFACE_CHANNEL_TYPE_CALL + QLatin1String(".MutableContents");
+    static const QString streamedMediaImmutableStreams =
+        TP_QT_IFACE_CHANNEL_TYPE_STREAMED_MEDIA + QLatin1String(".ImmutableStreams");
+    static const QString dbusTubeServiceName =
+        TP_QT_IFACE_CHANNEL_TYPE_DBUS_TUBE + QLatin1String(".ServiceName");
+    static const QString streamTubeService =
+        TP_QT_IFACE_CHANNEL_TYPE_STREAM_TUBE + QLatin1String(".Service");
+
+    struct CapabilitySpec
+    {
+        Capability capability;
+        RequestableChannelClassSpec spec;
+    };
+    const CapabilitySpec capabilitySpecs[] = {
+        { TextChats, RequestableChannelClassSpec::textChat() },
+        { AudioCalls, RequestableChannelClassSpec::audioCall() },
+        { VideoCalls, RequestableChannelClassSpec::videoCall() },
+        { VideoCallsWithAudio, RequestableChannelClassSpec::videoCallWithAudioAllowed() },
+        { VideoCallsWithAudio, RequestableChannelClassSpec::audioCallWithVideoAllowed() },
+        { StreamedMediaCalls, RequestableChannelClassSpec::streamedMediaCall() },
+        { StreamedMediaAudioCalls, RequestableChannelClassSpec::streamedMediaAudioCall() },
+        { StreamedMediaVideoCalls, RequestableChannelClassSpec::streamedMediaVideoCall() },
+        { StreamedMediaVideoCallsWithAudio,
+            RequestableChannelClassSpec::streamedMediaVideoCallWithAudio() },
+        { FileTransfers, RequestableChannelClassSpec::fileTransfer() },
+        { TextChatrooms, RequestableChannelClassSpec::textChatroom() },
+        { ConferenceStreamedMediaCalls, RequestableChannelClassSpec::conferenceStreamedMediaCall() },
+        { ConferenceStreamedMediaCallsWithInvitees,
+            RequestableChannelClassSpec::conferenceStreamedMediaCallWithInvitees() },
+        { ConferenceTextChats, RequestableChannelClassSpec::conferenceTextChat() },
+        { ConferenceTextChatsWithInvitees,
+            RequestableChannelClassSpec::conferenceTextChatWithInvitees() },
+        { ConferenceTextChatrooms, RequestableChannelClassSpec::conferenceTextChatroom() },
+        { ConferenceTextChatroomsWithInvitees,
+            RequestableChannelClassSpec::conferenceTextChatroomWithInvitees() },
+        { ContactSearches, RequestableChannelClassSpec::contactSearch() },
+        { ContactSearchesWithSpecificServer,
+            RequestableChannelClassSpec::contactSearchWithSpecificServer() },
+        { ContactSearchesWithLimit, RequestableChannelClassSpec::contactSearchWithLimit() },
+        { DBusTubes, RequestableChannelClassSpec::dbusTube() },
+        { StreamTubes, RequestableChannelClassSpec::streamTube() }
+    };
+    const int numCapabilitySpecs = sizeof(capabilitySpecs) / sizeof(capabilitySpecs[0]);
+
+    capabilities = 0;
+    dbusTubeServices.clear();
+    supportedDBusTubeServices.clear();
+    streamTubeServices.clear();
+    supportedStreamTubeServices.clear();
+
+    QSet<QString> dbusServices, streamServices;
+    foreach (const RequestableChannelClassSpec &rccSpec, rccSpecs) {
+        for (int i = 0; i < numCapabilitySpecs; ++i) {
+            if (!has(capabilitySpecs[i].capability) &&
+                rccSpec.supports(capabilitySpecs[i].spec)) {
+                capabilities |= capabilitySpecs[i].capability;
+            }
+        }
+
+        QString channelType = rccSpec.channelType();
+        if (channelType == TP_QT_IFACE_CHANNEL_TYPE_CALL &&
+            rccSpec.allowsProperty(callMutableContents)) {
+            capabilities |= UpgradingCalls;
+        } else if (channelType == TP_QT_IFACE_CHANNEL_TYPE_STREAMED_MEDIA &&
+            !rccSpec.allowsProperty(streamedMediaImmutableStreams)) {
+            capabilities |= UpgradingStreamedMediaCalls;
+        } else if (channelType == TP_QT_IFACE_CHANNEL_TYPE_DBUS_TUBE &&
+            rccSpec.targetHandleType() == HandleTypeContact &&
+            rccSpec.hasFixedProperty(dbusTubeServiceName)) {
+            QString service = rccSpec.fixedProperty(dbusTubeServiceName).toString();
+            dbusServices.insert(service);
+            if (rccSpec.supports(RequestableChannelClassSpec::dbusTube(service))) {
+                supportedDBusTubeServices.insert(service);
+            }
+        } else if (channelType == TP_QT_IFACE_CHANNEL_TYPE_STREAM_TUBE &&
+            rccSpec.targetHandleType() == HandleTypeContact &&
+            rccSpec.hasFixedProperty(streamTubeService)) {
+            QString service = rccSpec.fixedProperty(streamTubeService).toString();
+            streamServices.insert(service);
+            if (rccSpec.supports(RequestableChannelClassSpec::streamTube(service))) {
+                supportedStreamTubeServices.insert(service);
+            }
+        }
+    }
+
+    dbusTubeServices = dbusServices.toList();
+    streamTubeServices = streamServices.toList();
 }
 
 /**
@@ -147,6 +234,7 @@ void CapabilitiesBase::updateRequestableChannelClasses(
         const RequestableChannelClassList &rccs)
 {
     mPriv->rccSpecs = RequestableChannelClassSpecList(rccs);
+    mPriv->updateCapabilities();
 }
 
 /**
@@ -189,54 +277,27 @@ bool CapabilitiesBase::isSpecificToContact() const
  */
 bool CapabilitiesBase::textChats() const
 {
-    foreach (const RequestableChannelClassSpec &rccSpec, mPriv->rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::textChat())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::TextChats);
 }
 
 bool CapabilitiesBase::audioCalls() const
 {
-    foreach (const RequestableChannelClassSpec &rccSpec, mPriv->rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::audioCall())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::AudioCalls);
 }
 
 bool CapabilitiesBase::videoCalls() const
 {
-    foreach (const RequestableChannelClassSpec &rccSpec, mPriv->rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::videoCall())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::VideoCalls);
 }
 
 bool CapabilitiesBase::videoCallsWithAudio() const
 {
-    foreach (const RequestableChannelClassSpec &rccSpec, mPriv->rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::videoCallWithAudioAllowed()) ||
-            rccSpec.supports(RequestableChannelClassSpec::audioCallWithVideoAllowed())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::VideoCallsWithAudio);
 }
 
 bool CapabilitiesBase::upgradingCalls() const
 {
-    foreach (const RequestableChannelClassSpec &rccSpec, mPriv->rccSpecs) {
-        if (rccSpec.channelType() == TP_QT_IFACE_CHANNEL_TYPE_CALL &&
-            rccSpec.allowsProperty(TP_QT_IFACE_CHANNEL_TYPE_CALL + QLatin1String(".MutableContents"))) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::UpgradingCalls);
 }
 
 /**
@@ -254,12 +315,7 @@ bool CapabilitiesBase::upgradingCalls() const
  */
 bool CapabilitiesBase::streamedMediaCalls() const
 {
-    foreach (const RequestableChannelClassSpec &rccSpec, mPriv->rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::streamedMediaCall())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::StreamedMediaCalls);
 }
 
 /**
@@ -285,12 +341,7 @@ bool CapabilitiesBase::streamedMediaCalls() const
  */
 bool CapabilitiesBase::streamedMediaAudioCalls() const
 {
-    foreach (const RequestableChannelClassSpec &rccSpec, mPriv->rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::streamedMediaAudioCall())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::StreamedMediaAudioCalls);
 }
 
 /**
@@ -305,12 +356,7 @@ bool CapabilitiesBase::streamedMediaAudioCalls() const
  */
 bool CapabilitiesBase::streamedMediaVideoCalls() const
 {
-    foreach (const RequestableChannelClassSpec &rccSpec, mPriv->rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::streamedMediaVideoCall())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::StreamedMediaVideoCalls);
 }
 
 /**
@@ -325,12 +371,7 @@ bool CapabilitiesBase::streamedMediaVideoCalls() const
  */
 bool CapabilitiesBase::streamedMediaVideoCallsWithAudio() const
 {
-    foreach (const RequestableChannelClassSpec &rccSpec, mPriv->rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::streamedMediaVideoCallWithAudio())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::StreamedMediaVideoCallsWithAudio);
 }
 
 /**
@@ -360,15 +401,7 @@ bool CapabilitiesBase::streamedMediaVideoCallsWithAudio() const
  */
 bool CapabilitiesBase::upgradingStreamedMediaCalls() const
 {
-    foreach (const RequestableChannelClassSpec &rccSpec, mPriv->rccSpecs) {
-        if (rccSpec.channelType() == TP_QT_IFACE_CHANNEL_TYPE_STREAMED_MEDIA &&
-            !rccSpec.allowsProperty(TP_QT_IFACE_CHANNEL_TYPE_STREAMED_MEDIA + QLatin1String(".ImmutableStreams"))) {
-            // TODO should we test all classes that have channelType
-            //      StreamedMedia or just one is fine?
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::UpgradingStreamedMediaCalls);
 }
 
 /**
@@ -379,12 +412,7 @@ bool CapabilitiesBase::upgradingStreamedMediaCalls() const
  */
 bool CapabilitiesBase::fileTransfers() const
 {
-    foreach (const RequestableChannelClassSpec &rccSpec, mPriv->rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::fileTransfer())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::FileTransfers);
 }
 
 } // Tp
@@ -76,7 +76,9 @@ protected:
 
 private:
     friend class Connection;
+    friend class ConnectionCapabilities;
     friend class Contact;
+    friend class ContactCapabilities;
 
     struct Private;
     friend struct Private;
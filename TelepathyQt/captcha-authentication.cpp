@@ -45,7 +45,7 @@ PendingCaptchaAnswer::PendingCaptchaAnswer(const QDBusPendingCall &call,
       mCaptcha(object),
       mChannel(mCaptcha->channel())
 {
-    debug() << "Calling Captcha.Answer";
+    tpDebug(logChannels) << "Calling Captcha.Answer";
     if (mWatcher->isFinished()) {
         onAnswerFinished();
     } else {
@@ -63,18 +63,18 @@ void PendingCaptchaAnswer::onAnswerFinished()
 {
     QDBusReply<void> reply = mWatcher->reply();
     if (!reply.isValid()) {
-        warning().nospace() << "Captcha.Answer failed with " <<
+        tpWarning(logChannels).nospace() << "Captcha.Answer failed with " <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
         return;
     }
 
-    debug() << "Captcha.Answer returned successfully";
+    tpDebug(logChannels) << "Captcha.Answer returned successfully";
 
     // It might have been already opened - check
     if (mCaptcha->status() == CaptchaStatusLocalPending ||
             mCaptcha->status() == CaptchaStatusRemotePending) {
-        debug() << "Awaiting captcha to be answered from server";
+        tpDebug(logChannels) << "Awaiting captcha to be answered from server";
         // Wait until status becomes relevant
         connect(mCaptcha.data(),
                 SIGNAL(statusChanged(Tp::CaptchaStatus)),
@@ -92,7 +92,7 @@ void PendingCaptchaAnswer::onCaptchaStatusChanged(Tp::CaptchaStatus status)
                 SIGNAL(finished(Tp::PendingOperation*)),
                 SLOT(onRequestCloseFinished(Tp::PendingOperation*)));
     } else if (status == CaptchaStatusFailed || status == CaptchaStatusTryAgain) {
-        warning() << "Captcha status changed to" << status << ", failing";
+        tpWarning(logChannels) << "Captcha status changed to" << status << ", failing";
         setFinishedWithError(mCaptcha->error(), mCaptcha->errorDetails().debugMessage());
     }
 }
@@ -101,7 +101,8 @@ void PendingCaptchaAnswer::onRequestCloseFinished(Tp::PendingOperation *operatio
 {
     if (operation->isError()) {
         // We cannot really fail just because the channel didn't close. Throw a warning instead.
-        warning() << "Could not close the channel after a successful captcha answer!!" << operation->errorMessage();
+        tpWarning(logChannels) <<
+            "Could not close the channel after a successful captcha answer!!" << operation->errorMessage();
     }
 
     setFinished();
@@ -114,7 +115,7 @@ PendingCaptchaCancel::PendingCaptchaCancel(const QDBusPendingCall &call,
       mCaptcha(object),
       mChannel(mCaptcha->channel())
 {
-    debug() << "Calling Captcha.Cancel";
+    tpDebug(logChannels) << "Calling Captcha.Cancel";
     if (mWatcher->isFinished()) {
         onCancelFinished();
     } else {
@@ -132,13 +133,13 @@ void PendingCaptchaCancel::onCancelFinished()
 {
     QDBusReply<void> reply = mWatcher->reply();
     if (!reply.isValid()) {
-        warning().nospace() << "Captcha.Answer failed with " <<
+        tpWarning(logChannels).nospace() << "Captcha.Answer failed with " <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
         return;
     }
 
-    debug() << "Captcha.Cancel returned successfully";
+    tpDebug(logChannels) << "Captcha.Cancel returned successfully";
 
     // Perfect. Close the channel now.
     connect(mChannel->requestClose(),
@@ -150,7 +151,8 @@ void PendingCaptchaCancel::onRequestCloseFinished(Tp::PendingOperation *operatio
 {
     if (operation->isError()) {
         // We cannot really fail just because the channel didn't close. Throw a warning instead.
-        warning() << "Could not close the channel after a successful captcha cancel!!" << operation->errorMessage();
+        tpWarning(logChannels) <<
+            "Could not close the channel after a successful captcha cancel!!" << operation->errorMessage();
     }
 
     setFinished();
@@ -301,7 +303,7 @@ PendingCaptchas *CaptchaAuthentication::requestCaptchas(const QStringList &prefe
 {
     // The captcha should be either LocalPending or TryAgain
     if (status() != CaptchaStatusLocalPending && status() != CaptchaStatusTryAgain) {
-        warning() << "Status must be local pending or try again";
+        tpWarning(logChannels) << "Status must be local pending or try again";
         return new PendingCaptchas(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel busy"), CaptchaAuthenticationPtr(this));
     }
@@ -362,7 +364,7 @@ Tp::PendingOperation *CaptchaAuthentication::answer(const Tp::CaptchaAnswers &re
 {
     // The captcha should be LocalPending or TryAgain
     if (status() != CaptchaStatusLocalPending) {
-        warning() << "Status must be local pending";
+        tpWarning(logChannels) << "Status must be local pending";
         return new PendingCaptchas(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel busy"), CaptchaAuthenticationPtr(this));
     }
@@ -190,7 +190,7 @@ ChannelClass ChannelClassSpec::bareClass() const
     ChannelClass cc;
 
     if (!isValid()) {
-        warning() << "Tried to convert an invalid ChannelClassSpec to a ChannelClass";
+        tpWarning(logChannels) << "Tried to convert an invalid ChannelClassSpec to a ChannelClass";
         return ChannelClass();
     }
 
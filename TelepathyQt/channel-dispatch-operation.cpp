@@ -88,7 +88,7 @@ ChannelDispatchOperation::Private::Private(ChannelDispatchOperation *parent)
       readinessHelper(parent->readinessHelper()),
       gotPossibleHandlers(false)
 {
-    debug() << "Creating new ChannelDispatchOperation:" << parent->objectPath();
+    tpDebug(logClients) << "Creating new ChannelDispatchOperation:" << parent->objectPath();
 
     parent->connect(baseInterface,
             SIGNAL(Finished()),
@@ -132,13 +132,13 @@ void ChannelDispatchOperation::Private::introspectMain(ChannelDispatchOperation:
             && mainProps.contains(QLatin1String("Connection"))
             && mainProps.contains(QLatin1String("Interfaces"))
             && mainProps.contains(QLatin1String("PossibleHandlers"))) {
-        debug() << "Supplied properties were sufficient, not introspecting"
+        tpDebug(logClients) << "Supplied properties were sufficient, not introspecting"
             << self->parent->objectPath();
         self->extractMainProps(mainProps, true);
         return;
     }
 
-    debug() << "Calling Properties::GetAll(ChannelDispatchOperation)";
+    tpDebug(logClients) << "Calling Properties::GetAll(ChannelDispatchOperation)";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(
                 self->properties->GetAll(TP_QT_IFACE_CHANNEL_DISPATCH_OPERATION),
@@ -210,7 +210,7 @@ void ChannelDispatchOperation::Private::extractMainProps(const QVariantMap &prop
     }
 
     if (readyOps.isEmpty()) {
-        debug() << "No proxies to prepare for CDO" << parent->objectPath();
+        tpDebug(logClients) << "No proxies to prepare for CDO" << parent->objectPath();
         readinessHelper->setIntrospectCompleted(FeatureCore, true);
     } else {
         parent->connect(new PendingComposite(readyOps, ChannelDispatchOperationPtr(parent)),
@@ -225,7 +225,7 @@ ChannelDispatchOperation::PendingClaim::PendingClaim(const ChannelDispatchOperat
       mDispatchOp(op),
       mHandler(handler)
 {
-    debug() << "Invoking CDO.Claim";
+    tpDebug(logClients) << "Invoking CDO.Claim";
     connect(new PendingVoid(op->baseInterface()->Claim(), op),
             SIGNAL(finished(Tp::PendingOperation*)),
             SLOT(onClaimFinished(Tp::PendingOperation*)));
@@ -239,7 +239,7 @@ void ChannelDispatchOperation::PendingClaim::onClaimFinished(
         PendingOperation *op)
 {
     if (!op->isError()) {
-        debug() << "CDO.Claim returned successfully, updating HandledChannels";
+        tpDebug(logClients) << "CDO.Claim returned successfully, updating HandledChannels";
         if (mHandler) {
             // register the channels in HandledChannels
             FakeHandlerManager::instance()->registerChannels(
@@ -247,7 +247,8 @@ void ChannelDispatchOperation::PendingClaim::onClaimFinished(
         }
         setFinished();
     } else {
-        warning() << "CDO.Claim failed with" << op->errorName() << "-" << op->errorMessage();
+        tpWarning(logClients) << "CDO.Claim failed with" << op->errorName() << "-" <<
+            op->errorMessage();
         setFinishedWithError(op->errorName(), op->errorMessage());
     }
 }
@@ -366,15 +367,18 @@ ChannelDispatchOperation::ChannelDispatchOperation(const QDBusConnection &bus,
       mPriv(new Private(this))
 {
     if (accountFactory->dbusConnection().name() != bus.name()) {
-        warning() << "  The D-Bus connection in the account factory is not the proxy connection";
+        tpWarning(logClients) <<
+            "  The D-Bus connection in the account factory is not the proxy connection";
     }
 
     if (connectionFactory->dbusConnection().name() != bus.name()) {
-        warning() << "  The D-Bus connection in the connection factory is not the proxy connection";
+        tpWarning(logClients) <<
+            "  The D-Bus connection in the connection factory is not the proxy connection";
     }
 
     if (channelFactory->dbusConnection().name() != bus.name()) {
-        warning() << "  The D-Bus connection in the channel factory is not the proxy connection";
+        tpWarning(logClients) <<
+            "  The D-Bus connection in the channel factory is not the proxy connection";
     }
 
     mPriv->channels = initialChannels;
@@ -431,7 +435,7 @@ AccountPtr ChannelDispatchOperation::account() const
 QList<ChannelPtr> ChannelDispatchOperation::channels() const
 {
     if (!isReady()) {
-        warning() << "ChannelDispatchOperation::channels called with channel "
+        tpWarning(logClients) << "ChannelDispatchOperation::channels called with channel "
             "not ready";
     }
     return mPriv->channels;
@@ -573,7 +577,7 @@ Client::ChannelDispatchOperationInterface *ChannelDispatchOperation::baseInterfa
 
 void ChannelDispatchOperation::onFinished()
 {
-    debug() << "ChannelDispatchOperation finished and was removed";
+    tpDebug(logClients) << "ChannelDispatchOperation finished and was removed";
     invalidate(TP_QT_ERROR_OBJECT_REMOVED,
                QLatin1String("ChannelDispatchOperation finished and was removed"));
 }
@@ -584,12 +588,13 @@ void ChannelDispatchOperation::gotMainProperties(QDBusPendingCallWatcher *watche
 
     // Watcher is NULL if we didn't have to introspect at all
     if (!reply.isError()) {
-        debug() << "Got reply to Properties::GetAll(ChannelDispatchOperation)";
+        tpDebug(logClients) << "Got reply to Properties::GetAll(ChannelDispatchOperation)";
         mPriv->extractMainProps(reply.value(), false);
     } else {
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore,
                 false, reply.error());
-        warning().nospace() << "Properties::GetAll(ChannelDispatchOperation) failed with "
+        tpWarning(logClients).nospace() <<
+            "Properties::GetAll(ChannelDispatchOperation) failed with "
             << reply.error().name() << ": " << reply.error().message();
     }
 }
@@ -610,7 +615,7 @@ void ChannelDispatchOperation::onChannelLost(
 void ChannelDispatchOperation::onProxiesPrepared(Tp::PendingOperation *op)
 {
     if (op->isError()) {
-        warning() << "Preparing proxies for CDO" << objectPath() << "failed with"
+        tpWarning(logClients) << "Preparing proxies for CDO" << objectPath() << "failed with"
             << op->errorName() << ":" << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false);
     } else {
@@ -102,7 +102,7 @@ ChannelRequest::Private::Private(ChannelRequest *parent,
       propertiesDone(false),
       gotSWC(false)
 {
-    debug() << "Creating new ChannelRequest:" << parent->objectPath();
+    tpDebug(logClients) << "Creating new ChannelRequest:" << parent->objectPath();
 
     parent->connect(baseInterface,
             SIGNAL(Failed(QString,QString)),
@@ -166,7 +166,7 @@ void ChannelRequest::Private::introspectMain(ChannelRequest::Private *self)
     }
 
     if (needIntrospectMainProps) {
-        debug() << "Calling Properties::GetAll(ChannelRequest)";
+        tpDebug(logClients) << "Calling Properties::GetAll(ChannelRequest)";
         QDBusPendingCallWatcher *watcher =
             new QDBusPendingCallWatcher(
                     self->properties->GetAll(TP_QT_IFACE_CHANNEL_REQUEST),
@@ -199,7 +199,8 @@ void ChannelRequest::Private::extractMainProps(const QVariantMap &props, bool la
                 // Most often a no-op, but we want this to guarantee the old behavior in all cases
                 readyOp = account->becomeReady();
             } else {
-                warning() << "The account" << accountObjectPath.path() << "was not the expected"
+                tpWarning(logClients) <<
+                    "The account" << accountObjectPath.path() << "was not the expected"
                     << account->objectPath() << "for CR" << parent->objectPath();
                 // Construct a new one instead
                 account.reset();
@@ -247,7 +248,7 @@ void ChannelRequest::Private::extractMainProps(const QVariantMap &props, bool la
                 SIGNAL(finished(Tp::PendingOperation*)),
                 SLOT(onAccountReady(Tp::PendingOperation*)));
     } else if (lastCall) {
-        warning() << "No account for ChannelRequest" << parent->objectPath();
+        tpWarning(logClients) << "No account for ChannelRequest" << parent->objectPath();
         readinessHelper->setIntrospectCompleted(FeatureCore, true);
     }
 }
@@ -348,15 +349,18 @@ ChannelRequest::ChannelRequest(const QDBusConnection &bus,
                   channelFactory, contactFactory))
 {
     if (accountFactory->dbusConnection().name() != bus.name()) {
-        warning() << "  The D-Bus connection in the account factory is not the proxy connection";
+        tpWarning(logClients) <<
+            "  The D-Bus connection in the account factory is not the proxy connection";
     }
 
     if (connectionFactory->dbusConnection().name() != bus.name()) {
-        warning() << "  The D-Bus connection in the connection factory is not the proxy connection";
+        tpWarning(logClients) <<
+            "  The D-Bus connection in the connection factory is not the proxy connection";
     }
 
     if (channelFactory->dbusConnection().name() != bus.name()) {
-        warning() << "  The D-Bus connection in the channel factory is not the proxy connection";
+        tpWarning(logClients) <<
+            "  The D-Bus connection in the channel factory is not the proxy connection";
     }
 }
 
@@ -591,14 +595,14 @@ void ChannelRequest::gotMainProperties(QDBusPendingCallWatcher *watcher)
     QVariantMap props;
 
     if (!reply.isError()) {
-        debug() << "Got reply to Properties::GetAll(ChannelRequest)";
+        tpDebug(logClients) << "Got reply to Properties::GetAll(ChannelRequest)";
         props = reply.value();
 
         mPriv->extractMainProps(props, true);
     } else {
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore,
                 false, reply.error());
-        warning().nospace() << "Properties::GetAll(ChannelRequest) failed with "
+        tpWarning(logClients).nospace() << "Properties::GetAll(ChannelRequest) failed with "
             << reply.error().name() << ": " << reply.error().message();
     }
 
@@ -608,7 +612,7 @@ void ChannelRequest::gotMainProperties(QDBusPendingCallWatcher *watcher)
 void ChannelRequest::onAccountReady(PendingOperation *op)
 {
     if (op->isError()) {
-        warning() << "Unable to make ChannelRequest.Account ready";
+        tpWarning(logClients) << "Unable to make ChannelRequest.Account ready";
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
                 op->errorName(), op->errorMessage());
         return;
@@ -635,7 +639,8 @@ void ChannelRequest::onSucceededWithChannel(
         const QVariantMap &chanProps)
 {
     if (mPriv->gotSWC) {
-        warning().nospace() << "Got SucceededWithChannel again for CR(" << objectPath() << ")!";
+        tpWarning(logClients).nospace() << "Got SucceededWithChannel again for CR(" <<
+            objectPath() << ")!";
         return;
     }
 
@@ -662,7 +667,7 @@ void ChannelRequest::onSucceededWithChannel(
 void ChannelRequest::onChanBuilt(Tp::PendingOperation *op)
 {
     if (op->isError()) {
-        warning() << "Failed to build Channel which the ChannelRequest succeeded with,"
+        tpWarning(logClients) << "Failed to build Channel which the ChannelRequest succeeded with,"
             << "succeeding with NULL channel:" << op->errorName() << ',' << op->errorMessage();
         mPriv->chan.reset();
     }
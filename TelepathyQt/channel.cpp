@@ -31,6 +31,7 @@
 #include "TelepathyQt/debug-internal.h"
 
 #include "TelepathyQt/future-internal.h"
+#include "TelepathyQt/peer-transport-internal.h"
 
 #include <TelepathyQt/ChannelFactory>
 #include <TelepathyQt/Connection>
@@ -269,8 +270,8 @@ const QString Channel::Private::GroupMembersChangedInfo::keyContactIds(QLatin1St
 Channel::Private::Private(Channel *parent, const ConnectionPtr &connection,
         const QVariantMap &immutableProperties)
     : parent(parent),
-      baseInterface(new Client::ChannelInterface(parent)),
-      properties(parent->interface<Client::DBus::PropertiesInterface>()),
+      baseInterface(0),
+      properties(0),
       connection(connection),
       immutableProperties(immutableProperties),
       group(0),
@@ -293,21 +294,26 @@ Channel::Private::Private(Channel *parent, const ConnectionPtr &connection,
       buildingConferenceChannelRemovedActorContact(false),
       introspectingRoomConfig(false)
 {
-    debug() << "Creating new Channel:" << parent->objectPath();
+    tpDebug(logChannels) << "Creating new Channel:" << parent->objectPath();
+
+    // Talk to the service the same way as the connection does, before any interface is built
+    PeerTransport::inherit(parent, connection.data());
+    baseInterface = new Client::ChannelInterface(parent);
+    properties = parent->interface<Client::DBus::PropertiesInterface>();
 
     if (connection->isValid()) {
-        debug() << " Connecting to Channel::Closed() signal";
+        tpDebug(logChannels) << " Connecting to Channel::Closed() signal";
         parent->connect(baseInterface,
                         SIGNAL(Closed()),
                         SLOT(onClosed()));
 
-        debug() << " Connection to owning connection's lifetime signals";
+        tpDebug(logChannels) << " Connection to owning connection's lifetime signals";
         parent->connect(connection.data(),
                         SIGNAL(invalidated(Tp::DBusProxy*,QString,QString)),
                         SLOT(onConnectionInvalidated()));
     }
     else {
-        warning() << "Connection given as the owner for a Channel was "
+        tpWarning(logChannels) << "Connection given as the owner for a Channel was "
             "invalid! Channel will be stillborn.";
         parent->invalidate(TP_QT_ERROR_INVALID_ARGUMENT,
                 QLatin1String("Connection given as the owner of this channel was invalid"));
@@ -352,7 +358,7 @@ void Channel::Private::introspectMain(Channel::Private *self)
 {
     // Make sure connection object is ready, as we need to use some methods that
     // are only available after connection object gets ready.
-    debug() << "Calling Connection::becomeReady()";
+    tpDebug(logChannels) << "Calling Connection::becomeReady()";
     self->parent->connect(self->connection->becomeReady(),
             SIGNAL(finished(Tp::PendingOperation*)),
             SLOT(onConnectionReady(Tp::PendingOperation*)));
@@ -403,7 +409,7 @@ void Channel::Private::introspectMainProperties()
     }
 
     if (needIntrospectMainProps) {
-        debug() << "Calling Properties::GetAll(Channel)";
+        tpDebug(logChannels) << "Calling Properties::GetAll(Channel)";
         QDBusPendingCallWatcher *watcher =
             new QDBusPendingCallWatcher(
                     properties->GetAll(TP_QT_IFACE_CHANNEL),
@@ -419,7 +425,7 @@ void Channel::Private::introspectMainProperties()
 
 void Channel::Private::introspectMainFallbackChannelType()
 {
-    debug() << "Calling Channel::GetChannelType()";
+    tpDebug(logChannels) << "Calling Channel::GetChannelType()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(baseInterface->GetChannelType(), parent);
     parent->connect(watcher,
@@ -429,7 +435,7 @@ void Channel::Private::introspectMainFallbackChannelType()
 
 void Channel::Private::introspectMainFallbackHandle()
 {
-    debug() << "Calling Channel::GetHandle()";
+    tpDebug(logChannels) << "Calling Channel::GetHandle()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(baseInterface->GetHandle(), parent);
     parent->connect(watcher,
@@ -439,7 +445,7 @@ void Channel::Private::introspectMainFallbackHandle()
 
 void Channel::Private::introspectMainFallbackInterfaces()
 {
-    debug() << "Calling Channel::GetInterfaces()";
+    tpDebug(logChannels) << "Calling Channel::GetInterfaces()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(baseInterface->GetInterfaces(), parent);
     parent->connect(watcher,
@@ -456,7 +462,7 @@ void Channel::Private::introspectGroup()
         Q_ASSERT(group != 0);
     }
 
-    debug() << "Introspecting Channel.Interface.Group for" << parent->objectPath();
+    tpDebug(logChannels) << "Introspecting Channel.Interface.Group for" << parent->objectPath();
 
     parent->connect(group,
                     SIGNAL(GroupFlagsChanged(uint,uint)),
@@ -487,7 +493,7 @@ void Channel::Private::introspectGroup()
                     SIGNAL(SelfHandleChanged(uint)),
                     SLOT(onSelfHandleChanged(uint)));
 
-    debug() << "Calling Properties::GetAll(Channel.Interface.Group)";
+    tpDebug(logChannels) << "Calling Properties::GetAll(Channel.Interface.Group)";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(
                 properties->GetAll(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP),
@@ -501,7 +507,7 @@ void Channel::Private::introspectGroupFallbackFlags()
 {
     Q_ASSERT(group != 0);
 
-    debug() << "Calling Channel.Interface.Group::GetGroupFlags()";
+    tpDebug(logChannels) << "Calling Channel.Interface.Group::GetGroupFlags()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(group->GetGroupFlags(), parent);
     parent->connect(watcher,
@@ -513,7 +519,7 @@ void Channel::Private::introspectGroupFallbackMembers()
 {
     Q_ASSERT(group != 0);
 
-    debug() << "Calling Channel.Interface.Group::GetAllMembers()";
+    tpDebug(logChannels) << "Calling Channel.Interface.Group::GetAllMembers()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(group->GetAllMembers(), parent);
     parent->connect(watcher,
@@ -525,7 +531,7 @@ void Channel::Private::introspectGroupFallbackLocalPendingWithInfo()
 {
     Q_ASSERT(group != 0);
 
-    debug() << "Calling Channel.Interface.Group::GetLocalPendingMembersWithInfo()";
+    tpDebug(logChannels) << "Calling Channel.Interface.Group::GetLocalPendingMembersWithInfo()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(group->GetLocalPendingMembersWithInfo(),
                 parent);
@@ -538,7 +544,7 @@ void Channel::Private::introspectGroupFallbackSelfHandle()
 {
     Q_ASSERT(group != 0);
 
-    debug() << "Calling Channel.Interface.Group::GetSelfHandle()";
+    tpDebug(logChannels) << "Calling Channel.Interface.Group::GetSelfHandle()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(group->GetSelfHandle(), parent);
     parent->connect(watcher,
@@ -551,13 +557,13 @@ void Channel::Private::introspectConference()
     Q_ASSERT(properties != 0);
     Q_ASSERT(conference == 0);
 
-    debug() << "Introspecting Conference interface";
+    tpDebug(logChannels) << "Introspecting Conference interface";
     conference = parent->interface<Client::ChannelInterfaceConferenceInterface>();
     Q_ASSERT(conference != 0);
 
     introspectingConference = true;
 
-    debug() << "Connecting to Channel.Interface.Conference.ChannelMerged/Removed";
+    tpDebug(logChannels) << "Connecting to Channel.Interface.Conference.ChannelMerged/Removed";
     parent->connect(conference,
             SIGNAL(ChannelMerged(QDBusObjectPath,uint,QVariantMap)),
             SLOT(onConferenceChannelMerged(QDBusObjectPath,uint,QVariantMap)));
@@ -565,7 +571,7 @@ void Channel::Private::introspectConference()
             SIGNAL(ChannelRemoved(QDBusObjectPath,QVariantMap)),
             SLOT(onConferenceChannelRemoved(QDBusObjectPath,QVariantMap)));
 
-    debug() << "Calling Properties::GetAll(Channel.Interface.Conference)";
+    tpDebug(logChannels) << "Calling Properties::GetAll(Channel.Interface.Conference)";
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
             properties->GetAll(TP_QT_IFACE_CHANNEL_INTERFACE_CONFERENCE),
             parent);
@@ -579,14 +585,14 @@ void Channel::Private::introspectRoomConfig()
     Q_ASSERT(properties != 0);
     Q_ASSERT(roomConfig == 0);
 
-    debug() << "Introspecting RoomConfig interface";
+    tpDebug(logChannels) << "Introspecting RoomConfig interface";
     roomConfig = parent->interface<Client::ChannelInterfaceRoomConfigInterface>();
     roomConfig->setMonitorProperties(true);
     Q_ASSERT(roomConfig != 0);
 
     introspectingRoomConfig = true;
 
-    debug() << "Calling Properties::GetAll(Channel.Interface.RoomConfig)";
+    tpDebug(logChannels) << "Calling Properties::GetAll(Channel.Interface.RoomConfig)";
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
             properties->GetAll(TP_QT_IFACE_CHANNEL_INTERFACE_ROOM_CONFIG),
             parent);
@@ -621,10 +627,12 @@ void Channel::Private::continueIntrospection()
             if (groupMembersChangedQueue.isEmpty() && !buildingContacts
                     && !introspectingRoomConfig
                     && !introspectingConference) {
-                debug() << "Both the IS and the MCD queue empty for the first time. Ready.";
+                tpDebug(logChannels) <<
+                    "Both the IS and the MCD queue empty for the first time. Ready.";
                 setReady();
             } else {
-                debug() << "Introspection done before contacts done - contacts sets ready";
+                tpDebug(logChannels) <<
+                    "Introspection done before contacts done - contacts sets ready";
             }
         }
     } else {
@@ -647,7 +655,7 @@ void Channel::Private::extractMainProps(const QVariantMap &props)
                   && props.contains(keyTargetHandleType);
 
     if (!haveProps) {
-        warning() << "Channel properties specified in 0.17.7 not found";
+        tpWarning(logChannels) << "Channel properties specified in 0.17.7 not found";
 
         introspectQueue.enqueue(&Private::introspectMainFallbackChannelType);
         introspectQueue.enqueue(&Private::introspectMainFallbackHandle);
@@ -703,7 +711,7 @@ void Channel::Private::extractMainProps(const QVariantMap &props)
         nowHaveInterfaces();
     }
 
-    debug() << "Have initiator handle:" << (initiatorHandle ? "yes" : "no");
+    tpDebug(logChannels) << "Have initiator handle:" << (initiatorHandle ? "yes" : "no");
 }
 
 void Channel::Private::extract0176GroupProps(const QVariantMap &props)
@@ -726,15 +734,15 @@ void Channel::Private::extract0176GroupProps(const QVariantMap &props)
                   && props.contains(keySelfHandle);
 
     if (!haveProps) {
-        warning() << " Properties specified in 0.17.6 not found";
-        warning() << "  Handle owners and self handle tracking disabled";
+        tpWarning(logChannels) << " Properties specified in 0.17.6 not found";
+        tpWarning(logChannels) << "  Handle owners and self handle tracking disabled";
 
         introspectQueue.enqueue(&Private::introspectGroupFallbackFlags);
         introspectQueue.enqueue(&Private::introspectGroupFallbackMembers);
         introspectQueue.enqueue(&Private::introspectGroupFallbackLocalPendingWithInfo);
         introspectQueue.enqueue(&Private::introspectGroupFallbackSelfHandle);
     } else {
-        debug() << " Found properties specified in 0.17.6";
+        tpDebug(logChannels) << " Found properties specified in 0.17.6";
 
         groupAreHandleOwnersAvailable = true;
         groupIsSelfHandleTracked = true;
@@ -758,7 +766,7 @@ void Channel::Private::extract0176GroupProps(const QVariantMap &props)
 
 void Channel::Private::nowHaveInterfaces()
 {
-    debug() << "Channel has" << parent->interfaces().size() <<
+    tpDebug(logChannels) << "Channel has" << parent->interfaces().size() <<
         "optional interfaces:" << parent->interfaces();
 
     QStringList interfaces = parent->interfaces();
@@ -838,7 +846,7 @@ bool Channel::Private::setGroupFlags(uint newGroupFlags)
     if ((groupFlags & ChannelGroupFlagMembersChangedDetailed) &&
         !usingMembersChangedDetailed) {
         usingMembersChangedDetailed = true;
-        debug() << "Starting to exclusively listen to MembersChangedDetailed for" <<
+        tpDebug(logChannels) << "Starting to exclusively listen to MembersChangedDetailed for" <<
             parent->objectPath();
         parent->disconnect(group,
                            SIGNAL(MembersChanged(QString,Tp::UIntList,
@@ -850,7 +858,8 @@ bool Channel::Private::setGroupFlags(uint newGroupFlags)
                                    Tp::UIntList,uint,uint)));
     } else if (!(groupFlags & ChannelGroupFlagMembersChangedDetailed) &&
                usingMembersChangedDetailed) {
-        warning() << " Channel service did spec-incompliant removal of MCD from GroupFlags";
+        tpWarning(logChannels) <<
+            " Channel service did spec-incompliant removal of MCD from GroupFlags";
         usingMembersChangedDetailed = false;
         parent->connect(group,
                         SIGNAL(MembersChanged(QString,Tp::UIntList,
@@ -930,26 +939,30 @@ void Channel::Private::processMembersChanged()
 
         if (!parent->isReady(Channel::FeatureCore)) {
             if (introspectQueue.isEmpty()) {
-                debug() << "Both the MCD and the introspect queue empty for the first time. Ready!";
+                tpDebug(logChannels) <<
+                    "Both the MCD and the introspect queue empty for the first time. Ready!";
 
                 if (initiatorHandle && !initiatorContact) {
-                    warning() << " Unable to create contact object for initiator with handle" <<
+                    tpWarning(logChannels) <<
+                        " Unable to create contact object for initiator with handle" <<
                         initiatorHandle;
                 }
 
                 if (targetHandleType == HandleTypeContact && targetHandle != 0 && !targetContact) {
-                    warning() << " Unable to create contact object for target with handle" <<
+                    tpWarning(logChannels) <<
+                        " Unable to create contact object for target with handle" <<
                         targetHandle;
                 }
 
                 if (groupSelfHandle && !groupSelfContact) {
-                    warning() << " Unable to create contact object for self handle" <<
+                    tpWarning(logChannels) << " Unable to create contact object for self handle" <<
                         groupSelfHandle;
                 }
 
                 continueIntrospection();
             } else {
-                debug() << "Contact queue empty but introspect queue isn't. IS will set ready.";
+                tpDebug(logChannels) <<
+                    "Contact queue empty but introspect queue isn't. IS will set ready.";
             }
         }
 
@@ -1009,7 +1022,8 @@ void Channel::Private::updateContacts(const QList<ContactPtr> &contacts)
     ContactPtr actorContact;
     bool selfContactUpdated = false;
 
-    debug() << "Entering Chan::Priv::updateContacts() with" << contacts.size() << "contacts";
+    tpDebug(logChannels) << "Entering Chan::Priv::updateContacts() with" << contacts.size() <<
+        "contacts";
 
     // FIXME: simplify. Some duplication of logic present.
     foreach (ContactPtr contact, contacts) {
@@ -1161,12 +1175,12 @@ bool Channel::Private::fakeGroupInterfaceIfNeeded()
         groupSelfHandle = connection->selfHandle();
         groupInitialMembers = UIntList() << groupSelfHandle << targetHandle;
 
-        debug().nospace() << "Faking a group on channel with self handle=" <<
+        tpDebug(logChannels).nospace() << "Faking a group on channel with self handle=" <<
             groupSelfHandle << " and other handle=" << targetHandle;
 
         nowHaveInitialMembers();
     } else {
-        warning() << "Connection::selfHandle is 0 or targetHandle is 0, "
+        tpWarning(logChannels) << "Connection::selfHandle is 0 or targetHandle is 0, "
             "not faking a group on channel";
     }
 
@@ -1177,27 +1191,27 @@ void Channel::Private::setReady()
 {
     Q_ASSERT(!parent->isReady(Channel::FeatureCore));
 
-    debug() << "Channel fully ready";
-    debug() << " Channel type" << channelType;
-    debug() << " Target handle" << targetHandle;
-    debug() << " Target handle type" << targetHandleType;
+    tpDebug(logChannels) << "Channel fully ready";
+    tpDebug(logChannels) << " Channel type" << channelType;
+    tpDebug(logChannels) << " Target handle" << targetHandle;
+    tpDebug(logChannels) << " Target handle type" << targetHandleType;
 
     if (parent->interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        debug() << " Group: flags" << groupFlags;
+        tpDebug(logChannels) << " Group: flags" << groupFlags;
         if (groupAreHandleOwnersAvailable) {
-            debug() << " Group: Number of handle owner mappings" <<
+            tpDebug(logChannels) << " Group: Number of handle owner mappings" <<
                 groupHandleOwners.size();
         }
         else {
-            debug() << " Group: No handle owners property present";
+            tpDebug(logChannels) << " Group: No handle owners property present";
         }
-        debug() << " Group: Number of current members" <<
+        tpDebug(logChannels) << " Group: Number of current members" <<
             groupContacts.size();
-        debug() << " Group: Number of local pending members" <<
+        tpDebug(logChannels) << " Group: Number of local pending members" <<
             groupLocalPendingContacts.size();
-        debug() << " Group: Number of remote pending members" <<
+        tpDebug(logChannels) << " Group: Number of remote pending members" <<
             groupRemotePendingContacts.size();
-        debug() << " Group: Self handle" << groupSelfHandle <<
+        tpDebug(logChannels) << " Group: Self handle" << groupSelfHandle <<
             "tracked:" << (groupIsSelfHandleTracked ? "yes" : "no");
     }
 
@@ -1720,11 +1734,11 @@ QString Channel::channelType() const
     // Similarly, we don't want warnings triggered when using the type interface
     // proxies internally.
     if (!isReady(Channel::FeatureCore) && mPriv->channelType.isEmpty()) {
-        warning() << "Channel::channelType() before the channel type has "
+        tpWarning(logChannels) << "Channel::channelType() before the channel type has "
             "been received";
     }
     else if (!isValid()) {
-        warning() << "Channel::channelType() used with channel closed";
+        tpWarning(logChannels) << "Channel::channelType() used with channel closed";
     }
 
     return mPriv->channelType;
@@ -1742,7 +1756,7 @@ QString Channel::channelType() const
 HandleType Channel::targetHandleType() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::targetHandleType() used channel not ready";
+        tpWarning(logChannels) << "Channel::targetHandleType() used channel not ready";
     }
 
     return (HandleType) mPriv->targetHandleType;
@@ -1761,7 +1775,7 @@ HandleType Channel::targetHandleType() const
 uint Channel::targetHandle() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::targetHandle() used channel not ready";
+        tpWarning(logChannels) << "Channel::targetHandle() used channel not ready";
     }
 
     return mPriv->targetHandle;
@@ -1786,7 +1800,7 @@ uint Channel::targetHandle() const
 QString Channel::targetId() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::targetId() used, but the channel is not ready";
+        tpWarning(logChannels) << "Channel::targetId() used, but the channel is not ready";
     }
 
     return mPriv->targetId;
@@ -1804,9 +1818,10 @@ QString Channel::targetId() const
 ContactPtr Channel::targetContact() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::targetContact() used, but the channel is not ready";
+        tpWarning(logChannels) << "Channel::targetContact() used, but the channel is not ready";
     } else if (targetHandleType() != HandleTypeContact) {
-        warning() << "Channel::targetContact() used with targetHandleType() != Contact";
+        tpWarning(logChannels) <<
+            "Channel::targetContact() used with targetHandleType() != Contact";
     }
 
     return mPriv->targetContact;
@@ -1815,9 +1830,9 @@ ContactPtr Channel::targetContact() const
 RoomPtr Channel::targetRoom() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::targetRoom() used, but the channel is not ready";
+        tpWarning(logChannels) << "Channel::targetRoom() used, but the channel is not ready";
     } else if (targetHandleType() != HandleTypeRoom) {
-        warning() << "Channel::targetRoom() used with targetHandleType() != Room";
+        tpWarning(logChannels) << "Channel::targetRoom() used with targetHandleType() != Room";
     }
 
     return mPriv->targetRoom;
@@ -1835,7 +1850,7 @@ RoomPtr Channel::targetRoom() const
 bool Channel::isRequested() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::isRequested() used channel not ready";
+        tpWarning(logChannels) << "Channel::isRequested() used channel not ready";
     }
 
     return mPriv->requested;
@@ -1852,7 +1867,7 @@ bool Channel::isRequested() const
 ContactPtr Channel::initiatorContact() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::initiatorContact() used channel not ready";
+        tpWarning(logChannels) << "Channel::initiatorContact() used channel not ready";
     }
 
     return mPriv->initiatorContact;
@@ -1909,7 +1924,7 @@ void Channel::PendingLeave::onChanInvalidated(Tp::DBusProxy *proxy)
         return;
     }
 
-    debug() << "Finishing PendingLeave successfully as the channel was invalidated";
+    tpDebug(logChannels) << "Finishing PendingLeave successfully as the channel was invalidated";
 
     setFinished();
 }
@@ -1923,14 +1938,14 @@ void Channel::PendingLeave::onRemoveFinished(Tp::PendingOperation *op)
     ChannelPtr chan = ChannelPtr::staticCast(object());
 
     if (op->isValid()) {
-        debug() << "We left the channel" << chan->objectPath();
+        tpDebug(logChannels) << "We left the channel" << chan->objectPath();
 
         ContactPtr c = chan->groupSelfContact();
 
         if (chan->groupContacts().contains(c)
                 || chan->groupLocalPendingContacts().contains(c)
                 || chan->groupRemotePendingContacts().contains(c)) {
-            debug() << "Waiting for self remove to be picked up";
+            tpDebug(logChannels) << "Waiting for self remove to be picked up";
             connect(chan.data(),
                     SIGNAL(groupMembersChanged(Tp::Contacts,Tp::Contacts,Tp::Contacts,Tp::Contacts,
                             Tp::Channel::GroupMemberChangeDetails)),
@@ -1943,7 +1958,8 @@ void Channel::PendingLeave::onRemoveFinished(Tp::PendingOperation *op)
         return;
     }
 
-    debug() << "Leave RemoveMembersWithReason failed with " << op->errorName() << op->errorMessage()
+    tpDebug(logChannels) <<
+        "Leave RemoveMembersWithReason failed with " << op->errorName() << op->errorMessage()
         << "- falling back to Close";
 
     // If the channel has been closed or otherwise invalidated already in this mainloop iteration,
@@ -1965,7 +1981,7 @@ void Channel::PendingLeave::onMembersChanged(const Tp::Contacts &, const Tp::Con
     ContactPtr c = chan->groupSelfContact();
 
     if (removed.contains(c)) {
-        debug() << "Leave event picked up for" << chan->objectPath();
+        tpDebug(logChannels) << "Leave event picked up for" << chan->objectPath();
         setFinished();
     }
 }
@@ -1979,12 +1995,12 @@ void Channel::PendingLeave::onCloseFinished(Tp::PendingOperation *op)
     ChannelPtr chan = ChannelPtr::staticCast(object());
 
     if (op->isError()) {
-        warning() << "Closing the channel" << chan->objectPath()
+        tpWarning(logChannels) << "Closing the channel" << chan->objectPath()
             << "as a fallback for leaving it failed with"
             << op->errorName() << op->errorMessage() << "- so didn't leave";
         setFinishedWithError(op->errorName(), op->errorMessage());
     } else {
-        debug() << "We left (by closing) the channel" << chan->objectPath();
+        tpDebug(logChannels) << "We left (by closing) the channel" << chan->objectPath();
         setFinished();
     }
 }
@@ -2034,7 +2050,7 @@ PendingOperation *Channel::requestLeave(const QString &message, ChannelGroupChan
 
     if (!groupContacts().contains(self) && !groupLocalPendingContacts().contains(self)
             && !groupRemotePendingContacts().contains(self)) {
-        debug() << "Channel::requestLeave() called for " << objectPath() <<
+        tpDebug(logChannels) << "Channel::requestLeave() called for " << objectPath() <<
             "which we aren't a member of";
         return new PendingSuccess(ChannelPtr(this));
     }
@@ -2081,7 +2097,7 @@ PendingOperation *Channel::requestLeave(const QString &message, ChannelGroupChan
 ChannelGroupFlags Channel::groupFlags() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupFlags() used channel not ready";
+        tpWarning(logChannels) << "Channel::groupFlags() used channel not ready";
     }
 
     return (ChannelGroupFlags) mPriv->groupFlags;
@@ -2101,7 +2117,7 @@ ChannelGroupFlags Channel::groupFlags() const
 bool Channel::groupCanAddContacts() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupCanAddContacts() used channel not ready";
+        tpWarning(logChannels) << "Channel::groupCanAddContacts() used channel not ready";
     }
 
     return mPriv->groupFlags & ChannelGroupFlagCanAdd;
@@ -2119,7 +2135,8 @@ bool Channel::groupCanAddContacts() const
 bool Channel::groupCanAddContactsWithMessage() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupCanAddContactsWithMessage() used when channel not ready";
+        tpWarning(logChannels) <<
+            "Channel::groupCanAddContactsWithMessage() used when channel not ready";
     }
 
     return mPriv->groupFlags & ChannelGroupFlagMessageAdd;
@@ -2137,7 +2154,8 @@ bool Channel::groupCanAddContactsWithMessage() const
 bool Channel::groupCanAcceptContactsWithMessage() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupCanAcceptContactsWithMessage() used when channel not ready";
+        tpWarning(logChannels) <<
+            "Channel::groupCanAcceptContactsWithMessage() used when channel not ready";
     }
 
     return mPriv->groupFlags & ChannelGroupFlagMessageAccept;
@@ -2169,12 +2187,12 @@ PendingOperation *Channel::groupAddContacts(const QList<ContactPtr> &contacts,
         const QString &message)
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupAddContacts() used channel not ready";
+        tpWarning(logChannels) << "Channel::groupAddContacts() used channel not ready";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel not ready"),
                 ChannelPtr(this));
     } else if (contacts.isEmpty()) {
-        warning() << "Channel::groupAddContacts() used with empty contacts param";
+        tpWarning(logChannels) << "Channel::groupAddContacts() used with empty contacts param";
         return new PendingFailure(TP_QT_ERROR_INVALID_ARGUMENT,
                 QLatin1String("contacts cannot be an empty list"),
                 ChannelPtr(this));
@@ -2182,7 +2200,8 @@ PendingOperation *Channel::groupAddContacts(const QList<ContactPtr> &contacts,
 
     foreach (const ContactPtr &contact, contacts) {
         if (!contact) {
-            warning() << "Channel::groupAddContacts() used but contacts param contains "
+            tpWarning(logChannels) <<
+                "Channel::groupAddContacts() used but contacts param contains "
                 "invalid contact";
             return new PendingFailure(TP_QT_ERROR_INVALID_ARGUMENT,
                     QLatin1String("Unable to add invalid contacts"),
@@ -2191,7 +2210,7 @@ PendingOperation *Channel::groupAddContacts(const QList<ContactPtr> &contacts,
     }
 
     if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        warning() << "Channel::groupAddContacts() used with no group interface";
+        tpWarning(logChannels) << "Channel::groupAddContacts() used with no group interface";
         return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("Channel does not support group interface"),
                 ChannelPtr(this));
@@ -2218,7 +2237,7 @@ PendingOperation *Channel::groupAddContacts(const QList<ContactPtr> &contacts,
 bool Channel::groupCanRescindContacts() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupCanRescindContacts() used channel not ready";
+        tpWarning(logChannels) << "Channel::groupCanRescindContacts() used channel not ready";
     }
 
     return mPriv->groupFlags & ChannelGroupFlagCanRescind;
@@ -2237,7 +2256,8 @@ bool Channel::groupCanRescindContacts() const
 bool Channel::groupCanRescindContactsWithMessage() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupCanRescindContactsWithMessage() used when channel not ready";
+        tpWarning(logChannels) <<
+            "Channel::groupCanRescindContactsWithMessage() used when channel not ready";
     }
 
     return mPriv->groupFlags & ChannelGroupFlagMessageRescind;
@@ -2259,7 +2279,7 @@ bool Channel::groupCanRescindContactsWithMessage() const
 bool Channel::groupCanRemoveContacts() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupCanRemoveContacts() used channel not ready";
+        tpWarning(logChannels) << "Channel::groupCanRemoveContacts() used channel not ready";
     }
 
     return mPriv->groupFlags & ChannelGroupFlagCanRemove;
@@ -2277,7 +2297,8 @@ bool Channel::groupCanRemoveContacts() const
 bool Channel::groupCanRemoveContactsWithMessage() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupCanRemoveContactsWithMessage() used when channel not ready";
+        tpWarning(logChannels) <<
+            "Channel::groupCanRemoveContactsWithMessage() used when channel not ready";
     }
 
     return mPriv->groupFlags & ChannelGroupFlagMessageRemove;
@@ -2296,7 +2317,8 @@ bool Channel::groupCanRemoveContactsWithMessage() const
 bool Channel::groupCanRejectContactsWithMessage() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupCanRejectContactsWithMessage() used when channel not ready";
+        tpWarning(logChannels) <<
+            "Channel::groupCanRejectContactsWithMessage() used when channel not ready";
     }
 
     return mPriv->groupFlags & ChannelGroupFlagMessageReject;
@@ -2312,7 +2334,8 @@ bool Channel::groupCanRejectContactsWithMessage() const
 bool Channel::groupCanDepartWithMessage() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupCanDepartWithMessage() used when channel not ready";
+        tpWarning(logChannels) <<
+            "Channel::groupCanDepartWithMessage() used when channel not ready";
     }
 
     return mPriv->groupFlags & ChannelGroupFlagMessageDepart;
@@ -2363,14 +2386,14 @@ PendingOperation *Channel::groupRemoveContacts(const QList<ContactPtr> &contacts
         const QString &message, ChannelGroupChangeReason reason)
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupRemoveContacts() used channel not ready";
+        tpWarning(logChannels) << "Channel::groupRemoveContacts() used channel not ready";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel not ready"),
                 ChannelPtr(this));
     }
 
     if (contacts.isEmpty()) {
-        warning() << "Channel::groupRemoveContacts() used with empty contacts param";
+        tpWarning(logChannels) << "Channel::groupRemoveContacts() used with empty contacts param";
         return new PendingFailure(TP_QT_ERROR_INVALID_ARGUMENT,
                 QLatin1String("contacts param cannot be an empty list"),
                 ChannelPtr(this));
@@ -2378,7 +2401,8 @@ PendingOperation *Channel::groupRemoveContacts(const QList<ContactPtr> &contacts
 
     foreach (const ContactPtr &contact, contacts) {
         if (!contact) {
-            warning() << "Channel::groupRemoveContacts() used but contacts param contains "
+            tpWarning(logChannels) <<
+                "Channel::groupRemoveContacts() used but contacts param contains "
                 "invalid contact:";
             return new PendingFailure(TP_QT_ERROR_INVALID_ARGUMENT,
                     QLatin1String("Unable to remove invalid contacts"),
@@ -2387,7 +2411,7 @@ PendingOperation *Channel::groupRemoveContacts(const QList<ContactPtr> &contacts
     }
 
     if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        warning() << "Channel::groupRemoveContacts() used with no group interface";
+        tpWarning(logChannels) << "Channel::groupRemoveContacts() used with no group interface";
         return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("Channel does not support group interface"),
                 ChannelPtr(this));
@@ -2420,7 +2444,7 @@ PendingOperation *Channel::groupRemoveContacts(const QList<ContactPtr> &contacts
 Contacts Channel::groupContacts(bool includeSelfContact) const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupMembers() used channel not ready";
+        tpWarning(logChannels) << "Channel::groupMembers() used channel not ready";
     }
 
     Contacts ret = mPriv->groupContacts.values().toSet();
@@ -2449,9 +2473,10 @@ Contacts Channel::groupContacts(bool includeSelfContact) const
 Contacts Channel::groupLocalPendingContacts(bool includeSelfContact) const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupLocalPendingContacts() used channel not ready";
+        tpWarning(logChannels) << "Channel::groupLocalPendingContacts() used channel not ready";
     } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        warning() << "Channel::groupLocalPendingContacts() used with no group interface";
+        tpWarning(logChannels) <<
+            "Channel::groupLocalPendingContacts() used with no group interface";
     }
 
     Contacts ret = mPriv->groupLocalPendingContacts.values().toSet();
@@ -2480,9 +2505,9 @@ Contacts Channel::groupLocalPendingContacts(bool includeSelfContact) const
 Contacts Channel::groupRemotePendingContacts(bool includeSelfContact) const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupRemotePendingContacts() used channel not ready";
+        tpWarning(logChannels) << "Channel::groupRemotePendingContacts() used channel not ready";
     } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        warning() << "Channel::groupRemotePendingContacts() used with no "
+        tpWarning(logChannels) << "Channel::groupRemotePendingContacts() used with no "
             "group interface";
     }
 
@@ -2507,11 +2532,14 @@ Channel::GroupMemberChangeDetails Channel::groupLocalPendingContactChangeInfo(
         const ContactPtr &contact) const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupLocalPendingContactChangeInfo() used channel not ready";
+        tpWarning(logChannels) <<
+            "Channel::groupLocalPendingContactChangeInfo() used channel not ready";
     } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        warning() << "Channel::groupLocalPendingContactChangeInfo() used with no group interface";
+        tpWarning(logChannels) <<
+            "Channel::groupLocalPendingContactChangeInfo() used with no group interface";
     } else if (!contact) {
-        warning() << "Channel::groupLocalPendingContactChangeInfo() used with null contact param";
+        tpWarning(logChannels) <<
+            "Channel::groupLocalPendingContactChangeInfo() used with null contact param";
         return GroupMemberChangeDetails();
     }
 
@@ -2542,9 +2570,10 @@ Channel::GroupMemberChangeDetails Channel::groupSelfContactRemoveInfo() const
     // Oftentimes, the channel will be closed as a result from being left - so checking a channel's
     // self remove info when it has been closed and hence invalidated is valid
     if (isValid() && !isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupSelfContactRemoveInfo() used before Channel::FeatureCore is ready";
+        tpWarning(logChannels) <<
+            "Channel::groupSelfContactRemoveInfo() used before Channel::FeatureCore is ready";
     } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        warning() << "Channel::groupSelfContactRemoveInfo() used with "
+        tpWarning(logChannels) << "Channel::groupSelfContactRemoveInfo() used with "
             "no group interface";
     }
 
@@ -2577,9 +2606,9 @@ Channel::GroupMemberChangeDetails Channel::groupSelfContactRemoveInfo() const
 bool Channel::groupAreHandleOwnersAvailable() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupAreHandleOwnersAvailable() used channel not ready";
+        tpWarning(logChannels) << "Channel::groupAreHandleOwnersAvailable() used channel not ready";
     } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        warning() << "Channel::groupAreHandleOwnersAvailable() used with "
+        tpWarning(logChannels) << "Channel::groupAreHandleOwnersAvailable() used with "
             "no group interface";
     }
 
@@ -2605,13 +2634,13 @@ bool Channel::groupAreHandleOwnersAvailable() const
 HandleOwnerMap Channel::groupHandleOwners() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupHandleOwners() used channel not ready";
+        tpWarning(logChannels) << "Channel::groupHandleOwners() used channel not ready";
     } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        warning() << "Channel::groupAreHandleOwnersAvailable() used with no "
+        tpWarning(logChannels) << "Channel::groupAreHandleOwnersAvailable() used with no "
             "group interface";
     }
     else if (!groupAreHandleOwnersAvailable()) {
-        warning() << "Channel::groupAreHandleOwnersAvailable() used, but handle "
+        tpWarning(logChannels) << "Channel::groupAreHandleOwnersAvailable() used, but handle "
             "owners not available";
     }
 
@@ -2635,9 +2664,9 @@ HandleOwnerMap Channel::groupHandleOwners() const
 bool Channel::groupIsSelfContactTracked() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupIsSelfHandleTracked() used channel not ready";
+        tpWarning(logChannels) << "Channel::groupIsSelfHandleTracked() used channel not ready";
     } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        warning() << "Channel::groupIsSelfHandleTracked() used with "
+        tpWarning(logChannels) << "Channel::groupIsSelfHandleTracked() used with "
             "no group interface";
     }
 
@@ -2657,7 +2686,7 @@ bool Channel::groupIsSelfContactTracked() const
 ContactPtr Channel::groupSelfContact() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupSelfContact() used channel not ready";
+        tpWarning(logChannels) << "Channel::groupSelfContact() used channel not ready";
     }
 
     return mPriv->groupSelfContact;
@@ -2675,7 +2704,7 @@ ContactPtr Channel::groupSelfContact() const
 bool Channel::groupSelfHandleIsLocalPending() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupSelfHandleIsLocalPending() used when "
+        tpWarning(logChannels) << "Channel::groupSelfHandleIsLocalPending() used when "
             "channel not ready";
         return false;
     }
@@ -2696,7 +2725,7 @@ bool Channel::groupSelfHandleIsLocalPending() const
 PendingOperation *Channel::groupAddSelfHandle()
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupAddSelfHandle() used when channel not "
+        tpWarning(logChannels) << "Channel::groupAddSelfHandle() used when channel not "
             "ready";
         return new PendingFailure(TP_QT_ERROR_INVALID_ARGUMENT,
                 QLatin1String("Channel object not ready"),
@@ -2914,10 +2943,10 @@ void Channel::gotMainProperties(QDBusPendingCallWatcher *watcher)
     QVariantMap props;
 
     if (!reply.isError()) {
-        debug() << "Got reply to Properties::GetAll(Channel)";
+        tpDebug(logChannels) << "Got reply to Properties::GetAll(Channel)";
         props = reply.value();
     } else {
-        warning().nospace() << "Properties::GetAll(Channel) failed with " <<
+        tpWarning(logChannels).nospace() << "Properties::GetAll(Channel) failed with " <<
             reply.error().name() << ": " << reply.error().message();
     }
 
@@ -2931,14 +2960,14 @@ void Channel::gotChannelType(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<QString> reply = *watcher;
 
     if (reply.isError()) {
-        warning().nospace() << "Channel::GetChannelType() failed with " <<
+        tpWarning(logChannels).nospace() << "Channel::GetChannelType() failed with " <<
             reply.error().name() << ": " << reply.error().message() <<
             ", Channel officially dead";
         invalidate(reply.error());
         return;
     }
 
-    debug() << "Got reply to fallback Channel::GetChannelType()";
+    tpDebug(logChannels) << "Got reply to fallback Channel::GetChannelType()";
     mPriv->channelType = reply.value();
     mPriv->continueIntrospection();
 }
@@ -2948,14 +2977,14 @@ void Channel::gotHandle(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<uint, uint> reply = *watcher;
 
     if (reply.isError()) {
-        warning().nospace() << "Channel::GetHandle() failed with " <<
+        tpWarning(logChannels).nospace() << "Channel::GetHandle() failed with " <<
             reply.error().name() << ": " << reply.error().message() <<
             ", Channel officially dead";
         invalidate(reply.error());
         return;
     }
 
-    debug() << "Got reply to fallback Channel::GetHandle()";
+    tpDebug(logChannels) << "Got reply to fallback Channel::GetHandle()";
     mPriv->targetHandleType = reply.argumentAt<0>();
     mPriv->targetHandle = reply.argumentAt<1>();
     mPriv->continueIntrospection();
@@ -2966,14 +2995,14 @@ void Channel::gotInterfaces(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<QStringList> reply = *watcher;
 
     if (reply.isError()) {
-        warning().nospace() << "Channel::GetInterfaces() failed with " <<
+        tpWarning(logChannels).nospace() << "Channel::GetInterfaces() failed with " <<
             reply.error().name() << ": " << reply.error().message() <<
             ", Channel officially dead";
         invalidate(reply.error());
         return;
     }
 
-    debug() << "Got reply to fallback Channel::GetInterfaces()";
+    tpDebug(logChannels) << "Got reply to fallback Channel::GetInterfaces()";
     setInterfaces(reply.value());
     mPriv->readinessHelper->setInterfaces(interfaces());
     mPriv->nowHaveInterfaces();
@@ -2985,7 +3014,7 @@ void Channel::gotInterfaces(QDBusPendingCallWatcher *watcher)
 
 void Channel::onClosed()
 {
-    debug() << "Got Channel::Closed";
+    tpDebug(logChannels) << "Got Channel::Closed";
 
     QString error;
     QString message;
@@ -3029,7 +3058,7 @@ void Channel::onConnectionReady(PendingOperation *op)
 
 void Channel::onConnectionInvalidated()
 {
-    debug() << "Owning connection died leaving an orphan Channel, "
+    tpDebug(logChannels) << "Owning connection died leaving an orphan Channel, "
         "changing to closed";
     invalidate(TP_QT_ERROR_ORPHANED,
                QLatin1String("Connection given as the owner of this channel was invalidated"));
@@ -3041,11 +3070,11 @@ void Channel::gotGroupProperties(QDBusPendingCallWatcher *watcher)
     QVariantMap props;
 
     if (!reply.isError()) {
-        debug() << "Got reply to Properties::GetAll(Channel.Interface.Group)";
+        tpDebug(logChannels) << "Got reply to Properties::GetAll(Channel.Interface.Group)";
         props = reply.value();
     }
     else {
-        warning().nospace() << "Properties::GetAll(Channel.Interface.Group) "
+        tpWarning(logChannels).nospace() << "Properties::GetAll(Channel.Interface.Group) "
             "failed with " << reply.error().name() << ": " <<
             reply.error().message();
     }
@@ -3061,15 +3090,16 @@ void Channel::gotGroupFlags(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<uint> reply = *watcher;
 
     if (reply.isError()) {
-        warning().nospace() << "Channel.Interface.Group::GetGroupFlags() failed with " <<
+        tpWarning(logChannels).nospace() <<
+            "Channel.Interface.Group::GetGroupFlags() failed with " <<
             reply.error().name() << ": " << reply.error().message();
     }
     else {
-        debug() << "Got reply to fallback Channel.Interface.Group::GetGroupFlags()";
+        tpDebug(logChannels) << "Got reply to fallback Channel.Interface.Group::GetGroupFlags()";
         mPriv->setGroupFlags(reply.value());
 
         if (mPriv->groupFlags & ChannelGroupFlagProperties) {
-            warning() << " Reply included ChannelGroupFlagProperties, even "
+            tpWarning(logChannels) << " Reply included ChannelGroupFlagProperties, even "
                 "though properties specified in 0.17.7 didn't work! - unsetting";
             mPriv->groupFlags &= ~ChannelGroupFlagProperties;
         }
@@ -3083,10 +3113,11 @@ void Channel::gotAllMembers(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<UIntList, UIntList, UIntList> reply = *watcher;
 
     if (reply.isError()) {
-        warning().nospace() << "Channel.Interface.Group::GetAllMembers() failed with " <<
+        tpWarning(logChannels).nospace() <<
+            "Channel.Interface.Group::GetAllMembers() failed with " <<
             reply.error().name() << ": " << reply.error().message();
     } else {
-        debug() << "Got reply to fallback Channel.Interface.Group::GetAllMembers()";
+        tpDebug(logChannels) << "Got reply to fallback Channel.Interface.Group::GetAllMembers()";
 
         mPriv->groupInitialMembers = reply.argumentAt<0>();
         mPriv->groupInitialRP = reply.argumentAt<2>();
@@ -3106,12 +3137,14 @@ void Channel::gotLocalPendingMembersWithInfo(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<LocalPendingInfoList> reply = *watcher;
 
     if (reply.isError()) {
-        warning().nospace() << "Channel.Interface.Group::GetLocalPendingMembersWithInfo() "
+        tpWarning(logChannels).nospace() <<
+            "Channel.Interface.Group::GetLocalPendingMembersWithInfo() "
             "failed with " << reply.error().name() << ": " << reply.error().message();
-        warning() << " Falling back to what GetAllMembers returned with no extended info";
+        tpWarning(logChannels) <<
+            " Falling back to what GetAllMembers returned with no extended info";
     }
     else {
-        debug() << "Got reply to fallback "
+        tpDebug(logChannels) << "Got reply to fallback "
             "Channel.Interface.Group::GetLocalPendingMembersWithInfo()";
         // Overrides the previous vague list provided by gotAllMembers
         mPriv->groupInitialLP = reply.value();
@@ -3125,10 +3158,11 @@ void Channel::gotSelfHandle(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<uint> reply = *watcher;
 
     if (reply.isError()) {
-        warning().nospace() << "Channel.Interface.Group::GetSelfHandle() failed with " <<
+        tpWarning(logChannels).nospace() <<
+            "Channel.Interface.Group::GetSelfHandle() failed with " <<
             reply.error().name() << ": " << reply.error().message();
     } else {
-        debug() << "Got reply to fallback Channel.Interface.Group::GetSelfHandle()";
+        tpDebug(logChannels) << "Got reply to fallback Channel.Interface.Group::GetSelfHandle()";
         // Don't overwrite the self handle we got from the connection with 0
         if (reply.value()) {
             mPriv->groupSelfHandle = reply.value();
@@ -3151,18 +3185,18 @@ void Channel::gotContacts(PendingOperation *op)
         contacts = pending->contacts();
 
         if (!pending->invalidHandles().isEmpty()) {
-            warning() << "Unable to construct Contact objects for handles:" <<
+            tpWarning(logChannels) << "Unable to construct Contact objects for handles:" <<
                 pending->invalidHandles();
 
             if (mPriv->groupSelfHandle &&
                 pending->invalidHandles().contains(mPriv->groupSelfHandle)) {
-                warning() << "Unable to retrieve self contact";
+                tpWarning(logChannels) << "Unable to retrieve self contact";
                 mPriv->groupSelfContact.reset();
                 emit groupSelfContactChanged();
             }
         }
     } else {
-        warning().nospace() << "Getting contacts failed with " <<
+        tpWarning(logChannels).nospace() << "Getting contacts failed with " <<
             pending->errorName() << ":" << pending->errorMessage();
     }
 
@@ -3171,13 +3205,13 @@ void Channel::gotContacts(PendingOperation *op)
 
 void Channel::onGroupFlagsChanged(uint added, uint removed)
 {
-    debug().nospace() << "Got Channel.Interface.Group::GroupFlagsChanged(" <<
+    tpDebug(logChannels).nospace() << "Got Channel.Interface.Group::GroupFlagsChanged(" <<
         hex << added << ", " << removed << ")";
 
     added &= ~(mPriv->groupFlags);
     removed &= mPriv->groupFlags;
 
-    debug().nospace() << "Arguments after filtering (" << hex << added <<
+    tpDebug(logChannels).nospace() << "Arguments after filtering (" << hex << added <<
         ", " << removed << ")";
 
     uint groupFlags = mPriv->groupFlags;
@@ -3186,26 +3220,26 @@ void Channel::onGroupFlagsChanged(uint added, uint removed)
     // just emit groupFlagsChanged and related signals if the flags really
     // changed and we are ready
     if (mPriv->setGroupFlags(groupFlags) && isReady(Channel::FeatureCore)) {
-        debug() << "Emitting groupFlagsChanged with" << mPriv->groupFlags <<
+        tpDebug(logChannels) << "Emitting groupFlagsChanged with" << mPriv->groupFlags <<
             "value" << added << "added" << removed << "removed";
         emit groupFlagsChanged((ChannelGroupFlags) mPriv->groupFlags,
                 (ChannelGroupFlags) added, (ChannelGroupFlags) removed);
 
         if (added & ChannelGroupFlagCanAdd ||
             removed & ChannelGroupFlagCanAdd) {
-            debug() << "Emitting groupCanAddContactsChanged";
+            tpDebug(logChannels) << "Emitting groupCanAddContactsChanged";
             emit groupCanAddContactsChanged(groupCanAddContacts());
         }
 
         if (added & ChannelGroupFlagCanRemove ||
             removed & ChannelGroupFlagCanRemove) {
-            debug() << "Emitting groupCanRemoveContactsChanged";
+            tpDebug(logChannels) << "Emitting groupCanRemoveContactsChanged";
             emit groupCanRemoveContactsChanged(groupCanRemoveContacts());
         }
 
         if (added & ChannelGroupFlagCanRescind ||
             removed & ChannelGroupFlagCanRescind) {
-            debug() << "Emitting groupCanRescindContactsChanged";
+            tpDebug(logChannels) << "Emitting groupCanRescindContactsChanged";
             emit groupCanRescindContactsChanged(groupCanRescindContacts());
         }
     }
@@ -3221,11 +3255,11 @@ void Channel::onMembersChanged(const QString &message,
         return;
     }
 
-    debug() << "Got Channel.Interface.Group::MembersChanged with" << added.size() <<
+    tpDebug(logChannels) << "Got Channel.Interface.Group::MembersChanged with" << added.size() <<
         "added," << removed.size() << "removed," << localPending.size() <<
         "moved to LP," << remotePending.size() << "moved to RP," << actor <<
         "being the actor," << reason << "the reason and" << message << "the message";
-    debug() << " synthesizing a corresponding MembersChangedDetailed signal";
+    tpDebug(logChannels) << " synthesizing a corresponding MembersChangedDetailed signal";
 
     QVariantMap details;
 
@@ -3252,7 +3286,8 @@ void Channel::onMembersChangedDetailed(
         return;
     }
 
-    debug() << "Got Channel.Interface.Group::MembersChangedDetailed with" << added.size() <<
+    tpDebug(logChannels) << "Got Channel.Interface.Group::MembersChangedDetailed with" <<
+        added.size() <<
         "added," << removed.size() << "removed," << localPending.size() <<
         "moved to LP," << remotePending.size() << "moved to RP and with" << details.size() <<
         "details";
@@ -3266,14 +3301,14 @@ void Channel::Private::doMembersChangedDetailed(
         const QVariantMap &details)
 {
     if (!groupHaveMembers) {
-        debug() << "Still waiting for initial group members, "
+        tpDebug(logChannels) << "Still waiting for initial group members, "
             "so ignoring delta signal...";
         return;
     }
 
     if (added.isEmpty() && removed.isEmpty() &&
         localPending.isEmpty() && remotePending.isEmpty()) {
-        debug() << "Nothing really changed, so skipping membersChanged";
+        tpDebug(logChannels) << "Nothing really changed, so skipping membersChanged";
         return;
     }
 
@@ -3286,7 +3321,7 @@ void Channel::Private::doMembersChangedDetailed(
             if (removed.size() != 1 ||
                 (added.size() + localPending.size() + remotePending.size()) != 1) {
                 // spec-incompliant CM, ignoring members changed
-                warning() << "Received MembersChangedDetailed with reason "
+                tpWarning(logChannels) << "Received MembersChangedDetailed with reason "
                     "Renamed and removed.size != 1 or added.size + "
                     "localPending.size + remotePending.size != 1. Ignoring";
                 return;
@@ -3330,11 +3365,11 @@ void Channel::Private::doMembersChangedDetailed(
 void Channel::onHandleOwnersChanged(const HandleOwnerMap &added,
         const UIntList &removed)
 {
-    debug() << "Got Channel.Interface.Group::HandleOwnersChanged with" <<
+    tpDebug(logChannels) << "Got Channel.Interface.Group::HandleOwnersChanged with" <<
         added.size() << "added," << removed.size() << "removed";
 
     if (!mPriv->groupAreHandleOwnersAvailable) {
-        debug() << "Still waiting for initial handle owners, so ignoring "
+        tpDebug(logChannels) << "Still waiting for initial handle owners, so ignoring "
             "delta signal...";
         return;
     }
@@ -3350,7 +3385,7 @@ void Channel::onHandleOwnersChanged(const HandleOwnerMap &added,
 
         if (!mPriv->groupHandleOwners.contains(handle)
                 || mPriv->groupHandleOwners[handle] != global) {
-            debug() << " +++/changed" << handle << "->" << global;
+            tpDebug(logChannels) << " +++/changed" << handle << "->" << global;
             mPriv->groupHandleOwners[handle] = global;
             emitAdded.append(handle);
         }
@@ -3358,7 +3393,7 @@ void Channel::onHandleOwnersChanged(const HandleOwnerMap &added,
 
     foreach (uint handle, removed) {
         if (mPriv->groupHandleOwners.contains(handle)) {
-            debug() << " ---" << handle;
+            tpDebug(logChannels) << " ---" << handle;
             mPriv->groupHandleOwners.remove(handle);
             emitRemoved.append(handle);
         }
@@ -3367,7 +3402,7 @@ void Channel::onHandleOwnersChanged(const HandleOwnerMap &added,
     // just emit groupHandleOwnersChanged if it really changed and
     // we are ready
     if ((emitAdded.size() || emitRemoved.size()) && isReady(Channel::FeatureCore)) {
-        debug() << "Emitting groupHandleOwnersChanged with" << emitAdded.size() <<
+        tpDebug(logChannels) << "Emitting groupHandleOwnersChanged with" << emitAdded.size() <<
             "added" << emitRemoved.size() << "removed";
         emit groupHandleOwnersChanged(mPriv->groupHandleOwners,
                 emitAdded, emitRemoved);
@@ -3376,11 +3411,11 @@ void Channel::onHandleOwnersChanged(const HandleOwnerMap &added,
 
 void Channel::onSelfHandleChanged(uint selfHandle)
 {
-    debug().nospace() << "Got Channel.Interface.Group::SelfHandleChanged";
+    tpDebug(logChannels).nospace() << "Got Channel.Interface.Group::SelfHandleChanged";
 
     if (selfHandle != mPriv->groupSelfHandle) {
         mPriv->groupSelfHandle = selfHandle;
-        debug() << " Emitting groupSelfHandleChanged with new self handle" <<
+        tpDebug(logChannels) << " Emitting groupSelfHandleChanged with new self handle" <<
             selfHandle;
 
         // FIXME: fix self contact building with no group
@@ -3396,7 +3431,7 @@ void Channel::gotConferenceProperties(QDBusPendingCallWatcher *watcher)
     mPriv->introspectingConference = false;
 
     if (!reply.isError()) {
-        debug() << "Got reply to Properties::GetAll(Channel.Interface.Conference)";
+        tpDebug(logChannels) << "Got reply to Properties::GetAll(Channel.Interface.Conference)";
         props = reply.value();
 
         ConnectionPtr conn = connection();
@@ -3460,7 +3495,7 @@ void Channel::gotConferenceProperties(QDBusPendingCallWatcher *watcher)
             mPriv->conferenceOriginalChannels.insert(i.key(), channel);
         }
     } else {
-        warning().nospace() << "Properties::GetAll(Channel.Interface.Conference) "
+        tpWarning(logChannels).nospace() << "Properties::GetAll(Channel.Interface.Conference) "
             "failed with " << reply.error().name() << ": " <<
             reply.error().message();
     }
@@ -3475,7 +3510,7 @@ void Channel::gotConferenceInitialInviteeContacts(PendingOperation *op)
     if (pending->isValid()) {
         mPriv->conferenceInitialInviteeContacts = pending->contacts().toSet();
     } else {
-        warning().nospace() << "Getting conference initial invitee contacts "
+        tpWarning(logChannels).nospace() << "Getting conference initial invitee contacts "
             "failed with " << pending->errorName() << ":" <<
             pending->errorMessage();
     }
@@ -3543,7 +3578,7 @@ void Channel::gotConferenceChannelRemovedActorContact(PendingOperation *op)
             Q_ASSERT(pc->contacts().size() == 1);
             actorContact = pc->contacts().first();
         } else {
-            warning().nospace() << "Getting conference channel removed actor "
+            tpWarning(logChannels).nospace() << "Getting conference channel removed actor "
                 "failed with " << pc->errorName() << ":" <<
                 pc->errorMessage();
         }
@@ -3579,11 +3614,11 @@ void Channel::gotRoomConfigProperties(QDBusPendingCallWatcher *watcher)
     mPriv->introspectingRoomConfig = false;
 
     if (!reply.isError()) {
-        debug() << "Got reply to Properties::GetAll(Channel.Interface.RoomConfig)";
+        tpDebug(logChannels) << "Got reply to Properties::GetAll(Channel.Interface.RoomConfig)";
         props = reply.value();
         mPriv->targetRoom->receiveRoomConfig(props);
     } else {
-        warning().nospace() << "Properties::GetAll(Channel.Interface.RoomConfig) "
+        tpWarning(logChannels).nospace() << "Properties::GetAll(Channel.Interface.RoomConfig) "
             "failed with " << reply.error().name() << ": " <<
             reply.error().message();
     }
@@ -118,7 +118,7 @@ void ClientObserverAdaptor::ObserveChannels(const QDBusObjectPath &accountPath,
         const QVariantMap &observerInfo,
         const QDBusMessage &message)
 {
-    debug() << "ObserveChannels: account:" << accountPath.path() <<
+    tpDebug(logClients) << "ObserveChannels: account:" << accountPath.path() <<
         ", connection:" << connectionPath.path();
 
     AccountFactoryConstPtr accFactory = mRegistrar->accountFactory();
@@ -214,7 +214,8 @@ void ClientObserverAdaptor::ObserveChannels(const QDBusObjectPath &accountPath,
 
     mInvocations.append(invocation);
 
-    debug() << "Preparing proxies for ObserveChannels of" << channelDetailsList.size() << "channels"
+    tpDebug(logClients) <<
+        "Preparing proxies for ObserveChannels of" << channelDetailsList.size() << "channels"
         << "for client" << mClient;
 }
 
@@ -232,7 +233,8 @@ void ClientObserverAdaptor::onReadyOpFinished(Tp::PendingOperation *op)
         (*i)->readyOp = 0;
 
         if (op->isError()) {
-            warning() << "Preparing proxies for ObserveChannels failed with" << op->errorName()
+            tpWarning(logClients) <<
+                "Preparing proxies for ObserveChannels failed with" << op->errorName()
                 << op->errorMessage();
             (*i)->error = op->errorName();
             (*i)->message = op->errorMessage();
@@ -251,7 +253,8 @@ void ClientObserverAdaptor::onReadyOpFinished(Tp::PendingOperation *op)
             continue;
         }
 
-        debug() << "Invoking application observeChannels with" << invocation->chans.size()
+        tpDebug(logClients) <<
+            "Invoking application observeChannels with" << invocation->chans.size()
             << "channels on" << mClient;
 
         mClient->observeChannels(invocation->ctx, invocation->acc, invocation->conn,
@@ -289,7 +292,7 @@ void ClientApproverAdaptor::AddDispatchOperation(const Tp::ChannelDetailsList &c
     QDBusObjectPath connectionPath = qdbus_cast<QDBusObjectPath>(
             properties.value(
                 TP_QT_IFACE_CHANNEL_DISPATCH_OPERATION + QLatin1String(".Connection")));
-    debug() << "addDispatchOperation: connection:" << connectionPath.path();
+    tpDebug(logClients) << "addDispatchOperation: connection:" << connectionPath.path();
     QString connectionBusName = connectionPath.path().mid(1).replace(
             QLatin1String("/"), QLatin1String("."));
     PendingReady *connReady = connFactory->proxy(connectionBusName, connectionPath.path(), chanFactory,
@@ -335,7 +338,8 @@ void ClientApproverAdaptor::onReadyOpFinished(Tp::PendingOperation *op)
         (*i)->readyOp = 0;
 
         if (op->isError()) {
-            warning() << "Preparing proxies for AddDispatchOperation failed with" << op->errorName()
+            tpWarning(logClients) <<
+                "Preparing proxies for AddDispatchOperation failed with" << op->errorName()
                 << op->errorMessage();
             (*i)->error = op->errorName();
             (*i)->message = op->errorMessage();
@@ -354,7 +358,7 @@ void ClientApproverAdaptor::onReadyOpFinished(Tp::PendingOperation *op)
             continue;
         }
 
-        debug() << "Invoking application addDispatchOperation with CDO"
+        tpDebug(logClients) << "Invoking application addDispatchOperation with CDO"
             << invocation->dispatchOp->objectPath() << "on" << mClient;
 
         mClient->addDispatchOperation(invocation->ctx, invocation->dispatchOp);
@@ -395,7 +399,7 @@ void ClientHandlerAdaptor::HandleChannels(const QDBusObjectPath &accountPath,
         const QVariantMap &handlerInfo,
         const QDBusMessage &message)
 {
-    debug() << "HandleChannels: account:" << accountPath.path() <<
+    tpDebug(logClients) << "HandleChannels: account:" << accountPath.path() <<
         ", connection:" << connectionPath.path();
 
     AccountFactoryConstPtr accFactory = mRegistrar->accountFactory();
@@ -408,7 +412,7 @@ void ClientHandlerAdaptor::HandleChannels(const QDBusObjectPath &accountPath,
 
     RequestTemporaryHandler *tempHandler = dynamic_cast<RequestTemporaryHandler *>(mClient);
     if (tempHandler) {
-        debug() << "  This is a temporary handler for the Request & Handle API,"
+        tpDebug(logClients) << "  This is a temporary handler for the Request & Handle API,"
             << "giving an early signal of the invocation";
         tempHandler->setDBusHandlerInvoked();
     }
@@ -471,7 +475,8 @@ void ClientHandlerAdaptor::HandleChannels(const QDBusObjectPath &accountPath,
 
     mInvocations.append(invocation);
 
-    debug() << "Preparing proxies for HandleChannels of" << channelDetailsList.size() << "channels"
+    tpDebug(logClients) <<
+        "Preparing proxies for HandleChannels of" << channelDetailsList.size() << "channels"
         << "for client" << mClient;
 }
 
@@ -489,7 +494,8 @@ void ClientHandlerAdaptor::onReadyOpFinished(Tp::PendingOperation *op)
         (*i)->readyOp = 0;
 
         if (op->isError()) {
-            warning() << "Preparing proxies for HandleChannels failed with" << op->errorName()
+            tpWarning(logClients) <<
+                "Preparing proxies for HandleChannels failed with" << op->errorName()
                 << op->errorMessage();
             (*i)->error = op->errorName();
             (*i)->message = op->errorMessage();
@@ -504,7 +510,8 @@ void ClientHandlerAdaptor::onReadyOpFinished(Tp::PendingOperation *op)
         if (!invocation->error.isEmpty()) {
             RequestTemporaryHandler *tempHandler = dynamic_cast<RequestTemporaryHandler *>(mClient);
             if (tempHandler) {
-                debug() << "  This is a temporary handler for the Request & Handle API, indicating failure";
+                tpDebug(logClients) <<
+                    "  This is a temporary handler for the Request & Handle API, indicating failure";
                 tempHandler->setDBusHandlerErrored(invocation->error, invocation->message);
             }
 
@@ -514,7 +521,8 @@ void ClientHandlerAdaptor::onReadyOpFinished(Tp::PendingOperation *op)
             continue;
         }
 
-        debug() << "Invoking application handleChannels with" << invocation->chans.size()
+        tpDebug(logClients) <<
+            "Invoking application handleChannels with" << invocation->chans.size()
             << "channels on" << mClient;
 
         mClient->handleChannels(invocation->ctx, invocation->acc, invocation->conn,
@@ -527,7 +535,7 @@ void ClientHandlerAdaptor::onContextFinished(
         const QList<ChannelPtr> &channels, ClientHandlerAdaptor *self)
 {
     if (!context->isError()) {
-        debug() << "HandleChannels context finished successfully, "
+        tpDebug(logClients) << "HandleChannels context finished successfully, "
             "updating handled channels";
 
         // register the channels in FakeHandlerManager so we report HandledChannels correctly
@@ -555,7 +563,7 @@ void ClientHandlerRequestsAdaptor::AddRequest(
         const QVariantMap &requestProperties,
         const QDBusMessage &message)
 {
-    debug() << "AddRequest:" << request.path();
+    tpDebug(logClients) << "AddRequest:" << request.path();
     message.setDelayedReply(true);
     mBus.send(message.createReply());
     mClient->addRequest(ChannelRequest::create(mBus,
@@ -571,7 +579,7 @@ void ClientHandlerRequestsAdaptor::RemoveRequest(
         const QString &errorName, const QString &errorMessage,
         const QDBusMessage &message)
 {
-    debug() << "RemoveRequest:" << request.path() << "-" << errorName
+    tpDebug(logClients) << "RemoveRequest:" << request.path() << "-" << errorName
         << "-" << errorMessage;
     message.setDelayedReply(true);
     mBus.send(message.createReply());
@@ -592,15 +600,18 @@ struct TP_QT_NO_EXPORT ClientRegistrar::Private
         contactFactory(contactFactory)
     {
         if (accFactory->dbusConnection().name() != bus.name()) {
-            warning() << "  The D-Bus connection in the account factory is not the proxy connection";
+            tpWarning(logClients) <<
+                "  The D-Bus connection in the account factory is not the proxy connection";
         }
 
         if (connFactory->dbusConnection().name() != bus.name()) {
-            warning() << "  The D-Bus connection in the connection factory is not the proxy connection";
+            tpWarning(logClients) <<
+                "  The D-Bus connection in the connection factory is not the proxy connection";
         }
 
         if (chanFactory->dbusConnection().name() != bus.name()) {
-            warning() << "  The D-Bus connection in the channel factory is not the proxy connection";
+            tpWarning(logClients) <<
+                "  The D-Bus connection in the channel factory is not the proxy connection";
         }
     }
 
@@ -882,12 +893,12 @@ bool ClientRegistrar::registerClient(const AbstractClientPtr &client,
         const QString &clientName, bool unique)
 {
     if (!client) {
-        warning() << "Unable to register a null client";
+        tpWarning(logClients) << "Unable to register a null client";
         return false;
     }
 
     if (mPriv->clients.contains(client)) {
-        debug() << "Client already registered";
+        tpDebug(logClients) << "Client already registered";
         return true;
     }
 
@@ -904,7 +915,7 @@ bool ClientRegistrar::registerClient(const AbstractClientPtr &client,
     }
 
     if (mPriv->services.contains(busName)) {
-        warning() << "Unable to register client: busName" <<
+        tpWarning(logClients) << "Unable to register client: busName" <<
             busName << "already registered";
         return false;
     }
@@ -947,7 +958,7 @@ bool ClientRegistrar::registerClient(const AbstractClientPtr &client,
     }
 
     if (interfaces.isEmpty()) {
-        warning() << "Client does not implement any known interface";
+        tpWarning(logClients) << "Client does not implement any known interface";
         // cleanup
         return false;
     }
@@ -959,7 +970,7 @@ bool ClientRegistrar::registerClient(const AbstractClientPtr &client,
     objectPath.replace(QLatin1String("."), QLatin1String("/"));
     if (!mPriv->bus.registerObject(objectPath, object)) {
         // this shouldn't happen, but let's make sure
-        warning() << "Unable to register client: objectPath" <<
+        tpWarning(logClients) << "Unable to register client: objectPath" <<
             objectPath << "already registered";
         // cleanup
         delete object;
@@ -967,7 +978,7 @@ bool ClientRegistrar::registerClient(const AbstractClientPtr &client,
     }
 
     if (!mPriv->bus.registerService(busName)) {
-        warning() << "Unable to register service: busName" <<
+        tpWarning(logClients) << "Unable to register service: busName" <<
             busName << "already registered";
         mPriv->bus.unregisterObject(objectPath, QDBusConnection::UnregisterTree);
         delete object;
@@ -979,7 +990,7 @@ bool ClientRegistrar::registerClient(const AbstractClientPtr &client,
         handler->setRegistered(true);
     }
 
-    debug() << "Client registered - busName:" << busName <<
+    tpDebug(logClients) << "Client registered - busName:" << busName <<
         "objectPath:" << objectPath << "interfaces:" << interfaces;
 
     mPriv->services.insert(busName);
@@ -1002,7 +1013,7 @@ bool ClientRegistrar::registerClient(const AbstractClientPtr &client,
 bool ClientRegistrar::unregisterClient(const AbstractClientPtr &client)
 {
     if (!mPriv->clients.contains(client)) {
-        warning() << "Trying to unregister an unregistered client";
+        tpWarning(logClients) << "Trying to unregister an unregistered client";
         return false;
     }
 
@@ -1026,7 +1037,7 @@ bool ClientRegistrar::unregisterClient(const AbstractClientPtr &client)
     mPriv->bus.unregisterService(busName);
     mPriv->services.remove(busName);
 
-    debug() << "Client unregistered - busName:" << busName <<
+    tpDebug(logClients) << "Client unregistered - busName:" << busName <<
         "objectPath:" << objectPath;
 
     return true;
@@ -0,0 +1,150 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2026 agent <agent@local>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "TelepathyQt/completion-queue-internal.h"
+
+#include <TelepathyQt/PendingOperation>
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QThreadStorage>
+
+namespace Tp
+{
+
+namespace
+{
+
+QThreadStorage<CompletionQueue *> queues;
+
+}
+
+int CompletionQueue::eventType = QEvent::registerEventType();
+
+CompletionQueue *CompletionQueue::forCurrentThread()
+{
+    if (!queues.hasLocalData()) {
+        queues.setLocalData(new CompletionQueue);
+    }
+    return queues.localData();
+}
+
+void CompletionQueue::cancelQueued(QObject *object, qint64 position)
+{
+    if (queues.hasLocalData()) {
+        queues.localData()->cancel(object, position);
+    }
+}
+
+CompletionQueue::CompletionQueue()
+    : mBase(0),
+      mHead(0),
+      mDepth(0),
+      mPosted(false)
+{
+}
+
+CompletionQueue::~CompletionQueue()
+{
+}
+
+qint64 CompletionQueue::enqueue(PendingOperation *operation)
+{
+    return append(operation, 0);
+}
+
+qint64 CompletionQueue::enqueue(QObject *object, const char *member)
+{
+    return append(object, member);
+}
+
+qint64 CompletionQueue::append(QObject *object, const char *member)
+{
+    Entry entry = { object, member };
+    mEntries.append(entry);
+
+    if (!mPosted) {
+        mPosted = true;
+        QCoreApplication::postEvent(this, new QEvent(static_cast<QEvent::Type>(eventType)));
+    }
+
+    return mBase + mEntries.size() - 1;
+}
+
+void CompletionQueue::cancel(QObject *object, qint64 position)
+{
+    // Entries which were already dispatched, or dropped with the dispatched part of the queue,
+    // have nothing left to cancel
+    qint64 index = position - mBase;
+    if (index < mHead || index >= mEntries.size()) {
+        return;
+    }
+
+    Entry &entry = mEntries[(int) index];
+    Q_ASSERT(entry.object == object || !entry.object);
+    if (entry.object == object) {
+        entry.object = 0;
+    }
+}
+
+bool CompletionQueue::event(QEvent *event)
+{
+    if (event->type() != eventType) {
+        return QObject::event(event);
+    }
+
+    mPosted = false;
+
+    // Only dispatch what was queued before this event; entries queued from the calls below
+    // have posted the next event. The head is shared so that a nested mainloop started from one
+    // of the calls carries on where we are instead of dispatching the same entries again.
+    int end = mEntries.size();
+    ++mDepth;
+    while (mHead < end) {
+        Entry entry = mEntries[mHead++];
+        if (!entry.object) {
+            continue;
+        }
+
+        if (entry.member) {
+            QMetaObject::invokeMethod(entry.object, entry.member);
+        } else {
+            static_cast<PendingOperation *>(entry.object)->emitFinished();
+        }
+    }
+    --mDepth;
+
+    if (mDepth == 0) {
+        if (mHead == mEntries.size()) {
+            mBase += mEntries.size();
+            mEntries.resize(0);
+            mHead = 0;
+        } else if (mHead > 1024 && mHead * 2 > mEntries.size()) {
+            mBase += mHead;
+            mEntries.remove(0, mHead);
+            mHead = 0;
+        }
+    }
+
+    return true;
+}
+
+} // Tp
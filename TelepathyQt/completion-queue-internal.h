@@ -0,0 +1,90 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2026 agent <agent@local>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _TelepathyQt_completion_queue_internal_h_HEADER_GUARD_
+#define _TelepathyQt_completion_queue_internal_h_HEADER_GUARD_
+
+#include <TelepathyQt/Global>
+
+#include <QObject>
+#include <QVector>
+
+class QEvent;
+
+namespace Tp
+{
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+class PendingOperation;
+
+// Per-thread queue delivering the finished() signal of pending operations, and other deferred
+// calls which must stay ordered with them, from a single posted event per mainloop iteration
+// instead of a zero timer per operation. Everything queued before the event is processed is
+// dispatched in FIFO order; anything queued while dispatching waits for the next event, so
+// queued calls never run synchronously from the code queueing them.
+//
+// enqueue() returns the position of the entry, which is what cancelQueued() needs to drop it
+// without searching the queue when the object goes away before it is dispatched.
+class TP_QT_NO_EXPORT CompletionQueue : public QObject
+{
+    Q_DISABLE_COPY(CompletionQueue)
+
+public:
+    static CompletionQueue *forCurrentThread();
+    static void cancelQueued(QObject *object, qint64 position);
+
+    ~CompletionQueue();
+
+    qint64 enqueue(PendingOperation *operation);
+    qint64 enqueue(QObject *object, const char *member);
+
+protected:
+    bool event(QEvent *event);
+
+private:
+    struct Entry
+    {
+        QObject *object;
+        // 0 for pending operations, whose finished() signal is emitted
+        const char *member;
+    };
+
+    CompletionQueue();
+
+    qint64 append(QObject *object, const char *member);
+    void cancel(QObject *object, qint64 position);
+
+    static int eventType;
+
+    QVector<Entry> mEntries;
+    // Position of mEntries[0], which only grows as dispatched entries are dropped
+    qint64 mBase;
+    int mHead;
+    int mDepth;
+    bool mPosted;
+};
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+} // Tp
+
+#endif
@@ -22,6 +22,8 @@
 
 #include <TelepathyQt/ConnectionCapabilities>
 
+#include "TelepathyQt/capabilities-base-internal.h"
+
 #include <TelepathyQt/Constants>
 #include <TelepathyQt/Types>
 
@@ -86,13 +88,7 @@ ConnectionCapabilities::~ConnectionCapabilities()
  */
 bool ConnectionCapabilities::textChatrooms() const
 {
-    RequestableChannelClassSpecList rccSpecs = allClassSpecs();
-    foreach (const RequestableChannelClassSpec &rccSpec, rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::textChatroom())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::TextChatrooms);
 }
 
 /**
@@ -102,13 +98,7 @@ bool ConnectionCapabilities::textChatrooms() const
  */
 bool ConnectionCapabilities::conferenceStreamedMediaCalls() const
 {
-    RequestableChannelClassSpecList rccSpecs = allClassSpecs();
-    foreach (const RequestableChannelClassSpec &rccSpec, rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::conferenceStreamedMediaCall())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::ConferenceStreamedMediaCalls);
 }
 
 /**
@@ -125,13 +115,7 @@ bool ConnectionCapabilities::conferenceStreamedMediaCalls() const
  */
 bool ConnectionCapabilities::conferenceStreamedMediaCallsWithInvitees() const
 {
-    RequestableChannelClassSpecList rccSpecs = allClassSpecs();
-    foreach (const RequestableChannelClassSpec &rccSpec, rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::conferenceStreamedMediaCallWithInvitees())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::ConferenceStreamedMediaCallsWithInvitees);
 }
 
 /**
@@ -141,13 +125,7 @@ bool ConnectionCapabilities::conferenceStreamedMediaCallsWithInvitees() const
  */
 bool ConnectionCapabilities::conferenceTextChats() const
 {
-    RequestableChannelClassSpecList rccSpecs = allClassSpecs();
-    foreach (const RequestableChannelClassSpec &rccSpec, rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::conferenceTextChat())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::ConferenceTextChats);
 }
 
 /**
@@ -164,13 +142,7 @@ bool ConnectionCapabilities::conferenceTextChats() const
  */
 bool ConnectionCapabilities::conferenceTextChatsWithInvitees() const
 {
-    RequestableChannelClassSpecList rccSpecs = allClassSpecs();
-    foreach (const RequestableChannelClassSpec &rccSpec, rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::conferenceTextChatWithInvitees())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::ConferenceTextChatsWithInvitees);
 }
 
 /**
@@ -180,13 +152,7 @@ bool ConnectionCapabilities::conferenceTextChatsWithInvitees() const
  */
 bool ConnectionCapabilities::conferenceTextChatrooms() const
 {
-    RequestableChannelClassSpecList rccSpecs = allClassSpecs();
-    foreach (const RequestableChannelClassSpec &rccSpec, rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::conferenceTextChatroom())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::ConferenceTextChatrooms);
 }
 
 /**
@@ -203,13 +169,7 @@ bool ConnectionCapabilities::conferenceTextChatrooms() const
  */
 bool ConnectionCapabilities::conferenceTextChatroomsWithInvitees() const
 {
-    RequestableChannelClassSpecList rccSpecs = allClassSpecs();
-    foreach (const RequestableChannelClassSpec &rccSpec, rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::conferenceTextChatroomWithInvitees())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::ConferenceTextChatroomsWithInvitees);
 }
 
 /**
@@ -219,13 +179,7 @@ bool ConnectionCapabilities::conferenceTextChatroomsWithInvitees() const
  */
 bool ConnectionCapabilities::contactSearches() const
 {
-    RequestableChannelClassSpecList rccSpecs = allClassSpecs();
-    foreach (const RequestableChannelClassSpec &rccSpec, rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::contactSearch())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::ContactSearches);
 }
 
 /**
@@ -235,13 +189,7 @@ bool ConnectionCapabilities::contactSearches() const
  */
 bool ConnectionCapabilities::contactSearchesWithSpecificServer() const
 {
-    RequestableChannelClassSpecList rccSpecs = allClassSpecs();
-    foreach (const RequestableChannelClassSpec &rccSpec, rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::contactSearchWithSpecificServer())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::ContactSearchesWithSpecificServer);
 }
 
 /**
@@ -251,13 +199,7 @@ bool ConnectionCapabilities::contactSearchesWithSpecificServer() const
  */
 bool ConnectionCapabilities::contactSearchesWithLimit() const
 {
-    RequestableChannelClassSpecList rccSpecs = allClassSpecs();
-    foreach (const RequestableChannelClassSpec &rccSpec, rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::contactSearchWithLimit())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::ContactSearchesWithLimit);
 }
 
 /**
@@ -267,13 +209,7 @@ bool ConnectionCapabilities::contactSearchesWithLimit() const
  */
 bool ConnectionCapabilities::dbusTubes() const
 {
-    RequestableChannelClassSpecList rccSpecs = allClassSpecs();
-    foreach (const RequestableChannelClassSpec &rccSpec, rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::dbusTube())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::DBusTubes);
 }
 
 /**
@@ -283,13 +219,7 @@ bool ConnectionCapabilities::dbusTubes() const
  */
 bool ConnectionCapabilities::streamTubes() const
 {
-    RequestableChannelClassSpecList rccSpecs = allClassSpecs();
-    foreach (const RequestableChannelClassSpec &rccSpec, rccSpecs) {
-        if (rccSpec.supports(RequestableChannelClassSpec::streamTube())) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->has(Private::StreamTubes);
 }
 
 } // Tp
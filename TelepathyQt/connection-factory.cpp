@@ -28,6 +28,16 @@
 namespace Tp
 {
 
+struct TP_QT_NO_EXPORT ConnectionFactory::Private
+{
+    Private()
+        : peerToPeerEnabled(false)
+    {
+    }
+
+    bool peerToPeerEnabled;
+};
+
 /**
  * \class ConnectionFactory
  * \ingroup utils
@@ -71,7 +81,8 @@ ConnectionFactoryPtr ConnectionFactory::create(const QDBusConnection &bus,
  * \param features The features to make ready on constructed Connections.
  */
 ConnectionFactory::ConnectionFactory(const QDBusConnection &bus, const Features &features)
-    : FixedFeatureFactory(bus)
+    : FixedFeatureFactory(bus),
+      mPriv(new Private)
 {
     addFeatures(features);
 }
@@ -81,6 +92,45 @@ ConnectionFactory::ConnectionFactory(const QDBusConnection &bus, const Features
  */
 ConnectionFactory::~ConnectionFactory()
 {
+    delete mPriv;
+}
+
+/**
+ * Return whether proxies constructed by this factory talk to their service directly when it
+ * offers to.
+ *
+ * \return \c true if peer-to-peer connections are enabled, \c false otherwise.
+ * \sa setPeerToPeerEnabled()
+ */
+bool ConnectionFactory::isPeerToPeerEnabled() const
+{
+    return mPriv->peerToPeerEnabled;
+}
+
+/**
+ * Set whether proxies constructed by this factory should talk to their service directly when it
+ * offers to.
+ *
+ * Connection managers built on BaseConnection can listen on a private socket in addition to the
+ * bus (see BaseConnection::setPeerToPeerEnabled()). When this is enabled, Connection proxies
+ * constructed from then on connect to that socket while Connection::FeatureCore is being made
+ * ready, and the interfaces of the connection created afterwards, those used by its
+ * ContactManager and those of its channels make their method calls and receive their signals
+ * over it. The bus is still used to find the connection, to follow its status and to notice the
+ * service going away, and proxies fall back to it if the direct connection can't be made.
+ *
+ * The direct connection is only accepted from processes running as the same user as the
+ * service. Proxies using it must be used from the thread they were made ready in. Proxies for
+ * the same connection constructed by other factories, and their channels, keep using the bus.
+ *
+ * This is disabled by default and only affects proxies constructed after the call.
+ *
+ * \param enabled Whether peer-to-peer connections should be enabled.
+ * \sa isPeerToPeerEnabled()
+ */
+void ConnectionFactory::setPeerToPeerEnabled(bool enabled)
+{
+    mPriv->peerToPeerEnabled = enabled;
 }
 
 /**
@@ -109,7 +159,9 @@ PendingReady *ConnectionFactory::proxy(const QString &busName, const QString &ob
 {
     DBusProxyPtr proxy = cachedProxy(busName, objectPath);
     if (proxy.isNull()) {
-        proxy = construct(busName, objectPath, chanFactory, contactFactory);
+        ConnectionPtr connection = construct(busName, objectPath, chanFactory, contactFactory);
+        connection->setPeerToPeerRequested(mPriv->peerToPeerEnabled);
+        proxy = connection;
     }
 
     return nowHaveProxy(proxy);
@@ -58,6 +58,9 @@ public:
             const ChannelFactoryConstPtr &chanFactory,
             const ContactFactoryConstPtr &contactFactory) const;
 
+    bool isPeerToPeerEnabled() const;
+    void setPeerToPeerEnabled(bool enabled);
+
 protected:
     ConnectionFactory(const QDBusConnection &bus, const Features &features);
 
@@ -70,7 +73,7 @@ protected:
 
 private:
     struct Private;
-    Private *mPriv; // Currently unused, just for future-proofing
+    Private *mPriv;
 };
 
 } // Tp
@@ -67,7 +67,7 @@ void ConnectionManager::Private::PendingNames::onCallFinished(QDBusPendingCallWa
         parseResult(reply.value());
         continueProcessing();
     } else {
-        warning() << "Failure: error " << reply.error().name() <<
+        tpWarning(logConnections) << "Failure: error " << reply.error().name() <<
             ": " << reply.error().message();
         setFinishedWithError(reply.error());
     }
@@ -82,7 +82,7 @@ void ConnectionManager::Private::PendingNames::continueProcessing()
         invokeMethod(method);
     }
     else {
-        debug() << "Success: list" << mResult;
+        tpDebug(logConnections) << "Success: list" << mResult;
         setResult(mResult.toList());
         setFinished();
     }
@@ -149,7 +149,7 @@ void ConnectionManager::Private::ProtocolWrapper::introspectMain(
         ConnectionManager::Private::ProtocolWrapper *self)
 {
     if (self->extractImmutableProperties()) {
-        debug() << "Got everything we want from the immutable props for" <<
+        tpDebug(logConnections) << "Got everything we want from the immutable props for" <<
             self->info().name();
         self->continueIntrospection();
         return;
@@ -169,7 +169,7 @@ void ConnectionManager::Private::ProtocolWrapper::introspectMainProperties()
     Client::ProtocolInterface *protocol = baseInterface();
     Q_ASSERT(protocol != 0);
 
-    debug() << "Calling Properties::GetAll(Protocol) for" << info().name();
+    tpDebug(logConnections) << "Calling Properties::GetAll(Protocol) for" << info().name();
     PendingVariantMap *pvm = protocol->requestAllProperties();
     connect(pvm,
             SIGNAL(finished(Tp::PendingOperation*)),
@@ -182,7 +182,8 @@ void ConnectionManager::Private::ProtocolWrapper::introspectInterfaces()
         if (hasInterface(TP_QT_IFACE_PROTOCOL_INTERFACE_AVATARS)) {
             introspectQueue.enqueue(&ProtocolWrapper::introspectAvatars);
         } else {
-            debug() << "Full functionality requires CM support for the Protocol.Avatars interface";
+            tpDebug(logConnections) <<
+                "Full functionality requires CM support for the Protocol.Avatars interface";
         }
     }
 
@@ -190,7 +191,8 @@ void ConnectionManager::Private::ProtocolWrapper::introspectInterfaces()
         if (hasInterface(TP_QT_IFACE_PROTOCOL_INTERFACE_PRESENCE)) {
             introspectQueue.enqueue(&ProtocolWrapper::introspectPresence);
         } else {
-            debug() << "Full functionality requires CM support for the Protocol.Presence interface";
+            tpDebug(logConnections) <<
+                "Full functionality requires CM support for the Protocol.Presence interface";
         }
     }
 
@@ -198,7 +200,8 @@ void ConnectionManager::Private::ProtocolWrapper::introspectInterfaces()
         if (hasInterface(TP_QT_IFACE_PROTOCOL_INTERFACE_ADDRESSING)) {
             introspectQueue.enqueue(&ProtocolWrapper::introspectAddressing);
         } else {
-            debug() << "Full functionality requires CM support for the Protocol.Addressing interface";
+            tpDebug(logConnections) <<
+                "Full functionality requires CM support for the Protocol.Addressing interface";
         }
     }
 }
@@ -208,7 +211,7 @@ void ConnectionManager::Private::ProtocolWrapper::introspectAvatars()
     Client::ProtocolInterfaceAvatarsInterface *avatars = avatarsInterface();
     Q_ASSERT(avatars != 0);
 
-    debug() << "Calling Properties::GetAll(Protocol.Avatars) for" << info().name();
+    tpDebug(logConnections) << "Calling Properties::GetAll(Protocol.Avatars) for" << info().name();
     PendingVariantMap *pvm = avatars->requestAllProperties();
     connect(pvm,
             SIGNAL(finished(Tp::PendingOperation*)),
@@ -220,7 +223,7 @@ void ConnectionManager::Private::ProtocolWrapper::introspectPresence()
     Client::ProtocolInterfacePresenceInterface *presence = presenceInterface();
     Q_ASSERT(presence != 0);
 
-    debug() << "Calling Properties::GetAll(Protocol.Presence) for" << info().name();
+    tpDebug(logConnections) << "Calling Properties::GetAll(Protocol.Presence) for" << info().name();
     PendingVariantMap *pvm = presence->requestAllProperties();
     connect(pvm,
             SIGNAL(finished(Tp::PendingOperation*)),
@@ -232,7 +235,8 @@ void ConnectionManager::Private::ProtocolWrapper::introspectAddressing()
     Client::ProtocolInterfaceAddressingInterface *addressing = addressingInterface();
     Q_ASSERT(addressing != 0);
 
-    debug() << "Calling Properties::GetAll(Protocol.Addressing) for" << info().name();
+    tpDebug(logConnections) << "Calling Properties::GetAll(Protocol.Addressing) for" <<
+        info().name();
     PendingVariantMap *pvm = addressing->requestAllProperties();
     connect(pvm,
             SIGNAL(finished(Tp::PendingOperation*)),
@@ -252,7 +256,7 @@ void ConnectionManager::Private::ProtocolWrapper::gotMainProperties(
         Tp::PendingOperation *op)
 {
     if (!op->isError()) {
-        debug() << "Got reply to Properties.GetAll(Protocol)";
+        tpDebug(logConnections) << "Got reply to Properties.GetAll(Protocol)";
         PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
         QVariantMap unqualifiedProps = pvm->result();
 
@@ -260,10 +264,11 @@ void ConnectionManager::Private::ProtocolWrapper::gotMainProperties(
 
         introspectInterfaces();
     } else {
-        warning().nospace() <<
+        tpWarning(logConnections).nospace() <<
             "Properties.GetAll(Protocol) failed: " <<
             op->errorName() << ": " << op->errorMessage();
-        warning() << "  Full functionality requires CM support for the Protocol interface";
+        tpWarning(logConnections) <<
+            "  Full functionality requires CM support for the Protocol interface";
     }
 
     continueIntrospection();
@@ -273,17 +278,18 @@ void ConnectionManager::Private::ProtocolWrapper::gotAvatarsProperties(
         Tp::PendingOperation *op)
 {
     if (!op->isError()) {
-        debug() << "Got reply to Properties.GetAll(Protocol.Avatars)";
+        tpDebug(logConnections) << "Got reply to Properties.GetAll(Protocol.Avatars)";
         PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
         QVariantMap unqualifiedProps = pvm->result();
 
         extractAvatarsProperties(qualifyProperties(TP_QT_IFACE_PROTOCOL_INTERFACE_AVATARS,
                     unqualifiedProps));
     } else {
-        warning().nospace() <<
+        tpWarning(logConnections).nospace() <<
             "Properties.GetAll(Protocol.Avatars) failed: " <<
             op->errorName() << ": " << op->errorMessage();
-        warning() << "  Full functionality requires CM support for the Protocol.Avatars interface";
+        tpWarning(logConnections) <<
+            "  Full functionality requires CM support for the Protocol.Avatars interface";
     }
 
     continueIntrospection();
@@ -293,17 +299,18 @@ void ConnectionManager::Private::ProtocolWrapper::gotPresenceProperties(
         Tp::PendingOperation *op)
 {
     if (!op->isError()) {
-        debug() << "Got reply to Properties.GetAll(Protocol.Presence)";
+        tpDebug(logConnections) << "Got reply to Properties.GetAll(Protocol.Presence)";
         PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
         QVariantMap unqualifiedProps = pvm->result();
 
         extractPresenceProperties(qualifyProperties(TP_QT_IFACE_PROTOCOL_INTERFACE_PRESENCE,
                     unqualifiedProps));
     } else {
-        warning().nospace() <<
+        tpWarning(logConnections).nospace() <<
             "Properties.GetAll(Protocol.Presence) failed: " <<
             op->errorName() << ": " << op->errorMessage();
-        warning() << "  Full functionality requires CM support for the Protocol.Presence interface";
+        tpWarning(logConnections) <<
+            "  Full functionality requires CM support for the Protocol.Presence interface";
     }
 
     continueIntrospection();
@@ -315,17 +322,18 @@ void ConnectionManager::Private::ProtocolWrapper::gotAddressingProperties(
     QVariantMap unqualifiedProps;
 
     if (!op->isError()) {
-        debug() << "Got reply to Properties.GetAll(Protocol.Addressing)";
+        tpDebug(logConnections) << "Got reply to Properties.GetAll(Protocol.Addressing)";
         PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
         QVariantMap unqualifiedProps = pvm->result();
 
         extractAddressingProperties(qualifyProperties(TP_QT_IFACE_PROTOCOL_INTERFACE_ADDRESSING,
                     unqualifiedProps));
     } else {
-        warning().nospace() <<
+        tpWarning(logConnections).nospace() <<
             "Properties.GetAll(Protocol.Addressing) failed: " <<
             op->errorName() << ": " << op->errorMessage();
-        warning() << "  Full functionality requires CM support for the Protocol.Addressing interface";
+        tpWarning(logConnections) <<
+            "  Full functionality requires CM support for the Protocol.Addressing interface";
     }
 
     continueIntrospection();
@@ -532,14 +540,16 @@ ConnectionManager::Private::Private(ConnectionManager *parent, const QString &na
       chanFactory(chanFactory),
       contactFactory(contactFactory)
 {
-    debug() << "Creating new ConnectionManager:" << parent->busName();
+    tpDebug(logConnections) << "Creating new ConnectionManager:" << parent->busName();
 
     if (connFactory->dbusConnection().name() != parent->dbusConnection().name()) {
-        warning() << "  The D-Bus connection in the connection factory is not the proxy connection";
+        tpWarning(logConnections) <<
+            "  The D-Bus connection in the connection factory is not the proxy connection";
     }
 
     if (chanFactory->dbusConnection().name() != parent->dbusConnection().name()) {
-        warning() << "  The D-Bus connection in the channel factory is not the proxy connection";
+        tpWarning(logConnections) <<
+            "  The D-Bus connection in the channel factory is not the proxy connection";
     }
 
     ReadinessHelper::Introspectables introspectables;
@@ -597,10 +607,10 @@ void ConnectionManager::Private::introspectMain(ConnectionManager::Private *self
         return;
     }
 
-    warning() << "Error parsing config file for connection manager"
+    tpWarning(logConnections) << "Error parsing config file for connection manager"
         << self->name << "- introspecting";
 
-    debug() << "Calling Properties::GetAll(ConnectionManager)";
+    tpDebug(logConnections) << "Calling Properties::GetAll(ConnectionManager)";
     PendingVariantMap *pvm = self->baseInterface->requestAllProperties();
     self->parent->connect(pvm,
             SIGNAL(finished(Tp::PendingOperation*)),
@@ -609,7 +619,7 @@ void ConnectionManager::Private::introspectMain(ConnectionManager::Private *self
 
 void ConnectionManager::Private::introspectProtocolsLegacy()
 {
-    debug() << "Calling ConnectionManager::ListProtocols";
+    tpDebug(logConnections) << "Calling ConnectionManager::ListProtocols";
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
             baseInterface->ListProtocols(), parent);
     parent->connect(watcher,
@@ -620,7 +630,8 @@ void ConnectionManager::Private::introspectProtocolsLegacy()
 void ConnectionManager::Private::introspectParametersLegacy()
 {
     foreach (const QString &protocolName, parametersQueue) {
-        debug() << "Calling ConnectionManager::GetParameters(" << protocolName << ")";
+        tpDebug(logConnections) << "Calling ConnectionManager::GetParameters(" << protocolName <<
+            ")";
         QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
                 baseInterface->GetParameters(protocolName), parent);
         parent->connect(watcher,
@@ -989,7 +1000,7 @@ void ConnectionManager::gotMainProperties(Tp::PendingOperation *op)
     QVariantMap props;
 
     if (!op->isError()) {
-        debug() << "Got reply to Properties.GetAll(ConnectionManager)";
+        tpDebug(logConnections) << "Got reply to Properties.GetAll(ConnectionManager)";
         PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
 
         props = pvm->result();
@@ -1001,7 +1012,7 @@ void ConnectionManager::gotMainProperties(Tp::PendingOperation *op)
             mPriv->readinessHelper->setInterfaces(interfaces());
         }
     } else {
-        warning().nospace() <<
+        tpWarning(logConnections).nospace() <<
             "Properties.GetAll(ConnectionManager) failed: " <<
             op->errorName() << ": " << op->errorMessage();
 
@@ -1018,7 +1029,8 @@ void ConnectionManager::gotMainProperties(Tp::PendingOperation *op)
         while (i != end) {
             QString protocolName = i.key();
             if (!checkValidProtocolName(protocolName)) {
-                warning() << "Protocol has an invalid name" << protocolName << "- ignoring";
+                tpWarning(logConnections) << "Protocol has an invalid name" << protocolName <<
+                    "- ignoring";
                 continue;
             }
 
@@ -1046,7 +1058,7 @@ void ConnectionManager::gotProtocolsLegacy(QDBusPendingCallWatcher *watcher)
     QStringList protocolsNames;
 
     if (!reply.isError()) {
-        debug() << "Got reply to ConnectionManager.ListProtocols";
+        tpDebug(logConnections) << "Got reply to ConnectionManager.ListProtocols";
         protocolsNames = reply.value();
 
         if (!protocolsNames.isEmpty()) {
@@ -1063,7 +1075,7 @@ void ConnectionManager::gotProtocolsLegacy(QDBusPendingCallWatcher *watcher)
     } else {
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false, reply.error());
 
-        warning().nospace() <<
+        tpWarning(logConnections).nospace() <<
             "ConnectionManager.ListProtocols failed: " <<
             reply.error().name() << ": " << reply.error().message();
 
@@ -1090,11 +1102,12 @@ void ConnectionManager::gotParametersLegacy(QDBusPendingCallWatcher *watcher)
     Q_UNUSED(found);
 
     if (!reply.isError()) {
-        debug() << QString(QLatin1String("Got reply to ConnectionManager.GetParameters(%1)")).arg(protocolName);
+        tpDebug(logConnections) <<
+            QString(QLatin1String("Got reply to ConnectionManager.GetParameters(%1)")).arg(protocolName);
         ParamSpecList parameters = reply.value();
         ProtocolInfo &info = mPriv->protocols[pos];
         foreach (const ParamSpec &spec, parameters) {
-            debug() << "Parameter" << spec.name << "has flags" << spec.flags
+            tpDebug(logConnections) << "Parameter" << spec.name << "has flags" << spec.flags
                 << "and signature" << spec.signature;
 
             info.addParameter(spec);
@@ -1103,7 +1116,7 @@ void ConnectionManager::gotParametersLegacy(QDBusPendingCallWatcher *watcher)
         // let's remove this protocol as we can't get the params
         mPriv->protocols.removeAt(pos);
 
-        warning().nospace() <<
+        tpWarning(logConnections).nospace() <<
             QString(QLatin1String("ConnectionManager.GetParameters(%1) failed: ")).arg(protocolName) <<
             reply.error().name() << ": " << reply.error().message();
     }
@@ -1132,7 +1145,7 @@ void ConnectionManager::onProtocolReady(Tp::PendingOperation *op)
     if (!op->isError()) {
         mPriv->protocols.append(info);
     } else {
-        warning().nospace() << "Protocol(" << info.name() << ")::becomeReady "
+        tpWarning(logConnections).nospace() << "Protocol(" << info.name() << ")::becomeReady "
             "failed: " << op->errorName() << ": " << op->errorMessage();
     }
 
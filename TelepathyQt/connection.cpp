@@ -31,6 +31,7 @@
 #include "TelepathyQt/_gen/connection-lowlevel.moc.hpp"
 
 #include "TelepathyQt/debug-internal.h"
+#include "TelepathyQt/peer-transport-internal.h"
 
 #include <TelepathyQt/ChannelFactory>
 #include <TelepathyQt/ConnectionCapabilities>
@@ -73,6 +74,7 @@ struct TP_QT_NO_EXPORT Connection::Private
     void introspectMainFallbackSelfHandle();
     void introspectCapabilities();
     void introspectContactAttributeInterfaces();
+    void introspectPeerToPeer();
     static void introspectSelfContact(Private *self);
     static void introspectSimplePresence(Private *self);
     static void introspectRoster(Private *self);
@@ -112,6 +114,10 @@ struct TP_QT_NO_EXPORT Connection::Private
     // Introspection
     QQueue<void (Private::*)()> introspectMainQueue;
 
+    // Set by ConnectionFactory::setPeerToPeerEnabled()
+    bool peerToPeerRequested;
+    bool peerToPeerAttached;
+
     // FeatureCore
     // keep pendingStatus and pendingStatusReason until we emit statusChanged
     // so Connection::status() and Connection::statusReason() are consistent
@@ -203,6 +209,8 @@ Connection::Private::Private(Connection *parent,
       properties(parent->interface<Client::DBus::PropertiesInterface>()),
       simplePresence(0),
       readinessHelper(parent->readinessHelper()),
+      peerToPeerRequested(false),
+      peerToPeerAttached(false),
       introspectingConnected(false),
       pendingStatus((uint) -1),
       pendingStatusReason(ConnectionStatusReasonNoneSpecified),
@@ -222,7 +230,8 @@ Connection::Private::Private(Connection *parent,
     Q_ASSERT(properties != 0);
 
     if (chanFactory->dbusConnection().name() != parent->dbusConnection().name()) {
-        warning() << "  The D-Bus connection in the channel factory is not the proxy connection";
+        tpWarning(logConnections) <<
+            "  The D-Bus connection in the channel factory is not the proxy connection";
     }
 
     init();
@@ -309,7 +318,7 @@ Connection::Private::Private(Connection *parent,
         cmName = rx.cap(1);
         protocolName = rx.cap(2);
     } else {
-        warning() << "Connection object path is not spec-compliant, "
+        tpWarning(logConnections) << "Connection object path is not spec-compliant, "
             "trying again with a different account-specific part check";
 
         rx = QRegExp(QLatin1String("^") + TP_QT_CONNECTION_OBJECT_PATH_BASE + QLatin1String(
@@ -321,7 +330,7 @@ Connection::Private::Private(Connection *parent,
             cmName = rx.cap(1);
             protocolName = rx.cap(2);
         } else {
-            warning() << "Not a valid Connection object path:" <<
+            tpWarning(logConnections) << "Not a valid Connection object path:" <<
                 parent->objectPath();
         }
     }
@@ -331,6 +340,10 @@ Connection::Private::~Private()
 {
     contactManager->resetRoster();
 
+    if (peerToPeerAttached) {
+        PeerTransport::detach(parent);
+    }
+
     // Clear selfContact so its handle will be released cleanly before the
     // handleContext
     selfContact.reset();
@@ -339,19 +352,19 @@ Connection::Private::~Private()
     // All handle contexts locked, so safe
     if (!--handleContext->refcount) {
         if (!immortalHandles) {
-            debug() << "Destroying HandleContext";
+            tpDebug(logConnections) << "Destroying HandleContext";
 
             foreach (uint handleType, handleContext->types.keys()) {
                 HandleContext::Type type = handleContext->types[handleType];
 
                 if (!type.refcounts.empty()) {
-                    debug() << " Still had references to" <<
+                    tpDebug(logConnections) << " Still had references to" <<
                         type.refcounts.size() << "handles, releasing now";
                     baseInterface->ReleaseHandles(handleType, type.refcounts.keys());
                 }
 
                 if (!type.toRelease.empty()) {
-                    debug() << " Was going to release" <<
+                    tpDebug(logConnections) << " Was going to release" <<
                         type.toRelease.size() << "handles, doing that now";
                     baseInterface->ReleaseHandles(handleType, type.toRelease.toList());
                 }
@@ -369,15 +382,15 @@ Connection::Private::~Private()
 
 void Connection::Private::init()
 {
-    debug() << "Connecting to ConnectionError()";
+    tpDebug(logConnections) << "Connecting to ConnectionError()";
     parent->connect(baseInterface,
             SIGNAL(ConnectionError(QString,QVariantMap)),
             SLOT(onConnectionError(QString,QVariantMap)));
-    debug() << "Connecting to StatusChanged()";
+    tpDebug(logConnections) << "Connecting to StatusChanged()";
     parent->connect(baseInterface,
             SIGNAL(StatusChanged(uint,uint)),
             SLOT(onStatusChanged(uint,uint)));
-    debug() << "Connecting to SelfHandleChanged()";
+    tpDebug(logConnections) << "Connecting to SelfHandleChanged()";
     parent->connect(baseInterface,
             SIGNAL(SelfHandleChanged(uint)),
             SLOT(onSelfHandleChanged(uint)));
@@ -386,11 +399,11 @@ void Connection::Private::init()
     QString busConnectionName = baseInterface->connection().name();
 
     if (handleContexts.contains(qMakePair(busConnectionName, parent->objectPath()))) {
-        debug() << "Reusing existing HandleContext for" << parent->objectPath();
+        tpDebug(logConnections) << "Reusing existing HandleContext for" << parent->objectPath();
         handleContext = handleContexts[
             qMakePair(busConnectionName, parent->objectPath())];
     } else {
-        debug() << "Creating new HandleContext for" << parent->objectPath();
+        tpDebug(logConnections) << "Creating new HandleContext for" << parent->objectPath();
         handleContext = new HandleContext;
         handleContexts[
             qMakePair(busConnectionName, parent->objectPath())] = handleContext;
@@ -402,7 +415,7 @@ void Connection::Private::init()
 
 void Connection::Private::introspectMain(Connection::Private *self)
 {
-    debug() << "Calling Properties::GetAll(Connection)";
+    tpDebug(logConnections) << "Calling Properties::GetAll(Connection)";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(
                 self->properties->GetAll(TP_QT_IFACE_CONNECTION),
@@ -414,7 +427,7 @@ void Connection::Private::introspectMain(Connection::Private *self)
 
 void Connection::Private::introspectMainFallbackStatus()
 {
-    debug() << "Calling GetStatus()";
+    tpDebug(logConnections) << "Calling GetStatus()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(baseInterface->GetStatus(),
                 parent);
@@ -425,7 +438,7 @@ void Connection::Private::introspectMainFallbackStatus()
 
 void Connection::Private::introspectMainFallbackInterfaces()
 {
-    debug() << "Calling GetInterfaces()";
+    tpDebug(logConnections) << "Calling GetInterfaces()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(baseInterface->GetInterfaces(),
                 parent);
@@ -436,7 +449,7 @@ void Connection::Private::introspectMainFallbackInterfaces()
 
 void Connection::Private::introspectMainFallbackSelfHandle()
 {
-    debug() << "Calling GetSelfHandle()";
+    tpDebug(logConnections) << "Calling GetSelfHandle()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(baseInterface->GetSelfHandle(),
                 parent);
@@ -447,7 +460,7 @@ void Connection::Private::introspectMainFallbackSelfHandle()
 
 void Connection::Private::introspectCapabilities()
 {
-    debug() << "Retrieving capabilities";
+    tpDebug(logConnections) << "Retrieving capabilities";
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
             properties->Get(
                 TP_QT_IFACE_CONNECTION_INTERFACE_REQUESTS,
@@ -459,7 +472,7 @@ void Connection::Private::introspectCapabilities()
 
 void Connection::Private::introspectContactAttributeInterfaces()
 {
-    debug() << "Retrieving contact attribute interfaces";
+    tpDebug(logConnections) << "Retrieving contact attribute interfaces";
     QDBusPendingCall call =
         properties->Get(
                 TP_QT_IFACE_CONNECTION_INTERFACE_CONTACTS,
@@ -471,9 +484,21 @@ void Connection::Private::introspectContactAttributeInterfaces()
                     SLOT(gotContactAttributeInterfaces(QDBusPendingCallWatcher*)));
 }
 
+void Connection::Private::introspectPeerToPeer()
+{
+    tpDebug(logConnections) << "Retrieving peer-to-peer address";
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
+            properties->Get(
+                TP_QT_IFACE_CONNECTION_INTERFACE_PEER_TO_PEER_DRAFT,
+                QLatin1String("Address")), parent);
+    parent->connect(watcher,
+            SIGNAL(finished(QDBusPendingCallWatcher*)),
+            SLOT(gotPeerToPeerAddress(QDBusPendingCallWatcher*)));
+}
+
 void Connection::Private::introspectSelfContact(Connection::Private *self)
 {
-    debug() << "Building self contact";
+    tpDebug(logConnections) << "Building self contact";
 
     Q_ASSERT(!self->introspectingSelfContact);
 
@@ -491,7 +516,7 @@ void Connection::Private::introspectSimplePresence(Connection::Private *self)
 {
     Q_ASSERT(self->properties != 0);
 
-    debug() << "Calling Properties::Get("
+    tpDebug(logConnections) << "Calling Properties::Get("
         "Connection.I.SimplePresence.Statuses)";
     QDBusPendingCall call =
         self->properties->GetAll(
@@ -505,7 +530,7 @@ void Connection::Private::introspectSimplePresence(Connection::Private *self)
 
 void Connection::Private::introspectRoster(Connection::Private *self)
 {
-    debug() << "Introspecting roster";
+    tpDebug(logConnections) << "Introspecting roster";
 
     PendingOperation *op = self->contactManager->introspectRoster();
     self->parent->connect(op,
@@ -515,7 +540,7 @@ void Connection::Private::introspectRoster(Connection::Private *self)
 
 void Connection::Private::introspectRosterGroups(Connection::Private *self)
 {
-    debug() << "Introspecting roster groups";
+    tpDebug(logConnections) << "Introspecting roster groups";
 
     PendingOperation *op = self->contactManager->introspectRosterGroups();
     self->parent->connect(op,
@@ -525,19 +550,19 @@ void Connection::Private::introspectRosterGroups(Connection::Private *self)
 
 void Connection::Private::introspectBalance(Connection::Private *self)
 {
-    debug() << "Introspecting balance";
+    tpDebug(logConnections) << "Introspecting balance";
 
     // we already checked if balance interface exists, so bypass requests
     // interface checking
     Client::ConnectionInterfaceBalanceInterface *iface =
         self->parent->interface<Client::ConnectionInterfaceBalanceInterface>();
 
-    debug() << "Connecting to Balance.BalanceChanged";
+    tpDebug(logConnections) << "Connecting to Balance.BalanceChanged";
     self->parent->connect(iface,
             SIGNAL(BalanceChanged(Tp::CurrencyAmount)),
             SLOT(onBalanceChanged(Tp::CurrencyAmount)));
 
-    debug() << "Retrieving balance";
+    tpDebug(logConnections) << "Retrieving balance";
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
             self->properties->Get(
                 TP_QT_IFACE_CONNECTION_INTERFACE_BALANCE,
@@ -561,7 +586,8 @@ void Connection::Private::introspectConnected(Connection::Private *self)
 void Connection::Private::continueMainIntrospection()
 {
     if (!parent->isValid()) {
-        debug() << parent << "stopping main introspection, as it has been invalidated";
+        tpDebug(logConnections) << parent <<
+            "stopping main introspection, as it has been invalidated";
         return;
     }
 
@@ -586,7 +612,7 @@ void Connection::Private::setCurrentStatus(uint status)
     if (introspectingConnected) {
         // On the other hand, we have to finish the Connected introspection for now, as
         // ReadinessHelper would otherwise wait indefinitely for it to land
-        debug() << "Finishing FeatureConnected for status" << this->status <<
+        tpDebug(logConnections) << "Finishing FeatureConnected for status" << this->status <<
             "to allow ReadinessHelper to introspect new status" << status;
         readinessHelper->setIntrospectCompleted(FeatureConnected, true);
         introspectingConnected = false;
@@ -599,7 +625,7 @@ void Connection::Private::forceCurrentStatus(uint status)
 {
     // only update the status if we did not get it from StatusChanged
     if (pendingStatus == (uint) -1) {
-        debug() << "Got status:" << status;
+        tpDebug(logConnections) << "Got status:" << status;
         pendingStatus = status;
         // No need to re-run introspection as we just received the status. Let
         // the introspection continue normally but update readinessHelper with
@@ -610,7 +636,7 @@ void Connection::Private::forceCurrentStatus(uint status)
 
 void Connection::Private::setInterfaces(const QStringList &interfaces)
 {
-    debug() << "Got interfaces:" << interfaces;
+    tpDebug(logConnections) << "Got interfaces:" << interfaces;
     parent->setInterfaces(interfaces);
     readinessHelper->setInterfaces(interfaces);
 }
@@ -678,7 +704,7 @@ void Connection::PendingConnect::onConnectReply(QDBusPendingCallWatcher *watcher
     ConnectionPtr connection = ConnectionPtr::qObjectCast(proxy());
 
     if (watcher->isError()) {
-        debug() << "Connect failed with" <<
+        tpDebug(logConnections) << "Connect failed with" <<
             watcher->error().name() << ": " << watcher->error().message();
         setFinishedWithError(watcher->error());
         connection->disconnect(
@@ -710,7 +736,8 @@ void Connection::PendingConnect::onStatusChanged(ConnectionStatus newStatus)
     ConnectionPtr connection = ConnectionPtr::qObjectCast(proxy());
 
     if (newStatus == ConnectionStatusDisconnected) {
-        debug() << "Connection became disconnected while a PendingConnect was underway";
+        tpDebug(logConnections) <<
+            "Connection became disconnected while a PendingConnect was underway";
         setFinishedWithError(connection->invalidationReason(), connection->invalidationMessage());
 
         connection->disconnect(this,
@@ -739,16 +766,16 @@ void Connection::PendingConnect::onBecomeReadyReply(Tp::PendingOperation *op)
             SLOT(onConnInvalidated(Tp::DBusProxy*,QString,QString)));
 
     if (op->isError()) {
-        debug() << "Connection->becomeReady failed with" <<
+        tpDebug(logConnections) << "Connection->becomeReady failed with" <<
             op->errorName() << ": " << op->errorMessage();
         setFinishedWithError(op->errorName(), op->errorMessage());
     } else {
-        debug() << "Connected";
+        tpDebug(logConnections) << "Connected";
 
         if (connection->isValid()) {
             setFinished();
         } else {
-            debug() << "  ... but the Connection was immediately invalidated!";
+            tpDebug(logConnections) << "  ... but the Connection was immediately invalidated!";
             setFinishedWithError(connection->invalidationReason(), connection->invalidationMessage());
         }
     }
@@ -762,7 +789,7 @@ void Connection::PendingConnect::onConnInvalidated(Tp::DBusProxy *proxy, const Q
     Q_ASSERT(proxy == connection.data());
 
     if (!isFinished()) {
-        debug() << "Unable to connect. Connection invalidated";
+        tpDebug(logConnections) << "Unable to connect. Connection invalidated";
         setFinishedWithError(error, message);
     }
 
@@ -1262,7 +1289,8 @@ QVariantMap Connection::ErrorDetails::allDetails() const
 const Connection::ErrorDetails &Connection::errorDetails() const
 {
     if (isValid()) {
-        warning() << "Connection::errorDetails() used on" << objectPath() << "which is valid";
+        tpWarning(logConnections) << "Connection::errorDetails() used on" << objectPath() <<
+            "which is valid";
     }
 
     return mPriv->errorDetails;
@@ -1300,14 +1328,15 @@ uint Connection::selfHandle() const
 SimpleStatusSpecMap ConnectionLowlevel::allowedPresenceStatuses() const
 {
     if (!isValid()) {
-        warning() << "ConnectionLowlevel::selfHandle() "
+        tpWarning(logConnections) << "ConnectionLowlevel::selfHandle() "
             "called for a connection which is already destroyed";
         return SimpleStatusSpecMap();
     }
 
     ConnectionPtr conn(connection());
     if (!conn->isReady(Connection::FeatureSimplePresence)) {
-        warning() << "Trying to retrieve allowed presence statuses from connection, but "
+        tpWarning(logConnections) <<
+            "Trying to retrieve allowed presence statuses from connection, but "
                      "simple presence is not supported or was not requested. "
                      "Enable FeatureSimplePresence in this connection";
     }
@@ -1329,14 +1358,15 @@ SimpleStatusSpecMap ConnectionLowlevel::allowedPresenceStatuses() const
 uint ConnectionLowlevel::maxPresenceStatusMessageLength() const
 {
     if (!isValid()) {
-        warning() << "ConnectionLowlevel::maxPresenceStatusMessageLength() "
+        tpWarning(logConnections) << "ConnectionLowlevel::maxPresenceStatusMessageLength() "
             "called for a connection which is already destroyed";
         return 0;
     }
 
     ConnectionPtr conn(connection());
     if (!conn->isReady(Connection::FeatureSimplePresence)) {
-        warning() << "Trying to retrieve max presence status message length connection, but "
+        tpWarning(logConnections) <<
+            "Trying to retrieve max presence status message length connection, but "
                      "simple presence is not supported or was not requested. "
                      "Enable FeatureSimplePresence in this connection";
     }
@@ -1367,7 +1397,8 @@ PendingOperation *ConnectionLowlevel::setSelfPresence(const QString &status,
         const QString &statusMessage)
 {
     if (!isValid()) {
-        warning() << "ConnectionLowlevel::selfHandle() called for a connection which is already destroyed";
+        tpWarning(logConnections) <<
+            "ConnectionLowlevel::selfHandle() called for a connection which is already destroyed";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE, QLatin1String("Connection already destroyed"),
                 ConnectionPtr());
     }
@@ -1400,7 +1431,8 @@ PendingOperation *ConnectionLowlevel::setSelfPresence(const QString &status,
 ContactPtr Connection::selfContact() const
 {
     if (!isReady(FeatureSelfContact)) {
-        warning() << "Connection::selfContact() used, but becomeReady(FeatureSelfContact) "
+        tpWarning(logConnections) <<
+            "Connection::selfContact() used, but becomeReady(FeatureSelfContact) "
             "hasn't been completed!";
     }
 
@@ -1423,7 +1455,7 @@ ContactPtr Connection::selfContact() const
 CurrencyAmount Connection::accountBalance() const
 {
     if (!isReady(FeatureAccountBalance)) {
-        warning() << "Connection::accountBalance() used before connection "
+        tpWarning(logConnections) << "Connection::accountBalance() used before connection "
             "FeatureAccountBalance is ready";
     }
 
@@ -1445,7 +1477,7 @@ CurrencyAmount Connection::accountBalance() const
 ConnectionCapabilities Connection::capabilities() const
 {
     if (!isReady(Connection::FeatureCore)) {
-        warning() << "Connection::capabilities() used before connection "
+        tpWarning(logConnections) << "Connection::capabilities() used before connection "
             "FeatureCore is ready";
     }
 
@@ -1466,17 +1498,18 @@ void Connection::onStatusReady(uint status)
     if (isValid()) {
         emit statusChanged((ConnectionStatus) mPriv->status);
     } else {
-        debug() << this << " not emitting statusChanged because it has been invalidated";
+        tpDebug(logConnections) << this <<
+            " not emitting statusChanged because it has been invalidated";
     }
 }
 
 void Connection::onStatusChanged(uint status, uint reason)
 {
-    debug() << "StatusChanged from" << mPriv->pendingStatus
+    tpDebug(logConnections) << "StatusChanged from" << mPriv->pendingStatus
             << "to" << status << "with reason" << reason;
 
     if (mPriv->pendingStatus == status) {
-        warning() << "New status was the same as the old status! Ignoring"
+        tpWarning(logConnections) << "New status was the same as the old status! Ignoring"
             "redundant StatusChanged";
         return;
     }
@@ -1487,7 +1520,7 @@ void Connection::onStatusChanged(uint status, uint reason)
 
     switch (status) {
         case ConnectionStatusConnected:
-            debug() << "Performing introspection for the Connected status";
+            tpDebug(logConnections) << "Performing introspection for the Connected status";
             mPriv->setCurrentStatus(status);
             break;
 
@@ -1513,7 +1546,7 @@ void Connection::onStatusChanged(uint status, uint reason)
             break;
 
         default:
-            warning() << "Unknown connection status" << status;
+            tpWarning(logConnections) << "Unknown connection status" << status;
             break;
     }
 }
@@ -1521,7 +1554,8 @@ void Connection::onStatusChanged(uint status, uint reason)
 void Connection::onConnectionError(const QString &error,
         const QVariantMap &details)
 {
-    debug().nospace() << "Connection(" << objectPath() << ") got ConnectionError(" << error
+    tpDebug(logConnections).nospace() <<
+        "Connection(" << objectPath() << ") got ConnectionError(" << error
         << ") with " << details.size() << " details";
 
     mPriv->errorDetails = details;
@@ -1537,7 +1571,7 @@ void Connection::gotMainProperties(QDBusPendingCallWatcher *watcher)
     if (!reply.isError()) {
         props = reply.value();
     } else {
-        warning().nospace() << "Properties::GetAll(Connection) failed with " <<
+        tpWarning(logConnections).nospace() << "Properties::GetAll(Connection) failed with " <<
             reply.error().name() << ": " << reply.error().message();
         // let's try to fallback first before failing
     }
@@ -1575,6 +1609,13 @@ void Connection::gotMainProperties(QDBusPendingCallWatcher *watcher)
         mPriv->immortalHandles = qdbus_cast<bool>(props[QLatin1String("HasImmortalHandles")]);
     }
 
+    // First, so that the interfaces built by the remaining steps already use the peer
+    if (mPriv->peerToPeerRequested && !mPriv->peerToPeerAttached &&
+            hasInterface(TP_QT_IFACE_CONNECTION_INTERFACE_PEER_TO_PEER_DRAFT)) {
+        mPriv->introspectMainQueue.enqueue(
+                &Private::introspectPeerToPeer);
+    }
+
     if (hasInterface(TP_QT_IFACE_CONNECTION_INTERFACE_REQUESTS)) {
         mPriv->introspectMainQueue.enqueue(
                 &Private::introspectCapabilities);
@@ -1599,7 +1640,7 @@ void Connection::gotStatus(QDBusPendingCallWatcher *watcher)
 
         mPriv->continueMainIntrospection();
     } else {
-        warning().nospace() << "GetStatus() failed with " <<
+        tpWarning(logConnections).nospace() << "GetStatus() failed with " <<
             reply.error().name() << ": " << reply.error().message();
         mPriv->invalidateResetCaps(reply.error().name(), reply.error().message());
     }
@@ -1615,7 +1656,7 @@ void Connection::gotInterfaces(QDBusPendingCallWatcher *watcher)
         mPriv->setInterfaces(reply.value());
     }
     else {
-        warning().nospace() << "GetInterfaces() failed with " <<
+        tpWarning(logConnections).nospace() << "GetInterfaces() failed with " <<
             reply.error().name() << ": " << reply.error().message() <<
             " - assuming no new interfaces";
         // let's not fail if GetInterfaces fail
@@ -1632,11 +1673,11 @@ void Connection::gotSelfHandle(QDBusPendingCallWatcher *watcher)
 
     if (!reply.isError()) {
         mPriv->selfHandle = reply.value();
-        debug() << "Got self handle:" << mPriv->selfHandle;
+        tpDebug(logConnections) << "Got self handle:" << mPriv->selfHandle;
 
         mPriv->continueMainIntrospection();
     } else {
-        warning().nospace() << "GetSelfHandle() failed with " <<
+        tpWarning(logConnections).nospace() << "GetSelfHandle() failed with " <<
             reply.error().name() << ": " << reply.error().message();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore,
                 false, reply.error());
@@ -1650,11 +1691,11 @@ void Connection::gotCapabilities(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<QDBusVariant> reply = *watcher;
 
     if (!reply.isError()) {
-        debug() << "Got capabilities";
+        tpDebug(logConnections) << "Got capabilities";
         mPriv->caps.updateRequestableChannelClasses(
                 qdbus_cast<RequestableChannelClassList>(reply.value().variant()));
     } else {
-        warning().nospace() << "Getting capabilities failed with " <<
+        tpWarning(logConnections).nospace() << "Getting capabilities failed with " <<
             reply.error().name() << ": " << reply.error().message();
         // let's not fail if retrieving capabilities fail
     }
@@ -1664,15 +1705,41 @@ void Connection::gotCapabilities(QDBusPendingCallWatcher *watcher)
     watcher->deleteLater();
 }
 
+void Connection::setPeerToPeerRequested(bool requested)
+{
+    mPriv->peerToPeerRequested = requested;
+}
+
+void Connection::gotPeerToPeerAddress(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<QDBusVariant> reply = *watcher;
+
+    if (!reply.isError()) {
+        QString address = reply.value().variant().toString();
+        tpDebug(logConnections) << "Got peer-to-peer address" << address;
+        mPriv->peerToPeerAttached = !address.isEmpty() &&
+            PeerTransport::attach(this, address);
+    } else {
+        tpWarning(logConnections).nospace() << "Getting peer-to-peer address failed with " <<
+            reply.error().name() << ": " << reply.error().message();
+    }
+
+    // Either way the bus still works, so carry on without the peer if it failed
+    mPriv->continueMainIntrospection();
+
+    watcher->deleteLater();
+}
+
 void Connection::gotContactAttributeInterfaces(QDBusPendingCallWatcher *watcher)
 {
     QDBusPendingReply<QDBusVariant> reply = *watcher;
 
     if (!reply.isError()) {
-        debug() << "Got contact attribute interfaces";
+        tpDebug(logConnections) << "Got contact attribute interfaces";
         mPriv->contactAttributeInterfaces = qdbus_cast<QStringList>(reply.value().variant());
     } else {
-        warning().nospace() << "Getting contact attribute interfaces failed with " <<
+        tpWarning(logConnections).nospace() <<
+            "Getting contact attribute interfaces failed with " <<
             reply.error().name() << ": " << reply.error().message();
         // let's not fail if retrieving contact attribute interfaces fail
         // TODO should we remove Contacts interface from interfaces?
@@ -1695,14 +1762,14 @@ void Connection::gotSimpleStatuses(QDBusPendingCallWatcher *watcher)
         mPriv->maxPresenceStatusMessageLength = qdbus_cast<uint>(
                 props[QLatin1String("MaximumStatusMessageLength")]);
 
-        debug() << "Got" << mPriv->simplePresenceStatuses.size() <<
+        tpDebug(logConnections) << "Got" << mPriv->simplePresenceStatuses.size() <<
             "simple presence statuses - max status message length is" <<
             mPriv->maxPresenceStatusMessageLength;
 
         mPriv->readinessHelper->setIntrospectCompleted(FeatureSimplePresence, true);
     }
     else {
-        warning().nospace() << "Getting simple presence statuses failed with " <<
+        tpWarning(logConnections).nospace() << "Getting simple presence statuses failed with " <<
             reply.error().name() << ":" << reply.error().message();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureSimplePresence, false, reply.error());
     }
@@ -1728,7 +1795,7 @@ void Connection::gotSelfContact(PendingOperation *op)
             emit selfContactChanged();
         }
     } else {
-        warning().nospace() << "Getting self contact failed with " <<
+        tpWarning(logConnections).nospace() << "Getting self contact failed with " <<
             pending->errorName() << ":" << pending->errorMessage();
 
         // check if the feature is already there, and for some reason introspectSelfContact
@@ -1754,28 +1821,28 @@ void Connection::gotSelfContact(PendingOperation *op)
 void Connection::onIntrospectRosterFinished(PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "Introspecting roster failed with " <<
+        tpWarning(logConnections).nospace() << "Introspecting roster failed with " <<
             op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureRoster, false,
                 op->errorName(), op->errorMessage());
         return;
     }
 
-    debug() << "Introspecting roster finished";
+    tpDebug(logConnections) << "Introspecting roster finished";
     mPriv->readinessHelper->setIntrospectCompleted(FeatureRoster, true);
 }
 
 void Connection::onIntrospectRosterGroupsFinished(PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "Introspecting roster groups failed with " <<
+        tpWarning(logConnections).nospace() << "Introspecting roster groups failed with " <<
             op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureRosterGroups, false,
                 op->errorName(), op->errorMessage());
         return;
     }
 
-    debug() << "Introspecting roster groups finished";
+    tpDebug(logConnections) << "Introspecting roster groups finished";
     mPriv->readinessHelper->setIntrospectCompleted(FeatureRosterGroups, true);
 }
 
@@ -1784,11 +1851,11 @@ void Connection::gotBalance(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<QVariant> reply = *watcher;
 
     if (!reply.isError()) {
-        debug() << "Got balance";
+        tpDebug(logConnections) << "Got balance";
         mPriv->accountBalance = qdbus_cast<CurrencyAmount>(reply.value());
         mPriv->readinessHelper->setIntrospectCompleted(FeatureAccountBalance, true);
     } else {
-        warning().nospace() << "Getting balance failed with " <<
+        tpWarning(logConnections).nospace() << "Getting balance failed with " <<
             reply.error().name() << ":" << reply.error().message();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureAccountBalance, false,
                 reply.error().name(), reply.error().message());
@@ -1858,14 +1925,14 @@ PendingChannel *ConnectionLowlevel::createChannel(const QVariantMap &request,
 
     ConnectionPtr conn(connection());
     if (conn->mPriv->pendingStatus != ConnectionStatusConnected) {
-        warning() << "Calling createChannel with connection not yet connected";
+        tpWarning(logConnections) << "Calling createChannel with connection not yet connected";
         return new PendingChannel(conn,
                 TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Connection not yet connected"));
     }
 
     if (!conn->interfaces().contains(TP_QT_IFACE_CONNECTION_INTERFACE_REQUESTS)) {
-        warning() << "Requests interface is not support by this connection";
+        tpWarning(logConnections) << "Requests interface is not support by this connection";
         return new PendingChannel(conn,
                 TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("Connection does not support Requests Interface"));
@@ -1877,7 +1944,7 @@ PendingChannel *ConnectionLowlevel::createChannel(const QVariantMap &request,
                 QLatin1String("Invalid 'request' argument"));
     }
 
-    debug() << "Creating a Channel";
+    tpDebug(logConnections) << "Creating a Channel";
     PendingChannel *channel = new PendingChannel(conn, request, true, timeout);
     return channel;
 }
@@ -1929,14 +1996,14 @@ PendingChannel *ConnectionLowlevel::ensureChannel(const QVariantMap &request,
 
     ConnectionPtr conn(connection());
     if (conn->mPriv->pendingStatus != ConnectionStatusConnected) {
-        warning() << "Calling ensureChannel with connection not yet connected";
+        tpWarning(logConnections) << "Calling ensureChannel with connection not yet connected";
         return new PendingChannel(conn,
                 TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Connection not yet connected"));
     }
 
     if (!conn->interfaces().contains(TP_QT_IFACE_CONNECTION_INTERFACE_REQUESTS)) {
-        warning() << "Requests interface is not support by this connection";
+        tpWarning(logConnections) << "Requests interface is not support by this connection";
         return new PendingChannel(conn,
                 TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("Connection does not support Requests Interface"));
@@ -1948,7 +2015,7 @@ PendingChannel *ConnectionLowlevel::ensureChannel(const QVariantMap &request,
                 QLatin1String("Invalid 'request' argument"));
     }
 
-    debug() << "Creating a Channel";
+    tpDebug(logConnections) << "Creating a Channel";
     PendingChannel *channel = new PendingChannel(conn, request, false, timeout);
     return channel;
 }
@@ -1985,7 +2052,7 @@ PendingChannel *ConnectionLowlevel::ensureChannel(const QVariantMap &request,
  */
 PendingHandles *ConnectionLowlevel::requestHandles(HandleType handleType, const QStringList &names)
 {
-    debug() << "Request for" << names.length() << "handles of type" << handleType;
+    tpDebug(logConnections) << "Request for" << names.length() << "handles of type" << handleType;
 
     if (!isValid()) {
         return new PendingHandles(TP_QT_ERROR_NOT_AVAILABLE,
@@ -2037,7 +2104,8 @@ PendingHandles *ConnectionLowlevel::requestHandles(HandleType handleType, const
  */
 PendingHandles *ConnectionLowlevel::referenceHandles(HandleType handleType, const UIntList &handles)
 {
-    debug() << "Reference of" << handles.length() << "handles of type" << handleType;
+    tpDebug(logConnections) << "Reference of" << handles.length() << "handles of type" <<
+        handleType;
 
     if (!isValid()) {
         return new PendingHandles(TP_QT_ERROR_NOT_AVAILABLE,
@@ -2061,7 +2129,7 @@ PendingHandles *ConnectionLowlevel::referenceHandles(HandleType handleType, cons
             }
         }
 
-        debug() << " Already holding" << alreadyHeld.size() <<
+        tpDebug(logConnections) << " Already holding" << alreadyHeld.size() <<
             "of the handles -" << notYetHeld.size() << "to go";
     } else {
         alreadyHeld = handles;
@@ -2165,7 +2233,7 @@ PendingOperation *ConnectionLowlevel::requestDisconnect()
 PendingContactAttributes *ConnectionLowlevel::contactAttributes(const UIntList &handles,
         const QStringList &interfaces, bool reference)
 {
-    debug() << "Request for attributes for" << handles.size() << "contacts";
+    tpDebug(logConnections) << "Request for attributes for" << handles.size() << "contacts";
 
     if (!isValid()) {
         PendingContactAttributes *pending = new PendingContactAttributes(ConnectionPtr(),
@@ -2180,17 +2248,19 @@ PendingContactAttributes *ConnectionLowlevel::contactAttributes(const UIntList &
         new PendingContactAttributes(conn,
                 handles, interfaces, reference);
     if (!conn->isReady(Connection::FeatureCore)) {
-        warning() << "ConnectionLowlevel::contactAttributes() used when not ready";
+        tpWarning(logConnections) << "ConnectionLowlevel::contactAttributes() used when not ready";
         pending->failImmediately(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("The connection isn't ready"));
         return pending;
     } else if (conn->mPriv->pendingStatus != ConnectionStatusConnected) {
-        warning() << "ConnectionLowlevel::contactAttributes() used with status" << conn->status() << "!= ConnectionStatusConnected";
+        tpWarning(logConnections) << "ConnectionLowlevel::contactAttributes() used with status" <<
+            conn->status() << "!= ConnectionStatusConnected";
         pending->failImmediately(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("The connection isn't Connected"));
         return pending;
     } else if (!conn->interfaces().contains(TP_QT_IFACE_CONNECTION_INTERFACE_CONTACTS)) {
-        warning() << "ConnectionLowlevel::contactAttributes() used without the remote object supporting"
+        tpWarning(logConnections) <<
+            "ConnectionLowlevel::contactAttributes() used without the remote object supporting"
                   << "the Contacts interface";
         pending->failImmediately(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("The connection doesn't support the Contacts interface"));
@@ -2216,16 +2286,19 @@ PendingContactAttributes *ConnectionLowlevel::contactAttributes(const UIntList &
 QStringList ConnectionLowlevel::contactAttributeInterfaces() const
 {
     if (!isValid()) {
-        warning() << "ConnectionLowlevel::contactAttributeInterfaces() called for a destroyed Connection";
+        tpWarning(logConnections) <<
+            "ConnectionLowlevel::contactAttributeInterfaces() called for a destroyed Connection";
         return QStringList();
     }
 
     ConnectionPtr conn(connection());
     if (conn->mPriv->pendingStatus != ConnectionStatusConnected) {
-        warning() << "ConnectionLowlevel::contactAttributeInterfaces() used with status"
+        tpWarning(logConnections) <<
+            "ConnectionLowlevel::contactAttributeInterfaces() used with status"
             << conn->status() << "!= ConnectionStatusConnected";
     } else if (!conn->interfaces().contains(TP_QT_IFACE_CONNECTION_INTERFACE_CONTACTS)) {
-        warning() << "ConnectionLowlevel::contactAttributeInterfaces() used without the remote object supporting"
+        tpWarning(logConnections) <<
+            "ConnectionLowlevel::contactAttributeInterfaces() used without the remote object supporting"
                   << "the Contacts interface";
     }
 
@@ -2247,7 +2320,8 @@ void ConnectionLowlevel::injectContactIds(const HandleIdentifierMap &contactIds)
             QString currentId = mPriv->contactsIds.value(handle);
 
             if (!currentId.isEmpty() && id != currentId) {
-                warning() << "Trying to overwrite contact id from" << currentId << "to" << id
+                tpWarning(logConnections) <<
+                    "Trying to overwrite contact id from" << currentId << "to" << id
                     << "for the same handle" << handle << ", ignoring";
             } else {
                 mPriv->contactsIds.insert(handle, id);
@@ -2340,7 +2414,7 @@ void Connection::unrefHandle(HandleType handleType, uint handle)
 
         if (!handleContext->types[handleType].releaseScheduled) {
             if (!handleContext->types[handleType].requestsInFlight) {
-                debug() << "Lost last reference to at least one handle of type" <<
+                tpDebug(logConnections) << "Lost last reference to at least one handle of type" <<
                     handleType <<
                     "and no requests in flight for that type - scheduling a release sweep";
                 QMetaObject::invokeMethod(this, "doReleaseSweep",
@@ -2363,20 +2437,22 @@ void Connection::doReleaseSweep(uint handleType)
     Q_ASSERT(handleContext->types.contains(handleType));
     Q_ASSERT(handleContext->types[handleType].releaseScheduled);
 
-    debug() << "Entering handle release sweep for type" << handleType;
+    tpDebug(logConnections) << "Entering handle release sweep for type" << handleType;
     handleContext->types[handleType].releaseScheduled = false;
 
     if (handleContext->types[handleType].requestsInFlight > 0) {
-        debug() << " There are requests in flight, deferring sweep to when they have been completed";
+        tpDebug(logConnections) <<
+            " There are requests in flight, deferring sweep to when they have been completed";
         return;
     }
 
     if (handleContext->types[handleType].toRelease.isEmpty()) {
-        debug() << " No handles to release - every one has been resurrected";
+        tpDebug(logConnections) << " No handles to release - every one has been resurrected";
         return;
     }
 
-    debug() << " Releasing" << handleContext->types[handleType].toRelease.size() << "handles";
+    tpDebug(logConnections) << " Releasing" << handleContext->types[handleType].toRelease.size() <<
+        "handles";
 
     mPriv->baseInterface->ReleaseHandles(handleType, handleContext->types[handleType].toRelease.toList());
     handleContext->types[handleType].toRelease.clear();
@@ -2397,7 +2473,7 @@ void Connection::handleRequestLanded(HandleType handleType)
     if (!--handleContext->types[handleType].requestsInFlight &&
         !handleContext->types[handleType].toRelease.isEmpty() &&
         !handleContext->types[handleType].releaseScheduled) {
-        debug() << "All handle requests for type" << handleType <<
+        tpDebug(logConnections) << "All handle requests for type" << handleType <<
             "landed and there are handles of that type to release - scheduling a release sweep";
         QMetaObject::invokeMethod(this, "doReleaseSweep", Qt::QueuedConnection, Q_ARG(uint, handleType));
         handleContext->types[handleType].releaseScheduled = true;
@@ -2411,11 +2487,12 @@ void Connection::onSelfHandleChanged(uint handle)
     }
 
     if (mPriv->pendingStatus != ConnectionStatusConnected || !mPriv->selfHandle) {
-        debug() << "Got a self handle change before we have the initial self handle, ignoring";
+        tpDebug(logConnections) <<
+            "Got a self handle change before we have the initial self handle, ignoring";
         return;
     }
 
-    debug() << "Connection self handle changed to" << handle;
+    tpDebug(logConnections) << "Connection self handle changed to" << handle;
     mPriv->selfHandle = handle;
     emit selfHandleChanged(handle);
 
@@ -2423,13 +2500,14 @@ void Connection::onSelfHandleChanged(uint handle)
         // We're currently introspecting the SelfContact feature, but have started building the
         // contact with the old handle, so we need to do it again with the new handle.
 
-        debug() << "The self contact is being built, will rebuild with the new handle shortly";
+        tpDebug(logConnections) <<
+            "The self contact is being built, will rebuild with the new handle shortly";
         mPriv->reintrospectSelfContactRequired = true;
     } else if (isReady(FeatureSelfContact)) {
         // We've already introspected the SelfContact feature, so we can reinvoke the introspection
         // logic directly to rebuild with the new handle.
 
-        debug() << "Re-building self contact for handle" << handle;
+        tpDebug(logConnections) << "Re-building self contact for handle" << handle;
         Private::introspectSelfContact(mPriv);
     }
 
@@ -207,6 +207,7 @@ private Q_SLOTS:
     TP_QT_NO_EXPORT void gotInterfaces(QDBusPendingCallWatcher *watcher);
     TP_QT_NO_EXPORT void gotSelfHandle(QDBusPendingCallWatcher *watcher);
     TP_QT_NO_EXPORT void gotCapabilities(QDBusPendingCallWatcher *watcher);
+    TP_QT_NO_EXPORT void gotPeerToPeerAddress(QDBusPendingCallWatcher *watcher);
     TP_QT_NO_EXPORT void gotContactAttributeInterfaces(QDBusPendingCallWatcher *watcher);
     TP_QT_NO_EXPORT void gotSimpleStatuses(QDBusPendingCallWatcher *watcher);
     TP_QT_NO_EXPORT void gotSelfContact(Tp::PendingOperation *op);
@@ -223,6 +224,7 @@ private Q_SLOTS:
 
 private:
     class PendingConnect;
+    friend class ConnectionFactory;
     friend class ConnectionLowlevel;
     friend class PendingChannel;
     friend class PendingConnect;
@@ -235,6 +237,8 @@ private:
     TP_QT_NO_EXPORT void unrefHandle(HandleType handleType, uint handle);
     TP_QT_NO_EXPORT void handleRequestLanded(HandleType handleType);
 
+    TP_QT_NO_EXPORT void setPeerToPeerRequested(bool requested);
+
     struct Private;
     friend struct Private;
     Private *mPriv;
@@ -22,6 +22,8 @@
 
 #include <TelepathyQt/ContactCapabilities>
 
+#include "TelepathyQt/capabilities-base-internal.h"
+
 #include <TelepathyQt/Types>
 
 namespace Tp
@@ -91,14 +93,10 @@ ContactCapabilities::~ContactCapabilities()
  */
 bool ContactCapabilities::dbusTubes(const QString &serviceName) const
 {
-    RequestableChannelClassSpec dbusTubeSpec = RequestableChannelClassSpec::dbusTube(serviceName);
-    RequestableChannelClassSpecList rccSpecs = allClassSpecs();
-    foreach (const RequestableChannelClassSpec &rccSpec, rccSpecs) {
-        if (rccSpec.supports(dbusTubeSpec)) {
-            return true;
-        }
+    if (serviceName.isEmpty()) {
+        return mPriv->has(Private::DBusTubes);
     }
-    return false;
+    return mPriv->supportedDBusTubeServices.contains(serviceName);
 }
 
 /**
@@ -108,20 +106,7 @@ bool ContactCapabilities::dbusTubes(const QString &serviceName) const
  */
 QStringList ContactCapabilities::dbusTubeServices() const
 {
-    QSet<QString> ret;
-
-    RequestableChannelClassSpecList rccSpecs = allClassSpecs();
-    foreach (const RequestableChannelClassSpec &rccSpec, rccSpecs) {
-        if (rccSpec.channelType() == TP_QT_IFACE_CHANNEL_TYPE_DBUS_TUBE &&
-            rccSpec.targetHandleType() == HandleTypeContact &&
-            rccSpec.hasFixedProperty(
-                    TP_QT_IFACE_CHANNEL_TYPE_DBUS_TUBE + QLatin1String(".ServiceName"))) {
-            ret << rccSpec.fixedProperty(
-                    TP_QT_IFACE_CHANNEL_TYPE_DBUS_TUBE + QLatin1String(".ServiceName")).toString();
-        }
-    }
-
-    return ret.toList();
+    return mPriv->dbusTubeServices;
 }
 
 /**
@@ -132,14 +117,10 @@ QStringList ContactCapabilities::dbusTubeServices() const
  */
 bool ContactCapabilities::streamTubes(const QString &service) const
 {
-    RequestableChannelClassSpec streamTubeSpec = RequestableChannelClassSpec::streamTube(service);
-    RequestableChannelClassSpecList rccSpecs = allClassSpecs();
-    foreach (const RequestableChannelClassSpec &rccSpec, rccSpecs) {
-        if (rccSpec.supports(streamTubeSpec)) {
-            return true;
-        }
+    if (service.isEmpty()) {
+        return mPriv->has(Private::StreamTubes);
     }
-    return false;
+    return mPriv->supportedStreamTubeServices.contains(service);
 }
 
 /**
@@ -149,20 +130,7 @@ bool ContactCapabilities::streamTubes(const QString &service) const
  */
 QStringList ContactCapabilities::streamTubeServices() const
 {
-    QSet<QString> ret;
-
-    RequestableChannelClassSpecList rccSpecs = allClassSpecs();
-    foreach (const RequestableChannelClassSpec &rccSpec, rccSpecs) {
-        if (rccSpec.channelType() == TP_QT_IFACE_CHANNEL_TYPE_STREAM_TUBE &&
-            rccSpec.targetHandleType() == HandleTypeContact &&
-            rccSpec.hasFixedProperty(
-                    TP_QT_IFACE_CHANNEL_TYPE_STREAM_TUBE + QLatin1String(".Service"))) {
-            ret << rccSpec.fixedProperty(
-                    TP_QT_IFACE_CHANNEL_TYPE_STREAM_TUBE + QLatin1String(".Service")).toString();
-        }
-    }
-
-    return ret.toList();
+    return mPriv->streamTubeServices;
 }
 
 } // Tp
@@ -26,6 +26,7 @@
 #include <TelepathyQt/ContactManager>
 #include <TelepathyQt/Global>
 #include <TelepathyQt/PendingOperation>
+#include <TelepathyQt/ReferencedHandles>
 #include <TelepathyQt/Types>
 
 #include <QList>
@@ -363,6 +364,39 @@ private Q_SLOTS:
     void onChannelClosed(Tp::PendingOperation *);
 };
 
+class TP_QT_NO_EXPORT ContactManager::PendingAttributes : public PendingOperation
+{
+    Q_OBJECT
+
+public:
+    PendingAttributes(const ConnectionPtr &conn, const UIntList &handles,
+            const QStringList &interfaces);
+    ~PendingAttributes();
+
+    UIntList handles() const { return mHandles; }
+    QStringList interfaces() const { return mInterfaces; }
+
+    // One entry per GetContactAttributes call this request was served from
+    QList<ReferencedHandles> validHandles() const { return mValidHandles; }
+    ContactAttributesMap attributes() const { return mAttributes; }
+
+    void addPendingChunk();
+    void chunkFinished(const ReferencedHandles &validHandles,
+            const ContactAttributesMap &attributes);
+    void chunkFailed(const QString &errorName, const QString &errorMessage);
+
+private:
+    void checkFinished();
+
+    UIntList mHandles;
+    QStringList mInterfaces;
+    int mPendingChunks;
+    QList<ReferencedHandles> mValidHandles;
+    ContactAttributesMap mAttributes;
+    QString mErrorName;
+    QString mErrorMessage;
+};
+
 class TP_QT_NO_EXPORT ContactManager::PendingRefreshContactInfo : public PendingOperation
 {
     Q_OBJECT
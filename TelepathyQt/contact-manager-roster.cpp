@@ -79,19 +79,19 @@ PendingOperation *ContactManager::Roster::introspect()
     ConnectionPtr conn(contactManager->connection());
 
     if (conn->hasInterface(TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_LIST)) {
-        debug() << "Connection.ContactList found, using it";
+        tpDebug(logContacts) << "Connection.ContactList found, using it";
 
         usingFallbackContactList = false;
 
         if (conn->hasInterface(TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_BLOCKING)) {
-            debug() << "Connection.ContactBlocking found. using it";
+            tpDebug(logContacts) << "Connection.ContactBlocking found. using it";
             hasContactBlockingInterface = true;
             introspectContactBlocking();
         } else {
-            debug() << "Connection.ContactBlocking not found, falling back "
+            tpDebug(logContacts) << "Connection.ContactBlocking not found, falling back "
                 "to contact list deny channel";
 
-            debug() << "Requesting handle for deny channel";
+            tpDebug(logContacts) << "Requesting handle for deny channel";
 
             contactListChannels.insert(ChannelInfo::TypeDeny,
                     ChannelInfo(ChannelInfo::TypeDeny));
@@ -104,7 +104,8 @@ PendingOperation *ContactManager::Roster::introspect()
                     SLOT(gotContactListChannelHandle(Tp::PendingOperation*)));
         }
     } else {
-        debug() << "Connection.ContactList not found, falling back to contact list channels";
+        tpDebug(logContacts) <<
+            "Connection.ContactList not found, falling back to contact list channels";
 
         usingFallbackContactList = true;
 
@@ -112,7 +113,7 @@ PendingOperation *ContactManager::Roster::introspect()
             QString channelId = ChannelInfo::identifierForType(
                     (ChannelInfo::Type) i);
 
-            debug() << "Requesting handle for" << channelId << "channel";
+            tpDebug(logContacts) << "Requesting handle for" << channelId << "channel";
 
             contactListChannels.insert(i,
                     ChannelInfo((ChannelInfo::Type) i));
@@ -142,10 +143,11 @@ PendingOperation *ContactManager::Roster::introspectGroups()
                     QLatin1String("Roster groups not supported"), conn);
         }
 
-        debug() << "Connection.ContactGroups found, using it";
+        tpDebug(logContacts) << "Connection.ContactGroups found, using it";
 
         if (!gotContactListInitialContacts) {
-            debug() << "Initial ContactList contacts not retrieved. Postponing introspection";
+            tpDebug(logContacts) <<
+                "Initial ContactList contacts not retrieved. Postponing introspection";
             groupsReintrospectionRequired = true;
             return new PendingSuccess(conn);
         }
@@ -171,7 +173,8 @@ PendingOperation *ContactManager::Roster::introspectGroups()
                 SIGNAL(finished(Tp::PendingOperation*)),
                 SLOT(gotContactListGroupsProperties(Tp::PendingOperation*)));
     } else {
-        debug() << "Connection.ContactGroups not found, falling back to contact list group channels";
+        tpDebug(logContacts) <<
+            "Connection.ContactGroups not found, falling back to contact list group channels";
 
         ++featureContactListGroupsTodo; // decremented in gotChannels
 
@@ -180,12 +183,12 @@ PendingOperation *ContactManager::Roster::introspectGroups()
         Client::ConnectionInterfaceRequestsInterface *iface =
             conn->interface<Client::ConnectionInterfaceRequestsInterface>();
 
-        debug() << "Connecting to Requests.NewChannels";
+        tpDebug(logContacts) << "Connecting to Requests.NewChannels";
         connect(iface,
                 SIGNAL(NewChannels(Tp::ChannelDetailsList)),
                 SLOT(onNewChannels(Tp::ChannelDetailsList)));
 
-        debug() << "Retrieving channels";
+        tpDebug(logContacts) << "Retrieving channels";
         Client::DBus::PropertiesInterface *properties =
             contactManager->connection()->interface<Client::DBus::PropertiesInterface>();
         QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
@@ -594,19 +597,19 @@ PendingOperation *ContactManager::Roster::removeContacts(
          */
 
         if (storedChannel && storedChannel->groupCanRemoveContacts()) {
-            debug() << "Removing contacts from stored list";
+            tpDebug(logContacts) << "Removing contacts from stored list";
             return storedChannel->groupRemoveContacts(contacts, message);
         }
 
         QList<PendingOperation*> operations;
 
         if (canRemovePresenceSubscription()) {
-            debug() << "Removing contacts from subscribe list";
+            tpDebug(logContacts) << "Removing contacts from subscribe list";
             operations << removePresenceSubscription(contacts, message);
         }
 
         if (canRemovePresencePublication()) {
-            debug() << "Removing contacts from publish list";
+            tpDebug(logContacts) << "Removing contacts from publish list";
             operations << removePresencePublication(contacts, message);
         }
 
@@ -694,13 +697,13 @@ PendingOperation *ContactManager::Roster::blockContacts(
 void ContactManager::Roster::gotContactBlockingCapabilities(PendingOperation *op)
 {
     if (op->isError()) {
-        warning() << "Getting ContactBlockingCapabilities property failed with" <<
+        tpWarning(logContacts) << "Getting ContactBlockingCapabilities property failed with" <<
             op->errorName() << ":" << op->errorMessage();
         introspectContactList();
         return;
     }
 
-    debug() << "Got ContactBlockingCapabilities property";
+    tpDebug(logContacts) << "Got ContactBlockingCapabilities property";
 
     PendingVariant *pv = qobject_cast<PendingVariant*>(op);
 
@@ -717,14 +720,14 @@ void ContactManager::Roster::gotContactBlockingBlockedContacts(
     QDBusPendingReply<HandleIdentifierMap> reply = *watcher;
 
     if (watcher->isError()) {
-        warning() << "Getting initial ContactBlocking blocked "
+        tpWarning(logContacts) << "Getting initial ContactBlocking blocked "
             "contacts failed with" <<
             watcher->error().name() << ":" << watcher->error().message();
         introspectContactList();
         return;
     }
 
-    debug() << "Got initial ContactBlocking blocked contacts";
+    tpDebug(logContacts) << "Got initial ContactBlocking blocked contacts";
 
     gotContactBlockingInitialBlockedContacts = true;
 
@@ -776,7 +779,7 @@ void ContactManager::Roster::gotContactListProperties(PendingOperation *op)
         return;
     }
 
-    debug() << "Got ContactList properties";
+    tpDebug(logContacts) << "Got ContactList properties";
 
     PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
 
@@ -797,10 +800,10 @@ void ContactManager::Roster::gotContactListContacts(QDBusPendingCallWatcher *wat
     QDBusPendingReply<ContactAttributesMap> reply = *watcher;
 
     if (watcher->isError()) {
-        warning() << "Failed introspecting ContactList contacts";
+        tpWarning(logContacts) << "Failed introspecting ContactList contacts";
 
         contactListState = ContactListStateFailure;
-        debug() << "Setting state to failure";
+        tpDebug(logContacts) << "Setting state to failure";
         emit contactManager->stateChanged((Tp::ContactListState) contactListState);
 
         // We may have been in state Failure and then Success, and FeatureRoster is already ready
@@ -812,21 +815,21 @@ void ContactManager::Roster::gotContactListContacts(QDBusPendingCallWatcher *wat
         return;
     }
 
-    debug() << "Got initial ContactList contacts";
+    tpDebug(logContacts) << "Got initial ContactList contacts";
 
     gotContactListInitialContacts = true;
 
     ConnectionPtr conn(contactManager->connection());
-    ContactAttributesMap attrsMap = reply.value();
+    const ContactAttributesMap attrsMap = reply.value();
+    Features features = conn->contactFactory()->features();
     ContactAttributesMap::const_iterator begin = attrsMap.constBegin();
     ContactAttributesMap::const_iterator end = attrsMap.constEnd();
     for (ContactAttributesMap::const_iterator i = begin; i != end; ++i) {
         uint bareHandle = i.key();
-        QVariantMap attrs = i.value();
 
         ContactPtr contact = contactManager->ensureContact(ReferencedHandles(conn,
                     HandleTypeContact, UIntList() << bareHandle),
-                conn->contactFactory()->features(), attrs);
+                features, i.value());
         cachedAllKnownContacts.insert(contact);
         contactListContacts.insert(contact);
     }
@@ -867,7 +870,7 @@ void ContactManager::Roster::gotContactListContacts(QDBusPendingCallWatcher *wat
 void ContactManager::Roster::setStateSuccess()
 {
     if (contactManager->connection()->isValid()) {
-        debug() << "State is now success";
+        tpDebug(logContacts) << "State is now success";
         contactListState = ContactListStateSuccess;
         emit contactManager->stateChanged((Tp::ContactListState) contactListState);
     }
@@ -890,7 +893,7 @@ void ContactManager::Roster::onContactListStateChanged(uint state)
     contactListState = state;
 
     if (state == ContactListStateFailure) {
-        debug() << "State changed to failure, finishing roster introspection";
+        tpDebug(logContacts) << "State changed to failure, finishing roster introspection";
     }
 
     emit contactManager->stateChanged((Tp::ContactListState) state);
@@ -907,13 +910,13 @@ void ContactManager::Roster::onContactListStateChanged(uint state)
 void ContactManager::Roster::onContactListContactsChangedWithId(const Tp::ContactSubscriptionMap &changes,
         const Tp::HandleIdentifierMap &ids, const Tp::HandleIdentifierMap &removals)
 {
-    debug() << "Got ContactList.ContactsChangedWithID with" << changes.size() <<
+    tpDebug(logContacts) << "Got ContactList.ContactsChangedWithID with" << changes.size() <<
         "changes and" << removals.size() << "removals";
 
     gotContactListContactsChangedWithId = true;
 
     if (!gotContactListInitialContacts) {
-        debug() << "Ignoring ContactList changes until initial contacts are retrieved";
+        tpDebug(logContacts) << "Ignoring ContactList changes until initial contacts are retrieved";
         return;
     }
 
@@ -932,11 +935,11 @@ void ContactManager::Roster::onContactListContactsChanged(const Tp::ContactSubsc
         return;
     }
 
-    debug() << "Got ContactList.ContactsChanged with" << changes.size() <<
+    tpDebug(logContacts) << "Got ContactList.ContactsChanged with" << changes.size() <<
         "changes and" << removals.size() << "removals";
 
     if (!gotContactListInitialContacts) {
-        debug() << "Ignoring ContactList changes until initial contacts are retrieved";
+        tpDebug(logContacts) << "Ignoring ContactList changes until initial contacts are retrieved";
         return;
     }
 
@@ -973,11 +976,11 @@ void ContactManager::Roster::onContactListBlockedContactsConstructed(Tp::Pending
 
         ContactPtr contact = contactManager->lookupContactByHandle(bareHandle);
         if (!contact) {
-            warning() << "Unable to construct contact for handle" << bareHandle;
+            tpWarning(logContacts) << "Unable to construct contact for handle" << bareHandle;
             continue;
         }
 
-        debug() << "Contact" << contact->id() << "is now blocked";
+        tpDebug(logContacts) << "Contact" << contact->id() << "is now blocked";
         blockedContacts.insert(contact);
         newBlockedContacts.insert(contact);
         contact->setBlocked(true);
@@ -990,11 +993,11 @@ void ContactManager::Roster::onContactListBlockedContactsConstructed(Tp::Pending
 
         ContactPtr contact = contactManager->lookupContactByHandle(bareHandle);
         if (!contact) {
-            warning() << "Unable to construct contact for handle" << bareHandle;
+            tpWarning(logContacts) << "Unable to construct contact for handle" << bareHandle;
             continue;
         }
 
-        debug() << "Contact" << contact->id() << "is now unblocked";
+        tpDebug(logContacts) << "Contact" << contact->id() << "is now unblocked";
         blockedContacts.remove(contact);
         unblockedContacts.insert(contact);
         contact->setBlocked(false);
@@ -1036,7 +1039,7 @@ void ContactManager::Roster::onContactListNewContactsConstructed(Tp::PendingOper
 
         ContactPtr contact = contactManager->lookupContactByHandle(bareHandle);
         if (!contact) {
-            warning() << "Unable to construct contact for handle" << bareHandle;
+            tpWarning(logContacts) << "Unable to construct contact for handle" << bareHandle;
             continue;
         }
 
@@ -1067,12 +1070,12 @@ void ContactManager::Roster::onContactListNewContactsConstructed(Tp::PendingOper
     foreach (uint bareHandle, info.removals.keys()) {
         ContactPtr contact = contactManager->lookupContactByHandle(bareHandle);
         if (!contact) {
-            warning() << "Unable to find removed contact with handle" << bareHandle;
+            tpWarning(logContacts) << "Unable to find removed contact with handle" << bareHandle;
             continue;
         }
 
         if (!contactListContacts.contains(contact)) {
-            warning() << "Contact" << contact->id() << "removed from ContactList "
+            tpWarning(logContacts) << "Contact" << contact->id() << "removed from ContactList "
                 "but it wasn't present, ignoring.";
             continue;
         }
@@ -1172,7 +1175,7 @@ void ContactManager::Roster::gotContactListChannelHandle(PendingOperation *op)
 
     if (op->isError()) {
         // let's not fail, because the contact lists are not supported
-        debug() << "Unable to retrieve handle for" << channelId << "channel, ignoring";
+        tpDebug(logContacts) << "Unable to retrieve handle for" << channelId << "channel, ignoring";
         contactListChannels.remove(type);
         onContactListChannelReady();
         return;
@@ -1180,7 +1183,7 @@ void ContactManager::Roster::gotContactListChannelHandle(PendingOperation *op)
 
     if (ph->invalidNames().size() == 1) {
         // let's not fail, because the contact lists are not supported
-        debug() << "Unable to retrieve handle for" << channelId << "channel, ignoring";
+        tpDebug(logContacts) << "Unable to retrieve handle for" << channelId << "channel, ignoring";
         contactListChannels.remove(type);
         onContactListChannelReady();
         return;
@@ -1188,7 +1191,7 @@ void ContactManager::Roster::gotContactListChannelHandle(PendingOperation *op)
 
     Q_ASSERT(ph->handles().size() == 1);
 
-    debug() << "Got handle for" << channelId << "channel";
+    tpDebug(logContacts) << "Got handle for" << channelId << "channel";
 
     if (!usingFallbackContactList) {
         Q_ASSERT(type == ChannelInfo::TypeDeny);
@@ -1199,7 +1202,7 @@ void ContactManager::Roster::gotContactListChannelHandle(PendingOperation *op)
     ReferencedHandles handle = ph->handles();
     contactListChannels[type].handle = handle;
 
-    debug() << "Requesting channel for" << channelId << "channel";
+    tpDebug(logContacts) << "Requesting channel for" << channelId << "channel";
     QVariantMap request;
     request.insert(TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType"),
             TP_QT_IFACE_CHANNEL_TYPE_CONTACT_LIST);
@@ -1219,7 +1222,7 @@ void ContactManager::Roster::gotContactListChannelHandle(PendingOperation *op)
 void ContactManager::Roster::gotContactListChannel(PendingOperation *op)
 {
     if (op->isError()) {
-        debug() << "Unable to create channel, ignoring";
+        tpDebug(logContacts) << "Unable to create channel, ignoring";
         onContactListChannelReady();
         return;
     }
@@ -1264,7 +1267,7 @@ void ContactManager::Roster::onContactListChannelReady()
     } else if (++contactListChannelsReady == ChannelInfo::LastType) {
         if (contactListChannels.isEmpty()) {
             contactListState = ContactListStateFailure;
-            debug() << "State is failure, roster not supported";
+            tpDebug(logContacts) << "State is failure, roster not supported";
             emit contactManager->stateChanged((Tp::ContactListState) contactListState);
 
             Q_ASSERT(introspectPendingOp);
@@ -1322,7 +1325,8 @@ void ContactManager::Roster::gotContactListGroupsProperties(PendingOperation *op
     }
 
     if (op->isError()) {
-        warning() << "Getting contact list groups properties failed:" << op->errorName() << '-'
+        tpWarning(logContacts) <<
+            "Getting contact list groups properties failed:" << op->errorName() << '-'
             << op->errorMessage();
 
         introspectGroupsPendingOp->setFinishedWithError(
@@ -1332,7 +1336,7 @@ void ContactManager::Roster::gotContactListGroupsProperties(PendingOperation *op
         return;
     }
 
-    debug() << "Got contact list groups properties";
+    tpDebug(logContacts) << "Got contact list groups properties";
     PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
 
     QVariantMap props = pvm->result();
@@ -1357,7 +1361,8 @@ void ContactManager::Roster::onContactListContactsUpgraded(PendingOperation *op)
     Q_ASSERT(introspectGroupsPendingOp != NULL);
 
     if (op->isError()) {
-        warning() << "Upgrading contacts with group membership failed:" << op->errorName() << '-'
+        tpWarning(logContacts) <<
+            "Upgrading contacts with group membership failed:" << op->errorName() << '-'
             << op->errorMessage();
 
         introspectGroupsPendingOp->setFinishedWithError(
@@ -1429,10 +1434,10 @@ void ContactManager::Roster::gotChannels(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<QVariant> reply = *watcher;
 
     if (!reply.isError()) {
-        debug() << "Got channels";
+        tpDebug(logContacts) << "Got channels";
         onNewChannels(qdbus_cast<ChannelDetailsList>(reply.value()));
     } else {
-        warning().nospace() << "Getting channels failed with " <<
+        tpWarning(logContacts).nospace() << "Getting channels failed with " <<
             reply.error().name() << ":" << reply.error().message();
     }
 
@@ -1451,19 +1456,19 @@ void ContactManager::Roster::onStoredChannelMembersChanged(
         const Channel::GroupMemberChangeDetails &details)
 {
     if (!groupLocalPendingMembersAdded.isEmpty()) {
-        warning() << "Found local pending contacts on stored list";
+        tpWarning(logContacts) << "Found local pending contacts on stored list";
     }
 
     if (!groupRemotePendingMembersAdded.isEmpty()) {
-        warning() << "Found remote pending contacts on stored list";
+        tpWarning(logContacts) << "Found remote pending contacts on stored list";
     }
 
     foreach (ContactPtr contact, groupMembersAdded) {
-        debug() << "Contact" << contact->id() << "on stored list";
+        tpDebug(logContacts) << "Contact" << contact->id() << "on stored list";
     }
 
     foreach (ContactPtr contact, groupMembersRemoved) {
-        debug() << "Contact" << contact->id() << "removed from stored list";
+        tpDebug(logContacts) << "Contact" << contact->id() << "removed from stored list";
     }
 
     // Perform the needed computation for allKnownContactsChanged
@@ -1480,21 +1485,21 @@ void ContactManager::Roster::onSubscribeChannelMembersChanged(
         const Channel::GroupMemberChangeDetails &details)
 {
     if (!groupLocalPendingMembersAdded.isEmpty()) {
-        warning() << "Found local pending contacts on subscribe list";
+        tpWarning(logContacts) << "Found local pending contacts on subscribe list";
     }
 
     foreach (ContactPtr contact, groupMembersAdded) {
-        debug() << "Contact" << contact->id() << "on subscribe list";
+        tpDebug(logContacts) << "Contact" << contact->id() << "on subscribe list";
         contact->setSubscriptionState(SubscriptionStateYes);
     }
 
     foreach (ContactPtr contact, groupRemotePendingMembersAdded) {
-        debug() << "Contact" << contact->id() << "added to subscribe list";
+        tpDebug(logContacts) << "Contact" << contact->id() << "added to subscribe list";
         contact->setSubscriptionState(SubscriptionStateAsk);
     }
 
     foreach (ContactPtr contact, groupMembersRemoved) {
-        debug() << "Contact" << contact->id() << "removed from subscribe list";
+        tpDebug(logContacts) << "Contact" << contact->id() << "removed from subscribe list";
         contact->setSubscriptionState(SubscriptionStateNo);
     }
 
@@ -1512,21 +1517,21 @@ void ContactManager::Roster::onPublishChannelMembersChanged(
         const Channel::GroupMemberChangeDetails &details)
 {
     if (!groupRemotePendingMembersAdded.isEmpty()) {
-        warning() << "Found remote pending contacts on publish list";
+        tpWarning(logContacts) << "Found remote pending contacts on publish list";
     }
 
     foreach (ContactPtr contact, groupMembersAdded) {
-        debug() << "Contact" << contact->id() << "on publish list";
+        tpDebug(logContacts) << "Contact" << contact->id() << "on publish list";
         contact->setPublishState(SubscriptionStateYes);
     }
 
     foreach (ContactPtr contact, groupLocalPendingMembersAdded) {
-        debug() << "Contact" << contact->id() << "added to publish list";
+        tpDebug(logContacts) << "Contact" << contact->id() << "added to publish list";
         contact->setPublishState(SubscriptionStateAsk, details.message());
     }
 
     foreach (ContactPtr contact, groupMembersRemoved) {
-        debug() << "Contact" << contact->id() << "removed from publish list";
+        tpDebug(logContacts) << "Contact" << contact->id() << "removed from publish list";
         contact->setPublishState(SubscriptionStateNo);
     }
 
@@ -1548,20 +1553,20 @@ void ContactManager::Roster::onDenyChannelMembersChanged(
         const Channel::GroupMemberChangeDetails &details)
 {
     if (!groupLocalPendingMembersAdded.isEmpty()) {
-        warning() << "Found local pending contacts on deny list";
+        tpWarning(logContacts) << "Found local pending contacts on deny list";
     }
 
     if (!groupRemotePendingMembersAdded.isEmpty()) {
-        warning() << "Found remote pending contacts on deny list";
+        tpWarning(logContacts) << "Found remote pending contacts on deny list";
     }
 
     foreach (ContactPtr contact, groupMembersAdded) {
-        debug() << "Contact" << contact->id() << "added to deny list";
+        tpDebug(logContacts) << "Contact" << contact->id() << "added to deny list";
         contact->setBlocked(true);
     }
 
     foreach (ContactPtr contact, groupMembersRemoved) {
-        debug() << "Contact" << contact->id() << "removed from deny list";
+        tpDebug(logContacts) << "Contact" << contact->id() << "removed from deny list";
         contact->setBlocked(false);
     }
 
@@ -1614,7 +1619,7 @@ void ContactManager::Roster::onContactListGroupRemoved(Tp::DBusProxy *proxy,
 
 void ContactManager::Roster::introspectContactBlocking()
 {
-    debug() << "Requesting ContactBlockingCapabilities property";
+    tpDebug(logContacts) << "Requesting ContactBlockingCapabilities property";
 
     ConnectionPtr conn(contactManager->connection());
 
@@ -1649,7 +1654,7 @@ void ContactManager::Roster::introspectContactBlockingBlockedContacts()
 
 void ContactManager::Roster::introspectContactList()
 {
-    debug() << "Requesting ContactList properties";
+    tpDebug(logContacts) << "Requesting ContactList properties";
 
     ConnectionPtr conn(contactManager->connection());
 
@@ -1770,7 +1775,8 @@ void ContactManager::Roster::processContactListGroupsUpdates()
         foreach (uint bareHandle, info.contacts) {
             ContactPtr contact = contactManager->lookupContactByHandle(bareHandle);
             if (!contact) {
-                warning() << "contact with handle" << bareHandle << "was added to a group but "
+                tpWarning(logContacts) <<
+                    "contact with handle" << bareHandle << "was added to a group but "
                     "never added to the contact list, ignoring";
                 continue;
             }
@@ -1787,7 +1793,8 @@ void ContactManager::Roster::processContactListGroupsUpdates()
         foreach (uint bareHandle, info.contacts) {
             ContactPtr contact = contactManager->lookupContactByHandle(bareHandle);
             if (!contact) {
-                warning() << "contact with handle" << bareHandle << "was removed from a group but "
+                tpWarning(logContacts) <<
+                    "contact with handle" << bareHandle << "was removed from a group but "
                     "never added to the contact list, ignoring";
                 continue;
             }
@@ -31,6 +31,7 @@
 #include <TelepathyQt/AvatarData>
 #include <TelepathyQt/Connection>
 #include <TelepathyQt/ConnectionLowlevel>
+#include <TelepathyQt/ContactCapabilities>
 #include <TelepathyQt/ContactFactory>
 #include <TelepathyQt/PendingChannel>
 #include <TelepathyQt/PendingContactAttributes>
@@ -57,6 +58,25 @@ struct TP_QT_NO_EXPORT ContactManager::Private
     Features realFeatures(const Features &features);
     QSet<QString> interfacesForFeatures(const Features &features);
 
+    // contact attributes
+    struct AttributesChunk
+    {
+        AttributesChunk()
+        {
+        }
+
+        AttributesChunk(const QStringList &interfaces)
+            : interfaces(interfaces)
+        {
+        }
+
+        UIntList handles;
+        QStringList interfaces;
+        QList<PendingAttributes *> requests;
+    };
+
+    void requestNextAttributesChunks();
+
     ContactManager *parent;
     WeakPtr<Connection> connection;
     ContactManager::Roster *roster;
@@ -72,14 +92,37 @@ struct TP_QT_NO_EXPORT ContactManager::Private
 
     // contact info
     PendingRefreshContactInfo *refreshInfoOp;
+
+    // contact attributes
+    QList<PendingAttributes *> attributesQueue;
+    QQueue<AttributesChunk> attributesChunksQueue;
+    QHash<PendingOperation *, AttributesChunk> attributesChunksInFlight;
+    int attributesChunkSize;
+
+    // values shared by the contacts which have identical ones
+    ContactCapabilities specificCapabilities;
+    bool hasConnectionCapabilities;
+    ContactCapabilities connectionCapabilities;
+    RequestableChannelClassSpecList connectionCapabilitiesSpecs;
+    QList<QPair<RequestableChannelClassList, ContactCapabilities> > sharedCapabilities;
+    QList<QStringList> sharedClientTypes;
 };
 
+// Keep the next chunk queued in the CM while the previous reply is being processed
+static const int maxAttributesChunksInFlight = 2;
+
+// Distinct capabilities and client types kept for sharing between contacts. Most rosters
+// only have a handful of them, so this bounds the linear lookups for the ones which don't
+static const int maxSharedContactValues = 32;
+
 ContactManager::Private::Private(ContactManager *parent, Connection *connection)
     : parent(parent),
       connection(connection),
       roster(new ContactManager::Roster(parent)),
       requestAvatarsIdle(false),
-      refreshInfoOp(0)
+      refreshInfoOp(0),
+      attributesChunkSize(500),
+      hasConnectionCapabilities(false)
 {
 }
 
@@ -138,6 +181,82 @@ QSet<QString> ContactManager::Private::interfacesForFeatures(const Features &fea
     return ret;
 }
 
+void ContactManager::Private::requestNextAttributesChunks()
+{
+    ConnectionLowlevelPtr connLowlevel = parent->connection()->lowlevel();
+
+    while (attributesChunksInFlight.size() < maxAttributesChunksInFlight &&
+           !attributesChunksQueue.isEmpty()) {
+        AttributesChunk chunk = attributesChunksQueue.dequeue();
+        PendingOperation *op = connLowlevel->contactAttributes(chunk.handles,
+                chunk.interfaces, true);
+        attributesChunksInFlight.insert(op, chunk);
+        parent->connect(op,
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(onAttributesChunkFinished(Tp::PendingOperation*)));
+    }
+}
+
+ContactManager::PendingAttributes::PendingAttributes(const ConnectionPtr &conn,
+        const UIntList &handles, const QStringList &interfaces)
+    : PendingOperation(conn),
+      mHandles(handles),
+      mInterfaces(interfaces),
+      mPendingChunks(0)
+{
+}
+
+ContactManager::PendingAttributes::~PendingAttributes()
+{
+}
+
+void ContactManager::PendingAttributes::addPendingChunk()
+{
+    ++mPendingChunks;
+}
+
+void ContactManager::PendingAttributes::chunkFinished(const ReferencedHandles &validHandles,
+        const ContactAttributesMap &attributes)
+{
+    mValidHandles.append(validHandles);
+    if (mAttributes.isEmpty()) {
+        // the common case of a request served by a single call, share the reply
+        mAttributes = attributes;
+    } else {
+        for (ContactAttributesMap::const_iterator i = attributes.constBegin();
+                i != attributes.constEnd(); ++i) {
+            mAttributes.insert(i.key(), i.value());
+        }
+    }
+
+    checkFinished();
+}
+
+void ContactManager::PendingAttributes::chunkFailed(const QString &errorName,
+        const QString &errorMessage)
+{
+    if (mErrorName.isEmpty()) {
+        mErrorName = errorName;
+        mErrorMessage = errorMessage;
+    }
+
+    checkFinished();
+}
+
+void ContactManager::PendingAttributes::checkFinished()
+{
+    Q_ASSERT(mPendingChunks > 0);
+    if (--mPendingChunks > 0) {
+        return;
+    }
+
+    if (!mErrorName.isEmpty()) {
+        setFinishedWithError(mErrorName, mErrorMessage);
+    } else {
+        setFinished();
+    }
+}
+
 ContactManager::PendingRefreshContactInfo::PendingRefreshContactInfo(const ConnectionPtr &conn)
     : PendingOperation(conn),
       mConn(conn)
@@ -169,7 +288,8 @@ void ContactManager::PendingRefreshContactInfo::refreshInfo()
         return;
     }
 
-    debug() << "Calling ContactInfo.RefreshContactInfo for" << mToRequest.size() << "handles";
+    tpDebug(logContacts) << "Calling ContactInfo.RefreshContactInfo for" << mToRequest.size() <<
+        "handles";
     Client::ConnectionInterfaceContactInfoInterface *contactInfoInterface =
         mConn->interface<Client::ConnectionInterfaceContactInfoInterface>();
     Q_ASSERT(contactInfoInterface);
@@ -184,11 +304,11 @@ void ContactManager::PendingRefreshContactInfo::refreshInfo()
 void ContactManager::PendingRefreshContactInfo::onRefreshInfoFinished(PendingOperation *op)
 {
     if (op->isError()) {
-        warning() << "ContactInfo.RefreshContactInfo failed with" <<
+        tpWarning(logContacts) << "ContactInfo.RefreshContactInfo failed with" <<
             op->errorName() << "-" << op->errorMessage();
         setFinishedWithError(op->errorName(), op->errorMessage());
     } else {
-        debug() << "Got reply to ContactInfo.RefreshContactInfo";
+        tpDebug(logContacts) << "Got reply to ContactInfo.RefreshContactInfo";
         setFinished();
     }
 }
@@ -261,7 +381,8 @@ Features ContactManager::supportedFeatures() const
             }
         }
 
-        debug() << mPriv->supportedFeatures.size() << "contact features supported using" << this;
+        tpDebug(logContacts) << mPriv->supportedFeatures.size() <<
+            "contact features supported using" << this;
     }
 
     return mPriv->supportedFeatures;
@@ -308,7 +429,7 @@ ContactListState ContactManager::state() const
 Contacts ContactManager::allKnownContacts() const
 {
     if (!connection()->isReady(Connection::FeatureRoster)) {
-        warning() << "Calling allKnownContacts() before FeatureRoster is ready";
+        tpWarning(logContacts) << "Calling allKnownContacts() before FeatureRoster is ready";
         return Contacts();
     }
 
@@ -1244,9 +1365,48 @@ PendingOperation *ContactManager::refreshContactInfo(const QList<ContactPtr> &co
     return mPriv->refreshInfoOp;
 }
 
+/**
+ * Return the maximum number of contacts whose attributes are requested from the connection
+ * manager in a single call.
+ *
+ * \return The chunk size, or 0 if requests are never split.
+ * \sa setContactAttributesChunkSize()
+ */
+int ContactManager::contactAttributesChunkSize() const
+{
+    return mPriv->attributesChunkSize;
+}
+
+/**
+ * Set the maximum number of contacts whose attributes are requested from the connection
+ * manager in a single call.
+ *
+ * All contactsForHandles(), contactsForIdentifiers() and upgradeContacts() requests made
+ * during the same main loop iteration are merged, and the attributes of their contacts are
+ * retrieved together. When the merged request contains more than \a chunkSize contacts, it is
+ * split into several calls which are sent one after the other, so that neither the bus nor
+ * the connection manager has to deal with one huge message. Each PendingContacts finishes as
+ * soon as the calls covering its own contacts have returned.
+ *
+ * The default is 500. Use 0 to never split requests.
+ *
+ * \param chunkSize The maximum number of contacts per call.
+ * \sa contactAttributesChunkSize()
+ */
+void ContactManager::setContactAttributesChunkSize(int chunkSize)
+{
+    if (chunkSize < 0) {
+        tpWarning(logContacts) <<
+            "ContactManager::setContactAttributesChunkSize() called with negative size";
+        return;
+    }
+
+    mPriv->attributesChunkSize = chunkSize;
+}
+
 void ContactManager::onAliasesChanged(const AliasPairList &aliases)
 {
-    debug() << "Got AliasesChanged for" << aliases.size() << "contacts";
+    tpDebug(logContacts) << "Got AliasesChanged for" << aliases.size() << "contacts";
 
     foreach (AliasPair pair, aliases) {
         ContactPtr contact = lookupContactByHandle(pair.handle);
@@ -1297,14 +1457,14 @@ void ContactManager::doRequestAvatars()
     }
 
     if (found > 0) {
-        debug() << "Avatar(s) found in cache for" << found << "contact(s)";
+        tpDebug(logContacts) << "Avatar(s) found in cache for" << found << "contact(s)";
     }
 
     if (found == contacts.size()) {
         return;
     }
 
-    debug() << "Requesting avatar(s) for" << contacts.size() - found << "contact(s)";
+    tpDebug(logContacts) << "Requesting avatar(s) for" << contacts.size() - found << "contact(s)";
 
     Client::ConnectionInterfaceAvatarsInterface *avatarsInterface =
         connection()->interface<Client::ConnectionInterfaceAvatarsInterface>();
@@ -1317,7 +1477,7 @@ void ContactManager::doRequestAvatars()
 
 void ContactManager::onAvatarUpdated(uint handle, const QString &token)
 {
-    debug() << "Got AvatarUpdate for contact with handle" << handle;
+    tpDebug(logContacts) << "Got AvatarUpdate for contact with handle" << handle;
 
     ContactPtr contact = lookupContactByHandle(handle);
     if (contact) {
@@ -1331,15 +1491,15 @@ void ContactManager::onAvatarRetrieved(uint handle, const QString &token,
     QString avatarFileName;
     QString mimeTypeFileName;
 
-    debug() << "Got AvatarRetrieved for contact with handle" << handle;
+    tpDebug(logContacts) << "Got AvatarRetrieved for contact with handle" << handle;
 
     bool success = mPriv->buildAvatarFileName(token, true, avatarFileName,
         mimeTypeFileName);
 
     if (success) {
-        debug() << "Write avatar in cache for handle" << handle;
-        debug() << "Filename:" << avatarFileName;
-        debug() << "MimeType:" << mimeType;
+        tpDebug(logContacts) << "Write avatar in cache for handle" << handle;
+        tpDebug(logContacts) << "Filename:" << avatarFileName;
+        tpDebug(logContacts) << "MimeType:" << mimeType;
 
         if (!QFile::exists(mimeTypeFileName)) {
             QTemporaryFile mimeTypeFile(mimeTypeFileName);
@@ -1373,7 +1533,7 @@ void ContactManager::onAvatarRetrieved(uint handle, const QString &token,
 
 void ContactManager::onPresencesChanged(const SimpleContactPresences &presences)
 {
-    debug() << "Got PresencesChanged for" << presences.size() << "contacts";
+    tpDebug(logContacts) << "Got PresencesChanged for" << presences.size() << "contacts";
 
     foreach (uint handle, presences.keys()) {
         ContactPtr contact = lookupContactByHandle(handle);
@@ -1386,7 +1546,7 @@ void ContactManager::onPresencesChanged(const SimpleContactPresences &presences)
 
 void ContactManager::onCapabilitiesChanged(const ContactCapabilitiesMap &caps)
 {
-    debug() << "Got ContactCapabilitiesChanged for" << caps.size() << "contacts";
+    tpDebug(logContacts) << "Got ContactCapabilitiesChanged for" << caps.size() << "contacts";
 
     foreach (uint handle, caps.keys()) {
         ContactPtr contact = lookupContactByHandle(handle);
@@ -1399,7 +1559,7 @@ void ContactManager::onCapabilitiesChanged(const ContactCapabilitiesMap &caps)
 
 void ContactManager::onLocationUpdated(uint handle, const QVariantMap &location)
 {
-    debug() << "Got LocationUpdated for contact with handle" << handle;
+    tpDebug(logContacts) << "Got LocationUpdated for contact with handle" << handle;
 
     ContactPtr contact = lookupContactByHandle(handle);
 
@@ -1410,7 +1570,7 @@ void ContactManager::onLocationUpdated(uint handle, const QVariantMap &location)
 
 void ContactManager::onContactInfoChanged(uint handle, const Tp::ContactInfoFieldList &info)
 {
-    debug() << "Got ContactInfoChanged for contact with handle" << handle;
+    tpDebug(logContacts) << "Got ContactInfoChanged for contact with handle" << handle;
 
     ContactPtr contact = lookupContactByHandle(handle);
 
@@ -1421,7 +1581,7 @@ void ContactManager::onContactInfoChanged(uint handle, const Tp::ContactInfoFiel
 
 void ContactManager::onClientTypesUpdated(uint handle, const QStringList &clientTypes)
 {
-    debug() << "Got ClientTypesUpdated for contact with handle" << handle;
+    tpDebug(logContacts) << "Got ClientTypesUpdated for contact with handle" << handle;
 
     ContactPtr contact = lookupContactByHandle(handle);
 
@@ -1438,6 +1598,89 @@ void ContactManager::doRefreshInfo()
     op->refreshInfo();
 }
 
+void ContactManager::doRequestAttributes()
+{
+    QList<PendingAttributes *> requests = mPriv->attributesQueue;
+    mPriv->attributesQueue.clear();
+
+    QSet<QString> interfacesSet;
+    foreach (PendingAttributes *request, requests) {
+        interfacesSet.unite(request->interfaces().toSet());
+    }
+    QStringList interfaces = interfacesSet.toList();
+
+    // Split the union of the requested handles in chunks, each request then waits for the
+    // chunks holding its handles only
+    QList<Private::AttributesChunk> chunks;
+    QHash<uint, int> chunkForHandle;
+    foreach (PendingAttributes *request, requests) {
+        QSet<int> requestChunks;
+        foreach (uint handle, request->handles()) {
+            int index = chunkForHandle.value(handle, -1);
+            if (index < 0) {
+                if (chunks.isEmpty() || (mPriv->attributesChunkSize > 0 &&
+                            chunks.last().handles.size() >= mPriv->attributesChunkSize)) {
+                    chunks.append(Private::AttributesChunk(interfaces));
+                }
+                index = chunks.size() - 1;
+                chunks[index].handles.append(handle);
+                chunkForHandle.insert(handle, index);
+            }
+
+            if (!requestChunks.contains(index)) {
+                requestChunks.insert(index);
+                chunks[index].requests.append(request);
+                request->addPendingChunk();
+            }
+        }
+    }
+
+    tpDebug(logContacts) << "Requesting attributes for" << chunkForHandle.size() <<
+        "contacts from" <<
+        requests.size() << "requests in" << chunks.size() << "calls";
+
+    foreach (const Private::AttributesChunk &chunk, chunks) {
+        mPriv->attributesChunksQueue.enqueue(chunk);
+    }
+    mPriv->requestNextAttributesChunks();
+}
+
+void ContactManager::onAttributesChunkFinished(PendingOperation *op)
+{
+    Private::AttributesChunk chunk = mPriv->attributesChunksInFlight.take(op);
+
+    if (op->isError()) {
+        tpWarning(logContacts).nospace() << "Getting contact attributes failed with " <<
+            op->errorName() << ": " << op->errorMessage();
+        foreach (PendingAttributes *request, chunk.requests) {
+            request->chunkFailed(op->errorName(), op->errorMessage());
+        }
+    } else {
+        PendingContactAttributes *pendingAttributes =
+            qobject_cast<PendingContactAttributes *>(op);
+        ReferencedHandles validHandles = pendingAttributes->validHandles();
+        ContactAttributesMap attributes = pendingAttributes->attributes();
+        foreach (PendingAttributes *request, chunk.requests) {
+            request->chunkFinished(validHandles, attributes);
+        }
+    }
+
+    mPriv->requestNextAttributesChunks();
+}
+
+ContactManager::PendingAttributes *ContactManager::contactAttributes(const UIntList &handles,
+        const QStringList &interfaces)
+{
+    Q_ASSERT(!handles.isEmpty());
+
+    PendingAttributes *op = new PendingAttributes(connection(), handles, interfaces);
+    if (mPriv->attributesQueue.isEmpty()) {
+        QTimer::singleShot(0, this, SLOT(doRequestAttributes()));
+    }
+    mPriv->attributesQueue.append(op);
+    return op;
+}
+
 ContactPtr ContactManager::ensureContact(const ReferencedHandles &handle,
         const Features &features, const QVariantMap &attributes)
 {
@@ -1454,6 +1697,53 @@ ContactPtr ContactManager::ensureContact(const ReferencedHandles &handle,
     return contact;
 }
 
+ContactCapabilities ContactManager::defaultContactCapabilities()
+{
+    if (supportedFeatures().contains(Contact::FeatureCapabilities)) {
+        if (!mPriv->specificCapabilities.isSpecificToContact()) {
+            mPriv->specificCapabilities = ContactCapabilities(true);
+        }
+        return mPriv->specificCapabilities;
+    }
+
+    RequestableChannelClassSpecList specs = connection()->capabilities().allClassSpecs();
+    if (!mPriv->hasConnectionCapabilities || mPriv->connectionCapabilitiesSpecs != specs) {
+        mPriv->hasConnectionCapabilities = true;
+        mPriv->connectionCapabilities = ContactCapabilities(specs, false);
+        mPriv->connectionCapabilitiesSpecs = specs;
+    }
+    return mPriv->connectionCapabilities;
+}
+
+ContactCapabilities ContactManager::sharedCapabilities(const RequestableChannelClassList &rccs)
+{
+    for (int i = 0; i < mPriv->sharedCapabilities.size(); ++i) {
+        if (mPriv->sharedCapabilities[i].first == rccs) {
+            return mPriv->sharedCapabilities[i].second;
+        }
+    }
+
+    ContactCapabilities caps(rccs, true);
+    if (mPriv->sharedCapabilities.size() < maxSharedContactValues) {
+        mPriv->sharedCapabilities.append(qMakePair(rccs, caps));
+    }
+    return caps;
+}
+
+QStringList ContactManager::sharedClientTypes(const QStringList &clientTypes)
+{
+    foreach (const QStringList &shared, mPriv->sharedClientTypes) {
+        if (shared == clientTypes) {
+            return shared;
+        }
+    }
+
+    if (mPriv->sharedClientTypes.size() < maxSharedContactValues) {
+        mPriv->sharedClientTypes.append(clientTypes);
+    }
+    return clientTypes;
+}
+
 ContactPtr ContactManager::ensureContact(uint bareHandle, const QString &id,
         const Features &features)
 {
@@ -1497,7 +1787,8 @@ QString ContactManager::featureToInterface(const Feature &feature)
     } else if (feature == Contact::FeatureClientTypes) {
         return TP_QT_IFACE_CONNECTION_INTERFACE_CLIENT_TYPES;
     } else {
-        warning() << "ContactManager doesn't know which interface corresponds to feature"
+        tpWarning(logContacts) <<
+            "ContactManager doesn't know which interface corresponds to feature"
             << feature;
         return QString();
     }
@@ -1571,7 +1862,7 @@ void ContactManager::ensureTracking(const Feature &feature)
         // nothing to do here, but we don't want to warn
         ;
     } else {
-        warning() << " Unknown feature" << feature
+        tpWarning(logContacts) << " Unknown feature" << feature
             << "when trying to figure out how to connect change notification!";
     }
 
@@ -125,6 +125,9 @@ public:
     PendingContacts *upgradeContacts(const QList<ContactPtr> &contacts,
             const Features &features);
 
+    int contactAttributesChunkSize() const;
+    void setContactAttributesChunkSize(int chunkSize);
+
     void requestContactAvatars(const QList<ContactPtr> &contacts);
 
     PendingOperation *refreshContactInfo(const QList<ContactPtr> &contact);
@@ -158,12 +161,17 @@ private Q_SLOTS:
     TP_QT_NO_EXPORT void onContactInfoChanged(uint, const Tp::ContactInfoFieldList &);
     TP_QT_NO_EXPORT void onClientTypesUpdated(uint, const QStringList &);
     TP_QT_NO_EXPORT void doRefreshInfo();
+    TP_QT_NO_EXPORT void doRequestAttributes();
+    TP_QT_NO_EXPORT void onAttributesChunkFinished(Tp::PendingOperation *op);
 
 private:
+    class PendingAttributes;
     class PendingRefreshContactInfo;
     class Roster;
     friend class Channel;
     friend class Connection;
+    friend class Contact;
+    friend class PendingAttributes;
     friend class PendingContacts;
     friend class PendingRefreshContactInfo;
     friend class Roster;
@@ -178,6 +186,10 @@ private:
     TP_QT_NO_EXPORT ContactPtr ensureContact(uint bareHandle,
             const QString &id, const Features &features);
 
+    TP_QT_NO_EXPORT ContactCapabilities defaultContactCapabilities();
+    TP_QT_NO_EXPORT ContactCapabilities sharedCapabilities(const RequestableChannelClassList &rccs);
+    TP_QT_NO_EXPORT QStringList sharedClientTypes(const QStringList &clientTypes);
+
     TP_QT_NO_EXPORT static QString featureToInterface(const Feature &feature);
     TP_QT_NO_EXPORT void ensureTracking(const Feature &feature);
 
@@ -187,6 +199,9 @@ private:
 
     TP_QT_NO_EXPORT PendingOperation *refreshContactInfo(Contact *contact);
 
+    TP_QT_NO_EXPORT PendingAttributes *contactAttributes(const UIntList &handles,
+            const QStringList &interfaces);
+
     struct Private;
     friend struct Private;
     Private *mPriv;
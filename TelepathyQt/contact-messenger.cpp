@@ -69,14 +69,9 @@ PendingSendMessage *ContactMessenger::Private::sendMessage(const Message &messag
 
     PendingSendMessage *op = new PendingSendMessage(ContactMessengerPtr(parent), message);
 
-    Tp::MessagePartList parts;
-    foreach (const Tp::MessagePart &part, message.parts()) {
-        parts << static_cast<QMap<QString, QDBusVariant> >(part);
-    }
-
     connect(new QDBusPendingCallWatcher(
                 cdMessagesInterface->SendMessage(QDBusObjectPath(account->objectPath()),
-                    contactIdentifier, parts, (uint) flags)),
+                    contactIdentifier, message.parts(), (uint) flags)),
             SIGNAL(finished(QDBusPendingCallWatcher*)),
             op,
             SLOT(onCDMessageSent(QDBusPendingCallWatcher*)));
@@ -104,7 +99,7 @@ ContactMessengerPtr ContactMessenger::create(const AccountPtr &account,
         const ContactPtr &contact)
 {
     if (!contact) {
-        warning() << "Contact used to create a ContactMessenger object must be "
+        tpWarning(logContacts) << "Contact used to create a ContactMessenger object must be "
             "valid";
         return ContactMessengerPtr();
     }
@@ -123,7 +118,8 @@ ContactMessengerPtr ContactMessenger::create(const AccountPtr &account,
         const QString &contactIdentifier)
 {
     if (contactIdentifier.isEmpty()) {
-        warning() << "Contact identifier used to create a ContactMessenger object must be "
+        tpWarning(logContacts) <<
+            "Contact identifier used to create a ContactMessenger object must be "
             "non-empty";
         return ContactMessengerPtr();
     }
@@ -51,6 +51,10 @@ struct TP_QT_NO_EXPORT ContactSearchChannel::Private
     void processSearchStateChangeQueue();
     void processSearchResultQueue();
 
+    int mergeSearchResult(const ContactSearchResultMap &result);
+    void dropFetchedResults();
+    void continueSearchIfBelowThreshold();
+
     struct SearchStateChangeInfo
     {
         SearchStateChangeInfo(uint state, const QString &errorName,
@@ -84,6 +88,18 @@ struct TP_QT_NO_EXPORT ContactSearchChannel::Private
     QQueue<SearchStateChangeInfo> searchStateChangeQueue;
     QQueue<ContactSearchResultMap> searchResultQueue;
     bool processingSignalsQueue;
+
+    // Merged result set, in arrival order and deduplicated by identifier. The first
+    // droppedResults results were fetched and dropped already, so positions in the result set
+    // are offset by that much in resultIdentifiers.
+    bool resolveContactsOnReceipt;
+    uint autoContinueThreshold;
+    uint resultBufferSize;
+    bool moreRequested;
+    QStringList resultIdentifiers;
+    QHash<QString, ContactInfoFieldList> resultInfo;
+    int droppedResults;
+    int resultCursor;
 };
 
 ContactSearchChannel::Private::Private(ContactSearchChannel *parent,
@@ -95,7 +111,13 @@ ContactSearchChannel::Private::Private(ContactSearchChannel *parent,
       readinessHelper(parent->readinessHelper()),
       searchState(ChannelContactSearchStateNotStarted),
       limit(0),
-      processingSignalsQueue(false)
+      processingSignalsQueue(false),
+      resolveContactsOnReceipt(true),
+      autoContinueThreshold(0),
+      resultBufferSize(0),
+      moreRequested(false),
+      droppedResults(0),
+      resultCursor(0)
 {
     ReadinessHelper::Introspectables introspectables;
 
@@ -192,6 +214,8 @@ void ContactSearchChannel::Private::processSearchStateChangeQueue()
     const SearchStateChangeInfo &info = searchStateChangeQueue.dequeue();
 
     searchState = info.state;
+    moreRequested = false;
+    continueSearchIfBelowThreshold();
     emit parent->searchStateChanged(
             static_cast<ChannelContactSearchState>(info.state), info.errorName,
             SearchStateChangeDetails(info.details));
@@ -203,7 +227,17 @@ void ContactSearchChannel::Private::processSearchStateChangeQueue()
 void ContactSearchChannel::Private::processSearchResultQueue()
 {
     const ContactSearchResultMap &result = searchResultQueue.first();
-    if (!result.isEmpty()) {
+    int added = mergeSearchResult(result);
+    if (added > 0) {
+        emit parent->searchResultsAvailable(added);
+    }
+
+    if (!resolveContactsOnReceipt) {
+        searchResultQueue.dequeue();
+
+        processingSignalsQueue = false;
+        processSignalsQueue();
+    } else if (!result.isEmpty()) {
         ContactManagerPtr manager = parent->connection()->contactManager();
         PendingContacts *pendingContacts = manager->contactsForIdentifiers(
                 result.keys());
@@ -220,6 +254,63 @@ void ContactSearchChannel::Private::processSearchResultQueue()
     }
 }
 
+int ContactSearchChannel::Private::mergeSearchResult(const ContactSearchResultMap &result)
+{
+    int added = 0;
+    for (ContactSearchResultMap::const_iterator it = result.constBegin();
+                                                it != result.constEnd();
+                                                ++it) {
+        QHash<QString, ContactInfoFieldList>::iterator existing = resultInfo.find(it.key());
+        if (existing != resultInfo.end()) {
+            *existing = it.value();
+            continue;
+        }
+        resultInfo.insert(it.key(), it.value());
+        resultIdentifiers.append(it.key());
+        ++added;
+    }
+    return added;
+}
+
+void ContactSearchChannel::Private::dropFetchedResults()
+{
+    if (resultBufferSize == 0) {
+        return;
+    }
+
+    int excess = resultCursor - droppedResults - static_cast<int>(resultBufferSize);
+    if (excess <= 0) {
+        return;
+    }
+
+    QStringList::iterator end = resultIdentifiers.begin() + excess;
+    for (QStringList::iterator it = resultIdentifiers.begin(); it != end; ++it) {
+        resultInfo.remove(*it);
+    }
+    resultIdentifiers.erase(resultIdentifiers.begin(), end);
+    droppedResults += excess;
+}
+
+void ContactSearchChannel::Private::continueSearchIfBelowThreshold()
+{
+    if (autoContinueThreshold == 0 || moreRequested ||
+        searchState != ChannelContactSearchStateMoreAvailable) {
+        return;
+    }
+
+    int unfetched = droppedResults + resultIdentifiers.size() - resultCursor;
+    if (static_cast<uint>(unfetched) >= autoContinueThreshold) {
+        return;
+    }
+
+    moreRequested = true;
+    PendingVoid *op = new PendingVoid(contactSearchInterface->More(),
+            ContactSearchChannelPtr(parent));
+    parent->connect(op,
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(gotMoreReply(Tp::PendingOperation*)));
+}
+
 struct TP_QT_NO_EXPORT ContactSearchChannel::SearchStateChangeDetails::Private : public QSharedData
 {
     Private(const QVariantMap &details)
@@ -499,7 +590,7 @@ PendingOperation *ContactSearchChannel::search(const ContactSearchMap &terms)
     }
 
     if (searchState() != ChannelContactSearchStateNotStarted) {
-        warning() << "ContactSearchChannel::search called with "
+        tpWarning(logChannels) << "ContactSearchChannel::search called with "
             "searchState() != ChannelContactSearchStateNotStarted. Doing nothing";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Search already started"),
@@ -522,7 +613,7 @@ void ContactSearchChannel::continueSearch()
     }
 
     if (searchState() != ChannelContactSearchStateMoreAvailable) {
-        warning() << "ContactSearchChannel::continueSearch called with "
+        tpWarning(logChannels) << "ContactSearchChannel::continueSearch called with "
             "searchState() != ChannelContactSearchStateMoreAvailable. Doing nothing";
         return;
     }
@@ -551,7 +642,7 @@ void ContactSearchChannel::stopSearch()
 
     if (searchState() != ChannelContactSearchStateInProgress &&
         searchState() != ChannelContactSearchStateMoreAvailable) {
-        warning() << "ContactSearchChannel::stopSearch called with "
+        tpWarning(logChannels) << "ContactSearchChannel::stopSearch called with "
             "searchState() != ChannelContactSearchStateInProgress or "
             "ChannelContactSearchStateMoreAvailable. Doing nothing";
         return;
@@ -561,6 +652,216 @@ void ContactSearchChannel::stopSearch()
             ContactSearchChannelPtr(this));
 }
 
+/**
+ * Return whether contacts are resolved as soon as search results are received.
+ *
+ * \return \c true if searchResultReceived() is emitted for each batch of results,
+ *         \c false if results are only merged into the result set.
+ * \sa setResolveContactsOnReceipt()
+ */
+bool ContactSearchChannel::resolvesContactsOnReceipt() const
+{
+    return mPriv->resolveContactsOnReceipt;
+}
+
+/**
+ * Set whether contacts are resolved as soon as search results are received.
+ *
+ * By default, a Contact object is built for every search result as soon as it is received
+ * and searchResultReceived() is emitted with the resolved batch. Searches returning many
+ * results can instead disable this, in which case searchResultReceived() is not emitted,
+ * results are only merged into the result set signalled by searchResultsAvailable(), and
+ * contacts are resolved on demand with fetchResults().
+ *
+ * This should be set before calling search().
+ *
+ * \param resolve Whether to resolve contacts on receipt.
+ * \sa fetchResults(), resultIdentifiers()
+ */
+void ContactSearchChannel::setResolveContactsOnReceipt(bool resolve)
+{
+    mPriv->resolveContactsOnReceipt = resolve;
+}
+
+/**
+ * Return the number of unfetched results below which a search is continued automatically.
+ *
+ * \return The threshold, or 0 if the search is never continued automatically.
+ * \sa setAutoContinueThreshold()
+ */
+uint ContactSearchChannel::autoContinueThreshold() const
+{
+    return mPriv->autoContinueThreshold;
+}
+
+/**
+ * Set the number of unfetched results below which a search is continued automatically.
+ *
+ * When \a threshold is not 0 and searchState() becomes #ChannelContactSearchStateMoreAvailable,
+ * continueSearch() is called automatically as long as fewer than \a threshold results lie
+ * beyond resultCursor(). Fetching results with fetchResults() moves the cursor and resumes
+ * the search, so results are requested from the service only as fast as they are consumed.
+ *
+ * This only throttles how fast results are requested. Results which were already fetched
+ * are kept until they are dropped according to resultBufferSize().
+ *
+ * \param threshold The threshold, or 0 to disable automatic continuation.
+ * \sa fetchResults(), continueSearch()
+ */
+void ContactSearchChannel::setAutoContinueThreshold(uint threshold)
+{
+    mPriv->autoContinueThreshold = threshold;
+    mPriv->continueSearchIfBelowThreshold();
+}
+
+/**
+ * Return the maximum number of fetched results kept in the result set.
+ *
+ * \return The number of fetched results kept, or 0 if every result is kept.
+ * \sa setResultBufferSize()
+ */
+uint ContactSearchChannel::resultBufferSize() const
+{
+    return mPriv->resultBufferSize;
+}
+
+/**
+ * Set the maximum number of fetched results kept in the result set.
+ *
+ * By default every result received is kept for the lifetime of the channel. When \a size is
+ * not 0, only the \a size most recently fetched results are kept along with the ones which were
+ * not fetched yet, and older ones are dropped as fetchResults() or setResultCursor() move the
+ * cursor past them. Together with setAutoContinueThreshold(), this bounds the memory used by
+ * searches which return a large number of results.
+ *
+ * Dropped results are no longer returned by resultIdentifiers() or resultInfoFields(), the
+ * cursor cannot be moved back to them, and a dropped result signalled again by the service
+ * is added again as a new result. \a size should be at least the count passed to
+ * fetchResults(), so that the information fields of the fetched contacts are still
+ * available when the returned PendingContacts finishes.
+ *
+ * \param size The number of fetched results to keep, or 0 to keep every result.
+ * \sa fetchResults(), setAutoContinueThreshold()
+ */
+void ContactSearchChannel::setResultBufferSize(uint size)
+{
+    mPriv->resultBufferSize = size;
+    mPriv->dropFetchedResults();
+}
+
+/**
+ * Return the number of distinct results received so far.
+ *
+ * Results signalled more than once for the same identifier are counted once. Results dropped
+ * according to resultBufferSize() are still counted.
+ *
+ * \return The number of results.
+ * \sa resultIdentifiers(), searchResultsAvailable()
+ */
+int ContactSearchChannel::resultCount() const
+{
+    return mPriv->droppedResults + mPriv->resultIdentifiers.size();
+}
+
+/**
+ * Return the identifiers of the results received so far, in the order they were received.
+ *
+ * Results dropped according to resultBufferSize() are skipped, but still count for \a offset.
+ *
+ * \param offset The index of the first identifier to return.
+ * \param limit The maximum number of identifiers to return, or -1 to return all remaining ones.
+ * \return A list of contact identifiers.
+ * \sa resultInfoFields(), fetchResults()
+ */
+QStringList ContactSearchChannel::resultIdentifiers(int offset, int limit) const
+{
+    int start = offset - mPriv->droppedResults;
+    if (start < 0) {
+        if (limit >= 0) {
+            limit = qMax(0, limit + start);
+        }
+        start = 0;
+    }
+    return mPriv->resultIdentifiers.mid(start, limit);
+}
+
+/**
+ * Return the contact information fields received for the result \a identifier.
+ *
+ * If the same identifier was returned more than once, the most recent fields are returned.
+ *
+ * \param identifier The contact identifier, as returned by resultIdentifiers().
+ * \return The contact information fields, or an invalid Contact::InfoFields object if there is
+ *         no such result or it was dropped according to resultBufferSize().
+ */
+Contact::InfoFields ContactSearchChannel::resultInfoFields(const QString &identifier) const
+{
+    QHash<QString, ContactInfoFieldList>::const_iterator it =
+        mPriv->resultInfo.constFind(identifier);
+    if (it == mPriv->resultInfo.constEnd()) {
+        return Contact::InfoFields();
+    }
+    return Contact::InfoFields(*it);
+}
+
+/**
+ * Return the position of the result cursor used by fetchResults().
+ *
+ * \return The index of the next result to be fetched.
+ * \sa setResultCursor(), fetchResults()
+ */
+int ContactSearchChannel::resultCursor() const
+{
+    return mPriv->resultCursor;
+}
+
+/**
+ * Move the result cursor used by fetchResults() to \a position.
+ *
+ * \param position The index of the next result to be fetched, clamped to the results which
+ *                 were not dropped according to resultBufferSize() and resultCount().
+ * \sa resultCursor(), fetchResults()
+ */
+void ContactSearchChannel::setResultCursor(int position)
+{
+    mPriv->resultCursor = qBound(mPriv->droppedResults, position, resultCount());
+    mPriv->dropFetchedResults();
+    mPriv->continueSearchIfBelowThreshold();
+}
+
+/**
+ * Resolve the contacts for up to \a count results starting at resultCursor(), and advance
+ * the cursor past them.
+ *
+ * This can be called while the search is still in progress, in which case fewer than
+ * \a count results may be fetched. The information fields for each contact can be retrieved
+ * with resultInfoFields(), using the identifiers in PendingContacts::identifiers().
+ *
+ * This method requires ContactSearchChannel::FeatureCore to be ready.
+ *
+ * \param count The maximum number of results to fetch.
+ * \return A PendingContacts object which will emit PendingContacts::finished
+ *         when the contacts have been resolved.
+ * \sa resultCursor(), setAutoContinueThreshold(), setResultBufferSize()
+ */
+PendingContacts *ContactSearchChannel::fetchResults(int count)
+{
+    if (!isReady(FeatureCore)) {
+        return new PendingContacts(connection()->contactManager(), QStringList(),
+                PendingContacts::ForIdentifiers, Features(), QStringList(),
+                TP_QT_ERROR_NOT_AVAILABLE, QLatin1String("Channel not ready"));
+    }
+
+    QStringList identifiers = mPriv->resultIdentifiers.mid(
+            mPriv->resultCursor - mPriv->droppedResults, count);
+    mPriv->resultCursor += identifiers.size();
+    mPriv->dropFetchedResults();
+
+    PendingContacts *pc = connection()->contactManager()->contactsForIdentifiers(identifiers);
+    mPriv->continueSearchIfBelowThreshold();
+    return pc;
+}
+
 void ContactSearchChannel::gotProperties(QDBusPendingCallWatcher *watcher)
 {
     QDBusPendingReply<QVariantMap> reply = *watcher;
@@ -571,10 +872,10 @@ void ContactSearchChannel::gotProperties(QDBusPendingCallWatcher *watcher)
 
         mPriv->searchState = qdbus_cast<uint>(props[QLatin1String("SearchState")]);
 
-        debug() << "Got reply to Properties::GetAll(ContactSearchChannel)";
+        tpDebug(logChannels) << "Got reply to Properties::GetAll(ContactSearchChannel)";
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, true);
     } else {
-        warning().nospace() << "Properties::GetAll(ContactSearchChannel) failed "
+        tpWarning(logChannels).nospace() << "Properties::GetAll(ContactSearchChannel) failed "
             "with " << reply.error().name() << ": " << reply.error().message();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
                 reply.error());
@@ -590,10 +891,10 @@ void ContactSearchChannel::gotSearchState(QDBusPendingCallWatcher *watcher)
     if (!reply.isError()) {
         mPriv->searchState = qdbus_cast<uint>(reply.value());
 
-        debug() << "Got reply to Properties::Get(SearchState)";
+        tpDebug(logChannels) << "Got reply to Properties::Get(SearchState)";
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, true);
     } else {
-        warning().nospace() << "Properties::Get(SearchState) failed "
+        tpWarning(logChannels).nospace() << "Properties::Get(SearchState) failed "
             "with " << reply.error().name() << ": " << reply.error().message();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
                 reply.error());
@@ -624,7 +925,7 @@ void ContactSearchChannel::gotSearchResultContacts(PendingOperation *op)
     const ContactSearchResultMap &result = mPriv->searchResultQueue.dequeue();
 
     if (!pc->isValid()) {
-        warning().nospace() << "Getting search result contacts "
+        tpWarning(logChannels).nospace() << "Getting search result contacts "
             "failed with " << pc->errorName() << ":" <<
             pc->errorMessage() << ". Ignoring search result";
         mPriv->processingSignalsQueue = false;
@@ -648,6 +949,19 @@ void ContactSearchChannel::gotSearchResultContacts(PendingOperation *op)
     mPriv->processSignalsQueue();
 }
 
+void ContactSearchChannel::gotMoreReply(PendingOperation *op)
+{
+    if (!op->isError()) {
+        return;
+    }
+
+    // The search stays in the MoreAvailable state, so let the next fetch try again instead of
+    // waiting for a state change which will never come
+    tpWarning(logChannels).nospace() << "ChannelTypeContactSearch::More() failed with " <<
+        op->errorName() << ": " << op->errorMessage();
+    mPriv->moreRequested = false;
+}
+
 /**
  * \fn void ContactSearchChannel::searchStateChanged(Tp::ChannelContactSearchState state,
  *          const QString &errorName,
@@ -669,8 +983,23 @@ void ContactSearchChannel::gotSearchResultContacts(PendingOperation *op)
  * until the searchState() goes to #ChannelContactSearchStateCompleted or
  * #ChannelContactSearchStateFailed.
  *
+ * This signal is not emitted if setResolveContactsOnReceipt() was set to \c false.
+ *
  * \param result The search result.
  * \sa searchState()
  */
 
+/**
+ * \fn void ContactSearchChannel::searchResultsAvailable(int count)
+ *
+ * Emitted when new results are merged into the result set. It can be emitted multiple times
+ * until the searchState() goes to #ChannelContactSearchStateCompleted or
+ * #ChannelContactSearchStateFailed.
+ *
+ * This signal is emitted regardless of resolvesContactsOnReceipt().
+ *
+ * \param count The number of results added to the result set.
+ * \sa resultCount(), fetchResults()
+ */
+
 } // Tp
@@ -34,6 +34,8 @@
 namespace Tp
 {
 
+class PendingContacts;
+
 class TP_QT_EXPORT ContactSearchChannel : public Channel
 {
     Q_OBJECT
@@ -85,10 +87,25 @@ public:
     void continueSearch();
     void stopSearch();
 
+    bool resolvesContactsOnReceipt() const;
+    void setResolveContactsOnReceipt(bool resolve);
+    uint autoContinueThreshold() const;
+    void setAutoContinueThreshold(uint threshold);
+    uint resultBufferSize() const;
+    void setResultBufferSize(uint size);
+
+    int resultCount() const;
+    QStringList resultIdentifiers(int offset = 0, int limit = -1) const;
+    Contact::InfoFields resultInfoFields(const QString &identifier) const;
+    int resultCursor() const;
+    void setResultCursor(int position);
+    PendingContacts *fetchResults(int count);
+
 Q_SIGNALS:
     void searchStateChanged(Tp::ChannelContactSearchState state, const QString &errorName,
             const Tp::ContactSearchChannel::SearchStateChangeDetails &details);
     void searchResultReceived(const Tp::ContactSearchChannel::SearchResult &result);
+    void searchResultsAvailable(int count);
 
 protected:
     ContactSearchChannel(const ConnectionPtr &connection, const QString &objectPath,
@@ -100,6 +117,7 @@ private Q_SLOTS:
     TP_QT_NO_EXPORT void onSearchStateChanged(uint state, const QString &error, const QVariantMap &details);
     TP_QT_NO_EXPORT void onSearchResultReceived(const Tp::ContactSearchResultMap &result);
     TP_QT_NO_EXPORT void gotSearchResultContacts(Tp::PendingOperation *op);
+    TP_QT_NO_EXPORT void gotMoreReply(Tp::PendingOperation *op);
 
 private:
     class PendingSearch;
@@ -26,6 +26,7 @@
 
 #include "TelepathyQt/debug-internal.h"
 #include "TelepathyQt/future-internal.h"
+#include "TelepathyQt/test-backdoors.h"
 
 #include <TelepathyQt/AvatarData>
 #include <TelepathyQt/Connection>
@@ -40,28 +41,102 @@
 #include <TelepathyQt/Presence>
 #include <TelepathyQt/ReferencedHandles>
 
+#include <QScopedPointer>
+
 namespace Tp
 {
 
 struct TP_QT_NO_EXPORT Contact::Private
 {
     Private(Contact *parent, ContactManager *manager,
-        const ReferencedHandles &handle)
+        const ReferencedHandles &handle, const ContactCapabilities &caps)
         : parent(parent),
           manager(ContactManagerPtr(manager)),
           handle(handle),
-          caps(manager->supportedFeatures().contains(Contact::FeatureCapabilities) ?
-                   ContactCapabilities(true) :  ContactCapabilities(
-                           manager->connection()->capabilities().allClassSpecs(), false)),
-          isContactInfoKnown(false), isAvatarTokenKnown(false),
+          caps(caps),
           subscriptionState(SubscriptionStateUnknown),
           publishState(SubscriptionStateUnknown),
           blocked(false)
     {
     }
 
+    // The data of the features most contacts don't have, which is only allocated
+    // once a value is set for the contact
+    struct AvatarBlock
+    {
+        AvatarBlock() : isAvatarTokenKnown(false) {}
+
+        bool isAvatarTokenKnown;
+        QString avatarToken;
+        AvatarData avatarData;
+    };
+
+    struct InfoBlock
+    {
+        InfoBlock() : isContactInfoKnown(false) {}
+
+        bool isContactInfoKnown;
+        InfoFields info;
+    };
+
+    struct AddressesBlock
+    {
+        QMap<QString, QString> vcardAddresses;
+        QStringList uris;
+    };
+
+    AvatarBlock *avatar()
+    {
+        if (!avatarBlock) {
+            avatarBlock.reset(new AvatarBlock);
+        }
+        return avatarBlock.data();
+    }
+
+    InfoBlock *contactInfo()
+    {
+        if (!infoBlock) {
+            infoBlock.reset(new InfoBlock);
+        }
+        return infoBlock.data();
+    }
+
     void updateAvatarData();
 
+    // Decode the attributes of a feature from the GetContactAttributes mapping
+    typedef void (*AttributeDecoder)(Contact *contact, const QVariantMap &attributes);
+    static AttributeDecoder attributeDecoder(const Feature &feature);
+
+    static void decodeAlias(Contact *contact, const QVariantMap &attributes);
+    static void decodeAvatarData(Contact *contact, const QVariantMap &attributes);
+    static void decodeAvatarToken(Contact *contact, const QVariantMap &attributes);
+    static void decodeCapabilities(Contact *contact, const QVariantMap &attributes);
+    static void decodeInfo(Contact *contact, const QVariantMap &attributes);
+    static void decodeLocation(Contact *contact, const QVariantMap &attributes);
+    static void decodeSimplePresence(Contact *contact, const QVariantMap &attributes);
+    static void decodeRosterGroups(Contact *contact, const QVariantMap &attributes);
+    static void decodeAddresses(Contact *contact, const QVariantMap &attributes);
+    static void decodeClientTypes(Contact *contact, const QVariantMap &attributes);
+
+    // The attribute names are built once instead of for every contact
+    static const QString attrContactId;
+    static const QString attrSubscribe;
+    static const QString attrPublish;
+    static const QString attrPublishRequest;
+    static const QString attrAlias;
+    static const QString attrAvatarToken;
+    static const QString attrCapabilities;
+    static const QString attrInfo;
+    static const QString attrLocation;
+    static const QString attrPresence;
+    static const QString attrGroups;
+    static const QString attrAddresses;
+    static const QString attrUris;
+    static const QString attrClientTypes;
+
+    // Shared by all the contacts whose presence is not known
+    static const Presence unknownPresence;
+
     Contact *parent;
 
     WeakPtr<ContactManager> manager;
@@ -72,18 +147,13 @@ struct TP_QT_NO_EXPORT Contact::Private
     Features actualFeatures;
 
     QString alias;
-    QMap<QString, QString> vcardAddresses;
-    QStringList uris;
     Presence presence;
     ContactCapabilities caps;
-    LocationInfo location;
-
-    bool isContactInfoKnown;
-    InfoFields info;
 
-    bool isAvatarTokenKnown;
-    QString avatarToken;
-    AvatarData avatarData;
+    QScopedPointer<AvatarBlock> avatarBlock;
+    QScopedPointer<InfoBlock> infoBlock;
+    QScopedPointer<AddressesBlock> addressesBlock;
+    QScopedPointer<LocationInfo> location;
 
     SubscriptionState subscriptionState;
     SubscriptionState publishState;
@@ -95,21 +165,215 @@ struct TP_QT_NO_EXPORT Contact::Private
     QStringList clientTypes;
 };
 
+const QString Contact::Private::attrContactId(
+        TP_QT_IFACE_CONNECTION + QLatin1String("/contact-id"));
+const QString Contact::Private::attrSubscribe(
+        TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_LIST + QLatin1String("/subscribe"));
+const QString Contact::Private::attrPublish(
+        TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_LIST + QLatin1String("/publish"));
+const QString Contact::Private::attrPublishRequest(
+        TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_LIST + QLatin1String("/publish-request"));
+const QString Contact::Private::attrAlias(
+        TP_QT_IFACE_CONNECTION_INTERFACE_ALIASING + QLatin1String("/alias"));
+const QString Contact::Private::attrAvatarToken(
+        TP_QT_IFACE_CONNECTION_INTERFACE_AVATARS + QLatin1String("/token"));
+const QString Contact::Private::attrCapabilities(
+        TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_CAPABILITIES + QLatin1String("/capabilities"));
+const QString Contact::Private::attrInfo(
+        TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_INFO + QLatin1String("/info"));
+const QString Contact::Private::attrLocation(
+        TP_QT_IFACE_CONNECTION_INTERFACE_LOCATION + QLatin1String("/location"));
+const QString Contact::Private::attrPresence(
+        TP_QT_IFACE_CONNECTION_INTERFACE_SIMPLE_PRESENCE + QLatin1String("/presence"));
+const QString Contact::Private::attrGroups(
+        TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_GROUPS + QLatin1String("/groups"));
+const QString Contact::Private::attrAddresses(
+        TP_QT_IFACE_CONNECTION_INTERFACE_ADDRESSING + QLatin1String("/addresses"));
+const QString Contact::Private::attrUris(
+        TP_QT_IFACE_CONNECTION_INTERFACE_ADDRESSING + QLatin1String("/uris"));
+const QString Contact::Private::attrClientTypes(
+        TP_QT_IFACE_CONNECTION_INTERFACE_CLIENT_TYPES + QLatin1String("/client-types"));
+
+const Presence Contact::Private::unknownPresence(ConnectionPresenceTypeUnknown,
+        QLatin1String("unknown"), QLatin1String(""));
+
+Contact::Private::AttributeDecoder Contact::Private::attributeDecoder(const Feature &feature)
+{
+    // Indexed by the feature ids, so that dispatching a feature is a single
+    // class name compare instead of one compare per known feature
+    static const AttributeDecoder decoders[] = {
+        &decodeAlias,
+        &decodeAvatarData,
+        &decodeAvatarToken,
+        &decodeCapabilities,
+        &decodeInfo,
+        &decodeLocation,
+        &decodeSimplePresence,
+        &decodeRosterGroups,
+        &decodeAddresses,
+        &decodeClientTypes
+    };
+
+    if (feature.second >= sizeof(decoders) / sizeof(decoders[0]) ||
+        feature.first != FeatureAlias.first) {
+        return 0;
+    }
+
+    return decoders[feature.second];
+}
+
+void Contact::Private::decodeAlias(Contact *contact, const QVariantMap &attributes)
+{
+    QString maybeAlias = qdbus_cast<QString>(attributes.value(attrAlias));
+
+    if (!maybeAlias.isEmpty()) {
+        contact->receiveAlias(maybeAlias);
+    } else if (contact->mPriv->alias.isEmpty()) {
+        contact->mPriv->alias = contact->mPriv->id;
+    }
+}
+
+void Contact::Private::decodeAvatarData(Contact *contact, const QVariantMap &attributes)
+{
+    Q_UNUSED(attributes);
+
+    if (contact->manager()->supportedFeatures().contains(FeatureAvatarData)) {
+        contact->mPriv->actualFeatures.insert(FeatureAvatarData);
+        contact->mPriv->updateAvatarData();
+    }
+}
+
+void Contact::Private::decodeAvatarToken(Contact *contact, const QVariantMap &attributes)
+{
+    QVariantMap::const_iterator it = attributes.constFind(attrAvatarToken);
+    if (it != attributes.constEnd()) {
+        contact->receiveAvatarToken(qdbus_cast<QString>(it.value()));
+    } else {
+        if (contact->manager()->supportedFeatures().contains(FeatureAvatarToken)) {
+            // AvatarToken being supported but not included in the mapping indicates
+            // that the avatar token is not known - however, the feature is working fine
+            contact->mPriv->actualFeatures.insert(FeatureAvatarToken);
+        }
+        // In either case, the avatar token can't be known, which contacts without an
+        // avatar block already say
+        AvatarBlock *avatar = contact->mPriv->avatarBlock.data();
+        if (avatar) {
+            avatar->isAvatarTokenKnown = false;
+            avatar->avatarToken = QLatin1String("");
+        }
+    }
+}
+
+void Contact::Private::decodeCapabilities(Contact *contact, const QVariantMap &attributes)
+{
+    RequestableChannelClassList maybeCaps = qdbus_cast<RequestableChannelClassList>(
+            attributes.value(attrCapabilities));
+
+    if (!maybeCaps.isEmpty()) {
+        contact->receiveCapabilities(maybeCaps);
+    } else {
+        if (contact->manager()->supportedFeatures().contains(FeatureCapabilities) &&
+            contact->mPriv->requestedFeatures.contains(FeatureCapabilities)) {
+            // Capabilities being supported but not updated in the
+            // mapping indicates that the capabilities is not known -
+            // however, the feature is working fine.
+            contact->mPriv->actualFeatures.insert(FeatureCapabilities);
+        }
+    }
+}
+
+void Contact::Private::decodeInfo(Contact *contact, const QVariantMap &attributes)
+{
+    ContactInfoFieldList maybeInfo = qdbus_cast<ContactInfoFieldList>(
+            attributes.value(attrInfo));
+
+    if (!maybeInfo.isEmpty()) {
+        contact->receiveInfo(maybeInfo);
+    } else {
+        if (contact->manager()->supportedFeatures().contains(FeatureInfo) &&
+            contact->mPriv->requestedFeatures.contains(FeatureInfo)) {
+            // Info being supported but not updated in the
+            // mapping indicates that the info is not known -
+            // however, the feature is working fine
+            contact->mPriv->actualFeatures.insert(FeatureInfo);
+        }
+    }
+}
+
+void Contact::Private::decodeLocation(Contact *contact, const QVariantMap &attributes)
+{
+    QVariantMap maybeLocation = qdbus_cast<QVariantMap>(attributes.value(attrLocation));
+
+    if (!maybeLocation.isEmpty()) {
+        contact->receiveLocation(maybeLocation);
+    } else {
+        if (contact->manager()->supportedFeatures().contains(FeatureLocation) &&
+            contact->mPriv->requestedFeatures.contains(FeatureLocation)) {
+            // Location being supported but not updated in the
+            // mapping indicates that the location is not known -
+            // however, the feature is working fine
+            contact->mPriv->actualFeatures.insert(FeatureLocation);
+        }
+    }
+}
+
+void Contact::Private::decodeSimplePresence(Contact *contact, const QVariantMap &attributes)
+{
+    SimplePresence maybePresence = qdbus_cast<SimplePresence>(attributes.value(attrPresence));
+
+    if (!maybePresence.status.isEmpty()) {
+        contact->receiveSimplePresence(maybePresence);
+    } else {
+        contact->mPriv->presence = unknownPresence;
+    }
+}
+
+void Contact::Private::decodeRosterGroups(Contact *contact, const QVariantMap &attributes)
+{
+    QStringList groups = qdbus_cast<QStringList>(attributes.value(attrGroups));
+    contact->mPriv->groups = groups.toSet();
+}
+
+void Contact::Private::decodeAddresses(Contact *contact, const QVariantMap &attributes)
+{
+    VCardFieldAddressMap addresses = qdbus_cast<VCardFieldAddressMap>(
+            attributes.value(attrAddresses));
+    QStringList uris = qdbus_cast<QStringList>(attributes.value(attrUris));
+    contact->receiveAddresses(addresses, uris);
+}
+
+void Contact::Private::decodeClientTypes(Contact *contact, const QVariantMap &attributes)
+{
+    QStringList maybeClientTypes = qdbus_cast<QStringList>(attributes.value(attrClientTypes));
+
+    if (!maybeClientTypes.isEmpty()) {
+        contact->receiveClientTypes(maybeClientTypes);
+    } else {
+        if (contact->manager()->supportedFeatures().contains(FeatureClientTypes) &&
+            contact->mPriv->requestedFeatures.contains(FeatureClientTypes)) {
+            // ClientTypes being supported but not updated in the
+            // mapping indicates that the info is not known -
+            // however, the feature is working fine
+            contact->mPriv->actualFeatures.insert(FeatureClientTypes);
+        }
+    }
+}
+
 void Contact::Private::updateAvatarData()
 {
     /* If token is NULL, it means that CM doesn't know the token. In that case we
      * have to request the avatar data to get the token. This happens with XMPP
      * for offline contacts. We don't want to bypass the avatar cache, so we won't
      * update avatar. */
-    if (avatarToken.isNull()) {
+    if (!avatarBlock || avatarBlock->avatarToken.isNull()) {
         return;
     }
 
     /* If token is empty (""), it means the contact has no avatar. */
-    if (avatarToken.isEmpty()) {
-        debug() << "Contact" << parent->id() << "has no avatar";
-        avatarData = AvatarData();
-        emit parent->avatarDataChanged(avatarData);
+    if (avatarBlock->avatarToken.isEmpty()) {
+        tpDebug(logContacts) << "Contact" << parent->id() << "has no avatar";
+        avatarBlock->avatarData = AvatarData();
+        emit parent->avatarDataChanged(avatarBlock->avatarData);
         return;
     }
 
@@ -319,11 +583,10 @@ const Feature Contact::FeatureClientTypes = Feature(QLatin1String(Contact::stati
 Contact::Contact(ContactManager *manager, const ReferencedHandles &handle,
         const Features &requestedFeatures, const QVariantMap &attributes)
     : Object(),
-      mPriv(new Private(this, manager, handle))
+      mPriv(new Private(this, manager, handle, manager->defaultContactCapabilities()))
 {
     mPriv->requestedFeatures.unite(requestedFeatures);
-    mPriv->id = qdbus_cast<QString>(attributes[
-            TP_QT_IFACE_CONNECTION + QLatin1String("/contact-id")]);
+    mPriv->id = qdbus_cast<QString>(attributes.value(Private::attrContactId));
 }
 
 /**
@@ -331,7 +594,7 @@ Contact::Contact(ContactManager *manager, const ReferencedHandles &handle,
  */
 Contact::~Contact()
 {
-    debug() << "Contact" << id() << "destroyed";
+    tpDebug(logContacts) << "Contact" << id() << "destroyed";
     delete mPriv;
 }
 
@@ -397,7 +660,7 @@ Features Contact::actualFeatures() const
 QString Contact::alias() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureAlias)) {
-        warning() << "Contact::alias() used on" << this
+        tpWarning(logContacts) << "Contact::alias() used on" << this
             << "for which FeatureAlias hasn't been requested - returning id";
         return id();
     }
@@ -415,7 +678,11 @@ QString Contact::alias() const
  */
 QMap<QString, QString> Contact::vcardAddresses() const
 {
-    return mPriv->vcardAddresses;
+    if (!mPriv->addressesBlock) {
+        return QMap<QString, QString>();
+    }
+
+    return mPriv->addressesBlock->vcardAddresses;
 }
 
 /**
@@ -428,7 +695,11 @@ QMap<QString, QString> Contact::vcardAddresses() const
  */
 QStringList Contact::uris() const
 {
-    return mPriv->uris;
+    if (!mPriv->addressesBlock) {
+        return QStringList();
+    }
+
+    return mPriv->addressesBlock->uris;
 }
 
 /**
@@ -442,12 +713,12 @@ QStringList Contact::uris() const
 bool Contact::isAvatarTokenKnown() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureAvatarToken)) {
-        warning() << "Contact::isAvatarTokenKnown() used on" << this
+        tpWarning(logContacts) << "Contact::isAvatarTokenKnown() used on" << this
             << "for which FeatureAvatarToken hasn't been requested - returning false";
         return false;
     }
 
-    return mPriv->isAvatarTokenKnown;
+    return mPriv->avatarBlock && mPriv->avatarBlock->isAvatarTokenKnown;
 }
 
 /**
@@ -463,16 +734,16 @@ bool Contact::isAvatarTokenKnown() const
 QString Contact::avatarToken() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureAvatarToken)) {
-        warning() << "Contact::avatarToken() used on" << this
+        tpWarning(logContacts) << "Contact::avatarToken() used on" << this
             << "for which FeatureAvatarToken hasn't been requested - returning \"\"";
         return QString();
     } else if (!isAvatarTokenKnown()) {
-        warning() << "Contact::avatarToken() used on" << this
+        tpWarning(logContacts) << "Contact::avatarToken() used on" << this
             << "for which the avatar token is not (yet) known - returning \"\"";
         return QString();
     }
 
-    return mPriv->avatarToken;
+    return mPriv->avatarBlock->avatarToken;
 }
 
 /**
@@ -488,12 +759,16 @@ QString Contact::avatarToken() const
 AvatarData Contact::avatarData() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureAvatarData)) {
-        warning() << "Contact::avatarData() used on" << this
+        tpWarning(logContacts) << "Contact::avatarData() used on" << this
             << "for which FeatureAvatarData hasn't been requested - returning \"\"";
         return AvatarData();
     }
 
-    return mPriv->avatarData;
+    if (!mPriv->avatarBlock) {
+        return AvatarData();
+    }
+
+    return mPriv->avatarBlock->avatarData;
 }
 
 /**
@@ -514,7 +789,7 @@ AvatarData Contact::avatarData() const
 void Contact::requestAvatarData()
 {
     if (!mPriv->requestedFeatures.contains(FeatureAvatarData)) {
-        warning() << "Contact::requestAvatarData() used on" << this
+        tpWarning(logContacts) << "Contact::requestAvatarData() used on" << this
             << "for which FeatureAvatarData hasn't been requested - returning \"\"";
         return;
     }
@@ -534,7 +809,7 @@ void Contact::requestAvatarData()
 Presence Contact::presence() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureSimplePresence)) {
-        warning() << "Contact::presence() used on" << this
+        tpWarning(logContacts) << "Contact::presence() used on" << this
             << "for which FeatureSimplePresence hasn't been requested - returning Unknown";
         return Presence();
     }
@@ -563,7 +838,7 @@ Presence Contact::presence() const
 ContactCapabilities Contact::capabilities() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureCapabilities)) {
-        warning() << "Contact::capabilities() used on" << this
+        tpWarning(logContacts) << "Contact::capabilities() used on" << this
             << "for which FeatureCapabilities hasn't been requested - returning 0";
         return ContactCapabilities(false);
     }
@@ -583,12 +858,14 @@ ContactCapabilities Contact::capabilities() const
 LocationInfo Contact::location() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureLocation)) {
-        warning() << "Contact::location() used on" << this
+        tpWarning(logContacts) << "Contact::location() used on" << this
             << "for which FeatureLocation hasn't been requested - returning 0";
         return LocationInfo();
+    } else if (!mPriv->location) {
+        return LocationInfo();
     }
 
-    return mPriv->location;
+    return *mPriv->location;
 }
 
 /**
@@ -606,12 +883,12 @@ LocationInfo Contact::location() const
 bool Contact::isContactInfoKnown() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureInfo)) {
-        warning() << "Contact::isContactInfoKnown() used on" << this
+        tpWarning(logContacts) << "Contact::isContactInfoKnown() used on" << this
             << "for which FeatureInfo hasn't been requested - returning false";
         return false;
     }
 
-    return mPriv->isContactInfoKnown;
+    return mPriv->infoBlock && mPriv->infoBlock->isContactInfoKnown;
 }
 
 /**
@@ -629,13 +906,15 @@ bool Contact::isContactInfoKnown() const
 Contact::InfoFields Contact::infoFields() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureInfo)) {
-        warning() << "Contact::infoFields() used on" << this
+        tpWarning(logContacts) << "Contact::infoFields() used on" << this
             << "for which FeatureInfo hasn't been requested - returning empty "
                "InfoFields";
         return InfoFields();
+    } else if (!mPriv->infoBlock) {
+        return InfoFields();
     }
 
-    return mPriv->info;
+    return mPriv->infoBlock->info;
 }
 
 /**
@@ -653,7 +932,7 @@ PendingOperation *Contact::refreshInfo()
 {
     ConnectionPtr conn = manager()->connection();
     if (!mPriv->requestedFeatures.contains(FeatureInfo)) {
-        warning() << "Contact::refreshInfo() used on" << this
+        tpWarning(logContacts) << "Contact::refreshInfo() used on" << this
             << "for which FeatureInfo hasn't been requested - failing";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("FeatureInfo needs to be ready in order to "
@@ -948,7 +1227,7 @@ PendingOperation *Contact::removeFromGroup(const QString &group)
 QStringList Contact::clientTypes() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureClientTypes)) {
-        warning() << "Contact::clientTypes() used on" << this
+        tpWarning(logContacts) << "Contact::clientTypes() used on" << this
             << "for which FeatureClientTypes hasn't been requested - returning an empty list";
         return QStringList();
     }
@@ -973,7 +1252,7 @@ QStringList Contact::clientTypes() const
 PendingStringList *Contact::requestClientTypes()
 {
     if (!mPriv->requestedFeatures.contains(FeatureClientTypes)) {
-        warning() << "Contact::requestClientTypes() used on" << this
+        tpWarning(logContacts) << "Contact::requestClientTypes() used on" << this
             << "for which FeatureClientTypes hasn't been requested - the operation will fail";
     }
 
@@ -989,143 +1268,26 @@ void Contact::augment(const Features &requestedFeatures, const QVariantMap &attr
 {
     mPriv->requestedFeatures.unite(requestedFeatures);
 
-    mPriv->id = qdbus_cast<QString>(attributes[
-            TP_QT_IFACE_CONNECTION + QLatin1String("/contact-id")]);
+    mPriv->id = qdbus_cast<QString>(attributes.value(Private::attrContactId));
 
-    if (attributes.contains(TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_LIST +
-                QLatin1String("/subscribe"))) {
-        uint subscriptionState = qdbus_cast<uint>(attributes.value(
-                     TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_LIST + QLatin1String("/subscribe")));
-        setSubscriptionState((SubscriptionState) subscriptionState);
+    QVariantMap::const_iterator it = attributes.constFind(Private::attrSubscribe);
+    if (it != attributes.constEnd()) {
+        setSubscriptionState((SubscriptionState) qdbus_cast<uint>(it.value()));
     }
 
-    if (attributes.contains(TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_LIST +
-                QLatin1String("/publish"))) {
-        uint publishState = qdbus_cast<uint>(attributes.value(
-                    TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_LIST + QLatin1String("/publish")));
-        QString publishRequest = qdbus_cast<QString>(attributes.value(
-                    TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_LIST + QLatin1String("/publish-request")));
-        setPublishState((SubscriptionState) publishState, publishRequest);
+    it = attributes.constFind(Private::attrPublish);
+    if (it != attributes.constEnd()) {
+        setPublishState((SubscriptionState) qdbus_cast<uint>(it.value()),
+                qdbus_cast<QString>(attributes.value(Private::attrPublishRequest)));
     }
 
     foreach (const Feature &feature, requestedFeatures) {
-        QString maybeAlias;
-        SimplePresence maybePresence;
-        RequestableChannelClassList maybeCaps;
-        QVariantMap maybeLocation;
-        ContactInfoFieldList maybeInfo;
-
-        if (feature == FeatureAlias) {
-            maybeAlias = qdbus_cast<QString>(attributes.value(
-                        TP_QT_IFACE_CONNECTION_INTERFACE_ALIASING + QLatin1String("/alias")));
-
-            if (!maybeAlias.isEmpty()) {
-                receiveAlias(maybeAlias);
-            } else if (mPriv->alias.isEmpty()) {
-                mPriv->alias = mPriv->id;
-            }
-        } else if (feature == FeatureAvatarData) {
-            if (manager()->supportedFeatures().contains(FeatureAvatarData)) {
-                mPriv->actualFeatures.insert(FeatureAvatarData);
-                mPriv->updateAvatarData();
-            }
-        } else if (feature == FeatureAvatarToken) {
-            if (attributes.contains(
-                        TP_QT_IFACE_CONNECTION_INTERFACE_AVATARS + QLatin1String("/token"))) {
-                receiveAvatarToken(qdbus_cast<QString>(attributes.value(
-                                TP_QT_IFACE_CONNECTION_INTERFACE_AVATARS + QLatin1String("/token"))));
-            } else {
-                if (manager()->supportedFeatures().contains(FeatureAvatarToken)) {
-                    // AvatarToken being supported but not included in the mapping indicates
-                    // that the avatar token is not known - however, the feature is working fine
-                    mPriv->actualFeatures.insert(FeatureAvatarToken);
-                }
-                // In either case, the avatar token can't be known
-                mPriv->isAvatarTokenKnown = false;
-                mPriv->avatarToken = QLatin1String("");
-            }
-        } else if (feature == FeatureCapabilities) {
-            maybeCaps = qdbus_cast<RequestableChannelClassList>(attributes.value(
-                        TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_CAPABILITIES + QLatin1String("/capabilities")));
-
-            if (!maybeCaps.isEmpty()) {
-                receiveCapabilities(maybeCaps);
-            } else {
-                if (manager()->supportedFeatures().contains(FeatureCapabilities) &&
-                    mPriv->requestedFeatures.contains(FeatureCapabilities)) {
-                    // Capabilities being supported but not updated in the
-                    // mapping indicates that the capabilities is not known -
-                    // however, the feature is working fine.
-                    mPriv->actualFeatures.insert(FeatureCapabilities);
-                }
-            }
-        } else if (feature == FeatureInfo) {
-            maybeInfo = qdbus_cast<ContactInfoFieldList>(attributes.value(
-                        TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_INFO + QLatin1String("/info")));
-
-            if (!maybeInfo.isEmpty()) {
-                receiveInfo(maybeInfo);
-            } else {
-                if (manager()->supportedFeatures().contains(FeatureInfo) &&
-                    mPriv->requestedFeatures.contains(FeatureInfo)) {
-                    // Info being supported but not updated in the
-                    // mapping indicates that the info is not known -
-                    // however, the feature is working fine
-                    mPriv->actualFeatures.insert(FeatureInfo);
-                }
-            }
-        } else if (feature == FeatureLocation) {
-            maybeLocation = qdbus_cast<QVariantMap>(attributes.value(
-                        TP_QT_IFACE_CONNECTION_INTERFACE_LOCATION + QLatin1String("/location")));
-
-            if (!maybeLocation.isEmpty()) {
-                receiveLocation(maybeLocation);
-            } else {
-                if (manager()->supportedFeatures().contains(FeatureLocation) &&
-                    mPriv->requestedFeatures.contains(FeatureLocation)) {
-                    // Location being supported but not updated in the
-                    // mapping indicates that the location is not known -
-                    // however, the feature is working fine
-                    mPriv->actualFeatures.insert(FeatureLocation);
-                }
-            }
-        } else if (feature == FeatureSimplePresence) {
-            maybePresence = qdbus_cast<SimplePresence>(attributes.value(
-                        TP_QT_IFACE_CONNECTION_INTERFACE_SIMPLE_PRESENCE + QLatin1String("/presence")));
-
-            if (!maybePresence.status.isEmpty()) {
-                receiveSimplePresence(maybePresence);
-            } else {
-                mPriv->presence.setStatus(ConnectionPresenceTypeUnknown,
-                        QLatin1String("unknown"), QLatin1String(""));
-            }
-        } else if (feature == FeatureRosterGroups) {
-            QStringList groups = qdbus_cast<QStringList>(attributes.value(
-                        TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_GROUPS + QLatin1String("/groups")));
-            mPriv->groups = groups.toSet();
-        } else if (feature == FeatureAddresses) {
-            VCardFieldAddressMap addresses = qdbus_cast<VCardFieldAddressMap>(attributes.value(
-                        TP_QT_IFACE_CONNECTION_INTERFACE_ADDRESSING + QLatin1String("/addresses")));
-            QStringList uris = qdbus_cast<QStringList>(attributes.value(
-                        TP_QT_IFACE_CONNECTION_INTERFACE_ADDRESSING + QLatin1String("/uris")));
-            receiveAddresses(addresses, uris);
-        } else if (feature == FeatureClientTypes) {
-            QStringList maybeClientTypes = qdbus_cast<QStringList>(attributes.value(
-                        TP_QT_IFACE_CONNECTION_INTERFACE_CLIENT_TYPES + QLatin1String("/client-types")));
-
-            if (!maybeClientTypes.isEmpty()) {
-                receiveClientTypes(maybeClientTypes);
-            } else {
-                if (manager()->supportedFeatures().contains(FeatureClientTypes) &&
-                    mPriv->requestedFeatures.contains(FeatureClientTypes)) {
-                    // ClientTypes being supported but not updated in the
-                    // mapping indicates that the info is not known -
-                    // however, the feature is working fine
-                    mPriv->actualFeatures.insert(FeatureClientTypes);
-                }
-            }
+        Private::AttributeDecoder decode = Private::attributeDecoder(feature);
+        if (decode) {
+            decode(this, attributes);
         } else {
-            warning() << "Unknown feature" << feature << "encountered when augmenting Contact";
+            tpWarning(logContacts) << "Unknown feature" << feature <<
+                "encountered when augmenting Contact";
         }
     }
 }
@@ -1161,18 +1323,20 @@ void Contact::setAvatarToken(const QString &token)
 
     mPriv->actualFeatures.insert(FeatureAvatarToken);
 
-    if (!mPriv->isAvatarTokenKnown || mPriv->avatarToken != token) {
-        mPriv->isAvatarTokenKnown = true;
-        mPriv->avatarToken = token;
-        emit avatarTokenChanged(mPriv->avatarToken);
+    Private::AvatarBlock *avatar = mPriv->avatar();
+    if (!avatar->isAvatarTokenKnown || avatar->avatarToken != token) {
+        avatar->isAvatarTokenKnown = true;
+        avatar->avatarToken = token;
+        emit avatarTokenChanged(avatar->avatarToken);
     }
 }
 
 void Contact::receiveAvatarData(const AvatarData &avatar)
 {
-    if (mPriv->avatarData.fileName != avatar.fileName) {
-        mPriv->avatarData = avatar;
-        emit avatarDataChanged(mPriv->avatarData);
+    Private::AvatarBlock *avatarBlock = mPriv->avatar();
+    if (avatarBlock->avatarData.fileName != avatar.fileName) {
+        avatarBlock->avatarData = avatar;
+        emit avatarDataChanged(avatarBlock->avatarData);
     }
 }
 
@@ -1200,7 +1364,7 @@ void Contact::receiveCapabilities(const RequestableChannelClassList &caps)
     mPriv->actualFeatures.insert(FeatureCapabilities);
 
     if (mPriv->caps.allClassSpecs().bareClasses() != caps) {
-        mPriv->caps.updateRequestableChannelClasses(caps);
+        mPriv->caps = manager()->sharedCapabilities(caps);
         emit capabilitiesChanged(mPriv->caps);
     }
 }
@@ -1213,9 +1377,14 @@ void Contact::receiveLocation(const QVariantMap &location)
 
     mPriv->actualFeatures.insert(FeatureLocation);
 
-    if (mPriv->location.allDetails() != location) {
-        mPriv->location.updateData(location);
-        emit locationUpdated(mPriv->location);
+    if (!mPriv->location) {
+        if (!location.isEmpty()) {
+            mPriv->location.reset(new LocationInfo(location));
+            emit locationUpdated(*mPriv->location);
+        }
+    } else if (mPriv->location->allDetails() != location) {
+        mPriv->location->updateData(location);
+        emit locationUpdated(*mPriv->location);
     }
 }
 
@@ -1226,11 +1395,12 @@ void Contact::receiveInfo(const ContactInfoFieldList &info)
     }
 
     mPriv->actualFeatures.insert(FeatureInfo);
-    mPriv->isContactInfoKnown = true;
+    Private::InfoBlock *infoBlock = mPriv->contactInfo();
+    infoBlock->isContactInfoKnown = true;
 
-    if (mPriv->info.allFields() != info) {
-        mPriv->info = InfoFields(info);
-        emit infoFieldsChanged(mPriv->info);
+    if (infoBlock->info.allFields() != info) {
+        infoBlock->info = InfoFields(info);
+        emit infoFieldsChanged(infoBlock->info);
     }
 }
 
@@ -1242,8 +1412,16 @@ void Contact::receiveAddresses(const QMap<QString, QString> &addresses,
     }
 
     mPriv->actualFeatures.insert(FeatureAddresses);
-    mPriv->vcardAddresses = addresses;
-    mPriv->uris = uris;
+    if (addresses.isEmpty() && uris.isEmpty()) {
+        mPriv->addressesBlock.reset();
+        return;
+    }
+
+    if (!mPriv->addressesBlock) {
+        mPriv->addressesBlock.reset(new Private::AddressesBlock);
+    }
+    mPriv->addressesBlock->vcardAddresses = addresses;
+    mPriv->addressesBlock->uris = uris;
 }
 
 void Contact::receiveClientTypes(const QStringList &clientTypes)
@@ -1255,7 +1433,7 @@ void Contact::receiveClientTypes(const QStringList &clientTypes)
     mPriv->actualFeatures.insert(FeatureClientTypes);
 
     if (mPriv->clientTypes != clientTypes) {
-        mPriv->clientTypes = clientTypes;
+        mPriv->clientTypes = manager()->sharedClientTypes(clientTypes);
         emit clientTypesChanged(mPriv->clientTypes);
     }
 }
@@ -1439,4 +1617,23 @@ void Contact::setRemovedFromGroup(const QString &group)
  * \sa clientTypes(), requestClientTypes()
  */
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+bool TestBackdoors::hasContactAvatarBlock(const ContactPtr &contact)
+{
+    return !contact->mPriv->avatarBlock.isNull();
+}
+
+bool TestBackdoors::hasContactInfoBlock(const ContactPtr &contact)
+{
+    return !contact->mPriv->infoBlock.isNull();
+}
+
+bool TestBackdoors::hasContactLocationBlock(const ContactPtr &contact)
+{
+    return !contact->mPriv->location.isNull();
+}
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
 } // Tp
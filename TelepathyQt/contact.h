@@ -47,6 +47,7 @@ class PendingOperation;
 class PendingStringList;
 class Presence;
 class ReferencedHandles;
+class TestBackdoors;
 
 class TP_QT_EXPORT Contact : public Object
 {
@@ -237,6 +238,7 @@ private:
     friend class Connection;
     friend class ContactFactory;
     friend class ContactManager;
+    friend class TestBackdoors;
     friend struct Private;
     Private *mPriv;
 };
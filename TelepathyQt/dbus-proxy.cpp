@@ -27,6 +27,7 @@
 #include "TelepathyQt/_gen/dbus-proxy.moc.hpp"
 
 #include "TelepathyQt/debug-internal.h"
+#include "TelepathyQt/peer-transport-internal.h"
 
 #include <TelepathyQt/Constants>
 
@@ -59,6 +60,8 @@ struct TP_QT_NO_EXPORT DBusProxy::Private
     QString objectPath;
     QString invalidationReason;
     QString invalidationMessage;
+    // Name of the direct connection to the service to use instead of the bus, see PeerTransport
+    QString peerName;
 };
 
 DBusProxy::Private::Private(const QDBusConnection &dbusConnection,
@@ -67,7 +70,7 @@ DBusProxy::Private::Private(const QDBusConnection &dbusConnection,
       busName(busName),
       objectPath(objectPath)
 {
-    debug() << "Creating new DBusProxy";
+    tpDebug(logGeneral) << "Creating new DBusProxy";
 }
 
 /**
@@ -196,7 +199,7 @@ QString DBusProxy::invalidationMessage() const
 void DBusProxy::invalidate(const QString &reason, const QString &message)
 {
     if (!isValid()) {
-        debug().nospace() << "Already invalidated by "
+        tpDebug(logGeneral).nospace() << "Already invalidated by "
             << mPriv->invalidationReason
             << ", not replacing with " << reason
             << " \"" << message << "\"";
@@ -205,7 +208,7 @@ void DBusProxy::invalidate(const QString &reason, const QString &message)
 
     Q_ASSERT(!reason.isEmpty());
 
-    debug().nospace() << "proxy invalidated: " << reason
+    tpDebug(logGeneral).nospace() << "proxy invalidated: " << reason
         << ": " << message;
 
     mPriv->invalidationReason = reason;
@@ -245,6 +248,16 @@ void DBusProxy::emitInvalidated()
  * \param errorMessage A debugging message associated with the error.
  */
 
+QString PeerTransport::peerName(const DBusProxy *proxy)
+{
+    return proxy->mPriv->peerName;
+}
+
+void PeerTransport::setPeerName(DBusProxy *proxy, const QString &name)
+{
+    proxy->mPriv->peerName = name;
+}
+
 // ==== StatefulDBusProxy ==============================================
 
 struct TP_QT_NO_EXPORT StatefulDBusProxy::Private
@@ -312,8 +325,9 @@ QString StatefulDBusProxy::uniqueNameFrom(const QDBusConnection &bus, const QStr
     QString error, message;
     QString uniqueName = uniqueNameFrom(bus, name, error, message);
     if (uniqueName.isEmpty()) {
-        warning() << "StatefulDBusProxy::uniqueNameFrom(): Failed to get unique name of" << name;
-        warning() << "  error:" << error << "message:" << message;
+        tpWarning(logGeneral) <<
+            "StatefulDBusProxy::uniqueNameFrom(): Failed to get unique name of" << name;
+        tpWarning(logGeneral) << "  error:" << error << "message:" << message;
     }
 
     return uniqueName;
@@ -378,7 +392,7 @@ StatelessDBusProxy::StatelessDBusProxy(const QDBusConnection &dbusConnection,
       mPriv(0)
 {
     if (busName.startsWith(QLatin1String(":"))) {
-        warning() <<
+        tpWarning(logGeneral) <<
             "Using StatelessDBusProxy for a unique name does not make sense";
     }
 }
@@ -37,6 +37,7 @@ class QDBusError;
 namespace Tp
 {
 
+class PeerTransport;
 class TestBackdoors;
 
 class TP_QT_EXPORT DBusProxy : public Object, public ReadyObject
@@ -70,6 +71,7 @@ private Q_SLOTS:
     TP_QT_NO_EXPORT void emitInvalidated();
 
 private:
+    friend class PeerTransport;
     friend class TestBackdoors;
 
     struct Private;
@@ -168,7 +168,7 @@ bool DBusService::registerObject(const QString &busName, const QString &objectPa
         error->set(TP_QT_ERROR_INVALID_ARGUMENT,
                 QString(QLatin1String("Object at path %1 already registered"))
                     .arg(objectPath));
-        warning() << "Unable to register object" << objectPath <<
+        tpWarning(logService) << "Unable to register object" << objectPath <<
             "- path already registered";
         return false;
     }
@@ -178,12 +178,12 @@ bool DBusService::registerObject(const QString &busName, const QString &objectPa
         error->set(TP_QT_ERROR_INVALID_ARGUMENT,
                 QString(QLatin1String("Name %1 already in use by another process"))
                     .arg(busName));
-        warning() << "Unable to register service" << busName <<
+        tpWarning(logService) << "Unable to register service" << busName <<
             "- name already registered by another process";
         return false;
     }
 
-    debug() << "Registered object" << objectPath << "at bus name" << busName;
+    tpDebug(logService) << "Registered object" << objectPath << "at bus name" << busName;
 
     mPriv->busName = busName;
     mPriv->dbusObject->setObjectPath(objectPath);
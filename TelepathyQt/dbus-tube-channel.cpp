@@ -129,7 +129,7 @@ void DBusTubeChannel::Private::introspectBusNamesMonitoring(DBusTubeChannel::Pri
         connect(dbusTubeInterface->requestPropertyDBusNames(), SIGNAL(finished(Tp::PendingOperation*)),
                 parent, SLOT(onRequestPropertyDBusNamesFinished(Tp::PendingOperation*)));
     } else {
-        debug() << "FeatureBusNameMonitoring does not make sense in a P2P context";
+        tpDebug(logTubes) << "FeatureBusNameMonitoring does not make sense in a P2P context";
         self->readinessHelper->setIntrospectCompleted(DBusTubeChannel::FeatureBusNameMonitoring, false);
     }
 }
@@ -138,7 +138,7 @@ void DBusTubeChannel::Private::introspectDBusTube(DBusTubeChannel::Private *self
 {
     DBusTubeChannel *parent = self->parent;
 
-    debug() << "Introspect dbus tube properties";
+    tpDebug(logTubes) << "Introspect dbus tube properties";
 
     if (parent->immutableProperties().contains(TP_QT_IFACE_CHANNEL_TYPE_DBUS_TUBE + QLatin1String(".ServiceName")) &&
         parent->immutableProperties().contains(TP_QT_IFACE_CHANNEL_TYPE_DBUS_TUBE + QLatin1String(".SupportedAccessControls"))) {
@@ -245,7 +245,7 @@ DBusTubeChannel::~DBusTubeChannel()
 QString DBusTubeChannel::serviceName() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "DBusTubeChannel::serviceName() used with "
+        tpWarning(logTubes) << "DBusTubeChannel::serviceName() used with "
             "FeatureCore not ready";
         return QString();
     }
@@ -277,7 +277,7 @@ QString DBusTubeChannel::serviceName() const
 bool DBusTubeChannel::supportsRestrictingToCurrentUser() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "DBusTubeChannel::supportsRestrictingToCurrentUser() used with "
+        tpWarning(logTubes) << "DBusTubeChannel::supportsRestrictingToCurrentUser() used with "
             "FeatureCore not ready";
         return false;
     }
@@ -303,7 +303,7 @@ bool DBusTubeChannel::supportsRestrictingToCurrentUser() const
 QString DBusTubeChannel::address() const
 {
     if (state() != TubeChannelStateOpen) {
-        warning() << "DBusTubeChannel::address() can be called only if "
+        tpWarning(logTubes) << "DBusTubeChannel::address() can be called only if "
             "the tube has already been opened";
         return QString();
     }
@@ -328,7 +328,7 @@ QString DBusTubeChannel::address() const
 QHash<QString, Tp::ContactPtr> DBusTubeChannel::contactsForBusNames() const
 {
     if (!isReady(FeatureBusNameMonitoring)) {
-        warning() << "DBusTubeChannel::contactsForBusNames() used with "
+        tpWarning(logTubes) << "DBusTubeChannel::contactsForBusNames() used with "
             "FeatureBusNameMonitoring not ready";
         return QHash<QString, Tp::ContactPtr>();
     }
@@ -339,7 +339,7 @@ QHash<QString, Tp::ContactPtr> DBusTubeChannel::contactsForBusNames() const
 void DBusTubeChannel::onRequestAllPropertiesFinished(PendingOperation *op)
 {
     if (!op->isError()) {
-        debug() << "RequestAllProperties succeeded";
+        tpDebug(logTubes) << "RequestAllProperties succeeded";
         PendingVariantMap *result = qobject_cast<PendingVariantMap*>(op);
 
         QVariantMap map = result->result();
@@ -353,7 +353,7 @@ void DBusTubeChannel::onRequestAllPropertiesFinished(PendingOperation *op)
         mPriv->extractProperties(qualifiedMap);
         mPriv->readinessHelper->setIntrospectCompleted(DBusTubeChannel::FeatureCore, true);
     } else {
-        warning().nospace() << "RequestAllProperties failed "
+        tpWarning(logTubes).nospace() << "RequestAllProperties failed "
             "with " << op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(DBusTubeChannel::FeatureCore, false);
     }
@@ -362,7 +362,7 @@ void DBusTubeChannel::onRequestAllPropertiesFinished(PendingOperation *op)
 void DBusTubeChannel::onRequestPropertyDBusNamesFinished(PendingOperation *op)
 {
     if (!op->isError()) {
-        debug() << "RequestPropertyDBusNames succeeded";
+        tpDebug(logTubes) << "RequestPropertyDBusNames succeeded";
         PendingVariant *result = qobject_cast<PendingVariant*>(op);
         DBusTubeParticipants participants = qdbus_cast<DBusTubeParticipants>(result->result());
 
@@ -378,7 +378,7 @@ void DBusTubeChannel::onRequestPropertyDBusNamesFinished(PendingOperation *op)
             mPriv->extractParticipants(participants);
         }
     } else {
-        warning().nospace() << "RequestPropertyDBusNames failed "
+        tpWarning(logTubes).nospace() << "RequestPropertyDBusNames failed "
             "with " << op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(DBusTubeChannel::FeatureBusNameMonitoring, false);
     }
@@ -386,7 +386,7 @@ void DBusTubeChannel::onRequestPropertyDBusNamesFinished(PendingOperation *op)
 
 void DBusTubeChannel::onQueueCompleted()
 {
-    debug() << "Queue was completed";
+    tpDebug(logTubes) << "Queue was completed";
 
     // Set the feature as completed, and disconnect the signal as it's no longer useful
     mPriv->readinessHelper->setIntrospectCompleted(DBusTubeChannel::FeatureBusNameMonitoring, true);
@@ -442,12 +442,12 @@ void DBusTubeChannel::onContactsRetrieved(const QUuid &uuid, const QList<Contact
                     emit busNameRemoved(busName, contact);
                 }
             } else {
-                warning() << "Trying to remove a bus name for contact " << contact->id()
+                tpWarning(logTubes) << "Trying to remove a bus name for contact " << contact->id()
                           << " which has not been retrieved previously!";
             }
         }
     } else {
-        warning() << "Contacts retrieved but no pending bus names were found";
+        tpWarning(logTubes) << "Contacts retrieved but no pending bus names were found";
         return;
     }
 }
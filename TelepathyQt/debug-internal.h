@@ -94,7 +94,7 @@ public:
     }
 
     template <typename T>
-    inline Debug &operator<<(T a)
+    inline Debug &operator<<(const T &a)
     {
         if (debug) {
             (*debug) << a;
@@ -112,6 +112,34 @@ private:
     void invokeDebugCallback();
 };
 
+// Per-subsystem debug categories. tpDebug() and tpWarning() check the flags inline, before any of
+// the streamed arguments are evaluated, so disabled statements cost a single branch.
+struct DebugCategory
+{
+    const char *name;
+    bool debugEnabled;
+    bool warningsEnabled;
+};
+
+TP_QT_EXPORT extern DebugCategory logGeneral;
+TP_QT_EXPORT extern DebugCategory logAccounts;
+TP_QT_EXPORT extern DebugCategory logConnections;
+TP_QT_EXPORT extern DebugCategory logContacts;
+TP_QT_EXPORT extern DebugCategory logChannels;
+TP_QT_EXPORT extern DebugCategory logTubes;
+TP_QT_EXPORT extern DebugCategory logClients;
+TP_QT_EXPORT extern DebugCategory logService;
+
+// Binary trace ring, see enableTracing(). Events are stored unformatted in a preallocated ring
+// and only turned into text by dumpTrace(), so \a event must be a string literal. Events which
+// need to say what they are about, such as which feature was introspected, can carry a \a detail
+// string obtained from traceString(), which stays valid for the lifetime of the process. As that
+// takes a lock, the string should be interned once up front rather than for every event.
+TP_QT_EXPORT extern bool tracingEnabled;
+TP_QT_EXPORT void recordTrace(const DebugCategory &category, const char *event,
+        const void *object, qint64 value, const char *detail = 0);
+TP_QT_EXPORT const char *traceString(const QString &string);
+
 // The telepathy-farsight Qt 4 binding links to these - they're not API outside
 // this source tarball, but they *are* ABI
 TP_QT_EXPORT Debug enabledDebug();
@@ -119,6 +147,28 @@ TP_QT_EXPORT Debug enabledWarning();
 
 #ifdef ENABLE_DEBUG
 
+#define tpDebug(category) \
+    for (bool tpLogEnabled = (category).debugEnabled; tpLogEnabled; tpLogEnabled = false) \
+        Tp::Debug(QtDebugMsg)
+
+#define tpWarning(category) \
+    for (bool tpLogEnabled = (category).warningsEnabled; tpLogEnabled; tpLogEnabled = false) \
+        Tp::Debug(QtWarningMsg)
+
+#define tpTrace(category, event, object, value) \
+    do { \
+        if (Tp::tracingEnabled) { \
+            Tp::recordTrace(category, event, object, value); \
+        } \
+    } while (0)
+
+#define tpTraceDetail(category, event, object, value, detail) \
+    do { \
+        if (Tp::tracingEnabled) { \
+            Tp::recordTrace(category, event, object, value, detail); \
+        } \
+    } while (0)
+
 inline Debug debug()
 {
     return enabledDebug();
@@ -155,6 +205,11 @@ struct NoDebug
     }
 };
 
+#define tpDebug(category) while (false) Tp::NoDebug()
+#define tpWarning(category) while (false) Tp::NoDebug()
+#define tpTrace(category, event, object, value) do { } while (0)
+#define tpTraceDetail(category, event, object, value, detail) do { } while (0)
+
 inline NoDebug debug()
 {
     return NoDebug();
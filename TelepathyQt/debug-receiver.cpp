@@ -150,7 +150,8 @@ PendingDebugMessageList *DebugReceiver::fetchMessages()
 PendingOperation *DebugReceiver::setMonitoringEnabled(bool enabled)
 {
     if (!isReady()) {
-        warning() << "DebugReceiver::setMonitoringEnabled called without DebugReceiver being ready";
+        tpWarning(logGeneral) <<
+            "DebugReceiver::setMonitoringEnabled called without DebugReceiver being ready";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("FeatureCore is not ready"), DebugReceiverPtr(this));
     }
@@ -26,6 +26,12 @@
 
 #include "config-version.h"
 
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+
 /**
  * \defgroup debug Common debug support
  *
@@ -37,6 +43,15 @@
  * warning messages. Normal debug output results in the normal operation of the
  * library, warning messages are output only when something goes wrong. Each
  * category can be invidually enabled.
+ *
+ * Output is further divided into subsystem categories, as listed by
+ * debugCategories(), which can be enabled individually with
+ * enableCategoryDebug() and enableCategoryWarnings(). Statements for a
+ * disabled category cost a single branch, their arguments are not evaluated.
+ *
+ * For diagnosing problems without the cost of formatting messages, a binary
+ * trace of internal events can be recorded into a fixed size ring buffer with
+ * enableTracing() and dumped on demand with dumpTrace().
  */
 
 namespace Tp
@@ -94,6 +109,121 @@ namespace Tp
  * \sa DebugCallback
  */
 
+/**
+ * \fn QStringList debugCategories()
+ * \ingroup debug
+ *
+ * Return the names of the subsystem categories debug output is divided into,
+ * for use with enableCategoryDebug() and enableCategoryWarnings().
+ *
+ * \return The list of category names.
+ */
+
+/**
+ * \fn void enableCategoryDebug(const QString &category, bool enable)
+ * \ingroup debug
+ *
+ * Enable or disable normal debug output for the given subsystem \a category
+ * only. enableDebug() changes the setting of all categories at once.
+ *
+ * If the library is not compiled with debug support enabled, this has no
+ * effect.
+ *
+ * \param category The name of the category, as returned by debugCategories().
+ * \param enable Whether debug output should be enabled or not.
+ */
+
+/**
+ * \fn void enableCategoryWarnings(const QString &category, bool enable)
+ * \ingroup debug
+ *
+ * Enable or disable warning output for the given subsystem \a category only.
+ * enableWarnings() changes the setting of all categories at once.
+ *
+ * If the library is not compiled with debug support enabled, this has no
+ * effect.
+ *
+ * \param category The name of the category, as returned by debugCategories().
+ * \param enable Whether warnings should be enabled or not.
+ */
+
+/**
+ * \fn void enableTracing(bool enable)
+ * \ingroup debug
+ *
+ * Enable or disable recording of internal events into the trace buffer.
+ *
+ * Trace events are stored in binary form in a preallocated ring buffer which
+ * keeps the most recent events, so tracing can be left enabled in production
+ * and dumped with dumpTrace() when something goes wrong. Enabling tracing
+ * clears the buffer; disabling it keeps the recorded events for dumping.
+ *
+ * If the library is not compiled with debug support enabled, this has no
+ * effect.
+ *
+ * The default is <code>false</code> ie. no events are recorded.
+ *
+ * \param enable Whether tracing should be enabled or not.
+ */
+
+/**
+ * \fn void dumpTrace()
+ * \ingroup debug
+ *
+ * Output the events currently in the trace buffer, oldest first, as debug
+ * messages. The messages are passed to the debug callback set with
+ * setDebugCallback() regardless of whether debug output is enabled.
+ *
+ * \sa enableTracing()
+ */
+
+DebugCategory logGeneral = { "tp-qt", false, true };
+DebugCategory logAccounts = { "tp-qt.accounts", false, true };
+DebugCategory logConnections = { "tp-qt.connections", false, true };
+DebugCategory logContacts = { "tp-qt.contacts", false, true };
+DebugCategory logChannels = { "tp-qt.channels", false, true };
+DebugCategory logTubes = { "tp-qt.tubes", false, true };
+DebugCategory logClients = { "tp-qt.clients", false, true };
+DebugCategory logService = { "tp-qt.service", false, true };
+
+bool tracingEnabled = false;
+
+namespace
+{
+
+DebugCategory * const categories[] = {
+    &logGeneral,
+    &logAccounts,
+    &logConnections,
+    &logContacts,
+    &logChannels,
+    &logTubes,
+    &logClients,
+    &logService
+};
+const int numCategories = sizeof(categories) / sizeof(categories[0]);
+
+DebugCategory *findCategory(const QString &name)
+{
+    for (int i = 0; i < numCategories; ++i) {
+        if (name == QLatin1String(categories[i]->name)) {
+            return categories[i];
+        }
+    }
+    return 0;
+}
+
+}
+
+QStringList debugCategories()
+{
+    QStringList ret;
+    for (int i = 0; i < numCategories; ++i) {
+        ret << QLatin1String(categories[i]->name);
+    }
+    return ret;
+}
+
 #ifdef ENABLE_DEBUG
 
 namespace
@@ -101,16 +231,145 @@ namespace
 bool debugEnabled = false;
 bool warningsEnabled = true;
 DebugCallback debugCallback = NULL;
+
+struct TraceEvent
+{
+    // 0 while the slot is being written, otherwise 1 + the number of the event it holds
+    QAtomicInt sequence;
+    qint64 nsecs;
+    const DebugCategory *category;
+    const char *event;
+    const void *object;
+    qint64 value;
+    const char *detail;
+};
+
+const int traceRingSize = 4096;
+TraceEvent traceRing[traceRingSize];
+QAtomicInt traceCount;
+QElapsedTimer traceTimer;
+
+struct TraceStrings
+{
+    QMutex mutex;
+    QSet<QByteArray> strings;
+};
+
+Q_GLOBAL_STATIC(TraceStrings, traceStrings)
 }
 
 void enableDebug(bool enable)
 {
     debugEnabled = enable;
+    for (int i = 0; i < numCategories; ++i) {
+        categories[i]->debugEnabled = enable;
+    }
 }
 
 void enableWarnings(bool enable)
 {
     warningsEnabled = enable;
+    for (int i = 0; i < numCategories; ++i) {
+        categories[i]->warningsEnabled = enable;
+    }
+}
+
+void enableCategoryDebug(const QString &category, bool enable)
+{
+    DebugCategory *cat = findCategory(category);
+    if (!cat) {
+        tpWarning(logGeneral) << "Unknown debug category" << category;
+        return;
+    }
+    cat->debugEnabled = enable;
+}
+
+void enableCategoryWarnings(const QString &category, bool enable)
+{
+    DebugCategory *cat = findCategory(category);
+    if (!cat) {
+        tpWarning(logGeneral) << "Unknown debug category" << category;
+        return;
+    }
+    cat->warningsEnabled = enable;
+}
+
+void enableTracing(bool enable)
+{
+    if (enable && !tracingEnabled) {
+        // Forget the events of a previous session, whose sequence numbers would be reused
+        for (int i = 0; i < traceRingSize; ++i) {
+            traceRing[i].sequence.fetchAndStoreRelaxed(0);
+        }
+        traceCount = 0;
+        traceTimer.start();
+    }
+    tracingEnabled = enable;
+}
+
+void recordTrace(const DebugCategory &category, const char *event,
+        const void *object, qint64 value, const char *detail)
+{
+    // Concurrent writers each claim their own slot, and only publish its sequence number once
+    // the event is fully written, so that dumpTrace() can skip slots which are being written
+    uint index = (uint) traceCount.fetchAndAddOrdered(1);
+    TraceEvent &ev = traceRing[index % traceRingSize];
+    ev.sequence.fetchAndStoreOrdered(0);
+    ev.nsecs = traceTimer.nsecsElapsed();
+    ev.category = &category;
+    ev.event = event;
+    ev.object = object;
+    ev.value = value;
+    ev.detail = detail;
+    ev.sequence.fetchAndStoreRelease((int) (index + 1));
+}
+
+const char *traceString(const QString &string)
+{
+    // Only used for small, fixed sets of strings such as feature class names, so the strings
+    // are never freed; the data of a QByteArray in a QSet doesn't move when the set grows
+    TraceStrings *ts = traceStrings();
+    QByteArray latin1 = string.toLatin1();
+    QMutexLocker locker(&ts->mutex);
+    QSet<QByteArray>::const_iterator it = ts->strings.constFind(latin1);
+    if (it == ts->strings.constEnd()) {
+        it = ts->strings.insert(latin1);
+    }
+    return it->constData();
+}
+
+void dumpTrace()
+{
+    uint count = (uint) traceCount.fetchAndAddOrdered(0);
+    uint first = count > (uint) traceRingSize ? count - traceRingSize : 0;
+
+    Debug(QtDebugMsg) << "Trace buffer holds" << (count - first) << "of" << count << "events";
+    for (uint i = first; i < count; ++i) {
+        TraceEvent &slot = traceRing[i % traceRingSize];
+        int sequence = (int) (i + 1);
+
+        // Copy the event out and check that it was published before and is still the same after,
+        // skipping it if it is still being written or was overwritten in the meantime
+        if (slot.sequence.fetchAndAddAcquire(0) != sequence) {
+            continue;
+        }
+        qint64 nsecs = slot.nsecs;
+        const DebugCategory *category = slot.category;
+        const char *event = slot.event;
+        const void *object = slot.object;
+        qint64 value = slot.value;
+        const char *detail = slot.detail;
+        if (slot.sequence.fetchAndAddOrdered(0) != sequence) {
+            continue;
+        }
+
+        Debug line(QtDebugMsg);
+        line.nospace() << "[" << (nsecs / 1000) << "us] " <<
+            category->name << ": " << event << " " << object << " " << value;
+        if (detail) {
+            line << " " << detail;
+        }
+    }
 }
 
 void setDebugCallback(DebugCallback cb)
@@ -120,7 +379,6 @@ void setDebugCallback(DebugCallback cb)
 
 Debug enabledDebug()
 {
-    return Debug(QtDebugMsg);
     if (debugEnabled) {
         return Debug(QtDebugMsg);
     } else {
@@ -169,6 +427,32 @@ void setDebugCallback(DebugCallback cb)
 {
 }
 
+void enableCategoryDebug(const QString &category, bool enable)
+{
+}
+
+void enableCategoryWarnings(const QString &category, bool enable)
+{
+}
+
+void enableTracing(bool enable)
+{
+}
+
+void recordTrace(const DebugCategory &category, const char *event,
+        const void *object, qint64 value, const char *detail)
+{
+}
+
+const char *traceString(const QString &string)
+{
+    return 0;
+}
+
+void dumpTrace()
+{
+}
+
 Debug enabledDebug()
 {
     return Debug();
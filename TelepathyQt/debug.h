@@ -29,12 +29,21 @@
 
 #include <TelepathyQt/Global>
 
+#include <QStringList>
+
 namespace Tp
 {
 
 TP_QT_EXPORT void enableDebug(bool enable);
 TP_QT_EXPORT void enableWarnings(bool enable);
 
+TP_QT_EXPORT QStringList debugCategories();
+TP_QT_EXPORT void enableCategoryDebug(const QString &category, bool enable);
+TP_QT_EXPORT void enableCategoryWarnings(const QString &category, bool enable);
+
+TP_QT_EXPORT void enableTracing(bool enable);
+TP_QT_EXPORT void dumpTrace();
+
 typedef void (*DebugCallback)(const QString &libraryName,
                               const QString &libraryVersion,
                               QtMsgType type,
@@ -0,0 +1,92 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2026 agent <agent@local>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _TelepathyQt_feature_internal_h_HEADER_GUARD_
+#define _TelepathyQt_feature_internal_h_HEADER_GUARD_
+
+#include <TelepathyQt/Feature>
+
+#include <QVarLengthArray>
+
+namespace Tp
+{
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+struct TP_QT_NO_EXPORT Feature::Private : public QSharedData
+{
+    Private(const QString &className, uint id, bool critical);
+
+    bool critical;
+    // Dense process-wide index of the (className, id) pair, see FeatureSet
+    int index;
+    // Class name interned with traceString() when the pair was registered, so that tracing
+    // feature introspection doesn't convert and look it up again every time
+    const char *traceName;
+};
+
+// Bitset over the dense feature indexes, so that the set operations done on every readiness
+// check are word operations instead of hashing and comparing class name strings. Features stays
+// the public type; this is only used internally where set operations are hot.
+class TP_QT_NO_EXPORT FeatureSet
+{
+public:
+    FeatureSet() { }
+    FeatureSet(const Feature &feature) { insert(feature); }
+    FeatureSet(const Features &features);
+
+    static int indexOf(const Feature &feature)
+    {
+        return feature.isValid() ? feature.mPriv->index : -1;
+    }
+
+    static const char *traceNameOf(const Feature &feature)
+    {
+        return feature.isValid() ? feature.mPriv->traceName : 0;
+    }
+
+    bool isEmpty() const;
+
+    bool contains(const Feature &feature) const
+    {
+        int index = indexOf(feature);
+        return index >= 0 && index / 64 < mWords.size() &&
+            (mWords[index / 64] & (Q_UINT64_C(1) << (index % 64)));
+    }
+    bool contains(const FeatureSet &other) const;
+    bool intersects(const FeatureSet &other) const;
+
+    void insert(const Feature &feature);
+    void remove(const Feature &feature);
+    void clear() { mWords.clear(); }
+
+    FeatureSet &operator|=(const FeatureSet &other);
+    FeatureSet operator|(const FeatureSet &other) const { return FeatureSet(*this) |= other; }
+
+private:
+    QVarLengthArray<quint64, 2> mWords;
+};
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+} // Tp
+
+#endif
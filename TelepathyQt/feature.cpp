@@ -21,17 +21,130 @@
  */
 
 #include <TelepathyQt/Feature>
+#include "TelepathyQt/feature-internal.h"
+
+#include "TelepathyQt/debug-internal.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
 
 namespace Tp
 {
 
-struct TP_QT_NO_EXPORT Feature::Private : public QSharedData
+namespace
 {
-    Private(bool critical) : critical(critical) {}
 
-    bool critical;
+struct FeatureRegistration
+{
+    int index;
+    const char *traceName;
 };
 
+// Most features are static members constructed during static initialization, which is when
+// they get registered; the lock is for the ones constructed later from arbitrary threads.
+FeatureRegistration registerFeature(const QString &className, uint id)
+{
+    static QMutex mutex;
+    static QHash<QPair<QString, uint>, FeatureRegistration> registrations;
+
+    QMutexLocker locker(&mutex);
+    QPair<QString, uint> key(className, id);
+    QHash<QPair<QString, uint>, FeatureRegistration>::const_iterator i =
+        registrations.constFind(key);
+    if (i != registrations.constEnd()) {
+        return i.value();
+    }
+
+    FeatureRegistration registration;
+    registration.index = registrations.size();
+    registration.traceName = traceString(className);
+    registrations.insert(key, registration);
+    return registration;
+}
+
+}
+
+Feature::Private::Private(const QString &className, uint id, bool critical)
+    : critical(critical)
+{
+    FeatureRegistration registration = registerFeature(className, id);
+    index = registration.index;
+    traceName = registration.traceName;
+}
+
+FeatureSet::FeatureSet(const Features &features)
+{
+    foreach (const Feature &feature, features) {
+        insert(feature);
+    }
+}
+
+bool FeatureSet::isEmpty() const
+{
+    for (int i = 0; i < mWords.size(); ++i) {
+        if (mWords[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FeatureSet::contains(const FeatureSet &other) const
+{
+    for (int i = 0; i < other.mWords.size(); ++i) {
+        quint64 word = i < mWords.size() ? mWords[i] : 0;
+        if (other.mWords[i] & ~word) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FeatureSet::intersects(const FeatureSet &other) const
+{
+    int size = qMin(mWords.size(), other.mWords.size());
+    for (int i = 0; i < size; ++i) {
+        if (mWords[i] & other.mWords[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FeatureSet::insert(const Feature &feature)
+{
+    int index = indexOf(feature);
+    if (index < 0) {
+        return;
+    }
+
+    int word = index / 64;
+    while (mWords.size() <= word) {
+        mWords.append(0);
+    }
+    mWords[word] |= Q_UINT64_C(1) << (index % 64);
+}
+
+void FeatureSet::remove(const Feature &feature)
+{
+    int index = indexOf(feature);
+    if (index >= 0 && index / 64 < mWords.size()) {
+        mWords[index / 64] &= ~(Q_UINT64_C(1) << (index % 64));
+    }
+}
+
+FeatureSet &FeatureSet::operator|=(const FeatureSet &other)
+{
+    while (mWords.size() < other.mWords.size()) {
+        mWords.append(0);
+    }
+    for (int i = 0; i < other.mWords.size(); ++i) {
+        mWords[i] |= other.mWords[i];
+    }
+    return *this;
+}
+
 /**
  * \class Feature
  * \ingroup utils
@@ -48,7 +161,7 @@ Feature::Feature()
 
 Feature::Feature(const QString &className, uint id, bool critical)
     : QPair<QString, uint>(className, id),
-      mPriv(new Private(critical))
+      mPriv(new Private(className, id, critical))
 {
 }
 
@@ -64,7 +177,7 @@ Feature::~Feature()
 
 Feature &Feature::operator=(const Feature &other)
 {
-    *this = other;
+    QPair<QString, uint>::operator=(other);
     this->mPriv = other.mPriv;
     return *this;
 }
@@ -53,6 +53,8 @@ public:
     bool isCritical() const;
 
 private:
+    friend class FeatureSet;
+
     struct Private;
     friend struct Private;
     QSharedDataPointer<Private> mPriv;
@@ -61,7 +61,7 @@ struct TP_QT_NO_EXPORT FileTransferChannelCreationProperties::Private : public Q
             // Set optional parameters
             lastModificationTime = fileInfo.lastModified();
         } else {
-            warning() << path << "is not a local file.";
+            tpWarning(logChannels) << path << "is not a local file.";
         }
     }
 
@@ -433,7 +433,7 @@ QString FileTransferChannelCreationProperties::uri() const
 QVariantMap FileTransferChannelCreationProperties::createRequest() const
 {
     if (!isValid()) {
-        warning() << "Invalid file transfer creation properties";
+        tpWarning(logChannels) << "Invalid file transfer creation properties";
         return QVariantMap();
     }
 
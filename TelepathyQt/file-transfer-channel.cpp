@@ -228,7 +228,7 @@ FileTransferChannel::~FileTransferChannel()
 FileTransferState FileTransferChannel::state() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        tpWarning(logChannels) << "FileTransferChannel::FeatureCore must be ready before "
             "calling state";
     }
 
@@ -248,7 +248,7 @@ FileTransferState FileTransferChannel::state() const
 FileTransferStateChangeReason FileTransferChannel::stateReason() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        tpWarning(logChannels) << "FileTransferChannel::FeatureCore must be ready before "
             "calling stateReason";
     }
 
@@ -272,7 +272,7 @@ FileTransferStateChangeReason FileTransferChannel::stateReason() const
 QString FileTransferChannel::fileName() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        tpWarning(logChannels) << "FileTransferChannel::FeatureCore must be ready before "
             "calling fileName";
     }
 
@@ -291,7 +291,7 @@ QString FileTransferChannel::fileName() const
 QString FileTransferChannel::contentType() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        tpWarning(logChannels) << "FileTransferChannel::FeatureCore must be ready before "
             "calling contentType";
     }
 
@@ -316,7 +316,7 @@ QString FileTransferChannel::contentType() const
 qulonglong FileTransferChannel::size() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        tpWarning(logChannels) << "FileTransferChannel::FeatureCore must be ready before "
             "calling size";
     }
 
@@ -340,7 +340,7 @@ qulonglong FileTransferChannel::size() const
 QString FileTransferChannel::uri() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        tpWarning(logChannels) << "FileTransferChannel::FeatureCore must be ready before "
             "calling uri";
     }
 
@@ -358,7 +358,7 @@ QString FileTransferChannel::uri() const
 FileHashType FileTransferChannel::contentHashType() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        tpWarning(logChannels) << "FileTransferChannel::FeatureCore must be ready before "
             "calling contentHashType";
     }
 
@@ -381,7 +381,7 @@ FileHashType FileTransferChannel::contentHashType() const
 QString FileTransferChannel::contentHash() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        tpWarning(logChannels) << "FileTransferChannel::FeatureCore must be ready before "
             "calling contentHash";
     }
 
@@ -404,7 +404,7 @@ QString FileTransferChannel::contentHash() const
 QString FileTransferChannel::description() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        tpWarning(logChannels) << "FileTransferChannel::FeatureCore must be ready before "
             "calling description";
     }
 
@@ -422,7 +422,7 @@ QString FileTransferChannel::description() const
 QDateTime FileTransferChannel::lastModificationTime() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        tpWarning(logChannels) << "FileTransferChannel::FeatureCore must be ready before "
             "calling lastModificationTime";
     }
 
@@ -440,7 +440,7 @@ QDateTime FileTransferChannel::lastModificationTime() const
 qulonglong FileTransferChannel::initialOffset() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        tpWarning(logChannels) << "FileTransferChannel::FeatureCore must be ready before "
             "calling initialOffset";
     }
 
@@ -460,7 +460,7 @@ qulonglong FileTransferChannel::initialOffset() const
 qulonglong FileTransferChannel::transferredBytes() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        tpWarning(logChannels) << "FileTransferChannel::FeatureCore must be ready before "
             "calling transferredBytes";
     }
 
@@ -483,7 +483,7 @@ qulonglong FileTransferChannel::transferredBytes() const
 SupportedSocketMap FileTransferChannel::availableSocketTypes() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        tpWarning(logChannels) << "FileTransferChannel::FeatureCore must be ready before "
             "calling availableSocketTypes";
     }
 
@@ -580,11 +580,11 @@ void FileTransferChannel::gotProperties(QDBusPendingCallWatcher *watcher)
     if (!reply.isError()) {
         QVariantMap props = reply.value();
         mPriv->extractProperties(props);
-        debug() << "Got reply to Properties::GetAll(FileTransferChannel)";
+        tpDebug(logChannels) << "Got reply to Properties::GetAll(FileTransferChannel)";
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, true);
     }
     else {
-        warning().nospace() << "Properties::GetAll(FileTransferChannel) failed "
+        tpWarning(logChannels).nospace() << "Properties::GetAll(FileTransferChannel) failed "
             "with " << reply.error().name() << ": " << reply.error().message();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
                 reply.error());
@@ -609,7 +609,7 @@ void FileTransferChannel::onStateChanged(uint state, uint stateReason)
         return;
     }
 
-    debug() << "File transfer state changed to" << state <<
+    tpDebug(logChannels) << "File transfer state changed to" << state <<
         "with reason" << stateReason;
     mPriv->pendingState = (FileTransferState) state;
     mPriv->pendingStateReason = (FileTransferStateChangeReason) stateReason;
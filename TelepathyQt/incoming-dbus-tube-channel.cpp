@@ -153,7 +153,7 @@ PendingDBusTubeConnection *IncomingDBusTubeChannel::acceptTube(bool allowOtherUs
                                         SocketAccessControlCredentials;
 
     if (!isReady(DBusTubeChannel::FeatureCore)) {
-        warning() << "DBusTubeChannel::FeatureCore must be ready before "
+        tpWarning(logTubes) << "DBusTubeChannel::FeatureCore must be ready before "
             "calling acceptTube";
         return new PendingDBusTubeConnection(QLatin1String(TP_QT_ERROR_NOT_AVAILABLE),
                 QLatin1String("Channel not ready"), IncomingDBusTubeChannelPtr(this));
@@ -161,14 +161,14 @@ PendingDBusTubeConnection *IncomingDBusTubeChannel::acceptTube(bool allowOtherUs
 
     // The tube must be in local pending state
     if (state() != TubeChannelStateLocalPending) {
-        warning() << "You can accept tubes only when they are in LocalPending state";
+        tpWarning(logTubes) << "You can accept tubes only when they are in LocalPending state";
         return new PendingDBusTubeConnection(QLatin1String(TP_QT_ERROR_NOT_AVAILABLE),
                 QLatin1String("Channel busy"), IncomingDBusTubeChannelPtr(this));
     }
 
     // Let's accept the tube
     if (!allowOtherUsers && !supportsRestrictingToCurrentUser()) {
-        warning() << "Current user restriction is not available for this tube, "
+        tpWarning(logTubes) << "Current user restriction is not available for this tube, "
             "falling back to allowing any connection";
         accessControl = SocketAccessControlLocalhost;
     }
@@ -166,7 +166,7 @@ IncomingFileTransferChannel::~IncomingFileTransferChannel()
 PendingOperation *IncomingFileTransferChannel::setUri(const QString& uri)
 {
     if (!isReady(FileTransferChannel::FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        tpWarning(logChannels) << "FileTransferChannel::FeatureCore must be ready before "
             "calling setUri";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel not ready"),
@@ -174,7 +174,7 @@ PendingOperation *IncomingFileTransferChannel::setUri(const QString& uri)
     }
 
     if (state() != FileTransferStatePending) {
-        warning() << "setUri must be called before calling acceptFile";
+        tpWarning(logChannels) << "setUri must be called before calling acceptFile";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Cannot set URI after calling acceptFile"),
                 IncomingFileTransferChannelPtr(this));
@@ -218,7 +218,7 @@ PendingOperation *IncomingFileTransferChannel::acceptFile(qulonglong offset,
         QIODevice *output)
 {
     if (!isReady(FileTransferChannel::FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        tpWarning(logChannels) << "FileTransferChannel::FeatureCore must be ready before "
             "calling acceptFile";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel not ready"),
@@ -227,7 +227,7 @@ PendingOperation *IncomingFileTransferChannel::acceptFile(qulonglong offset,
 
     // let's fail here direclty as we may only have one device to handle
     if (mPriv->output) {
-        warning() << "File transfer can only be started once in the same "
+        tpWarning(logChannels) << "File transfer can only be started once in the same "
             "channel";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("File transfer can only be started once in the same channel"),
@@ -242,7 +242,7 @@ PendingOperation *IncomingFileTransferChannel::acceptFile(qulonglong offset,
 
     if (!output->isWritable()) {
         mPriv->weOpenedDevice = false;
-        warning() << "Unable to open IO device for writing";
+        tpWarning(logChannels) << "Unable to open IO device for writing";
         return new PendingFailure(TP_QT_ERROR_PERMISSION_DENIED,
                                   QLatin1String("Unable to open IO device for writing"),
                                   IncomingFileTransferChannelPtr(this));
@@ -266,7 +266,7 @@ PendingOperation *IncomingFileTransferChannel::acceptFile(qulonglong offset,
 void IncomingFileTransferChannel::onAcceptFileFinished(PendingOperation *op)
 {
     if (op->isError()) {
-        warning() << "Error accepting file transfer " <<
+        tpWarning(logChannels) << "Error accepting file transfer " <<
             op->errorName() << ":" << op->errorMessage();
         invalidate(op->errorName(), op->errorMessage());
         return;
@@ -274,7 +274,7 @@ void IncomingFileTransferChannel::onAcceptFileFinished(PendingOperation *op)
 
     PendingVariant *pv = qobject_cast<PendingVariant *>(op);
     mPriv->addr = qdbus_cast<SocketAddressIPv4>(pv->result());
-    debug().nospace() << "Got address " << mPriv->addr.address <<
+    tpDebug(logChannels).nospace() << "Got address " << mPriv->addr.address <<
         ":" << mPriv->addr.port;
 
     if (state() == FileTransferStateOpen) {
@@ -295,7 +295,7 @@ void IncomingFileTransferChannel::connectToHost()
     if (initialOffset() > mPriv->requestedOffset) {
         // either the CM or the sender is doing something really wrong here,
         // cancel the transfer.
-        warning() << "InitialOffset bigger than requested offset, "
+        tpWarning(logChannels) << "InitialOffset bigger than requested offset, "
             "cancelling the transfer";
         cancel();
         invalidate(TP_QT_ERROR_INCONSISTENT,
@@ -316,14 +316,14 @@ void IncomingFileTransferChannel::connectToHost()
     connect(mPriv->socket, SIGNAL(readyRead()),
             SLOT(doTransfer()));
 
-    debug().nospace() << "Connecting to host " <<
+    tpDebug(logChannels).nospace() << "Connecting to host " <<
         mPriv->addr.address << ":" << mPriv->addr.port << "...";
     mPriv->socket->connectToHost(mPriv->addr.address, mPriv->addr.port);
 }
 
 void IncomingFileTransferChannel::onSocketConnected()
 {
-    debug() << "Connected to host";
+    tpDebug(logChannels) << "Connected to host";
     setConnected();
 
     doTransfer();
@@ -331,7 +331,7 @@ void IncomingFileTransferChannel::onSocketConnected()
 
 void IncomingFileTransferChannel::onSocketDisconnected()
 {
-    debug() << "Disconnected from host";
+    tpDebug(logChannels) << "Disconnected from host";
     setFinished();
 }
 
@@ -32,20 +32,44 @@
 #include <QtCore/QString>
 #include <QtCore/QStringList>
 
+#include <string.h>
+
 namespace Tp
 {
 
 struct TP_QT_NO_EXPORT KeyFile::Private
 {
+    // Location of a raw value in the file contents, values are only unescaped when read
+    struct Span
+    {
+        Span()
+            : offset(0), length(0)
+        {
+        }
+
+        Span(int offset, int length)
+            : offset(offset), length(length)
+        {
+        }
+
+        int offset;
+        int length;
+    };
+
+    typedef QHash<QString, Span> GroupMap;
+
     Private();
     Private(const QString &fName);
 
     void setFileName(const QString &fName);
     void setError(KeyFile::Status status, const QString &reason);
     bool read();
+    bool parse(const QByteArray &contents);
 
     bool validateKey(const QByteArray &data, int from, int to, QString &result);
 
+    Span span(const QString &key) const;
+
     QStringList allGroups() const;
     QStringList allKeys() const;
     QStringList keys() const;
@@ -56,7 +80,8 @@ struct TP_QT_NO_EXPORT KeyFile::Private
 
     QString fileName;
     KeyFile::Status status;
-    QHash<QString, QHash<QString, QByteArray> > groups;
+    QByteArray contents;
+    QHash<QString, GroupMap> groups;
     QString currentGroup;
 };
 
@@ -77,15 +102,17 @@ void KeyFile::Private::setFileName(const QString &fName)
     fileName = fName;
     status = KeyFile::NoError;
     currentGroup = QString();
+    contents.clear();
     groups.clear();
     read();
 }
 
 void KeyFile::Private::setError(KeyFile::Status st, const QString &reason)
 {
-    warning() << QString(QLatin1String("ERROR: filename(%1) reason(%2)"))
+    tpWarning(logGeneral) << QString(QLatin1String("ERROR: filename(%1) reason(%2)"))
                          .arg(fileName).arg(reason);
     status = st;
+    contents.clear();
     groups.clear();
 }
 
@@ -104,23 +131,58 @@ bool KeyFile::Private::read()
         return false;
     }
 
-    QByteArray data;
-    QByteArray group;
-    QString currentGroup;
-    QHash<QString, QByteArray> groupMap;
-    QByteArray rawValue;
+    // Read the whole file at once and keep it, values are located in it on parsing and only
+    // unescaped when read. A mapping is not used as the values have to stay valid even if
+    // the file is rewritten while this object is alive.
+    return parse(file.readAll());
+}
+
+static inline bool isSpace(char ch)
+{
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == '\v' || ch == '\f';
+}
+
+static inline void trim(const char *data, int &from, int &to)
+{
+    while (from < to && isSpace(data[from])) {
+        ++from;
+    }
+    while (to > from && isSpace(data[to - 1])) {
+        --to;
+    }
+}
+
+static inline int indexOf(const char *data, char ch, int from, int to)
+{
+    const void *found = memchr(data + from, ch, to - from);
+    return found ? static_cast<const char *>(found) - data : -1;
+}
+
+bool KeyFile::Private::parse(const QByteArray &data)
+{
+    // Single pass over the contents, lines are tokenized in place without copying them
+    const char *buf = data.constData();
+    int size = data.size();
+    int pos = 0;
     int line = 0;
-    int idx;
-    while (!file.atEnd()) {
-        data = file.readLine().trimmed();
+    QString currentGroup;
+    GroupMap groupMap;
+    while (pos < size) {
+        int from = pos;
+        int to = indexOf(buf, '\n', pos, size);
+        if (to == -1) {
+            to = size;
+        }
+        pos = to + 1;
         line++;
 
-        if (data.size() == 0) {
+        trim(buf, from, to);
+        if (from == to) {
             // skip empty lines
             continue;
         }
 
-        char ch = data.at(0);
+        char ch = buf[from];
         if (ch == '#') {
             // skip comments
             continue;
@@ -131,7 +193,7 @@ bool KeyFile::Private::read()
                 groupMap.clear();
             }
 
-            idx = data.indexOf(']');
+            int idx = indexOf(buf, ']', from, to);
             if (idx == -1) {
                 // line starts with [ and it's not a group
                 setError(KeyFile::FormatError,
@@ -140,24 +202,27 @@ bool KeyFile::Private::read()
                 return false;
             }
 
-            group = data.mid(1, idx - 1).trimmed();
-            if (groups.contains(QLatin1String(group))) {
+            int groupFrom = from + 1;
+            int groupTo = idx;
+            trim(buf, groupFrom, groupTo);
+
+            currentGroup = QLatin1String("");
+            if (!unescapeString(data, groupFrom, groupTo, currentGroup)) {
                 setError(KeyFile::FormatError,
-                         QString(QLatin1String("duplicated group '%1' at line %2"))
-                                 .arg(QLatin1String(group)).arg(line));
+                         QString(QLatin1String("invalid group '%1' at line %2"))
+                                 .arg(currentGroup).arg(line));
                 return false;
             }
 
-            currentGroup = QLatin1String("");
-            if (!unescapeString(group, 0, group.size(), currentGroup)) {
+            if (groups.contains(currentGroup)) {
                 setError(KeyFile::FormatError,
-                         QString(QLatin1String("invalid group '%1' at line %2"))
+                         QString(QLatin1String("duplicated group '%1' at line %2"))
                                  .arg(currentGroup).arg(line));
                 return false;
             }
         }
         else {
-            idx = data.indexOf('=');
+            int idx = indexOf(buf, '=', from, to);
             if (idx == -1) {
                 setError(KeyFile::FormatError,
                          QString(QLatin1String("format error at line %1 - missing '='"))
@@ -166,14 +231,13 @@ bool KeyFile::Private::read()
             }
 
             // remove trailing spaces
-            char ch;
             int idxKeyEnd = idx;
-            while ((ch = data.at(idxKeyEnd - 1)) == ' ' || ch == '\t') {
+            while (idxKeyEnd > from && ((ch = buf[idxKeyEnd - 1]) == ' ' || ch == '\t')) {
                 --idxKeyEnd;
             }
 
             QString key;
-            if (!validateKey(data, 0, idxKeyEnd, key)) {
+            if (!validateKey(data, from, idxKeyEnd, key)) {
                 setError(KeyFile::FormatError,
                          QString(QLatin1String("invalid key '%1' at line %2"))
                                  .arg(key).arg(line));
@@ -187,9 +251,10 @@ bool KeyFile::Private::read()
                 return false;
             }
 
-            data = data.mid(idx + 1).trimmed();
-            rawValue = data.mid(0, data.size());
-            groupMap[key] = rawValue;
+            int valueFrom = idx + 1;
+            int valueTo = to;
+            trim(buf, valueFrom, valueTo);
+            groupMap.insert(key, Span(valueFrom, valueTo - valueFrom));
         }
     }
 
@@ -198,6 +263,7 @@ bool KeyFile::Private::read()
         groupMap.clear();
     }
 
+    contents = data;
     return true;
 }
 
@@ -205,6 +271,7 @@ bool KeyFile::Private::validateKey(const QByteArray &data, int from, int to, QSt
 {
     int i = from;
     bool ret = true;
+    result.reserve(result.size() + (to - from));
     while (i < to) {
         uint ch = data.at(i++);
         // as an extension to the Desktop Entry spec, we allow " ", "_", "." and "@"
@@ -224,6 +291,15 @@ bool KeyFile::Private::validateKey(const QByteArray &data, int from, int to, QSt
     return ret;
 }
 
+KeyFile::Private::Span KeyFile::Private::span(const QString &key) const
+{
+    QHash<QString, GroupMap>::const_iterator group = groups.constFind(currentGroup);
+    if (group == groups.constEnd()) {
+        return Span();
+    }
+    return group->value(key);
+}
+
 QStringList KeyFile::Private::allGroups() const
 {
     return groups.keys();
@@ -232,7 +308,7 @@ QStringList KeyFile::Private::allGroups() const
 QStringList KeyFile::Private::allKeys() const
 {
     QStringList keys;
-    QHash<QString, QHash<QString, QByteArray> >::const_iterator itrGroups = groups.begin();
+    QHash<QString, GroupMap>::const_iterator itrGroups = groups.begin();
     while (itrGroups != groups.end()) {
         keys << itrGroups.value().keys();
         ++itrGroups;
@@ -242,29 +318,26 @@ QStringList KeyFile::Private::allKeys() const
 
 QStringList KeyFile::Private::keys() const
 {
-    QHash<QString, QByteArray> groupMap = groups[currentGroup];
-    return groupMap.keys();
+    return groups.value(currentGroup).keys();
 }
 
 bool KeyFile::Private::contains(const QString &key) const
 {
-    QHash<QString, QByteArray> groupMap = groups[currentGroup];
-    return groupMap.contains(key);
+    QHash<QString, GroupMap>::const_iterator group = groups.constFind(currentGroup);
+    return group != groups.constEnd() && group->contains(key);
 }
 
 QString KeyFile::Private::rawValue(const QString &key) const
 {
-    QHash<QString, QByteArray> groupMap = groups[currentGroup];
-    QByteArray rawValue = groupMap.value(key);
-    return QLatin1String(rawValue);
+    Span s = span(key);
+    return QString::fromLatin1(contents.constData() + s.offset, s.length);
 }
 
 QString KeyFile::Private::value(const QString &key) const
 {
-    QHash<QString, QByteArray> groupMap = groups[currentGroup];
+    Span s = span(key);
     QString result;
-    QByteArray rawValue = groupMap.value(key);
-    if (unescapeString(rawValue, 0, rawValue.size(), result)) {
+    if (unescapeString(contents, s.offset, s.offset + s.length, result)) {
         return result;
     }
     return QString();
@@ -272,10 +345,9 @@ QString KeyFile::Private::value(const QString &key) const
 
 QStringList KeyFile::Private::valueAsStringList(const QString &key) const
 {
-    QHash<QString, QByteArray> groupMap = groups[currentGroup];
+    Span s = span(key);
     QStringList result;
-    QByteArray rawValue = groupMap.value(key);
-    if (unescapeStringList(rawValue, 0, rawValue.size(), result)) {
+    if (unescapeStringList(contents, s.offset, s.offset + s.length, result)) {
         return result;
     }
     return QStringList();
@@ -322,6 +394,7 @@ KeyFile::KeyFile(const KeyFile &other)
 {
     mPriv->fileName = other.mPriv->fileName;
     mPriv->status = other.mPriv->status;
+    mPriv->contents = other.mPriv->contents;
     mPriv->groups = other.mPriv->groups;
     mPriv->currentGroup = other.mPriv->currentGroup;
 }
@@ -338,6 +411,7 @@ KeyFile &KeyFile::operator=(const KeyFile &other)
 {
     mPriv->fileName = other.mPriv->fileName;
     mPriv->status = other.mPriv->status;
+    mPriv->contents = other.mPriv->contents;
     mPriv->groups = other.mPriv->groups;
     mPriv->currentGroup = other.mPriv->currentGroup;
     return *this;
@@ -495,6 +569,7 @@ QStringList KeyFile::valueAsStringList(const QString &key) const
 bool KeyFile::unescapeString(const QByteArray &data, int from, int to, QString &result)
 {
     int i = from;
+    result.reserve(result.size() + (to - from));
     while (i < to) {
         uint ch = data.at(i++);
 
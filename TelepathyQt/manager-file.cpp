@@ -24,10 +24,12 @@
 
 #include "TelepathyQt/debug-internal.h"
 #include "TelepathyQt/key-file.h"
+#include "TelepathyQt/parsed-file-cache-internal.h"
 
 #include <TelepathyQt/Constants>
 #include <TelepathyQt/Utils>
 
+#include <QtCore/QDataStream>
 #include <QtCore/QDir>
 #include <QtCore/QHash>
 #include <QtCore/QString>
@@ -46,6 +48,9 @@ struct TP_QT_NO_EXPORT ManagerFile::Private
     bool parse(const QString &fileName);
     bool isValid() const;
 
+    bool loadFromCache(const QString &fileName);
+    void saveToCache(const QString &fileName) const;
+
     bool hasParameter(const QString &protocol, const QString &paramName) const;
     ParamSpec *getParameter(const QString &protocol, const QString &paramName);
     QStringList protocols() const;
@@ -92,6 +97,147 @@ ManagerFile::Private::Private(const QString &cmName)
 }
 
 void ManagerFile::Private::init()
+{
+    foreach (const QString configDir, ManagerFile::configDirs()) {
+        QString fileName = configDir + cmName + QLatin1String(".manager");
+        if (QFile::exists(fileName)) {
+            if (loadFromCache(fileName)) {
+                valid = true;
+                return;
+            }
+
+            tpDebug(logConnections) << "parsing manager file" << fileName;
+            protocolsMap.clear();
+            if (!parse(fileName)) {
+                tpWarning(logConnections) << "error parsing manager file" << fileName;
+                continue;
+            }
+            saveToCache(fileName);
+            valid = true;
+            return;
+        }
+    }
+}
+
+bool ManagerFile::Private::loadFromCache(const QString &fileName)
+{
+    QByteArray data;
+    if (!ParsedFileCache::managers()->lookup(fileName, data)) {
+        return false;
+    }
+
+    QDataStream stream(data);
+    ParsedFileCache::setupStream(stream);
+
+    QHash<QString, ProtocolInfo> protocols;
+    quint32 protocolsCount;
+    stream >> protocolsCount;
+    for (quint32 i = 0; i < protocolsCount && stream.status() == QDataStream::Ok; ++i) {
+        QString protocol;
+        ProtocolInfo info;
+        quint32 count;
+
+        stream >> protocol >> count;
+        for (quint32 j = 0; j < count && stream.status() == QDataStream::Ok; ++j) {
+            ParamSpec spec;
+            QVariant defaultValue;
+            stream >> spec.name >> spec.flags >> spec.signature >> defaultValue;
+            spec.defaultValue = QDBusVariant(defaultValue);
+            info.params.append(spec);
+        }
+
+        stream >> info.vcardField >> info.englishName >> info.iconName;
+
+        stream >> count;
+        for (quint32 j = 0; j < count && stream.status() == QDataStream::Ok; ++j) {
+            RequestableChannelClass rcc;
+            stream >> rcc.fixedProperties >> rcc.allowedProperties;
+            info.rccs.append(rcc);
+        }
+
+        SimpleStatusSpecMap statuses;
+        stream >> count;
+        for (quint32 j = 0; j < count && stream.status() == QDataStream::Ok; ++j) {
+            QString statusName;
+            SimpleStatusSpec status;
+            stream >> statusName >> status.type >> status.maySetOnSelf >> status.canHaveMessage;
+            statuses.insert(statusName, status);
+        }
+        info.statuses = PresenceSpecList(statuses);
+
+        QStringList supportedMimeTypes;
+        uint minHeight, maxHeight, recommendedHeight;
+        uint minWidth, maxWidth, recommendedWidth;
+        uint maxBytes;
+        stream >> supportedMimeTypes >> minHeight >> maxHeight >> recommendedHeight >>
+            minWidth >> maxWidth >> recommendedWidth >> maxBytes;
+        info.avatarRequirements = AvatarSpec(supportedMimeTypes,
+                minHeight, maxHeight, recommendedHeight,
+                minWidth, maxWidth, recommendedWidth,
+                maxBytes);
+
+        stream >> info.addressableVCardFields >> info.addressableUriSchemes;
+
+        protocols.insert(protocol, info);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        tpWarning(logConnections) << "Ignoring corrupted cache entry for manager file" << fileName;
+        return false;
+    }
+
+    tpDebug(logConnections) << "using cached manager file" << fileName;
+    protocolsMap = protocols;
+    return true;
+}
+
+void ManagerFile::Private::saveToCache(const QString &fileName) const
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    ParsedFileCache::setupStream(stream);
+
+    stream << (quint32) protocolsMap.size();
+    QHash<QString, ProtocolInfo>::const_iterator i = protocolsMap.constBegin();
+    while (i != protocolsMap.constEnd()) {
+        const ProtocolInfo &info = i.value();
+
+        stream << i.key() << (quint32) info.params.size();
+        foreach (const ParamSpec &spec, info.params) {
+            stream << spec.name << spec.flags << spec.signature << spec.defaultValue.variant();
+        }
+
+        stream << info.vcardField << info.englishName << info.iconName;
+
+        stream << (quint32) info.rccs.size();
+        foreach (const RequestableChannelClass &rcc, info.rccs) {
+            stream << rcc.fixedProperties << rcc.allowedProperties;
+        }
+
+        SimpleStatusSpecMap statuses = info.statuses.bareSpecs();
+        stream << (quint32) statuses.size();
+        SimpleStatusSpecMap::const_iterator status = statuses.constBegin();
+        while (status != statuses.constEnd()) {
+            stream << status.key() << status->type << status->maySetOnSelf <<
+                status->canHaveMessage;
+            ++status;
+        }
+
+        const AvatarSpec &avatar = info.avatarRequirements;
+        stream << avatar.supportedMimeTypes() << avatar.minimumHeight() <<
+            avatar.maximumHeight() << avatar.recommendedHeight() << avatar.minimumWidth() <<
+            avatar.maximumWidth() << avatar.recommendedWidth() << avatar.maximumBytes();
+
+        stream << info.addressableVCardFields << info.addressableUriSchemes;
+        ++i;
+    }
+
+    ParsedFileCache *cache = ParsedFileCache::managers();
+    cache->insert(fileName, data);
+    cache->saveLater();
+}
+
+QStringList ManagerFile::configDirs()
 {
     // TODO: should we cache the configDirs anywhere?
     QStringList configDirs;
@@ -116,19 +262,18 @@ void ManagerFile::Private::init()
         }
     }
 
-    foreach (const QString configDir, configDirs) {
+    return configDirs;
+}
+
+QString ManagerFile::fileNameForCM(const QString &cmName)
+{
+    foreach (const QString configDir, configDirs()) {
         QString fileName = configDir + cmName + QLatin1String(".manager");
         if (QFile::exists(fileName)) {
-            debug() << "parsing manager file" << fileName;
-            protocolsMap.clear();
-            if (!parse(fileName)) {
-                warning() << "error parsing manager file" << fileName;
-                continue;
-            }
-            valid = true;
-            return;
+            return fileName;
         }
     }
+    return QString();
 }
 
 bool ManagerFile::Private::parse(const QString &fileName)
@@ -161,7 +306,8 @@ bool ManagerFile::Private::parse(const QString &fileName)
                     spec.name = param.right(param.length() - 6);
 
                     if (values.length() == 0) {
-                        warning() << "param" << spec.name << "set but no signature defined";
+                        tpWarning(logConnections) << "param" << spec.name <<
+                            "set but no signature defined";
                         return false;
                     }
 
@@ -192,14 +338,16 @@ bool ManagerFile::Private::parse(const QString &fileName)
                     QString statusName = param.right(param.length() - 7);
 
                     if (values.length() == 0) {
-                        warning() << "status" << statusName << "set but no type defined";
+                        tpWarning(logConnections) << "status" << statusName <<
+                            "set but no type defined";
                         return false;
                     }
 
                     bool ok;
                     status.type = values[0].toUInt(&ok);
                     if (!ok) {
-                        warning() << "status" << statusName << "set but type is not an uint";
+                        tpWarning(logConnections) << "status" << statusName <<
+                            "set but type is not an uint";
                         return false;
                     }
 
@@ -216,7 +364,8 @@ bool ManagerFile::Private::parse(const QString &fileName)
                     }
 
                     if (statuses.contains(statusName)) {
-                        warning() << "status" << statusName << "defined more than once, "
+                        tpWarning(logConnections) <<
+                            "status" << statusName << "defined more than once, "
                             "replacing it";
                     }
 
@@ -232,7 +381,7 @@ bool ManagerFile::Private::parse(const QString &fileName)
                     QString paramName = param.right(param.length() - 8);
 
                     if (!hasParameter(protocol, paramName)) {
-                        warning() << "param" << paramName
+                        tpWarning(logConnections) << "param" << paramName
                                   << "has default value set, but not a definition";
                         continue;
                     }
@@ -245,7 +394,7 @@ bool ManagerFile::Private::parse(const QString &fileName)
                      * QString */
                     QVariant value = valueForKey(param, spec->signature);
                     if (value.type() == QVariant::Invalid) {
-                        warning() << "param" << paramName
+                        tpWarning(logConnections) << "param" << paramName
                                   << "has invalid signature";
                         protocolsMap.clear();
                         return false;
@@ -326,7 +475,8 @@ bool ManagerFile::Private::parse(const QString &fileName)
 
 bool ManagerFile::Private::isValid() const
 {
-    return ((keyFile.status() == KeyFile::NoError) && (valid));
+    // the key file is not read at all when the parsed contents come from the cache
+    return valid;
 }
 
 bool ManagerFile::Private::hasParameter(const QString &protocol,
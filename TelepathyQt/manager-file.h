@@ -60,6 +60,9 @@ public:
     QStringList addressableVCardFields(const QString &protocol) const;
     QStringList addressableUriSchemes(const QString &protocol) const;
 
+    static QStringList configDirs();
+    static QString fileNameForCM(const QString &cmName);
+
 private:
     struct Private;
     friend struct Private;
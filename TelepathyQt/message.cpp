@@ -24,6 +24,7 @@
 #include <TelepathyQt/ReceivedMessage>
 
 #include "TelepathyQt/debug-internal.h"
+#include "TelepathyQt/test-backdoors.h"
 
 #include <TelepathyQt/TextChannel>
 
@@ -80,14 +81,40 @@ bool partContains(const MessagePartList &parts, uint index, const char *key)
 struct TP_QT_NO_EXPORT Message::Private : public QSharedData
 {
     Private(const MessagePartList &parts);
+    Private(uint type, const QString &text);
     ~Private();
 
-    uint senderHandle() const;
-    QString senderId() const;
-    uint pendingId() const;
+    void parseHeader();
+    void parseBody();
+    MessagePartList buildParts() const;
+    const MessagePartList &ensureParts() const;
     void clearSenderHandle();
 
-    MessagePartList parts;
+    // The parts as received or given by the user. Messages created from a plain text body only
+    // store the typed fields below, and build their parts the first time they are requested,
+    // which is normally only when the message is sent.
+    mutable MessagePartList parts;
+    mutable bool lazyParts;
+
+    // well-known header fields, parsed once from parts[0]
+    bool hasSentTimestamp;
+    uint sentTimestamp;
+    uint receivedTimestamp;
+    uint messageType;
+    QString messageToken;
+    QString dbusInterface;
+    uint senderHandle;
+    QString senderId;
+    uint pendingId;
+    QString senderNickname;
+    QString supersededToken;
+    bool scrollback;
+    bool rescued;
+
+    // summary of the body parts
+    QString text;
+    bool nonTextBody;
+    bool truncated;
 
     // if the Text interface says "non-text" we still only have the text,
     // because the interface can't tell us anything else...
@@ -100,6 +127,39 @@ struct TP_QT_NO_EXPORT Message::Private : public QSharedData
 
 Message::Private::Private(const MessagePartList &parts)
     : parts(parts),
+      lazyParts(false),
+      hasSentTimestamp(false),
+      sentTimestamp(0),
+      receivedTimestamp(0),
+      messageType(ChannelTextMessageTypeNormal),
+      senderHandle(0),
+      pendingId(0),
+      scrollback(false),
+      rescued(false),
+      nonTextBody(true),
+      truncated(false),
+      forceNonText(false),
+      sender(0)
+{
+    if (!parts.isEmpty()) {
+        parseHeader();
+        parseBody();
+    }
+}
+
+Message::Private::Private(uint type, const QString &text)
+    : lazyParts(true),
+      hasSentTimestamp(false),
+      sentTimestamp(0),
+      receivedTimestamp(0),
+      messageType(type),
+      senderHandle(0),
+      pendingId(0),
+      scrollback(false),
+      rescued(false),
+      text(text),
+      nonTextBody(false),
+      truncated(false),
       forceNonText(false),
       sender(0)
 {
@@ -109,24 +169,122 @@ Message::Private::~Private()
 {
 }
 
-inline uint Message::Private::senderHandle() const
+void Message::Private::parseHeader()
 {
-    return uintOrZeroFromPart(parts, 0, "message-sender");
+    hasSentTimestamp = partContains(parts, 0, "message-sent");
+    sentTimestamp = uintOrZeroFromPart(parts, 0, "message-sent");
+    receivedTimestamp = uintOrZeroFromPart(parts, 0, "message-received");
+    messageType = uintOrZeroFromPart(parts, 0, "message-type");
+    messageToken = stringOrEmptyFromPart(parts, 0, "message-token");
+    dbusInterface = stringOrEmptyFromPart(parts, 0, "interface");
+    senderHandle = uintOrZeroFromPart(parts, 0, "message-sender");
+    senderId = stringOrEmptyFromPart(parts, 0, "message-sender-id");
+    pendingId = uintOrZeroFromPart(parts, 0, "pending-message-id");
+    senderNickname = stringOrEmptyFromPart(parts, 0, "sender-nickname");
+    supersededToken = stringOrEmptyFromPart(parts, 0, "supersedes");
+    scrollback = booleanFromPart(parts, 0, "scrollback", false);
+    rescued = booleanFromPart(parts, 0, "rescued", false);
 }
 
-inline QString Message::Private::senderId() const
+void Message::Private::parseBody()
 {
-    return stringOrEmptyFromPart(parts, 0, "message-sender-id");
+    // Alternative-groups for which we've already emitted an alternative
+    QSet<QString> altGroupsUsed;
+    // Alternative-groups which have a text/plain alternative, and the ones which need one
+    QSet<QString> texts;
+    QSet<QString> textNeeded;
+    bool unrescuable = false;
+
+    text = QString();
+    truncated = false;
+
+    for (int i = 1; i < parts.size(); i++) {
+        const QString altGroup = stringOrEmptyFromPart(parts, i, "alternative");
+        const QString contentType = stringOrEmptyFromPart(parts, i, "content-type");
+
+        if (booleanFromPart(parts, i, "truncated", false)) {
+            truncated = true;
+        }
+
+        if (contentType != QLatin1String("text/plain")) {
+            if (altGroup.isEmpty()) {
+                // we can't possibly rescue this part by using a text/plain
+                // alternative, because it's not in any alternative group
+                unrescuable = true;
+            } else {
+                // maybe we'll find a text/plain alternative for this
+                textNeeded << altGroup;
+            }
+            continue;
+        }
+
+        if (!altGroup.isEmpty()) {
+            // we can use this as an alternative for a non-text part
+            // with the same altGroup
+            texts << altGroup;
+        }
+
+        const QString interface = valueFromPart(parts, i, "interface").toString();
+        if (!interface.isEmpty()) {
+            continue;
+        }
+        if (!altGroup.isEmpty()) {
+            if (altGroupsUsed.contains(altGroup)) {
+                continue;
+            } else {
+                altGroupsUsed << altGroup;
+            }
+        }
+
+        QVariant content = valueFromPart(parts, i, "content");
+        if (content.type() == QVariant::String) {
+            text += content.toString();
+        } else {
+            // O RLY?
+            tpDebug(logChannels) << "allegedly text/plain part wasn't";
+        }
+    }
+
+    textNeeded -= texts;
+    nonTextBody = parts.size() <= 1 || unrescuable || !textNeeded.isEmpty();
 }
 
-inline uint Message::Private::pendingId() const
+MessagePartList Message::Private::buildParts() const
 {
-    return uintOrZeroFromPart(parts, 0, "pending-message-id");
+    MessagePartList ret;
+
+    MessagePart header;
+    if (hasSentTimestamp) {
+        header.insert(QLatin1String("message-sent"),
+                QDBusVariant(static_cast<qlonglong>(sentTimestamp)));
+    }
+    header.insert(QLatin1String("message-type"), QDBusVariant(messageType));
+    ret << header;
+
+    MessagePart body;
+    body.insert(QLatin1String("content-type"),
+            QDBusVariant(QLatin1String("text/plain")));
+    body.insert(QLatin1String("content"), QDBusVariant(text));
+    ret << body;
+
+    return ret;
+}
+
+const MessagePartList &Message::Private::ensureParts() const
+{
+    if (lazyParts) {
+        parts = buildParts();
+        lazyParts = false;
+    }
+    return parts;
 }
 
 void Message::Private::clearSenderHandle()
 {
-    parts[0].remove(QLatin1String("message-sender"));
+    senderHandle = 0;
+    if (!lazyParts) {
+        parts[0].remove(QLatin1String("message-sender"));
+    }
 }
 
 /**
@@ -167,16 +325,10 @@ Message::Message(const MessagePartList &parts)
  * \param text The message body.
  */
 Message::Message(uint timestamp, uint type, const QString &text)
-    : mPriv(new Private(MessagePartList() << MessagePart() << MessagePart()))
+    : mPriv(new Private(type, text))
 {
-    mPriv->parts[0].insert(QLatin1String("message-sent"),
-            QDBusVariant(static_cast<qlonglong>(timestamp)));
-    mPriv->parts[0].insert(QLatin1String("message-type"),
-            QDBusVariant(type));
-
-    mPriv->parts[1].insert(QLatin1String("content-type"),
-            QDBusVariant(QLatin1String("text/plain")));
-    mPriv->parts[1].insert(QLatin1String("content"), QDBusVariant(text));
+    mPriv->hasSentTimestamp = true;
+    mPriv->sentTimestamp = timestamp;
 }
 
 /**
@@ -186,14 +338,8 @@ Message::Message(uint timestamp, uint type, const QString &text)
  * \param text The message body.
  */
 Message::Message(ChannelTextMessageType type, const QString &text)
-    : mPriv(new Private(MessagePartList() << MessagePart() << MessagePart()))
+    : mPriv(new Private(static_cast<uint>(type), text))
 {
-    mPriv->parts[0].insert(QLatin1String("message-type"),
-            QDBusVariant(static_cast<uint>(type)));
-
-    mPriv->parts[1].insert(QLatin1String("content-type"),
-            QDBusVariant(QLatin1String("text/plain")));
-    mPriv->parts[1].insert(QLatin1String("content"), QDBusVariant(text));
 }
 
 /**
@@ -226,7 +372,7 @@ bool Message::operator==(const Message &other) const
 
 uint Message::sentTimestamp() const
 {
-    return valueFromPart(mPriv->parts, 0, "message-sent").toUInt();
+    return mPriv->sentTimestamp;
 }
 
 /**
@@ -261,7 +407,7 @@ QDateTime Message::sent() const
  */
 ChannelTextMessageType Message::messageType() const
 {
-    uint raw = valueFromPart(mPriv->parts, 0, "message-type").toUInt();
+    uint raw = mPriv->messageType;
 
     if (raw < static_cast<uint>(NUM_CHANNEL_TEXT_MESSAGE_TYPES)) {
         return ChannelTextMessageType(raw);
@@ -277,12 +423,7 @@ ChannelTextMessageType Message::messageType() const
  */
 bool Message::isTruncated() const
 {
-    for (int i = 1; i < size(); i++) {
-        if (booleanFromPart(mPriv->parts, i, "truncated", false)) {
-            return true;
-        }
-    }
-    return false;
+    return mPriv->truncated;
 }
 
 /**
@@ -294,38 +435,7 @@ bool Message::isTruncated() const
  */
 bool Message::hasNonTextContent() const
 {
-    if (mPriv->forceNonText || size() <= 1 || isSpecificToDBusInterface()) {
-        return true;
-    }
-
-    QSet<QString> texts;
-    QSet<QString> textNeeded;
-
-    for (int i = 1; i < size(); i++) {
-        QString altGroup = stringOrEmptyFromPart(mPriv->parts, i, "alternative");
-        QString contentType = stringOrEmptyFromPart(mPriv->parts, i, "content-type");
-
-        if (contentType == QLatin1String("text/plain")) {
-            if (!altGroup.isEmpty()) {
-                // we can use this as an alternative for a non-text part
-                // with the same altGroup
-                texts << altGroup;
-            }
-        } else {
-            QString alt = stringOrEmptyFromPart(mPriv->parts, i, "alternative");
-            if (altGroup.isEmpty()) {
-                // we can't possibly rescue this part by using a text/plain
-                // alternative, because it's not in any alternative group
-                return true;
-            } else {
-                // maybe we'll find a text/plain alternative for this
-                textNeeded << altGroup;
-            }
-        }
-    }
-
-    textNeeded -= texts;
-    return !textNeeded.isEmpty();
+    return mPriv->forceNonText || mPriv->nonTextBody || isSpecificToDBusInterface();
 }
 
 /**
@@ -336,7 +446,7 @@ bool Message::hasNonTextContent() const
  */
 QString Message::messageToken() const
 {
-    return stringOrEmptyFromPart(mPriv->parts, 0, "message-token");
+    return mPriv->messageToken;
 }
 
 /**
@@ -366,7 +476,7 @@ bool Message::isSpecificToDBusInterface() const
  */
 QString Message::dbusInterface() const
 {
-    return stringOrEmptyFromPart(mPriv->parts, 0, "interface");
+    return mPriv->dbusInterface;
 }
 
 /**
@@ -376,38 +486,7 @@ QString Message::dbusInterface() const
  */
 QString Message::text() const
 {
-    // Alternative-groups for which we've already emitted an alternative
-    QSet<QString> altGroupsUsed;
-    QString text;
-
-    for (int i = 1; i < size(); i++) {
-        const QString contentType = stringOrEmptyFromPart(mPriv->parts, i, "content-type");
-
-        if (contentType == QLatin1String("text/plain")) {
-            const QString interface = valueFromPart(mPriv->parts, i, "interface").toString();
-            if (!interface.isEmpty()) {
-                continue;
-            }
-            const QString altGroup = stringOrEmptyFromPart(mPriv->parts, i, "alternative");
-            if (!altGroup.isEmpty()) {
-                if (altGroupsUsed.contains(altGroup)) {
-                    continue;
-                } else {
-                    altGroupsUsed << altGroup;
-                }
-            }
-
-            QVariant content = valueFromPart(mPriv->parts, i, "content");
-            if (content.type() == QVariant::String) {
-                text += content.toString();
-            } else {
-                // O RLY?
-                debug() << "allegedly text/plain part wasn't";
-            }
-        }
-    }
-
-    return text;
+    return mPriv->text;
 }
 
 /**
@@ -425,7 +504,7 @@ MessagePart Message::header() const
 
 MessagePart Message::forwardedHeader() const
 {
-    for (const MessagePart &part : mPriv->parts) {
+    for (const MessagePart &part : parts()) {
         if (part.value(QLatin1String("interface")).variant().toString() == TP_QT_IFACE_CHANNEL + QLatin1String(".Interface.Forwarding")) {
             return part;
         }
@@ -441,6 +520,9 @@ MessagePart Message::forwardedHeader() const
  */
 int Message::size() const
 {
+    if (mPriv->lazyParts) {
+        return 2;
+    }
     return mPriv->parts.size();
 }
 
@@ -457,7 +539,7 @@ int Message::size() const
  */
 MessagePart Message::part(uint index) const
 {
-    return mPriv->parts.at(index);
+    return mPriv->ensureParts().at(index);
 }
 
 /**
@@ -467,7 +549,7 @@ MessagePart Message::part(uint index) const
  */
 MessagePartList Message::parts() const
 {
-    return mPriv->parts;
+    return mPriv->ensureParts();
 }
 
 /**
@@ -742,9 +824,9 @@ ReceivedMessage::ReceivedMessage(const MessagePartList &parts,
     : Message(parts)
 {
     if (!mPriv->parts[0].contains(QLatin1String("message-received"))) {
+        mPriv->receivedTimestamp = QDateTime::currentDateTime().toTime_t();
         mPriv->parts[0].insert(QLatin1String("message-received"),
-                QDBusVariant(static_cast<qlonglong>(
-                        QDateTime::currentDateTime().toTime_t())));
+                QDBusVariant(static_cast<qlonglong>(mPriv->receivedTimestamp)));
     }
     mPriv->textChannel = channel;
 }
@@ -778,7 +860,7 @@ ReceivedMessage::~ReceivedMessage()
 
 uint ReceivedMessage::receivedTimestamp() const
 {
-    return valueFromPart(mPriv->parts, 0, "message-received").toUInt();
+    return mPriv->receivedTimestamp;
 }
 
 /**
@@ -817,7 +899,7 @@ ContactPtr ReceivedMessage::sender() const
  */
 QString ReceivedMessage::senderNickname() const
 {
-    QString ret = stringOrEmptyFromPart(mPriv->parts, 0, "sender-nickname");
+    QString ret = mPriv->senderNickname;
     if (ret.isEmpty() && mPriv->sender) {
         ret = mPriv->sender->alias();
     }
@@ -835,7 +917,7 @@ QString ReceivedMessage::senderNickname() const
  */
 QString ReceivedMessage::supersededToken() const
 {
-    return stringOrEmptyFromPart(mPriv->parts, 0, "supersedes");
+    return mPriv->supersededToken;
 }
 
 /**
@@ -850,7 +932,7 @@ QString ReceivedMessage::supersededToken() const
  */
 bool ReceivedMessage::isScrollback() const
 {
-    return booleanFromPart(mPriv->parts, 0, "scrollback", false);
+    return mPriv->scrollback;
 }
 
 /**
@@ -864,7 +946,7 @@ bool ReceivedMessage::isScrollback() const
  */
 bool ReceivedMessage::isRescued() const
 {
-    return booleanFromPart(mPriv->parts, 0, "rescued", false);
+    return mPriv->rescued;
 }
 
 /**
@@ -903,17 +985,17 @@ bool ReceivedMessage::isFromChannel(const TextChannelPtr &channel) const
 
 uint ReceivedMessage::pendingId() const
 {
-    return mPriv->pendingId();
+    return mPriv->pendingId;
 }
 
 uint ReceivedMessage::senderHandle() const
 {
-    return mPriv->senderHandle();
+    return mPriv->senderHandle;
 }
 
 QString ReceivedMessage::senderId() const
 {
-    return mPriv->senderId();
+    return mPriv->senderId;
 }
 
 void ReceivedMessage::setForceNonText()
@@ -931,4 +1013,38 @@ void ReceivedMessage::setSender(const ContactPtr &sender)
     mPriv->sender = sender;
 }
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+Message TestBackdoors::createMessage(const MessagePartList &parts)
+{
+    return Message(parts);
+}
+
+Message TestBackdoors::createMessage(uint timestamp, uint type, const QString &text)
+{
+    return Message(timestamp, type, text);
+}
+
+ReceivedMessage TestBackdoors::createReceivedMessage(const MessagePartList &parts)
+{
+    return ReceivedMessage(parts, TextChannelPtr());
+}
+
+uint TestBackdoors::receivedMessageSenderHandle(const ReceivedMessage &message)
+{
+    return message.senderHandle();
+}
+
+QString TestBackdoors::receivedMessageSenderId(const ReceivedMessage &message)
+{
+    return message.senderId();
+}
+
+uint TestBackdoors::receivedMessagePendingId(const ReceivedMessage &message)
+{
+    return message.pendingId();
+}
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
 } // Tp
@@ -39,6 +39,7 @@ namespace Tp
 {
 
 class Contact;
+class TestBackdoors;
 class TextChannel;
 
 class TP_QT_EXPORT Message
@@ -85,6 +86,7 @@ public:
 private:
     friend class ContactMessenger;
     friend class ReceivedMessage;
+    friend class TestBackdoors;
     friend class TextChannel;
 
     TP_QT_NO_EXPORT Message();
@@ -156,6 +158,7 @@ public:
     bool isFromChannel(const TextChannelPtr &channel) const;
 
 protected:
+    friend class TestBackdoors;
     friend class TextChannel;
 
     ReceivedMessage(const MessagePartList &parts,
@@ -151,7 +151,7 @@ PendingDBusTubeConnection *OutgoingDBusTubeChannel::offerTube(const QVariantMap
                                         SocketAccessControlCredentials;
 
     if (!isReady(DBusTubeChannel::FeatureCore)) {
-        warning() << "DBusTubeChannel::FeatureCore must be ready before "
+        tpWarning(logTubes) << "DBusTubeChannel::FeatureCore must be ready before "
             "calling offerTube";
         return new PendingDBusTubeConnection(QLatin1String(TP_QT_ERROR_NOT_AVAILABLE),
                 QLatin1String("Channel not ready"), OutgoingDBusTubeChannelPtr(this));
@@ -159,14 +159,14 @@ PendingDBusTubeConnection *OutgoingDBusTubeChannel::offerTube(const QVariantMap
 
     // The tube must be not offered
     if (state() != TubeChannelStateNotOffered) {
-        warning() << "You can not expose more than a bus for each DBus Tube";
+        tpWarning(logTubes) << "You can not expose more than a bus for each DBus Tube";
         return new PendingDBusTubeConnection(QLatin1String(TP_QT_ERROR_NOT_AVAILABLE),
                 QLatin1String("Channel busy"), OutgoingDBusTubeChannelPtr(this));
     }
 
     // Let's offer the tube
     if (!allowOtherUsers && !supportsRestrictingToCurrentUser()) {
-        warning() << "Current user restriction is not available for this tube, "
+        tpWarning(logTubes) << "Current user restriction is not available for this tube, "
             "falling back to allowing any connection";
         accessControl = SocketAccessControlLocalhost;
     }
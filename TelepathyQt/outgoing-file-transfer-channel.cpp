@@ -166,7 +166,7 @@ OutgoingFileTransferChannel::~OutgoingFileTransferChannel()
 PendingOperation *OutgoingFileTransferChannel::provideFile(QIODevice *input)
 {
     if (!isReady(FileTransferChannel::FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        tpWarning(logChannels) << "FileTransferChannel::FeatureCore must be ready before "
             "calling provideFile";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel not ready"),
@@ -175,7 +175,7 @@ PendingOperation *OutgoingFileTransferChannel::provideFile(QIODevice *input)
 
     // let's fail here direclty as we may only have one device to handle
     if (mPriv->input) {
-        warning() << "File transfer can only be started once in the same "
+        tpWarning(logChannels) << "File transfer can only be started once in the same "
             "channel";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("File transfer can only be started once in the same channel"),
@@ -190,7 +190,7 @@ PendingOperation *OutgoingFileTransferChannel::provideFile(QIODevice *input)
 
     if (!input->isReadable()) {
         mPriv->weOpenedDevice = false;
-        warning() << "Unable to open IO device for reading";
+        tpWarning(logChannels) << "Unable to open IO device for reading";
         return new PendingFailure(TP_QT_ERROR_PERMISSION_DENIED,
                 QLatin1String("Unable to open IO device for reading"),
                 OutgoingFileTransferChannelPtr(this));
@@ -216,7 +216,7 @@ PendingOperation *OutgoingFileTransferChannel::provideFile(QIODevice *input)
 void OutgoingFileTransferChannel::onProvideFileFinished(PendingOperation *op)
 {
     if (op->isError()) {
-        warning() << "Error providing file transfer " <<
+        tpWarning(logChannels) << "Error providing file transfer " <<
             op->errorName() << ":" << op->errorMessage();
         invalidate(op->errorName(), op->errorMessage());
         return;
@@ -224,7 +224,7 @@ void OutgoingFileTransferChannel::onProvideFileFinished(PendingOperation *op)
 
     PendingVariant *pv = qobject_cast<PendingVariant *>(op);
     mPriv->addr = qdbus_cast<SocketAddressIPv4>(pv->result());
-    debug().nospace() << "Got address " << mPriv->addr.address <<
+    tpDebug(logChannels).nospace() << "Got address " << mPriv->addr.address <<
         ":" << mPriv->addr.port;
 
     if (state() == FileTransferStateOpen) {
@@ -251,14 +251,14 @@ void OutgoingFileTransferChannel::connectToHost()
     connect(mPriv->socket, SIGNAL(bytesWritten(qint64)),
             SLOT(doTransfer()));
 
-    debug().nospace() << "Connecting to host " <<
+    tpDebug(logChannels).nospace() << "Connecting to host " <<
         mPriv->addr.address << ":" << mPriv->addr.port << "...";
     mPriv->socket->connectToHost(mPriv->addr.address, mPriv->addr.port);
 }
 
 void OutgoingFileTransferChannel::onSocketConnected()
 {
-    debug() << "Connected to host";
+    tpDebug(logChannels) << "Connected to host";
     setConnected();
 
     connect(mPriv->input, SIGNAL(readyRead()),
@@ -269,25 +269,25 @@ void OutgoingFileTransferChannel::onSocketConnected()
         mPriv->input->seek(initialOffset());
     }
 
-    debug() << "Starting transfer...";
+    tpDebug(logChannels) << "Starting transfer...";
     doTransfer();
 }
 
 void OutgoingFileTransferChannel::onSocketDisconnected()
 {
-    debug() << "Disconnected from host";
+    tpDebug(logChannels) << "Disconnected from host";
     setFinished();
 }
 
 void OutgoingFileTransferChannel::onSocketError(QAbstractSocket::SocketError error)
 {
-    debug() << "Socket error" << error;
+    tpDebug(logChannels) << "Socket error" << error;
     setFinished();
 }
 
 void OutgoingFileTransferChannel::onInputAboutToClose()
 {
-    debug() << "Input closed";
+    tpDebug(logChannels) << "Input closed";
 
     // read all remaining data from input device and write to output device
     if (isConnected()) {
@@ -315,7 +315,7 @@ void OutgoingFileTransferChannel::doTransfer()
                 (qulonglong) len);
 
         mPriv->pos += skip;
-        debug() << "skipping" << skip << "bytes";
+        tpDebug(logChannels) << "skipping" << skip << "bytes";
         if (skip == len) {
             // nothing to write, all data read was skipped
             // schedule a transfer, as readyRead may never be called and
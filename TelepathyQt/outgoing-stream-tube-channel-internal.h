@@ -102,6 +102,11 @@ struct TP_QT_NO_EXPORT OutgoingStreamTubeChannel::Private
     QHash<QPair<QHostAddress, quint16>, uint> connectionsForSourceAddresses;
     QHash<uchar, uint> connectionsForCredentials;
 
+    // The reverse mappings, so that connections can be looked up and forgotten by their id
+    // alone
+    QHash<uint, QPair<QHostAddress, quint16> > sourceAddressesForConnections;
+    QHash<uint, uchar> credentialsForConnections;
+
     QHash<QUuid, QPair<uint, QDBusVariant> > pendingNewConnections;
 
     struct ClosedConnection {
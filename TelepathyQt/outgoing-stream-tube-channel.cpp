@@ -58,7 +58,7 @@ PendingOpenTube::PendingOpenTube(
 
     // FIXME: connect to channel invalidation here also
 
-    debug() << "Calling StreamTube.Offer";
+    tpDebug(logTubes) << "Calling StreamTube.Offer";
     if (offerOperation->isFinished()) {
         onOfferFinished(offerOperation);
     } else {
@@ -76,17 +76,17 @@ PendingOpenTube::~PendingOpenTube()
 void PendingOpenTube::onOfferFinished(PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "StreamTube.Offer failed with " <<
+        tpWarning(logTubes).nospace() << "StreamTube.Offer failed with " <<
             op->errorName() << ": " << op->errorMessage();
         setFinishedWithError(op->errorName(), op->errorMessage());
         return;
     }
 
-    debug() << "StreamTube.Offer returned successfully";
+    tpDebug(logTubes) << "StreamTube.Offer returned successfully";
 
     // It might have been already opened - check
     if (mPriv->tube->state() != TubeChannelStateOpen) {
-        debug() << "Awaiting tube to be opened";
+        tpDebug(logTubes) << "Awaiting tube to be opened";
         // Wait until the tube gets opened on the other side
         connect(mPriv->tube.data(),
                 SIGNAL(stateChanged(Tp::TubeChannelState)),
@@ -99,19 +99,19 @@ void PendingOpenTube::onOfferFinished(PendingOperation *op)
 void PendingOpenTube::onTubeStateChanged(TubeChannelState state)
 {
     if (state == TubeChannelStateOpen) {
-        debug() << "Tube is now opened";
+        tpDebug(logTubes) << "Tube is now opened";
         // Inject the parameters into the tube
         mPriv->tube->setParameters(mPriv->parameters);
         // The tube is ready: let's notify
         setFinished();
     } else {
         if (state != TubeChannelStateRemotePending) {
-            warning() << "Offering tube failed with" << TP_QT_ERROR_CONNECTION_REFUSED;
+            tpWarning(logTubes) << "Offering tube failed with" << TP_QT_ERROR_CONNECTION_REFUSED;
             // Something happened
             setFinishedWithError(TP_QT_ERROR_CONNECTION_REFUSED,
                     QLatin1String("The connection to this tube was refused"));
         } else {
-            debug() << "Awaiting remote to accept the tube";
+            tpDebug(logTubes) << "Awaiting remote to accept the tube";
         }
     }
 }
@@ -306,7 +306,7 @@ PendingOperation *OutgoingStreamTubeChannel::offerTcpSocket(
         const QVariantMap &parameters)
 {
     if (!isReady(OutgoingStreamTubeChannel::FeatureCore)) {
-        warning() << "OutgoingStreamTubeChannel::FeatureCore must be ready before "
+        tpWarning(logTubes) << "OutgoingStreamTubeChannel::FeatureCore must be ready before "
                 "calling offerTube";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel not ready"),
@@ -315,7 +315,7 @@ PendingOperation *OutgoingStreamTubeChannel::offerTcpSocket(
 
     // The tube must be not offered
     if (state() != TubeChannelStateNotOffered) {
-        warning() << "You can not expose more than a socket for each Stream Tube";
+        tpWarning(logTubes) << "You can not expose more than a socket for each Stream Tube";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel busy"),
                 OutgoingStreamTubeChannelPtr(this));
@@ -343,7 +343,7 @@ PendingOperation *OutgoingStreamTubeChannel::offerTcpSocket(
             accessControl = SocketAccessControlLocalhost;
         } else {
             // There are no combinations supported for this socket
-            warning() << "You requested an address type/access control combination "
+            tpWarning(logTubes) << "You requested an address type/access control combination "
                     "not supported by this channel";
             return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                     QLatin1String("The requested address type/access control "
@@ -379,7 +379,7 @@ PendingOperation *OutgoingStreamTubeChannel::offerTcpSocket(
             accessControl = SocketAccessControlLocalhost;
         } else {
             // There are no combinations supported for this socket
-            warning() << "You requested an address type/access control combination "
+            tpWarning(logTubes) << "You requested an address type/access control combination "
                     "not supported by this channel";
             return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                     QLatin1String("The requested address type/access control "
@@ -407,7 +407,7 @@ PendingOperation *OutgoingStreamTubeChannel::offerTcpSocket(
         return op;
     } else {
         // We're handling an IPv4/IPv6 socket only
-        warning() << "offerTube can be called only with a QHostAddress representing "
+        tpWarning(logTubes) << "offerTube can be called only with a QHostAddress representing "
                 "an IPv4 or IPv6 address";
         return new PendingFailure(TP_QT_ERROR_INVALID_ARGUMENT,
                 QLatin1String("Invalid host given"),
@@ -483,7 +483,7 @@ PendingOperation *OutgoingStreamTubeChannel::offerUnixSocket(
             SocketAccessControlLocalhost;
 
     if (!isReady(OutgoingStreamTubeChannel::FeatureCore)) {
-        warning() << "OutgoingStreamTubeChannel::FeatureCore must be ready before "
+        tpWarning(logTubes) << "OutgoingStreamTubeChannel::FeatureCore must be ready before "
                 "calling offerTube";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel not ready"),
@@ -492,7 +492,7 @@ PendingOperation *OutgoingStreamTubeChannel::offerUnixSocket(
 
     // The tube must be not offered
     if (state() != TubeChannelStateNotOffered) {
-        warning() << "You can not expose more than a socket for each Stream Tube";
+        tpWarning(logTubes) << "You can not expose more than a socket for each Stream Tube";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel busy"), OutgoingStreamTubeChannelPtr(this));
     }
@@ -505,7 +505,7 @@ PendingOperation *OutgoingStreamTubeChannel::offerUnixSocket(
                 !supportsAbstractUnixSocketsOnLocalhost()) ||
             (accessControl == SocketAccessControlCredentials &&
                 !supportsAbstractUnixSocketsWithCredentials()) ) {
-            warning() << "You requested an address type/access control combination "
+            tpWarning(logTubes) << "You requested an address type/access control combination "
                     "not supported by this channel";
             return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                     QLatin1String("The requested address type/access control "
@@ -536,7 +536,7 @@ PendingOperation *OutgoingStreamTubeChannel::offerUnixSocket(
                 !supportsUnixSocketsWithCredentials()) ||
             (accessControl != SocketAccessControlLocalhost &&
                 accessControl != SocketAccessControlCredentials) ) {
-            warning() << "You requested an address type/access control combination "
+            tpWarning(logTubes) << "You requested an address type/access control combination "
                 "not supported by this channel";
             return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                     QLatin1String("The requested address type/access control "
@@ -614,7 +614,8 @@ PendingOperation *OutgoingStreamTubeChannel::offerUnixSocket(
 QHash<QPair<QHostAddress, quint16>, uint> OutgoingStreamTubeChannel::connectionsForSourceAddresses() const
 {
     if (addressType() != SocketAddressTypeIPv4 && addressType() != SocketAddressTypeIPv6) {
-        warning() << "OutgoingStreamTubeChannel::connectionsForSourceAddresses() makes sense "
+        tpWarning(logTubes) <<
+            "OutgoingStreamTubeChannel::connectionsForSourceAddresses() makes sense "
                 "just when offering a TCP socket";
         return QHash<QPair<QHostAddress, quint16>, uint>();
     }
@@ -622,13 +623,15 @@ QHash<QPair<QHostAddress, quint16>, uint> OutgoingStreamTubeChannel::connections
     if (isValid() || !isDroppingConnections() ||
             !requestedFeatures().contains(StreamTubeChannel::FeatureConnectionMonitoring)) {
         if (!isReady(StreamTubeChannel::FeatureConnectionMonitoring)) {
-            warning() << "StreamTubeChannel::FeatureConnectionMonitoring must be ready before "
+            tpWarning(logTubes) <<
+                "StreamTubeChannel::FeatureConnectionMonitoring must be ready before "
                 "   calling connectionsForSourceAddresses";
             return QHash<QPair<QHostAddress, quint16>, uint>();
         }
 
         if (state() != TubeChannelStateOpen) {
-            warning() << "OutgoingStreamTubeChannel::connectionsForSourceAddresses() makes sense "
+            tpWarning(logTubes) <<
+                "OutgoingStreamTubeChannel::connectionsForSourceAddresses() makes sense "
                 "just when the tube is open";
             return QHash<QPair<QHostAddress, quint16>, uint>();
         }
@@ -657,13 +660,13 @@ QHash<QPair<QHostAddress, quint16>, uint> OutgoingStreamTubeChannel::connections
 QHash<uchar, uint> OutgoingStreamTubeChannel::connectionsForCredentials() const
 {
     if (addressType() != SocketAddressTypeUnix && addressType() != SocketAddressTypeAbstractUnix) {
-        warning() << "OutgoingStreamTubeChannel::connectionsForCredentials() makes sense "
+        tpWarning(logTubes) << "OutgoingStreamTubeChannel::connectionsForCredentials() makes sense "
                 "just when offering an Unix socket";
         return QHash<uchar, uint>();
     }
 
     if (accessControl() != SocketAccessControlCredentials) {
-        warning() << "OutgoingStreamTubeChannel::connectionsForCredentials() makes sense "
+        tpWarning(logTubes) << "OutgoingStreamTubeChannel::connectionsForCredentials() makes sense "
                 "just when offering an Unix socket requiring credentials";
         return QHash<uchar, uint>();
     }
@@ -671,13 +674,15 @@ QHash<uchar, uint> OutgoingStreamTubeChannel::connectionsForCredentials() const
     if (isValid() || !isDroppingConnections() ||
             !requestedFeatures().contains(StreamTubeChannel::FeatureConnectionMonitoring)) {
         if (!isReady(StreamTubeChannel::FeatureConnectionMonitoring)) {
-            warning() << "StreamTubeChannel::FeatureConnectionMonitoring must be ready before "
+            tpWarning(logTubes) <<
+                "StreamTubeChannel::FeatureConnectionMonitoring must be ready before "
                 "calling OutgoingStreamTubeChannel::connectionsForCredentials()";
             return QHash<uchar, uint>();
         }
 
         if (state() != TubeChannelStateOpen) {
-            warning() << "OutgoingStreamTubeChannel::connectionsForCredentials() makes sense "
+            tpWarning(logTubes) <<
+                "OutgoingStreamTubeChannel::connectionsForCredentials() makes sense "
                 "just when the tube is opened";
             return QHash<uchar, uint>();
         }
@@ -686,6 +691,35 @@ QHash<uchar, uint> OutgoingStreamTubeChannel::connectionsForCredentials() const
     return mPriv->connectionsForCredentials;
 }
 
+/**
+ * Return the source address of the connection with the given id.
+ *
+ * This is the reverse of connectionsForSourceAddresses() for a single connection, without building
+ * or searching the whole map.
+ *
+ * This method is only useful if a TCP socket was offered on this tube and the connection manager
+ * supports #SocketAccessControlPort.
+ *
+ * This method requires StreamTubeChannel::FeatureConnectionMonitoring to be ready.
+ *
+ * \param connectionId The id of the connection.
+ * \return The source address as a (QHostAddress, port in native byte order) pair, or
+ *     (QHostAddress::Null, 0) if it is not known.
+ * \sa connectionsForSourceAddresses()
+ */
+QPair<QHostAddress, quint16> OutgoingStreamTubeChannel::sourceAddressForConnection(
+        uint connectionId) const
+{
+    if (!isReady(StreamTubeChannel::FeatureConnectionMonitoring)) {
+        tpWarning(logTubes) <<
+            "StreamTubeChannel::FeatureConnectionMonitoring must be ready before "
+            "calling OutgoingStreamTubeChannel::sourceAddressForConnection()";
+    }
+
+    return mPriv->sourceAddressesForConnections.value(connectionId,
+            qMakePair(QHostAddress(QHostAddress::Null), quint16(0)));
+}
+
 /**
  * Return a map from connection ids to the associated contact.
  *
@@ -702,13 +736,15 @@ QHash<uint, ContactPtr> OutgoingStreamTubeChannel::contactsForConnections() cons
     if (isValid() || !isDroppingConnections() ||
             !requestedFeatures().contains(StreamTubeChannel::FeatureConnectionMonitoring)) {
         if (!isReady(StreamTubeChannel::FeatureConnectionMonitoring)) {
-            warning() << "StreamTubeChannel::FeatureConnectionMonitoring must be ready before "
+            tpWarning(logTubes) <<
+                "StreamTubeChannel::FeatureConnectionMonitoring must be ready before "
                 "calling contactsForConnections";
             return QHash<uint, ContactPtr>();
         }
 
         if (state() != TubeChannelStateOpen) {
-            warning() << "OutgoingStreamTubeChannel::contactsForConnections() makes sense "
+            tpWarning(logTubes) <<
+                "OutgoingStreamTubeChannel::contactsForConnections() makes sense "
                 "just when the tube is open";
             return QHash<uint, ContactPtr>();
         }
@@ -734,7 +770,8 @@ void OutgoingStreamTubeChannel::onContactsRetrieved(
         const QList<Tp::ContactPtr> &contacts)
 {
     if (!isValid()) {
-        debug() << "Invalidated OutgoingStreamTubeChannel not emitting queued connection event";
+        tpDebug(logTubes) <<
+            "Invalidated OutgoingStreamTubeChannel not emitting queued connection event";
         return;
     }
 
@@ -750,26 +787,38 @@ void OutgoingStreamTubeChannel::onContactsRetrieved(
             // Remove stuff from our hashes
             mPriv->contactsForConnections.remove(conn.id);
 
-            QHash<QPair<QHostAddress, quint16>, uint>::iterator srcAddrIter =
-                mPriv->connectionsForSourceAddresses.begin();
-            while (srcAddrIter != mPriv->connectionsForSourceAddresses.end()) {
-                if (srcAddrIter.value() == conn.id) {
-                    srcAddrIter = mPriv->connectionsForSourceAddresses.erase(srcAddrIter);
-                } else {
-                    ++srcAddrIter;
+            // Only the entries under this connection's own key need to be looked at
+            if (mPriv->sourceAddressesForConnections.contains(conn.id)) {
+                QPair<QHostAddress, quint16> srcAddr =
+                    mPriv->sourceAddressesForConnections.take(conn.id);
+                QHash<QPair<QHostAddress, quint16>, uint>::iterator srcAddrIter =
+                    mPriv->connectionsForSourceAddresses.find(srcAddr);
+                while (srcAddrIter != mPriv->connectionsForSourceAddresses.end() &&
+                        srcAddrIter.key() == srcAddr) {
+                    if (srcAddrIter.value() == conn.id) {
+                        srcAddrIter = mPriv->connectionsForSourceAddresses.erase(srcAddrIter);
+                    } else {
+                        ++srcAddrIter;
+                    }
                 }
             }
 
-            QHash<uchar, uint>::iterator credIter = mPriv->connectionsForCredentials.begin();
-            while (credIter != mPriv->connectionsForCredentials.end()) {
-                if (credIter.value() == conn.id) {
-                    credIter = mPriv->connectionsForCredentials.erase(credIter);
-                } else {
-                    ++credIter;
+            if (mPriv->credentialsForConnections.contains(conn.id)) {
+                uchar credentialByte = mPriv->credentialsForConnections.take(conn.id);
+                QHash<uchar, uint>::iterator credIter =
+                    mPriv->connectionsForCredentials.find(credentialByte);
+                while (credIter != mPriv->connectionsForCredentials.end() &&
+                        credIter.key() == credentialByte) {
+                    if (credIter.value() == conn.id) {
+                        credIter = mPriv->connectionsForCredentials.erase(credIter);
+                    } else {
+                        ++credIter;
+                    }
                 }
             }
         } else {
-            warning() << "No pending connections found in OSTC" << objectPath() << "for contacts"
+            tpWarning(logTubes) <<
+                "No pending connections found in OSTC" << objectPath() << "for contacts"
                 << contacts;
         }
 
@@ -805,12 +854,14 @@ void OutgoingStreamTubeChannel::onContactsRetrieved(
         if (accessControl() == SocketAccessControlCredentials) {
             uchar credentialByte = qdbus_cast<uchar>(connectionProperties.second.variant());
             mPriv->connectionsForCredentials.insertMulti(credentialByte, connectionProperties.first);
+            mPriv->credentialsForConnections.insert(connectionProperties.first, credentialByte);
         }
     }
 
     if (address.first != QHostAddress::Null) {
         // We can map it to a source address as well
         mPriv->connectionsForSourceAddresses.insertMulti(address, connectionProperties.first);
+        mPriv->sourceAddressesForConnections.insert(connectionProperties.first, address);
     }
 
     // Time for us to emit the signal
@@ -63,6 +63,7 @@ public:
 
     QHash<QPair<QHostAddress,quint16>, uint> connectionsForSourceAddresses() const;
     QHash<uchar, uint> connectionsForCredentials() const;
+    QPair<QHostAddress, quint16> sourceAddressForConnection(uint connectionId) const;
 
 protected:
     OutgoingStreamTubeChannel(const ConnectionPtr &connection, const QString &objectPath,
@@ -0,0 +1,486 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2026 agent <agent@local>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "TelepathyQt/parsed-file-cache-internal.h"
+
+#include "TelepathyQt/debug-internal.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QTemporaryFile>
+#include <QThread>
+
+#include <stdio.h>
+#include <string.h>
+
+namespace Tp
+{
+
+// Bump whenever the layout of the cache file changes
+static const char cacheMagic[8] = { 'T', 'P', 'Q', 'T', 'P', 'F', 'C', '\0' };
+static const quint32 cacheFormatVersion = 1;
+static bool cacheEnabled = true;
+
+// All the live caches, so that deferred saves can be flushed together
+static QList<ParsedFileCache*> liveCaches;
+
+static void saveAllCaches()
+{
+    foreach (ParsedFileCache *cache, liveCaches) {
+        cache->save();
+    }
+}
+
+// Flushes the caches with pending changes once control returns to the event loop. It doesn't
+// use signals or slots, as it is also built into the test library which doesn't run moc.
+class TP_QT_NO_EXPORT DeferredCacheSaver : public QObject
+{
+public:
+    DeferredCacheSaver()
+        : timerId(0)
+    {
+        // Whatever could not be flushed from the event loop is written on exit
+        qAddPostRoutine(saveAllCaches);
+    }
+
+    void schedule()
+    {
+        // Caches used from other threads are only saved on exit
+        if (!timerId && QThread::currentThread() == thread()) {
+            timerId = startTimer(0);
+        }
+    }
+
+protected:
+    void timerEvent(QTimerEvent *event)
+    {
+        Q_UNUSED(event);
+        killTimer(timerId);
+        timerId = 0;
+        saveAllCaches();
+    }
+
+private:
+    int timerId;
+};
+
+Q_GLOBAL_STATIC(DeferredCacheSaver, deferredCacheSaver)
+
+struct TP_QT_NO_EXPORT ParsedFileCache::Private
+{
+    Private(const QString &name, quint32 version);
+    ~Private();
+
+    struct Entry
+    {
+        Entry()
+            : modified(0), size(0), offset(-1), length(0)
+        {
+        }
+
+        qint64 modified;
+        qint64 size;
+        // location of the data in the mapped cache file, or -1 if it is held in data
+        qint64 offset;
+        quint32 length;
+        QByteArray data;
+    };
+
+    struct DirectoryEntry
+    {
+        DirectoryEntry()
+            : modified(0)
+        {
+        }
+
+        qint64 modified;
+        QStringList fileNames;
+    };
+
+    static QString cacheFileName(const QString &name);
+    static qint64 modificationTime(const QFileInfo &fi);
+
+    void load();
+    void unmap();
+    QByteArray entryData(const Entry &entry) const;
+
+    QString fileName;
+    quint32 version;
+    QFile file;
+    uchar *mapped;
+    qint64 mappedSize;
+    QHash<QString, Entry> entries;
+    QHash<QString, DirectoryEntry> directories;
+    bool dirty;
+    int savingSuspended;
+};
+
+ParsedFileCache::Private::Private(const QString &name, quint32 version)
+    : fileName(cacheFileName(name)),
+      version(version),
+      mapped(0),
+      mappedSize(0),
+      dirty(false),
+      savingSuspended(0)
+{
+    load();
+}
+
+ParsedFileCache::Private::~Private()
+{
+    unmap();
+}
+
+QString ParsedFileCache::Private::cacheFileName(const QString &name)
+{
+    QString cacheDir = QString::fromLocal8Bit(qgetenv("XDG_CACHE_HOME"));
+    if (cacheDir.isEmpty()) {
+        cacheDir = QString(QLatin1String("%1/.cache")).arg(QString::fromLocal8Bit(qgetenv("HOME")));
+    }
+
+    return QString(QLatin1String("%1/telepathy/qt-%2.cache")).arg(cacheDir).arg(name);
+}
+
+qint64 ParsedFileCache::Private::modificationTime(const QFileInfo &fi)
+{
+    return fi.lastModified().toMSecsSinceEpoch();
+}
+
+void ParsedFileCache::Private::load()
+{
+    file.setFileName(fileName);
+    if (!file.open(QFile::ReadOnly)) {
+        return;
+    }
+
+    mappedSize = file.size();
+    mapped = mappedSize > 0 ? file.map(0, mappedSize) : 0;
+    if (!mapped) {
+        file.close();
+        return;
+    }
+
+    // Only the index is read here, the data of each entry is read from the mapping on lookup
+    QByteArray contents = QByteArray::fromRawData(reinterpret_cast<const char *>(mapped),
+            mappedSize);
+    QDataStream stream(contents);
+    setupStream(stream);
+
+    char magic[sizeof(cacheMagic)];
+    quint32 formatVersion = 0, cacheVersion = 0;
+    if (stream.readRawData(magic, sizeof(magic)) != (int) sizeof(magic) ||
+        memcmp(magic, cacheMagic, sizeof(magic)) != 0) {
+        tpWarning(logGeneral) << "Ignoring invalid cache file" << fileName;
+        unmap();
+        return;
+    }
+
+    stream >> formatVersion >> cacheVersion;
+    if (formatVersion != cacheFormatVersion || cacheVersion != version) {
+        tpDebug(logGeneral) << "Ignoring cache file" << fileName << "with a different version";
+        unmap();
+        return;
+    }
+
+    quint32 count;
+    stream >> count;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString dirName;
+        DirectoryEntry dir;
+        stream >> dirName >> dir.modified >> dir.fileNames;
+        directories.insert(dirName, dir);
+    }
+
+    stream >> count;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString entryName;
+        Entry entry;
+        stream >> entryName >> entry.modified >> entry.size >> entry.length;
+        entry.offset = stream.device()->pos();
+        if (stream.skipRawData(entry.length) != (int) entry.length) {
+            break;
+        }
+        entries.insert(entryName, entry);
+    }
+
+    if (stream.status() != QDataStream::Ok || entries.size() != (int) count) {
+        tpWarning(logGeneral) << "Ignoring truncated cache file" << fileName;
+        entries.clear();
+        directories.clear();
+        unmap();
+        return;
+    }
+
+    tpDebug(logGeneral) << "Loaded" << entries.size() << "entries from cache file" << fileName;
+}
+
+void ParsedFileCache::Private::unmap()
+{
+    if (mapped) {
+        // entries pointing to the mapping must not outlive it
+        QHash<QString, Entry>::iterator i = entries.begin();
+        while (i != entries.end()) {
+            if (i->offset >= 0) {
+                i->data = QByteArray(reinterpret_cast<const char *>(mapped) + i->offset,
+                        i->length);
+                i->offset = -1;
+            }
+            ++i;
+        }
+
+        file.unmap(mapped);
+        mapped = 0;
+        mappedSize = 0;
+    }
+    file.close();
+}
+
+QByteArray ParsedFileCache::Private::entryData(const Entry &entry) const
+{
+    if (entry.offset < 0) {
+        return entry.data;
+    }
+
+    Q_ASSERT(mapped && entry.offset + entry.length <= mappedSize);
+    return QByteArray::fromRawData(reinterpret_cast<const char *>(mapped) + entry.offset,
+            entry.length);
+}
+
+ParsedFileCache *ParsedFileCache::managers()
+{
+    static ParsedFileCache *cache = 0;
+    if (!cache) {
+        cache = new ParsedFileCache(QLatin1String("managers"), 1);
+    }
+    return cache;
+}
+
+ParsedFileCache *ParsedFileCache::profiles()
+{
+    static ParsedFileCache *cache = 0;
+    if (!cache) {
+        cache = new ParsedFileCache(QLatin1String("profiles"), 2);
+    }
+    return cache;
+}
+
+ParsedFileCache::ParsedFileCache(const QString &name, quint32 version)
+    : mPriv(new Private(name, version))
+{
+    liveCaches.append(this);
+}
+
+ParsedFileCache::~ParsedFileCache()
+{
+    liveCaches.removeOne(this);
+    delete mPriv;
+}
+
+QString ParsedFileCache::fileName() const
+{
+    return mPriv->fileName;
+}
+
+bool ParsedFileCache::lookup(const QString &fileName, QByteArray &data) const
+{
+    if (!cacheEnabled) {
+        return false;
+    }
+
+    QFileInfo fi(fileName);
+    QHash<QString, Private::Entry>::const_iterator i =
+        mPriv->entries.constFind(fi.absoluteFilePath());
+    if (i == mPriv->entries.constEnd()) {
+        return false;
+    }
+
+    if (!fi.exists() || fi.size() != i->size ||
+        Private::modificationTime(fi) != i->modified) {
+        return false;
+    }
+
+    data = mPriv->entryData(*i);
+    return true;
+}
+
+void ParsedFileCache::insert(const QString &fileName, const QByteArray &data)
+{
+    if (!cacheEnabled) {
+        return;
+    }
+
+    QFileInfo fi(fileName);
+    Private::Entry entry;
+    entry.modified = Private::modificationTime(fi);
+    entry.size = fi.size();
+    entry.length = data.size();
+    entry.data = data;
+    mPriv->entries.insert(fi.absoluteFilePath(), entry);
+    mPriv->dirty = true;
+}
+
+bool ParsedFileCache::lookupDirectory(const QString &dirName, QStringList &fileNames) const
+{
+    if (!cacheEnabled) {
+        return false;
+    }
+
+    QHash<QString, Private::DirectoryEntry>::const_iterator i =
+        mPriv->directories.constFind(dirName);
+    if (i == mPriv->directories.constEnd()) {
+        return false;
+    }
+
+    QFileInfo fi(dirName);
+    if (!fi.exists() || Private::modificationTime(fi) != i->modified) {
+        return false;
+    }
+
+    fileNames = i->fileNames;
+    return true;
+}
+
+void ParsedFileCache::insertDirectory(const QString &dirName, const QStringList &fileNames)
+{
+    if (!cacheEnabled) {
+        return;
+    }
+
+    Private::DirectoryEntry dir;
+    dir.modified = Private::modificationTime(QFileInfo(dirName));
+    dir.fileNames = fileNames;
+    mPriv->directories.insert(dirName, dir);
+    mPriv->dirty = true;
+}
+
+void ParsedFileCache::suspendSaving()
+{
+    ++mPriv->savingSuspended;
+}
+
+void ParsedFileCache::resumeSaving()
+{
+    Q_ASSERT(mPriv->savingSuspended > 0);
+    if (--mPriv->savingSuspended == 0) {
+        saveLater();
+    }
+}
+
+void ParsedFileCache::saveLater()
+{
+    if (!mPriv->dirty) {
+        return;
+    }
+
+    DeferredCacheSaver *saver = deferredCacheSaver();
+    if (saver) {
+        saver->schedule();
+    }
+}
+
+void ParsedFileCache::save()
+{
+    if (!mPriv->dirty || mPriv->savingSuspended > 0) {
+        return;
+    }
+    mPriv->dirty = false;
+
+    QFileInfo fi(mPriv->fileName);
+    if (!QDir().mkpath(fi.absolutePath())) {
+        tpWarning(logGeneral) << "Unable to create cache directory" << fi.absolutePath();
+        return;
+    }
+
+    // Write to a new temporary file and rename it over the old one, so that other processes
+    // (and our own mapping) never see a partially written file
+    QTemporaryFile out(mPriv->fileName + QLatin1String(".XXXXXX"));
+    if (!out.open()) {
+        tpWarning(logGeneral) << "Unable to create a temporary file for cache file" <<
+            mPriv->fileName;
+        return;
+    }
+    QString tmpFileName = out.fileName();
+
+    QDataStream stream(&out);
+    setupStream(stream);
+    stream.writeRawData(cacheMagic, sizeof(cacheMagic));
+    stream << cacheFormatVersion << mPriv->version;
+
+    stream << (quint32) mPriv->directories.size();
+    QHash<QString, Private::DirectoryEntry>::const_iterator dir = mPriv->directories.constBegin();
+    while (dir != mPriv->directories.constEnd()) {
+        stream << dir.key() << dir->modified << dir->fileNames;
+        ++dir;
+    }
+
+    // drop entries for files that went away
+    QList<QString> entryNames;
+    QHash<QString, Private::Entry>::const_iterator entry = mPriv->entries.constBegin();
+    while (entry != mPriv->entries.constEnd()) {
+        if (QFile::exists(entry.key())) {
+            entryNames.append(entry.key());
+        }
+        ++entry;
+    }
+
+    stream << (quint32) entryNames.size();
+    foreach (const QString &entryName, entryNames) {
+        const Private::Entry &e = mPriv->entries[entryName];
+        QByteArray data = mPriv->entryData(e);
+        stream << entryName << e.modified << e.size << (quint32) data.size();
+        stream.writeRawData(data.constData(), data.size());
+    }
+
+    out.close();
+    if (stream.status() != QDataStream::Ok || out.error() != QFile::NoError ||
+        ::rename(QFile::encodeName(tmpFileName).constData(),
+                 QFile::encodeName(mPriv->fileName).constData()) != 0) {
+        tpWarning(logGeneral) << "Unable to write cache file" << mPriv->fileName;
+        return;
+    }
+    // it's been renamed, there is nothing left to remove
+    out.setAutoRemove(false);
+
+    tpDebug(logGeneral) << "Saved" << entryNames.size() << "entries to cache file" <<
+        mPriv->fileName;
+}
+
+void ParsedFileCache::setupStream(QDataStream &stream)
+{
+    stream.setVersion(QDataStream::Qt_4_6);
+    stream.setByteOrder(QDataStream::LittleEndian);
+}
+
+bool ParsedFileCache::isEnabled()
+{
+    return cacheEnabled;
+}
+
+void ParsedFileCache::setEnabled(bool enabled)
+{
+    cacheEnabled = enabled;
+}
+
+} // Tp
@@ -0,0 +1,87 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2026 agent <agent@local>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _TelepathyQt_parsed_file_cache_internal_h_HEADER_GUARD_
+#define _TelepathyQt_parsed_file_cache_internal_h_HEADER_GUARD_
+
+#include <TelepathyQt/Global>
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QString>
+#include <QStringList>
+
+namespace Tp
+{
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+// Versioned binary cache of parsed .manager and .profile files, stored in the user cache
+// directory and shared by all processes. Entries are validated against the modification time
+// and size of their source file, and directory listings against the directory modification
+// time, so files are only parsed again when they change on disk. Changes are written back in
+// one go, once control returns to the event loop or when the application exits.
+class TP_QT_NO_EXPORT ParsedFileCache
+{
+    Q_DISABLE_COPY(ParsedFileCache)
+
+public:
+    static ParsedFileCache *managers();
+    static ParsedFileCache *profiles();
+
+    ParsedFileCache(const QString &name, quint32 version);
+    ~ParsedFileCache();
+
+    QString fileName() const;
+
+    bool lookup(const QString &fileName, QByteArray &data) const;
+    void insert(const QString &fileName, const QByteArray &data);
+
+    bool lookupDirectory(const QString &dirName, QStringList &fileNames) const;
+    void insertDirectory(const QString &dirName, const QStringList &fileNames);
+
+    // save() writes pending changes right away, saveLater() defers them so that the changes
+    // made while parsing a whole directory of files only rewrite the cache file once
+    void save();
+    void saveLater();
+
+    // While suspended, save() is a no-op; resumeSaving() then writes all pending changes once
+    void suspendSaving();
+    void resumeSaving();
+
+    static void setupStream(QDataStream &stream);
+
+    // Disabling the caches makes every lookup miss and every change be dropped, which is
+    // mostly useful to measure the cost of parsing the files themselves
+    static bool isEnabled();
+    static void setEnabled(bool enabled);
+
+private:
+    struct Private;
+    friend struct Private;
+    Private *mPriv;
+};
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+} // Tp
+
+#endif
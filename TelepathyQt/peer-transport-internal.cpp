@@ -0,0 +1,143 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2026 agent <agent@local>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "TelepathyQt/peer-transport-internal.h"
+
+#include "TelepathyQt/debug-internal.h"
+
+#include <TelepathyQt/DBusProxy>
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+namespace Tp
+{
+
+namespace
+{
+
+struct Peer
+{
+    Peer() : refs(0) { }
+
+    QString name;
+    int refs;
+};
+
+// Sockets shared by the attached proxies of the same connection, by bus, service and object path
+QMutex peersMutex;
+QHash<QString, Peer> peers;
+
+QString peerKey(const DBusProxy *proxy)
+{
+    return proxy->dbusConnection().name() + QLatin1Char('\n') + proxy->busName() +
+        QLatin1Char('\n') + proxy->objectPath();
+}
+
+}
+
+bool PeerTransport::attach(DBusProxy *proxy, const QString &address)
+{
+    QMutexLocker locker(&peersMutex);
+    QString key = peerKey(proxy);
+    Peer &peer = peers[key];
+    if (peer.refs > 0) {
+        // Another proxy for the same connection already connected, share its socket
+        ++peer.refs;
+        setPeerName(proxy, peer.name);
+        return true;
+    }
+
+    static QAtomicInt serial;
+    QString name = QString(QLatin1String("tpqt-p2p-%1")).arg(serial.fetchAndAddOrdered(1));
+
+    QDBusConnection conn = QDBusConnection::connectToPeer(address, name);
+    if (!conn.isConnected()) {
+        tpWarning(logConnections) << "Unable to connect to peer at" << address << "-" <<
+            conn.lastError().message();
+        QDBusConnection::disconnectFromPeer(name);
+        peers.remove(key);
+        return false;
+    }
+
+    tpDebug(logConnections) << "Using peer connection" << name << "for" << proxy->objectPath();
+    peer.name = name;
+    peer.refs = 1;
+    setPeerName(proxy, name);
+    return true;
+}
+
+void PeerTransport::detach(DBusProxy *proxy)
+{
+    QMutexLocker locker(&peersMutex);
+    setPeerName(proxy, QString());
+
+    QHash<QString, Peer>::iterator i = peers.find(peerKey(proxy));
+    if (i == peers.end()) {
+        return;
+    }
+
+    if (--i->refs > 0) {
+        return;
+    }
+
+    QDBusConnection::disconnectFromPeer(i->name);
+    peers.erase(i);
+}
+
+void PeerTransport::inherit(DBusProxy *proxy, const DBusProxy *from)
+{
+    // Only objects of the same service can be reached through its peer connection
+    if (from && proxy->busName() == from->busName()) {
+        setPeerName(proxy, peerName(from));
+    }
+}
+
+QString PeerTransport::livePeer(const DBusProxy *proxy)
+{
+    QString name = peerName(proxy);
+    if (name.isEmpty()) {
+        return QString();
+    }
+
+    // A peer that went away (the service closed it) is kept until the proxies detach, but new
+    // interfaces go back to the bus
+    if (!QDBusConnection(name).isConnected()) {
+        return QString();
+    }
+
+    return name;
+}
+
+QDBusConnection PeerTransport::connectionFor(const DBusProxy *proxy)
+{
+    QString name = livePeer(proxy);
+    return name.isEmpty() ? proxy->dbusConnection() : QDBusConnection(name);
+}
+
+QString PeerTransport::serviceFor(const DBusProxy *proxy)
+{
+    return livePeer(proxy).isEmpty() ? proxy->busName() : QString();
+}
+
+} // Tp
@@ -0,0 +1,76 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2026 agent <agent@local>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _TelepathyQt_peer_transport_internal_h_HEADER_GUARD_
+#define _TelepathyQt_peer_transport_internal_h_HEADER_GUARD_
+
+#include <TelepathyQt/Global>
+
+#include <QDBusConnection>
+#include <QString>
+
+// Draft interface implemented by BaseConnection when peer-to-peer mode is enabled
+#define TP_QT_IFACE_CONNECTION_INTERFACE_PEER_TO_PEER_DRAFT \
+    (QLatin1String("org.freedesktop.Telepathy.Connection.Interface.PeerToPeer.DRAFT"))
+
+namespace Tp
+{
+
+class DBusProxy;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+// Direct D-Bus connections to connection services, used instead of the bus only by the proxies
+// which were explicitly given one: a Connection built by a factory with peer-to-peer enabled
+// attaches itself, and the channels constructed for it inherit its peer. Other proxies for the
+// same service, for instance from another factory, keep using the bus.
+class TP_QT_NO_EXPORT PeerTransport
+{
+public:
+    // Connects proxy, which must be a Connection, to its service listening at address. Each
+    // successful attach() must be balanced by a detach(); proxies for the same connection share
+    // one socket, closed when the last of them detaches.
+    static bool attach(DBusProxy *proxy, const QString &address);
+    static void detach(DBusProxy *proxy);
+
+    // Makes proxy, typically a channel being constructed, use the peer of from, if any. This
+    // doesn't keep the socket open, so from must outlive proxy.
+    static void inherit(DBusProxy *proxy, const DBusProxy *from);
+
+    // The connection to use for proxy's interfaces, which is proxy->dbusConnection() unless it
+    // was given a peer which is still connected.
+    static QDBusConnection connectionFor(const DBusProxy *proxy);
+    // The service name to use along with connectionFor(); peer connections have no names.
+    static QString serviceFor(const DBusProxy *proxy);
+
+private:
+    static QString livePeer(const DBusProxy *proxy);
+
+    // Defined along with DBusProxy, which stores the peer of each proxy
+    static QString peerName(const DBusProxy *proxy);
+    static void setPeerName(DBusProxy *proxy, const QString &name);
+};
+
+#endif
+
+} // Tp
+
+#endif
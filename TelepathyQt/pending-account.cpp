@@ -109,10 +109,10 @@ AccountManagerPtr PendingAccount::manager() const
 AccountPtr PendingAccount::account() const
 {
     if (!isFinished()) {
-        warning() << "PendingAccount::account called before finished, returning 0";
+        tpWarning(logAccounts) << "PendingAccount::account called before finished, returning 0";
         return AccountPtr();
     } else if (!isValid()) {
-        warning() << "PendingAccount::account called when not valid, returning 0";
+        tpWarning(logAccounts) << "PendingAccount::account called when not valid, returning 0";
         return AccountPtr();
     }
 
@@ -126,7 +126,8 @@ void PendingAccount::onCallFinished(QDBusPendingCallWatcher *watcher)
     if (!reply.isError()) {
         QString objectPath = reply.value().path();
 
-        debug() << "Got reply to AccountManager.CreateAccount - object path:" << objectPath;
+        tpDebug(logAccounts) << "Got reply to AccountManager.CreateAccount - object path:" <<
+            objectPath;
 
         PendingReady *readyOp = manager()->accountFactory()->proxy(manager()->busName(),
                 objectPath, manager()->connectionFactory(),
@@ -136,7 +137,7 @@ void PendingAccount::onCallFinished(QDBusPendingCallWatcher *watcher)
                 SIGNAL(finished(Tp::PendingOperation*)),
                 SLOT(onAccountBuilt(Tp::PendingOperation*)));
     } else {
-        debug().nospace() <<
+        tpDebug(logAccounts).nospace() <<
             "CreateAccount failed: " <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
@@ -150,7 +151,7 @@ void PendingAccount::onAccountBuilt(Tp::PendingOperation *op)
     Q_ASSERT(op->isFinished());
 
     if (op->isError()) {
-        warning() << "Making account ready using the factory failed:" <<
+        tpWarning(logAccounts) << "Making account ready using the factory failed:" <<
             op->errorName() << op->errorMessage();
         setFinishedWithError(op->errorName(), op->errorMessage());
     } else {
@@ -160,7 +161,7 @@ void PendingAccount::onAccountBuilt(Tp::PendingOperation *op)
 
         if (manager()->allAccounts().contains(mPriv->account)) {
             setFinished();
-            debug() << "New account" << mPriv->account->objectPath() << "built";
+            tpDebug(logAccounts) << "New account" << mPriv->account->objectPath() << "built";
         } else {
             // Have to wait for the AM to pick up the change and signal it so the world can be
             // assumed to be ~round when we finish
@@ -177,7 +178,8 @@ void PendingAccount::onNewAccount(const AccountPtr &account)
         return;
     }
 
-    debug() << "Account" << account->objectPath() << "added to AM, finishing PendingAccount";
+    tpDebug(logAccounts) << "Account" << account->objectPath() <<
+        "added to AM, finishing PendingAccount";
     setFinished();
 }
 
@@ -148,7 +148,7 @@ PendingCaptchas::PendingCaptchas(
     : PendingOperation(captchaAuthentication),
       mPriv(new PendingCaptchas::Private(this))
 {
-    warning() << "PendingCaptchas created with instant failure";
+    tpWarning(logChannels) << "PendingCaptchas created with instant failure";
     setFinishedWithError(errorName, errorMessage);
 }
 
@@ -169,7 +169,8 @@ void PendingCaptchas::onChannelInvalidated(Tp::DBusProxy *proxy,
         return;
     }
 
-    warning().nospace() << "PendingCaptchas failed because channel was invalidated with " <<
+    tpWarning(logChannels).nospace() <<
+        "PendingCaptchas failed because channel was invalidated with " <<
         errorName << ": " << errorMessage;
 
     setFinishedWithError(errorName, errorMessage);
@@ -180,14 +181,14 @@ void PendingCaptchas::onGetCaptchasWatcherFinished(QDBusPendingCallWatcher *watc
     QDBusPendingReply<Tp::CaptchaInfoList, uint, QString> reply = *watcher;
 
     if (reply.isError()) {
-        debug().nospace() << "PendingDBusCall failed: " <<
+        tpDebug(logChannels).nospace() << "PendingDBusCall failed: " <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
         watcher->deleteLater();
         return;
     }
 
-    debug() << "Got reply to PendingDBusCall";
+    tpDebug(logChannels) << "Got reply to PendingDBusCall";
     Tp::CaptchaInfoList list = qdbus_cast<Tp::CaptchaInfoList>(reply.argumentAt(0));
     int howManyRequired = reply.argumentAt(1).toUInt();
 
@@ -205,7 +206,8 @@ void PendingCaptchas::onGetCaptchasWatcherFinished(QDBusPendingCallWatcher *watc
                 // Ok, move on
             } else {
                 // In this case, there's something wrong
-                warning() << "Got a captcha with type " << info.type << " which does not "
+                tpWarning(logChannels) <<
+                    "Got a captcha with type " << info.type << " which does not "
                         "expose any available mimetype for its payload. Something might be "
                         "wrong with the connection manager.";
                 continue;
@@ -242,7 +244,7 @@ void PendingCaptchas::onGetCaptchasWatcherFinished(QDBusPendingCallWatcher *watc
     }
 
     if (finalList.size() != howManyRequired) {
-        warning() << "No captchas available matching the specified preferences";
+        tpWarning(logChannels) << "No captchas available matching the specified preferences";
         setFinishedWithError(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("No captchas matching the handler's request"));
         return;
@@ -289,14 +291,14 @@ void PendingCaptchas::onGetCaptchaDataWatcherFinished(QDBusPendingCallWatcher *w
     QDBusPendingReply<QByteArray> reply = *watcher;
 
     if (reply.isError()) {
-        debug().nospace() << "PendingDBusCall failed: " <<
+        tpDebug(logChannels).nospace() << "PendingDBusCall failed: " <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
         watcher->deleteLater();
         return;
     }
 
-    debug() << "Got reply to PendingDBusCall";
+    tpDebug(logChannels) << "Got reply to PendingDBusCall";
 
     // Add to the list
     mPriv->appendCaptchaResult(watcher->property("__Tp_Qt_CaptchaMimeType").toString(),
@@ -107,7 +107,7 @@ PendingChannelRequest::PendingChannelRequest(const AccountPtr &account,
                         userActionTime.isNull() ? 0 : userActionTime.toTime_t(),
                         preferredHandler, hints.allHints()), this);
             } else {
-                warning() << "Hints passed to channel request won't have an effect"
+                tpWarning(logClients) << "Hints passed to channel request won't have an effect"
                     << "because the Channel Dispatcher service in use is too old";
             }
         }
@@ -130,7 +130,7 @@ PendingChannelRequest::PendingChannelRequest(const AccountPtr &account,
                         userActionTime.isNull() ? 0 : userActionTime.toTime_t(),
                         preferredHandler, hints.allHints()), this);
             } else {
-                warning() << "Hints passed to channel request won't have an effect"
+                tpWarning(logClients) << "Hints passed to channel request won't have an effect"
                     << "because the Channel Dispatcher service in use is too old";
             }
         }
@@ -224,7 +224,7 @@ void PendingChannelRequest::onWatcherFinished(QDBusPendingCallWatcher *watcher)
 
     if (!reply.isError()) {
         QDBusObjectPath objectPath = reply.argumentAt<0>();
-        debug() << "Got reply to ChannelDispatcher.Ensure/CreateChannel "
+        tpDebug(logClients) << "Got reply to ChannelDispatcher.Ensure/CreateChannel "
             "- object path:" << objectPath.path();
 
         if (!account().isNull()) {
@@ -249,7 +249,7 @@ void PendingChannelRequest::onWatcherFinished(QDBusPendingCallWatcher *watcher)
                     SLOT(onProceedOperationFinished(Tp::PendingOperation*)));
         }
     } else {
-        debug().nospace() << "Ensure/CreateChannel failed:" <<
+        tpDebug(logClients).nospace() << "Ensure/CreateChannel failed:" <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
     }
@@ -81,7 +81,8 @@ protected:
             const ContactFactoryConstPtr &contactFactory) const
     {
         if (mAccount->objectPath() != objectPath) {
-            warning() << "Account received by the fake factory is different from original account";
+            tpWarning(logChannels) <<
+                "Account received by the fake factory is different from original account";
         }
         return mAccount;
     }
@@ -196,7 +197,7 @@ PendingChannel::PendingChannel(const AccountPtr &account,
             .replace(QLatin1String("."), QLatin1String("_")))
         .arg(Private::numHandlers++);
     if (!mPriv->cr->registerClient(mPriv->handler, handlerName, false)) {
-        warning() << "Unable to register handler" << handlerName;
+        tpWarning(logChannels) << "Unable to register handler" << handlerName;
         setFinishedWithError(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Unable to register handler"));
         return;
@@ -211,7 +212,7 @@ PendingChannel::PendingChannel(const AccountPtr &account,
 
     handlerName = QString(QLatin1String("org.freedesktop.Telepathy.Client.%1")).arg(handlerName);
 
-    debug() << "Requesting channel through account using handler" << handlerName;
+    tpDebug(logChannels) << "Requesting channel through account using handler" << handlerName;
     PendingChannelRequest *pcr;
     if (create) {
         pcr = account->createChannel(request, userActionTime, handlerName, ChannelRequestHints());
@@ -268,10 +269,12 @@ ConnectionPtr PendingChannel::connection() const
 bool PendingChannel::yours() const
 {
     if (!isFinished()) {
-        warning() << "PendingChannel::yours called before finished, returning undefined value";
+        tpWarning(logChannels) <<
+            "PendingChannel::yours called before finished, returning undefined value";
     }
     else if (!isValid()) {
-        warning() << "PendingChannel::yours called when not valid, returning undefined value";
+        tpWarning(logChannels) <<
+            "PendingChannel::yours called when not valid, returning undefined value";
     }
 
     return mPriv->yours;
@@ -345,7 +348,7 @@ QVariantMap PendingChannel::immutableProperties() const
     // This is a reasonable guess - if it's Yours it's guaranteedly Requested by us, and if it's not
     // it could be either Requested by somebody else but also an incoming channel just as well.
     if (!props.contains(TP_QT_IFACE_CHANNEL + QLatin1String(".Requested"))) {
-        debug() << "CM didn't provide Requested in channel immutable props, guessing"
+        tpDebug(logChannels) << "CM didn't provide Requested in channel immutable props, guessing"
             << mPriv->yours;
         props[TP_QT_IFACE_CHANNEL + QLatin1String(".Requested")] =
             mPriv->yours;
@@ -356,7 +359,8 @@ QVariantMap PendingChannel::immutableProperties() const
     if (!props.contains(TP_QT_IFACE_CHANNEL + QLatin1String(".InitiatorHandle"))) {
         if (qdbus_cast<bool>(props.value(TP_QT_IFACE_CHANNEL + QLatin1String(".Requested")))) {
             if (connection() && connection()->isReady(Connection::FeatureCore)) {
-                debug() << "CM didn't provide InitiatorHandle in channel immutable props, but we "
+                tpDebug(logChannels) <<
+                    "CM didn't provide InitiatorHandle in channel immutable props, but we "
                     "know it's the conn's self handle (and have it)";
                 props[TP_QT_IFACE_CHANNEL + QLatin1String(".InitiatorHandle")] =
                     connection()->selfHandle();
@@ -375,10 +379,10 @@ QVariantMap PendingChannel::immutableProperties() const
 ChannelPtr PendingChannel::channel() const
 {
     if (!isFinished()) {
-        warning() << "PendingChannel::channel called before finished, returning 0";
+        tpWarning(logChannels) << "PendingChannel::channel called before finished, returning 0";
         return ChannelPtr();
     } else if (!isValid()) {
-        warning() << "PendingChannel::channel called when not valid, returning 0";
+        tpWarning(logChannels) << "PendingChannel::channel called when not valid, returning 0";
         return ChannelPtr();
     }
 
@@ -394,10 +398,12 @@ ChannelPtr PendingChannel::channel() const
 HandledChannelNotifier *PendingChannel::handledChannelNotifier() const
 {
     if (!isFinished()) {
-        warning() << "PendingChannel::handledChannelNotifier called before finished, returning 0";
+        tpWarning(logChannels) <<
+            "PendingChannel::handledChannelNotifier called before finished, returning 0";
         return 0;
     } else if (!isValid()) {
-        warning() << "PendingChannel::handledChannelNotifier called when not valid, returning 0";
+        tpWarning(logChannels) <<
+            "PendingChannel::handledChannelNotifier called when not valid, returning 0";
         return 0;
     }
 
@@ -415,7 +421,8 @@ void PendingChannel::onConnectionCreateChannelFinished(QDBusPendingCallWatcher *
         QString objectPath = reply.argumentAt<0>().path();
         QVariantMap map = reply.argumentAt<1>();
 
-        debug() << "Got reply to Connection.CreateChannel - object path:" << objectPath;
+        tpDebug(logChannels) << "Got reply to Connection.CreateChannel - object path:" <<
+            objectPath;
 
         PendingReady *channelReady =
             connection()->channelFactory()->proxy(connection(), objectPath, map);
@@ -430,7 +437,7 @@ void PendingChannel::onConnectionCreateChannelFinished(QDBusPendingCallWatcher *
                 SIGNAL(finished(Tp::PendingOperation*)),
                 SLOT(onChannelReady(Tp::PendingOperation*)));
     } else {
-        debug().nospace() << "CreateChannel failed:" <<
+        tpDebug(logChannels).nospace() << "CreateChannel failed:" <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
     }
@@ -447,7 +454,8 @@ void PendingChannel::onConnectionEnsureChannelFinished(QDBusPendingCallWatcher *
         QString objectPath = reply.argumentAt<1>().path();
         QVariantMap map = reply.argumentAt<2>();
 
-        debug() << "Got reply to Connection.EnsureChannel - object path:" << objectPath;
+        tpDebug(logChannels) << "Got reply to Connection.EnsureChannel - object path:" <<
+            objectPath;
 
         PendingReady *channelReady =
             connection()->channelFactory()->proxy(connection(), objectPath, map);
@@ -462,7 +470,7 @@ void PendingChannel::onConnectionEnsureChannelFinished(QDBusPendingCallWatcher *
                 SIGNAL(finished(Tp::PendingOperation*)),
                 SLOT(onChannelReady(Tp::PendingOperation*)));
     } else {
-        debug().nospace() << "EnsureChannel failed:" <<
+        tpDebug(logChannels).nospace() << "EnsureChannel failed:" <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
     }
@@ -475,7 +483,8 @@ void PendingChannel::onChannelReady(PendingOperation *op)
     if (!op->isError()) {
         setFinished();
     } else {
-        debug() << "Making the channel ready for" << this << "failed with" << op->errorName()
+        tpDebug(logChannels) <<
+            "Making the channel ready for" << this << "failed with" << op->errorName()
             << ":" << op->errorMessage();
         setFinishedWithError(op->errorName(), op->errorMessage());
     }
@@ -487,7 +496,7 @@ void PendingChannel::onHandlerError(const QString &errorName, const QString &err
         return;
     }
 
-    warning() << "Creating/ensuring channel failed with" << errorName
+    tpWarning(logChannels) << "Creating/ensuring channel failed with" << errorName
         << ":" << errorMessage;
     setFinishedWithError(errorName, errorMessage);
 }
@@ -495,7 +504,8 @@ void PendingChannel::onHandlerError(const QString &errorName, const QString &err
 void PendingChannel::onHandlerChannelReceived(const ChannelPtr &channel)
 {
     if (isFinished()) {
-        warning() << "Handler received the channel but this operation already finished due "
+        tpWarning(logChannels) <<
+            "Handler received the channel but this operation already finished due "
             "to failure in the channel request";
         return;
     }
@@ -519,14 +529,15 @@ void PendingChannel::onAccountCreateChannelFinished(PendingOperation *op)
 {
     if (isFinished()) {
         if (isError()) {
-            warning() << "Creating/ensuring channel finished with a failure after the internal "
+            tpWarning(logChannels) <<
+                "Creating/ensuring channel finished with a failure after the internal "
                 "handler already got a channel, ignoring";
         }
         return;
     }
 
     if (op->isError()) {
-        warning() << "Creating/ensuring channel failed with" << op->errorName()
+        tpWarning(logChannels) << "Creating/ensuring channel failed with" << op->errorName()
             << ":" << op->errorMessage();
         setFinishedWithError(op->errorName(), op->errorMessage());
         return;
@@ -536,14 +547,16 @@ void PendingChannel::onAccountCreateChannelFinished(PendingOperation *op)
         // Our handler hasn't be called but the channel request is complete.
         // That means another handler handled the channels so we don't own it.
         if (mPriv->create) {
-            warning() << "Creating/ensuring channel failed with" << TP_QT_ERROR_SERVICE_CONFUSED
+            tpWarning(logChannels) <<
+                "Creating/ensuring channel failed with" << TP_QT_ERROR_SERVICE_CONFUSED
                 << ":" << QLatin1String("CD.CreateChannel/WithHints returned successfully and "
                         "the handler didn't receive the channel yet");
             setFinishedWithError(TP_QT_ERROR_SERVICE_CONFUSED,
                     QLatin1String("CD.CreateChannel/WithHints returned successfully and "
                         "the handler didn't receive the channel yet"));
         } else {
-            warning() << "Creating/ensuring channel failed with" << TP_QT_ERROR_NOT_YOURS
+            tpWarning(logChannels) <<
+                "Creating/ensuring channel failed with" << TP_QT_ERROR_NOT_YOURS
                 << ":" << QLatin1String("Another handler is handling this channel");
             setFinishedWithError(TP_QT_ERROR_NOT_YOURS,
                     QLatin1String("Another handler is handling this channel"));
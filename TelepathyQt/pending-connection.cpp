@@ -117,10 +117,12 @@ ConnectionManagerPtr PendingConnection::manager() const
 ConnectionPtr PendingConnection::connection() const
 {
     if (!isFinished()) {
-        warning() << "PendingConnection::connection called before finished, returning 0";
+        tpWarning(logConnections) <<
+            "PendingConnection::connection called before finished, returning 0";
         return ConnectionPtr();
     } else if (!isValid()) {
-        warning() << "PendingConnection::connection called when not valid, returning 0";
+        tpWarning(logConnections) <<
+            "PendingConnection::connection called when not valid, returning 0";
         return ConnectionPtr();
     }
 
@@ -135,7 +137,7 @@ void PendingConnection::onCallFinished(QDBusPendingCallWatcher *watcher)
         QString busName = reply.argumentAt<0>();
         QString objectPath = reply.argumentAt<1>().path();
 
-        debug() << "Got reply to ConnectionManager.CreateConnection - bus name:" <<
+        tpDebug(logConnections) << "Got reply to ConnectionManager.CreateConnection - bus name:" <<
             busName << "- object path:" << objectPath;
 
         PendingReady *readyOp = manager()->connectionFactory()->proxy(busName,
@@ -145,7 +147,7 @@ void PendingConnection::onCallFinished(QDBusPendingCallWatcher *watcher)
                 SIGNAL(finished(Tp::PendingOperation*)),
                 SLOT(onConnectionBuilt(Tp::PendingOperation*)));
     } else {
-        debug().nospace() <<
+        tpDebug(logConnections).nospace() <<
             "CreateConnection failed: " <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
@@ -159,12 +161,12 @@ void PendingConnection::onConnectionBuilt(Tp::PendingOperation *op)
     Q_ASSERT(op->isFinished());
 
     if (op->isError()) {
-        warning() << "Making connection ready using the factory failed:" <<
+        tpWarning(logConnections) << "Making connection ready using the factory failed:" <<
             op->errorName() << op->errorMessage();
         setFinishedWithError(op->errorName(), op->errorMessage());
     } else {
         setFinished();
-        debug() << "New connection" << mPriv->connection->objectPath() << "built";
+        tpDebug(logConnections) << "New connection" << mPriv->connection->objectPath() << "built";
     }
 }
 
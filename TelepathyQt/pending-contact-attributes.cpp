@@ -131,11 +131,12 @@ bool PendingContactAttributes::shouldReference() const
 ReferencedHandles PendingContactAttributes::validHandles() const
 {
     if (!isFinished()) {
-        warning() << "PendingContactAttributes::validHandles() called before finished";
+        tpWarning(logContacts) << "PendingContactAttributes::validHandles() called before finished";
     } else if (isError()) {
-        warning() << "PendingContactAttributes::validHandles() called when errored";
+        tpWarning(logContacts) << "PendingContactAttributes::validHandles() called when errored";
     } else if (!shouldReference()) {
-        warning() << "PendingContactAttributes::validHandles() called but weren't asked to"
+        tpWarning(logContacts) <<
+            "PendingContactAttributes::validHandles() called but weren't asked to"
                   << "reference handles";
     }
 
@@ -152,9 +153,9 @@ ReferencedHandles PendingContactAttributes::validHandles() const
 UIntList PendingContactAttributes::invalidHandles() const
 {
     if (!isFinished()) {
-        warning() << "PendingContactAttributes::validHandles() called before finished";
+        tpWarning(logContacts) << "PendingContactAttributes::validHandles() called before finished";
     } else if (isError()) {
-        warning() << "PendingContactAttributes::validHandles() called when errored";
+        tpWarning(logContacts) << "PendingContactAttributes::validHandles() called when errored";
     }
 
     return mPriv->invalidHandles;
@@ -171,9 +172,9 @@ UIntList PendingContactAttributes::invalidHandles() const
 ContactAttributesMap PendingContactAttributes::attributes() const
 {
     if (!isFinished()) {
-        warning() << "PendingContactAttributes::validHandles() called before finished";
+        tpWarning(logContacts) << "PendingContactAttributes::validHandles() called before finished";
     } else if (isError()) {
-        warning() << "PendingContactAttributes::validHandles() called when errored";
+        tpWarning(logContacts) << "PendingContactAttributes::validHandles() called when errored";
     }
 
     return mPriv->attributes;
@@ -184,7 +185,8 @@ void PendingContactAttributes::onCallFinished(QDBusPendingCallWatcher* watcher)
     QDBusPendingReply<ContactAttributesMap> reply = *watcher;
 
     if (reply.isError()) {
-        debug().nospace() << "GetCAs: error " << reply.error().name() << ": " << reply.error().message();
+        tpDebug(logContacts).nospace() << "GetCAs: error " << reply.error().name() << ": " <<
+            reply.error().message();
         setFinishedWithError(reply.error());
     } else {
         mPriv->attributes = reply.value();
@@ -99,9 +99,9 @@ ContactPtr PendingContactInfo::contact() const
 Contact::InfoFields PendingContactInfo::infoFields() const
 {
     if (!isFinished()) {
-        warning() << "PendingContactInfo::info called before finished";
+        tpWarning(logContacts) << "PendingContactInfo::info called before finished";
     } else if (!isValid()) {
-        warning() << "PendingContactInfo::info called when not valid";
+        tpWarning(logContacts) << "PendingContactInfo::info called when not valid";
     }
 
     return mPriv->info;
@@ -113,10 +113,10 @@ void PendingContactInfo::onCallFinished(QDBusPendingCallWatcher *watcher)
 
     if (!reply.isError()) {
         mPriv->info = Contact::InfoFields(reply.value());
-        debug() << "Got reply to ContactInfo.RequestContactInfo";
+        tpDebug(logContacts) << "Got reply to ContactInfo.RequestContactInfo";
         setFinished();
     } else {
-        debug().nospace() <<
+        tpDebug(logContacts).nospace() <<
             "ContactInfo.RequestContactInfo failed: " <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
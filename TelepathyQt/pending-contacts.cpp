@@ -26,13 +26,13 @@
 #include "TelepathyQt/_gen/pending-contacts.moc.hpp"
 #include "TelepathyQt/_gen/pending-contacts-internal.moc.hpp"
 
+#include "TelepathyQt/contact-manager-internal.h"
 #include "TelepathyQt/debug-internal.h"
 
 #include <TelepathyQt/Connection>
 #include <TelepathyQt/ConnectionLowlevel>
 #include <TelepathyQt/ContactManager>
 #include <TelepathyQt/ContactFactory>
-#include <TelepathyQt/PendingContactAttributes>
 #include <TelepathyQt/PendingHandles>
 #include <TelepathyQt/ReferencedHandles>
 
@@ -151,13 +151,15 @@ bool PendingContacts::Private::checkRequestTypeAndState(const char *methodName,
         RequestType type)
 {
     if (!parent->isFinished()) {
-        warning().nospace() << "PendingContacts::" << methodName << "() called before finished";
+        tpWarning(logContacts).nospace() << "PendingContacts::" << methodName <<
+            "() called before finished";
         return false;
     } else if (parent->isError()) {
-        warning().nospace() << "PendingContacts::" << methodName << "() called when errored";
+        tpWarning(logContacts).nospace() << "PendingContacts::" << methodName <<
+            "() called when errored";
         return false;
     } else if (requestType != type) {
-        warning().nospace() << "PendingContacts::" << methodName << "() called for" <<
+        tpWarning(logContacts).nospace() << "PendingContacts::" << methodName << "() called for" <<
             this << "which is not for " << debug;
         return false;
     }
@@ -196,9 +198,9 @@ PendingContacts::PendingContacts(const ContactManagerPtr &manager,
     if (!otherContacts.isEmpty()) {
         ConnectionPtr conn = manager->connection();
         if (conn->interfaces().contains(TP_QT_IFACE_CONNECTION_INTERFACE_CONTACTS)) {
-            PendingContactAttributes *attributes =
-                conn->lowlevel()->contactAttributes(otherContacts.toList(),
-                        interfaces, true);
+            // merged with the other requests made in this main loop iteration
+            PendingOperation *attributes =
+                manager->contactAttributes(otherContacts.toList(), interfaces);
 
             connect(attributes,
                     SIGNAL(finished(Tp::PendingOperation*)),
@@ -331,7 +333,8 @@ bool PendingContacts::isForHandles() const
 UIntList PendingContacts::handles() const
 {
     if (!isForHandles()) {
-        warning() << "Tried to get handles from" << this << "which is not for handles!";
+        tpWarning(logContacts) << "Tried to get handles from" << this <<
+            "which is not for handles!";
     }
 
     return mPriv->handles;
@@ -345,7 +348,8 @@ bool PendingContacts::isForIdentifiers() const
 QStringList PendingContacts::identifiers() const
 {
     if (!isForIdentifiers()) {
-        warning() << "Tried to get identifiers from" << this << "which is not for identifiers!";
+        tpWarning(logContacts) << "Tried to get identifiers from" << this <<
+            "which is not for identifiers!";
         return QStringList();
     }
 
@@ -360,7 +364,8 @@ bool PendingContacts::isForVCardAddresses() const
 QString PendingContacts::vcardField() const
 {
     if (!isForVCardAddresses()) {
-        warning() << "Tried to get vcard field from" << this << "which is not for vcard addresses!";
+        tpWarning(logContacts) << "Tried to get vcard field from" << this <<
+            "which is not for vcard addresses!";
     }
 
     return mPriv->vcardField;
@@ -369,7 +374,8 @@ QString PendingContacts::vcardField() const
 QStringList PendingContacts::vcardAddresses() const
 {
     if (!isForVCardAddresses()) {
-        warning() << "Tried to get vcard addresses from" << this << "which is not for vcard addresses!";
+        tpWarning(logContacts) << "Tried to get vcard addresses from" << this <<
+            "which is not for vcard addresses!";
         return QStringList();
     }
 
@@ -384,7 +390,7 @@ bool PendingContacts::isForUris() const
 QStringList PendingContacts::uris() const
 {
     if (!isForUris()) {
-        warning() << "Tried to get uris from" << this << "which is not for uris!";
+        tpWarning(logContacts) << "Tried to get uris from" << this << "which is not for uris!";
         return QStringList();
     }
 
@@ -399,7 +405,8 @@ bool PendingContacts::isUpgrade() const
 QList<ContactPtr> PendingContacts::contactsToUpgrade() const
 {
     if (!isUpgrade()) {
-        warning() << "Tried to get contacts to upgrade from" << this << "which is not an upgrade!";
+        tpWarning(logContacts) << "Tried to get contacts to upgrade from" << this <<
+            "which is not an upgrade!";
     }
 
     return mPriv->contactsToUpgrade;
@@ -408,9 +415,9 @@ QList<ContactPtr> PendingContacts::contactsToUpgrade() const
 QList<ContactPtr> PendingContacts::contacts() const
 {
     if (!isFinished()) {
-        warning() << "PendingContacts::contacts() called before finished";
+        tpWarning(logContacts) << "PendingContacts::contacts() called before finished";
     } else if (isError()) {
-        warning() << "PendingContacts::contacts() called when errored";
+        tpWarning(logContacts) << "PendingContacts::contacts() called when errored";
     }
 
     return mPriv->contacts;
@@ -481,27 +488,38 @@ QStringList PendingContacts::invalidUris() const
 
 void PendingContacts::onAttributesFinished(PendingOperation *operation)
 {
-    PendingContactAttributes *pendingAttributes =
-        qobject_cast<PendingContactAttributes *>(operation);
+    ContactManager::PendingAttributes *pendingAttributes =
+        qobject_cast<ContactManager::PendingAttributes *>(operation);
 
     if (pendingAttributes->isError()) {
-        debug() << "PendingAttrs error" << pendingAttributes->errorName()
+        tpDebug(logContacts) << "PendingAttrs error" << pendingAttributes->errorName()
                 << "message" << pendingAttributes->errorMessage();
         setFinishedWithError(pendingAttributes->errorName(), pendingAttributes->errorMessage());
         return;
     }
 
-    ReferencedHandles validHandles = pendingAttributes->validHandles();
-    ContactAttributesMap attributes = pendingAttributes->attributes();
+    // the reply may be shared with other requests, so only index it instead of searching
+    // it for each handle
+    QList<ReferencedHandles> validHandles = pendingAttributes->validHandles();
+    QHash<uint, QPair<int, int> > validHandlesIndex;
+    for (int i = 0; i < validHandles.size(); ++i) {
+        const ReferencedHandles &chunkHandles = validHandles.at(i);
+        for (int j = 0; j < chunkHandles.size(); ++j) {
+            validHandlesIndex.insert(chunkHandles.at(j), qMakePair(i, j));
+        }
+    }
+    // Only use const accessors on the map from here, as it is shared with the
+    // pending attributes operation and detaching it would copy every contact's attributes
+    const ContactAttributesMap attributes = pendingAttributes->attributes();
 
     foreach (uint handle, mPriv->handles) {
         if (!mPriv->satisfyingContacts.contains(handle)) {
-            int indexInValid = validHandles.indexOf(handle);
-            if (indexInValid >= 0) {
-                ReferencedHandles referencedHandle = validHandles.mid(indexInValid, 1);
-                QVariantMap handleAttributes = attributes[handle];
+            if (validHandlesIndex.contains(handle)) {
+                QPair<int, int> indexInValid = validHandlesIndex.value(handle);
+                ReferencedHandles referencedHandle =
+                    validHandles.at(indexInValid.first).mid(indexInValid.second, 1);
                 mPriv->satisfyingContacts.insert(handle, manager()->ensureContact(referencedHandle,
-                            mPriv->missingFeatures, handleAttributes));
+                            mPriv->missingFeatures, attributes.value(handle)));
             } else {
                 mPriv->invalidHandles.push_back(handle);
             }
@@ -519,7 +537,7 @@ void PendingContacts::onRequestHandlesFinished(PendingOperation *operation)
     mPriv->invalidIds = pendingHandles->invalidNames();
 
     if (pendingHandles->isError()) {
-        debug() << "RequestHandles error" << operation->errorName()
+        tpDebug(logContacts) << "RequestHandles error" << operation->errorName()
                 << "message" << operation->errorMessage();
         setFinishedWithError(operation->errorName(), operation->errorMessage());
         return;
@@ -545,17 +563,18 @@ void PendingContacts::onAddressingGetContactsFinished(PendingOperation *operatio
     }
 
     ConnectionPtr conn = mPriv->manager->connection();
-    ContactAttributesMap attributes = pa->attributes();
+    const ContactAttributesMap attributes = pa->attributes();
     UIntList handles = attributes.keys();
     ReferencedHandles referencedHandles(conn, HandleTypeContact, handles);
 
-    foreach (uint handle, handles) {
-        int indexInValid = referencedHandles.indexOf(handle);
-        Q_ASSERT(indexInValid >= 0);
+    // The referenced handles are in the order of the map keys
+    int indexInValid = 0;
+    for (ContactAttributesMap::const_iterator it = attributes.constBegin();
+            it != attributes.constEnd(); ++it, ++indexInValid) {
+        Q_ASSERT(referencedHandles.at(indexInValid) == it.key());
         ReferencedHandles referencedHandle = referencedHandles.mid(indexInValid, 1);
-        QVariantMap handleAttributes = attributes[handle];
         ContactPtr contact = mPriv->manager->ensureContact(referencedHandle,
-                    mPriv->missingFeatures, handleAttributes);
+                    mPriv->missingFeatures, it.value());
         mPriv->contacts.push_back(contact);
     }
 
@@ -567,7 +586,7 @@ void PendingContacts::onReferenceHandlesFinished(PendingOperation *operation)
     PendingHandles *pendingHandles = qobject_cast<PendingHandles *>(operation);
 
     if (pendingHandles->isError()) {
-        debug() << "ReferenceHandles error" << operation->errorName()
+        tpDebug(logContacts) << "ReferenceHandles error" << operation->errorName()
                 << "message" << operation->errorMessage();
         setFinishedWithError(operation->errorName(), operation->errorMessage());
         return;
@@ -604,7 +623,7 @@ void PendingContacts::onNestedFinished(PendingOperation *operation)
     Q_ASSERT(operation == mPriv->nested);
 
     if (operation->isError()) {
-        debug() << " error" << operation->errorName()
+        tpDebug(logContacts) << " error" << operation->errorName()
                 << "message" << operation->errorMessage();
         setFinishedWithError(operation->errorName(), operation->errorMessage());
         return;
@@ -620,7 +639,7 @@ void PendingContacts::onInspectHandlesFinished(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<QStringList> reply = *watcher;
 
     if (reply.isError()) {
-        debug().nospace() << "InspectHandles: error " << reply.error().name() << ": "
+        tpDebug(logContacts).nospace() << "InspectHandles: error " << reply.error().name() << ": "
             << reply.error().message();
         setFinishedWithError(reply.error());
         return;
@@ -712,7 +731,7 @@ void PendingAddressingGetContacts::onGetContactsFinished(QDBusPendingCallWatcher
         mAttributes = reply.argumentAt<1>();
         setFinished();
     } else {
-        debug().nospace() << "GetContactsBy* failed: " <<
+        tpDebug(logContacts).nospace() << "GetContactsBy* failed: " <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
     }
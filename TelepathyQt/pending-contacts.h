@@ -89,6 +89,7 @@ private Q_SLOTS:
 
 private:
     friend class ContactManager;
+    friend class ContactSearchChannel;
 
     enum RequestType
     {
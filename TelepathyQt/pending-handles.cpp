@@ -70,7 +70,7 @@ PendingHandles::PendingHandles(const ConnectionPtr &connection, HandleType handl
     : PendingOperation(connection),
       mPriv(new Private)
 {
-    debug() << "PendingHandles(request)";
+    tpDebug(logConnections) << "PendingHandles(request)";
 
     mPriv->handleType = handleType;
     mPriv->isRequest = true;
@@ -93,7 +93,7 @@ PendingHandles::PendingHandles(const ConnectionPtr &connection, HandleType handl
     : PendingOperation(connection),
       mPriv(new Private)
 {
-    debug() << "PendingHandles(reference)";
+    tpDebug(logConnections) << "PendingHandles(reference)";
 
     mPriv->handleType = handleType;
     mPriv->isRequest = false;
@@ -102,11 +102,11 @@ PendingHandles::PendingHandles(const ConnectionPtr &connection, HandleType handl
     mPriv->requestsFinished = 0;
 
     if (notYetHeld.isEmpty()) {
-        debug() << " All handles already held, finishing up instantly";
+        tpDebug(logConnections) << " All handles already held, finishing up instantly";
         mPriv->handles = mPriv->alreadyHeld;
         setFinished();
     } else {
-        debug() << " Calling HoldHandles";
+        tpDebug(logConnections) << " Calling HoldHandles";
 
         QDBusPendingCallWatcher *watcher =
             new QDBusPendingCallWatcher(
@@ -191,10 +191,10 @@ const QStringList &PendingHandles::namesRequested() const
 QStringList PendingHandles::validNames() const
 {
     if (!isFinished()) {
-        warning() << "PendingHandles::validNames called before finished";
+        tpWarning(logConnections) << "PendingHandles::validNames called before finished";
         return QStringList();
     } else if (!isValid()) {
-        warning() << "PendingHandles::validNames called when not valid";
+        tpWarning(logConnections) << "PendingHandles::validNames called when not valid";
         return QStringList();
     }
 
@@ -204,7 +204,7 @@ QStringList PendingHandles::validNames() const
 QHash<QString, QPair<QString, QString> > PendingHandles::invalidNames() const
 {
     if (!isFinished()) {
-        warning() << "PendingHandles::invalidNames called before finished";
+        tpWarning(logConnections) << "PendingHandles::invalidNames called before finished";
         return QHash<QString, QPair<QString, QString> >();
     }
 
@@ -238,10 +238,10 @@ const UIntList &PendingHandles::handlesToReference() const
 ReferencedHandles PendingHandles::handles() const
 {
     if (!isFinished()) {
-        warning() << "PendingHandles::handles() called before finished";
+        tpWarning(logConnections) << "PendingHandles::handles() called before finished";
         return ReferencedHandles();
     } else if (!isValid()) {
-        warning() << "PendingHandles::handles() called when not valid";
+        tpWarning(logConnections) << "PendingHandles::handles() called when not valid";
         return ReferencedHandles();
     }
 
@@ -251,7 +251,7 @@ ReferencedHandles PendingHandles::handles() const
 UIntList PendingHandles::invalidHandles() const
 {
     if (!isFinished()) {
-        warning() << "PendingHandles::invalidHandles called before finished";
+        tpWarning(logConnections) << "PendingHandles::invalidHandles called before finished";
     }
 
     return mPriv->invalidHandles;
@@ -279,7 +279,7 @@ void PendingHandles::onRequestHandlesFinished(QDBusPendingCallWatcher *watcher)
         }
 
         if (mPriv->namesRequested.size() == 1) {
-            debug().nospace() << " Failure: error " <<
+            tpDebug(logConnections).nospace() << " Failure: error " <<
                 reply.error().name() << ": " <<
                 reply.error().message();
 
@@ -306,7 +306,7 @@ void PendingHandles::onRequestHandlesFinished(QDBusPendingCallWatcher *watcher)
             mPriv->idsForWatchers.insert(watcher, name);
         }
     } else {
-        debug() << "Received reply to RequestHandles";
+        tpDebug(logConnections) << "Received reply to RequestHandles";
         mPriv->handles = ReferencedHandles(connection(),
                 mPriv->handleType, reply.value());
         mPriv->validNames.append(mPriv->namesRequested);
@@ -319,10 +319,10 @@ void PendingHandles::onHoldHandlesFinished(QDBusPendingCallWatcher *watcher)
 {
     QDBusPendingReply<void> reply = *watcher;
 
-    debug() << "Received reply to HoldHandles";
+    tpDebug(logConnections) << "Received reply to HoldHandles";
 
     if (reply.isError()) {
-        debug().nospace() << " Failure: error " <<
+        tpDebug(logConnections).nospace() << " Failure: error " <<
             reply.error().name() << ": " <<
             reply.error().message();
 
@@ -338,7 +338,7 @@ void PendingHandles::onHoldHandlesFinished(QDBusPendingCallWatcher *watcher)
         }
 
         if (mPriv->handlesToReference.size() == 1) {
-            debug().nospace() << " Failure: error " <<
+            tpDebug(logConnections).nospace() << " Failure: error " <<
                 reply.error().name() << ": " <<
                 reply.error().message();
 
@@ -377,10 +377,10 @@ void PendingHandles::onRequestHandlesFallbackFinished(QDBusPendingCallWatcher *w
     Q_ASSERT(mPriv->idsForWatchers.contains(watcher));
     QString id = mPriv->idsForWatchers.value(watcher);
 
-    debug() << "Received reply to RequestHandles(" << id << ")";
+    tpDebug(logConnections) << "Received reply to RequestHandles(" << id << ")";
 
     if (reply.isError()) {
-        debug().nospace() << " Failure: error " << reply.error().name() << ": "
+        tpDebug(logConnections).nospace() << " Failure: error " << reply.error().name() << ": "
             << reply.error().message();
 
         // if the error is disconnected for example, fail immediately
@@ -430,9 +430,9 @@ void PendingHandles::onRequestHandlesFallbackFinished(QDBusPendingCallWatcher *w
             setFinished();
         }
 
-        debug() << " namesRequested:" << mPriv->namesRequested;
-        debug() << " invalidNames  :" << mPriv->invalidNames;
-        debug() << " validNames    :" << mPriv->validNames;
+        tpDebug(logConnections) << " namesRequested:" << mPriv->namesRequested;
+        tpDebug(logConnections) << " invalidNames  :" << mPriv->invalidNames;
+        tpDebug(logConnections) << " validNames    :" << mPriv->validNames;
 
         connection()->handleRequestLanded(mPriv->handleType);
     }
@@ -447,10 +447,10 @@ void PendingHandles::onHoldHandlesFallbackFinished(QDBusPendingCallWatcher *watc
     Q_ASSERT(mPriv->handlesForWatchers.contains(watcher));
     uint handle = mPriv->handlesForWatchers.value(watcher);
 
-    debug() << "Received reply to HoldHandles(" << handle << ")";
+    tpDebug(logConnections) << "Received reply to HoldHandles(" << handle << ")";
 
     if (reply.isError()) {
-        debug().nospace() << " Failure: error " << reply.error().name() << ": "
+        tpDebug(logConnections).nospace() << " Failure: error " << reply.error().name() << ": "
             << reply.error().message();
 
         // if the error is disconnected for example, fail immediately
@@ -29,10 +29,12 @@
 #include "TelepathyQt/_gen/pending-operation.moc.hpp"
 #include "TelepathyQt/_gen/simple-pending-operations.moc.hpp"
 
+#include "TelepathyQt/completion-queue-internal.h"
 #include "TelepathyQt/debug-internal.h"
 
 #include <QDBusPendingCall>
 #include <QDBusPendingCallWatcher>
+#include <QThread>
 #include <QTimer>
 
 namespace Tp
@@ -40,18 +42,35 @@ namespace Tp
 
 struct TP_QT_NO_EXPORT PendingOperation::Private
 {
-    Private(const SharedPtr<RefCounted> &object)
-        : object(object),
-          finished(false)
+    Private(PendingOperation *parent, const SharedPtr<RefCounted> &object)
+        : parent(parent),
+          object(object),
+          finished(false),
+          queuePosition(-1)
     {
     }
 
+    void scheduleFinished();
+
+    PendingOperation *parent;
     SharedPtr<RefCounted> object;
     QString errorName;
     QString errorMessage;
     bool finished;
+    // Position in the completion queue while finished() is waiting to be emitted from it
+    qint64 queuePosition;
 };
 
+void PendingOperation::Private::scheduleFinished()
+{
+    if (parent->thread() == QThread::currentThread()) {
+        queuePosition = CompletionQueue::forCurrentThread()->enqueue(parent);
+    } else {
+        // The completion queue belongs to the thread the operation lives in
+        QTimer::singleShot(0, parent, SLOT(emitFinished()));
+    }
+}
+
 /**
  * \class PendingOperation
  * \headerfile TelepathyQt/pending-operation.h <TelepathyQt/PendingOperation>
@@ -89,7 +108,7 @@ struct TP_QT_NO_EXPORT PendingOperation::Private
  */
 PendingOperation::PendingOperation(const SharedPtr<RefCounted> &object)
     : QObject(),
-      mPriv(new Private(object))
+      mPriv(new Private(this, object))
 {
 }
 
@@ -99,11 +118,15 @@ PendingOperation::PendingOperation(const SharedPtr<RefCounted> &object)
 PendingOperation::~PendingOperation()
 {
     if (!mPriv->finished) {
-        warning() << this <<
+        tpWarning(logGeneral) << this <<
             "still pending when it was deleted - finished will "
             "never be emitted";
     }
 
+    if (mPriv->queuePosition >= 0) {
+        CompletionQueue::cancelQueued(this, mPriv->queuePosition);
+    }
+
     delete mPriv;
 }
 
@@ -120,6 +143,7 @@ SharedPtr<RefCounted> PendingOperation::object() const
 void PendingOperation::emitFinished()
 {
     Q_ASSERT(mPriv->finished);
+    mPriv->queuePosition = -1;
     emit finished(this);
     deleteLater();
 }
@@ -132,18 +156,19 @@ void PendingOperation::setFinished()
 {
     if (mPriv->finished) {
         if (!mPriv->errorName.isEmpty()) {
-            warning() << this << "trying to finish with success, but already"
+            tpWarning(logGeneral) << this << "trying to finish with success, but already"
                 " failed with" << mPriv->errorName << ":" << mPriv->errorMessage;
         } else {
-            warning() << this << "trying to finish with success, but already"
+            tpWarning(logGeneral) << this << "trying to finish with success, but already"
                 " succeeded";
         }
         return;
     }
 
+    tpTrace(logGeneral, "PendingOperation finished", this, 0);
     mPriv->finished = true;
     Q_ASSERT(isValid());
-    QTimer::singleShot(0, this, SLOT(emitFinished()));
+    mPriv->scheduleFinished();
 }
 
 /**
@@ -158,27 +183,28 @@ void PendingOperation::setFinishedWithError(const QString &name,
 {
     if (mPriv->finished) {
         if (mPriv->errorName.isEmpty()) {
-            warning() << this << "trying to fail with" << name <<
+            tpWarning(logGeneral) << this << "trying to fail with" << name <<
                 "but already failed with" << errorName() << ":" <<
                 errorMessage();
         } else {
-            warning() << this << "trying to fail with" << name <<
+            tpWarning(logGeneral) << this << "trying to fail with" << name <<
                 "but already succeeded";
         }
         return;
     }
 
     if (name.isEmpty()) {
-        warning() << this << "should be given a non-empty error name";
+        tpWarning(logGeneral) << this << "should be given a non-empty error name";
         mPriv->errorName = QLatin1String("org.freedesktop.Telepathy.Qt.ErrorHandlingError");
     } else {
         mPriv->errorName = name;
     }
 
+    tpTrace(logGeneral, "PendingOperation failed", this, 0);
     mPriv->errorMessage = message;
     mPriv->finished = true;
     Q_ASSERT(isError());
-    QTimer::singleShot(0, this, SLOT(emitFinished()));
+    mPriv->scheduleFinished();
 }
 
 /**
@@ -74,6 +74,7 @@ private Q_SLOTS:
     TP_QT_NO_EXPORT void emitFinished();
 
 private:
+    friend class CompletionQueue;
     friend class ContactManager;
     friend class ReadinessHelper;
 
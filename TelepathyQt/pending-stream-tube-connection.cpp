@@ -93,7 +93,7 @@ PendingStreamTubeConnection::PendingStreamTubeConnection(
             SIGNAL(invalidated(Tp::DBusProxy*,QString,QString)),
             SLOT(onChannelInvalidated(Tp::DBusProxy*,QString,QString)));
 
-    debug() << "Calling StreamTube.Accept";
+    tpDebug(logTubes) << "Calling StreamTube.Accept";
     if (acceptOperation->isFinished()) {
         onAcceptFinished(acceptOperation);
     } else {
@@ -198,7 +198,8 @@ void PendingStreamTubeConnection::onChannelInvalidated(DBusProxy *proxy,
         return;
     }
 
-    warning().nospace() << "StreamTube.Accept failed because channel was invalidated with " <<
+    tpWarning(logTubes).nospace() <<
+        "StreamTube.Accept failed because channel was invalidated with " <<
         errorName << ": " << errorMessage;
 
     setFinishedWithError(errorName, errorMessage);
@@ -211,30 +212,30 @@ void PendingStreamTubeConnection::onAcceptFinished(PendingOperation *op)
     }
 
     if (op->isError()) {
-        warning().nospace() << "StreamTube.Accept failed with " <<
+        tpWarning(logTubes).nospace() << "StreamTube.Accept failed with " <<
             op->errorName() << ": " << op->errorMessage();
         setFinishedWithError(op->errorName(), op->errorMessage());
         return;
     }
 
-    debug() << "StreamTube.Accept returned successfully";
+    tpDebug(logTubes) << "StreamTube.Accept returned successfully";
 
     PendingVariant *pv = qobject_cast<PendingVariant *>(op);
     // Build the address
     if (mPriv->type == SocketAddressTypeIPv4) {
         SocketAddressIPv4 addr = qdbus_cast<SocketAddressIPv4>(pv->result());
-        debug().nospace() << "Got address " << addr.address << ":" << addr.port;
+        tpDebug(logTubes).nospace() << "Got address " << addr.address << ":" << addr.port;
         mPriv->hostAddress = QHostAddress(addr.address);
         mPriv->port = addr.port;
     } else if (mPriv->type == SocketAddressTypeIPv6) {
         SocketAddressIPv6 addr = qdbus_cast<SocketAddressIPv6>(pv->result());
-        debug().nospace() << "Got address " << addr.address << ":" << addr.port;
+        tpDebug(logTubes).nospace() << "Got address " << addr.address << ":" << addr.port;
         mPriv->hostAddress = QHostAddress(addr.address);
         mPriv->port = addr.port;
     } else {
         // Unix socket
         mPriv->socketPath = QLatin1String(qdbus_cast<QByteArray>(pv->result()));
-        debug() << "Got socket " << mPriv->socketPath;
+        tpDebug(logTubes) << "Got socket " << mPriv->socketPath;
     }
 
     // It might have been already opened - check
@@ -249,7 +250,7 @@ void PendingStreamTubeConnection::onAcceptFinished(PendingOperation *op)
 
 void PendingStreamTubeConnection::onTubeStateChanged(TubeChannelState state)
 {
-    debug() << "Tube state changed to " << state;
+    tpDebug(logTubes) << "Tube state changed to " << state;
     if (state == TubeChannelStateOpen) {
         // The tube is ready, populate its properties
         if (mPriv->type == SocketAddressTypeIPv4 || mPriv->type == SocketAddressTypeIPv6) {
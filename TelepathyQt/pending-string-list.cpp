@@ -85,11 +85,11 @@ void PendingStringList::watcherFinished(QDBusPendingCallWatcher* watcher)
     QDBusPendingReply<QStringList> reply = *watcher;
 
     if (!reply.isError()) {
-        debug() << "Got reply to PendingStringList call";
+        tpDebug(logGeneral) << "Got reply to PendingStringList call";
         setResult(reply.value());
         setFinished();
     } else {
-        debug().nospace() << "PendingStringList call failed: " <<
+        tpDebug(logGeneral).nospace() << "PendingStringList call failed: " <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
     }
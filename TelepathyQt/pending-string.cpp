@@ -86,11 +86,11 @@ void PendingString::watcherFinished(QDBusPendingCallWatcher* watcher)
     QDBusPendingReply<QString> reply = *watcher;
 
     if (!reply.isError()) {
-        debug() << "Got reply to PendingString call";
+        tpDebug(logGeneral) << "Got reply to PendingString call";
         setResult(reply.value());
         setFinished();
     } else {
-        debug().nospace() << "PendingString call failed: " <<
+        tpDebug(logGeneral).nospace() << "PendingString call failed: " <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
     }
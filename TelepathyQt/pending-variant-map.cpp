@@ -76,11 +76,11 @@ void PendingVariantMap::watcherFinished(QDBusPendingCallWatcher* watcher)
     QDBusPendingReply<QVariantMap> reply = *watcher;
 
     if (!reply.isError()) {
-        debug() << "Got reply to PendingVariantMap call";
+        tpDebug(logGeneral) << "Got reply to PendingVariantMap call";
         mPriv->result = reply.value();
         setFinished();
     } else {
-        debug().nospace() << "PendingVariantMap call failed: " <<
+        tpDebug(logGeneral).nospace() << "PendingVariantMap call failed: " <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
     }
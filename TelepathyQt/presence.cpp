@@ -423,7 +423,7 @@ Presence PresenceSpec::presence(const QString &statusMessage) const
     }
 
     if (!canHaveStatusMessage() && !statusMessage.isEmpty()) {
-        warning() << "Passing a status message to PresenceSpec with "
+        tpWarning(logContacts) << "Passing a status message to PresenceSpec with "
             "canHaveStatusMessage() being false";
     }
 
@@ -24,6 +24,7 @@
 
 #include "TelepathyQt/_gen/profile-manager.moc.hpp"
 #include "TelepathyQt/debug-internal.h"
+#include "TelepathyQt/parsed-file-cache-internal.h"
 
 #include <TelepathyQt/ConnectionManager>
 #include <TelepathyQt/PendingComposite>
@@ -32,10 +33,14 @@
 #include <TelepathyQt/Profile>
 #include <TelepathyQt/ReadinessHelper>
 
+#include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QSet>
 #include <QString>
 #include <QStringList>
+#include <QTimer>
 
 namespace Tp
 {
@@ -46,18 +51,67 @@ struct TP_QT_NO_EXPORT ProfileManager::Private
 
     static void introspectMain(Private *self);
     static void introspectFakeProfiles(Private *self);
+    static void introspectWatching(Private *self);
+
+    static ProfilePtr loadProfile(const QString &fileName);
+
+    struct FileStamp
+    {
+        FileStamp() : modified(0), size(0) {}
+        FileStamp(const QFileInfo &fi)
+            : modified(fi.lastModified().toMSecsSinceEpoch()),
+              size(fi.size())
+        {
+        }
+
+        bool operator==(const FileStamp &other) const
+        {
+            return modified == other.modified && size == other.size;
+        }
+
+        qint64 modified;
+        qint64 size;
+    };
+    typedef QHash<QString, FileStamp> DirectorySnapshot;
+
+    static DirectorySnapshot snapshotDirectory(const QString &dirName);
+    static QString existingParentDirectory(const QString &dirName);
+    int directoryPriority(const QString &fileName) const;
+    QStringList watchMissingDirectories();
+    void rescanDirectory(const QString &dirName);
+    void updateProfile(const QString &serviceName, const QString &fileName,
+            const ProfilePtr &profile);
+    void removeProfileFile(const QString &fileName);
+    void addProfileFile(const QString &fileName);
+    void reloadProfileFile(const QString &fileName);
 
     ProfileManager *parent;
     ReadinessHelper *readinessHelper;
     QDBusConnection bus;
     QHash<QString, ProfilePtr> profiles;
+    // absolute file names of the non fake profiles, by service name
+    QHash<QString, QString> profileFileNames;
     QList<ConnectionManagerPtr> cms;
+
+    // FeatureFakeProfiles
+    // fake profiles by service name, including the ones overridden by a real profile
+    QHash<QString, ProfilePtr> fakeProfiles;
+
+    // FeatureWatching
+    QFileSystemWatcher *watcher;
+    // absolute search dirs in priority order, and their last seen contents
+    QStringList watchedDirs;
+    QHash<QString, DirectorySnapshot> snapshots;
+    // nearest existing parents of the search dirs which do not exist
+    QSet<QString> parentDirs;
+    QSet<QString> changedDirs;
 };
 
 ProfileManager::Private::Private(ProfileManager *parent, const QDBusConnection &bus)
     : parent(parent),
       readinessHelper(parent->readinessHelper()),
-      bus(bus)
+      bus(bus),
+      watcher(0)
 {
     ReadinessHelper::Introspectables introspectables;
 
@@ -77,6 +131,14 @@ ProfileManager::Private::Private(ProfileManager *parent, const QDBusConnection &
         this);
     introspectables[FeatureFakeProfiles] = introspectableFakeProfiles;
 
+    ReadinessHelper::Introspectable introspectableWatching(
+        QSet<uint>() << 0,                                           // makesSenseForStatuses
+        Features() << FeatureCore,                                   // dependsOnFeatures
+        QStringList(),                                               // dependsOnInterfaces
+        (ReadinessHelper::IntrospectFunc) &Private::introspectWatching,
+        this);
+    introspectables[FeatureWatching] = introspectableWatching;
+
     readinessHelper->addIntrospectables(introspectables);
 }
 
@@ -84,44 +146,50 @@ void ProfileManager::Private::introspectMain(ProfileManager::Private *self)
 {
     QStringList searchDirs = Profile::searchDirs();
 
-    foreach (const QString searchDir, searchDirs) {
-        QDir dir(searchDir);
-        dir.setFilter(QDir::Files);
+    // Loading each profile below updates the cache, write it only once when done
+    ParsedFileCache *cache = ParsedFileCache::profiles();
+    cache->suspendSaving();
 
-        QFileInfoList list = dir.entryInfoList();
-        for (int i = 0; i < list.size(); ++i) {
-            QFileInfo fi = list.at(i);
+    foreach (const QString searchDir, searchDirs) {
+        // The directory listing is cached as well and only redone when the directory changed
+        QStringList fileNames;
+        if (!cache->lookupDirectory(searchDir, fileNames)) {
+            QDir dir(searchDir);
+            dir.setFilter(QDir::Files);
+            dir.setNameFilters(QStringList() << QLatin1String("*.profile"));
+
+            QFileInfoList list = dir.entryInfoList();
+            for (int i = 0; i < list.size(); ++i) {
+                const QFileInfo &fi = list.at(i);
+                if (fi.completeSuffix() == QLatin1String("profile")) {
+                    fileNames.append(fi.absoluteFilePath());
+                }
+            }
 
-            if (fi.completeSuffix() !=  QLatin1String("profile")) {
-                continue;
+            if (dir.exists()) {
+                cache->insertDirectory(searchDir, fileNames);
             }
+        }
 
-            QString fileName = fi.absoluteFilePath();
-            QString serviceName = fi.baseName();
+        foreach (const QString &fileName, fileNames) {
+            QString serviceName = QFileInfo(fileName).baseName();
 
             if (self->profiles.contains(serviceName)) {
-                debug() << "Profile for service" << serviceName << "already "
+                tpDebug(logConnections) << "Profile for service" << serviceName << "already "
                     "exists. Ignoring profile file:" << fileName;
                 continue;
             }
 
-            ProfilePtr profile = Profile::createForFileName(fileName);
-            if (!profile->isValid()) {
-                continue;
-            }
-
-            if (profile->type() != QLatin1String("IM")) {
-                debug() << "Ignoring profile for service" << serviceName <<
-                    ": type != IM. Profile file:" << fileName;
-                continue;
+            ProfilePtr profile = loadProfile(fileName);
+            if (profile) {
+                self->profiles.insert(serviceName, profile);
+                self->profileFileNames.insert(serviceName, QFileInfo(fileName).absoluteFilePath());
             }
-
-            debug() << "Found profile for service" << serviceName <<
-                "- profile file:" << fileName;
-            self->profiles.insert(serviceName, profile);
         }
     }
 
+    cache->resumeSaving();
+
     self->readinessHelper->setIntrospectCompleted(FeatureCore, true);
 }
 
@@ -133,6 +201,279 @@ void ProfileManager::Private::introspectFakeProfiles(ProfileManager::Private *se
             SLOT(onCmNamesRetrieved(Tp::PendingOperation *)));
 }
 
+void ProfileManager::Private::introspectWatching(ProfileManager::Private *self)
+{
+    self->watcher = new QFileSystemWatcher(self->parent);
+    self->parent->connect(self->watcher,
+            SIGNAL(directoryChanged(QString)),
+            SLOT(onPathChanged(QString)));
+    self->parent->connect(self->watcher,
+            SIGNAL(fileChanged(QString)),
+            SLOT(onPathChanged(QString)));
+
+    foreach (const QString &searchDir, Profile::searchDirs()) {
+        QString dirName = QDir(searchDir).absolutePath();
+        self->watchedDirs.append(dirName);
+        if (!QFileInfo(dirName).isDir()) {
+            // watched through its parent until it is created
+            continue;
+        }
+
+        DirectorySnapshot snapshot = snapshotDirectory(dirName);
+        self->snapshots.insert(dirName, snapshot);
+        self->watcher->addPath(dirName);
+        // in-place modifications of a file are only reported for the file itself
+        if (!snapshot.isEmpty()) {
+            self->watcher->addPaths(snapshot.keys());
+        }
+    }
+
+    foreach (const QString &dirName, self->watchMissingDirectories()) {
+        self->rescanDirectory(dirName);
+    }
+
+    self->readinessHelper->setIntrospectCompleted(FeatureWatching, true);
+}
+
+ProfilePtr ProfileManager::Private::loadProfile(const QString &fileName)
+{
+    QString serviceName = QFileInfo(fileName).baseName();
+
+    ProfilePtr profile = Profile::createForFileName(fileName);
+    if (!profile->isValid()) {
+        return ProfilePtr();
+    }
+
+    if (profile->type() != QLatin1String("IM")) {
+        tpDebug(logConnections) << "Ignoring profile for service" << serviceName <<
+            ": type != IM. Profile file:" << fileName;
+        return ProfilePtr();
+    }
+
+    tpDebug(logConnections) << "Found profile for service" << serviceName <<
+        "- profile file:" << fileName;
+    return profile;
+}
+
+ProfileManager::Private::DirectorySnapshot ProfileManager::Private::snapshotDirectory(
+        const QString &dirName)
+{
+    DirectorySnapshot snapshot;
+
+    QDir dir(dirName);
+    dir.setFilter(QDir::Files);
+    dir.setNameFilters(QStringList() << QLatin1String("*.profile"));
+
+    QFileInfoList list = dir.entryInfoList();
+    for (int i = 0; i < list.size(); ++i) {
+        const QFileInfo &fi = list.at(i);
+        if (fi.completeSuffix() == QLatin1String("profile")) {
+            snapshot.insert(fi.absoluteFilePath(), FileStamp(fi));
+        }
+    }
+
+    return snapshot;
+}
+
+QString ProfileManager::Private::existingParentDirectory(const QString &dirName)
+{
+    QString parentDirName = dirName;
+    do {
+        parentDirName = QFileInfo(parentDirName).absolutePath();
+    } while (!QFileInfo(parentDirName).isDir() && parentDirName != QDir::rootPath());
+    return parentDirName;
+}
+
+int ProfileManager::Private::directoryPriority(const QString &fileName) const
+{
+    int priority = watchedDirs.indexOf(QFileInfo(fileName).absolutePath());
+    return priority >= 0 ? priority : watchedDirs.size();
+}
+
+/*
+ * Watch the nearest existing parent of each search dir which does not exist, to notice when
+ * it is created, e.g. ~/.local/share/telepathy/profiles when the first local profile is
+ * installed. Search dirs which were removed are watched through their parent again.
+ *
+ * Return the search dirs which appeared since the last call. They are watched from now on,
+ * with an empty snapshot, so rescanning them adds all the profiles they contain.
+ */
+QStringList ProfileManager::Private::watchMissingDirectories()
+{
+    QStringList appearedDirs;
+    QSet<QString> newParentDirs;
+    foreach (const QString &dirName, watchedDirs) {
+        bool exists = QFileInfo(dirName).isDir();
+        if (snapshots.contains(dirName)) {
+            if (exists) {
+                continue;
+            }
+            // Drop its profiles, if that was not done yet. The watcher stops watching removed
+            // paths by itself
+            tpDebug(logConnections) << "Profile search directory" << dirName << "removed";
+            rescanDirectory(dirName);
+            snapshots.remove(dirName);
+        } else if (exists) {
+            tpDebug(logConnections) << "Profile search directory" << dirName << "created";
+            snapshots.insert(dirName, DirectorySnapshot());
+            watcher->addPath(dirName);
+            appearedDirs.append(dirName);
+            continue;
+        }
+
+        newParentDirs.insert(existingParentDirectory(dirName));
+    }
+
+    foreach (const QString &dirName, parentDirs) {
+        if (!newParentDirs.contains(dirName) && !snapshots.contains(dirName)) {
+            watcher->removePath(dirName);
+        }
+    }
+
+    QStringList watchedParentDirs = watcher->directories();
+    foreach (const QString &dirName, newParentDirs) {
+        if (!watchedParentDirs.contains(dirName)) {
+            watcher->addPath(dirName);
+        }
+    }
+    parentDirs = newParentDirs;
+
+    return appearedDirs;
+}
+
+/*
+ * Compare the contents of dirName with the last snapshot taken and only reload the profile
+ * files that were added, removed or modified since then.
+ */
+void ProfileManager::Private::rescanDirectory(const QString &dirName)
+{
+    DirectorySnapshot oldSnapshot = snapshots.value(dirName);
+    DirectorySnapshot newSnapshot = snapshotDirectory(dirName);
+    snapshots.insert(dirName, newSnapshot);
+
+    QStringList addedFiles;
+    DirectorySnapshot::const_iterator i = newSnapshot.constBegin();
+    while (i != newSnapshot.constEnd()) {
+        DirectorySnapshot::const_iterator old = oldSnapshot.constFind(i.key());
+        if (old == oldSnapshot.constEnd()) {
+            addedFiles.append(i.key());
+        } else if (!(old.value() == i.value())) {
+            tpDebug(logConnections) << "Profile file" << i.key() << "changed";
+            reloadProfileFile(i.key());
+        }
+        ++i;
+    }
+
+    i = oldSnapshot.constBegin();
+    while (i != oldSnapshot.constEnd()) {
+        if (!newSnapshot.contains(i.key())) {
+            tpDebug(logConnections) << "Profile file" << i.key() << "removed";
+            removeProfileFile(i.key());
+        }
+        ++i;
+    }
+
+    foreach (const QString &fileName, addedFiles) {
+        tpDebug(logConnections) << "Profile file" << fileName << "added";
+        addProfileFile(fileName);
+    }
+
+    // Files replaced by rename are no longer watched
+    QStringList watchedFiles = watcher->files();
+    foreach (const QString &fileName, newSnapshot.keys()) {
+        if (!watchedFiles.contains(fileName)) {
+            watcher->addPath(fileName);
+        }
+    }
+}
+
+/*
+ * Set the profile for serviceName, loaded from fileName or fake if fileName is empty, or
+ * remove it if profile is null, and emit the matching signal.
+ */
+void ProfileManager::Private::updateProfile(const QString &serviceName,
+        const QString &fileName, const ProfilePtr &profile)
+{
+    ProfilePtr oldProfile = profiles.value(serviceName);
+    if (profile) {
+        profiles.insert(serviceName, profile);
+        if (fileName.isEmpty()) {
+            profileFileNames.remove(serviceName);
+        } else {
+            profileFileNames.insert(serviceName, fileName);
+        }
+        if (oldProfile) {
+            emit parent->profileChanged(profile);
+        } else {
+            emit parent->profileAdded(profile);
+        }
+    } else if (oldProfile) {
+        profiles.remove(serviceName);
+        profileFileNames.remove(serviceName);
+        emit parent->profileRemoved(oldProfile);
+    }
+}
+
+void ProfileManager::Private::removeProfileFile(const QString &fileName)
+{
+    QString serviceName = QFileInfo(fileName).baseName();
+    if (profileFileNames.value(serviceName) != fileName) {
+        return;
+    }
+
+    // A file for the same service in a lower priority search dir takes over
+    for (int i = directoryPriority(fileName) + 1; i < watchedDirs.size(); ++i) {
+        QString otherFileName = QString(QLatin1String("%1/%2.profile"))
+            .arg(watchedDirs.at(i)).arg(serviceName);
+        if (!QFile::exists(otherFileName)) {
+            continue;
+        }
+
+        ProfilePtr replacement = loadProfile(otherFileName);
+        if (replacement) {
+            updateProfile(serviceName, otherFileName, replacement);
+            return;
+        }
+    }
+
+    // The fake profile the file replaced, if any, is used again
+    updateProfile(serviceName, QString(), fakeProfiles.value(serviceName));
+}
+
+void ProfileManager::Private::addProfileFile(const QString &fileName)
+{
+    QString serviceName = QFileInfo(fileName).baseName();
+    if (profileFileNames.contains(serviceName) &&
+        directoryPriority(profileFileNames.value(serviceName)) <= directoryPriority(fileName)) {
+        tpDebug(logConnections) << "Profile for service" << serviceName << "already "
+            "exists. Ignoring profile file:" << fileName;
+        return;
+    }
+
+    // Replaces fake profiles too
+    ProfilePtr profile = loadProfile(fileName);
+    if (profile) {
+        updateProfile(serviceName, fileName, profile);
+    }
+}
+
+void ProfileManager::Private::reloadProfileFile(const QString &fileName)
+{
+    QString serviceName = QFileInfo(fileName).baseName();
+    if (profileFileNames.value(serviceName) != fileName) {
+        // the file was not in use, it may have been invalid before
+        addProfileFile(fileName);
+        return;
+    }
+
+    ProfilePtr profile = loadProfile(fileName);
+    if (profile) {
+        updateProfile(serviceName, fileName, profile);
+    } else {
+        removeProfileFile(fileName);
+    }
+}
+
 /**
  * \class ProfileManager
  * \headerfile TelepathyQt/profile-manager.h <TelepathyQt/ProfileManager>
@@ -178,6 +519,20 @@ const Feature ProfileManager::FeatureCore = Feature(QLatin1String(ProfileManager
  */
 const Feature ProfileManager::FeatureFakeProfiles = Feature(QLatin1String(ProfileManager::staticMetaObject.className()), 1);
 
+/**
+ * Enabling this feature will make ProfileManager watch the profile search directories and
+ * keep profiles() up to date as .profile files are added, removed or modified.
+ *
+ * Only the files that changed are parsed again. The profileAdded(), profileRemoved() and
+ * profileChanged() signals are emitted accordingly, so long-running processes do not need
+ * to recreate the ProfileManager to pick up new profiles.
+ *
+ * Search directories that do not exist yet, such as the user's local profiles directory, are
+ * watched through their nearest existing parent directory, and their profiles are added once
+ * they are created.
+ */
+const Feature ProfileManager::FeatureWatching = Feature(QLatin1String(ProfileManager::staticMetaObject.className()), 2);
+
 /**
  * Create a new ProfileManager object.
  */
@@ -260,10 +615,41 @@ ProfilePtr ProfileManager::profileForService(const QString &serviceName) const
     return mPriv->profiles.value(serviceName);
 }
 
+/**
+ * \fn void ProfileManager::profileAdded(const Tp::ProfilePtr &profile)
+ *
+ * Emitted when a .profile file for a new service is found, if
+ * FeatureWatching is ready.
+ *
+ * \param profile The new profile.
+ */
+
+/**
+ * \fn void ProfileManager::profileRemoved(const Tp::ProfilePtr &profile)
+ *
+ * Emitted when the .profile file for a service is removed or became invalid,
+ * if FeatureWatching is ready.
+ *
+ * \param profile The removed profile.
+ */
+
+/**
+ * \fn void ProfileManager::profileChanged(const Tp::ProfilePtr &profile)
+ *
+ * Emitted when the profile for an existing service is replaced, if
+ * FeatureWatching is ready. This happens when the .profile file for the
+ * service is modified, when a file in a search directory with higher
+ * priority overrides it, when a real profile replaces a fake one, or when the
+ * fake profile is used again because the real one was removed.
+ *
+ * \param profile The new profile, replacing the previous one for the same
+ *                service name.
+ */
+
 void ProfileManager::onCmNamesRetrieved(Tp::PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "Getting available CMs failed with " <<
+        tpWarning(logConnections).nospace() << "Getting available CMs failed with " <<
             op->errorName() << ":" << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureFakeProfiles, false,
                 op->errorName(), op->errorMessage());
@@ -293,7 +679,8 @@ void ProfileManager::onCmNamesRetrieved(Tp::PendingOperation *op)
 void ProfileManager::onCMsReady(Tp::PendingOperation *op)
 {
     if (op->isError()) {
-        warning() << "Failed introspecting all CMs, trying to create fake profiles anyway";
+        tpWarning(logConnections) <<
+            "Failed introspecting all CMs, trying to create fake profiles anyway";
     }
 
     ProfilePtr profile;
@@ -312,21 +699,61 @@ void ProfileManager::onCMsReady(Tp::PendingOperation *op)
             }
 
             QString serviceName = QString(QLatin1String("%1-%2")).arg(cm->name()).arg(protocolName);
-            profile = profileForService(serviceName);
-            if (profile) {
+            if (mPriv->fakeProfiles.contains(serviceName)) {
                 continue;
             }
 
+            // Kept even if a real profile exists for serviceName, in case its file is removed
             profile = ProfilePtr(new Profile(
                         serviceName,
                         cm->name(),
                         protocolName,
                         cm->protocol(protocolName)));
-            mPriv->profiles.insert(serviceName, profile);
+            mPriv->fakeProfiles.insert(serviceName, profile);
+            if (!mPriv->profiles.contains(serviceName)) {
+                mPriv->profiles.insert(serviceName, profile);
+            }
         }
     }
 
     mPriv->readinessHelper->setIntrospectCompleted(FeatureFakeProfiles, true);
 }
 
+void ProfileManager::onPathChanged(const QString &path)
+{
+    // Either a search dir, the parent of a missing one or a profile file
+    QString dirName = path;
+    if (!mPriv->snapshots.contains(dirName) && !mPriv->parentDirs.contains(dirName)) {
+        dirName = QFileInfo(path).absolutePath();
+        if (!mPriv->snapshots.contains(dirName)) {
+            return;
+        }
+    }
+
+    // Editors and package managers touch several files at once, coalesce all the
+    // notifications received in this mainloop iteration
+    if (mPriv->changedDirs.isEmpty()) {
+        QTimer::singleShot(0, this, SLOT(processChangedDirectories()));
+    }
+    mPriv->changedDirs.insert(dirName);
+}
+
+void ProfileManager::processChangedDirectories()
+{
+    QSet<QString> changedDirs = mPriv->changedDirs;
+    mPriv->changedDirs.clear();
+
+    // Rescan in priority order, so that lookups for replacements see up to date snapshots
+    foreach (const QString &dirName, mPriv->watchedDirs) {
+        if (changedDirs.contains(dirName)) {
+            mPriv->rescanDirectory(dirName);
+        }
+    }
+
+    // Search dirs may have been created under a watched parent, or removed
+    foreach (const QString &dirName, mPriv->watchMissingDirectories()) {
+        mPriv->rescanDirectory(dirName);
+    }
+}
+
 } // Tp
@@ -48,6 +48,7 @@ class TP_QT_EXPORT ProfileManager : public Object, public ReadyObject
 public:
     static const Feature FeatureCore;
     static const Feature FeatureFakeProfiles;
+    static const Feature FeatureWatching;
 
     static ProfileManagerPtr create(const QDBusConnection &bus = QDBusConnection::sessionBus());
 
@@ -58,9 +59,16 @@ public:
     QList<ProfilePtr> profilesForProtocol(const QString &protocolName) const;
     ProfilePtr profileForService(const QString &serviceName) const;
 
+Q_SIGNALS:
+    void profileAdded(const Tp::ProfilePtr &profile);
+    void profileRemoved(const Tp::ProfilePtr &profile);
+    void profileChanged(const Tp::ProfilePtr &profile);
+
 private Q_SLOTS:
     TP_QT_NO_EXPORT void onCmNamesRetrieved(Tp::PendingOperation *op);
     TP_QT_NO_EXPORT void onCMsReady(Tp::PendingOperation *op);
+    TP_QT_NO_EXPORT void onPathChanged(const QString &path);
+    TP_QT_NO_EXPORT void processChangedDirectories();
 
 private:
     ProfileManager(const QDBusConnection &bus);
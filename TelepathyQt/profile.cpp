@@ -24,18 +24,18 @@
 
 #include "TelepathyQt/debug-internal.h"
 #include "TelepathyQt/manager-file.h"
+#include "TelepathyQt/parsed-file-cache-internal.h"
 
 #include <TelepathyQt/ProtocolInfo>
 #include <TelepathyQt/ProtocolParameter>
 #include <TelepathyQt/Utils>
 
+#include <QDataStream>
+#include <QDateTime>
 #include <QFile>
 #include <QFileInfo>
 #include <QStringList>
-#include <QXmlAttributes>
-#include <QXmlDefaultHandler>
-#include <QXmlInputSource>
-#include <QXmlSimpleReader>
+#include <QXmlStreamReader>
 
 namespace Tp
 {
@@ -49,8 +49,13 @@ struct TP_QT_NO_EXPORT Profile::Private
 
     void lookupProfile();
     bool parse(QFile *file);
+    void rememberFileState();
+    void loadSections();
     void invalidate();
 
+    bool loadFromCache(const QString &fileName);
+    void saveToCache(const QString &fileName) const;
+
     struct Data
     {
         Data();
@@ -69,12 +74,21 @@ struct TP_QT_NO_EXPORT Profile::Private
         RequestableChannelClassSpecList unsupportedChannelClassSpecs;
     };
 
-    class XmlHandler;
+    class XmlReader;
 
     QString serviceName;
+    QString fileName;
+    // state of the file when the header was read, to notice it changing before the sections
+    // are read
+    qint64 fileSize;
+    QDateTime fileModified;
     bool valid;
     bool fake;
     bool allowNonIMType;
+    // whether the parameters, presences and unsupported channel classes were read
+    bool sectionsLoaded;
+    // whether reading them failed, in which case they are reported as empty
+    bool sectionsMalformed;
     Data data;
 };
 
@@ -97,35 +111,36 @@ void Profile::Private::Data::clear()
 }
 
 
-class TP_QT_NO_EXPORT Profile::Private::XmlHandler :
-                public QXmlDefaultHandler
+class TP_QT_NO_EXPORT Profile::Private::XmlReader
 {
 public:
-    XmlHandler(const QString &serviceName, bool allowNonIMType, Profile::Private::Data *outputData);
-
-    bool startElement(const QString &namespaceURI, const QString &localName,
-            const QString &qName, const QXmlAttributes &attributes);
-    bool endElement(const QString &namespaceURI, const QString &localName,
-            const QString &qName);
-    bool characters(const QString &str);
-    bool fatalError(const QXmlParseException &exception);
+    XmlReader(QIODevice *device, const QString &serviceName, bool allowNonIMType,
+            Profile::Private::Data *outputData);
+
+    bool readHeader();
+    bool readSections();
     QString errorString() const;
 
 private:
-    bool attributeValueAsBoolean(const QXmlAttributes &attributes,
-            const QString &qName);
-
+    bool readService(bool sections);
+    bool readParameters();
+    bool readParameter();
+    bool readPresences();
+    bool readUnsupportedChannelClasses();
+    bool readChannelClass();
+
+    bool nextChildElement();
+    bool unexpectedElement(const QString &parentElement);
+    bool checkAttributes(const QStringList &allowedAttrs,
+            const QStringList &mandatoryAttrs = QStringList());
+    bool attributeValueAsBoolean(const QString &name) const;
+    bool setError(const QString &errorString);
+
+    QXmlStreamReader mReader;
     QString mServiceName;
     bool allowNonIMType;
     Profile::Private::Data *mData;
-    QStack<QString> mElements;
-    QString mCurrentText;
-    Profile::Parameter mCurrentParameter;
-    RequestableChannelClass mCurrentCC;
-    QString mCurrentPropertyName;
-    QString mCurrentPropertyType;
     QString mErrorString;
-    bool mMetServiceTag;
 
     static const QString xmlNs;
 
@@ -153,257 +168,327 @@ private:
     static const QString elemAttrDisabled;
 };
 
-const QString Profile::Private::XmlHandler::xmlNs = QLatin1String("http://telepathy.freedesktop.org/wiki/service-profile-v1");
-
-const QString Profile::Private::XmlHandler::elemService = QLatin1String("service");
-const QString Profile::Private::XmlHandler::elemName = QLatin1String("name");
-const QString Profile::Private::XmlHandler::elemParams = QLatin1String("parameters");
-const QString Profile::Private::XmlHandler::elemParam = QLatin1String("parameter");
-const QString Profile::Private::XmlHandler::elemPresences = QLatin1String("presences");
-const QString Profile::Private::XmlHandler::elemPresence = QLatin1String("presence");
-const QString Profile::Private::XmlHandler::elemUnsupportedCCs = QLatin1String("unsupported-channel-classes");
-const QString Profile::Private::XmlHandler::elemCC = QLatin1String("channel-class");
-const QString Profile::Private::XmlHandler::elemProperty = QLatin1String("property");
-
-const QString Profile::Private::XmlHandler::elemAttrId = QLatin1String("id");
-const QString Profile::Private::XmlHandler::elemAttrName = QLatin1String("name");
-const QString Profile::Private::XmlHandler::elemAttrType = QLatin1String("type");
-const QString Profile::Private::XmlHandler::elemAttrProvider = QLatin1String("provider");
-const QString Profile::Private::XmlHandler::elemAttrManager = QLatin1String("manager");
-const QString Profile::Private::XmlHandler::elemAttrProtocol = QLatin1String("protocol");
-const QString Profile::Private::XmlHandler::elemAttrLabel = QLatin1String("label");
-const QString Profile::Private::XmlHandler::elemAttrMandatory = QLatin1String("mandatory");
-const QString Profile::Private::XmlHandler::elemAttrAllowOthers = QLatin1String("allow-others");
-const QString Profile::Private::XmlHandler::elemAttrIcon = QLatin1String("icon");
-const QString Profile::Private::XmlHandler::elemAttrMessage = QLatin1String("message");
-const QString Profile::Private::XmlHandler::elemAttrDisabled = QLatin1String("disabled");
-
-Profile::Private::XmlHandler::XmlHandler(const QString &serviceName,
+const QString Profile::Private::XmlReader::xmlNs = QLatin1String("http://telepathy.freedesktop.org/wiki/service-profile-v1");
+
+const QString Profile::Private::XmlReader::elemService = QLatin1String("service");
+const QString Profile::Private::XmlReader::elemName = QLatin1String("name");
+const QString Profile::Private::XmlReader::elemParams = QLatin1String("parameters");
+const QString Profile::Private::XmlReader::elemParam = QLatin1String("parameter");
+const QString Profile::Private::XmlReader::elemPresences = QLatin1String("presences");
+const QString Profile::Private::XmlReader::elemPresence = QLatin1String("presence");
+const QString Profile::Private::XmlReader::elemUnsupportedCCs = QLatin1String("unsupported-channel-classes");
+const QString Profile::Private::XmlReader::elemCC = QLatin1String("channel-class");
+const QString Profile::Private::XmlReader::elemProperty = QLatin1String("property");
+
+const QString Profile::Private::XmlReader::elemAttrId = QLatin1String("id");
+const QString Profile::Private::XmlReader::elemAttrName = QLatin1String("name");
+const QString Profile::Private::XmlReader::elemAttrType = QLatin1String("type");
+const QString Profile::Private::XmlReader::elemAttrProvider = QLatin1String("provider");
+const QString Profile::Private::XmlReader::elemAttrManager = QLatin1String("manager");
+const QString Profile::Private::XmlReader::elemAttrProtocol = QLatin1String("protocol");
+const QString Profile::Private::XmlReader::elemAttrLabel = QLatin1String("label");
+const QString Profile::Private::XmlReader::elemAttrMandatory = QLatin1String("mandatory");
+const QString Profile::Private::XmlReader::elemAttrAllowOthers = QLatin1String("allow-others");
+const QString Profile::Private::XmlReader::elemAttrIcon = QLatin1String("icon");
+const QString Profile::Private::XmlReader::elemAttrMessage = QLatin1String("message");
+const QString Profile::Private::XmlReader::elemAttrDisabled = QLatin1String("disabled");
+
+Profile::Private::XmlReader::XmlReader(QIODevice *device,
+        const QString &serviceName,
         bool allowNonIMType,
         Profile::Private::Data *outputData)
-    : mServiceName(serviceName),
+    : mReader(device),
+      mServiceName(serviceName),
       allowNonIMType(allowNonIMType),
-      mData(outputData),
-      mMetServiceTag(false)
+      mData(outputData)
 {
 }
 
-bool Profile::Private::XmlHandler::startElement(const QString &namespaceURI,
-        const QString &localName, const QString &qName,
-        const QXmlAttributes &attributes)
+/*
+ * Read only the service metadata (the <service> attributes and <name>), stopping at the
+ * first section once they are known.
+ */
+bool Profile::Private::XmlReader::readHeader()
 {
-    if (!mMetServiceTag && qName != elemService) {
-        mErrorString = QLatin1String("the file is not a profile file");
-        return false;
+    return readService(false);
+}
+
+/*
+ * Read the whole file, including the parameters, presences and unsupported channel
+ * classes sections.
+ */
+bool Profile::Private::XmlReader::readSections()
+{
+    return readService(true);
+}
+
+QString Profile::Private::XmlReader::errorString() const
+{
+    return mErrorString;
+}
+
+bool Profile::Private::XmlReader::readService(bool sections)
+{
+    if (!mReader.readNextStartElement() || mReader.name() != elemService ||
+        mReader.namespaceUri() != xmlNs) {
+        if (mReader.hasError()) {
+            return setError(mReader.errorString());
+        }
+        return setError(QLatin1String("the file is not a profile file"));
     }
 
-    if (namespaceURI != xmlNs) {
-        // ignore all elements with unknown xmlns
-        debug() << "Ignoring unknown xmlns" << namespaceURI;
-        return true;
+    if (!checkAttributes(QStringList() << elemAttrId << elemAttrType << elemAttrManager <<
+                elemAttrProtocol << elemAttrProvider << elemAttrIcon,
+            QStringList() << elemAttrId << elemAttrType << elemAttrManager <<
+                elemAttrProtocol)) {
+        return false;
     }
 
-#define CHECK_ELEMENT_IS_CHILD_OF(parentElement) \
-    if (mElements.top() != parentElement) { \
-        mErrorString = QString(QLatin1String("element '%1' is not a " \
-                    "child of element '%2'")) \
-            .arg(qName) \
-            .arg(parentElement); \
-        return false; \
+    QXmlStreamAttributes attributes = mReader.attributes();
+    if (attributes.value(elemAttrId) != mServiceName) {
+        return setError(QString(QLatin1String("the '%1' attribute of the "
+                        "element '%2' does not match the file name"))
+                .arg(elemAttrId)
+                .arg(elemService));
     }
-#define CHECK_ELEMENT_ATTRIBUTES_COUNT(value) \
-    if (attributes.count() != value) { \
-        mErrorString = QString(QLatin1String("element '%1' contains more " \
-                    "than %2 attributes")) \
-            .arg(qName) \
-            .arg(value); \
-        return false; \
+
+    mData->type = attributes.value(elemAttrType).toString();
+    if (mData->type != QLatin1String("IM") && !allowNonIMType) {
+        return setError(QString(QLatin1String("unknown value of element "
+                        "'type': %1"))
+                .arg(mData->type));
     }
-#define CHECK_ELEMENT_HAS_ATTRIBUTE(attribute) \
-    if (attributes.index(attribute) == -1) { \
-        mErrorString = QString(QLatin1String("mandatory attribute '%1' " \
-                    "missing on element '%2'")) \
-            .arg(attribute) \
-            .arg(qName); \
-        return false; \
+    mData->provider = attributes.value(elemAttrProvider).toString();
+    mData->cmName = attributes.value(elemAttrManager).toString();
+    mData->protocolName = attributes.value(elemAttrProtocol).toString();
+    mData->iconName = attributes.value(elemAttrIcon).toString();
+
+    bool metName = false;
+    while (nextChildElement()) {
+        if (mReader.name() == elemName) {
+            if (!checkAttributes(QStringList())) {
+                return false;
+            }
+            mData->name = mReader.readElementText();
+            metName = true;
+        } else if (mReader.name() == elemParams || mReader.name() == elemPresences ||
+                   mReader.name() == elemUnsupportedCCs) {
+            if (!sections) {
+                if (metName) {
+                    // all the metadata is known, the sections are read on demand
+                    return true;
+                }
+                mReader.skipCurrentElement();
+            } else if (mReader.name() == elemParams) {
+                if (!readParameters()) {
+                    return false;
+                }
+            } else if (mReader.name() == elemPresences) {
+                if (!readPresences()) {
+                    return false;
+                }
+            } else if (!readUnsupportedChannelClasses()) {
+                return false;
+            }
+        } else if (!unexpectedElement(elemService)) {
+            return false;
+        }
     }
-#define CHECK_ELEMENT_ATTRIBUTES(allowedAttrs) \
-    for (int i = 0; i < attributes.count(); ++i) { \
-        bool valid = false; \
-        QString attrName = attributes.qName(i); \
-        foreach (const QString &allowedAttr, allowedAttrs) { \
-            if (attrName == allowedAttr) { \
-                valid = true; \
-                break; \
-            } \
-        } \
-        if (!valid) { \
-            mErrorString = QString(QLatin1String("invalid attribute '%1' on " \
-                        "element '%2'")) \
-                .arg(attrName) \
-                .arg(qName); \
-            return false; \
-        } \
+
+    if (mReader.hasError()) {
+        return setError(QString(QLatin1String("parse error at line %1, column %2: %3"))
+                .arg(mReader.lineNumber())
+                .arg(mReader.columnNumber())
+                .arg(mReader.errorString()));
     }
 
-    if (qName == elemService) {
-        CHECK_ELEMENT_HAS_ATTRIBUTE(elemAttrId);
-        CHECK_ELEMENT_HAS_ATTRIBUTE(elemAttrType);
-        CHECK_ELEMENT_HAS_ATTRIBUTE(elemAttrManager);
-        CHECK_ELEMENT_HAS_ATTRIBUTE(elemAttrProtocol);
+    return true;
+}
 
-        QStringList allowedAttrs = QStringList() <<
-            elemAttrId << elemAttrType << elemAttrManager <<
-            elemAttrProtocol << elemAttrProvider << elemAttrIcon;
-        CHECK_ELEMENT_ATTRIBUTES(allowedAttrs);
+bool Profile::Private::XmlReader::readParameters()
+{
+    if (!checkAttributes(QStringList())) {
+        return false;
+    }
 
-        if (attributes.value(elemAttrId) != mServiceName) {
-            mErrorString = QString(QLatin1String("the '%1' attribute of the "
-                        "element '%2' does not match the file name"))
-                .arg(elemAttrId)
-                .arg(elemService);
+    while (nextChildElement()) {
+        if (mReader.name() == elemParam) {
+            if (!readParameter()) {
+                return false;
+            }
+        } else if (!unexpectedElement(elemParams)) {
             return false;
         }
+    }
+    return true;
+}
 
-        mMetServiceTag = true;
-        mData->type = attributes.value(elemAttrType);
-        if (mData->type != QLatin1String("IM") && !allowNonIMType) {
-            mErrorString = QString(QLatin1String("unknown value of element "
-                        "'type': %1"))
-                .arg(mCurrentText);
-            return false;
-        }
-        mData->provider = attributes.value(elemAttrProvider);
-        mData->cmName = attributes.value(elemAttrManager);
-        mData->protocolName = attributes.value(elemAttrProtocol);
-        mData->iconName = attributes.value(elemAttrIcon);
-    } else if (qName == elemParams) {
-        CHECK_ELEMENT_IS_CHILD_OF(elemService);
-        CHECK_ELEMENT_ATTRIBUTES_COUNT(0);
-    } else if (qName == elemParam) {
-        CHECK_ELEMENT_IS_CHILD_OF(elemParams);
-        CHECK_ELEMENT_HAS_ATTRIBUTE(elemAttrName);
-        QStringList allowedAttrs = QStringList() << elemAttrName <<
-            elemAttrType << elemAttrMandatory << elemAttrLabel;
-        CHECK_ELEMENT_ATTRIBUTES(allowedAttrs);
-
-        QString paramType = attributes.value(elemAttrType);
-        if (paramType.isEmpty()) {
-            paramType = QLatin1String("s");
-        }
-        mCurrentParameter.setName(attributes.value(elemAttrName));
-        mCurrentParameter.setDBusSignature(QDBusSignature(paramType));
-        mCurrentParameter.setLabel(attributes.value(elemAttrLabel));
-        mCurrentParameter.setMandatory(attributeValueAsBoolean(attributes,
-                    elemAttrMandatory));
-    } else if (qName == elemPresences) {
-        CHECK_ELEMENT_IS_CHILD_OF(elemService);
-        QStringList allowedAttrs = QStringList() << elemAttrAllowOthers;
-        CHECK_ELEMENT_ATTRIBUTES(allowedAttrs);
-
-        mData->allowOtherPresences = attributeValueAsBoolean(attributes,
-                elemAttrAllowOthers);
-    } else if (qName == elemPresence) {
-        CHECK_ELEMENT_IS_CHILD_OF(elemPresences);
-        CHECK_ELEMENT_HAS_ATTRIBUTE(elemAttrId);
-        QStringList allowedAttrs = QStringList() << elemAttrId <<
-            elemAttrLabel << elemAttrIcon << elemAttrMessage <<
-            elemAttrDisabled;
-        CHECK_ELEMENT_ATTRIBUTES(allowedAttrs);
-
-        mData->presences.append(Profile::Presence(
-                    attributes.value(elemAttrId),
-                    attributes.value(elemAttrLabel),
-                    attributes.value(elemAttrIcon),
-                    attributes.value(elemAttrMessage),
-                    attributeValueAsBoolean(attributes, elemAttrDisabled)));
-    } else if (qName == elemUnsupportedCCs) {
-        CHECK_ELEMENT_IS_CHILD_OF(elemService);
-        CHECK_ELEMENT_ATTRIBUTES_COUNT(0);
-    } else if (qName == elemCC) {
-        CHECK_ELEMENT_IS_CHILD_OF(elemUnsupportedCCs);
-        CHECK_ELEMENT_ATTRIBUTES_COUNT(0);
-    } else if (qName == elemProperty) {
-        CHECK_ELEMENT_IS_CHILD_OF(elemCC);
-        CHECK_ELEMENT_ATTRIBUTES_COUNT(2);
-        CHECK_ELEMENT_HAS_ATTRIBUTE(elemAttrName);
-        CHECK_ELEMENT_HAS_ATTRIBUTE(elemAttrType);
-
-        mCurrentPropertyName = attributes.value(elemAttrName);
-        mCurrentPropertyType = attributes.value(elemAttrType);
-    } else {
-        if (qName != elemName) {
-            Tp::warning() << "Ignoring unknown element" << qName;
-        } else {
-            // check if we are inside <service>
-            CHECK_ELEMENT_IS_CHILD_OF(elemService);
-            // no element here supports attributes
-            CHECK_ELEMENT_ATTRIBUTES_COUNT(0);
-        }
+bool Profile::Private::XmlReader::readParameter()
+{
+    if (!checkAttributes(QStringList() << elemAttrName << elemAttrType <<
+                elemAttrMandatory << elemAttrLabel,
+            QStringList() << elemAttrName)) {
+        return false;
     }
 
-#undef CHECK_ELEMENT_IS_CHILD_OF
-#undef CHECK_ELEMENT_ATTRIBUTES_COUNT
-#undef CHECK_ELEMENT_HAS_ATTRIBUTE
-#undef CHECK_ELEMENT_ATTRIBUTES
+    QXmlStreamAttributes attributes = mReader.attributes();
+    QString paramType = attributes.value(elemAttrType).toString();
+    if (paramType.isEmpty()) {
+        paramType = QLatin1String("s");
+    }
 
-    mElements.push(qName);
-    mCurrentText.clear();
+    QString name = attributes.value(elemAttrName).toString();
+    QString label = attributes.value(elemAttrLabel).toString();
+    bool mandatory = attributeValueAsBoolean(elemAttrMandatory);
+    QVariant value = parseValueWithDBusSignature(mReader.readElementText(), paramType);
+    mData->parameters.append(Profile::Parameter(name, QDBusSignature(paramType),
+                value, label, mandatory));
     return true;
 }
 
-bool Profile::Private::XmlHandler::endElement(const QString &namespaceURI,
-        const QString &localName, const QString &qName)
+bool Profile::Private::XmlReader::readPresences()
 {
-    if (namespaceURI != xmlNs) {
-        // ignore all elements with unknown xmlns
-        debug() << "Ignoring unknown xmlns" << namespaceURI;
-        return true;
-    } else if (qName == elemName) {
-        mData->name = mCurrentText;
-    } else if (qName == elemParam) {
-        mCurrentParameter.setValue(parseValueWithDBusSignature(mCurrentText,
-                    mCurrentParameter.dbusSignature().signature()));
-        mData->parameters.append(Profile::Parameter(mCurrentParameter));
-    } else if (qName == elemCC) {
-        mData->unsupportedChannelClassSpecs.append(RequestableChannelClassSpec(mCurrentCC));
-        mCurrentCC.fixedProperties.clear();
-    } else if (qName == elemProperty) {
-        mCurrentCC.fixedProperties[mCurrentPropertyName] =
-            parseValueWithDBusSignature(mCurrentText,
-                    mCurrentPropertyType);
+    if (!checkAttributes(QStringList() << elemAttrAllowOthers)) {
+        return false;
+    }
+
+    mData->allowOtherPresences = attributeValueAsBoolean(elemAttrAllowOthers);
+
+    while (nextChildElement()) {
+        if (mReader.name() == elemPresence) {
+            if (!checkAttributes(QStringList() << elemAttrId << elemAttrLabel <<
+                        elemAttrIcon << elemAttrMessage << elemAttrDisabled,
+                    QStringList() << elemAttrId)) {
+                return false;
+            }
+
+            QXmlStreamAttributes attributes = mReader.attributes();
+            mData->presences.append(Profile::Presence(
+                        attributes.value(elemAttrId).toString(),
+                        attributes.value(elemAttrLabel).toString(),
+                        attributes.value(elemAttrIcon).toString(),
+                        attributes.value(elemAttrMessage).toString(),
+                        attributeValueAsBoolean(elemAttrDisabled)));
+            mReader.skipCurrentElement();
+        } else if (!unexpectedElement(elemPresences)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Profile::Private::XmlReader::readUnsupportedChannelClasses()
+{
+    if (!checkAttributes(QStringList())) {
+        return false;
     }
 
-    mElements.pop();
+    while (nextChildElement()) {
+        if (mReader.name() == elemCC) {
+            if (!readChannelClass()) {
+                return false;
+            }
+        } else if (!unexpectedElement(elemUnsupportedCCs)) {
+            return false;
+        }
+    }
     return true;
 }
 
-bool Profile::Private::XmlHandler::characters(const QString &str)
+bool Profile::Private::XmlReader::readChannelClass()
 {
-    mCurrentText += str;
+    if (!checkAttributes(QStringList())) {
+        return false;
+    }
+
+    RequestableChannelClass cc;
+    while (nextChildElement()) {
+        if (mReader.name() == elemProperty) {
+            QStringList attrs = QStringList() << elemAttrName << elemAttrType;
+            if (!checkAttributes(attrs, attrs)) {
+                return false;
+            }
+
+            QXmlStreamAttributes attributes = mReader.attributes();
+            QString propertyName = attributes.value(elemAttrName).toString();
+            QString propertyType = attributes.value(elemAttrType).toString();
+            cc.fixedProperties[propertyName] =
+                parseValueWithDBusSignature(mReader.readElementText(), propertyType);
+        } else if (!unexpectedElement(elemCC)) {
+            return false;
+        }
+    }
+
+    mData->unsupportedChannelClassSpecs.append(RequestableChannelClassSpec(cc));
     return true;
 }
 
-bool Profile::Private::XmlHandler::fatalError(
-        const QXmlParseException &exception)
+/*
+ * Advance to the next child element of the current element, skipping elements with an
+ * unknown xmlns. Return false when the current element ends or on error.
+ */
+bool Profile::Private::XmlReader::nextChildElement()
 {
-    mErrorString = QString(QLatin1String("parse error at line %1, column %2: "
-                "%3"))
-        .arg(exception.lineNumber())
-        .arg(exception.columnNumber())
-        .arg(exception.message());
+    while (mReader.readNextStartElement()) {
+        if (mReader.namespaceUri() == xmlNs) {
+            return true;
+        }
+
+        // ignore all elements with unknown xmlns
+        tpDebug(logConnections) << "Ignoring unknown xmlns" << mReader.namespaceUri().toString();
+        mReader.skipCurrentElement();
+    }
     return false;
 }
 
-QString Profile::Private::XmlHandler::errorString() const
+bool Profile::Private::XmlReader::unexpectedElement(const QString &parentElement)
 {
-    return mErrorString;
+    QString qName = mReader.qualifiedName().toString();
+    if (qName == elemService || qName == elemName || qName == elemParams ||
+        qName == elemParam || qName == elemPresences || qName == elemPresence ||
+        qName == elemUnsupportedCCs || qName == elemCC || qName == elemProperty) {
+        return setError(QString(QLatin1String("element '%1' is not a "
+                        "child of element '%2'"))
+                .arg(qName)
+                .arg(parentElement));
+    }
+
+    tpWarning(logConnections) << "Ignoring unknown element" << qName;
+    mReader.skipCurrentElement();
+    return true;
+}
+
+bool Profile::Private::XmlReader::checkAttributes(const QStringList &allowedAttrs,
+        const QStringList &mandatoryAttrs)
+{
+    QXmlStreamAttributes attributes = mReader.attributes();
+    QString qName = mReader.qualifiedName().toString();
+
+    foreach (const QString &attrName, mandatoryAttrs) {
+        if (!attributes.hasAttribute(attrName)) {
+            return setError(QString(QLatin1String("mandatory attribute '%1' "
+                            "missing on element '%2'"))
+                    .arg(attrName)
+                    .arg(qName));
+        }
+    }
+
+    foreach (const QXmlStreamAttribute &attribute, attributes) {
+        QString attrName = attribute.qualifiedName().toString();
+        if (!allowedAttrs.contains(attrName)) {
+            return setError(QString(QLatin1String("invalid attribute '%1' on "
+                            "element '%2'"))
+                    .arg(attrName)
+                    .arg(qName));
+        }
+    }
+
+    return true;
 }
 
-bool Profile::Private::XmlHandler::attributeValueAsBoolean(
-        const QXmlAttributes &attributes, const QString &qName)
+bool Profile::Private::XmlReader::attributeValueAsBoolean(const QString &name) const
 {
-    QString tmpStr = attributes.value(qName);
+    QString tmpStr = mReader.attributes().value(name).toString();
     if (tmpStr == QLatin1String("1") ||
         tmpStr == QLatin1String("true")) {
         return true;
@@ -412,11 +497,20 @@ bool Profile::Private::XmlHandler::attributeValueAsBoolean(
     }
 }
 
+bool Profile::Private::XmlReader::setError(const QString &errorString)
+{
+    mErrorString = errorString;
+    return false;
+}
+
 
 Profile::Private::Private()
-    : valid(false),
+    : fileSize(-1),
+      valid(false),
       fake(false),
-      allowNonIMType(false)
+      allowNonIMType(false),
+      sectionsLoaded(false),
+      sectionsMalformed(false)
 {
 }
 
@@ -437,30 +531,31 @@ void Profile::Private::setFileName(const QString &fileName)
     QFileInfo fi(fileName);
     serviceName = fi.baseName();
 
-    debug() << "Loading profile file" << fileName;
+    tpDebug(logConnections) << "Loading profile file" << fileName;
 
     QFile file(fileName);
     if (!file.exists()) {
-        warning() << QString(QLatin1String("Error parsing profile file %1: file does not exist"))
+        tpWarning(logConnections) <<
+            QString(QLatin1String("Error parsing profile file %1: file does not exist"))
             .arg(file.fileName());
         return;
     }
 
     if (!file.open(QFile::ReadOnly)) {
-        warning() << QString(QLatin1String("Error parsing profile file %1: "
+        tpWarning(logConnections) << QString(QLatin1String("Error parsing profile file %1: "
                     "cannot open file for readonly access"))
             .arg(file.fileName());
         return;
     }
 
     if (parse(&file)) {
-        debug() << "Profile file" << fileName << "loaded successfully";
+        tpDebug(logConnections) << "Profile file" << fileName << "loaded successfully";
     }
 }
 
 void Profile::Private::lookupProfile()
 {
-    debug() << "Searching profile for service" << serviceName;
+    tpDebug(logConnections) << "Searching profile for service" << serviceName;
 
     QStringList searchDirs = Profile::searchDirs();
     bool found = false;
@@ -477,14 +572,14 @@ void Profile::Private::lookupProfile()
         }
 
         if (parse(&file)) {
-            debug() << "Profile for service" << serviceName << "found:" << fileName;
+            tpDebug(logConnections) << "Profile for service" << serviceName << "found:" << fileName;
             found = true;
             break;
         }
     }
 
     if (!found) {
-        debug() << "Cannot find valid profile for service" << serviceName;
+        tpDebug(logConnections) << "Cannot find valid profile for service" << serviceName;
     }
 }
 
@@ -493,32 +588,204 @@ bool Profile::Private::parse(QFile *file)
     invalidate();
 
     fake = false;
-    QFileInfo fi(file->fileName());
-    XmlHandler xmlHandler(serviceName, allowNonIMType, &data);
-
-    QXmlSimpleReader xmlReader;
-    xmlReader.setContentHandler(&xmlHandler);
-    xmlReader.setErrorHandler(&xmlHandler);
+    if (loadFromCache(file->fileName())) {
+        return true;
+    }
 
-    QXmlInputSource xmlInputSource(file);
-    if (!xmlReader.parse(xmlInputSource)) {
-        warning() << QString(QLatin1String("Error parsing profile file %1: %2"))
+    // Most users only look at the service metadata, so the sections are read on demand
+    XmlReader xmlReader(file, serviceName, allowNonIMType, &data);
+    if (!xmlReader.readHeader()) {
+        tpWarning(logConnections) << QString(QLatin1String("Error parsing profile file %1: %2"))
             .arg(file->fileName())
-            .arg(xmlHandler.errorString());
+            .arg(xmlReader.errorString());
         invalidate();
         return false;
     }
 
     valid = true;
+    fileName = file->fileName();
+    rememberFileState();
+    saveToCache(fileName);
     return true;
 }
 
+void Profile::Private::rememberFileState()
+{
+    QFileInfo fi(fileName);
+    fileSize = fi.size();
+    fileModified = fi.lastModified();
+}
+
+void Profile::Private::loadSections()
+{
+    if (sectionsMalformed) {
+        tpWarning(logConnections) << "Profile file" << fileName <<
+            "has malformed sections, reporting them as empty";
+        return;
+    }
+
+    if (sectionsLoaded || !valid || fake) {
+        return;
+    }
+    sectionsLoaded = true;
+
+    // The whole file is read again, header included, so that the sections always match the
+    // header even if the file was replaced since the header was read
+    QFileInfo fi(fileName);
+    bool changed = fi.size() != fileSize || fi.lastModified() != fileModified;
+    if (changed) {
+        tpDebug(logConnections) << "Profile file" << fileName <<
+            "changed since it was loaded, reading it again";
+    }
+
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly)) {
+        tpWarning(logConnections) << QString(QLatin1String("Error parsing profile file %1: "
+                    "cannot open file for readonly access"))
+            .arg(fileName);
+        sectionsMalformed = true;
+        return;
+    }
+
+    Data fullData;
+    XmlReader xmlReader(&file, serviceName, allowNonIMType, &fullData);
+    if (!xmlReader.readSections()) {
+        // The profile has been handed out already with its header, which stays usable, so only
+        // the sections are given up on
+        tpWarning(logConnections) << QString(QLatin1String("Error parsing profile file %1: %2"))
+            .arg(fileName)
+            .arg(xmlReader.errorString());
+        sectionsMalformed = true;
+        return;
+    }
+
+    if (changed) {
+        data = fullData;
+        rememberFileState();
+    } else {
+        data.parameters = fullData.parameters;
+        data.allowOtherPresences = fullData.allowOtherPresences;
+        data.presences = fullData.presences;
+        data.unsupportedChannelClassSpecs = fullData.unsupportedChannelClassSpecs;
+    }
+    saveToCache(fileName);
+}
+
 void Profile::Private::invalidate()
 {
     valid = false;
+    sectionsLoaded = false;
+    sectionsMalformed = false;
+    fileName.clear();
+    fileSize = -1;
+    fileModified = QDateTime();
     data.clear();
 }
 
+bool Profile::Private::loadFromCache(const QString &cachedFileName)
+{
+    QByteArray cached;
+    if (!ParsedFileCache::profiles()->lookup(cachedFileName, cached)) {
+        return false;
+    }
+
+    QDataStream stream(cached);
+    ParsedFileCache::setupStream(stream);
+
+    Data cachedData;
+    quint32 count;
+
+    bool cachedSections;
+    stream >> cachedData.type >> cachedData.provider >> cachedData.name >>
+        cachedData.iconName >> cachedData.cmName >> cachedData.protocolName >> cachedSections;
+
+    if (cachedSections) {
+        stream >> count;
+        for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+            QString name, signature, label;
+            QVariant value;
+            bool mandatory;
+            stream >> name >> signature >> value >> label >> mandatory;
+            cachedData.parameters.append(Profile::Parameter(name, QDBusSignature(signature),
+                        value, label, mandatory));
+        }
+
+        stream >> cachedData.allowOtherPresences >> count;
+        for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+            QString id, label, iconName, message;
+            bool disabled;
+            stream >> id >> label >> iconName >> message >> disabled;
+            cachedData.presences.append(Profile::Presence(id, label, iconName, message,
+                        disabled));
+        }
+
+        stream >> count;
+        for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+            RequestableChannelClass rcc;
+            stream >> rcc.fixedProperties >> rcc.allowedProperties;
+            cachedData.unsupportedChannelClassSpecs.append(RequestableChannelClassSpec(rcc));
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        tpWarning(logConnections) << "Ignoring corrupted cache entry for profile file" <<
+            cachedFileName;
+        return false;
+    }
+
+    // The cache also holds profiles loaded through createForFileName(), which accepts any type
+    if (cachedData.type != QLatin1String("IM") && !allowNonIMType) {
+        tpWarning(logConnections) << QString(QLatin1String("Error parsing profile file %1: "
+                    "unknown value of element 'type': %2"))
+            .arg(cachedFileName)
+            .arg(cachedData.type);
+        return false;
+    }
+
+    data = cachedData;
+    valid = true;
+    sectionsLoaded = cachedSections;
+    fileName = cachedFileName;
+    rememberFileState();
+    return true;
+}
+
+void Profile::Private::saveToCache(const QString &cachedFileName) const
+{
+    QByteArray cached;
+    QDataStream stream(&cached, QIODevice::WriteOnly);
+    ParsedFileCache::setupStream(stream);
+
+    stream << data.type << data.provider << data.name << data.iconName << data.cmName <<
+        data.protocolName << sectionsLoaded;
+
+    if (sectionsLoaded) {
+        stream << (quint32) data.parameters.size();
+        foreach (const Profile::Parameter &param, data.parameters) {
+            stream << param.name() << param.dbusSignature().signature() << param.value() <<
+                param.label() << param.isMandatory();
+        }
+
+        stream << data.allowOtherPresences << (quint32) data.presences.size();
+        foreach (const Profile::Presence &presence, data.presences) {
+            stream << presence.id() << presence.label() << presence.iconName() <<
+                QString(presence.canHaveStatusMessage() ? QLatin1String("1") : QLatin1String("0")) <<
+                presence.isDisabled();
+        }
+
+        stream << (quint32) data.unsupportedChannelClassSpecs.size();
+        foreach (const RequestableChannelClassSpec &spec, data.unsupportedChannelClassSpecs) {
+            RequestableChannelClass rcc = spec.bareClass();
+            stream << rcc.fixedProperties << rcc.allowedProperties;
+        }
+    }
+
+    // Loading the sections of many profiles one by one only rewrites the cache file once
+    ParsedFileCache *cache = ParsedFileCache::profiles();
+    cache->insert(cachedFileName, cached);
+    cache->saveLater();
+}
+
 /**
  * \class Profile
  * \ingroup utils
@@ -529,6 +796,12 @@ void Profile::Private::invalidate()
  *
  * Note that profiles with xml element \<type\> different than "IM" are considered
  * invalid.
+ *
+ * Only the service metadata is read when the profile is loaded. The parameters,
+ * presences and unsupported channel classes sections are read the first time one of
+ * them is accessed. If those sections turn out to be malformed, a warning is printed
+ * whenever they are accessed and they are reported as empty, while the service metadata
+ * stays available.
  */
 
 /**
@@ -621,6 +894,7 @@ Profile::Profile(const QString &serviceName, const QString &cmName,
 
     mPriv->valid = true;
     mPriv->fake = true;
+    mPriv->sectionsLoaded = true;
 }
 
 /**
@@ -644,6 +918,10 @@ QString Profile::serviceName() const
 /**
  * Return whether this profile is valid.
  *
+ * This only depends on the service metadata, which is read when the profile is loaded.
+ * Malformed parameters, presences or unsupported channel classes sections are reported
+ * by the accessors for them instead.
+ *
  * \return \c true if valid, otherwise \c false.
  */
 bool Profile::isValid() const
@@ -738,6 +1016,7 @@ QString Profile::protocolName() const
  */
 Profile::ParameterList Profile::parameters() const
 {
+    mPriv->loadSections();
     return mPriv->data.parameters;
 }
 
@@ -748,6 +1027,7 @@ Profile::ParameterList Profile::parameters() const
  */
 bool Profile::hasParameter(const QString &name) const
 {
+    mPriv->loadSections();
     foreach (const Parameter &parameter, mPriv->data.parameters) {
         if (parameter.name() == name) {
             return true;
@@ -763,6 +1043,7 @@ bool Profile::hasParameter(const QString &name) const
  */
 Profile::Parameter Profile::parameter(const QString &name) const
 {
+    mPriv->loadSections();
     foreach (const Parameter &parameter, mPriv->data.parameters) {
         if (parameter.name() == name) {
             return parameter;
@@ -779,6 +1060,7 @@ Profile::Parameter Profile::parameter(const QString &name) const
  */
 bool Profile::allowOtherPresences() const
 {
+    mPriv->loadSections();
     return mPriv->data.allowOtherPresences;
 }
 
@@ -790,6 +1072,7 @@ bool Profile::allowOtherPresences() const
  */
 Profile::PresenceList Profile::presences() const
 {
+    mPriv->loadSections();
     return mPriv->data.presences;
 }
 
@@ -800,6 +1083,7 @@ Profile::PresenceList Profile::presences() const
  */
 bool Profile::hasPresence(const QString &id) const
 {
+    mPriv->loadSections();
     foreach (const Presence &presence, mPriv->data.presences) {
         if (presence.id() == id) {
             return true;
@@ -815,6 +1099,7 @@ bool Profile::hasPresence(const QString &id) const
  */
 Profile::Presence Profile::presence(const QString &id) const
 {
+    mPriv->loadSections();
     foreach (const Presence &presence, mPriv->data.presences) {
         if (presence.id() == id) {
             return presence;
@@ -831,6 +1116,7 @@ Profile::Presence Profile::presence(const QString &id) const
  */
 RequestableChannelClassSpecList Profile::unsupportedChannelClassSpecs() const
 {
+    mPriv->loadSections();
     return mPriv->data.unsupportedChannelClassSpecs;
 }
 
@@ -844,6 +1130,11 @@ void Profile::setFileName(const QString &fileName)
     mPriv->setFileName(fileName);
 }
 
+QString Profile::fileName() const
+{
+    return mPriv->fileName;
+}
+
 QStringList Profile::searchDirs()
 {
     QStringList ret;
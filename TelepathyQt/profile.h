@@ -152,6 +152,7 @@ public:
 private:
     friend class Account;
     friend class ProfileManager;
+    friend class SharedDataRegistry;
 
     TP_QT_NO_EXPORT Profile();
     TP_QT_NO_EXPORT Profile(const QString &serviceName, const QString &cmName,
@@ -159,6 +160,7 @@ private:
 
     TP_QT_NO_EXPORT void setServiceName(const QString &serviceName);
     TP_QT_NO_EXPORT void setFileName(const QString &fileName);
+    TP_QT_NO_EXPORT QString fileName() const;
 
     TP_QT_NO_EXPORT static QStringList searchDirs();
 
@@ -25,6 +25,7 @@
 #include "TelepathyQt/_gen/readiness-helper.moc.hpp"
 
 #include "TelepathyQt/debug-internal.h"
+#include "TelepathyQt/feature-internal.h"
 
 #include <TelepathyQt/Constants>
 #include <TelepathyQt/DBusProxy>
@@ -49,6 +50,7 @@ struct TP_QT_NO_EXPORT ReadinessHelper::Introspectable::Private : public QShared
             bool critical)
         : makesSenseForStatuses(makesSenseForStatuses),
         dependsOnFeatures(dependsOnFeatures),
+        dependsOnFeatureSet(dependsOnFeatures),
         dependsOnInterfaces(dependsOnInterfaces),
         introspectFunc(introspectFunc),
         introspectFuncData(introspectFuncData),
@@ -56,6 +58,7 @@ struct TP_QT_NO_EXPORT ReadinessHelper::Introspectable::Private : public QShared
 
     QSet<uint> makesSenseForStatuses;
     Features dependsOnFeatures;
+    FeatureSet dependsOnFeatureSet;
     QStringList dependsOnInterfaces;
     IntrospectFunc introspectFunc;
     void *introspectFuncData;
@@ -109,6 +112,12 @@ struct TP_QT_NO_EXPORT ReadinessHelper::Private
             const QString &errorMessage = QString());
     void iterateIntrospection();
     Features depsFor(const Feature &feature); // Recursive dependencies for a feature
+    FeatureSet depsSetFor(const Feature &feature);
+
+    void addSatisfied(const Feature &feature);
+    void addMissing(const Feature &feature, const QString &errorName,
+            const QString &errorMessage);
+    void clearCompleted();
 
     void abortOperations(const QString &errorName, const QString &errorMessage);
 
@@ -125,6 +134,12 @@ struct TP_QT_NO_EXPORT ReadinessHelper::Private
     Features missingFeatures;
     Features pendingFeatures;
     Features inFlightFeatures;
+    // Bitset mirrors of the sets above which are checked on every isReady() and introspection step
+    FeatureSet supportedFeatureSet;
+    FeatureSet satisfiedFeatureSet;
+    FeatureSet requestedFeatureSet;
+    FeatureSet missingFeatureSet;
+    QHash<int, FeatureSet> depsSets;
     QHash<Feature, QPair<QString, QString> > missingFeaturesErrors;
     QList<PendingReady *> pendingOperations;
 
@@ -152,6 +167,7 @@ ReadinessHelper::Private::Private(
         Q_ASSERT(introspectable.mPriv->introspectFunc != 0);
         supportedStatuses += introspectable.mPriv->makesSenseForStatuses;
         supportedFeatures += feature;
+        supportedFeatureSet.insert(feature);
     }
 }
 
@@ -177,6 +193,7 @@ ReadinessHelper::Private::Private(
         Q_ASSERT(introspectable.mPriv->introspectFunc != 0);
         supportedStatuses += introspectable.mPriv->makesSenseForStatuses;
         supportedFeatures += feature;
+        supportedFeatureSet.insert(feature);
     }
 }
 
@@ -195,8 +212,7 @@ void ReadinessHelper::Private::setCurrentStatus(uint newStatus)
 
     if (inFlightFeatures.isEmpty()) {
         currentStatus = newStatus;
-        satisfiedFeatures.clear();
-        missingFeatures.clear();
+        clearCompleted();
 
         // Make all features that were requested for the new status pending again
         pendingFeatures = requestedFeatures;
@@ -210,7 +226,7 @@ void ReadinessHelper::Private::setCurrentStatus(uint newStatus)
             emit parent->statusReady(currentStatus);
         }
     } else {
-        debug() << "status changed while introspection process was running";
+        tpDebug(logGeneral) << "status changed while introspection process was running";
         pendingStatusChange = true;
         pendingStatus = newStatus;
     }
@@ -219,10 +235,13 @@ void ReadinessHelper::Private::setCurrentStatus(uint newStatus)
 void ReadinessHelper::Private::setIntrospectCompleted(const Feature &feature,
         bool success, const QString &errorName, const QString &errorMessage)
 {
-    debug() << "ReadinessHelper::setIntrospectCompleted: feature:" << feature <<
+    tpDebug(logGeneral) << "ReadinessHelper::setIntrospectCompleted: feature:" << feature <<
         "- success:" << success;
+    tpTraceDetail(logGeneral, success ? "Feature introspection completed" :
+            "Feature introspection failed", object, feature.second,
+            FeatureSet::traceNameOf(feature));
     if (pendingStatusChange) {
-        debug() << "ReadinessHelper::setIntrospectCompleted called while there is "
+        tpDebug(logGeneral) << "ReadinessHelper::setIntrospectCompleted called while there is "
             "a pending status change - ignoring";
 
         inFlightFeatures.remove(feature);
@@ -240,14 +259,12 @@ void ReadinessHelper::Private::setIntrospectCompleted(const Feature &feature,
     Q_ASSERT(inFlightFeatures.contains(feature));
 
     if (success) {
-        satisfiedFeatures.insert(feature);
+        addSatisfied(feature);
     }
     else {
-        missingFeatures.insert(feature);
-        missingFeaturesErrors.insert(feature,
-                QPair<QString, QString>(errorName, errorMessage));
+        addMissing(feature, errorName, errorMessage);
         if (errorName.isEmpty()) {
-            warning() << "ReadinessHelper::setIntrospectCompleted: Feature" <<
+            tpWarning(logGeneral) << "ReadinessHelper::setIntrospectCompleted: Feature" <<
                 feature << "introspection failed but no error message was given";
         }
     }
@@ -261,7 +278,7 @@ void ReadinessHelper::Private::setIntrospectCompleted(const Feature &feature,
 void ReadinessHelper::Private::iterateIntrospection()
 {
     if (proxy && !proxy->isValid()) {
-        debug() << "ReadinessHelper: not iterating as the proxy is invalidated";
+        tpDebug(logGeneral) << "ReadinessHelper: not iterating as the proxy is invalidated";
         return;
     }
 
@@ -276,22 +293,22 @@ void ReadinessHelper::Private::iterateIntrospection()
     //
     //  So we can safely skip the rest of this function here.
     if (pendingStatusChange) {
-        debug() << "ReadinessHelper: not iterating as a status change is pending";
+        tpDebug(logGeneral) << "ReadinessHelper: not iterating as a status change is pending";
         return;
     }
 
     // Flag the currently pending reverse dependencies of any previously discovered missing features
     // as missing
-    foreach (const Feature &feature, pendingFeatures) {
-        if (!depsFor(feature).intersect(missingFeatures).isEmpty()) {
-            missingFeatures.insert(feature);
-            missingFeaturesErrors.insert(feature,
-                    QPair<QString, QString>(TP_QT_ERROR_NOT_AVAILABLE,
-                        QLatin1String("Feature depends on other features that are not available")));
+    if (!missingFeatureSet.isEmpty()) {
+        foreach (const Feature &feature, pendingFeatures) {
+            if (depsSetFor(feature).intersects(missingFeatureSet)) {
+                addMissing(feature, TP_QT_ERROR_NOT_AVAILABLE,
+                        QLatin1String("Feature depends on other features that are not available"));
+            }
         }
     }
 
-    const Features completedFeatures = satisfiedFeatures + missingFeatures;
+    const FeatureSet completedFeatureSet = satisfiedFeatureSet | missingFeatureSet;
 
     // check if any pending operations for becomeReady should finish now
     // based on their requested features having nothing more than what
@@ -299,7 +316,7 @@ void ReadinessHelper::Private::iterateIntrospection()
     QString errorName;
     QString errorMessage;
     foreach (PendingReady *operation, pendingOperations) {
-        if ((operation->requestedFeatures() - completedFeatures).isEmpty()) {
+        if (completedFeatureSet.contains(FeatureSet(operation->requestedFeatures()))) {
             if (parent->isReady(operation->requestedFeatures(), &errorName, &errorMessage)) {
                 operation->setFinished();
             } else {
@@ -314,7 +331,7 @@ void ReadinessHelper::Private::iterateIntrospection()
         }
     }
 
-    if ((requestedFeatures - completedFeatures).isEmpty()) {
+    if (completedFeatureSet.contains(requestedFeatureSet)) {
         // Otherwise, we'd emit statusReady with currentStatus although we are supposed to be
         // introspecting the pendingStatus and only when that is complete, emit statusReady
         Q_ASSERT(!pendingStatusChange);
@@ -326,13 +343,19 @@ void ReadinessHelper::Private::iterateIntrospection()
 
     // update pendingFeatures with the difference of requested and
     // satisfied + missing
-    pendingFeatures -= completedFeatures;
+    for (Features::iterator i = pendingFeatures.begin(); i != pendingFeatures.end();) {
+        if (completedFeatureSet.contains(*i)) {
+            i = pendingFeatures.erase(i);
+        } else {
+            ++i;
+        }
+    }
 
     // find out which features don't have dependencies that are still pending
     Features readyToIntrospect;
     foreach (const Feature &feature, pendingFeatures) {
         // missing doesn't have to be considered here anymore
-        if ((introspectables[feature].mPriv->dependsOnFeatures - satisfiedFeatures).isEmpty()) {
+        if (satisfiedFeatureSet.contains(introspectables[feature].mPriv->dependsOnFeatureSet)) {
             readyToIntrospect.insert(feature);
         }
     }
@@ -359,7 +382,7 @@ void ReadinessHelper::Private::iterateIntrospection()
             if (!interfaces.contains(interface)) {
                 // If a feature is ready to introspect and depends on a interface
                 // that is not present the feature can't possibly be satisfied
-                debug() << "feature" << feature << "depends on interfaces" <<
+                tpDebug(logGeneral) << "feature" << feature << "depends on interfaces" <<
                     introspectable.mPriv->dependsOnInterfaces << ", but interface" << interface <<
                     "is not present";
                 setIntrospectCompleted(feature, false,
@@ -388,6 +411,41 @@ Features ReadinessHelper::Private::depsFor(const Feature &feature)
     return deps;
 }
 
+FeatureSet ReadinessHelper::Private::depsSetFor(const Feature &feature)
+{
+    int index = FeatureSet::indexOf(feature);
+    QHash<int, FeatureSet>::const_iterator i = depsSets.constFind(index);
+    if (i != depsSets.constEnd()) {
+        return i.value();
+    }
+
+    FeatureSet deps(depsFor(feature));
+    depsSets.insert(index, deps);
+    return deps;
+}
+
+void ReadinessHelper::Private::addSatisfied(const Feature &feature)
+{
+    satisfiedFeatures.insert(feature);
+    satisfiedFeatureSet.insert(feature);
+}
+
+void ReadinessHelper::Private::addMissing(const Feature &feature, const QString &errorName,
+        const QString &errorMessage)
+{
+    missingFeatures.insert(feature);
+    missingFeatureSet.insert(feature);
+    missingFeaturesErrors.insert(feature, QPair<QString, QString>(errorName, errorMessage));
+}
+
+void ReadinessHelper::Private::clearCompleted()
+{
+    satisfiedFeatures.clear();
+    satisfiedFeatureSet.clear();
+    missingFeatures.clear();
+    missingFeatureSet.clear();
+}
+
 void ReadinessHelper::Private::abortOperations(const QString &errorName,
         const QString &errorMessage)
 {
@@ -446,7 +504,7 @@ void ReadinessHelper::addIntrospectables(const Introspectables &introspectables)
             i != introspectables.constEnd(); ++i) {
         Feature feature = i.key();
         if (mPriv->introspectables.contains(feature)) {
-            warning() << "ReadinessHelper::addIntrospectables: trying to add an "
+            tpWarning(logGeneral) << "ReadinessHelper::addIntrospectables: trying to add an "
                 "introspectable for feature" << feature << "but introspectable "
                 "for this feature already exists";
         } else {
@@ -454,11 +512,15 @@ void ReadinessHelper::addIntrospectables(const Introspectables &introspectables)
             mPriv->introspectables.insert(feature, introspectable);
             mPriv->supportedStatuses += introspectable.mPriv->makesSenseForStatuses;
             mPriv->supportedFeatures += feature;
+            mPriv->supportedFeatureSet.insert(feature);
         }
     }
 
-    debug() << "ReadinessHelper: new supportedStatuses =" << mPriv->supportedStatuses;
-    debug() << "ReadinessHelper: new supportedFeatures =" << mPriv->supportedFeatures;
+    // New introspectables may add to the dependencies of the existing ones
+    mPriv->depsSets.clear();
+
+    tpDebug(logGeneral) << "ReadinessHelper: new supportedStatuses =" << mPriv->supportedStatuses;
+    tpDebug(logGeneral) << "ReadinessHelper: new supportedFeatures =" << mPriv->supportedFeatures;
 }
 
 uint ReadinessHelper::currentStatus() const
@@ -526,7 +588,7 @@ bool ReadinessHelper::isReady(const Feature &feature,
         return false;
     }
 
-    if (!mPriv->supportedFeatures.contains(feature)) {
+    if (!mPriv->supportedFeatureSet.contains(feature)) {
         if (errorName) {
             *errorName = TP_QT_ERROR_INVALID_ARGUMENT;
         }
@@ -539,12 +601,12 @@ bool ReadinessHelper::isReady(const Feature &feature,
     bool ret = true;
 
     if (feature.isCritical()) {
-        if (!mPriv->satisfiedFeatures.contains(feature)) {
+        if (!mPriv->satisfiedFeatureSet.contains(feature)) {
             ret = false;
         }
     } else {
-        if (!mPriv->satisfiedFeatures.contains(feature) &&
-            !mPriv->missingFeatures.contains(feature)) {
+        if (!mPriv->satisfiedFeatureSet.contains(feature) &&
+            !mPriv->missingFeatureSet.contains(feature)) {
             ret = false;
         }
     }
@@ -604,9 +666,10 @@ PendingReady *ReadinessHelper::becomeReady(const Features &requestedFeatures)
         }
     }
 
-    Features supportedFeatures = mPriv->supportedFeatures;
-    if (supportedFeatures.intersect(requestedFeatures) != requestedFeatures) {
-        warning() << "ReadinessHelper::becomeReady called with invalid features: requestedFeatures =" <<
+    const FeatureSet requestedFeatureSet(requestedFeatures);
+    if (!mPriv->supportedFeatureSet.contains(requestedFeatureSet)) {
+        tpWarning(logGeneral) <<
+            "ReadinessHelper::becomeReady called with invalid features: requestedFeatures =" <<
             requestedFeatures << "- supportedFeatures =" << mPriv->supportedFeatures;
         PendingReady *operation = new PendingReady(SharedPtr<RefCounted>(mPriv->object),
                 requestedFeatures);
@@ -633,11 +696,14 @@ PendingReady *ReadinessHelper::becomeReady(const Features &requestedFeatures)
 
     // Insert the dependencies of the requested features too
     Features requestedWithDeps = requestedFeatures;
-    foreach (const Feature &feature, requestedFeatures) {
-        requestedWithDeps.unite(mPriv->depsFor(feature));
+    if (!mPriv->requestedFeatureSet.contains(requestedFeatureSet)) {
+        foreach (const Feature &feature, requestedFeatures) {
+            requestedWithDeps.unite(mPriv->depsFor(feature));
+        }
     }
 
     mPriv->requestedFeatures += requestedWithDeps;
+    mPriv->requestedFeatureSet |= FeatureSet(requestedWithDeps);
     mPriv->pendingFeatures += requestedWithDeps; // will be updated in iterateIntrospection
 
     operation = new PendingReady(SharedPtr<RefCounted>(mPriv->object), requestedFeatures);
@@ -675,8 +741,7 @@ void ReadinessHelper::onProxyInvalidated(DBusProxy *proxy,
         const QString &errorName, const QString &errorMessage)
 {
     // clear satisfied and missing features as we have public methods to get them
-    mPriv->satisfiedFeatures.clear();
-    mPriv->missingFeatures.clear();
+    mPriv->clearCompleted();
 
     mPriv->abortOperations(errorName, errorMessage);
 }
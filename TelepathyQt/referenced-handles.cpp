@@ -63,7 +63,7 @@ struct TP_QT_NO_EXPORT ReferencedHandles::Private : public QSharedData
         if (!handles.isEmpty()) {
             ConnectionPtr conn(connection);
             if (!conn) {
-                debug() << "  Destroyed after Connection, so the Connection "
+                tpDebug(logConnections) << "  Destroyed after Connection, so the Connection "
                     "has already released the handles";
                 return;
             }
@@ -79,7 +79,7 @@ struct TP_QT_NO_EXPORT ReferencedHandles::Private : public QSharedData
         if (!handles.isEmpty()) {
             ConnectionPtr conn(connection);
             if (!conn) {
-                debug() << "  Destroyed after Connection, so the Connection "
+                tpDebug(logConnections) << "  Destroyed after Connection, so the Connection "
                     "has already released the handles";
                 return;
             }
@@ -202,7 +202,7 @@ void ReferencedHandles::clear()
                 conn->unrefHandle(handleType(), handle);
             }
         } else {
-            warning() << "Connection already destroyed in "
+            tpWarning(logConnections) << "Connection already destroyed in "
                 "ReferencedHandles::clear() so can't unref!";
         }
     }
@@ -226,7 +226,7 @@ int ReferencedHandles::removeAll(uint handle)
                 conn->unrefHandle(handleType(), handle);
             }
         } else {
-            warning() << "Connection already destroyed in "
+            tpWarning(logConnections) << "Connection already destroyed in "
                 "ReferencedHandles::removeAll() with handle ==" <<
                 handle << "so can't unref!";
         }
@@ -241,7 +241,7 @@ void ReferencedHandles::removeAt(int i)
     if (conn) {
         conn->unrefHandle(handleType(), at(i));
     } else {
-        warning() << "Connection already destroyed in "
+        tpWarning(logConnections) << "Connection already destroyed in "
             "ReferencedHandles::removeAt() with i ==" <<
             i << "so can't unref!";
     }
@@ -258,7 +258,7 @@ bool ReferencedHandles::removeOne(uint handle)
         if (conn) {
             conn->unrefHandle(handleType(), handle);
         } else {
-            warning() << "Connection already destroyed in "
+            tpWarning(logConnections) << "Connection already destroyed in "
                 "ReferencedHandles::removeOne() with handle ==" <<
                 handle << "so can't unref!";
         }
@@ -278,7 +278,7 @@ uint ReferencedHandles::takeAt(int i)
     if (conn) {
         conn->unrefHandle(handleType(), at(i));
     } else {
-        warning() << "Connection already destroyed in "
+        tpWarning(logConnections) << "Connection already destroyed in "
             "ReferencedHandles::takeAt() with i ==" <<
             i << "so can't unref!";
     }
@@ -290,7 +290,7 @@ ReferencedHandles ReferencedHandles::operator+(const ReferencedHandles &another)
 {
     if (connection() != another.connection() ||
         handleType() != another.handleType()) {
-        warning() << "Tried to concatenate ReferencedHandles instances "
+        tpWarning(logConnections) << "Tried to concatenate ReferencedHandles instances "
             "with different connection and/or handle type";
         return *this;
     }
@@ -76,7 +76,8 @@ void RequestTemporaryHandler::handleChannels(
     }
 
     if (!errorMessage.isEmpty()) {
-        warning() << "Handling channel failed with" << TP_QT_ERROR_SERVICE_CONFUSED << ":" <<
+        tpWarning(logClients) << "Handling channel failed with" << TP_QT_ERROR_SERVICE_CONFUSED <<
+            ":" <<
             errorMessage;
 
         // Only emit error if we didn't receive any channel yet.
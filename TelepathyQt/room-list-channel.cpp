@@ -26,24 +26,199 @@
 #include "TelepathyQt/debug-internal.h"
 
 #include <TelepathyQt/Connection>
+#include <TelepathyQt/PendingFailure>
+#include <TelepathyQt/PendingVariant>
+#include <TelepathyQt/PendingVoid>
+
+#include <QSet>
+#include <QVector>
+
+#include <algorithm>
 
 namespace Tp
 {
 
 struct TP_QT_NO_EXPORT RoomListChannel::Private
 {
-    inline Private();
-    inline ~Private();
+    Private(RoomListChannel *parent, const QVariantMap &immutableProperties);
+    ~Private();
+
+    static void introspectMain(Private *self);
+    void introspectListingRooms();
+
+    void addRooms(const RoomInfoList &newRooms, RoomInfoList *changedRooms);
+    void addIndexKeys(int index, QVector<QPair<QString, int> > *keys) const;
+    void removeIndexKeys(int index);
+
+    static QString handleName(const RoomInfo &room);
+    static QString name(const RoomInfo &room);
+
+    struct IndexKeyLessThan
+    {
+        bool operator()(const QPair<QString, int> &a, const QPair<QString, int> &b) const
+        {
+            return a.first < b.first;
+        }
+
+        bool operator()(const QPair<QString, int> &a, const QString &prefix) const
+        {
+            return a.first < prefix;
+        }
+    };
+
+    // Public object
+    RoomListChannel *parent;
+
+    Client::ChannelTypeRoomListInterface *roomListInterface;
+
+    ReadinessHelper *readinessHelper;
+
+    // Introspection
+    QString server;
+    bool listingRooms;
+
+    // Room directory, accumulated from GotRooms batches. Rooms are kept in arrival order and
+    // deduplicated by handle name; the prefix index holds the case-folded handle name and room
+    // name of every room, sorted, pointing back into rooms.
+    RoomInfoList rooms;
+    QHash<QString, int> roomIndexByHandleName;
+    QVector<QPair<QString, int> > prefixIndex;
 };
 
-RoomListChannel::Private::Private()
+RoomListChannel::Private::Private(RoomListChannel *parent,
+        const QVariantMap &immutableProperties)
+    : parent(parent),
+      roomListInterface(parent->interface<Client::ChannelTypeRoomListInterface>()),
+      readinessHelper(parent->readinessHelper()),
+      listingRooms(false)
 {
+    server = qdbus_cast<QString>(immutableProperties.value(
+                TP_QT_IFACE_CHANNEL_TYPE_ROOM_LIST + QLatin1String(".Server")));
+
+    ReadinessHelper::Introspectables introspectables;
+
+    ReadinessHelper::Introspectable introspectableCore(
+        QSet<uint>() << 0,                                                      // makesSenseForStatuses
+        Features() << Channel::FeatureCore,                                     // dependsOnFeatures (core)
+        QStringList(),                                                          // dependsOnInterfaces
+        (ReadinessHelper::IntrospectFunc) &Private::introspectMain,
+        this);
+    introspectables[FeatureCore] = introspectableCore;
+
+    readinessHelper->addIntrospectables(introspectables);
 }
 
 RoomListChannel::Private::~Private()
 {
 }
 
+void RoomListChannel::Private::introspectMain(RoomListChannel::Private *self)
+{
+    self->parent->connect(self->roomListInterface,
+            SIGNAL(GotRooms(Tp::RoomInfoList)),
+            SLOT(onGotRooms(Tp::RoomInfoList)));
+    self->parent->connect(self->roomListInterface,
+            SIGNAL(ListingRooms(bool)),
+            SLOT(onListingRooms(bool)));
+
+    if (self->parent->immutableProperties().contains(
+                TP_QT_IFACE_CHANNEL_TYPE_ROOM_LIST + QLatin1String(".Server"))) {
+        self->introspectListingRooms();
+    } else {
+        self->parent->connect(self->roomListInterface->requestPropertyServer(),
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(gotServer(Tp::PendingOperation*)));
+    }
+}
+
+void RoomListChannel::Private::introspectListingRooms()
+{
+    QDBusPendingCallWatcher *watcher =
+        new QDBusPendingCallWatcher(roomListInterface->GetListingRooms(), parent);
+    parent->connect(watcher,
+            SIGNAL(finished(QDBusPendingCallWatcher*)),
+            SLOT(gotListingRooms(QDBusPendingCallWatcher*)));
+}
+
+QString RoomListChannel::Private::handleName(const RoomInfo &room)
+{
+    return qdbus_cast<QString>(room.info.value(QLatin1String("handle-name")));
+}
+
+QString RoomListChannel::Private::name(const RoomInfo &room)
+{
+    return qdbus_cast<QString>(room.info.value(QLatin1String("name")));
+}
+
+void RoomListChannel::Private::addIndexKeys(int index, QVector<QPair<QString, int> > *keys) const
+{
+    const RoomInfo &room = rooms.at(index);
+    QString handleNameKey = handleName(room).toCaseFolded();
+    QString nameKey = name(room).toCaseFolded();
+    if (!handleNameKey.isEmpty()) {
+        keys->append(qMakePair(handleNameKey, index));
+    }
+    if (!nameKey.isEmpty() && nameKey != handleNameKey) {
+        keys->append(qMakePair(nameKey, index));
+    }
+}
+
+void RoomListChannel::Private::removeIndexKeys(int index)
+{
+    QVector<QPair<QString, int> > keys;
+    addIndexKeys(index, &keys);
+    foreach (const QPair<QString, int> &key, keys) {
+        QVector<QPair<QString, int> >::iterator it = std::lower_bound(prefixIndex.begin(),
+                prefixIndex.end(), key, IndexKeyLessThan());
+        while (it != prefixIndex.end() && it->first == key.first) {
+            if (it->second == index) {
+                prefixIndex.erase(it);
+                break;
+            }
+            ++it;
+        }
+    }
+}
+
+void RoomListChannel::Private::addRooms(const RoomInfoList &newRooms,
+        RoomInfoList *changedRooms)
+{
+    QVector<QPair<QString, int> > newKeys;
+    newKeys.reserve(newRooms.size() * 2);
+    rooms.reserve(rooms.size() + newRooms.size());
+
+    foreach (const RoomInfo &room, newRooms) {
+        QString roomHandleName = handleName(room);
+        int index = roomIndexByHandleName.value(roomHandleName, -1);
+        if (index >= 0) {
+            if (rooms.at(index) == room) {
+                continue;
+            }
+            removeIndexKeys(index);
+            rooms[index] = room;
+        } else {
+            index = rooms.size();
+            rooms.append(room);
+            if (!roomHandleName.isEmpty()) {
+                roomIndexByHandleName.insert(roomHandleName, index);
+            }
+        }
+        addIndexKeys(index, &newKeys);
+        changedRooms->append(room);
+    }
+
+    if (newKeys.isEmpty()) {
+        return;
+    }
+
+    // Merge the sorted batch into the index instead of resorting the whole directory
+    std::sort(newKeys.begin(), newKeys.end(), IndexKeyLessThan());
+    int oldSize = prefixIndex.size();
+    prefixIndex += newKeys;
+    std::inplace_merge(prefixIndex.begin(), prefixIndex.begin() + oldSize,
+            prefixIndex.end(), IndexKeyLessThan());
+}
+
 /**
  * \class RoomListChannel
  * \ingroup clientchannel
@@ -51,14 +226,29 @@ RoomListChannel::Private::~Private()
  *
  * \brief The RoomListChannel class represents a Telepathy Channel of type RoomList.
  *
- * Note that this subclass of Channel will eventually provide a high-level API for the
- * RoomList interface. Until then, it's just a Channel.
+ * Once RoomListChannel::FeatureCore is ready, the rooms signalled by the service are
+ * accumulated into a room directory, which can be queried with rooms(), roomsWithPrefix()
+ * and room() while the listing is still in progress. Rooms signalled more than once are
+ * stored only once, keyed by their handle name.
  *
  * For more details, please refer to \telepathy_spec.
  *
  * See \ref async_model, \ref shared_ptr
  */
 
+/**
+ * Feature representing the core that needs to become ready to make the
+ * RoomListChannel object usable.
+ *
+ * Note that this feature must be enabled in order to use most
+ * RoomListChannel methods.
+ * See specific methods documentation for more details.
+ *
+ * This feature is not enabled by default, as it costs an extra D-Bus round trip,
+ * and has to be requested explicitly with becomeReady() or through the channel factory.
+ */
+const Feature RoomListChannel::FeatureCore = Feature(QLatin1String(RoomListChannel::staticMetaObject.className()), 0);
+
 /**
  * Create a new RoomListChannel object.
  *
@@ -84,14 +274,14 @@ RoomListChannelPtr RoomListChannel::create(const ConnectionPtr &connection,
  * \param objectPath The channel object path.
  * \param immutableProperties The channel immutable properties.
  * \param coreFeature The core feature of the channel type, if any. The corresponding introspectable should
- *                    should depend on Channel::FeatureCore.
+ *                    depend on RoomListChannel::FeatureCore.
  */
 RoomListChannel::RoomListChannel(const ConnectionPtr &connection,
         const QString &objectPath,
         const QVariantMap &immutableProperties,
         const Feature &coreFeature)
     : Channel(connection, objectPath, immutableProperties, coreFeature),
-      mPriv(new Private())
+      mPriv(new Private(this, immutableProperties))
 {
 }
 
@@ -103,4 +293,263 @@ RoomListChannel::~RoomListChannel()
     delete mPriv;
 }
 
+/**
+ * Return the DNS name of the server whose rooms are listed by this channel.
+ *
+ * This method requires RoomListChannel::FeatureCore to be ready.
+ *
+ * \return For protocols with a concept of chatrooms on multiple servers with different DNS
+ *         names (like XMPP), the DNS name of the server, e.g. "conference.jabber.org".
+ *         Otherwise, an empty string.
+ */
+QString RoomListChannel::server() const
+{
+    return mPriv->server;
+}
+
+/**
+ * Return whether a room listing is currently in progress.
+ *
+ * Change notification is via the listingRoomsChanged() signal.
+ *
+ * This method requires RoomListChannel::FeatureCore to be ready.
+ *
+ * \return \c true if the service is listing rooms, \c false otherwise.
+ * \sa listRooms(), stopListing()
+ */
+bool RoomListChannel::isListingRooms() const
+{
+    return mPriv->listingRooms;
+}
+
+/**
+ * Request that the service lists the rooms available on the server.
+ *
+ * Rooms are signalled by roomsReceived() as they arrive and accumulated into the
+ * room directory.
+ *
+ * This method requires RoomListChannel::FeatureCore to be ready.
+ *
+ * \return A PendingOperation which will emit PendingOperation::finished
+ *         when the call has finished.
+ * \sa isListingRooms(), stopListing()
+ */
+PendingOperation *RoomListChannel::listRooms()
+{
+    if (!isReady(FeatureCore)) {
+        return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
+                QLatin1String("Channel not ready"),
+                RoomListChannelPtr(this));
+    }
+
+    return new PendingVoid(mPriv->roomListInterface->ListRooms(),
+            RoomListChannelPtr(this));
+}
+
+/**
+ * Stop the current room listing.
+ *
+ * Rooms received so far are kept in the room directory.
+ *
+ * This method requires RoomListChannel::FeatureCore to be ready.
+ *
+ * \return A PendingOperation which will emit PendingOperation::finished
+ *         when the call has finished.
+ * \sa isListingRooms(), listRooms()
+ */
+PendingOperation *RoomListChannel::stopListing()
+{
+    if (!isReady(FeatureCore)) {
+        return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
+                QLatin1String("Channel not ready"),
+                RoomListChannelPtr(this));
+    }
+
+    return new PendingVoid(mPriv->roomListInterface->StopListing(),
+            RoomListChannelPtr(this));
+}
+
+/**
+ * Return the number of distinct rooms received so far.
+ *
+ * This method requires RoomListChannel::FeatureCore to be ready.
+ *
+ * \return The number of rooms in the room directory.
+ * \sa rooms()
+ */
+int RoomListChannel::roomCount() const
+{
+    return mPriv->rooms.size();
+}
+
+/**
+ * Return a page of the rooms received so far, in the order they were first signalled.
+ *
+ * This method requires RoomListChannel::FeatureCore to be ready.
+ *
+ * \param offset The index of the first room to return.
+ * \param limit The maximum number of rooms to return, or -1 to return all remaining rooms.
+ * \return A list of rooms.
+ * \sa roomCount(), roomsWithPrefix()
+ */
+RoomInfoList RoomListChannel::rooms(int offset, int limit) const
+{
+    if (offset <= 0 && limit < 0) {
+        return mPriv->rooms;
+    }
+    return mPriv->rooms.mid(offset, limit);
+}
+
+/**
+ * Return a page of the rooms received so far whose handle name or name starts with \a prefix.
+ *
+ * The comparison is case-insensitive and results are ordered by the matching key. This
+ * method uses an incrementally maintained index and can be called while the listing is still
+ * in progress.
+ *
+ * This method requires RoomListChannel::FeatureCore to be ready.
+ *
+ * \param prefix The prefix to search for.
+ * \param offset The number of matching rooms to skip.
+ * \param limit The maximum number of rooms to return, or -1 to return all remaining matches.
+ * \return A list of rooms.
+ * \sa rooms(), room()
+ */
+RoomInfoList RoomListChannel::roomsWithPrefix(const QString &prefix, int offset, int limit) const
+{
+    RoomInfoList ret;
+    QString key = prefix.toCaseFolded();
+    QSet<int> seen;
+
+    QVector<QPair<QString, int> >::const_iterator it = std::lower_bound(
+            mPriv->prefixIndex.constBegin(), mPriv->prefixIndex.constEnd(), key,
+            Private::IndexKeyLessThan());
+    for (; it != mPriv->prefixIndex.constEnd() && it->first.startsWith(key); ++it) {
+        if (limit >= 0 && ret.size() >= limit) {
+            break;
+        }
+        if (seen.contains(it->second)) {
+            continue;
+        }
+        seen.insert(it->second);
+        if (offset > 0) {
+            --offset;
+            continue;
+        }
+        ret.append(mPriv->rooms.at(it->second));
+    }
+    return ret;
+}
+
+/**
+ * Return whether a room with the given handle name has been received.
+ *
+ * This method requires RoomListChannel::FeatureCore to be ready.
+ *
+ * \param handleName The identifier of the room, as in the "handle-name" room information key.
+ * \return \c true if the room is in the room directory, \c false otherwise.
+ * \sa room()
+ */
+bool RoomListChannel::hasRoom(const QString &handleName) const
+{
+    return mPriv->roomIndexByHandleName.contains(handleName);
+}
+
+/**
+ * Return the room with the given handle name.
+ *
+ * This method requires RoomListChannel::FeatureCore to be ready.
+ *
+ * \param handleName The identifier of the room, as in the "handle-name" room information key.
+ * \return The room information, or a default constructed RoomInfo if no such room was received.
+ * \sa hasRoom()
+ */
+RoomInfo RoomListChannel::room(const QString &handleName) const
+{
+    int index = mPriv->roomIndexByHandleName.value(handleName, -1);
+    if (index < 0) {
+        return RoomInfo();
+    }
+    return mPriv->rooms.at(index);
+}
+
+void RoomListChannel::gotServer(PendingOperation *op)
+{
+    if (op->isError()) {
+        tpWarning(logChannels).nospace() <<
+            "RoomListInterface::requestPropertyServer() failed with " <<
+            op->errorName() << ": " << op->errorMessage();
+        mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
+                op->errorName(), op->errorMessage());
+        return;
+    }
+
+    tpDebug(logChannels) << "Got reply to RoomListInterface::requestPropertyServer()";
+    PendingVariant *pv = qobject_cast<PendingVariant*>(op);
+    mPriv->server = qdbus_cast<QString>(pv->result());
+    mPriv->introspectListingRooms();
+}
+
+void RoomListChannel::gotListingRooms(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<bool> reply = *watcher;
+
+    if (!reply.isError()) {
+        mPriv->listingRooms = reply.value();
+
+        tpDebug(logChannels) << "Got reply to RoomList::GetListingRooms()";
+        mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, true);
+    } else {
+        tpWarning(logChannels).nospace() << "RoomList::GetListingRooms() failed "
+            "with " << reply.error().name() << ": " << reply.error().message();
+        mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
+                reply.error());
+    }
+
+    watcher->deleteLater();
+}
+
+void RoomListChannel::onGotRooms(const RoomInfoList &rooms)
+{
+    RoomInfoList changedRooms;
+    mPriv->addRooms(rooms, &changedRooms);
+
+    tpDebug(logChannels) << "Got" << rooms.size() << "rooms," << changedRooms.size() <<
+        "new or changed";
+    if (!changedRooms.isEmpty()) {
+        emit roomsReceived(changedRooms);
+    }
+}
+
+void RoomListChannel::onListingRooms(bool listing)
+{
+    if (mPriv->listingRooms == listing) {
+        return;
+    }
+
+    mPriv->listingRooms = listing;
+    emit listingRoomsChanged(listing);
+}
+
+/**
+ * \fn void RoomListChannel::listingRoomsChanged(bool listing)
+ *
+ * Emitted when the value of isListingRooms() changes.
+ *
+ * \param listing Whether a room listing is in progress.
+ * \sa isListingRooms()
+ */
+
+/**
+ * \fn void RoomListChannel::roomsReceived(const Tp::RoomInfoList &rooms)
+ *
+ * Emitted when rooms are added to or updated in the room directory. It can be emitted
+ * multiple times while isListingRooms() is \c true.
+ *
+ * Rooms signalled again by the service with unchanged information are not included.
+ *
+ * \param rooms The new or changed rooms.
+ * \sa rooms(), roomsWithPrefix()
+ */
+
 } // Tp
@@ -28,6 +28,7 @@
 #endif
 
 #include <TelepathyQt/Channel>
+#include <TelepathyQt/Types>
 
 namespace Tp
 {
@@ -38,16 +39,40 @@ class TP_QT_EXPORT RoomListChannel : public Channel
     Q_DISABLE_COPY(RoomListChannel)
 
 public:
+    static const Feature FeatureCore;
+
     static RoomListChannelPtr create(const ConnectionPtr &connection,
             const QString &objectPath, const QVariantMap &immutableProperties);
 
     virtual ~RoomListChannel();
 
+    QString server() const;
+    bool isListingRooms() const;
+
+    PendingOperation *listRooms();
+    PendingOperation *stopListing();
+
+    int roomCount() const;
+    RoomInfoList rooms(int offset = 0, int limit = -1) const;
+    RoomInfoList roomsWithPrefix(const QString &prefix, int offset = 0, int limit = -1) const;
+    bool hasRoom(const QString &handleName) const;
+    RoomInfo room(const QString &handleName) const;
+
+Q_SIGNALS:
+    void listingRoomsChanged(bool listing);
+    void roomsReceived(const Tp::RoomInfoList &rooms);
+
 protected:
     RoomListChannel(const ConnectionPtr &connection, const QString &objectPath,
             const QVariantMap &immutableProperties,
             const Feature &coreFeature = Channel::FeatureCore);
 
+private Q_SLOTS:
+    TP_QT_NO_EXPORT void gotServer(Tp::PendingOperation *op);
+    TP_QT_NO_EXPORT void gotListingRooms(QDBusPendingCallWatcher *watcher);
+    TP_QT_NO_EXPORT void onGotRooms(const Tp::RoomInfoList &rooms);
+    TP_QT_NO_EXPORT void onListingRooms(bool listing);
+
 private:
     struct Private;
     friend struct Private;
@@ -66,7 +66,7 @@ Features Room::actualFeatures() const
 bool Room::moderated() const
 {
     if (!mPriv->m_actualFeatures.contains(FeatureRoomConfig)) {
-        warning() << "Room::moderated() used on" << this
+        tpWarning(logChannels) << "Room::moderated() used on" << this
             << "for which FeatureRoomConfig is not available (yet)";
         return false;
     }
@@ -77,7 +77,7 @@ bool Room::moderated() const
 QString Room::title() const
 {
     if (!mPriv->m_actualFeatures.contains(FeatureRoomConfig)) {
-        warning() << "Room::title() used on" << this
+        tpWarning(logChannels) << "Room::title() used on" << this
             << "for which FeatureRoomConfig is not available (yet)";
         return QString();
     }
@@ -108,7 +108,8 @@ void Room::updateRoomConfigProperties(const QVariantMap &changedProperties)
                 emit titleChanged(newTitle);
             }
         } else {
-            warning() << "Room::updateRoomConfigProperties(): Unhandled key" << key << "with value" << changedProperties.value(key);
+            tpWarning(logChannels) << "Room::updateRoomConfigProperties(): Unhandled key" << key <<
+                "with value" << changedProperties.value(key);
         }
     }
 }
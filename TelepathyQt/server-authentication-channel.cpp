@@ -165,7 +165,8 @@ ServerAuthenticationChannel::~ServerAuthenticationChannel()
 bool ServerAuthenticationChannel::hasCaptchaInterface() const
 {
     if (!isReady(ServerAuthenticationChannel::FeatureCore)) {
-        warning() << "ServerAuthenticationChannel::hasCaptchaInterface() used with FeatureCore not ready";
+        tpWarning(logChannels) <<
+            "ServerAuthenticationChannel::hasCaptchaInterface() used with FeatureCore not ready";
         return false;
     }
 
@@ -183,7 +184,8 @@ bool ServerAuthenticationChannel::hasCaptchaInterface() const
 bool ServerAuthenticationChannel::hasSaslInterface() const
 {
     if (!isReady(ServerAuthenticationChannel::FeatureCore)) {
-        warning() << "ServerAuthenticationChannel::hasSaslInterface() used with FeatureCore not ready";
+        tpWarning(logChannels) <<
+            "ServerAuthenticationChannel::hasSaslInterface() used with FeatureCore not ready";
         return false;
     }
 
@@ -207,7 +209,8 @@ bool ServerAuthenticationChannel::hasSaslInterface() const
 CaptchaAuthenticationPtr ServerAuthenticationChannel::captchaAuthentication() const
 {
     if (!isReady(ServerAuthenticationChannel::FeatureCore)) {
-        warning() << "ServerAuthenticationChannel::captchaAuthentication() used with FeatureCore not ready";
+        tpWarning(logChannels) <<
+            "ServerAuthenticationChannel::captchaAuthentication() used with FeatureCore not ready";
         return CaptchaAuthenticationPtr();
     }
 
@@ -221,10 +224,10 @@ void ServerAuthenticationChannel::gotCaptchaAuthenticationProperties(Tp::Pending
 
         mPriv->captchaAuthentication->mPriv->extractCaptchaAuthenticationProperties(pvm->result());
 
-        debug() << "Got reply to Properties::GetAll(CaptchaAuthentication)";
+        tpDebug(logChannels) << "Got reply to Properties::GetAll(CaptchaAuthentication)";
         mPriv->readinessHelper->setIntrospectCompleted(ServerAuthenticationChannel::FeatureCore, true);
     } else {
-        warning().nospace() << "Properties::GetAll(CaptchaAuthentication) failed "
+        tpWarning(logChannels).nospace() << "Properties::GetAll(CaptchaAuthentication) failed "
             "with " << op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(ServerAuthenticationChannel::FeatureCore, false,
                 op->errorName(), op->errorMessage());
@@ -236,7 +239,7 @@ void ServerAuthenticationChannel::gotServerAuthenticationProperties(Tp::PendingO
     if (!op->isError()) {
         PendingVariantMap *pvm = qobject_cast<PendingVariantMap *>(op);
 
-        debug() << "Got reply to Properties::GetAll(ServerAuthentication)";
+        tpDebug(logChannels) << "Got reply to Properties::GetAll(ServerAuthentication)";
         mPriv->authMethod = qdbus_cast<QString>(pvm->result()[QLatin1String("AuthenticationMethod")]);
 
         if (mPriv->authMethod == TP_QT_IFACE_CHANNEL_INTERFACE_CAPTCHA_AUTHENTICATION) {
@@ -262,7 +265,7 @@ void ServerAuthenticationChannel::gotServerAuthenticationProperties(Tp::PendingO
             mPriv->readinessHelper->setIntrospectCompleted(ServerAuthenticationChannel::FeatureCore, true);
         }
     } else {
-        warning().nospace() << "Properties::GetAll(ServerAuthentication) failed "
+        tpWarning(logChannels).nospace() << "Properties::GetAll(ServerAuthentication) failed "
             "with " << op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(ServerAuthenticationChannel::FeatureCore, false,
                 op->errorName(), op->errorMessage());
@@ -0,0 +1,184 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2026 agent <agent@local>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "TelepathyQt/shared-data-registry-internal.h"
+
+#include "TelepathyQt/debug-internal.h"
+#include "TelepathyQt/manager-file.h"
+#include "TelepathyQt/test-backdoors.h"
+
+#include <TelepathyQt/ConnectionManager>
+#include <TelepathyQt/Profile>
+
+#include <QFileInfo>
+
+namespace Tp
+{
+
+SharedDataRegistry::Entry::Entry(const QString &fileName)
+    : fileName(fileName)
+{
+    if (!fileName.isEmpty()) {
+        lastModified = QFileInfo(fileName).lastModified();
+    }
+    lastChecked.start();
+}
+
+bool SharedDataRegistry::Entry::needsRecheck(int recheckInterval) const
+{
+    return lastChecked.elapsed() >= recheckInterval;
+}
+
+bool SharedDataRegistry::Entry::isStale(const QString &currentFileName)
+{
+    lastChecked.restart();
+
+    if (currentFileName != fileName) {
+        return true;
+    }
+
+    if (fileName.isEmpty()) {
+        return false;
+    }
+
+    QFileInfo fi(fileName);
+    return !fi.exists() || fi.lastModified() != lastModified;
+}
+
+SharedDataRegistry *SharedDataRegistry::mInstance = 0;
+
+SharedDataRegistry *SharedDataRegistry::instance()
+{
+    if (!mInstance) {
+        mInstance = new SharedDataRegistry();
+    }
+    return mInstance;
+}
+
+SharedDataRegistry::SharedDataRegistry(int recheckInterval)
+    : mRecheckInterval(recheckInterval)
+{
+}
+
+SharedDataRegistry::~SharedDataRegistry()
+{
+    if (mInstance == this) {
+        mInstance = 0;
+    }
+}
+
+int SharedDataRegistry::size() const
+{
+    return mConnectionManagers.size() + mProfiles.size();
+}
+
+template<class T>
+void SharedDataRegistry::pruneExpired(QHash<QString, TypedEntry<T> > &entries)
+{
+    typename QHash<QString, TypedEntry<T> >::iterator i = entries.begin();
+    while (i != entries.end()) {
+        if (SharedPtr<T>(i->object).isNull()) {
+            i = entries.erase(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+ConnectionManagerPtr SharedDataRegistry::connectionManager(const QDBusConnection &bus,
+        const QString &cmName,
+        const ConnectionFactoryConstPtr &connFactory,
+        const ChannelFactoryConstPtr &chanFactory,
+        const ContactFactoryConstPtr &contactFactory)
+{
+    // CMs built with different factories would construct different objects, don't mix them
+    QString key = QString(QLatin1String("%1/%2/%3/%4/%5"))
+        .arg(bus.name())
+        .arg(cmName)
+        .arg((quintptr) connFactory.data(), 0, 16)
+        .arg((quintptr) chanFactory.data(), 0, 16)
+        .arg((quintptr) contactFactory.data(), 0, 16);
+
+    pruneExpired(mConnectionManagers);
+
+    QHash<QString, TypedEntry<ConnectionManager> >::iterator i = mConnectionManagers.find(key);
+    if (i != mConnectionManagers.end()) {
+        // Finding the .manager file means looking through all the config dirs, only do it
+        // once the cached modification time is due for a recheck
+        if (!i->needsRecheck(mRecheckInterval) ||
+                !i->isStale(ManagerFile::fileNameForCM(cmName))) {
+            tpDebug(logGeneral) << "Sharing connection manager" << cmName;
+            return ConnectionManagerPtr(i->object);
+        }
+        mConnectionManagers.erase(i);
+    }
+
+    ConnectionManagerPtr cm = ConnectionManager::create(bus, cmName,
+            connFactory, chanFactory, contactFactory);
+    mConnectionManagers.insert(key,
+            TypedEntry<ConnectionManager>(cm, ManagerFile::fileNameForCM(cmName)));
+    return cm;
+}
+
+ProfilePtr SharedDataRegistry::profile(const QString &serviceName)
+{
+    pruneExpired(mProfiles);
+
+    QHash<QString, TypedEntry<Profile> >::iterator i = mProfiles.find(serviceName);
+    if (i != mProfiles.end()) {
+        ProfilePtr profile = ProfilePtr(i->object);
+        if (!i->needsRecheck(mRecheckInterval) || !i->isStale(profile->fileName())) {
+            tpDebug(logGeneral) << "Sharing profile for service" << serviceName;
+            return profile;
+        }
+        mProfiles.erase(i);
+    }
+
+    ProfilePtr profile = Profile::createForServiceName(serviceName);
+    // Services without a .profile file may get one installed later on, only remember found ones
+    if (profile->isValid()) {
+        mProfiles.insert(serviceName, TypedEntry<Profile>(profile, profile->fileName()));
+    }
+    return profile;
+}
+
+SharedDataRegistry *TestBackdoors::createSharedDataRegistry(int recheckInterval)
+{
+    return new SharedDataRegistry(recheckInterval);
+}
+
+void TestBackdoors::destroySharedDataRegistry(SharedDataRegistry *registry)
+{
+    delete registry;
+}
+
+ProfilePtr TestBackdoors::sharedDataRegistryProfile(SharedDataRegistry *registry,
+        const QString &serviceName)
+{
+    return registry->profile(serviceName);
+}
+
+int TestBackdoors::sharedDataRegistrySize(SharedDataRegistry *registry)
+{
+    return registry->size();
+}
+
+} // Tp
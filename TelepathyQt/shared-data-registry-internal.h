@@ -0,0 +1,112 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2026 agent <agent@local>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _TelepathyQt_shared_data_registry_internal_h_HEADER_GUARD_
+#define _TelepathyQt_shared_data_registry_internal_h_HEADER_GUARD_
+
+#include <TelepathyQt/ChannelFactory>
+#include <TelepathyQt/ConnectionFactory>
+#include <TelepathyQt/ContactFactory>
+#include <TelepathyQt/Types>
+
+#include <QDateTime>
+#include <QDBusConnection>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+
+namespace Tp
+{
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+// Process-wide registry handing out the same ConnectionManager and Profile objects to all the
+// accounts using them, so that .manager and .profile files are only parsed once. Entries are
+// only weakly referenced and are dropped when the file they were read from changes. The
+// modification time read when an entry was added is trusted for recheckInterval milliseconds,
+// so that looking up a shared object does not hit the file system every time.
+class TP_QT_NO_EXPORT SharedDataRegistry
+{
+    Q_DISABLE_COPY(SharedDataRegistry)
+
+public:
+    enum { DefaultRecheckInterval = 5000 };
+
+    static SharedDataRegistry *instance();
+
+    SharedDataRegistry(int recheckInterval = DefaultRecheckInterval);
+    ~SharedDataRegistry();
+
+    int size() const;
+
+    ConnectionManagerPtr connectionManager(const QDBusConnection &bus, const QString &cmName,
+            const ConnectionFactoryConstPtr &connFactory,
+            const ChannelFactoryConstPtr &chanFactory,
+            const ContactFactoryConstPtr &contactFactory);
+    ProfilePtr profile(const QString &serviceName);
+
+private:
+    struct Entry
+    {
+        Entry()
+        {
+        }
+
+        Entry(const QString &fileName);
+
+        bool needsRecheck(int recheckInterval) const;
+        bool isStale(const QString &currentFileName);
+
+        QString fileName;
+        QDateTime lastModified;
+        QElapsedTimer lastChecked;
+    };
+
+    template<class T>
+    struct TypedEntry : public Entry
+    {
+        TypedEntry()
+        {
+        }
+
+        TypedEntry(const SharedPtr<T> &object, const QString &fileName)
+            : Entry(fileName),
+              object(object)
+        {
+        }
+
+        WeakPtr<T> object;
+    };
+
+    template<class T>
+    static void pruneExpired(QHash<QString, TypedEntry<T> > &entries);
+
+    static SharedDataRegistry *mInstance;
+    int mRecheckInterval;
+    QHash<QString, TypedEntry<ConnectionManager> > mConnectionManagers;
+    QHash<QString, TypedEntry<Profile> > mProfiles;
+};
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+} // Tp
+
+#endif
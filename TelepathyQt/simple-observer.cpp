@@ -78,16 +78,16 @@ SimpleObserver::Private::Private(SimpleObserver *parent,
         observer = SharedPtr<Observer>(new Observer(cr, fakeAccountFactory,
                     normalizedChannelFilter.toList(), observerName));
         if (!cr->registerClient(observer, observerName, false)) {
-            warning() << "Unable to register observer" << observerName;
+            tpWarning(logClients) << "Unable to register observer" << observerName;
             observer.reset();
             cr.reset();
             return;
         }
 
-        debug() << "Observer" << observerName << "registered";
+        tpDebug(logClients) << "Observer" << observerName << "registered";
         observers.insert(observerUniqueId, observer);
     } else {
-        debug() << "Observer" << observer->observerName() <<
+        tpDebug(logClients) << "Observer" << observer->observerName() <<
             "already registered and matches filter, using it";
         cr = ClientRegistrarPtr(observer->clientRegistrar());
     }
@@ -234,7 +234,7 @@ void SimpleObserver::Private::Observer::observeChannels(
 
         // this shouldn't happen, but in any case
         if (!channel->isValid()) {
-            warning() << "Channel received to observe is invalid. "
+            tpWarning(logClients) << "Channel received to observe is invalid. "
                 "Ignoring channel";
             continue;
         }
@@ -477,7 +477,7 @@ SimpleObserver::SimpleObserver(const AccountPtr &account,
         }
 
         if (requiresNormalization) {
-            debug() << "Contact id requires normalization. "
+            tpDebug(logClients) << "Contact id requires normalization. "
                 "Queueing events until it is normalized";
             onAccountConnectionChanged(account->connection());
         }
@@ -561,7 +561,7 @@ void SimpleObserver::onAccountConnectionConnected()
         return;
     }
 
-    debug() << "Normalizing contact id" << mPriv->contactIdentifier;
+    tpDebug(logClients) << "Normalizing contact id" << mPriv->contactIdentifier;
     ContactManagerPtr contactManager = conn->contactManager();
     connect(contactManager->contactsForIdentifiers(QStringList() << mPriv->contactIdentifier),
             SIGNAL(finished(Tp::PendingOperation*)),
@@ -572,7 +572,7 @@ void SimpleObserver::onContactConstructed(Tp::PendingOperation *op)
 {
     if (op->isError()) {
         // what should we do here? retry? wait for a new connection?
-        warning() << "Normalizing contact id failed with" <<
+        tpWarning(logClients) << "Normalizing contact id failed with" <<
             op->errorName() << " : " << op->errorMessage();
         return;
     }
@@ -580,13 +580,13 @@ void SimpleObserver::onContactConstructed(Tp::PendingOperation *op)
     PendingContacts *pc = qobject_cast<PendingContacts*>(op);
     Q_ASSERT((pc->contacts().size() + pc->invalidIdentifiers().size()) == 1);
     if (!pc->invalidIdentifiers().isEmpty()) {
-        warning() << "Normalizing contact id failed with invalid id" <<
+        tpWarning(logClients) << "Normalizing contact id failed with invalid id" <<
             mPriv->contactIdentifier;
         return;
     }
 
     ContactPtr contact = pc->contacts().first();
-    debug() << "Contact id" << mPriv->contactIdentifier <<
+    tpDebug(logClients) << "Contact id" << mPriv->contactIdentifier <<
         "normalized to" << contact->id();
     mPriv->normalizedContactIdentifier = contact->id();
     mPriv->processChannelsQueue();
@@ -94,7 +94,7 @@ SimpleStreamTubeHandler::SimpleStreamTubeHandler(
 SimpleStreamTubeHandler::~SimpleStreamTubeHandler()
 {
     if (!mTubes.empty()) {
-        debug() << "~SSTubeHandler(): Closing" << mTubes.size() << "leftover tubes";
+        tpDebug(logTubes) << "~SSTubeHandler(): Closing" << mTubes.size() << "leftover tubes";
 
         foreach (const StreamTubeChannelPtr &tube, mTubes.keys()) {
             tube->requestClose();
@@ -111,7 +111,7 @@ void SimpleStreamTubeHandler::handleChannels(
         const QDateTime &userActionTime,
         const HandlerInfo &handlerInfo)
 {
-    debug() << "SimpleStreamTubeHandler::handleChannels() invoked for " <<
+    tpDebug(logTubes) << "SimpleStreamTubeHandler::handleChannels() invoked for " <<
         channels.size() << "channels on account" << account->objectPath();
 
     SharedPtr<InvocationData> invocation(new InvocationData());
@@ -127,10 +127,11 @@ void SimpleStreamTubeHandler::handleChannels(
                 chan->immutableProperties()[TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType")].toString();
 
             if (channelType != TP_QT_IFACE_CHANNEL_TYPE_STREAM_TUBE) {
-                debug() << "We got a non-StreamTube channel" << chan->objectPath() <<
+                tpDebug(logTubes) << "We got a non-StreamTube channel" << chan->objectPath() <<
                     "of type" << channelType << ", ignoring";
             } else {
-                warning() << "The channel factory used for a simple StreamTube handler must" <<
+                tpWarning(logTubes) <<
+                    "The channel factory used for a simple StreamTube handler must" <<
                     "construct StreamTubeChannel subclasses for stream tubes";
             }
             continue;
@@ -156,7 +157,8 @@ void SimpleStreamTubeHandler::handleChannels(
     mInvocations.append(invocation);
 
     if (invocation->tubes.isEmpty()) {
-        warning() << "SSTH::HandleChannels got no suitable channels, admitting we're Confused";
+        tpWarning(logTubes) <<
+            "SSTH::HandleChannels got no suitable channels, admitting we're Confused";
         invocation->readyOp = 0;
         invocation->error = TP_QT_ERROR_CONFUSED;
         invocation->message = QLatin1String("Got no suitable channels");
@@ -183,7 +185,8 @@ void SimpleStreamTubeHandler::onReadyOpFinished(Tp::PendingOperation *op)
         (*i)->readyOp = 0;
 
         if (op->isError()) {
-            warning() << "Preparing proxies for SSTubeHandler failed with" << op->errorName()
+            tpWarning(logTubes) <<
+                "Preparing proxies for SSTubeHandler failed with" << op->errorName()
                 << op->errorMessage();
             (*i)->error = op->errorName();
             (*i)->message = op->errorMessage();
@@ -202,12 +205,13 @@ void SimpleStreamTubeHandler::onReadyOpFinished(Tp::PendingOperation *op)
             continue;
         }
 
-        debug() << "Emitting SSTubeHandler::invokedForTube for" << invocation->tubes.size()
+        tpDebug(logTubes) <<
+            "Emitting SSTubeHandler::invokedForTube for" << invocation->tubes.size()
             << "tubes";
 
         foreach (const StreamTubeChannelPtr &tube, invocation->tubes) {
             if (!tube->isValid()) {
-                debug() << "Skipping already invalidated tube" << tube->objectPath();
+                tpDebug(logTubes) << "Skipping already invalidated tube" << tube->objectPath();
                 continue;
             }
 
@@ -238,7 +242,8 @@ void SimpleStreamTubeHandler::onTubeInvalidated(DBusProxy *proxy,
     Q_ASSERT(!tube.isNull());
     Q_ASSERT(mTubes.contains(tube));
 
-    debug() << "Tube" << tube->objectPath() << "invalidated - " << errorName << ':' << errorMessage;
+    tpDebug(logTubes) << "Tube" << tube->objectPath() << "invalidated - " << errorName << ':' <<
+        errorMessage;
 
     AccountPtr acc = mTubes.value(tube);
     mTubes.remove(tube);
@@ -49,7 +49,7 @@ SimpleTextObserver::Private::Private(SimpleTextObserver *parent,
       account(account),
       contactIdentifier(contactIdentifier)
 {
-    debug() << "Creating a new SimpleTextObserver";
+    tpDebug(logClients) << "Creating a new SimpleTextObserver";
     ChannelClassSpec channelFilter = ChannelClassSpec::textChat();
     observer = SimpleObserver::create(account, ChannelClassSpecList() << channelFilter,
             contactIdentifier, requiresNormalization,
@@ -229,10 +229,12 @@ void SimpleTextObserver::onNewChannels(const QList<ChannelPtr> &channels)
         TextChannelPtr textChannel = TextChannelPtr::qObjectCast(channel);
         if (!textChannel) {
             if (channel->channelType() != TP_QT_IFACE_CHANNEL_TYPE_TEXT) {
-                warning() << "Channel received to observe is not of type Text, service confused. "
+                tpWarning(logClients) <<
+                    "Channel received to observe is not of type Text, service confused. "
                     "Ignoring channel";
             } else {
-                warning() << "Channel received to observe is not a subclass of TextChannel. "
+                tpWarning(logClients) <<
+                    "Channel received to observe is not a subclass of TextChannel. "
                     "ChannelFactory set on this observer's account must construct TextChannel "
                     "subclasses for channels of type Text. Ignoring channel";
             }
@@ -28,6 +28,8 @@
 namespace Tp
 {
 
+class StreamTubeConnector;
+
 class TP_QT_NO_EXPORT StreamTubeClient::TubeWrapper :
                 public QObject
 {
@@ -45,17 +47,25 @@ public:
     IncomingStreamTubeChannelPtr mTube;
     QHostAddress mSourceAddress;
     quint16 mSourcePort;
+    StreamTubeConnector *mConnector;
+
+    void startConnector(PendingStreamTubeConnection *conn, uint poolSize);
 
 Q_SIGNALS:
     void acceptFinished(TubeWrapper *wrapper, Tp::PendingStreamTubeConnection *conn);
     void newConnection(TubeWrapper *wrapper, uint conn);
     void connectionClosed(TubeWrapper *wrapper, uint conn, const QString &error,
             const QString &message);
+    void localConnectionReady(TubeWrapper *wrapper, int socketDescriptor);
+    void localConnectionFailed(TubeWrapper *wrapper, const QString &error,
+            const QString &message);
 
 private Q_SLOTS:
     void onTubeAccepted(Tp::PendingOperation *);
     void onNewConnection(uint);
     void onConnectionClosed(uint, const QString &, const QString &);
+    void onConnectorReady(int);
+    void onConnectorFailed(const QString &, const QString &);
 };
 
 } // Tp
@@ -28,6 +28,8 @@
 
 #include "TelepathyQt/debug-internal.h"
 #include "TelepathyQt/simple-stream-tube-handler.h"
+#include "TelepathyQt/stream-tube-connector-internal.h"
+#include "TelepathyQt/stream-tube-metrics-internal.h"
 
 #include <TelepathyQt/AccountManager>
 #include <TelepathyQt/ClientRegistrar>
@@ -96,6 +98,60 @@ namespace Tp
  * to it.
  */
 
+/**
+ * \class StreamTubeClient::LocalConnectionHandler
+ * \ingroup serverclient
+ * \headerfile TelepathyQt/stream-tube-client.h <TelepathyQt/StreamTubeClient>
+ *
+ * \brief The StreamTubeClient::LocalConnectionHandler abstract interface receives connections to
+ * tubes accepted as Unix sockets, already established by a StreamTubeClient connection pool.
+ *
+ * See StreamTubeClient::setLocalConnectionPool() for the details.
+ */
+
+/**
+ * \fn void StreamTubeClient::LocalConnectionHandler::handleLocalConnection(const AccountPtr &,
+ * const IncomingStreamTubeChannelPtr &, int)
+ *
+ * Called with a connection to the local endpoint of \a tube, as requested with
+ * StreamTubeClient::requestLocalConnection().
+ *
+ * The socket is connected, non-blocking and close-on-exec. If the tube requires credentials, they
+ * have already been sent. The socket is owned by the handler from this point on, and can be used
+ * e.g. with QLocalSocket::setSocketDescriptor().
+ *
+ * \param account The account from which the tube originates.
+ * \param tube The tube channel the connection has been made through.
+ * \param socketDescriptor The native socket descriptor of the connection.
+ */
+
+/**
+ * Called when a connection requested with StreamTubeClient::requestLocalConnection() could not be
+ * made.
+ *
+ * The default implementation does nothing.
+ *
+ * \param account The account from which the tube originates.
+ * \param tube The tube channel the connection was requested for.
+ * \param error The D-Bus error name corresponding to the reason for the failure.
+ * \param message A freeform debug message associated with the error.
+ */
+void StreamTubeClient::LocalConnectionHandler::localConnectionFailed(const AccountPtr &account,
+        const IncomingStreamTubeChannelPtr &tube, const QString &error, const QString &message)
+{
+    Q_UNUSED(account);
+    Q_UNUSED(tube);
+    Q_UNUSED(error);
+    Q_UNUSED(message);
+}
+
+/**
+ * \fn StreamTubeClient::LocalConnectionHandler::~LocalConnectionHandler
+ *
+ * Class destructor. Protected, because StreamTubeClient never deletes a LocalConnectionHandler
+ * passed to it.
+ */
+
 struct TP_QT_NO_EXPORT StreamTubeClient::Tube::Private : public QSharedData
 {
     // empty placeholder for now
@@ -204,7 +260,9 @@ struct TP_QT_NO_EXPORT StreamTubeClient::Private
           clientName(maybeClientName),
           isRegistered(false),
           acceptsAsTcp(false), acceptsAsUnix(false),
-          tcpGenerator(0), requireCredentials(false)
+          tcpGenerator(0), requireCredentials(false),
+          connectionHandler(0), connectionPoolSize(0),
+          metrics(0), metricsReportInterval(1000)
     {
         if (clientName.isEmpty()) {
             clientName = QString::fromLatin1("TpQtSTubeClient_%1_%2")
@@ -221,12 +279,12 @@ struct TP_QT_NO_EXPORT StreamTubeClient::Private
             return;
         }
 
-        debug() << "Register StreamTubeClient with name " << clientName;
+        tpDebug(logTubes) << "Register StreamTubeClient with name " << clientName;
 
         if (registrar->registerClient(handler, clientName)) {
             isRegistered = true;
         } else {
-            warning() << "StreamTubeClient" << clientName
+            tpWarning(logTubes) << "StreamTubeClient" << clientName
                 << "registration failed";
         }
     }
@@ -240,6 +298,12 @@ struct TP_QT_NO_EXPORT StreamTubeClient::Private
     TcpSourceAddressGenerator *tcpGenerator;
     bool requireCredentials;
 
+    LocalConnectionHandler *connectionHandler;
+    uint connectionPoolSize;
+
+    StreamTubeMetricsCollector *metrics;
+    int metricsReportInterval;
+
     QHash<StreamTubeChannelPtr, TubeWrapper *> tubes;
 };
 
@@ -249,7 +313,8 @@ StreamTubeClient::TubeWrapper::TubeWrapper(
         const QHostAddress &sourceAddress,
         quint16 sourcePort,
         StreamTubeClient *parent)
-    : QObject(parent), mAcc(acc), mTube(tube), mSourceAddress(sourceAddress), mSourcePort(sourcePort)
+    : QObject(parent), mAcc(acc), mTube(tube), mSourceAddress(sourceAddress), mSourcePort(sourcePort),
+      mConnector(0)
 {
     QHostAddress hostAddress = sourceAddress;
 
@@ -265,7 +330,7 @@ StreamTubeClient::TubeWrapper::TubeWrapper(
                     !tube->supportsIPv4SocketsWithSpecifiedAddress()) ||
                 (hostAddress.protocol() == QAbstractSocket::IPv6Protocol &&
                  !tube->supportsIPv6SocketsWithSpecifiedAddress())) {
-            debug() << "StreamTubeClient falling back to Localhost AC for tube" <<
+            tpDebug(logTubes) << "StreamTubeClient falling back to Localhost AC for tube" <<
                 tube->objectPath();
             mSourceAddress = sourceAddress.protocol() == QAbstractSocket::IPv4Protocol ?
                  QHostAddress::Any : QHostAddress::AnyIPv6;
@@ -289,10 +354,11 @@ StreamTubeClient::TubeWrapper::TubeWrapper(
         const IncomingStreamTubeChannelPtr &tube,
         bool requireCredentials,
         StreamTubeClient *parent)
-    : QObject(parent), mAcc(acc), mTube(tube), mSourcePort(0)
+    : QObject(parent), mAcc(acc), mTube(tube), mSourcePort(0), mConnector(0)
 {
     if (requireCredentials && !tube->supportsUnixSocketsWithCredentials()) {
-        debug() << "StreamTubeClient falling back to Localhost AC for tube" << tube->objectPath();
+        tpDebug(logTubes) << "StreamTubeClient falling back to Localhost AC for tube" <<
+            tube->objectPath();
         requireCredentials = false;
     }
 
@@ -323,6 +389,33 @@ void StreamTubeClient::TubeWrapper::onConnectionClosed(uint conn, const QString
     emit connectionClosed(this, conn, error, message);
 }
 
+void StreamTubeClient::TubeWrapper::startConnector(PendingStreamTubeConnection *conn,
+        uint poolSize)
+{
+    Q_ASSERT(mConnector == 0);
+
+    mConnector = new StreamTubeConnector(conn->localAddress(),
+            conn->addressType() == SocketAddressTypeAbstractUnix, conn->requiresCredentials(),
+            conn->credentialByte(), poolSize, this);
+    connect(mConnector,
+            SIGNAL(connectionReady(int)),
+            SLOT(onConnectorReady(int)));
+    connect(mConnector,
+            SIGNAL(connectionFailed(QString,QString)),
+            SLOT(onConnectorFailed(QString,QString)));
+}
+
+void StreamTubeClient::TubeWrapper::onConnectorReady(int socketDescriptor)
+{
+    emit localConnectionReady(this, socketDescriptor);
+}
+
+void StreamTubeClient::TubeWrapper::onConnectorFailed(const QString &error,
+        const QString &message)
+{
+    emit localConnectionFailed(this, error, message);
+}
+
 /**
  * \class StreamTubeClient
  * \ingroup serverclient
@@ -524,7 +617,8 @@ StreamTubeClientPtr StreamTubeClient::create(
         bool bypassApproval)
 {
     if (p2pServices.isEmpty() && roomServices.isEmpty()) {
-        warning() << "Tried to create a StreamTubeClient with no services, returning NULL";
+        tpWarning(logTubes) <<
+            "Tried to create a StreamTubeClient with no services, returning NULL";
         return StreamTubeClientPtr();
     }
 
@@ -647,7 +741,8 @@ bool StreamTubeClient::acceptsAsTcp() const
 StreamTubeClient::TcpSourceAddressGenerator *StreamTubeClient::tcpGenerator() const
 {
     if (!acceptsAsTcp()) {
-        warning() << "StreamTubeClient::tcpGenerator() used, but not accepting as TCP, returning 0";
+        tpWarning(logTubes) <<
+            "StreamTubeClient::tcpGenerator() used, but not accepting as TCP, returning 0";
         return 0;
     }
 
@@ -743,6 +838,92 @@ void StreamTubeClient::setToAcceptAsUnix(bool requireCredentials)
     mPriv->ensureRegistered();
 }
 
+/**
+ * Return the handler receiving the connections made by the local connection pool, if any.
+ *
+ * \return A pointer to the handler, or 0 if the local connection pool is disabled.
+ * \sa setLocalConnectionPool()
+ */
+StreamTubeClient::LocalConnectionHandler *StreamTubeClient::localConnectionHandler() const
+{
+    return mPriv->connectionHandler;
+}
+
+/**
+ * Return the number of connections the local connection pool keeps established for each tube.
+ *
+ * \return The pool size, or 0 if the local connection pool is disabled.
+ * \sa setLocalConnectionPool()
+ */
+uint StreamTubeClient::localConnectionPoolSize() const
+{
+    return mPriv->connectionPoolSize;
+}
+
+/**
+ * Set the client to make the connections to the local endpoints of tubes accepted as Unix sockets
+ * itself, keeping \a poolSize of them established ahead of time for each tube.
+ *
+ * Ordinarily, the application connects to the socket signaled by tubeAcceptedAsUnix() whenever it
+ * needs a connection, and then sends the credential byte if required, before it can start using the
+ * connection. With the pool, the client does this as soon as the tube has been accepted, and hands
+ * out the connections on demand with requestLocalConnection(). Connections are passed to the
+ * \a handler as plain socket descriptors, saving the setup round trips from the latency of each
+ * new connection. This suits protocols using many short-lived connections, such as RPC
+ * mechanisms.
+ *
+ * As far as the protocol backend and the remote service are concerned, each pooled connection is a
+ * real connection which is merely idle until used. Consequently, newConnection() is emitted when a
+ * connection enters the pool, rather than when it's handed out, and the remote service must be
+ * prepared to have up to \a poolSize idle connections open per tube. A \a poolSize of 0 makes the
+ * client connect only when requested, which still spares the application the handshake.
+ *
+ * The pool only affects the tubes accepted as Unix sockets after this call, see
+ * setToAcceptAsUnix(). tubeAcceptedAsUnix() is still emitted for them, and the application can
+ * keep making connections of its own as well. Passing a null \a handler disables the pool.
+ *
+ * The pool is only available on Unix platforms.
+ *
+ * \param handler A pointer to the handler to receive the connections, or 0 to disable the pool.
+ * \param poolSize The number of idle connections to keep established for each tube.
+ * \sa requestLocalConnection()
+ */
+void StreamTubeClient::setLocalConnectionPool(LocalConnectionHandler *handler, uint poolSize)
+{
+    if (handler && !StreamTubeConnector::isSupported()) {
+        tpWarning(logTubes) << "Local connection pools not supported on this platform, ignoring";
+        return;
+    }
+
+    mPriv->connectionHandler = handler;
+    mPriv->connectionPoolSize = handler ? poolSize : 0;
+}
+
+/**
+ * Request a connection to the local endpoint of the given \a tube from the local connection pool.
+ *
+ * If the pool has a connection ready, the handler set with setLocalConnectionPool() is given it
+ * before this method returns, and a new connection is made in the background to take its place.
+ * Otherwise, the handler is given the connection as soon as it has been made, or told about the
+ * failure to make it.
+ *
+ * \param tube The tube to connect through, as returned by tubes().
+ * \return \c true if the request was started, \c false if the tube isn't handled by this
+ * client, hasn't been accepted yet or was accepted without the local connection pool.
+ */
+bool StreamTubeClient::requestLocalConnection(const Tube &tube)
+{
+    TubeWrapper *wrapper = mPriv->tubes.value(tube.channel());
+    if (!wrapper || !wrapper->mConnector) {
+        tpWarning(logTubes) << "StreamTubeClient::requestLocalConnection() used for a tube"
+            << "which isn't pooled";
+        return false;
+    }
+
+    wrapper->mConnector->request();
+    return true;
+}
+
 /**
  * Return the tubes currently handled by the client.
  *
@@ -781,7 +962,8 @@ QHash<StreamTubeClient::Tube, QSet<uint> > StreamTubeClient::connections() const
 {
     QHash<Tube, QSet<uint> > conns;
     if (!monitorsConnections()) {
-        warning() << "StreamTubeClient::connections() used, but connection monitoring is disabled";
+        tpWarning(logTubes) <<
+            "StreamTubeClient::connections() used, but connection monitoring is disabled";
         return conns;
     }
 
@@ -802,6 +984,138 @@ QHash<StreamTubeClient::Tube, QSet<uint> > StreamTubeClient::connections() const
     return conns;
 }
 
+/**
+ * Return whether timing metrics are being collected for the tubes handled by this client.
+ *
+ * \return \c true if metrics are enabled, \c false otherwise.
+ * \sa setMetricsEnabled()
+ */
+bool StreamTubeClient::isMetricsEnabled() const
+{
+    return mPriv->metrics != 0;
+}
+
+/**
+ * Set whether timing metrics should be collected for the tubes handled by this client.
+ *
+ * When enabled, the client measures how long accepting the tubes offered to it takes, and, if
+ * connection monitoring was requested when creating the client, how long it takes for the
+ * application to make the first connection to an accepted tube's local socket and how long the
+ * connections stay open. The results can be polled with metrics() and connectionMetrics(), and
+ * are also reported periodically with metricsUpdated().
+ *
+ * Only the tubes offered after metrics are enabled are measured, and disabling metrics discards
+ * everything collected so far. While disabled, which is the default, metrics have no cost beyond a
+ * pointer check whenever a tube or connection changes.
+ *
+ * \param enabled Whether metrics should be collected.
+ * \sa StreamTubeMetrics
+ */
+void StreamTubeClient::setMetricsEnabled(bool enabled)
+{
+    if (enabled == isMetricsEnabled()) {
+        return;
+    }
+
+    if (!enabled) {
+        delete mPriv->metrics;
+        mPriv->metrics = 0;
+        return;
+    }
+
+    mPriv->metrics = new StreamTubeMetricsCollector(this);
+    mPriv->metrics->setReportInterval(mPriv->metricsReportInterval);
+    connect(mPriv->metrics,
+            SIGNAL(reportDue(Tp::StreamTubeMetrics)),
+            SIGNAL(metricsUpdated(Tp::StreamTubeMetrics)));
+}
+
+/**
+ * Return the minimum interval between two metricsUpdated() signals.
+ *
+ * \return The interval in milliseconds, or 0 if the signal is disabled.
+ * \sa setMetricsReportInterval()
+ */
+int StreamTubeClient::metricsReportInterval() const
+{
+    return mPriv->metricsReportInterval;
+}
+
+/**
+ * Set the minimum interval between two metricsUpdated() signals.
+ *
+ * Changes are reported together at the end of the interval they happen in, one second by default.
+ * An interval of 0 disables the signal.
+ *
+ * \param msecs The interval in milliseconds.
+ */
+void StreamTubeClient::setMetricsReportInterval(int msecs)
+{
+    mPriv->metricsReportInterval = qMax(msecs, 0);
+    if (mPriv->metrics) {
+        mPriv->metrics->setReportInterval(mPriv->metricsReportInterval);
+    }
+}
+
+/**
+ * Return the metrics aggregated over all of the tubes offered to this client since metrics were
+ * enabled, including the ones which have since been closed.
+ *
+ * The data going through the tubes is never counted on the client side, so
+ * StreamTubeMetrics::hasByteCounts() is always \c false.
+ *
+ * \return The aggregate metrics, or an invalid StreamTubeMetrics if metrics are disabled.
+ * \sa isMetricsEnabled()
+ */
+StreamTubeMetrics StreamTubeClient::metrics() const
+{
+    if (!mPriv->metrics) {
+        tpWarning(logTubes) << "StreamTubeClient::metrics() used, but metrics are disabled";
+        return StreamTubeMetrics();
+    }
+
+    return mPriv->metrics->total();
+}
+
+/**
+ * Return the metrics of a single tube currently handled by this client.
+ *
+ * \param tube The tube, as returned by tubes().
+ * \return The metrics of the tube, or an invalid StreamTubeMetrics if metrics are disabled, or the
+ * tube isn't handled by this client or was offered before metrics were enabled.
+ */
+StreamTubeMetrics StreamTubeClient::metrics(const Tube &tube) const
+{
+    if (!mPriv->metrics) {
+        tpWarning(logTubes) << "StreamTubeClient::metrics() used, but metrics are disabled";
+        return StreamTubeMetrics();
+    }
+
+    return mPriv->metrics->forTube(tube.channel());
+}
+
+/**
+ * Return the metrics of a single connection currently open through a tube handled by this client.
+ *
+ * This requires connection monitoring to have been requested when creating the client.
+ *
+ * \param tube The tube, as returned by tubes().
+ * \param connectionId The ID of the connection, as signaled by newConnection().
+ * \return The metrics of the connection, or an invalid StreamTubeConnectionMetrics if metrics are
+ * disabled or the connection isn't known.
+ */
+StreamTubeConnectionMetrics StreamTubeClient::connectionMetrics(const Tube &tube,
+        uint connectionId) const
+{
+    if (!mPriv->metrics) {
+        tpWarning(logTubes) <<
+            "StreamTubeClient::connectionMetrics() used, but metrics are disabled";
+        return StreamTubeConnectionMetrics();
+    }
+
+    return mPriv->metrics->forConnection(tube.channel(), connectionId);
+}
+
 void StreamTubeClient::onInvokedForTube(
         const AccountPtr &acc,
         const StreamTubeChannelPtr &tube,
@@ -813,19 +1127,24 @@ void StreamTubeClient::onInvokedForTube(
     Q_ASSERT(tube->isValid()); // SSTH won't emit invalid tubes
 
     if (mPriv->tubes.contains(tube)) {
-        debug() << "Ignoring StreamTubeClient reinvocation for tube" << tube->objectPath();
+        tpDebug(logTubes) << "Ignoring StreamTubeClient reinvocation for tube" <<
+            tube->objectPath();
         return;
     }
 
     IncomingStreamTubeChannelPtr incoming = IncomingStreamTubeChannelPtr::qObjectCast(tube);
 
     if (!incoming) {
-        warning() << "The ChannelFactory used by StreamTubeClient must construct" <<
+        tpWarning(logTubes) << "The ChannelFactory used by StreamTubeClient must construct" <<
             "IncomingStreamTubeChannel subclasses for Requested=false StreamTubes";
         tube->requestClose();
         return;
     }
 
+    if (mPriv->metrics) {
+        mPriv->metrics->tubeHandled(incoming);
+    }
+
     TubeWrapper *wrapper = 0;
 
     if (mPriv->acceptsAsTcp) {
@@ -869,13 +1188,14 @@ void StreamTubeClient::onAcceptFinished(TubeWrapper *wrapper, PendingStreamTubeC
     Q_ASSERT(conn != NULL);
 
     if (!mPriv->tubes.contains(wrapper->mTube)) {
-        debug() << "StreamTubeClient ignoring Accept result for invalidated tube"
+        tpDebug(logTubes) << "StreamTubeClient ignoring Accept result for invalidated tube"
             << wrapper->mTube->objectPath();
         return;
     }
 
     if (conn->isError()) {
-        warning() << "StreamTubeClient couldn't accept tube" << wrapper->mTube->objectPath() << '-'
+        tpWarning(logTubes) <<
+            "StreamTubeClient couldn't accept tube" << wrapper->mTube->objectPath() << '-'
             << conn->errorName() << ':' << conn->errorMessage();
 
         if (wrapper->mTube->isValid()) {
@@ -883,13 +1203,20 @@ void StreamTubeClient::onAcceptFinished(TubeWrapper *wrapper, PendingStreamTubeC
         }
 
         wrapper->mTube->disconnect(this);
+        if (mPriv->metrics) {
+            mPriv->metrics->tubeClosed(wrapper->mTube);
+        }
         emit tubeClosed(wrapper->mAcc, wrapper->mTube, conn->errorName(), conn->errorMessage());
         mPriv->tubes.remove(wrapper->mTube);
         wrapper->deleteLater();
         return;
     }
 
-    debug() << "StreamTubeClient accepted tube" << wrapper->mTube->objectPath();
+    tpDebug(logTubes) << "StreamTubeClient accepted tube" << wrapper->mTube->objectPath();
+
+    if (mPriv->metrics) {
+        mPriv->metrics->tubeSetUp(wrapper->mTube);
+    }
 
     if (conn->addressType() == SocketAddressTypeIPv4
             || conn->addressType() == SocketAddressTypeIPv6) {
@@ -897,6 +1224,16 @@ void StreamTubeClient::onAcceptFinished(TubeWrapper *wrapper, PendingStreamTubeC
         emit tubeAcceptedAsTcp(addr.first, addr.second, wrapper->mSourceAddress,
                 wrapper->mSourcePort, wrapper->mAcc, wrapper->mTube);
     } else {
+        if (mPriv->connectionHandler) {
+            connect(wrapper,
+                    SIGNAL(localConnectionReady(TubeWrapper*,int)),
+                    SLOT(onLocalConnectionReady(TubeWrapper*,int)));
+            connect(wrapper,
+                    SIGNAL(localConnectionFailed(TubeWrapper*,QString,QString)),
+                    SLOT(onLocalConnectionFailed(TubeWrapper*,QString,QString)));
+            wrapper->startConnector(conn, mPriv->connectionPoolSize);
+        }
+
         emit tubeAcceptedAsUnix(conn->localAddress(), conn->requiresCredentials(),
                 conn->credentialByte(), wrapper->mAcc, wrapper->mTube);
     }
@@ -914,9 +1251,13 @@ void StreamTubeClient::onTubeInvalidated(Tp::DBusProxy *proxy, const QString &er
         return;
     }
 
-    debug() << "Client StreamTube" << tube->objectPath() << "invalidated - " << error << ':'
+    tpDebug(logTubes) <<
+        "Client StreamTube" << tube->objectPath() << "invalidated - " << error << ':'
         << message;
 
+    if (mPriv->metrics) {
+        mPriv->metrics->tubeClosed(tube);
+    }
     emit tubeClosed(wrapper->mAcc, wrapper->mTube, error, message);
     mPriv->tubes.remove(tube);
     delete wrapper;
@@ -927,6 +1268,9 @@ void StreamTubeClient::onNewConnection(
         uint conn)
 {
     Q_ASSERT(monitorsConnections());
+    if (mPriv->metrics) {
+        mPriv->metrics->connectionOpened(wrapper->mTube, conn);
+    }
     emit newConnection(wrapper->mAcc, wrapper->mTube, conn);
 }
 
@@ -937,9 +1281,33 @@ void StreamTubeClient::onConnectionClosed(
         const QString &message)
 {
     Q_ASSERT(monitorsConnections());
+    if (mPriv->metrics) {
+        mPriv->metrics->connectionClosed(wrapper->mTube, conn);
+    }
     emit connectionClosed(wrapper->mAcc, wrapper->mTube, conn, error, message);
 }
 
+void StreamTubeClient::onLocalConnectionReady(TubeWrapper *wrapper, int socketDescriptor)
+{
+    if (!mPriv->connectionHandler) {
+        // The pool has been disabled since the tube was accepted, so nobody wants the connection
+        StreamTubeConnector::discard(socketDescriptor);
+        return;
+    }
+
+    mPriv->connectionHandler->handleLocalConnection(wrapper->mAcc, wrapper->mTube,
+            socketDescriptor);
+}
+
+void StreamTubeClient::onLocalConnectionFailed(TubeWrapper *wrapper, const QString &error,
+        const QString &message)
+{
+    if (mPriv->connectionHandler) {
+        mPriv->connectionHandler->localConnectionFailed(wrapper->mAcc, wrapper->mTube, error,
+                message);
+    }
+}
+
 /**
  * \fn void StreamTubeClient::tubeOffered(const AccountPtr &account, const
  * IncomingStreamTubeChannelPtr &tube)
@@ -1055,4 +1423,15 @@ void StreamTubeClient::onConnectionClosed(
  * \param message A freeform debug message associated with the error.
  */
 
+/**
+ * \fn void StreamTubeClient::metricsUpdated(const Tp::StreamTubeMetrics &metrics)
+ *
+ * Emitted with the aggregate metrics when tubes or connections have changed, at most once per
+ * metricsReportInterval().
+ *
+ * This is only emitted if metrics are enabled, see setMetricsEnabled().
+ *
+ * \param metrics The metrics aggregated over all of the tubes offered since metrics were enabled.
+ */
+
 } // Tp
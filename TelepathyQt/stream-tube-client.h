@@ -28,6 +28,7 @@
 #include <TelepathyQt/ConnectionFactory>
 #include <TelepathyQt/ContactFactory>
 #include <TelepathyQt/RefCounted>
+#include <TelepathyQt/StreamTubeMetrics>
 #include <TelepathyQt/Types>
 
 class QHostAddress;
@@ -56,6 +57,19 @@ public:
         virtual ~TcpSourceAddressGenerator() {}
     };
 
+    class LocalConnectionHandler
+    {
+    public:
+        virtual void handleLocalConnection(const AccountPtr &account,
+                const IncomingStreamTubeChannelPtr &tube, int socketDescriptor) = 0;
+        virtual void localConnectionFailed(const AccountPtr &account,
+                const IncomingStreamTubeChannelPtr &tube, const QString &error,
+                const QString &message);
+
+    protected:
+        virtual ~LocalConnectionHandler() {}
+    };
+
     class Tube : public QPair<AccountPtr, IncomingStreamTubeChannelPtr>
     {
     public:
@@ -141,9 +155,23 @@ public:
     void setToAcceptAsTcp(TcpSourceAddressGenerator *generator = 0);
     void setToAcceptAsUnix(bool requireCredentials = false);
 
+    LocalConnectionHandler *localConnectionHandler() const;
+    uint localConnectionPoolSize() const;
+    void setLocalConnectionPool(LocalConnectionHandler *handler, uint poolSize = 1);
+    bool requestLocalConnection(const Tube &tube);
+
     QList<Tube> tubes() const;
     QHash<Tube, QSet<uint> > connections() const;
 
+    bool isMetricsEnabled() const;
+    void setMetricsEnabled(bool enabled);
+    int metricsReportInterval() const;
+    void setMetricsReportInterval(int msecs);
+
+    StreamTubeMetrics metrics() const;
+    StreamTubeMetrics metrics(const Tube &tube) const;
+    StreamTubeConnectionMetrics connectionMetrics(const Tube &tube, uint connectionId) const;
+
 Q_SIGNALS:
     void tubeOffered(
             const Tp::AccountPtr &account,
@@ -179,6 +207,8 @@ Q_SIGNALS:
             const QString &error,
             const QString &message);
 
+    void metricsUpdated(const Tp::StreamTubeMetrics &metrics);
+
 private Q_SLOTS:
 
     TP_QT_NO_EXPORT void onInvokedForTube(
@@ -199,6 +229,12 @@ private Q_SLOTS:
             const QString &error,
             const QString &message);
 
+    TP_QT_NO_EXPORT void onLocalConnectionReady(TubeWrapper *wrapper, int socketDescriptor);
+    TP_QT_NO_EXPORT void onLocalConnectionFailed(
+            TubeWrapper *wrapper,
+            const QString &error,
+            const QString &message);
+
 private:
     TP_QT_NO_EXPORT StreamTubeClient(
             const ClientRegistrarPtr &registrar,
@@ -0,0 +1,405 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2026 agent <agent@local>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include "TelepathyQt/stream-tube-connector-internal.h"
+
+#include "TelepathyQt/_gen/stream-tube-connector-internal.moc.hpp"
+
+#include "TelepathyQt/debug-internal.h"
+
+#include <TelepathyQt/Constants>
+
+#include <QFile>
+#include <QSocketNotifier>
+#include <QTimer>
+
+#ifdef Q_OS_UNIX
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace Tp
+{
+
+#ifdef Q_OS_UNIX
+
+namespace
+{
+
+// When the listen backlog of the connection manager is full, connecting is retried after this many
+// milliseconds, doubled for each further attempt, until the requests waiting are failed
+const int initialRetryDelay = 10;
+const uint maxRetries = 8;
+
+bool setNonBlocking(int fd)
+{
+    int flags = ::fcntl(fd, F_GETFL);
+    return flags != -1 &&
+        ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1 &&
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC) != -1;
+}
+
+// Sends the credential byte, along with our credentials where the platform lets us, in the single
+// message the connection manager expects before relaying anything
+bool sendCredentials(int fd, uchar credentialByte)
+{
+    char data = static_cast<char>(credentialByte);
+    struct iovec iov;
+    iov.iov_base = &data;
+    iov.iov_len = 1;
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+#if defined(SCM_CREDENTIALS)
+    union {
+        struct cmsghdr hdr;
+        char buf[CMSG_SPACE(sizeof(struct ucred))];
+    } control;
+    memset(&control, 0, sizeof(control));
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_CREDENTIALS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(struct ucred));
+    struct ucred *cred = reinterpret_cast<struct ucred *>(CMSG_DATA(cmsg));
+    cred->pid = ::getpid();
+    cred->uid = ::getuid();
+    cred->gid = ::getgid();
+#elif defined(SCM_CREDS)
+    // The kernel fills in the actual credentials
+    union {
+        struct cmsghdr hdr;
+        char buf[CMSG_SPACE(sizeof(struct cmsgcred))];
+    } control;
+    memset(&control, 0, sizeof(control));
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_CREDS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(struct cmsgcred));
+#endif
+
+    int flags = 0;
+#ifdef MSG_NOSIGNAL
+    flags |= MSG_NOSIGNAL;
+#endif
+
+    ssize_t ret;
+    do {
+        ret = ::sendmsg(fd, &msg, flags);
+    } while (ret == -1 && errno == EINTR);
+
+    return ret == 1;
+}
+
+}
+
+#endif
+
+StreamTubeConnector::StreamTubeConnector(const QString &address, bool abstract,
+        bool requireCredentials, uchar credentialByte, uint poolSize, QObject *parent)
+    : QObject(parent),
+      mAbstract(abstract),
+      mRequireCredentials(requireCredentials),
+      mCredentialByte(credentialByte),
+      mPoolSize(poolSize),
+      mRequested(0),
+      mRetryTimer(new QTimer(this)),
+      mRetries(0)
+{
+    mRetryTimer->setSingleShot(true);
+    connect(mRetryTimer,
+            SIGNAL(timeout()),
+            SLOT(onRetryTimeout()));
+
+    if (abstract) {
+        // Abstract addresses start with a NUL byte, which we add back when connecting
+        QString name = address;
+        if (name.startsWith(QLatin1Char('\0'))) {
+            name.remove(0, 1);
+        }
+        mAddress = name.toLatin1();
+    } else {
+        mAddress = QFile::encodeName(address);
+    }
+
+    fill();
+}
+
+StreamTubeConnector::~StreamTubeConnector()
+{
+#ifdef Q_OS_UNIX
+    for (QHash<int, QSocketNotifier *>::const_iterator i = mConnecting.constBegin();
+            i != mConnecting.constEnd(); ++i) {
+        delete i.value();
+        ::close(i.key());
+    }
+
+    foreach (int fd, mPooled) {
+        ::close(fd);
+    }
+#endif
+}
+
+bool StreamTubeConnector::isSupported()
+{
+#ifdef Q_OS_UNIX
+    return true;
+#else
+    return false;
+#endif
+}
+
+void StreamTubeConnector::discard(int socketDescriptor)
+{
+#ifdef Q_OS_UNIX
+    ::close(socketDescriptor);
+#else
+    Q_UNUSED(socketDescriptor);
+#endif
+}
+
+void StreamTubeConnector::request()
+{
+    int fd = takePooled();
+    if (fd != -1) {
+        emit connectionReady(fd);
+        fill();
+        return;
+    }
+
+    ++mRequested;
+    fill();
+}
+
+void StreamTubeConnector::fill()
+{
+    // While backing off, the retry timer carries on filling
+    if (mRetryTimer->isActive()) {
+        return;
+    }
+
+    while (uint(mPooled.size() + mConnecting.size()) < mPoolSize + mRequested) {
+        if (!startConnect()) {
+            return;
+        }
+    }
+}
+
+#ifdef Q_OS_UNIX
+
+bool StreamTubeConnector::startConnect()
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+
+    int offset = mAbstract ? 1 : 0;
+    if (mAddress.size() + offset >= int(sizeof(addr.sun_path))) {
+        failed(QLatin1String("Socket address too long"));
+        return false;
+    }
+    memcpy(addr.sun_path + offset, mAddress.constData(), mAddress.size());
+    socklen_t len = offsetof(struct sockaddr_un, sun_path) + offset + mAddress.size();
+    if (!mAbstract) {
+        ++len;
+    }
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1 || !setNonBlocking(fd)) {
+        failed(QLatin1String(strerror(errno)));
+        if (fd != -1) {
+            ::close(fd);
+        }
+        return false;
+    }
+
+#ifdef SO_NOSIGPIPE
+    int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+    int ret;
+    do {
+        ret = ::connect(fd, reinterpret_cast<struct sockaddr *>(&addr), len);
+    } while (ret == -1 && errno == EINTR);
+
+    if (ret == 0) {
+        connected(fd);
+    } else if (errno == EINPROGRESS) {
+        QSocketNotifier *notifier = new QSocketNotifier(fd, QSocketNotifier::Write, this);
+        connect(notifier,
+                SIGNAL(activated(int)),
+                SLOT(onConnected(int)));
+        mConnecting.insert(fd, notifier);
+    } else if (errno == EAGAIN) {
+        // The listen backlog of the connection manager is full. Nothing is left in progress on the
+        // socket in this case, so start over once the connection manager has had time to catch up
+        ::close(fd);
+        retryLater();
+        return false;
+    } else {
+        failed(QLatin1String(strerror(errno)));
+        ::close(fd);
+        return false;
+    }
+
+    return true;
+}
+
+void StreamTubeConnector::retryLater()
+{
+    if (mRetries == maxRetries) {
+        mRetries = 0;
+        failed(QLatin1String("The connection manager isn't accepting connections"));
+        return;
+    }
+
+    mRetryTimer->start(initialRetryDelay << mRetries);
+    ++mRetries;
+}
+
+void StreamTubeConnector::onConnected(int fd)
+{
+    QSocketNotifier *notifier = mConnecting.take(fd);
+    if (!notifier) {
+        return;
+    }
+
+    // We're in its activated() handler, so it can't be deleted yet
+    notifier->setEnabled(false);
+    notifier->deleteLater();
+
+    int error = 0;
+    socklen_t len = sizeof(error);
+    ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len);
+    if (error != 0) {
+        failed(QLatin1String(strerror(error)));
+        ::close(fd);
+        return;
+    }
+
+    connected(fd);
+}
+
+void StreamTubeConnector::connected(int fd)
+{
+    mRetries = 0;
+
+    if (mRequireCredentials && !sendCredentials(fd, mCredentialByte)) {
+        failed(QLatin1String(strerror(errno)));
+        ::close(fd);
+        return;
+    }
+
+    if (mRequested > 0) {
+        --mRequested;
+        emit connectionReady(fd);
+    } else {
+        mPooled.append(fd);
+    }
+}
+
+int StreamTubeConnector::takePooled()
+{
+    while (!mPooled.isEmpty()) {
+        int fd = mPooled.takeFirst();
+
+        // Skip connections the connection manager has given up on while they were waiting
+        struct pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = 0;
+        pfd.revents = 0;
+        if (::poll(&pfd, 1, 0) == 1 && (pfd.revents & (POLLHUP | POLLERR | POLLNVAL))) {
+            ::close(fd);
+            continue;
+        }
+
+        return fd;
+    }
+
+    return -1;
+}
+
+#else
+
+bool StreamTubeConnector::startConnect()
+{
+    failed(QLatin1String("Unix sockets are not supported on this platform"));
+    return false;
+}
+
+void StreamTubeConnector::retryLater()
+{
+}
+
+void StreamTubeConnector::onConnected(int fd)
+{
+    Q_UNUSED(fd);
+}
+
+void StreamTubeConnector::connected(int fd)
+{
+    Q_UNUSED(fd);
+}
+
+int StreamTubeConnector::takePooled()
+{
+    return -1;
+}
+
+#endif
+
+void StreamTubeConnector::onRetryTimeout()
+{
+    fill();
+}
+
+void StreamTubeConnector::failed(const QString &message)
+{
+    tpWarning(logTubes) << "Couldn't connect to the tube socket -" << message;
+
+    // Each request waiting for a connection is told, failing to fill the pool is retried when the
+    // next connection is requested
+    uint requested = mRequested;
+    mRequested = 0;
+    for (uint i = 0; i < requested; ++i) {
+        emit connectionFailed(TP_QT_ERROR_NETWORK_ERROR, message);
+    }
+}
+
+} // Tp
@@ -0,0 +1,94 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2026 agent <agent@local>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef _TelepathyQt_stream_tube_connector_internal_h_HEADER_GUARD_
+#define _TelepathyQt_stream_tube_connector_internal_h_HEADER_GUARD_
+
+#include <TelepathyQt/Global>
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+class QSocketNotifier;
+class QTimer;
+
+namespace Tp
+{
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+// Keeps a number of connections to the local Unix socket of an accepted tube established ahead of
+// time, with the credentials already sent if the tube requires them, so that handing one out to the
+// application doesn't need to wait for the connection manager.
+class TP_QT_NO_EXPORT StreamTubeConnector : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(StreamTubeConnector)
+
+public:
+    StreamTubeConnector(const QString &address, bool abstract, bool requireCredentials,
+            uchar credentialByte, uint poolSize, QObject *parent);
+    ~StreamTubeConnector();
+
+    static bool isSupported();
+    static void discard(int socketDescriptor);
+
+    // Emits connectionReady() before returning if a pooled connection is available
+    void request();
+
+Q_SIGNALS:
+    void connectionReady(int socketDescriptor);
+    void connectionFailed(const QString &error, const QString &message);
+
+private Q_SLOTS:
+    void onConnected(int socketDescriptor);
+    void onRetryTimeout();
+
+private:
+    void fill();
+    bool startConnect();
+    void retryLater();
+    void connected(int fd);
+    void failed(const QString &message);
+    int takePooled();
+
+    QByteArray mAddress;
+    bool mAbstract;
+    bool mRequireCredentials;
+    uchar mCredentialByte;
+    uint mPoolSize;
+
+    QList<int> mPooled;
+    QHash<int, QSocketNotifier *> mConnecting;
+    uint mRequested;
+    QTimer *mRetryTimer;
+    uint mRetries;
+};
+
+#endif
+
+} // Tp
+
+#endif
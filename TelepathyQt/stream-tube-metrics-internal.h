@@ -0,0 +1,144 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2026 agent <agent@local>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef _TelepathyQt_stream_tube_metrics_internal_h_HEADER_GUARD_
+#define _TelepathyQt_stream_tube_metrics_internal_h_HEADER_GUARD_
+
+#include <TelepathyQt/StreamTubeChannel>
+#include <TelepathyQt/StreamTubeMetrics>
+#include <TelepathyQt/Types>
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QSharedData>
+#include <QTimer>
+#include <QVector>
+
+namespace Tp
+{
+
+class StreamTubeRelay;
+
+struct TP_QT_NO_EXPORT StreamTubeMetrics::Private : public QSharedData
+{
+    Private();
+
+    uint tubeCount;
+    qint64 setupLatency;
+    QVector<uint> setupLatencies;
+    qint64 firstConnectionLatency;
+    QVector<uint> firstConnectionLatencies;
+    uint openConnections;
+    uint totalConnections;
+    QVector<uint> lifetimes;
+    bool hasByteCounts;
+    qint64 bytesSent;
+    qint64 bytesReceived;
+};
+
+struct TP_QT_NO_EXPORT StreamTubeConnectionMetrics::Private : public QSharedData
+{
+    Private(uint connectionId, qint64 age, qint64 setupLatency)
+        : connectionId(connectionId),
+          age(age),
+          setupLatency(setupLatency)
+    {
+    }
+
+    uint connectionId;
+    qint64 age;
+    qint64 setupLatency;
+};
+
+// Records the setup and connection timing of the tubes handled by a StreamTubeServer or
+// StreamTubeClient. The owner feeds it events as they happen; totals are kept up to date
+// incrementally, so reading them doesn't depend on the number of tubes or connections.
+class TP_QT_NO_EXPORT StreamTubeMetricsCollector : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(StreamTubeMetricsCollector)
+
+public:
+    StreamTubeMetricsCollector(QObject *parent);
+    ~StreamTubeMetricsCollector();
+
+    int reportInterval() const;
+    void setReportInterval(int msecs);
+
+    // Byte counts are only known for connections going through a relay
+    void setRelay(const StreamTubeRelay *relay);
+
+    void tubeHandled(const StreamTubeChannelPtr &tube);
+    void tubeSetUp(const StreamTubeChannelPtr &tube);
+    void tubeClosed(const StreamTubeChannelPtr &tube);
+    void connectionOpened(const StreamTubeChannelPtr &tube, uint connectionId);
+    void connectionClosed(const StreamTubeChannelPtr &tube, uint connectionId);
+
+    StreamTubeMetrics total() const;
+    StreamTubeMetrics forTube(const StreamTubeChannelPtr &tube) const;
+    StreamTubeConnectionMetrics forConnection(const StreamTubeChannelPtr &tube,
+            uint connectionId) const;
+
+Q_SIGNALS:
+    void reportDue(const Tp::StreamTubeMetrics &total);
+
+private Q_SLOTS:
+    void onReportTimeout();
+
+private:
+    struct TubeData
+    {
+        TubeData();
+
+        qint64 handledAt;
+        qint64 setUpAt;
+        qint64 firstConnectionAt;
+        uint totalConnections;
+        QHash<uint, qint64> connections;
+        QVector<uint> lifetimes;
+    };
+
+    void changed();
+
+    QElapsedTimer mClock;
+    QTimer mReportTimer;
+    const StreamTubeRelay *mRelay;
+
+    QHash<StreamTubeChannelPtr, TubeData> mTubes;
+
+    // Running totals over every tube handled, including closed ones
+    uint mTubeCount;
+    qint64 mSetupLatencySum;
+    uint mSetupCount;
+    QVector<uint> mSetupLatencies;
+    qint64 mFirstConnectionLatencySum;
+    uint mFirstConnectionCount;
+    QVector<uint> mFirstConnectionLatencies;
+    uint mOpenConnections;
+    uint mTotalConnections;
+    QVector<uint> mLifetimes;
+};
+
+} // Tp
+
+#endif
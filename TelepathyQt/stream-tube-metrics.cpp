@@ -0,0 +1,648 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2026 agent <agent@local>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <TelepathyQt/StreamTubeMetrics>
+#include "TelepathyQt/stream-tube-metrics-internal.h"
+
+#include "TelepathyQt/_gen/stream-tube-metrics-internal.moc.hpp"
+
+#include "TelepathyQt/debug-internal.h"
+#include "TelepathyQt/stream-tube-relay-internal.h"
+
+namespace Tp
+{
+
+namespace
+{
+
+// Upper bounds of the histogram buckets, in milliseconds. Roughly logarithmic, from what a local
+// round trip takes to connections staying up for an hour.
+const qint64 histogramBoundsMsecs[] = {
+    1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 30000, 60000, 300000, 3600000
+};
+const int histogramBucketCount =
+    int(sizeof(histogramBoundsMsecs) / sizeof(histogramBoundsMsecs[0])) + 1;
+
+void record(QVector<uint> &histogram, qint64 msecs)
+{
+    int bucket = 0;
+    while (bucket < histogramBucketCount - 1 && msecs > histogramBoundsMsecs[bucket]) {
+        ++bucket;
+    }
+    ++histogram[bucket];
+}
+
+QVector<uint> singleEntryHistogram(qint64 msecs)
+{
+    QVector<uint> histogram(histogramBucketCount, 0);
+    if (msecs >= 0) {
+        record(histogram, msecs);
+    }
+    return histogram;
+}
+
+}
+
+StreamTubeMetrics::Private::Private()
+    : tubeCount(0),
+      setupLatency(-1),
+      setupLatencies(histogramBucketCount, 0),
+      firstConnectionLatency(-1),
+      firstConnectionLatencies(histogramBucketCount, 0),
+      openConnections(0),
+      totalConnections(0),
+      lifetimes(histogramBucketCount, 0),
+      hasByteCounts(false),
+      bytesSent(0),
+      bytesReceived(0)
+{
+}
+
+/**
+ * \class StreamTubeMetrics
+ * \ingroup serverclient
+ * \headerfile TelepathyQt/stream-tube-metrics.h <TelepathyQt/StreamTubeMetrics>
+ *
+ * \brief The StreamTubeMetrics class represents timing and throughput measurements of one or more
+ * stream tubes handled by a StreamTubeServer or StreamTubeClient.
+ *
+ * Instances are snapshots, retrieved with StreamTubeServer::metrics(),
+ * StreamTubeClient::metrics() and the corresponding metricsUpdated() signals. They either describe
+ * a single tube, or all of the tubes handled since metrics were enabled, including those which
+ * have since been closed.
+ *
+ * All durations are in milliseconds. The histograms have a bucket for each of the upper bounds
+ * returned by histogramBounds(), and one more at the end for anything longer than the largest
+ * bound.
+ */
+
+/**
+ * Construct a new invalid StreamTubeMetrics instance.
+ */
+StreamTubeMetrics::StreamTubeMetrics()
+{
+}
+
+/**
+ * Copy constructor.
+ */
+StreamTubeMetrics::StreamTubeMetrics(const StreamTubeMetrics &other)
+    : mPriv(other.mPriv)
+{
+}
+
+/**
+ * Class destructor.
+ */
+StreamTubeMetrics::~StreamTubeMetrics()
+{
+}
+
+/**
+ * Return the inclusive upper bounds of the histogram buckets, in milliseconds.
+ *
+ * Bucket \c i of a histogram counts the durations longer than bound <tt>i - 1</tt> and no longer
+ * than bound \c i. The histograms have one bucket more than there are bounds, counting the
+ * durations longer than the largest bound.
+ *
+ * \return The bucket bounds in ascending order.
+ */
+QList<qint64> StreamTubeMetrics::histogramBounds()
+{
+    QList<qint64> bounds;
+    for (int i = 0; i < histogramBucketCount - 1; ++i) {
+        bounds << histogramBoundsMsecs[i];
+    }
+    return bounds;
+}
+
+/**
+ * Assignment operator.
+ */
+StreamTubeMetrics &StreamTubeMetrics::operator=(const StreamTubeMetrics &other)
+{
+    this->mPriv = other.mPriv;
+    return *this;
+}
+
+/**
+ * Return the number of tubes these metrics describe.
+ *
+ * \return 1 for the metrics of a single tube, or the number of tubes handled since metrics were
+ * enabled for aggregate metrics.
+ */
+uint StreamTubeMetrics::tubeCount() const
+{
+    if (!isValid()) {
+        return 0;
+    }
+
+    return mPriv->tubeCount;
+}
+
+/**
+ * Return how long it took to set the tube up.
+ *
+ * For StreamTubeServer, this is the time from starting to offer the tube to the remote contact
+ * accepting it. For StreamTubeClient, this is the time from starting to accept the tube to the
+ * local socket being ready for connections.
+ *
+ * For aggregate metrics, this is the mean over the tubes which have been set up.
+ *
+ * \return The setup latency in milliseconds, or -1 if no tube has been set up yet.
+ * \sa setupLatencyHistogram()
+ */
+qint64 StreamTubeMetrics::setupLatency() const
+{
+    if (!isValid()) {
+        return -1;
+    }
+
+    return mPriv->setupLatency;
+}
+
+/**
+ * Return the distribution of the setupLatency() of the tubes.
+ *
+ * \return The histogram, with the buckets given by histogramBounds().
+ */
+QList<uint> StreamTubeMetrics::setupLatencyHistogram() const
+{
+    if (!isValid()) {
+        return QList<uint>();
+    }
+
+    return mPriv->setupLatencies.toList();
+}
+
+/**
+ * Return how long it took for the first connection to be made after the tube was set up.
+ *
+ * For aggregate metrics, this is the mean over the tubes which have had a connection made through
+ * them.
+ *
+ * This is only known if connection monitoring was requested when creating the server or client.
+ *
+ * \return The latency in milliseconds, or -1 if no connection has been made yet.
+ * \sa firstConnectionLatencyHistogram()
+ */
+qint64 StreamTubeMetrics::firstConnectionLatency() const
+{
+    if (!isValid()) {
+        return -1;
+    }
+
+    return mPriv->firstConnectionLatency;
+}
+
+/**
+ * Return the distribution of the firstConnectionLatency() of the tubes.
+ *
+ * \return The histogram, with the buckets given by histogramBounds().
+ */
+QList<uint> StreamTubeMetrics::firstConnectionLatencyHistogram() const
+{
+    if (!isValid()) {
+        return QList<uint>();
+    }
+
+    return mPriv->firstConnectionLatencies.toList();
+}
+
+/**
+ * Return the number of connections currently open through the tubes.
+ *
+ * This is only known if connection monitoring was requested when creating the server or client.
+ *
+ * \return The number of open connections.
+ */
+uint StreamTubeMetrics::openConnectionCount() const
+{
+    if (!isValid()) {
+        return 0;
+    }
+
+    return mPriv->openConnections;
+}
+
+/**
+ * Return the number of connections made through the tubes, including closed ones.
+ *
+ * This is only known if connection monitoring was requested when creating the server or client.
+ *
+ * \return The number of connections.
+ */
+uint StreamTubeMetrics::totalConnectionCount() const
+{
+    if (!isValid()) {
+        return 0;
+    }
+
+    return mPriv->totalConnections;
+}
+
+/**
+ * Return the distribution of how long the closed connections through the tubes stayed open.
+ *
+ * This is only known if connection monitoring was requested when creating the server or client.
+ *
+ * \return The histogram, with the buckets given by histogramBounds().
+ */
+QList<uint> StreamTubeMetrics::connectionLifetimeHistogram() const
+{
+    if (!isValid()) {
+        return QList<uint>();
+    }
+
+    return mPriv->lifetimes.toList();
+}
+
+/**
+ * Return whether bytesSent() and bytesReceived() are known.
+ *
+ * The data sent through tubes is normally moved by the protocol backend directly to and from the
+ * application's sockets, so it can't be counted. The exception is a StreamTubeServer with the Unix
+ * socket relay enabled (see StreamTubeServer::setUnixRelayEnabled()), whose aggregate metrics
+ * count the data going through the relay. The relay is shared by all tubes, so the metrics of
+ * single tubes never have byte counts.
+ *
+ * \return \c true if the byte counts are known, \c false otherwise.
+ */
+bool StreamTubeMetrics::hasByteCounts() const
+{
+    if (!isValid()) {
+        return false;
+    }
+
+    return mPriv->hasByteCounts;
+}
+
+/**
+ * Return the number of bytes sent to remote contacts through the tubes.
+ *
+ * \return The number of bytes, or 0 if hasByteCounts() is \c false.
+ */
+qint64 StreamTubeMetrics::bytesSent() const
+{
+    if (!isValid()) {
+        return 0;
+    }
+
+    return mPriv->bytesSent;
+}
+
+/**
+ * Return the number of bytes received from remote contacts through the tubes.
+ *
+ * \return The number of bytes, or 0 if hasByteCounts() is \c false.
+ */
+qint64 StreamTubeMetrics::bytesReceived() const
+{
+    if (!isValid()) {
+        return 0;
+    }
+
+    return mPriv->bytesReceived;
+}
+
+/**
+ * \class StreamTubeConnectionMetrics
+ * \ingroup serverclient
+ * \headerfile TelepathyQt/stream-tube-metrics.h <TelepathyQt/StreamTubeConnectionMetrics>
+ *
+ * \brief The StreamTubeConnectionMetrics class represents timing measurements of a single
+ * connection made through a stream tube.
+ *
+ * Instances are snapshots, retrieved with StreamTubeServer::connectionMetrics() and
+ * StreamTubeClient::connectionMetrics(). All durations are in milliseconds.
+ */
+
+/**
+ * Construct a new invalid StreamTubeConnectionMetrics instance.
+ */
+StreamTubeConnectionMetrics::StreamTubeConnectionMetrics()
+{
+}
+
+/**
+ * Copy constructor.
+ */
+StreamTubeConnectionMetrics::StreamTubeConnectionMetrics(const StreamTubeConnectionMetrics &other)
+    : mPriv(other.mPriv)
+{
+}
+
+/**
+ * Class destructor.
+ */
+StreamTubeConnectionMetrics::~StreamTubeConnectionMetrics()
+{
+}
+
+/**
+ * Assignment operator.
+ */
+StreamTubeConnectionMetrics &StreamTubeConnectionMetrics::operator=(
+        const StreamTubeConnectionMetrics &other)
+{
+    this->mPriv = other.mPriv;
+    return *this;
+}
+
+/**
+ * Return the id of the connection on its tube.
+ *
+ * \return The connection id.
+ */
+uint StreamTubeConnectionMetrics::connectionId() const
+{
+    if (!isValid()) {
+        return 0;
+    }
+
+    return mPriv->connectionId;
+}
+
+/**
+ * Return how long the connection had been open when these metrics were retrieved.
+ *
+ * \return The age in milliseconds.
+ */
+qint64 StreamTubeConnectionMetrics::age() const
+{
+    if (!isValid()) {
+        return 0;
+    }
+
+    return mPriv->age;
+}
+
+/**
+ * Return how long after the tube was set up the connection was made.
+ *
+ * \return The latency in milliseconds, or -1 if the connection was reported before the tube
+ * finished setting up.
+ */
+qint64 StreamTubeConnectionMetrics::setupLatency() const
+{
+    if (!isValid()) {
+        return -1;
+    }
+
+    return mPriv->setupLatency;
+}
+
+StreamTubeMetricsCollector::TubeData::TubeData()
+    : handledAt(0),
+      setUpAt(-1),
+      firstConnectionAt(-1),
+      totalConnections(0)
+{
+}
+
+StreamTubeMetricsCollector::StreamTubeMetricsCollector(QObject *parent)
+    : QObject(parent),
+      mRelay(0),
+      mTubeCount(0),
+      mSetupLatencySum(0),
+      mSetupCount(0),
+      mSetupLatencies(histogramBucketCount, 0),
+      mFirstConnectionLatencySum(0),
+      mFirstConnectionCount(0),
+      mFirstConnectionLatencies(histogramBucketCount, 0),
+      mOpenConnections(0),
+      mTotalConnections(0),
+      mLifetimes(histogramBucketCount, 0)
+{
+    mClock.start();
+
+    mReportTimer.setSingleShot(true);
+    mReportTimer.setInterval(1000);
+    connect(&mReportTimer,
+            SIGNAL(timeout()),
+            SLOT(onReportTimeout()));
+}
+
+StreamTubeMetricsCollector::~StreamTubeMetricsCollector()
+{
+}
+
+int StreamTubeMetricsCollector::reportInterval() const
+{
+    return mReportTimer.interval();
+}
+
+void StreamTubeMetricsCollector::setReportInterval(int msecs)
+{
+    mReportTimer.setInterval(msecs);
+    if (msecs <= 0) {
+        mReportTimer.stop();
+    }
+}
+
+void StreamTubeMetricsCollector::setRelay(const StreamTubeRelay *relay)
+{
+    mRelay = relay;
+}
+
+void StreamTubeMetricsCollector::tubeHandled(const StreamTubeChannelPtr &tube)
+{
+    if (mTubes.contains(tube)) {
+        return;
+    }
+
+    TubeData &data = mTubes[tube];
+    data.handledAt = mClock.elapsed();
+    ++mTubeCount;
+    changed();
+}
+
+void StreamTubeMetricsCollector::tubeSetUp(const StreamTubeChannelPtr &tube)
+{
+    QHash<StreamTubeChannelPtr, TubeData>::iterator i = mTubes.find(tube);
+    if (i == mTubes.end() || i->setUpAt >= 0) {
+        return;
+    }
+
+    i->setUpAt = mClock.elapsed();
+    qint64 latency = i->setUpAt - i->handledAt;
+    mSetupLatencySum += latency;
+    ++mSetupCount;
+    record(mSetupLatencies, latency);
+    changed();
+}
+
+void StreamTubeMetricsCollector::tubeClosed(const StreamTubeChannelPtr &tube)
+{
+    QHash<StreamTubeChannelPtr, TubeData>::iterator i = mTubes.find(tube);
+    if (i == mTubes.end()) {
+        return;
+    }
+
+    // Connections still open when the tube goes away are closed along with it
+    qint64 now = mClock.elapsed();
+    for (QHash<uint, qint64>::const_iterator conn = i->connections.constBegin();
+            conn != i->connections.constEnd(); ++conn) {
+        record(mLifetimes, now - conn.value());
+    }
+    mOpenConnections -= i->connections.size();
+
+    mTubes.erase(i);
+    changed();
+}
+
+void StreamTubeMetricsCollector::connectionOpened(const StreamTubeChannelPtr &tube,
+        uint connectionId)
+{
+    QHash<StreamTubeChannelPtr, TubeData>::iterator i = mTubes.find(tube);
+    if (i == mTubes.end() || i->connections.contains(connectionId)) {
+        return;
+    }
+
+    qint64 now = mClock.elapsed();
+    if (i->firstConnectionAt < 0 && i->setUpAt >= 0) {
+        i->firstConnectionAt = now;
+        qint64 latency = now - i->setUpAt;
+        mFirstConnectionLatencySum += latency;
+        ++mFirstConnectionCount;
+        record(mFirstConnectionLatencies, latency);
+    }
+
+    i->connections.insert(connectionId, now);
+    ++i->totalConnections;
+    ++mOpenConnections;
+    ++mTotalConnections;
+    changed();
+}
+
+void StreamTubeMetricsCollector::connectionClosed(const StreamTubeChannelPtr &tube,
+        uint connectionId)
+{
+    QHash<StreamTubeChannelPtr, TubeData>::iterator i = mTubes.find(tube);
+    if (i == mTubes.end()) {
+        return;
+    }
+
+    QHash<uint, qint64>::iterator conn = i->connections.find(connectionId);
+    if (conn == i->connections.end()) {
+        return;
+    }
+
+    qint64 lifetime = mClock.elapsed() - conn.value();
+    if (i->lifetimes.isEmpty()) {
+        i->lifetimes.fill(0, histogramBucketCount);
+    }
+    record(i->lifetimes, lifetime);
+    record(mLifetimes, lifetime);
+
+    i->connections.erase(conn);
+    --mOpenConnections;
+    changed();
+}
+
+StreamTubeMetrics StreamTubeMetricsCollector::total() const
+{
+    StreamTubeMetrics metrics;
+    metrics.mPriv = new StreamTubeMetrics::Private;
+    StreamTubeMetrics::Private *priv = metrics.mPriv.data();
+
+    priv->tubeCount = mTubeCount;
+    if (mSetupCount) {
+        priv->setupLatency = mSetupLatencySum / mSetupCount;
+    }
+    priv->setupLatencies = mSetupLatencies;
+    if (mFirstConnectionCount) {
+        priv->firstConnectionLatency = mFirstConnectionLatencySum / mFirstConnectionCount;
+    }
+    priv->firstConnectionLatencies = mFirstConnectionLatencies;
+    priv->openConnections = mOpenConnections;
+    priv->totalConnections = mTotalConnections;
+    priv->lifetimes = mLifetimes;
+
+    if (mRelay) {
+        // The relay's local end is the protocol backend, its target the application's service
+        priv->hasByteCounts = true;
+        priv->bytesSent = mRelay->bytesToLocal();
+        priv->bytesReceived = mRelay->bytesToTarget();
+    }
+
+    return metrics;
+}
+
+StreamTubeMetrics StreamTubeMetricsCollector::forTube(const StreamTubeChannelPtr &tube) const
+{
+    QHash<StreamTubeChannelPtr, TubeData>::const_iterator i = mTubes.constFind(tube);
+    if (i == mTubes.constEnd()) {
+        return StreamTubeMetrics();
+    }
+
+    StreamTubeMetrics metrics;
+    metrics.mPriv = new StreamTubeMetrics::Private;
+    StreamTubeMetrics::Private *priv = metrics.mPriv.data();
+
+    priv->tubeCount = 1;
+    if (i->setUpAt >= 0) {
+        priv->setupLatency = i->setUpAt - i->handledAt;
+        priv->setupLatencies = singleEntryHistogram(priv->setupLatency);
+    }
+    if (i->firstConnectionAt >= 0) {
+        priv->firstConnectionLatency = i->firstConnectionAt - i->setUpAt;
+        priv->firstConnectionLatencies = singleEntryHistogram(priv->firstConnectionLatency);
+    }
+    priv->openConnections = i->connections.size();
+    priv->totalConnections = i->totalConnections;
+    if (!i->lifetimes.isEmpty()) {
+        priv->lifetimes = i->lifetimes;
+    }
+
+    return metrics;
+}
+
+StreamTubeConnectionMetrics StreamTubeMetricsCollector::forConnection(
+        const StreamTubeChannelPtr &tube, uint connectionId) const
+{
+    QHash<StreamTubeChannelPtr, TubeData>::const_iterator i = mTubes.constFind(tube);
+    if (i == mTubes.constEnd() || !i->connections.contains(connectionId)) {
+        return StreamTubeConnectionMetrics();
+    }
+
+    qint64 openedAt = i->connections.value(connectionId);
+    StreamTubeConnectionMetrics metrics;
+    metrics.mPriv = new StreamTubeConnectionMetrics::Private(connectionId,
+            mClock.elapsed() - openedAt, i->setUpAt >= 0 ? openedAt - i->setUpAt : -1);
+    return metrics;
+}
+
+void StreamTubeMetricsCollector::changed()
+{
+    // Coalesce the updates happening within an interval into a single report
+    if (mReportTimer.interval() > 0 && !mReportTimer.isActive()) {
+        mReportTimer.start();
+    }
+}
+
+void StreamTubeMetricsCollector::onReportTimeout()
+{
+    emit reportDue(total());
+}
+
+} // Tp
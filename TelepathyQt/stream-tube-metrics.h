@@ -0,0 +1,104 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2026 agent <agent@local>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef _TelepathyQt_stream_tube_metrics_h_HEADER_GUARD_
+#define _TelepathyQt_stream_tube_metrics_h_HEADER_GUARD_
+
+#ifndef IN_TP_QT_HEADER
+#error IN_TP_QT_HEADER
+#endif
+
+#include <TelepathyQt/Global>
+
+#include <QList>
+#include <QMetaType>
+#include <QSharedDataPointer>
+
+namespace Tp
+{
+
+class StreamTubeMetricsCollector;
+
+class TP_QT_EXPORT StreamTubeMetrics
+{
+public:
+    StreamTubeMetrics();
+    StreamTubeMetrics(const StreamTubeMetrics &other);
+    ~StreamTubeMetrics();
+
+    static QList<qint64> histogramBounds();
+
+    bool isValid() const { return mPriv.constData() != 0; }
+
+    StreamTubeMetrics &operator=(const StreamTubeMetrics &other);
+
+    uint tubeCount() const;
+    qint64 setupLatency() const;
+    QList<uint> setupLatencyHistogram() const;
+    qint64 firstConnectionLatency() const;
+    QList<uint> firstConnectionLatencyHistogram() const;
+
+    uint openConnectionCount() const;
+    uint totalConnectionCount() const;
+    QList<uint> connectionLifetimeHistogram() const;
+
+    bool hasByteCounts() const;
+    qint64 bytesSent() const;
+    qint64 bytesReceived() const;
+
+private:
+    friend class StreamTubeMetricsCollector;
+
+    struct Private;
+    friend struct Private;
+    QSharedDataPointer<Private> mPriv;
+};
+
+class TP_QT_EXPORT StreamTubeConnectionMetrics
+{
+public:
+    StreamTubeConnectionMetrics();
+    StreamTubeConnectionMetrics(const StreamTubeConnectionMetrics &other);
+    ~StreamTubeConnectionMetrics();
+
+    bool isValid() const { return mPriv.constData() != 0; }
+
+    StreamTubeConnectionMetrics &operator=(const StreamTubeConnectionMetrics &other);
+
+    uint connectionId() const;
+    qint64 age() const;
+    qint64 setupLatency() const;
+
+private:
+    friend class StreamTubeMetricsCollector;
+
+    struct Private;
+    friend struct Private;
+    QSharedDataPointer<Private> mPriv;
+};
+
+} // Tp
+
+Q_DECLARE_METATYPE(Tp::StreamTubeMetrics)
+Q_DECLARE_METATYPE(Tp::StreamTubeConnectionMetrics)
+
+#endif
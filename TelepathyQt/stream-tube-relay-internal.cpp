@@ -0,0 +1,518 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2026 agent <agent@local>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "TelepathyQt/stream-tube-relay-internal.h"
+
+#include "TelepathyQt/_gen/stream-tube-relay-internal.moc.hpp"
+
+#include "TelepathyQt/debug-internal.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QSocketNotifier>
+
+#ifdef Q_OS_UNIX
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+// How the user on the other end of an accepted connection is found out, if at all
+#if defined(SO_PEERCRED)
+#define TP_QT_RELAY_PEERCRED
+#elif defined(Q_OS_MAC) || defined(Q_OS_BSD4)
+#define TP_QT_RELAY_GETPEEREID
+#endif
+#endif
+
+namespace Tp
+{
+
+#ifdef Q_OS_UNIX
+
+namespace
+{
+
+// Bytes moved per system call, and the most chunks moved in one direction before returning to the
+// event loop, so that one busy connection can't starve the others
+const int chunkSize = 64 * 1024;
+const int maxChunksPerWakeup = 16;
+
+bool setNonBlocking(int fd)
+{
+    int flags = ::fcntl(fd, F_GETFL);
+    return flags != -1 &&
+        ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1 &&
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC) != -1;
+}
+
+bool isSameUser(int fd)
+{
+#if defined(TP_QT_RELAY_PEERCRED)
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    if (::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) == -1) {
+        return false;
+    }
+    return cred.uid == ::getuid();
+#elif defined(TP_QT_RELAY_GETPEEREID)
+    uid_t uid;
+    gid_t gid;
+    if (::getpeereid(fd, &uid, &gid) == -1) {
+        return false;
+    }
+    return uid == ::getuid();
+#else
+    // isSupported() is false, but never let anybody in even if the relay is started regardless
+    Q_UNUSED(fd);
+    return false;
+#endif
+}
+
+#ifdef Q_OS_LINUX
+// splice() can't be told not to raise SIGPIPE like send() can, so block it while moving data and
+// swallow the one we caused, if any
+class SigPipeBlocker
+{
+public:
+    SigPipeBlocker()
+    {
+        sigset_t pending;
+        sigemptyset(&mPipe);
+        sigaddset(&mPipe, SIGPIPE);
+        sigpending(&pending);
+        mWasPending = sigismember(&pending, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &mPipe, &mOldMask);
+    }
+
+    ~SigPipeBlocker()
+    {
+        if (!mWasPending) {
+            sigset_t pending;
+            sigpending(&pending);
+            if (sigismember(&pending, SIGPIPE)) {
+                static const struct timespec noWait = { 0, 0 };
+                sigtimedwait(&mPipe, 0, &noWait);
+            }
+        }
+        pthread_sigmask(SIG_SETMASK, &mOldMask, 0);
+    }
+
+private:
+    sigset_t mPipe;
+    sigset_t mOldMask;
+    bool mWasPending;
+};
+#endif
+
+}
+
+#endif
+
+StreamTubeRelay::StreamTubeRelay(QObject *parent)
+    : QLocalServer(parent),
+      mPort(0),
+      mBytesToTarget(0),
+      mBytesToLocal(0)
+{
+}
+
+StreamTubeRelay::~StreamTubeRelay()
+{
+}
+
+bool StreamTubeRelay::isSupported()
+{
+    // Without a way to check who connected, any local user could reach the relayed service
+#if defined(TP_QT_RELAY_PEERCRED) || defined(TP_QT_RELAY_GETPEEREID)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool StreamTubeRelay::start()
+{
+    if (isListening()) {
+        return true;
+    }
+
+    // Prefer the per-user runtime directory, which only the user can enter
+    QString dir = QFile::decodeName(qgetenv("XDG_RUNTIME_DIR"));
+    if (dir.isEmpty()) {
+        dir = QDir::tempPath();
+    }
+
+    QString name = QString(QLatin1String("%1/tpqt-tube-relay-%2-%3"))
+        .arg(dir)
+        .arg(QCoreApplication::applicationPid())
+        .arg((quintptr) this, 0, 16);
+    QLocalServer::removeServer(name);
+
+#if QT_VERSION >= 0x050000
+    setSocketOptions(QLocalServer::UserAccessOption);
+#endif
+
+    if (!listen(name)) {
+        tpWarning(logTubes) << "Unable to listen for relayed tube connections at" << name <<
+            "-" << errorString();
+        return false;
+    }
+
+    tpDebug(logTubes) << "Relaying tube connections from" << fullServerName();
+    return true;
+}
+
+void StreamTubeRelay::setTarget(const QHostAddress &address, quint16 port)
+{
+    mAddress = address;
+    mPort = port;
+}
+
+void StreamTubeRelay::incomingConnection(quintptr socketDescriptor)
+{
+#ifdef Q_OS_UNIX
+    int fd = int(socketDescriptor);
+    if (!isSameUser(fd)) {
+        tpWarning(logTubes) << "Rejecting relayed tube connection from another user";
+        ::close(fd);
+        return;
+    }
+
+    // Owned by the relay until the connection closes
+    new StreamTubeRelayConnection(fd, mAddress, mPort, this);
+#else
+    Q_UNUSED(socketDescriptor);
+#endif
+}
+
+StreamTubeRelayConnection::Direction::Direction()
+    : from(-1),
+      to(-1),
+      readNotifier(0),
+      writeNotifier(0),
+      pending(0),
+      transferred(0),
+      eof(false),
+      done(false)
+{
+    pipe[0] = pipe[1] = -1;
+}
+
+#ifdef Q_OS_UNIX
+
+StreamTubeRelayConnection::StreamTubeRelayConnection(int localFd, const QHostAddress &address,
+        quint16 port, StreamTubeRelay *relay)
+    : QObject(relay),
+      mLocalFd(localFd),
+      mTargetFd(-1),
+      mConnectNotifier(0),
+      mFinished(false)
+{
+    if (!setNonBlocking(mLocalFd)) {
+        finish(strerror(errno));
+        return;
+    }
+
+    struct sockaddr_storage storage;
+    socklen_t len;
+    memset(&storage, 0, sizeof(storage));
+    if (address.protocol() == QAbstractSocket::IPv6Protocol) {
+        struct sockaddr_in6 *sa = reinterpret_cast<struct sockaddr_in6 *>(&storage);
+        Q_IPV6ADDR ip = address.toIPv6Address();
+        sa->sin6_family = AF_INET6;
+        sa->sin6_port = htons(port);
+        memcpy(&sa->sin6_addr, &ip, sizeof(sa->sin6_addr));
+        len = sizeof(struct sockaddr_in6);
+    } else {
+        struct sockaddr_in *sa = reinterpret_cast<struct sockaddr_in *>(&storage);
+        sa->sin_family = AF_INET;
+        sa->sin_port = htons(port);
+        sa->sin_addr.s_addr = htonl(address.toIPv4Address());
+        len = sizeof(struct sockaddr_in);
+    }
+
+    mTargetFd = ::socket(storage.ss_family, SOCK_STREAM, 0);
+    if (mTargetFd == -1 || !setNonBlocking(mTargetFd)) {
+        finish(strerror(errno));
+        return;
+    }
+
+#ifdef SO_NOSIGPIPE
+    int one = 1;
+    ::setsockopt(mTargetFd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+    ::setsockopt(mLocalFd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+    int ret;
+    do {
+        ret = ::connect(mTargetFd, reinterpret_cast<struct sockaddr *>(&storage), len);
+    } while (ret == -1 && errno == EINTR);
+
+    if (ret == 0) {
+        onTargetConnected();
+    } else if (errno == EINPROGRESS) {
+        mConnectNotifier = new QSocketNotifier(mTargetFd, QSocketNotifier::Write, this);
+        connect(mConnectNotifier,
+                SIGNAL(activated(int)),
+                SLOT(onTargetConnected()));
+    } else {
+        finish(strerror(errno));
+    }
+}
+
+StreamTubeRelayConnection::~StreamTubeRelayConnection()
+{
+    // Notifiers must go before the descriptors they watch
+    delete mConnectNotifier;
+    Direction *directions[] = { &mToTarget, &mToLocal };
+    for (int i = 0; i < 2; ++i) {
+        delete directions[i]->readNotifier;
+        delete directions[i]->writeNotifier;
+        if (directions[i]->pipe[0] != -1) {
+            ::close(directions[i]->pipe[0]);
+            ::close(directions[i]->pipe[1]);
+        }
+    }
+
+    if (mTargetFd != -1) {
+        ::close(mTargetFd);
+    }
+    ::close(mLocalFd);
+}
+
+void StreamTubeRelayConnection::onTargetConnected()
+{
+    if (mConnectNotifier) {
+        int error = 0;
+        socklen_t len = sizeof(error);
+        ::getsockopt(mTargetFd, SOL_SOCKET, SO_ERROR, &error, &len);
+
+        // We're in its activated() handler, so it can't be deleted yet
+        mConnectNotifier->setEnabled(false);
+        mConnectNotifier->deleteLater();
+        mConnectNotifier = 0;
+
+        if (error != 0) {
+            finish(strerror(error));
+            return;
+        }
+    }
+
+    StreamTubeRelay *relay = static_cast<StreamTubeRelay *>(parent());
+    if (!setUp(mToTarget, mLocalFd, mTargetFd, &relay->mBytesToTarget, SLOT(pumpToTarget())) ||
+            !setUp(mToLocal, mTargetFd, mLocalFd, &relay->mBytesToLocal, SLOT(pumpToLocal()))) {
+        finish(strerror(errno));
+        return;
+    }
+
+    pumpToTarget();
+    pumpToLocal();
+}
+
+bool StreamTubeRelayConnection::setUp(Direction &direction, int from, int to,
+        qint64 *transferred, const char *pumpSlot)
+{
+    direction.from = from;
+    direction.to = to;
+    direction.transferred = transferred;
+
+#ifdef Q_OS_LINUX
+    if (::pipe2(direction.pipe, O_NONBLOCK | O_CLOEXEC) == -1) {
+        return false;
+    }
+#endif
+
+    // pump() enables them when it would block
+    direction.readNotifier = new QSocketNotifier(from, QSocketNotifier::Read, this);
+    direction.readNotifier->setEnabled(false);
+    connect(direction.readNotifier, SIGNAL(activated(int)), pumpSlot);
+    direction.writeNotifier = new QSocketNotifier(to, QSocketNotifier::Write, this);
+    direction.writeNotifier->setEnabled(false);
+    connect(direction.writeNotifier, SIGNAL(activated(int)), pumpSlot);
+    return true;
+}
+
+void StreamTubeRelayConnection::pumpToTarget()
+{
+    if (!pump(mToTarget)) {
+        finish(strerror(errno));
+    } else if (mToTarget.done && mToLocal.done) {
+        finish(0);
+    }
+}
+
+void StreamTubeRelayConnection::pumpToLocal()
+{
+    if (!pump(mToLocal)) {
+        finish(strerror(errno));
+    } else if (mToTarget.done && mToLocal.done) {
+        finish(0);
+    }
+}
+
+// Moves data from direction.from to direction.to until either would block, returning false on
+// errors. Each chunk is fully written out before the next one is read, so at most one chunk per
+// direction is ever held in the pipe or buffer.
+bool StreamTubeRelayConnection::pump(Direction &direction)
+{
+    if (mFinished || direction.done) {
+        return true;
+    }
+
+#ifdef Q_OS_LINUX
+    SigPipeBlocker sigPipeBlocker;
+#endif
+
+    for (int chunks = 0; chunks < maxChunksPerWakeup; ++chunks) {
+        while (direction.pending > 0) {
+#ifdef Q_OS_LINUX
+            ssize_t written = ::splice(direction.pipe[0], 0, direction.to, 0, direction.pending,
+                    SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+#else
+            int flags = 0;
+#ifdef MSG_NOSIGNAL
+            flags |= MSG_NOSIGNAL;
+#endif
+            ssize_t written = ::send(direction.to,
+                    direction.buffer.constData() + (direction.buffer.size() - direction.pending),
+                    direction.pending, flags);
+#endif
+            if (written == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    direction.readNotifier->setEnabled(false);
+                    direction.writeNotifier->setEnabled(true);
+                    return true;
+                }
+                return false;
+            }
+            direction.pending -= written;
+            *direction.transferred += written;
+        }
+        direction.writeNotifier->setEnabled(false);
+
+        if (direction.eof) {
+            ::shutdown(direction.to, SHUT_WR);
+            direction.readNotifier->setEnabled(false);
+            direction.done = true;
+            return true;
+        }
+
+#ifdef Q_OS_LINUX
+        ssize_t received = ::splice(direction.from, 0, direction.pipe[1], 0, chunkSize,
+                SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+#else
+        direction.buffer.resize(chunkSize);
+        ssize_t received = ::recv(direction.from, direction.buffer.data(), chunkSize, 0);
+        direction.buffer.resize(received > 0 ? received : 0);
+#endif
+        if (received == 0) {
+            direction.eof = true;
+        } else if (received == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                direction.readNotifier->setEnabled(true);
+                return true;
+            }
+            return false;
+        } else {
+            direction.pending = received;
+        }
+    }
+
+    // Still busy, let the other connections have a go before carrying on
+    direction.writeNotifier->setEnabled(direction.pending > 0);
+    direction.readNotifier->setEnabled(direction.pending == 0);
+    return true;
+}
+
+void StreamTubeRelayConnection::finish(const char *reason)
+{
+    if (mFinished) {
+        return;
+    }
+    mFinished = true;
+
+    if (reason) {
+        tpDebug(logTubes) << "Relayed tube connection failed:" << reason;
+    }
+
+    if (mConnectNotifier) {
+        mConnectNotifier->setEnabled(false);
+    }
+
+    Direction *directions[] = { &mToTarget, &mToLocal };
+    for (int i = 0; i < 2; ++i) {
+        if (directions[i]->readNotifier) {
+            directions[i]->readNotifier->setEnabled(false);
+            directions[i]->writeNotifier->setEnabled(false);
+        }
+    }
+
+    deleteLater();
+}
+
+#else
+
+StreamTubeRelayConnection::StreamTubeRelayConnection(int localFd, const QHostAddress &address,
+        quint16 port, StreamTubeRelay *relay)
+    : QObject(relay),
+      mLocalFd(localFd),
+      mTargetFd(-1),
+      mConnectNotifier(0),
+      mFinished(true)
+{
+    Q_UNUSED(address);
+    Q_UNUSED(port);
+    deleteLater();
+}
+
+StreamTubeRelayConnection::~StreamTubeRelayConnection()
+{
+}
+
+void StreamTubeRelayConnection::onTargetConnected()
+{
+}
+
+void StreamTubeRelayConnection::pumpToTarget()
+{
+}
+
+void StreamTubeRelayConnection::pumpToLocal()
+{
+}
+
+#endif
+
+} // Tp
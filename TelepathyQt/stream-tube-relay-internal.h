@@ -0,0 +1,127 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2026 agent <agent@local>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _TelepathyQt_stream_tube_relay_internal_h_HEADER_GUARD_
+#define _TelepathyQt_stream_tube_relay_internal_h_HEADER_GUARD_
+
+#include <TelepathyQt/Global>
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <QLocalServer>
+#include <QObject>
+
+class QSocketNotifier;
+
+namespace Tp
+{
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+// Listens on a private Unix socket and forwards every connection made to it to a TCP socket, used
+// by StreamTubeServer to offer TCP services on tubes as Unix sockets. The bytes are moved between
+// the two sockets by the kernel (splice() through a pipe) where possible, and through a small
+// userspace buffer elsewhere.
+class TP_QT_NO_EXPORT StreamTubeRelay : public QLocalServer
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(StreamTubeRelay)
+
+public:
+    StreamTubeRelay(QObject *parent);
+    ~StreamTubeRelay();
+
+    static bool isSupported();
+
+    bool start();
+
+    // Only affects connections made after the call
+    void setTarget(const QHostAddress &address, quint16 port);
+
+    QHostAddress targetAddress() const { return mAddress; }
+    quint16 targetPort() const { return mPort; }
+
+    // Totals over all connections relayed so far
+    qint64 bytesToTarget() const { return mBytesToTarget; }
+    qint64 bytesToLocal() const { return mBytesToLocal; }
+
+protected:
+    void incomingConnection(quintptr socketDescriptor);
+
+private:
+    friend class StreamTubeRelayConnection;
+
+    QHostAddress mAddress;
+    quint16 mPort;
+    qint64 mBytesToTarget;
+    qint64 mBytesToLocal;
+};
+
+class TP_QT_NO_EXPORT StreamTubeRelayConnection : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(StreamTubeRelayConnection)
+
+public:
+    StreamTubeRelayConnection(int localFd, const QHostAddress &address, quint16 port,
+            StreamTubeRelay *relay);
+    ~StreamTubeRelayConnection();
+
+private Q_SLOTS:
+    void onTargetConnected();
+    void pumpToTarget();
+    void pumpToLocal();
+
+private:
+    struct Direction
+    {
+        Direction();
+
+        int from;
+        int to;
+        QSocketNotifier *readNotifier;
+        QSocketNotifier *writeNotifier;
+        int pipe[2];
+        QByteArray buffer;
+        qint64 pending;
+        qint64 *transferred;
+        bool eof;
+        bool done;
+    };
+
+    bool setUp(Direction &direction, int from, int to, qint64 *transferred,
+            const char *pumpSlot);
+    bool pump(Direction &direction);
+    void finish(const char *reason);
+
+    int mLocalFd;
+    int mTargetFd;
+    QSocketNotifier *mConnectNotifier;
+    Direction mToTarget;
+    Direction mToLocal;
+    bool mFinished;
+};
+
+#endif
+
+} // Tp
+
+#endif
@@ -34,8 +34,7 @@ class TP_QT_NO_EXPORT StreamTubeServer::TubeWrapper :
 
 public:
     TubeWrapper(const AccountPtr &acc, const OutgoingStreamTubeChannelPtr &tube,
-            const QHostAddress &exportedAddr, quint16 exportedPort, const QVariantMap &params,
-            StreamTubeServer *parent);
+            PendingOperation *offerOp, StreamTubeServer *parent);
     ~TubeWrapper() { }
 
     AccountPtr mAcc;
@@ -28,7 +28,10 @@
 
 #include "TelepathyQt/debug-internal.h"
 #include "TelepathyQt/simple-stream-tube-handler.h"
+#include "TelepathyQt/stream-tube-metrics-internal.h"
+#include "TelepathyQt/stream-tube-relay-internal.h"
 
+#include <QLocalServer>
 #include <QScopedPointer>
 #include <QSharedData>
 #include <QTcpServer>
@@ -300,7 +303,12 @@ struct StreamTubeServer::Private
           clientName(maybeClientName),
           isRegistered(false),
           exportedPort(0),
-          generator(0)
+          exportedUnixCredentials(false),
+          generator(0),
+          relayEnabled(false),
+          relay(0),
+          metrics(0),
+          metricsReportInterval(1000)
     {
         if (clientName.isEmpty()) {
             clientName = QString::fromLatin1("TpQtSTubeServer_%1_%2")
@@ -317,36 +325,84 @@ struct StreamTubeServer::Private
             return;
         }
 
-        debug() << "Register StreamTubeServer with name " << clientName;
+        tpDebug(logTubes) << "Register StreamTubeServer with name " << clientName;
 
         if (registrar->registerClient(handler, clientName)) {
             isRegistered = true;
         } else {
-            warning() << "StreamTubeServer" << clientName
+            tpWarning(logTubes) << "StreamTubeServer" << clientName
                 << "registration failed";
         }
     }
 
+    PendingOperation *offer(const OutgoingStreamTubeChannelPtr &tube, const QVariantMap &params,
+            StreamTubeServer *parent)
+    {
+        if (!exportedUnixAddr.isEmpty()) {
+            tpDebug(logTubes).nospace() << "Offering Unix socket " << exportedUnixAddr <<
+                " on tube " << tube->objectPath();
+            return tube->offerUnixSocket(exportedUnixAddr, params, exportedUnixCredentials);
+        }
+
+        Q_ASSERT(!exportedAddr.isNull() && exportedPort != 0);
+
+        if (relayEnabled && tube->supportsUnixSocketsOnLocalhost()) {
+            if (!relay) {
+                relay = new StreamTubeRelay(parent);
+                if (!relay->start()) {
+                    // Don't retry for every tube, the TCP socket can be offered directly anyway
+                    relayEnabled = false;
+                    delete relay;
+                    relay = 0;
+                } else if (metrics) {
+                    metrics->setRelay(relay);
+                }
+            }
+
+            if (relay) {
+                relay->setTarget(exportedAddr, exportedPort);
+                tpDebug(logTubes).nospace() << "Offering socket " << exportedAddr << ":" <<
+                    exportedPort << " through relay " << relay->fullServerName() <<
+                    " on tube " << tube->objectPath();
+                return tube->offerUnixSocket(relay->fullServerName(), params);
+            }
+        }
+
+        tpDebug(logTubes).nospace() << "Offering socket " << exportedAddr << ":" <<
+            exportedPort << " on tube " << tube->objectPath();
+        return tube->offerTcpSocket(exportedAddr, exportedPort, params);
+    }
+
     ClientRegistrarPtr registrar;
     SharedPtr<SimpleStreamTubeHandler> handler;
     QString clientName;
     bool isRegistered;
 
+    // Either a TCP or a Unix socket is exported at a time
     QHostAddress exportedAddr;
     quint16 exportedPort;
+    QString exportedUnixAddr;
+    bool exportedUnixCredentials;
     ParametersGenerator *generator;
     QScopedPointer<FixedParametersGenerator> fixedGenerator;
 
+    bool relayEnabled;
+    StreamTubeRelay *relay;
+
+    // Only allocated while metrics are enabled, so disabled metrics cost a pointer check per event
+    StreamTubeMetricsCollector *metrics;
+    int metricsReportInterval;
+
     QHash<StreamTubeChannelPtr, TubeWrapper *> tubes;
 
 };
 
 StreamTubeServer::TubeWrapper::TubeWrapper(const AccountPtr &acc,
-        const OutgoingStreamTubeChannelPtr &tube, const QHostAddress &exportedAddr,
-        quint16 exportedPort, const QVariantMap &params, StreamTubeServer *parent)
+        const OutgoingStreamTubeChannelPtr &tube, PendingOperation *offerOp,
+        StreamTubeServer *parent)
     : QObject(parent), mAcc(acc), mTube(tube)
 {
-    connect(tube->offerTcpSocket(exportedAddr, exportedPort, params),
+    connect(offerOp,
             SIGNAL(finished(Tp::PendingOperation*)),
             SLOT(onTubeOffered(Tp::PendingOperation*)));
     connect(tube.data(),
@@ -379,8 +435,8 @@ void StreamTubeServer::TubeWrapper::onConnectionClosed(uint conn, const QString
  * \headerfile TelepathyQt/stream-tube-server.h <TelepathyQt/StreamTubeServer>
  *
  * \brief The StreamTubeServer class is a Handler implementation for outgoing %Stream %Tube channels,
- * allowing an application to easily export a TCP network server over Telepathy Tubes without
- * worrying about the channel dispatching details.
+ * allowing an application to easily export a TCP network server or a Unix socket server over Telepathy
+ * Tubes without worrying about the channel dispatching details.
  *
  * Telepathy Tubes is a technology for connecting arbitrary applications together through the IM
  * network (and sometimes with direct peer-to-peer connections), such that issues like firewall/NAT
@@ -434,7 +490,6 @@ void StreamTubeServer::TubeWrapper::onConnectionClosed(uint conn, const QString
  *
  * \todo Coin up a small Python script or alike to easily generate the .client and .service files.
  * (fd.o #41614)
- * \todo Support exporting Unix sockets as well. (fd.o #41615)
  */
 
 /**
@@ -659,7 +714,7 @@ bool StreamTubeServer::monitorsConnections() const
  * Return the host address and port of the currently exported TCP socket, if any.
  *
  * QHostAddress::Null is reported as the address and 0 as the port if no TCP socket has yet been
- * successfully exported.
+ * successfully exported, or a Unix socket has been exported since.
  *
  * \return The host address and port values in a pair structure.
  */
@@ -668,6 +723,32 @@ QPair<QHostAddress, quint16> StreamTubeServer::exportedTcpSocketAddress() const
     return qMakePair(mPriv->exportedAddr, mPriv->exportedPort);
 }
 
+/**
+ * Return the address of the currently exported Unix socket, if any.
+ *
+ * Abstract Unix socket addresses start with a \c NUL byte. An empty string is reported if no Unix
+ * socket has yet been successfully exported, or a TCP socket has been exported since.
+ *
+ * \return The socket address.
+ * \sa exportedUnixSocketRequiresCredentials()
+ */
+QString StreamTubeServer::exportedUnixSocketAddress() const
+{
+    return mPriv->exportedUnixAddr;
+}
+
+/**
+ * Return whether the currently exported Unix socket was exported requiring credentials.
+ *
+ * \return \c true if the connection managers were asked to pass credentials when connecting to
+ * the socket, \c false otherwise or if no Unix socket is exported.
+ * \sa exportUnixSocket()
+ */
+bool StreamTubeServer::exportedUnixSocketRequiresCredentials() const
+{
+    return !mPriv->exportedUnixAddr.isEmpty() && mPriv->exportedUnixCredentials;
+}
+
 /**
  * Return the fixed parameters, if any, which are sent along when offering the exported socket on
  * all handled tubes.
@@ -723,12 +804,16 @@ void StreamTubeServer::exportTcpSocket(
         const QVariantMap &parameters)
 {
     if (address.isNull() || port == 0) {
-        warning() << "Attempted to export null TCP socket address or zero port, ignoring";
+        tpWarning(logTubes) << "Attempted to export null TCP socket address or zero port, ignoring";
         return;
     }
 
     mPriv->exportedAddr = address;
     mPriv->exportedPort = port;
+    mPriv->exportedUnixAddr.clear();
+    if (mPriv->relay) {
+        mPriv->relay->setTarget(address, port);
+    }
 
     mPriv->generator = 0;
     if (!parameters.isEmpty()) {
@@ -760,7 +845,7 @@ void StreamTubeServer::exportTcpSocket(
         const QVariantMap &parameters)
 {
     if (!server->isListening()) {
-        warning() << "Attempted to export non-listening QTcpServer, ignoring";
+        tpWarning(logTubes) << "Attempted to export non-listening QTcpServer, ignoring";
         return;
     }
 
@@ -796,12 +881,16 @@ void StreamTubeServer::exportTcpSocket(
         ParametersGenerator *generator)
 {
     if (address.isNull() || port == 0) {
-        warning() << "Attempted to export null TCP socket address or zero port, ignoring";
+        tpWarning(logTubes) << "Attempted to export null TCP socket address or zero port, ignoring";
         return;
     }
 
     mPriv->exportedAddr = address;
     mPriv->exportedPort = port;
+    mPriv->exportedUnixAddr.clear();
+    if (mPriv->relay) {
+        mPriv->relay->setTarget(address, port);
+    }
     mPriv->generator = generator;
 
     mPriv->ensureRegistered();
@@ -823,7 +912,7 @@ void StreamTubeServer::exportTcpSocket(
         ParametersGenerator *generator)
 {
     if (!server->isListening()) {
-        warning() << "Attempted to export non-listening QTcpServer, ignoring";
+        tpWarning(logTubes) << "Attempted to export non-listening QTcpServer, ignoring";
         return;
     }
 
@@ -840,6 +929,188 @@ void StreamTubeServer::exportTcpSocket(
     }
 }
 
+/**
+ * Set the server to offer the Unix socket listening at the given \a socketAddress as the local
+ * endpoint of tubes handled in the future.
+ *
+ * Abstract Unix sockets are also supported, and are given as addresses prefixed with a \c NUL byte.
+ * This replaces any TCP socket exported earlier with exportTcpSocket(), and vice versa.
+ *
+ * If \a requireCredentials is \c true, the protocol backends are asked to pass an SCM_CREDS or
+ * SCM_CREDENTIALS message, as supported by the platform, along with a single byte when connecting to
+ * the socket. The service can then check that connections only come from the intended local user.
+ * This is in-band in the data stream, so the service must expect it. Tubes on protocol backends
+ * that don't support this for the given kind of socket fail to be offered, and are closed; see
+ * OutgoingStreamTubeChannel::offerUnixSocket() for the details.
+ *
+ * A fixed set of protocol bootstrapping \a parameters can optionally be set to be sent along with
+ * all tube offers until the next call to exportUnixSocket() or exportTcpSocket(). See the
+ * ParametersGenerator documentation for an in-depth description of the parameter transfer
+ * mechanism.
+ *
+ * The handler is registered on the bus at the latest when this method or another export method is
+ * called for the first time, so one should check the return value of isRegistered() at that point
+ * to verify that was successful.
+ *
+ * \param socketAddress The address of the socket.
+ * \param parameters The bootstrapping parameters in a string-value map.
+ * \param requireCredentials Whether the connection managers should pass credentials when
+ *                           connecting.
+ */
+void StreamTubeServer::exportUnixSocket(
+        const QString &socketAddress,
+        const QVariantMap &parameters,
+        bool requireCredentials)
+{
+    if (socketAddress.isEmpty()) {
+        tpWarning(logTubes) << "Attempted to export empty Unix socket address, ignoring";
+        return;
+    }
+
+    mPriv->exportedUnixAddr = socketAddress;
+    mPriv->exportedUnixCredentials = requireCredentials;
+    mPriv->exportedAddr = QHostAddress();
+    mPriv->exportedPort = 0;
+
+    mPriv->generator = 0;
+    if (!parameters.isEmpty()) {
+        mPriv->fixedGenerator.reset(new FixedParametersGenerator(parameters));
+        mPriv->generator = mPriv->fixedGenerator.data();
+    }
+
+    mPriv->ensureRegistered();
+}
+
+/**
+ * Set the StreamTubeServer to offer the already listening local \a server as the local endpoint of
+ * tubes handled in the future.
+ *
+ * This is just a convenience wrapper around
+ * exportUnixSocket(const QString &, const QVariantMap &, bool) to be used when the server code is
+ * implemented using QLocalServer.
+ *
+ * \param server A pointer to the local server.
+ * \param parameters The bootstrapping parameters in a string-value map.
+ * \param requireCredentials Whether the connection managers should pass credentials when
+ *                           connecting.
+ */
+void StreamTubeServer::exportUnixSocket(
+        const QLocalServer *server,
+        const QVariantMap &parameters,
+        bool requireCredentials)
+{
+    if (!server->isListening()) {
+        tpWarning(logTubes) << "Attempted to export non-listening QLocalServer, ignoring";
+        return;
+    }
+
+    return exportUnixSocket(server->fullServerName(), parameters, requireCredentials);
+}
+
+/**
+ * Set the server to offer the Unix socket listening at the given \a socketAddress as the local
+ * endpoint of tubes handled in the future, sending the parameters from the given \a generator along
+ * with the offers.
+ *
+ * See exportUnixSocket(const QString &, const QVariantMap &, bool) for the details.
+ *
+ * \param socketAddress The address of the socket.
+ * \param generator A pointer to the bootstrapping parameters generator.
+ * \param requireCredentials Whether the connection managers should pass credentials when
+ *                           connecting.
+ */
+void StreamTubeServer::exportUnixSocket(
+        const QString &socketAddress,
+        ParametersGenerator *generator,
+        bool requireCredentials)
+{
+    if (socketAddress.isEmpty()) {
+        tpWarning(logTubes) << "Attempted to export empty Unix socket address, ignoring";
+        return;
+    }
+
+    mPriv->exportedUnixAddr = socketAddress;
+    mPriv->exportedUnixCredentials = requireCredentials;
+    mPriv->exportedAddr = QHostAddress();
+    mPriv->exportedPort = 0;
+    mPriv->generator = generator;
+
+    mPriv->ensureRegistered();
+}
+
+/**
+ * Set the server to offer the already listening local \a server as the local endpoint of tubes
+ * handled in the future, sending the parameters from the given \a generator along with the offers.
+ *
+ * This is just a convenience wrapper around
+ * exportUnixSocket(const QString &, ParametersGenerator *, bool) to be used when the server code
+ * is implemented using QLocalServer.
+ *
+ * \param server A pointer to the local server.
+ * \param generator A pointer to the bootstrapping parameters generator.
+ * \param requireCredentials Whether the connection managers should pass credentials when
+ *                           connecting.
+ */
+void StreamTubeServer::exportUnixSocket(
+        const QLocalServer *server,
+        ParametersGenerator *generator,
+        bool requireCredentials)
+{
+    if (!server->isListening()) {
+        tpWarning(logTubes) << "Attempted to export non-listening QLocalServer, ignoring";
+        return;
+    }
+
+    return exportUnixSocket(server->fullServerName(), generator, requireCredentials);
+}
+
+/**
+ * Return whether exported TCP sockets are offered through an in-process Unix socket relay.
+ *
+ * \return \c true if the relay is enabled, \c false otherwise.
+ * \sa setUnixRelayEnabled()
+ */
+bool StreamTubeServer::isUnixRelayEnabled() const
+{
+    return mPriv->relayEnabled;
+}
+
+/**
+ * Set whether exported TCP sockets should be offered through an in-process Unix socket relay.
+ *
+ * Protocol backends reach an exported TCP socket over the loopback interface. When the relay is
+ * enabled, tubes handled in the future on backends supporting Unix sockets are instead offered a
+ * private Unix socket owned by this server, which forwards each connection to the exported TCP
+ * socket. On Linux, the data is moved between the two sockets with splice(), without being copied
+ * through this process. Only connections from the same user are accepted, as checked by the socket
+ * peer credentials. The socket is also created in \c $XDG_RUNTIME_DIR, if set, which other users
+ * can't enter.
+ *
+ * Tubes on backends not supporting Unix sockets are still offered the TCP socket directly. Exporting
+ * a Unix socket with exportUnixSocket() always offers it directly.
+ *
+ * The source addresses of relayed connections aren't known, so newTcpConnection() and
+ * tcpConnectionClosed() are not emitted for them, and tcpConnections() doesn't include them; use
+ * newConnection(), connectionClosed() and connections() instead. Connections made through an
+ * already offered relayed tube after exportTcpSocket() has been called again go to the newly
+ * exported socket.
+ *
+ * The relay is only available on Unix platforms which can tell the user on the other end of a
+ * local socket (\c SO_PEERCRED or \c getpeereid()). Elsewhere, enabling it has no effect.
+ *
+ * \param enabled Whether the relay should be enabled.
+ * \sa isUnixRelayEnabled()
+ */
+void StreamTubeServer::setUnixRelayEnabled(bool enabled)
+{
+    if (enabled && !StreamTubeRelay::isSupported()) {
+        tpWarning(logTubes) << "Unix socket relay not supported on this platform, ignoring";
+        return;
+    }
+
+    mPriv->relayEnabled = enabled;
+}
+
 /**
  * Return the tubes currently handled by the server.
  *
@@ -880,7 +1151,8 @@ QHash<QPair<QHostAddress, quint16>,
 {
     QHash<QPair<QHostAddress /* sourceAddress */, quint16 /* sourcePort */>, RemoteContact> conns;
     if (!monitorsConnections()) {
-        warning() << "StreamTubeServer::tcpConnections() used, but connection monitoring is disabled";
+        tpWarning(logTubes) <<
+            "StreamTubeServer::tcpConnections() used, but connection monitoring is disabled";
         return conns;
     }
 
@@ -921,6 +1193,192 @@ QHash<QPair<QHostAddress, quint16>,
     return conns;
 }
 
+/**
+ * Return the ongoing connections over tubes handled by this server, whichever kind of socket they
+ * were made to.
+ *
+ * The returned mapping has for each Tube a structure containing pointers to the account and tube
+ * channel objects as keys, with the current connections on them as values. These map the integer
+ * connection ids, which are unique amongst the connections active on a single tube at any given
+ * time but not globally, to the remote contacts the connections are from.
+ *
+ * This is effectively a state recovery accessor corresponding to the change notification signals
+ * newConnection() and connectionClosed().
+ *
+ * The mapping is only populated if connection monitoring was requested when creating the server (so
+ * monitorsConnections() returns \c true).
+ *
+ * \return The connections in a mapping with Tube structures as keys and maps from connection ids to
+ * remote contacts as values.
+ */
+QHash<StreamTubeServer::Tube, QHash<uint, StreamTubeServer::RemoteContact> >
+    StreamTubeServer::connections() const
+{
+    QHash<Tube, QHash<uint, RemoteContact> > conns;
+    if (!monitorsConnections()) {
+        tpWarning(logTubes) <<
+            "StreamTubeServer::connections() used, but connection monitoring is disabled";
+        return conns;
+    }
+
+    foreach (const Tube &tube, tubes()) {
+        // As in tcpConnections(), skip tubes which aren't or are no longer open
+        if (!tube.channel()->isValid() || tube.channel()->state() != TubeChannelStateOpen) {
+            continue;
+        }
+
+        QHash<uint, ContactPtr> connContacts = tube.channel()->contactsForConnections();
+        if (connContacts.isEmpty()) {
+            continue;
+        }
+
+        QHash<uint, RemoteContact> tubeConns;
+        for (QHash<uint, ContactPtr>::const_iterator i = connContacts.constBegin();
+                i != connContacts.constEnd(); ++i) {
+            tubeConns.insert(i.key(), RemoteContact(tube.account(), i.value()));
+        }
+        conns.insert(tube, tubeConns);
+    }
+
+    return conns;
+}
+
+/**
+ * Return whether timing and throughput metrics are being collected for the tubes handled by this
+ * server.
+ *
+ * \return \c true if metrics are enabled, \c false otherwise.
+ * \sa setMetricsEnabled()
+ */
+bool StreamTubeServer::isMetricsEnabled() const
+{
+    return mPriv->metrics != 0;
+}
+
+/**
+ * Set whether timing and throughput metrics should be collected for the tubes handled by this
+ * server.
+ *
+ * When enabled, the server measures how long the tubes take to be accepted by the remote contacts
+ * after being offered, and, if connection monitoring was requested when creating the server, how
+ * long the first connections take to be made and how long the connections stay open. The results
+ * can be polled with metrics() and connectionMetrics(), and are also reported periodically with
+ * metricsUpdated().
+ *
+ * Only the tubes handled after metrics are enabled are measured. Disabling metrics discards
+ * everything collected so far. Metrics are disabled by default, in which case they have no cost
+ * beyond a pointer check whenever a tube or connection changes.
+ *
+ * \param enabled Whether metrics should be collected.
+ * \sa StreamTubeMetrics
+ */
+void StreamTubeServer::setMetricsEnabled(bool enabled)
+{
+    if (enabled == isMetricsEnabled()) {
+        return;
+    }
+
+    if (!enabled) {
+        delete mPriv->metrics;
+        mPriv->metrics = 0;
+        return;
+    }
+
+    mPriv->metrics = new StreamTubeMetricsCollector(this);
+    mPriv->metrics->setReportInterval(mPriv->metricsReportInterval);
+    mPriv->metrics->setRelay(mPriv->relay);
+    connect(mPriv->metrics,
+            SIGNAL(reportDue(Tp::StreamTubeMetrics)),
+            SIGNAL(metricsUpdated(Tp::StreamTubeMetrics)));
+}
+
+/**
+ * Return the minimum interval between two metricsUpdated() signals.
+ *
+ * \return The interval in milliseconds, or 0 if the signal is disabled.
+ * \sa setMetricsReportInterval()
+ */
+int StreamTubeServer::metricsReportInterval() const
+{
+    return mPriv->metricsReportInterval;
+}
+
+/**
+ * Set the minimum interval between two metricsUpdated() signals.
+ *
+ * The changes happening during an interval are reported together at its end, so there is at most
+ * one signal per interval however busy the tubes are. The default interval is one second. Setting
+ * an interval of 0 disables the signal, leaving metrics() to be polled as needed.
+ *
+ * \param msecs The interval in milliseconds.
+ */
+void StreamTubeServer::setMetricsReportInterval(int msecs)
+{
+    mPriv->metricsReportInterval = qMax(msecs, 0);
+    if (mPriv->metrics) {
+        mPriv->metrics->setReportInterval(mPriv->metricsReportInterval);
+    }
+}
+
+/**
+ * Return the metrics aggregated over all of the tubes handled since metrics were enabled,
+ * including the ones which have since been closed.
+ *
+ * If the Unix socket relay is in use (see setUnixRelayEnabled()), the amount of data which has gone
+ * through it is included as well.
+ *
+ * \return The aggregate metrics, or an invalid StreamTubeMetrics if metrics are disabled.
+ * \sa isMetricsEnabled()
+ */
+StreamTubeMetrics StreamTubeServer::metrics() const
+{
+    if (!mPriv->metrics) {
+        tpWarning(logTubes) << "StreamTubeServer::metrics() used, but metrics are disabled";
+        return StreamTubeMetrics();
+    }
+
+    return mPriv->metrics->total();
+}
+
+/**
+ * Return the metrics of a single tube currently handled by this server.
+ *
+ * \param tube The tube, as returned by tubes().
+ * \return The metrics of the tube, or an invalid StreamTubeMetrics if metrics are disabled, or the
+ * tube isn't handled by this server or was handled before metrics were enabled.
+ */
+StreamTubeMetrics StreamTubeServer::metrics(const Tube &tube) const
+{
+    if (!mPriv->metrics) {
+        tpWarning(logTubes) << "StreamTubeServer::metrics() used, but metrics are disabled";
+        return StreamTubeMetrics();
+    }
+
+    return mPriv->metrics->forTube(tube.channel());
+}
+
+/**
+ * Return the metrics of a single connection currently open through a tube handled by this server.
+ *
+ * This requires connection monitoring to have been requested when creating the server.
+ *
+ * \param tube The tube, as returned by tubes().
+ * \param connectionId The id of the connection, as signaled by newConnection().
+ * \return The metrics of the connection, or an invalid StreamTubeConnectionMetrics if metrics are
+ * disabled or the connection isn't known.
+ */
+StreamTubeConnectionMetrics StreamTubeServer::connectionMetrics(const Tube &tube,
+        uint connectionId) const
+{
+    if (!mPriv->metrics) {
+        tpWarning(logTubes) <<
+            "StreamTubeServer::connectionMetrics() used, but metrics are disabled";
+        return StreamTubeConnectionMetrics();
+    }
+
+    return mPriv->metrics->forConnection(tube.channel(), connectionId);
+}
+
 void StreamTubeServer::onInvokedForTube(
         const AccountPtr &acc,
         const StreamTubeChannelPtr &tube,
@@ -936,25 +1394,24 @@ void StreamTubeServer::onInvokedForTube(
     if (outgoing) {
         emit tubeRequested(acc, outgoing, time, hints);
     } else {
-        warning() << "The ChannelFactory used by StreamTubeServer must construct" <<
+        tpWarning(logTubes) << "The ChannelFactory used by StreamTubeServer must construct" <<
             "OutgoingStreamTubeChannel subclasses for Requested=true StreamTubes";
         tube->requestClose();
         return;
     }
 
     if (!mPriv->tubes.contains(tube)) {
-        debug().nospace() << "Offering socket " << mPriv->exportedAddr << ":" << mPriv->exportedPort
-            << " on tube " << tube->objectPath();
-
         QVariantMap params;
         if (mPriv->generator) {
             params = mPriv->generator->nextParameters(acc, outgoing, hints);
         }
 
-        Q_ASSERT(!mPriv->exportedAddr.isNull() && mPriv->exportedPort != 0);
+        if (mPriv->metrics) {
+            mPriv->metrics->tubeHandled(outgoing);
+        }
 
         TubeWrapper *wrapper =
-            new TubeWrapper(acc, outgoing, mPriv->exportedAddr, mPriv->exportedPort, params, this);
+            new TubeWrapper(acc, outgoing, mPriv->offer(outgoing, params, this), this);
 
         connect(wrapper,
                 SIGNAL(offerFinished(TubeWrapper*,Tp::PendingOperation*)),
@@ -983,7 +1440,7 @@ void StreamTubeServer::onOfferFinished(
     OutgoingStreamTubeChannelPtr tube = wrapper->mTube;
 
     if (op->isError()) {
-        warning() << "Offer() failed, closing tube" << tube->objectPath() << '-' <<
+        tpWarning(logTubes) << "Offer() failed, closing tube" << tube->objectPath() << '-' <<
             op->errorName() << ':' << op->errorMessage();
 
         if (wrapper->mTube->isValid()) {
@@ -991,11 +1448,17 @@ void StreamTubeServer::onOfferFinished(
         }
 
         wrapper->mTube->disconnect(this);
+        if (mPriv->metrics) {
+            mPriv->metrics->tubeClosed(tube);
+        }
         emit tubeClosed(wrapper->mAcc, wrapper->mTube, op->errorName(), op->errorMessage());
         mPriv->tubes.remove(wrapper->mTube);
         wrapper->deleteLater();
     } else {
-        debug() << "Tube" << tube->objectPath() << "offered successfully";
+        tpDebug(logTubes) << "Tube" << tube->objectPath() << "offered successfully";
+        if (mPriv->metrics) {
+            mPriv->metrics->tubeSetUp(tube);
+        }
     }
 }
 
@@ -1013,8 +1476,12 @@ void StreamTubeServer::onTubeInvalidated(
         return;
     }
 
-    debug() << "Tube" << tube->objectPath() << "invalidated with" << error << ':' << message;
+    tpDebug(logTubes) << "Tube" << tube->objectPath() << "invalidated with" << error << ':' <<
+        message;
 
+    if (mPriv->metrics) {
+        mPriv->metrics->tubeClosed(tube);
+    }
     emit tubeClosed(wrapper->mAcc, wrapper->mTube, error, message);
     mPriv->tubes.remove(tube);
     delete wrapper;
@@ -1026,20 +1493,20 @@ void StreamTubeServer::onNewConnection(
 {
     Q_ASSERT(monitorsConnections());
 
+    if (mPriv->metrics) {
+        mPriv->metrics->connectionOpened(wrapper->mTube, conn);
+    }
+
+    ContactPtr contact = wrapper->mTube->contactsForConnections().value(conn);
+
     if (wrapper->mTube->addressType() == SocketAddressTypeIPv4
             || wrapper->mTube->addressType() == SocketAddressTypeIPv6) {
-        QHash<QPair<QHostAddress,quint16>, uint> srcAddrConns =
-            wrapper->mTube->connectionsForSourceAddresses();
-        QHash<uint, Tp::ContactPtr> connContacts =
-            wrapper->mTube->contactsForConnections();
-
-        QPair<QHostAddress, quint16> srcAddr = srcAddrConns.key(conn);
+        QPair<QHostAddress, quint16> srcAddr = wrapper->mTube->sourceAddressForConnection(conn);
         emit newTcpConnection(srcAddr.first, srcAddr.second, wrapper->mAcc,
-                connContacts.value(conn), wrapper->mTube);
-    } else {
-        // No UNIX socket should ever have been offered yet
-        Q_ASSERT(false);
+                contact, wrapper->mTube);
     }
+
+    emit newConnection(wrapper->mAcc, wrapper->mTube, conn, contact);
 }
 
 void StreamTubeServer::onConnectionClosed(
@@ -1050,20 +1517,20 @@ void StreamTubeServer::onConnectionClosed(
 {
     Q_ASSERT(monitorsConnections());
 
+    if (mPriv->metrics) {
+        mPriv->metrics->connectionClosed(wrapper->mTube, conn);
+    }
+
+    ContactPtr contact = wrapper->mTube->contactsForConnections().value(conn);
+
     if (wrapper->mTube->addressType() == SocketAddressTypeIPv4
             || wrapper->mTube->addressType() == SocketAddressTypeIPv6) {
-        QHash<QPair<QHostAddress,quint16>, uint> srcAddrConns =
-            wrapper->mTube->connectionsForSourceAddresses();
-        QHash<uint, Tp::ContactPtr> connContacts =
-            wrapper->mTube->contactsForConnections();
-
-        QPair<QHostAddress, quint16> srcAddr = srcAddrConns.key(conn);
+        QPair<QHostAddress, quint16> srcAddr = wrapper->mTube->sourceAddressForConnection(conn);
         emit tcpConnectionClosed(srcAddr.first, srcAddr.second, wrapper->mAcc,
-                connContacts.value(conn), error, message, wrapper->mTube);
-    } else {
-        // No UNIX socket should ever have been offered yet
-        Q_ASSERT(false);
+                contact, error, message, wrapper->mTube);
     }
+
+    emit connectionClosed(wrapper->mAcc, wrapper->mTube, conn, contact, error, message);
 }
 
 /**
@@ -1139,4 +1606,52 @@ void StreamTubeServer::onConnectionClosed(
  * \param tube A pointer to the tube channel through which the connection has been made.
  */
 
+/**
+ * \fn void StreamTubeServer::newConnection(const AccountPtr &account, const
+ * OutgoingStreamTubeChannelPtr &tube, uint connectionId, const ContactPtr &contact)
+ *
+ * Emitted when we have picked up a new connection to the (current or previous) exported server
+ * socket, be it a TCP or a Unix one.
+ *
+ * For TCP sockets this is emitted right after newTcpConnection(). The \a connectionId is only
+ * unique amongst the connections active on \a tube at any given time.
+ *
+ * This is only emitted if connection monitoring was enabled when creating the StreamTubeServer.
+ *
+ * \param account A pointer to the account through which the remote contact can be reached.
+ * \param tube A pointer to the tube channel through which the connection has been made.
+ * \param connectionId The integer id of the connection on \a tube.
+ * \param contact A pointer to the remote contact object.
+ */
+
+/**
+ * \fn void StreamTubeServer::connectionClosed(const AccountPtr &account, const
+ * OutgoingStreamTubeChannelPtr &tube, uint connectionId, const ContactPtr &contact, const QString
+ * &error, const QString &message)
+ *
+ * Emitted when a connection (previously announced with newConnection()) through one of our handled
+ * tubes has been closed due to an error or by a graceful disconnect (in which case the error is
+ * ::TP_QT_ERROR_DISCONNECTED).
+ *
+ * This is only emitted if connection monitoring was enabled when creating the StreamTubeServer.
+ *
+ * \param account A pointer to the account through which the remote contact can be reached.
+ * \param tube A pointer to the tube channel through which the connection has been made.
+ * \param connectionId The integer id of the connection on \a tube.
+ * \param contact A pointer to the remote contact object.
+ * \param error The D-Bus error name corresponding to the reason for the closure.
+ * \param message A freeform debug message associated with the error.
+ */
+
+/**
+ * \fn void StreamTubeServer::metricsUpdated(const Tp::StreamTubeMetrics &metrics)
+ *
+ * Emitted with the aggregate metrics when tubes or connections have changed, at most once per
+ * metricsReportInterval().
+ *
+ * This is only emitted if metrics are enabled, see setMetricsEnabled().
+ *
+ * \param metrics The metrics aggregated over all of the tubes handled since metrics were enabled.
+ */
+
 } // Tp
@@ -31,9 +31,11 @@
 #include <TelepathyQt/ConnectionFactory>
 #include <TelepathyQt/ContactFactory>
 #include <TelepathyQt/RefCounted>
+#include <TelepathyQt/StreamTubeMetrics>
 #include <TelepathyQt/Types>
 
 class QHostAddress;
+class QLocalServer;
 class QTcpServer;
 
 namespace Tp
@@ -162,6 +164,8 @@ public:
     bool monitorsConnections() const;
 
     QPair<QHostAddress, quint16> exportedTcpSocketAddress() const;
+    QString exportedUnixSocketAddress() const;
+    bool exportedUnixSocketRequiresCredentials() const;
     QVariantMap exportedParameters() const;
 
     void exportTcpSocket(
@@ -180,9 +184,40 @@ public:
             const QTcpServer *server,
             ParametersGenerator *generator);
 
+    void exportUnixSocket(
+            const QString &socketAddress,
+            const QVariantMap &parameters = QVariantMap(),
+            bool requireCredentials = false);
+    void exportUnixSocket(
+            const QLocalServer *server,
+            const QVariantMap &parameters = QVariantMap(),
+            bool requireCredentials = false);
+
+    void exportUnixSocket(
+            const QString &socketAddress,
+            ParametersGenerator *generator,
+            bool requireCredentials = false);
+    void exportUnixSocket(
+            const QLocalServer *server,
+            ParametersGenerator *generator,
+            bool requireCredentials = false);
+
+    bool isUnixRelayEnabled() const;
+    void setUnixRelayEnabled(bool enabled);
+
     QList<Tube> tubes() const;
 
     QHash<QPair<QHostAddress, quint16>, RemoteContact> tcpConnections() const;
+    QHash<Tube, QHash<uint, RemoteContact> > connections() const;
+
+    bool isMetricsEnabled() const;
+    void setMetricsEnabled(bool enabled);
+    int metricsReportInterval() const;
+    void setMetricsReportInterval(int msecs);
+
+    StreamTubeMetrics metrics() const;
+    StreamTubeMetrics metrics(const Tube &tube) const;
+    StreamTubeConnectionMetrics connectionMetrics(const Tube &tube, uint connectionId) const;
 
 Q_SIGNALS:
 
@@ -212,6 +247,21 @@ Q_SIGNALS:
             const QString &message,
             const Tp::OutgoingStreamTubeChannelPtr &tube);
 
+    void newConnection(
+            const Tp::AccountPtr &account,
+            const Tp::OutgoingStreamTubeChannelPtr &tube,
+            uint connectionId,
+            const Tp::ContactPtr &contact);
+    void connectionClosed(
+            const Tp::AccountPtr &account,
+            const Tp::OutgoingStreamTubeChannelPtr &tube,
+            uint connectionId,
+            const Tp::ContactPtr &contact,
+            const QString &error,
+            const QString &message);
+
+    void metricsUpdated(const Tp::StreamTubeMetrics &metrics);
+
 private Q_SLOTS:
     TP_QT_NO_EXPORT void onInvokedForTube(
             const Tp::AccountPtr &account,
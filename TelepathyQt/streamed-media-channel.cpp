@@ -119,11 +119,11 @@ StreamedMediaChannelPtr PendingStreamedMediaStreams::channel() const
 StreamedMediaStreams PendingStreamedMediaStreams::streams() const
 {
     if (!isFinished()) {
-        warning() << "PendingStreamedMediaStreams::streams called before finished, "
+        tpWarning(logChannels) << "PendingStreamedMediaStreams::streams called before finished, "
             "returning empty list";
         return StreamedMediaStreams();
     } else if (!isValid()) {
-        warning() << "PendingStreamedMediaStreams::streams called when not valid, "
+        tpWarning(logChannels) << "PendingStreamedMediaStreams::streams called when not valid, "
             "returning empty list";
         return StreamedMediaStreams();
     }
@@ -135,7 +135,7 @@ void PendingStreamedMediaStreams::gotStreams(QDBusPendingCallWatcher *watcher)
 {
     QDBusPendingReply<MediaStreamInfoList> reply = *watcher;
     if (reply.isError()) {
-        warning().nospace() << "StreamedMedia::RequestStreams()"
+        tpWarning(logChannels).nospace() << "StreamedMedia::RequestStreams()"
             " failed with " << reply.error().name() << ": " <<
             reply.error().message();
         setFinishedWithError(reply.error());
@@ -143,7 +143,7 @@ void PendingStreamedMediaStreams::gotStreams(QDBusPendingCallWatcher *watcher)
         return;
     }
 
-    debug() << "Got reply to StreamedMedia::RequestStreams()";
+    tpDebug(logChannels) << "Got reply to StreamedMedia::RequestStreams()";
 
     MediaStreamInfoList list = reply.value();
     foreach (const MediaStreamInfo &streamInfo, list) {
@@ -194,11 +194,11 @@ void PendingStreamedMediaStreams::onStreamReady(PendingOperation *op)
     }
 
     mPriv->streamsReady++;
-    debug() << "PendingStreamedMediaStreams:";
-    debug() << "  Streams count:" << mPriv->numStreams;
-    debug() << "  Streams ready:" << mPriv->streamsReady;
+    tpDebug(logChannels) << "PendingStreamedMediaStreams:";
+    tpDebug(logChannels) << "  Streams count:" << mPriv->numStreams;
+    tpDebug(logChannels) << "  Streams ready:" << mPriv->streamsReady;
     if (mPriv->streamsReady == mPriv->numStreams) {
-        debug() << "All streams are ready";
+        tpDebug(logChannels) << "All streams are ready";
         setFinished();
     }
 }
@@ -256,17 +256,17 @@ StreamedMediaStream::Private::Private(StreamedMediaStream *parent,
 
 void StreamedMediaStream::Private::introspectContact(StreamedMediaStream::Private *self)
 {
-    debug() << "Introspecting stream";
+    tpDebug(logChannels) << "Introspecting stream";
     if (self->contactHandle == 0) {
-        debug() << "Stream ready";
+        tpDebug(logChannels) << "Stream ready";
         self->readinessHelper->setIntrospectCompleted(FeatureCore, true);
         return;
     }
 
-    debug() << "Introspecting stream contact";
+    tpDebug(logChannels) << "Introspecting stream contact";
     ContactManagerPtr contactManager =
         self->parent->channel()->connection()->contactManager();
-    debug() << "contact manager" << contactManager;
+    tpDebug(logChannels) << "contact manager" << contactManager;
     // TODO: pass id hints to ContactManager if we ever gain support to retrieve contact ids
     //       from MediaStreamInfo or something similar.
     self->parent->connect(contactManager->contactsForHandles(
@@ -531,7 +531,8 @@ PendingOperation *StreamedMediaStream::startDTMFTone(DTMFEvent event)
 {
     StreamedMediaChannelPtr chan(channel());
     if (!chan->interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_DTMF)) {
-        warning() << "StreamedMediaStream::startDTMFTone() used with no dtmf interface";
+        tpWarning(logChannels) <<
+            "StreamedMediaStream::startDTMFTone() used with no dtmf interface";
         return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("StreamedMediaChannel does not support dtmf interface"),
                 StreamedMediaStreamPtr(this));
@@ -566,7 +567,7 @@ PendingOperation *StreamedMediaStream::stopDTMFTone()
 {
     StreamedMediaChannelPtr chan(channel());
     if (!chan->interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_DTMF)) {
-        warning() << "StreamedMediaStream::stopDTMFTone() used with no dtmf interface";
+        tpWarning(logChannels) << "StreamedMediaStream::stopDTMFTone() used with no dtmf interface";
         return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("StreamedMediaChannel does not support dtmf interface"),
                 StreamedMediaStreamPtr(this));
@@ -679,7 +680,7 @@ void StreamedMediaStream::gotContact(PendingOperation *op)
     Q_ASSERT(pc->isForHandles());
 
     if (op->isError()) {
-        warning().nospace() << "Gathering media stream contact failed: "
+        tpWarning(logChannels).nospace() << "Gathering media stream contact failed: "
             << op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
                 op->errorName(), op->errorMessage());
@@ -693,12 +694,13 @@ void StreamedMediaStream::gotContact(PendingOperation *op)
         Q_ASSERT(invalidHandles.size() == 0);
         mPriv->contact = contacts.first();
 
-        debug() << "Got stream contact";
-        debug() << "Stream ready";
+        tpDebug(logChannels) << "Got stream contact";
+        tpDebug(logChannels) << "Stream ready";
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, true);
     } else {
         Q_ASSERT(invalidHandles.size() == 1);
-        warning().nospace() << "Error retrieving media stream contact (invalid handle)";
+        tpWarning(logChannels).nospace() <<
+            "Error retrieving media stream contact (invalid handle)";
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
                 TP_QT_ERROR_INVALID_ARGUMENT,
                 QLatin1String("Invalid contact handle"));
@@ -1149,9 +1151,11 @@ bool StreamedMediaChannel::handlerStreamingRequired() const
 LocalHoldState StreamedMediaChannel::localHoldState() const
 {
     if (!isReady(FeatureLocalHoldState)) {
-        warning() << "StreamedMediaChannel::localHoldState() used with FeatureLocalHoldState not ready";
+        tpWarning(logChannels) <<
+            "StreamedMediaChannel::localHoldState() used with FeatureLocalHoldState not ready";
     } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_HOLD)) {
-        warning() << "StreamedMediaChannel::localHoldStateReason() used with no hold interface";
+        tpWarning(logChannels) <<
+            "StreamedMediaChannel::localHoldStateReason() used with no hold interface";
     }
 
     return mPriv->localHoldState;
@@ -1168,9 +1172,11 @@ LocalHoldState StreamedMediaChannel::localHoldState() const
 LocalHoldStateReason StreamedMediaChannel::localHoldStateReason() const
 {
     if (!isReady(FeatureLocalHoldState)) {
-        warning() << "StreamedMediaChannel::localHoldStateReason() used with FeatureLocalHoldState not ready";
+        tpWarning(logChannels) <<
+            "StreamedMediaChannel::localHoldStateReason() used with FeatureLocalHoldState not ready";
     } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_HOLD)) {
-        warning() << "StreamedMediaChannel::localHoldStateReason() used with no hold interface";
+        tpWarning(logChannels) <<
+            "StreamedMediaChannel::localHoldStateReason() used with no hold interface";
     }
 
     return mPriv->localHoldStateReason;
@@ -1211,7 +1217,7 @@ LocalHoldStateReason StreamedMediaChannel::localHoldStateReason() const
 PendingOperation *StreamedMediaChannel::requestHold(bool hold)
 {
     if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_HOLD)) {
-        warning() << "StreamedMediaChannel::requestHold() used with no hold interface";
+        tpWarning(logChannels) << "StreamedMediaChannel::requestHold() used with no hold interface";
         return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("StreamedMediaChannel does not support hold interface"),
                 StreamedMediaChannelPtr(this));
@@ -1325,7 +1331,7 @@ void StreamedMediaChannel::gotStreams(QDBusPendingCallWatcher *watcher)
 {
     QDBusPendingReply<MediaStreamInfoList> reply = *watcher;
     if (reply.isError()) {
-        warning().nospace() << "StreamedMedia.ListStreams failed with" <<
+        tpWarning(logChannels).nospace() << "StreamedMedia.ListStreams failed with" <<
             reply.error().name() << ": " << reply.error().message();
 
         mPriv->readinessHelper->setIntrospectCompleted(FeatureStreams,
@@ -1334,7 +1340,7 @@ void StreamedMediaChannel::gotStreams(QDBusPendingCallWatcher *watcher)
         return;
     }
 
-    debug() << "Got reply to StreamedMedia::ListStreams()";
+    tpDebug(logChannels) << "Got reply to StreamedMedia::ListStreams()";
 
     MediaStreamInfoList streamInfoList = reply.value();
     if (streamInfoList.size() > 0) {
@@ -1361,7 +1367,7 @@ void StreamedMediaChannel::onStreamAdded(uint streamId,
         uint contactHandle, uint streamType)
 {
     if (lookupStreamById(streamId)) {
-        debug() << "Received StreamedMedia.StreamAdded for an existing "
+        tpDebug(logChannels) << "Received StreamedMedia.StreamAdded for an existing "
             "stream, ignoring";
         return;
     }
@@ -1379,7 +1385,7 @@ void StreamedMediaChannel::onStreamAdded(uint streamId,
 
 void StreamedMediaChannel::onStreamRemoved(uint streamId)
 {
-    debug() << "Received StreamedMedia.StreamRemoved for stream" <<
+    tpDebug(logChannels) << "Received StreamedMedia.StreamRemoved for stream" <<
         streamId;
 
     StreamedMediaStreamPtr stream = lookupStreamById(streamId);
@@ -1408,7 +1414,7 @@ void StreamedMediaChannel::onStreamRemoved(uint streamId)
 void StreamedMediaChannel::onStreamDirectionChanged(uint streamId,
         uint streamDirection, uint streamPendingFlags)
 {
-    debug() << "Received StreamedMedia.StreamDirectionChanged for stream" <<
+    tpDebug(logChannels) << "Received StreamedMedia.StreamDirectionChanged for stream" <<
         streamId << "with direction changed to" << streamDirection;
 
     StreamedMediaStreamPtr stream = lookupStreamById(streamId);
@@ -1432,7 +1438,7 @@ void StreamedMediaChannel::onStreamDirectionChanged(uint streamId,
 void StreamedMediaChannel::onStreamStateChanged(uint streamId,
         uint streamState)
 {
-    debug() << "Received StreamedMedia.StreamStateChanged for stream" <<
+    tpDebug(logChannels) << "Received StreamedMedia.StreamStateChanged for stream" <<
         streamId << "with state changed to" << streamState;
 
     StreamedMediaStreamPtr stream = lookupStreamById(streamId);
@@ -1452,7 +1458,7 @@ void StreamedMediaChannel::onStreamStateChanged(uint streamId,
 void StreamedMediaChannel::onStreamError(uint streamId,
         uint errorCode, const QString &errorMessage)
 {
-    debug() << "Received StreamedMedia.StreamError for stream" <<
+    tpDebug(logChannels) << "Received StreamedMedia.StreamError for stream" <<
         streamId << "with error code" << errorCode <<
         "and message:" << errorMessage;
 
@@ -1468,11 +1474,11 @@ void StreamedMediaChannel::gotLocalHoldState(QDBusPendingCallWatcher *watcher)
 {
     QDBusPendingReply<uint, uint> reply = *watcher;
     if (reply.isError()) {
-        warning().nospace() << "StreamedMedia::Hold::GetHoldState()"
+        tpWarning(logChannels).nospace() << "StreamedMedia::Hold::GetHoldState()"
             " failed with " << reply.error().name() << ": " <<
             reply.error().message();
 
-        debug() << "Ignoring error getting hold state and assuming we're not "
+        tpDebug(logChannels) << "Ignoring error getting hold state and assuming we're not "
             "on hold";
         onLocalHoldStateChanged(mPriv->localHoldState,
                 mPriv->localHoldStateReason);
@@ -1480,7 +1486,7 @@ void StreamedMediaChannel::gotLocalHoldState(QDBusPendingCallWatcher *watcher)
         return;
     }
 
-    debug() << "Got reply to StreamedMedia::Hold::GetHoldState()";
+    tpDebug(logChannels) << "Got reply to StreamedMedia::Hold::GetHoldState()";
     onLocalHoldStateChanged(reply.argumentAt<0>(), reply.argumentAt<1>());
     watcher->deleteLater();
 }
@@ -30,6 +30,9 @@
 #include <TelepathyQt/Global>
 #include <TelepathyQt/ConnectionCapabilities>
 #include <TelepathyQt/ContactCapabilities>
+#include <TelepathyQt/Message>
+#include <TelepathyQt/ReceivedMessage>
+#include <TelepathyQt/Types>
 
 #include <QString>
 
@@ -39,6 +42,7 @@ namespace Tp
 {
 
 class DBusProxy;
+class SharedDataRegistry;
 
 // Exported so the tests can use it even if they link dynamically
 // The header is not installed though, so this should be considered private API
@@ -50,6 +54,26 @@ struct TP_QT_EXPORT TestBackdoors
             const RequestableChannelClassSpecList &rccSpecs);
     static ContactCapabilities createContactCapabilities(
             const RequestableChannelClassSpecList &rccSpecs, bool specificToContact);
+
+    // Implemented in contact.cpp, next to the private data of Contact
+    static bool hasContactAvatarBlock(const ContactPtr &contact);
+    static bool hasContactInfoBlock(const ContactPtr &contact);
+    static bool hasContactLocationBlock(const ContactPtr &contact);
+
+    // Implemented in message.cpp, as the constructors taking parts are private
+    static Message createMessage(const MessagePartList &parts);
+    static Message createMessage(uint timestamp, uint type, const QString &text);
+    static ReceivedMessage createReceivedMessage(const MessagePartList &parts);
+    static uint receivedMessageSenderHandle(const ReceivedMessage &message);
+    static QString receivedMessageSenderId(const ReceivedMessage &message);
+    static uint receivedMessagePendingId(const ReceivedMessage &message);
+
+    // Implemented in shared-data-registry-internal.cpp, as the registry is not exported
+    static SharedDataRegistry *createSharedDataRegistry(int recheckInterval);
+    static void destroySharedDataRegistry(SharedDataRegistry *registry);
+    static ProfilePtr sharedDataRegistryProfile(SharedDataRegistry *registry,
+            const QString &serviceName);
+    static int sharedDataRegistrySize(SharedDataRegistry *registry);
 };
 
 } // Tp
@@ -301,7 +301,7 @@ void TextChannel::Private::updateInitialMessages()
     MessagePartListList messages = qdbus_cast<MessagePartListList>(
             props[QLatin1String("PendingMessages")]);
     if (messages.isEmpty()) {
-        debug() << "Message queue empty: FeatureMessageQueue is now ready";
+        tpDebug(logChannels) << "Message queue empty: FeatureMessageQueue is now ready";
         readinessHelper->setIntrospectCompleted(FeatureMessageQueue, true);
     } else {
         foreach (const MessagePartList &message, messages) {
@@ -346,7 +346,7 @@ void TextChannel::Private::processMessageQueue()
     // to incoming messages
     while (!incompleteMessages.isEmpty()) {
         const MessageEvent *e = incompleteMessages.first();
-        debug() << "MessageEvent:" << reinterpret_cast<const void *>(e);
+        tpDebug(logChannels) << "MessageEvent:" << reinterpret_cast<const void *>(e);
 
         if (e->isMessage) {
             if (e->message.senderHandle() != 0 &&
@@ -358,7 +358,7 @@ void TextChannel::Private::processMessageQueue()
             }
 
             // if we reach here, the message is ready
-            debug() << "Message is usable, copying to main queue";
+            tpDebug(logChannels) << "Message is usable, copying to main queue";
             messages << e->message;
             emit parent->messageReceived(e->message);
         } else {
@@ -376,14 +376,14 @@ void TextChannel::Private::processMessageQueue()
             }
         }
 
-        debug() << "Dropping first event";
+        tpDebug(logChannels) << "Dropping first event";
         delete incompleteMessages.takeFirst();
     }
 
     if (incompleteMessages.isEmpty()) {
         if (readinessHelper->requestedFeatures().contains(FeatureMessageQueue) &&
             !readinessHelper->isReady(Features() << FeatureMessageQueue)) {
-            debug() << "incompleteMessages empty for the first time: "
+            tpDebug(logChannels) << "incompleteMessages empty for the first time: "
                 "FeatureMessageQueue is now ready";
             readinessHelper->setIntrospectCompleted(FeatureMessageQueue, true);
         }
@@ -422,7 +422,7 @@ void TextChannel::Private::processChatStateQueue()
 {
     while (!chatStateQueue.isEmpty()) {
         const ChatStateEvent *e = chatStateQueue.first();
-        debug() << "ChatStateEvent:" << reinterpret_cast<const void *>(e);
+        tpDebug(logChannels) << "ChatStateEvent:" << reinterpret_cast<const void *>(e);
 
         if (e->contact.isNull()) {
             // the chat state Contact object wasn't retrieved yet, but needs
@@ -436,7 +436,7 @@ void TextChannel::Private::processChatStateQueue()
         // if we reach here, the Contact object is ready
         emit parent->chatStateChanged(e->contact, (ChannelChatState) e->state);
 
-        debug() << "Dropping first event";
+        tpDebug(logChannels) << "Dropping first event";
         delete chatStateQueue.takeFirst();
     }
 
@@ -745,7 +745,7 @@ QStringList TextChannel::supportedContentTypes() const
 QList<ChannelTextMessageType> TextChannel::supportedMessageTypes() const
 {
     if (!isReady(FeatureMessageCapabilities)) {
-        warning() << "TextChannel::supportedMessageTypes() used with "
+        tpWarning(logChannels) << "TextChannel::supportedMessageTypes() used with "
                 "FeatureMessageCapabilities not ready";
     }
 
@@ -763,7 +763,7 @@ QList<ChannelTextMessageType> TextChannel::supportedMessageTypes() const
 bool TextChannel::supportsMessageType(ChannelTextMessageType messageType) const
 {
     if (!isReady(FeatureMessageCapabilities)) {
-        warning() << "TextChannel::supportsMessageType() used with "
+        tpWarning(logChannels) << "TextChannel::supportsMessageType() used with "
                 "FeatureMessageCapabilities not ready";
     }
 
@@ -841,7 +841,7 @@ QList<ReceivedMessage> TextChannel::messageQueue() const
 ChannelChatState TextChannel::chatState(const ContactPtr &contact) const
 {
     if (!isReady(FeatureChatState)) {
-        warning() << "TextChannel::chatState() used with "
+        tpWarning(logChannels) << "TextChannel::chatState() used with "
             "FeatureChatState not ready";
         return ChannelChatStateInactive;
     }
@@ -861,7 +861,7 @@ void TextChannel::onAcknowledgePendingMessagesReply(
     if (reply.isError()) {
         // One of the IDs was bad, and we can't know which one. Recover by
         // doing as much as possible, and hope for the best...
-        debug() << "Recovering from AcknowledgePendingMessages failure for: "
+        tpDebug(logChannels) << "Recovering from AcknowledgePendingMessages failure for: "
             << ids;
         foreach (uint id, ids) {
             mPriv->textInterface->AcknowledgePendingMessages(UIntList() << id);
@@ -896,7 +896,7 @@ void TextChannel::acknowledge(const QList<ReceivedMessage> &messages)
         if (m.isFromChannel(TextChannelPtr(this))) {
             ids << m.pendingId();
         } else {
-            warning() << "message did not come from this channel, ignoring";
+            tpWarning(logChannels) << "message did not come from this channel, ignoring";
         }
     }
 
@@ -935,7 +935,7 @@ void TextChannel::forget(const QList<ReceivedMessage> &messages)
 {
     foreach (const ReceivedMessage &m, messages) {
         if (!m.isFromChannel(TextChannelPtr(this))) {
-            warning() << "message did not come from this channel, ignoring";
+            tpWarning(logChannels) << "message did not come from this channel, ignoring";
         } else if (mPriv->messages.removeOne(m)) {
             emit pendingMessageRemoved(m);
         }
@@ -1049,7 +1049,7 @@ PendingSendMessage *TextChannel::send(const MessagePartList &parts,
 PendingOperation *TextChannel::requestChatState(ChannelChatState state)
 {
     if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_CHAT_STATE)) {
-        warning() << "TextChannel::requestChatState() used with no chat "
+        tpWarning(logChannels) << "TextChannel::requestChatState() used with no chat "
             "state interface";
         return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("TextChannel does not support chat state interface"),
@@ -1082,7 +1082,7 @@ void TextChannel::onContactsFinished(PendingOperation *op)
     }
 
     if (pc->isError()) {
-        warning().nospace() << "Gathering contacts failed: "
+        tpWarning(logChannels).nospace() << "Gathering contacts failed: "
             << pc->errorName() << ": " << pc->errorMessage();
         foreach (uint handle, pc->handles()) {
             mPriv->contactLost(handle);
@@ -1251,7 +1251,7 @@ void TextChannel::gotProperties(QDBusPendingCallWatcher *watcher)
 
     QDBusPendingReply<QVariantMap> reply = *watcher;
     if (reply.isError()) {
-        warning().nospace() << "Properties::GetAll(Channel.Interface.Messages)"
+        tpWarning(logChannels).nospace() << "Properties::GetAll(Channel.Interface.Messages)"
             " failed with " << reply.error().name() << ": " <<
             reply.error().message();
 
@@ -1268,7 +1268,7 @@ void TextChannel::gotProperties(QDBusPendingCallWatcher *watcher)
         return;
     }
 
-    debug() << "Properties::GetAll(Channel.Interface.Messages) returned";
+    tpDebug(logChannels) << "Properties::GetAll(Channel.Interface.Messages) returned";
     mPriv->props = reply.value();
 
     mPriv->updateInitialMessages();
@@ -1284,7 +1284,7 @@ void TextChannel::gotPendingMessages(QDBusPendingCallWatcher *watcher)
 
     QDBusPendingReply<PendingTextMessageList> reply = *watcher;
     if (reply.isError()) {
-        warning().nospace() << "Properties::GetAll(Channel.Interface.Messages)"
+        tpWarning(logChannels).nospace() << "Properties::GetAll(Channel.Interface.Messages)"
             " failed with " << reply.error().name() << ": " <<
             reply.error().message();
 
@@ -1293,7 +1293,7 @@ void TextChannel::gotPendingMessages(QDBusPendingCallWatcher *watcher)
         return;
     }
 
-    debug() << "Text::ListPendingMessages returned";
+    tpDebug(logChannels) << "Text::ListPendingMessages returned";
     PendingTextMessageList list = reply.value();
 
     if (!list.isEmpty()) {
@@ -70,7 +70,7 @@ void TubeChannel::Private::introspectTube(TubeChannel::Private *self)
 {
     TubeChannel *parent = self->parent;
 
-    debug() << "Introspecting tube properties";
+    tpDebug(logTubes) << "Introspecting tube properties";
     Client::ChannelInterfaceTubeInterface *tubeInterface =
             parent->interface<Client::ChannelInterfaceTubeInterface>();
 
@@ -175,7 +175,7 @@ TubeChannel::~TubeChannel()
 QVariantMap TubeChannel::parameters() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "TubeChannel::parameters() used with FeatureCore not ready";
+        tpWarning(logTubes) << "TubeChannel::parameters() used with FeatureCore not ready";
         return QVariantMap();
     }
 
@@ -195,7 +195,7 @@ QVariantMap TubeChannel::parameters() const
 TubeChannelState TubeChannel::state() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "TubeChannel::state() used with FeatureCore not ready";
+        tpWarning(logTubes) << "TubeChannel::state() used with FeatureCore not ready";
         return TubeChannelStateNotOffered;
     }
 
@@ -215,7 +215,7 @@ void TubeChannel::onTubeChannelStateChanged(uint newState)
 
     uint oldState = mPriv->state;
 
-    debug() << "Tube state changed to" << newState;
+    tpDebug(logTubes) << "Tube state changed to" << newState;
     mPriv->state = (Tp::TubeChannelState) newState;
 
     /* only emit stateChanged if we already received the state from initial introspection */
@@ -231,10 +231,10 @@ void TubeChannel::gotTubeProperties(PendingOperation *op)
 
         mPriv->extractTubeProperties(pvm->result());
 
-        debug() << "Got reply to Properties::GetAll(TubeChannel)";
+        tpDebug(logTubes) << "Got reply to Properties::GetAll(TubeChannel)";
         mPriv->readinessHelper->setIntrospectCompleted(TubeChannel::FeatureCore, true);
     } else {
-        warning().nospace() << "Properties::GetAll(TubeChannel) failed "
+        tpWarning(logTubes).nospace() << "Properties::GetAll(TubeChannel) failed "
             "with " << op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(TubeChannel::FeatureCore, false,
                 op->errorName(), op->errorMessage());
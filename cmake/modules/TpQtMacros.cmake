@@ -102,6 +102,18 @@
 #       and optional argument a set of additional libraries the target will link to. Please remember that you need to
 #       set up the DBus environment by calling TPQT_SETUP_DBUS_TEST_ENVIRONMENT BEFORE you call this macro.
 #
+# macro TPQT_ADD_DBUS_BENCHMARK (fancyName name [libraries ...])
+#       This macro builds a benchmark requiring DBus emulation just like TPQT_ADD_DBUS_UNIT_TEST builds a unit test,
+#       but doesn't add it to the automatic CTest suite, so that it doesn't slow down "make test". Instead, it is
+#       appended to the TPQT_BENCHMARK_COMMANDS variable, which can be passed to add_custom_target to run all the
+#       benchmarks of the directory one after the other, and a benchmark-${fancyName} target runs it alone.
+#       TPQT_SETUP_DBUS_TEST_ENVIRONMENT must have been called before, as for TPQT_ADD_DBUS_UNIT_TEST.
+#
+# macro TPQT_ADD_GENERIC_BENCHMARK (fancyName name [libraries ...])
+#       This macro is the equivalent of TPQT_ADD_DBUS_BENCHMARK for benchmarks which don't require DBus emulation,
+#       which are built like TPQT_ADD_GENERIC_UNIT_TEST builds a unit test. The runGenericTest.sh script must have
+#       been written to the current binary directory before, as for TPQT_ADD_GENERIC_UNIT_TEST.
+#
 # macro _TPQT_ADD_CHECK_TARGETS (fancyName name command [args])
 #       This is an internal macro which is meant to be used by TPQT_ADD_DBUS_UNIT_TEST and TPQT_ADD_GENERIC_UNIT_TEST.
 #       It takes care of generating a check target for each test method available (currently normal execution, valgrind and
@@ -430,6 +442,32 @@ macro(tpqt_add_dbus_unit_test _fancyName _name)
     _tpqt_add_check_targets(${_fancyName} ${_name} ${with_session_bus} ${CMAKE_CURRENT_BINARY_DIR}/test-${_name})
 endmacro()
 
+macro(tpqt_add_dbus_benchmark _fancyName _name)
+    tpqt_generate_moc_i(${_name}.cpp ${CMAKE_CURRENT_BINARY_DIR}/_gen/${_name}.cpp.moc.hpp)
+    add_executable(test-${_name} ${_name}.cpp ${CMAKE_CURRENT_BINARY_DIR}/_gen/${_name}.cpp.moc.hpp)
+    target_link_libraries(test-${_name} ${QT_QTCORE_LIBRARY} ${QT_QTDBUS_LIBRARY} ${QT_QTNETWORK_LIBRARY} ${QT_QTXML_LIBRARY} ${QT_QTTEST_LIBRARY} telepathy-qt${QT_VERSION_MAJOR} tp-qt-tests ${TP_QT_EXECUTABLE_LINKER_FLAGS} ${ARGN})
+    set(_benchmark_command ${SH} ${CMAKE_CURRENT_BINARY_DIR}/runDbusTest.sh ${CMAKE_CURRENT_BINARY_DIR}/test-${_name})
+    list(APPEND TPQT_BENCHMARK_COMMANDS COMMAND ${_benchmark_command})
+    list(APPEND TPQT_BENCHMARK_TARGETS test-${_name})
+
+    add_custom_target(benchmark-${_fancyName} ${_benchmark_command}
+                      WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR})
+    add_dependencies(benchmark-${_fancyName} test-${_name})
+endmacro()
+
+macro(tpqt_add_generic_benchmark _fancyName _name)
+    tpqt_generate_moc_i(${_name}.cpp ${CMAKE_CURRENT_BINARY_DIR}/_gen/${_name}.cpp.moc.hpp)
+    add_executable(test-${_name} ${_name}.cpp ${CMAKE_CURRENT_BINARY_DIR}/_gen/${_name}.cpp.moc.hpp)
+    target_link_libraries(test-${_name} ${QT_QTCORE_LIBRARY} ${QT_QTNETWORK_LIBRARY} ${QT_QTXML_LIBRARY} ${QT_QTTEST_LIBRARY} telepathy-qt${QT_VERSION_MAJOR} tp-qt-tests ${TP_QT_EXECUTABLE_LINKER_FLAGS} ${ARGN})
+    set(_benchmark_command ${SH} ${CMAKE_CURRENT_BINARY_DIR}/runGenericTest.sh ${CMAKE_CURRENT_BINARY_DIR}/test-${_name})
+    list(APPEND TPQT_BENCHMARK_COMMANDS COMMAND ${_benchmark_command})
+    list(APPEND TPQT_BENCHMARK_TARGETS test-${_name})
+
+    add_custom_target(benchmark-${_fancyName} ${_benchmark_command}
+                      WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR})
+    add_dependencies(benchmark-${_fancyName} test-${_name})
+endmacro()
+
 macro(_tpqt_add_check_targets _fancyName _name _runnerScript)
     set_tests_properties(${_fancyName}
         PROPERTIES
@@ -0,0 +1,281 @@
+#include <tests/lib/test.h>
+#include <tests/benchmarks/synthetic-cm.h>
+
+#define TP_QT_ENABLE_LOWLEVEL_API
+
+#include <TelepathyQt/ChannelFactory>
+#include <TelepathyQt/Connection>
+#include <TelepathyQt/ConnectionFactory>
+#include <TelepathyQt/ConnectionInterfaceRequestsInterface>
+#include <TelepathyQt/ConnectionLowlevel>
+#include <TelepathyQt/ConnectionManager>
+#include <TelepathyQt/ConnectionManagerLowlevel>
+#include <TelepathyQt/ContactFactory>
+#include <TelepathyQt/DBusError>
+#include <TelepathyQt/PendingConnection>
+#include <TelepathyQt/PendingReady>
+#include <TelepathyQt/ReceivedMessage>
+#include <TelepathyQt/TextChannel>
+
+using namespace Tp;
+
+class TestBenchChannels : public Test
+{
+    Q_OBJECT
+
+public:
+    TestBenchChannels(QObject *parent = 0)
+        : Test(parent), mCM(0), mExpectedChannels(0), mReadyChannels(0),
+          mExpectedMessages(0), mReceivedMessages(0)
+    { }
+
+protected Q_SLOTS:
+    void onNewChannels(const Tp::ChannelDetailsList &channels);
+    void onChannelReady(Tp::PendingOperation *op);
+    void onMessageReceived(const Tp::ReceivedMessage &message);
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+
+    void benchmarkChannelDispatch();
+    void benchmarkMessageReceive_data();
+    void benchmarkMessageReceive();
+    void benchmarkProxyReadiness_data();
+    void benchmarkProxyReadiness();
+
+    void cleanup();
+    void cleanupTestCase();
+
+private:
+    TextChannelPtr createTextChannel(const BaseChannelPtr &svcChannel) const;
+
+    SyntheticCM::Config mConfig;
+    SyntheticCM::Manager *mCM;
+    ChannelFactoryPtr mChannelFactory;
+    ConnectionPtr mConn;
+
+    QList<ChannelPtr> mDispatchedChannels;
+    int mExpectedChannels;
+    int mReadyChannels;
+    int mExpectedMessages;
+    int mReceivedMessages;
+};
+
+void TestBenchChannels::onNewChannels(const Tp::ChannelDetailsList &channels)
+{
+    // What a Handler sees once the dispatcher hands the channel over: a factory-built proxy
+    // made ready with the features the factory was configured with.
+    foreach (const ChannelDetails &details, channels) {
+        PendingReady *pr = mChannelFactory->proxy(mConn, details.channel.path(), details.properties);
+        connect(pr,
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(onChannelReady(Tp::PendingOperation*)));
+    }
+}
+
+void TestBenchChannels::onChannelReady(Tp::PendingOperation *op)
+{
+    if (op->isError()) {
+        qWarning() << "Channel proxy failed to become ready:" << op->errorName() << op->errorMessage();
+        mLoop->exit(1);
+        return;
+    }
+
+    PendingReady *pr = qobject_cast<PendingReady*>(op);
+    mDispatchedChannels << ChannelPtr::qObjectCast(pr->proxy());
+    if (++mReadyChannels == mExpectedChannels) {
+        mLoop->exit(0);
+    }
+}
+
+void TestBenchChannels::onMessageReceived(const Tp::ReceivedMessage &message)
+{
+    Q_UNUSED(message);
+    if (++mReceivedMessages == mExpectedMessages) {
+        mLoop->exit(0);
+    }
+}
+
+void TestBenchChannels::initTestCase()
+{
+    initTestCaseImpl();
+
+    mConfig = SyntheticCM::Config::fromEnvironment();
+    qDebug() << "Synthetic CM:" << mConfig.contacts << "contacts," << mConfig.channels <<
+        "channels," << mConfig.messageRate << "messages/s," << mConfig.mucSize << "room members";
+
+    mCM = new SyntheticCM::Manager(mConfig, this);
+    DBusError err;
+    QVERIFY(mCM->registerObject(&err));
+    QVERIFY(!err.isValid());
+
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    mChannelFactory = ChannelFactory::create(bus);
+    mChannelFactory->addFeaturesForTextChats(TextChannel::FeatureMessageQueue);
+    mChannelFactory->addFeaturesForTextChatrooms(TextChannel::FeatureMessageQueue);
+
+    ConnectionManagerPtr cliCM = ConnectionManager::create(bus, mCM->name(),
+            ConnectionFactory::create(bus), mChannelFactory, ContactFactory::create());
+    connect(cliCM->becomeReady(),
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+
+    PendingConnection *pc = cliCM->lowlevel()->requestConnection(mCM->protocolName(), QVariantMap());
+    connect(pc,
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+
+    mConn = pc->connection();
+    connect(mConn->lowlevel()->requestConnect(),
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mConn->status(), ConnectionStatusConnected);
+    QVERIFY(mCM->connection());
+}
+
+void TestBenchChannels::init()
+{
+    initImpl();
+}
+
+TextChannelPtr TestBenchChannels::createTextChannel(const BaseChannelPtr &svcChannel) const
+{
+    return TextChannel::create(mConn, svcChannel->objectPath(), svcChannel->immutableProperties());
+}
+
+void TestBenchChannels::benchmarkChannelDispatch()
+{
+    if (mConfig.channels == 0) {
+        qDebug() << "Channel dispatch disabled by configuration";
+        return;
+    }
+
+    Client::ConnectionInterfaceRequestsInterface *requests =
+        mConn->interface<Client::ConnectionInterfaceRequestsInterface>();
+    QVERIFY(requests);
+    connect(requests,
+            SIGNAL(NewChannels(Tp::ChannelDetailsList)),
+            SLOT(onNewChannels(Tp::ChannelDetailsList)));
+
+    QBENCHMARK {
+        mReadyChannels = 0;
+        mExpectedChannels = mConfig.channels;
+        QList<BaseChannelPtr> svcChannels = mCM->connection()->announceTextChannels(mConfig.channels);
+        QCOMPARE(svcChannels.size(), mConfig.channels);
+        QCOMPARE(mLoop->exec(), 0);
+
+        // Close them again so every iteration dispatches the same number of fresh channels
+        mDispatchedChannels.clear();
+        foreach (const BaseChannelPtr &svcChannel, svcChannels) {
+            svcChannel->close();
+        }
+    }
+
+    disconnect(requests,
+            SIGNAL(NewChannels(Tp::ChannelDetailsList)),
+            this,
+            SLOT(onNewChannels(Tp::ChannelDetailsList)));
+    mExpectedChannels = 0;
+}
+
+void TestBenchChannels::benchmarkMessageReceive_data()
+{
+    QTest::addColumn<bool>("room");
+
+    QTest::newRow("1-1 chat") << false;
+    QTest::newRow("chat room") << true;
+}
+
+void TestBenchChannels::benchmarkMessageReceive()
+{
+    QFETCH(bool, room);
+
+    if (mConfig.messageRate == 0) {
+        qDebug() << "Message receive disabled by configuration";
+        return;
+    }
+
+    BaseChannelPtr svcChannel = room ?
+        mCM->connection()->announceRoom(mConfig.mucSize) :
+        mCM->connection()->announceTextChannels(1).value(0);
+    QVERIFY(svcChannel);
+
+    TextChannelPtr channel = createTextChannel(svcChannel);
+    connect(channel->becomeReady(Features() << TextChannel::FeatureMessageQueue),
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+    connect(channel.data(),
+            SIGNAL(messageReceived(Tp::ReceivedMessage)),
+            SLOT(onMessageReceived(Tp::ReceivedMessage)));
+
+    // One iteration delivers a second's worth of messages as fast as the bus allows
+    QBENCHMARK {
+        mReceivedMessages = 0;
+        mExpectedMessages = mConfig.messageRate;
+        mCM->connection()->receiveMessages(svcChannel, mConfig.messageRate);
+        QCOMPARE(mLoop->exec(), 0);
+
+        channel->acknowledge(channel->messageQueue());
+    }
+
+    mExpectedMessages = 0;
+    svcChannel->close();
+}
+
+void TestBenchChannels::benchmarkProxyReadiness_data()
+{
+    QTest::addColumn<int>("members");
+
+    QTest::newRow("1-1 chat") << -1;
+    if (mConfig.mucSize > 10) {
+        QTest::newRow("room with 10 members") << 10;
+    }
+    QTest::newRow(qPrintable(QString(QLatin1String("room with %1 members")).arg(mConfig.mucSize)))
+        << mConfig.mucSize;
+}
+
+void TestBenchChannels::benchmarkProxyReadiness()
+{
+    QFETCH(int, members);
+
+    BaseChannelPtr svcChannel = members < 0 ?
+        mCM->connection()->announceTextChannels(1).value(0) :
+        mCM->connection()->announceRoom(members);
+    QVERIFY(svcChannel);
+
+    // Each iteration builds a new proxy for the same channel, so readiness includes the
+    // group member contacts being built for rooms.
+    QBENCHMARK {
+        TextChannelPtr channel = createTextChannel(svcChannel);
+        connect(channel->becomeReady(Features() << TextChannel::FeatureCore),
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+        QCOMPARE(mLoop->exec(), 0);
+        if (members >= 0) {
+            QCOMPARE(channel->groupContacts().size(), qMin(members, mConfig.contacts) + 1);
+        }
+    }
+
+    svcChannel->close();
+}
+
+void TestBenchChannels::cleanup()
+{
+    cleanupImpl();
+}
+
+void TestBenchChannels::cleanupTestCase()
+{
+    mDispatchedChannels.clear();
+    mConn.reset();
+
+    cleanupTestCaseImpl();
+}
+
+QTEST_MAIN(TestBenchChannels)
+#include "_gen/bench-channels.cpp.moc.hpp"
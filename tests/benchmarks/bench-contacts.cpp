@@ -0,0 +1,298 @@
+#include <tests/lib/test.h>
+#include <tests/benchmarks/synthetic-cm.h>
+
+#include <QFile>
+
+#define TP_QT_ENABLE_LOWLEVEL_API
+
+#include <TelepathyQt/ChannelFactory>
+#include <TelepathyQt/Connection>
+#include <TelepathyQt/ConnectionFactory>
+#include <TelepathyQt/ConnectionLowlevel>
+#include <TelepathyQt/ConnectionManager>
+#include <TelepathyQt/ConnectionManagerLowlevel>
+#include <TelepathyQt/Contact>
+#include <TelepathyQt/ContactFactory>
+#include <TelepathyQt/ContactManager>
+#include <TelepathyQt/DBusError>
+#include <TelepathyQt/PendingConnection>
+#include <TelepathyQt/PendingContacts>
+#include <TelepathyQt/PendingReady>
+#include <TelepathyQt/Presence>
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+using namespace Tp;
+
+namespace
+{
+
+// The resident set size of the process, or -1 if it can't be known
+qint64 residentMemory()
+{
+#ifdef Q_OS_UNIX
+    QFile statm(QLatin1String("/proc/self/statm"));
+    if (statm.open(QIODevice::ReadOnly)) {
+        QList<QByteArray> pages = statm.readAll().split(' ');
+        if (pages.size() > 1) {
+            return pages[1].toLongLong() * sysconf(_SC_PAGESIZE);
+        }
+    }
+#endif
+    return -1;
+}
+
+}
+
+class TestBenchContacts : public Test
+{
+    Q_OBJECT
+
+public:
+    TestBenchContacts(QObject *parent = 0)
+        : Test(parent), mCM(0), mPresenceChanges(0), mExpectedPresenceChanges(0)
+    { }
+
+protected Q_SLOTS:
+    void onPresenceChanged(const Tp::Presence &presence);
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+
+    void benchmarkContactLoading_data();
+    void benchmarkContactLoading();
+    void benchmarkRosterIntrospection_data();
+    void benchmarkRosterIntrospection();
+    void benchmarkPresenceChurn();
+    void benchmarkContactMemory();
+
+    void cleanup();
+    void cleanupTestCase();
+
+private:
+    void addChurnColumn();
+    ConnectionPtr createConnectionProxy() const;
+
+    SyntheticCM::Config mConfig;
+    SyntheticCM::Manager *mCM;
+    ContactFactoryConstPtr mContactFactory;
+    ConnectionPtr mConn;
+    int mPresenceChanges;
+    int mExpectedPresenceChanges;
+};
+
+void TestBenchContacts::onPresenceChanged(const Tp::Presence &presence)
+{
+    Q_UNUSED(presence);
+    if (++mPresenceChanges == mExpectedPresenceChanges) {
+        mLoop->exit(0);
+    }
+}
+
+void TestBenchContacts::initTestCase()
+{
+    initTestCaseImpl();
+
+    mConfig = SyntheticCM::Config::fromEnvironment();
+    qDebug() << "Synthetic CM:" << mConfig.contacts << "contacts," <<
+        mConfig.presenceChurnRate << "presence changes/s";
+
+    mCM = new SyntheticCM::Manager(mConfig, this);
+    DBusError err;
+    QVERIFY(mCM->registerObject(&err));
+    QVERIFY(!err.isValid());
+
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    mContactFactory = ContactFactory::create(Features() << Contact::FeatureSimplePresence);
+    ConnectionManagerPtr cliCM = ConnectionManager::create(bus, mCM->name(),
+            ConnectionFactory::create(bus), ChannelFactory::create(bus), mContactFactory);
+    connect(cliCM->becomeReady(),
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+
+    PendingConnection *pc = cliCM->lowlevel()->requestConnection(mCM->protocolName(), QVariantMap());
+    connect(pc,
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+
+    mConn = pc->connection();
+    connect(mConn->lowlevel()->requestConnect(),
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mConn->status(), ConnectionStatusConnected);
+    QVERIFY(mCM->connection());
+}
+
+void TestBenchContacts::init()
+{
+    initImpl();
+}
+
+void TestBenchContacts::addChurnColumn()
+{
+    QTest::addColumn<bool>("churn");
+
+    QTest::newRow("idle") << false;
+    QTest::newRow("presence churn") << true;
+}
+
+ConnectionPtr TestBenchContacts::createConnectionProxy() const
+{
+    return Connection::create(mConn->busName(), mConn->objectPath(),
+            ChannelFactory::create(QDBusConnection::sessionBus()), mContactFactory);
+}
+
+void TestBenchContacts::benchmarkContactLoading_data()
+{
+    addChurnColumn();
+}
+
+void TestBenchContacts::benchmarkContactLoading()
+{
+    QFETCH(bool, churn);
+
+    QStringList ids = mCM->connection()->rosterIdentifiers();
+    if (churn) {
+        mCM->connection()->startChurn();
+    }
+
+    // Each iteration drops the contacts it built, so the next one goes through the whole
+    // handle and attribute lookup again.
+    QBENCHMARK {
+        PendingContacts *pc = mConn->contactManager()->contactsForIdentifiers(ids,
+                Features() << Contact::FeatureSimplePresence);
+        connect(pc,
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+        QCOMPARE(mLoop->exec(), 0);
+        QCOMPARE(pc->contacts().size(), ids.size());
+        WeakPtr<Contact> contact = ids.isEmpty() ? ContactPtr() : pc->contacts().first();
+
+        // The operation holds the contacts until it is deleted, and the contact manager only
+        // has weak references to them, so deleting it releases them. Also deliver whatever the
+        // lookup left queued, such as handle reference calls, before the next iteration.
+        QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+        processDBusQueue(mConn.data());
+        QVERIFY(ContactPtr(contact).isNull());
+    }
+
+    mCM->connection()->stopChurn();
+}
+
+void TestBenchContacts::benchmarkRosterIntrospection_data()
+{
+    addChurnColumn();
+}
+
+void TestBenchContacts::benchmarkRosterIntrospection()
+{
+    QFETCH(bool, churn);
+
+    if (churn) {
+        mCM->connection()->startChurn();
+    }
+
+    QBENCHMARK {
+        ConnectionPtr conn = createConnectionProxy();
+        connect(conn->becomeReady(Features() << Connection::FeatureCore << Connection::FeatureRoster),
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+        QCOMPARE(mLoop->exec(), 0);
+        QCOMPARE(conn->contactManager()->state(), ContactListStateSuccess);
+        QCOMPARE(conn->contactManager()->allKnownContacts().size(), mConfig.contacts);
+    }
+
+    mCM->connection()->stopChurn();
+}
+
+void TestBenchContacts::benchmarkPresenceChurn()
+{
+    if (mConfig.contacts == 0 || mConfig.presenceChurnRate == 0) {
+        qDebug() << "Presence churn disabled by configuration";
+        return;
+    }
+
+    ConnectionPtr conn = createConnectionProxy();
+    connect(conn->becomeReady(Features() << Connection::FeatureCore << Connection::FeatureRoster),
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+
+    foreach (const ContactPtr &contact, conn->contactManager()->allKnownContacts()) {
+        connect(contact.data(),
+                SIGNAL(presenceChanged(Tp::Presence)),
+                SLOT(onPresenceChanged(Tp::Presence)));
+    }
+
+    // One iteration delivers a second's worth of presence changes as fast as the bus allows
+    QBENCHMARK {
+        mPresenceChanges = 0;
+        mExpectedPresenceChanges = mConfig.presenceChurnRate;
+        mCM->connection()->changePresences(mConfig.presenceChurnRate);
+        QCOMPARE(mLoop->exec(), 0);
+    }
+
+    mExpectedPresenceChanges = 0;
+}
+
+void TestBenchContacts::benchmarkContactMemory()
+{
+    if (residentMemory() < 0) {
+        qDebug() << "The resident memory of the process can't be known on this system";
+        return;
+    }
+
+    // A fresh proxy, so that none of the contacts exist yet
+    ConnectionPtr conn = createConnectionProxy();
+    connect(conn->becomeReady(),
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+
+    // Request the features a roster UI typically uses. The synthetic CM leaves most of them
+    // unset, as is the case for most contacts of a large roster
+    Features features = Features()
+        << Contact::FeatureAlias
+        << Contact::FeatureAvatarToken
+        << Contact::FeatureSimplePresence
+        << Contact::FeatureCapabilities
+        << Contact::FeatureLocation
+        << Contact::FeatureInfo
+        << Contact::FeatureClientTypes;
+
+    QStringList ids = mCM->connection()->rosterIdentifiers();
+    qint64 before = residentMemory();
+
+    PendingContacts *pc = conn->contactManager()->contactsForIdentifiers(ids, features);
+    connect(pc,
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+    QList<ContactPtr> contacts = pc->contacts();
+    QCOMPARE(contacts.size(), ids.size());
+
+    qint64 after = residentMemory();
+    qDebug() << contacts.size() << "contacts use" << (after - before) / 1024 << "KiB," <<
+        (contacts.isEmpty() ? 0 : (after - before) / contacts.size()) << "bytes per contact";
+}
+
+void TestBenchContacts::cleanup()
+{
+    cleanupImpl();
+}
+
+void TestBenchContacts::cleanupTestCase()
+{
+    mConn.reset();
+
+    cleanupTestCaseImpl();
+}
+
+QTEST_MAIN(TestBenchContacts)
+#include "_gen/bench-contacts.cpp.moc.hpp"
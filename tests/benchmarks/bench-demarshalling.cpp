@@ -0,0 +1,204 @@
+#include <tests/lib/test.h>
+
+#include <TelepathyQt/Channel>
+#include <TelepathyQt/Types>
+#include <TelepathyQt/types-internal.h>
+
+using namespace Tp;
+
+namespace
+{
+
+const uint numContacts = 1000;
+const uint numMessageParts = 200;
+
+ContactAttributesMap contactAttributes()
+{
+    ContactAttributesMap ret;
+    for (uint handle = 1; handle <= numContacts; ++handle) {
+        QVariantMap attributes;
+        attributes.insert(TP_QT_IFACE_CONNECTION + QLatin1String("/contact-id"),
+                QString(QLatin1String("contact%1@example.com")).arg(handle));
+        attributes.insert(TP_QT_IFACE_CONNECTION_INTERFACE_ALIASING + QLatin1String("/alias"),
+                QString(QLatin1String("Contact %1")).arg(handle));
+        attributes.insert(TP_QT_IFACE_CONNECTION_INTERFACE_AVATARS + QLatin1String("/token"),
+                QString::number(handle, 16));
+        ret.insert(handle, attributes);
+    }
+    return ret;
+}
+
+SimpleContactPresences presences()
+{
+    SimpleContactPresences ret;
+    for (uint handle = 1; handle <= numContacts; ++handle) {
+        SimplePresence presence;
+        presence.type = ConnectionPresenceTypeAvailable;
+        presence.status = QLatin1String("available");
+        presence.statusMessage = QString(QLatin1String("Status of contact %1")).arg(handle);
+        ret.insert(handle, presence);
+    }
+    return ret;
+}
+
+MessagePartList messageParts()
+{
+    MessagePartList ret;
+    for (uint i = 0; i < numMessageParts; ++i) {
+        MessagePart part;
+        part.insert(QLatin1String("content-type"),
+                QDBusVariant(QLatin1String("text/plain")));
+        part.insert(QLatin1String("alternative"),
+                QDBusVariant(QString::number(i)));
+        part.insert(QLatin1String("content"),
+                QDBusVariant(QString(QLatin1String("Part %1 of the message")).arg(i)));
+        ret.append(part);
+    }
+    return ret;
+}
+
+template<typename T>
+void benchmarkDemarshal(const QVariant &value)
+{
+    QDBusArgument arg = qvariant_cast<QDBusArgument>(value);
+    QBENCHMARK {
+        // the copy is detached on read, so each iteration starts over
+        QDBusArgument copy(arg);
+        T ret;
+        copy >> ret;
+    }
+}
+
+}
+
+/* The values have to come from an actual D-Bus message to be demarshalled, so they are exported
+ * as the Parameters property of Channel.Interface.Tube, for which we already have the
+ * autogenerated interface */
+class TubeAdaptor : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.Telepathy.Channel.Interface.Tube")
+    Q_CLASSINFO("D-Bus Introspection", ""
+"  <interface name=\"org.freedesktop.Telepathy.Channel.Interface.Tube\" >\n"
+"    <property name=\"Parameters\" type=\"a{sv}\" access=\"read\" />\n"
+"  </interface>\n"
+        "")
+
+    Q_PROPERTY(QVariantMap Parameters READ Parameters)
+
+public:
+    TubeAdaptor(QObject *parent) : QDBusAbstractAdaptor(parent) {}
+    ~TubeAdaptor() {}
+
+public: // Properties
+    inline QVariantMap Parameters() const
+    {
+        QVariantMap ret;
+        ret.insert(QLatin1String("ContactAttributes"), qVariantFromValue(contactAttributes()));
+        ret.insert(QLatin1String("Presences"), qVariantFromValue(presences()));
+        ret.insert(QLatin1String("MessageParts"), qVariantFromValue(messageParts()));
+        return ret;
+    }
+};
+
+class TestBenchDemarshalling : public Test
+{
+    Q_OBJECT
+
+public:
+    TestBenchDemarshalling(QObject *parent = 0)
+        : Test(parent)
+    { }
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+
+    void benchmarkDemarshalling_data();
+    void benchmarkDemarshalling();
+
+    void cleanup();
+    void cleanupTestCase();
+
+private:
+    QVariantMap mParameters;
+};
+
+void TestBenchDemarshalling::initTestCase()
+{
+    initTestCaseImpl();
+
+    QDBusConnection bus = QDBusConnection::sessionBus();
+
+    QString tubeBusName = QLatin1String("org.freedesktop.Telepathy.Test.BenchDemarshalling");
+    QString tubePath = QLatin1String("/org/freedesktop/Telepathy/Test/BenchDemarshalling");
+
+    QObject *adaptorObject = new QObject(this);
+    (void) new TubeAdaptor(adaptorObject);
+    QVERIFY(bus.registerService(tubeBusName));
+    QVERIFY(bus.registerObject(tubePath, adaptorObject));
+
+    Client::ChannelInterfaceTubeInterface *tubeIface = new Client::ChannelInterfaceTubeInterface(
+            bus, tubeBusName, tubePath, this);
+    QVERIFY(waitForProperty(tubeIface->requestPropertyParameters(), &mParameters));
+}
+
+void TestBenchDemarshalling::init()
+{
+    initImpl();
+}
+
+void TestBenchDemarshalling::benchmarkDemarshalling_data()
+{
+    QTest::addColumn<QString>("key");
+    QTest::addColumn<bool>("fast");
+
+    QTest::newRow("ContactAttributesMap, generic") << QString(QLatin1String("ContactAttributes")) << false;
+    QTest::newRow("ContactAttributesMap, fast") << QString(QLatin1String("ContactAttributes")) << true;
+    QTest::newRow("SimpleContactPresences, generic") << QString(QLatin1String("Presences")) << false;
+    QTest::newRow("SimpleContactPresences, fast") << QString(QLatin1String("Presences")) << true;
+    QTest::newRow("MessagePartList, generic") << QString(QLatin1String("MessageParts")) << false;
+    QTest::newRow("MessagePartList, fast") << QString(QLatin1String("MessageParts")) << true;
+}
+
+void TestBenchDemarshalling::benchmarkDemarshalling()
+{
+    QFETCH(QString, key);
+    QFETCH(bool, fast);
+
+    // The generic rows demarshal into the plain Qt containers the generated types
+    // derive from, which makes QtDBus use its own templates
+    QVariant value = mParameters.value(key);
+    if (key == QLatin1String("ContactAttributes")) {
+        if (fast) {
+            benchmarkDemarshal<ContactAttributesMap>(value);
+        } else {
+            benchmarkDemarshal<QMap<uint, QVariantMap> >(value);
+        }
+    } else if (key == QLatin1String("Presences")) {
+        if (fast) {
+            benchmarkDemarshal<SimpleContactPresences>(value);
+        } else {
+            benchmarkDemarshal<QMap<uint, SimplePresence> >(value);
+        }
+    } else {
+        if (fast) {
+            benchmarkDemarshal<MessagePartList>(value);
+        } else {
+            benchmarkDemarshal<QList<QMap<QString, QDBusVariant> > >(value);
+        }
+    }
+}
+
+void TestBenchDemarshalling::cleanup()
+{
+    cleanupImpl();
+}
+
+void TestBenchDemarshalling::cleanupTestCase()
+{
+    cleanupTestCaseImpl();
+}
+
+QTEST_MAIN(TestBenchDemarshalling)
+#include "_gen/bench-demarshalling.cpp.moc.hpp"
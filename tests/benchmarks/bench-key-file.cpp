@@ -0,0 +1,46 @@
+#include <QtTest/QtTest>
+
+#include "TelepathyQt/key-file.h"
+
+using namespace Tp;
+
+class TestBenchKeyFile : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void benchmarkKeyFile();
+};
+
+void TestBenchKeyFile::benchmarkKeyFile()
+{
+    // Synthetic file of 10k lines: 100 groups of 99 keys each
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    for (int group = 0; group < 100; ++group) {
+        file.write(QString(QLatin1String("[group %1]\n")).arg(group).toLatin1());
+        for (int key = 0; key < 99; ++key) {
+            file.write(QString(QLatin1String("key-%1 = some\\svalue;with\\;escapes;%1\n"))
+                    .arg(key).toLatin1());
+        }
+    }
+    file.close();
+
+    QBENCHMARK {
+        KeyFile keyFile(file.fileName());
+        QCOMPARE(keyFile.status(), KeyFile::NoError);
+    }
+
+    KeyFile keyFile(file.fileName());
+    QCOMPARE(keyFile.allGroups().size(), 100);
+    keyFile.setGroup(QLatin1String("group 42"));
+    QCOMPARE(keyFile.keys().size(), 99);
+    QCOMPARE(keyFile.value(QLatin1String("key-7")), QString(QLatin1String("some value;with;escapes;7")));
+    QCOMPARE(keyFile.valueAsStringList(QLatin1String("key-7")),
+             QStringList() << QLatin1String("some value") << QLatin1String("with;escapes") <<
+                              QLatin1String("7"));
+}
+
+QTEST_MAIN(TestBenchKeyFile)
+
+#include "_gen/bench-key-file.cpp.moc.hpp"
@@ -0,0 +1,87 @@
+#include <QtTest/QtTest>
+
+#include <TelepathyQt/Debug>
+#include "TelepathyQt/manager-file.h"
+#include "TelepathyQt/parsed-file-cache-internal.h"
+
+#include <QTemporaryDir>
+
+using namespace Tp;
+
+class TestBenchManagerFile : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestBenchManagerFile(QObject *parent = 0);
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void benchmarkManagerFile();
+
+    void cleanupTestCase();
+
+private:
+    QTemporaryDir mDataHome;
+    QByteArray mOldDataHome;
+};
+
+TestBenchManagerFile::TestBenchManagerFile(QObject *parent)
+    : QObject(parent)
+{
+    Tp::enableDebug(false);
+    Tp::enableWarnings(true);
+}
+
+void TestBenchManagerFile::initTestCase()
+{
+    // Measure parsing the file, not reading back the cached result of the first iteration, and
+    // keep the benchmark file out of the user's cache
+    ParsedFileCache::setEnabled(false);
+
+    QVERIFY(mDataHome.isValid());
+    mOldDataHome = qgetenv("XDG_DATA_HOME");
+    qputenv("XDG_DATA_HOME", QFile::encodeName(mDataHome.path()));
+}
+
+void TestBenchManagerFile::benchmarkManagerFile()
+{
+    QString managersDir = mDataHome.path() + QLatin1String("/telepathy/managers");
+    QVERIFY(QDir().mkpath(managersDir));
+
+    // Synthetic .manager file of 10k lines: 200 protocols with 49 parameter lines each
+    QFile file(managersDir + QLatin1String("/benchmark.manager"));
+    QVERIFY(file.open(QFile::WriteOnly));
+    file.write("[ConnectionManager]\nName = benchmark\n");
+    for (int protocol = 0; protocol < 200; ++protocol) {
+        file.write(QString(QLatin1String("[Protocol proto%1]\n")).arg(protocol).toLatin1());
+        for (int param = 0; param < 24; ++param) {
+            file.write(QString(QLatin1String("param-p%1 = s\ndefault-p%1 = value%1\n"))
+                    .arg(param).toLatin1());
+        }
+    }
+    file.close();
+
+    QBENCHMARK {
+        ManagerFile managerFile(QLatin1String("benchmark"));
+        QCOMPARE(managerFile.isValid(), true);
+    }
+
+    ManagerFile managerFile(QLatin1String("benchmark"));
+    QCOMPARE(managerFile.protocols().size(), 200);
+    QCOMPARE(managerFile.parameters(QLatin1String("proto7")).size(), 24);
+}
+
+void TestBenchManagerFile::cleanupTestCase()
+{
+    if (mOldDataHome.isEmpty()) {
+        qunsetenv("XDG_DATA_HOME");
+    } else {
+        qputenv("XDG_DATA_HOME", mOldDataHome);
+    }
+}
+
+QTEST_MAIN(TestBenchManagerFile)
+
+#include "_gen/bench-manager-file.cpp.moc.hpp"
@@ -0,0 +1,83 @@
+#include <QtTest/QtTest>
+
+#include <QDBusMessage>
+#include <QDBusPendingCall>
+
+#include <TelepathyQt/Debug>
+#include <TelepathyQt/PendingVoid>
+
+using namespace Tp;
+
+class TestBenchPendingOperations : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestBenchPendingOperations(QObject *parent = 0);
+
+protected Q_SLOTS:
+    void onFinished(Tp::PendingOperation *op);
+
+private Q_SLOTS:
+    void benchmarkCompletion();
+
+private:
+    int mFinished;
+    int mRemaining;
+    QEventLoop *mLoop;
+};
+
+TestBenchPendingOperations::TestBenchPendingOperations(QObject *parent)
+    : QObject(parent),
+      mFinished(0),
+      mRemaining(0),
+      mLoop(new QEventLoop(this))
+{
+    Tp::enableDebug(false);
+    Tp::enableWarnings(true);
+}
+
+void TestBenchPendingOperations::onFinished(Tp::PendingOperation *op)
+{
+    Q_UNUSED(op);
+
+    mFinished++;
+    if (--mRemaining == 0) {
+        mLoop->exit(0);
+    }
+}
+
+void TestBenchPendingOperations::benchmarkCompletion()
+{
+    // TPQT_BENCH_OPERATIONS: operations finished in the same mainloop iteration
+    bool ok = false;
+    int numOperations = qgetenv("TPQT_BENCH_OPERATIONS").toInt(&ok);
+    if (!ok || numOperations <= 0) {
+        numOperations = 1000000;
+    }
+
+    QDBusMessage call = QDBusMessage::createMethodCall(
+            QLatin1String("org.freedesktop.Telepathy.Test"), QLatin1String("/"),
+            QLatin1String("org.freedesktop.Telepathy.Test"), QLatin1String("Test"));
+    QDBusMessage reply = call.createReply();
+
+    QBENCHMARK_ONCE {
+        for (int i = 0; i < numOperations; ++i) {
+            PendingOperation *op = new PendingVoid(QDBusPendingCall::fromCompletedCall(reply),
+                    SharedPtr<RefCounted>());
+            connect(op, SIGNAL(finished(Tp::PendingOperation*)),
+                    SLOT(onFinished(Tp::PendingOperation*)));
+        }
+
+        mRemaining = numOperations;
+        QCOMPARE(mLoop->exec(), 0);
+        // Let the finished operations be deleted as part of the measurement
+        QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+    }
+
+    QCOMPARE(mFinished, numOperations);
+}
+
+QTEST_MAIN(TestBenchPendingOperations)
+
+#include "_gen/bench-pending-operations.cpp.moc.hpp"
@@ -0,0 +1,145 @@
+#include <QtTest/QtTest>
+
+#include <TelepathyQt/Debug>
+#include <TelepathyQt/Profile>
+
+#include <QTemporaryDir>
+
+using namespace Tp;
+
+class TestBenchProfiles : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestBenchProfiles(QObject *parent = 0);
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void benchmarkProfiles_data();
+    void benchmarkProfiles();
+
+    void cleanupTestCase();
+
+private:
+    void loadProfiles(const QStringList &fileNames, bool sections);
+
+    QTemporaryDir mCacheDir;
+    QByteArray mOldCacheHome;
+};
+
+TestBenchProfiles::TestBenchProfiles(QObject *parent)
+    : QObject(parent)
+{
+    Tp::enableDebug(false);
+    Tp::enableWarnings(true);
+}
+
+void TestBenchProfiles::initTestCase()
+{
+    // Keep the parsed file cache out of the user's cache directory
+    QVERIFY(mCacheDir.isValid());
+    mOldCacheHome = qgetenv("XDG_CACHE_HOME");
+    qputenv("XDG_CACHE_HOME", QFile::encodeName(mCacheDir.path()));
+}
+
+void TestBenchProfiles::benchmarkProfiles_data()
+{
+    QTest::addColumn<bool>("sections");
+    QTest::addColumn<bool>("cached");
+
+    QTest::newRow("metadata, parsed") << false << false;
+    QTest::newRow("all sections, parsed") << true << false;
+    QTest::newRow("metadata, cached") << false << true;
+    QTest::newRow("all sections, cached") << true << true;
+}
+
+void TestBenchProfiles::benchmarkProfiles()
+{
+    QFETCH(bool, sections);
+    QFETCH(bool, cached);
+
+    // Every row gets files the parsed file cache has never seen, as it is keyed by file name
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString profilesDir = dir.path();
+
+    // Directory of 500 synthetic profiles, each with parameters, presences and
+    // unsupported channel classes sections
+    QStringList fileNames;
+    for (int i = 0; i < 500; ++i) {
+        QString serviceName = QString(QLatin1String("benchmark-profile-%1")).arg(i);
+        QFile file(QString(QLatin1String("%1/%2.profile")).arg(profilesDir).arg(serviceName));
+        QVERIFY(file.open(QFile::WriteOnly));
+        file.write(QString(QLatin1String(
+            "<service xmlns=\"http://telepathy.freedesktop.org/wiki/service-profile-v1\"\n"
+            "         id=\"%1\" type=\"IM\" provider=\"Provider\"\n"
+            "         manager=\"benchmarkcm\" protocol=\"proto%2\" icon=\"im-%1\">\n"
+            "  <name>Benchmark Profile %2</name>\n"
+            "  <parameters>\n"
+            "    <parameter name=\"server\" type=\"s\" mandatory=\"1\">server%2.com</parameter>\n"
+            "    <parameter name=\"port\" type=\"u\" mandatory=\"1\">5222</parameter>\n"
+            "    <parameter name=\"require-encryption\" type=\"b\">true</parameter>\n"
+            "  </parameters>\n"
+            "  <presences allow-others=\"1\">\n"
+            "    <presence id=\"available\" label=\"Online\" icon=\"online\" message=\"true\"/>\n"
+            "    <presence id=\"offline\" label=\"Offline\"/>\n"
+            "    <presence id=\"away\" label=\"Gone\" message=\"true\"/>\n"
+            "    <presence id=\"hidden\" disabled=\"1\"/>\n"
+            "  </presences>\n"
+            "  <unsupported-channel-classes>\n"
+            "    <channel-class>\n"
+            "      <property name=\"org.freedesktop.Telepathy.Channel.TargetHandleType\"\n"
+            "                type=\"u\">3</property>\n"
+            "      <property name=\"org.freedesktop.Telepathy.Channel.ChannelType\"\n"
+            "                type=\"s\">org.freedesktop.Telepathy.Channel.Type.Text</property>\n"
+            "    </channel-class>\n"
+            "  </unsupported-channel-classes>\n"
+            "</service>\n")).arg(serviceName).arg(i).toUtf8());
+        file.close();
+        fileNames.append(file.fileName());
+    }
+
+    if (cached) {
+        // Warm the cache up first, so that only cache hits are measured
+        loadProfiles(fileNames, sections);
+        QBENCHMARK {
+            loadProfiles(fileNames, sections);
+        }
+    } else {
+        // Any further iteration would be served from the cache filled by the first one
+        QBENCHMARK_ONCE {
+            loadProfiles(fileNames, sections);
+        }
+    }
+}
+
+void TestBenchProfiles::loadProfiles(const QStringList &fileNames, bool sections)
+{
+    foreach (const QString &fileName, fileNames) {
+        ProfilePtr profile = Profile::createForFileName(fileName);
+        QVERIFY(!profile->cmName().isEmpty());
+        if (sections) {
+            QCOMPARE(profile->parameters().size(), 3);
+            QCOMPARE(profile->presences().size(), 4);
+            QCOMPARE(profile->unsupportedChannelClassSpecs().size(), 1);
+        }
+    }
+}
+
+void TestBenchProfiles::cleanupTestCase()
+{
+    // Let the deferred cache save run while the directory is still there
+    QCoreApplication::processEvents();
+
+    if (mOldCacheHome.isEmpty()) {
+        qunsetenv("XDG_CACHE_HOME");
+    } else {
+        qputenv("XDG_CACHE_HOME", mOldCacheHome);
+    }
+}
+
+QTEST_MAIN(TestBenchProfiles)
+
+#include "_gen/bench-profiles.cpp.moc.hpp"
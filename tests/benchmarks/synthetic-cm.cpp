@@ -0,0 +1,539 @@
+#include "tests/benchmarks/synthetic-cm.h"
+
+#include <QDateTime>
+#include <QDebug>
+
+#include <TelepathyQt/Constants>
+#include <TelepathyQt/DBusError>
+#include <TelepathyQt/Types>
+
+namespace SyntheticCM
+{
+
+static const int c_churnInterval = 10; // ms
+
+static int intFromEnvironment(const char *name, int defaultValue)
+{
+    bool ok = false;
+    int value = qgetenv(name).toInt(&ok);
+    return (ok && value >= 0) ? value : defaultValue;
+}
+
+static Tp::RequestableChannelClass textChannelClass(Tp::HandleType targetHandleType)
+{
+    Tp::RequestableChannelClass text;
+    text.fixedProperties[TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType")] = TP_QT_IFACE_CHANNEL_TYPE_TEXT;
+    text.fixedProperties[TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandleType")] = uint(targetHandleType);
+    text.allowedProperties.append(TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandle"));
+    text.allowedProperties.append(TP_QT_IFACE_CHANNEL + QLatin1String(".TargetID"));
+    return text;
+}
+
+static Tp::SimpleStatusSpec statusSpec(Tp::ConnectionPresenceType type)
+{
+    Tp::SimpleStatusSpec spec;
+    spec.type = type;
+    spec.maySetOnSelf = true;
+    spec.canHaveMessage = (type != Tp::ConnectionPresenceTypeOffline);
+    return spec;
+}
+
+static Tp::SimplePresence churnPresence(uint step)
+{
+    static const char *statuses[] = { "available", "away", "busy" };
+    static const Tp::ConnectionPresenceType types[] = {
+        Tp::ConnectionPresenceTypeAvailable,
+        Tp::ConnectionPresenceTypeAway,
+        Tp::ConnectionPresenceTypeBusy
+    };
+
+    Tp::SimplePresence presence;
+    presence.type = types[step % 3];
+    presence.status = QLatin1String(statuses[step % 3]);
+    presence.statusMessage = QString(QLatin1String("step %1")).arg(step);
+    return presence;
+}
+
+Config::Config()
+    : contacts(200),
+      channels(20),
+      mucSize(50),
+      presenceChurnRate(100),
+      messageRate(100)
+{
+}
+
+Config Config::fromEnvironment()
+{
+    Config config;
+    config.contacts = intFromEnvironment("TPQT_BENCH_CONTACTS", config.contacts);
+    config.channels = intFromEnvironment("TPQT_BENCH_CHANNELS", config.channels);
+    config.mucSize = intFromEnvironment("TPQT_BENCH_MUC_SIZE", config.mucSize);
+    config.presenceChurnRate = intFromEnvironment("TPQT_BENCH_PRESENCE_RATE", config.presenceChurnRate);
+    config.messageRate = intFromEnvironment("TPQT_BENCH_MESSAGE_RATE", config.messageRate);
+    return config;
+}
+
+Connection::Connection(const QDBusConnection &dbusConnection,
+        const QString &cmName, const QString &protocolName,
+        const QVariantMap &parameters)
+    : Tp::BaseConnection(dbusConnection, cmName, protocolName, parameters),
+      mNextChannelTarget(0),
+      mPresenceCursor(0),
+      mMessageSerial(0),
+      mChurnPresencesSent(0),
+      mChurnMessagesSent(0)
+{
+    /* Connection.Interface.Contacts */
+    mContactsIface = Tp::BaseConnectionContactsInterface::create();
+    mContactsIface->setGetContactAttributesCallback(Tp::memFun(this, &Connection::getContactAttributes));
+    mContactsIface->setContactAttributeInterfaces(QStringList()
+            << TP_QT_IFACE_CONNECTION
+            << TP_QT_IFACE_CONNECTION_INTERFACE_SIMPLE_PRESENCE
+            << TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_LIST);
+    plugInterface(Tp::AbstractConnectionInterfacePtr::dynamicCast(mContactsIface));
+
+    /* Connection.Interface.SimplePresence */
+    Tp::SimpleStatusSpecMap statuses;
+    statuses.insert(QLatin1String("available"), statusSpec(Tp::ConnectionPresenceTypeAvailable));
+    statuses.insert(QLatin1String("away"), statusSpec(Tp::ConnectionPresenceTypeAway));
+    statuses.insert(QLatin1String("busy"), statusSpec(Tp::ConnectionPresenceTypeBusy));
+    statuses.insert(QLatin1String("offline"), statusSpec(Tp::ConnectionPresenceTypeOffline));
+
+    mPresenceIface = Tp::BaseConnectionSimplePresenceInterface::create();
+    mPresenceIface->setStatuses(statuses);
+    mPresenceIface->setSetPresenceCallback(Tp::memFun(this, &Connection::setPresence));
+    plugInterface(Tp::AbstractConnectionInterfacePtr::dynamicCast(mPresenceIface));
+
+    /* Connection.Interface.ContactList */
+    mContactListIface = Tp::BaseConnectionContactListInterface::create();
+    mContactListIface->setGetContactListAttributesCallback(Tp::memFun(this, &Connection::getContactListAttributes));
+    plugInterface(Tp::AbstractConnectionInterfacePtr::dynamicCast(mContactListIface));
+
+    /* Connection.Interface.Requests */
+    mRequestsIface = Tp::BaseConnectionRequestsInterface::create(this);
+    mRequestsIface->requestableChannelClasses << textChannelClass(Tp::HandleTypeContact)
+                                              << textChannelClass(Tp::HandleTypeRoom);
+    plugInterface(Tp::AbstractConnectionInterfacePtr::dynamicCast(mRequestsIface));
+
+    setConnectCallback(Tp::memFun(this, &Connection::connectCB));
+    setCreateChannelCallback(Tp::memFun(this, &Connection::createChannelCB));
+    setInspectHandlesCallback(Tp::memFun(this, &Connection::inspectHandles));
+    setRequestHandlesCallback(Tp::memFun(this, &Connection::requestHandles));
+
+    mContactIds.insert(1, QLatin1String("self@synthetic"));
+    mContactHandles.insert(QLatin1String("self@synthetic"), 1);
+    setSelfContact(1, QLatin1String("self@synthetic"));
+
+    mChurnTimer.setInterval(c_churnInterval);
+    connect(&mChurnTimer, SIGNAL(timeout()), SLOT(onChurnTimeout()));
+
+    setConfig(Config());
+}
+
+Connection::~Connection()
+{
+}
+
+void Connection::setConfig(const Config &config)
+{
+    mConfig = config;
+
+    for (int i = 0; i < mConfig.contacts; ++i) {
+        uint handle = contactHandle(i);
+        if (mContactIds.contains(handle)) {
+            continue;
+        }
+
+        QString id = QString(QLatin1String("contact%1@synthetic")).arg(i);
+        mContactIds.insert(handle, id);
+        mContactHandles.insert(id, handle);
+        mPresences.insert(handle, churnPresence(i));
+    }
+}
+
+QStringList Connection::rosterIdentifiers() const
+{
+    QStringList ids;
+    for (int i = 0; i < mConfig.contacts; ++i) {
+        ids << mContactIds.value(contactHandle(i));
+    }
+    return ids;
+}
+
+void Connection::changePresences(int count)
+{
+    if (mConfig.contacts == 0) {
+        return;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        uint step = mPresenceCursor++;
+        uint handle = contactHandle(step % mConfig.contacts);
+        Tp::SimplePresence presence = churnPresence(step + 1);
+        mPresences[handle] = presence;
+
+        Tp::SimpleContactPresences changed;
+        changed.insert(handle, presence);
+        mPresenceIface->setPresences(changed);
+    }
+}
+
+QList<Tp::BaseChannelPtr> Connection::announceTextChannels(int count)
+{
+    QList<Tp::BaseChannelPtr> channels;
+    if (mConfig.contacts == 0) {
+        return channels;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        uint handle = contactHandle(mNextChannelTarget++ % mConfig.contacts);
+
+        QVariantMap request;
+        request[TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType")] = TP_QT_IFACE_CHANNEL_TYPE_TEXT;
+        request[TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandleType")] = uint(Tp::HandleTypeContact);
+        request[TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandle")] = handle;
+        request[TP_QT_IFACE_CHANNEL + QLatin1String(".InitiatorHandle")] = handle;
+
+        Tp::DBusError error;
+        Tp::BaseChannelPtr channel = createChannel(request, /* suppressHandler */ false, &error);
+        if (error.isValid()) {
+            qWarning() << "Unable to announce text channel:" << error.message();
+            break;
+        }
+        channels << channel;
+    }
+
+    return channels;
+}
+
+Tp::BaseChannelPtr Connection::announceRoom(int members)
+{
+    uint handle = ensureRoomHandle(QString(QLatin1String("room%1@conference.synthetic"))
+            .arg(mRoomIds.size()));
+
+    QVariantMap request;
+    request[TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType")] = TP_QT_IFACE_CHANNEL_TYPE_TEXT;
+    request[TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandleType")] = uint(Tp::HandleTypeRoom);
+    request[TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandle")] = handle;
+
+    Tp::DBusError error;
+    Tp::BaseChannelPtr channel = createChannel(request, /* suppressHandler */ false, &error);
+    if (error.isValid()) {
+        qWarning() << "Unable to announce room:" << error.message();
+        return Tp::BaseChannelPtr();
+    }
+
+    Tp::BaseChannelGroupInterfacePtr group = Tp::BaseChannelGroupInterfacePtr::dynamicCast(
+            channel->interface(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP));
+    Tp::UIntList memberHandles;
+    memberHandles << selfHandle();
+    for (int i = 0; i < qMin(members, mConfig.contacts); ++i) {
+        memberHandles << contactHandle(i);
+    }
+    group->setMembers(memberHandles, QVariantMap());
+
+    return channel;
+}
+
+void Connection::receiveMessages(const Tp::BaseChannelPtr &channel, int count)
+{
+    Tp::BaseChannelTextTypePtr textType = Tp::BaseChannelTextTypePtr::dynamicCast(
+            channel->interface(TP_QT_IFACE_CHANNEL_TYPE_TEXT));
+    if (!textType || mConfig.contacts == 0) {
+        return;
+    }
+
+    uint timestamp = QDateTime::currentDateTime().toTime_t();
+    for (int i = 0; i < count; ++i) {
+        uint serial = ++mMessageSerial;
+        uint sender = channel->targetHandleType() == Tp::HandleTypeContact ?
+            channel->targetHandle() : contactHandle(serial % mConfig.contacts);
+
+        Tp::MessagePart header;
+        header[QLatin1String("message-token")] = QDBusVariant(QString::number(serial));
+        header[QLatin1String("message-sender")] = QDBusVariant(sender);
+        header[QLatin1String("message-sender-id")] = QDBusVariant(mContactIds.value(sender));
+        header[QLatin1String("message-received")] = QDBusVariant(timestamp);
+        header[QLatin1String("message-type")] = QDBusVariant(uint(Tp::ChannelTextMessageTypeNormal));
+
+        Tp::MessagePart body;
+        body[QLatin1String("content-type")] = QDBusVariant(QString(QLatin1String("text/plain")));
+        body[QLatin1String("content")] = QDBusVariant(
+                QString(QLatin1String("Synthetic message %1")).arg(serial));
+
+        textType->addReceivedMessage(Tp::MessagePartList() << header << body);
+    }
+}
+
+void Connection::startChurn(const Tp::BaseChannelPtr &messageChannel)
+{
+    mChurnChannel = messageChannel;
+    mChurnPresencesSent = 0;
+    mChurnMessagesSent = 0;
+    mChurnClock.start();
+    mChurnTimer.start();
+}
+
+void Connection::stopChurn()
+{
+    mChurnTimer.stop();
+    mChurnChannel.reset();
+}
+
+void Connection::onChurnTimeout()
+{
+    qint64 elapsed = mChurnClock.elapsed();
+
+    qint64 presencesDue = mConfig.presenceChurnRate * elapsed / 1000 - mChurnPresencesSent;
+    if (presencesDue > 0) {
+        changePresences(presencesDue);
+        mChurnPresencesSent += presencesDue;
+    }
+
+    if (mChurnChannel) {
+        qint64 messagesDue = mConfig.messageRate * elapsed / 1000 - mChurnMessagesSent;
+        if (messagesDue > 0) {
+            receiveMessages(mChurnChannel, messagesDue);
+            mChurnMessagesSent += messagesDue;
+        }
+    }
+}
+
+void Connection::connectCB(Tp::DBusError *error)
+{
+    Q_UNUSED(error)
+    setStatus(Tp::ConnectionStatusConnected, Tp::ConnectionStatusReasonRequested);
+    mContactListIface->setContactListState(Tp::ContactListStateSuccess);
+}
+
+Tp::BaseChannelPtr Connection::createChannelCB(const QVariantMap &request, Tp::DBusError *error)
+{
+    const QString channelType = request.value(TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType")).toString();
+    uint targetHandleType = request.value(TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandleType")).toUInt();
+    uint targetHandle = request.value(TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandle")).toUInt();
+    QString targetID;
+
+    if (channelType != TP_QT_IFACE_CHANNEL_TYPE_TEXT) {
+        error->set(TP_QT_ERROR_NOT_IMPLEMENTED, QLatin1String("Only text channels are supported"));
+        return Tp::BaseChannelPtr();
+    }
+
+    switch (targetHandleType) {
+    case Tp::HandleTypeContact:
+        if (!targetHandle) {
+            targetHandle = mContactHandles.value(request.value(TP_QT_IFACE_CHANNEL + QLatin1String(".TargetID")).toString());
+        }
+        targetID = mContactIds.value(targetHandle);
+        break;
+    case Tp::HandleTypeRoom:
+        if (!targetHandle) {
+            targetHandle = ensureRoomHandle(request.value(TP_QT_IFACE_CHANNEL + QLatin1String(".TargetID")).toString());
+        }
+        targetID = mRoomIds.value(targetHandle);
+        break;
+    default:
+        error->set(TP_QT_ERROR_INVALID_ARGUMENT, QLatin1String("Unexpected target handle type"));
+        return Tp::BaseChannelPtr();
+    }
+
+    if (targetID.isEmpty()) {
+        error->set(TP_QT_ERROR_INVALID_HANDLE, QLatin1String("Unexpected target (unknown handle/ID)"));
+        return Tp::BaseChannelPtr();
+    }
+
+    Tp::BaseChannelPtr baseChannel = Tp::BaseChannel::create(this, channelType,
+            Tp::HandleType(targetHandleType), targetHandle);
+    baseChannel->setTargetID(targetID);
+
+    Tp::BaseChannelTextTypePtr textType = Tp::BaseChannelTextType::create(baseChannel.data());
+    baseChannel->plugInterface(Tp::AbstractChannelInterfacePtr::dynamicCast(textType));
+
+    Tp::BaseChannelMessagesInterfacePtr messages = Tp::BaseChannelMessagesInterface::create(
+            textType.data(),
+            QStringList() << QLatin1String("text/plain"),
+            Tp::UIntList() << Tp::ChannelTextMessageTypeNormal,
+            Tp::MessagePartSupportFlagOneAttachment | Tp::MessagePartSupportFlagMultipleAttachments,
+            Tp::DeliveryReportingSupportFlagReceiveFailures);
+    baseChannel->plugInterface(Tp::AbstractChannelInterfacePtr::dynamicCast(messages));
+
+    if (targetHandleType == Tp::HandleTypeRoom) {
+        Tp::BaseChannelGroupInterfacePtr group = Tp::BaseChannelGroupInterface::create();
+        baseChannel->plugInterface(Tp::AbstractChannelInterfacePtr::dynamicCast(group));
+        group->setSelfHandle(selfHandle());
+    }
+
+    return baseChannel;
+}
+
+QStringList Connection::inspectHandles(uint handleType, const Tp::UIntList &handles, Tp::DBusError *error)
+{
+    const QHash<uint, QString> *ids;
+    switch (handleType) {
+    case Tp::HandleTypeContact:
+        ids = &mContactIds;
+        break;
+    case Tp::HandleTypeRoom:
+        ids = &mRoomIds;
+        break;
+    default:
+        error->set(TP_QT_ERROR_INVALID_ARGUMENT, QLatin1String("Unexpected handle type"));
+        return QStringList();
+    }
+
+    QStringList result;
+    Q_FOREACH (uint handle, handles) {
+        if (!ids->contains(handle)) {
+            error->set(TP_QT_ERROR_INVALID_HANDLE, QLatin1String("Unknown handle"));
+            return QStringList();
+        }
+        result << ids->value(handle);
+    }
+
+    return result;
+}
+
+Tp::UIntList Connection::requestHandles(uint handleType, const QStringList &identifiers, Tp::DBusError *error)
+{
+    Tp::UIntList result;
+
+    // Contact list channels (e.g. the deny list) are not provided
+    if (handleType != Tp::HandleTypeContact && handleType != Tp::HandleTypeRoom) {
+        error->set(TP_QT_ERROR_NOT_AVAILABLE, QLatin1String("Unsupported handle type"));
+        return result;
+    }
+
+    Q_FOREACH (const QString &identifier, identifiers) {
+        uint handle = handleType == Tp::HandleTypeContact ?
+            mContactHandles.value(identifier) : ensureRoomHandle(identifier);
+        if (!handle) {
+            error->set(TP_QT_ERROR_INVALID_HANDLE,
+                    QString(QLatin1String("Unknown identifier (%1)")).arg(identifier));
+            return Tp::UIntList();
+        }
+        result << handle;
+    }
+
+    return result;
+}
+
+Tp::ContactAttributesMap Connection::getContactAttributes(const Tp::UIntList &handles,
+        const QStringList &interfaces, Tp::DBusError *error)
+{
+    Q_UNUSED(error)
+
+    bool wantPresence = interfaces.contains(TP_QT_IFACE_CONNECTION_INTERFACE_SIMPLE_PRESENCE);
+    bool wantContactList = interfaces.contains(TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_LIST);
+
+    Tp::ContactAttributesMap contactAttributes;
+    Q_FOREACH (uint handle, handles) {
+        if (!mContactIds.contains(handle)) {
+            continue;
+        }
+
+        QVariantMap attributes;
+        attributes[TP_QT_IFACE_CONNECTION + QLatin1String("/contact-id")] = mContactIds.value(handle);
+
+        if (wantPresence) {
+            Tp::SimplePresence presence = mPresences.value(handle, churnPresence(0));
+            attributes[TP_QT_IFACE_CONNECTION_INTERFACE_SIMPLE_PRESENCE + QLatin1String("/presence")] =
+                QVariant::fromValue(presence);
+        }
+
+        if (wantContactList && handle != selfHandle()) {
+            attributes[TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_LIST + QLatin1String("/subscribe")] =
+                uint(Tp::SubscriptionStateYes);
+            attributes[TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_LIST + QLatin1String("/publish")] =
+                uint(Tp::SubscriptionStateYes);
+        }
+
+        contactAttributes[handle] = attributes;
+    }
+
+    return contactAttributes;
+}
+
+Tp::ContactAttributesMap Connection::getContactListAttributes(const QStringList &interfaces,
+        bool hold, Tp::DBusError *error)
+{
+    Q_UNUSED(hold)
+
+    Tp::UIntList handles;
+    for (int i = 0; i < mConfig.contacts; ++i) {
+        handles << contactHandle(i);
+    }
+
+    QStringList allInterfaces = interfaces;
+    allInterfaces << TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_LIST;
+    return getContactAttributes(handles, allInterfaces, error);
+}
+
+uint Connection::setPresence(const QString &status, const QString &message, Tp::DBusError *error)
+{
+    Q_UNUSED(status)
+    Q_UNUSED(message)
+    Q_UNUSED(error)
+    return 0;
+}
+
+uint Connection::ensureRoomHandle(const QString &identifier)
+{
+    if (identifier.isEmpty()) {
+        return 0;
+    }
+
+    uint handle = mRoomHandles.value(identifier);
+    if (!handle) {
+        handle = mRoomIds.size() + 1;
+        mRoomIds.insert(handle, identifier);
+        mRoomHandles.insert(identifier, handle);
+    }
+    return handle;
+}
+
+Manager::Manager(const Config &config, QObject *parent)
+    : QObject(parent),
+      mConfig(config)
+{
+    mProtocol = Tp::BaseProtocol::create(QLatin1String("synthetic"));
+    mProtocol->setRequestableChannelClasses(Tp::RequestableChannelClassSpecList()
+            << textChannelClass(Tp::HandleTypeContact)
+            << textChannelClass(Tp::HandleTypeRoom));
+    mProtocol->setCreateConnectionCallback(Tp::memFun(this, &Manager::createConnectionCB));
+
+    mConnectionManager = Tp::BaseConnectionManager::create(QLatin1String("syntheticcm"));
+    mConnectionManager->addProtocol(mProtocol);
+}
+
+Manager::~Manager()
+{
+}
+
+bool Manager::registerObject(Tp::DBusError *error)
+{
+    return mConnectionManager->registerObject(error);
+}
+
+QString Manager::name() const
+{
+    return mConnectionManager->name();
+}
+
+QString Manager::protocolName() const
+{
+    return mProtocol->name();
+}
+
+Tp::BaseConnectionPtr Manager::createConnectionCB(const QVariantMap &parameters, Tp::DBusError *error)
+{
+    Q_UNUSED(error)
+
+    mConnection = Tp::BaseConnection::create<Connection>(mConnectionManager->name(),
+            mProtocol->name(), parameters);
+    mConnection->setConfig(mConfig);
+    return Tp::BaseConnectionPtr::staticCast(mConnection);
+}
+
+} // namespace SyntheticCM
+
+#include "_gen/synthetic-cm.h.moc.hpp"
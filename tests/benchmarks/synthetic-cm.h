@@ -0,0 +1,137 @@
+#ifndef _TelepathyQt_tests_benchmarks_synthetic_cm_h_HEADER_GUARD_
+#define _TelepathyQt_tests_benchmarks_synthetic_cm_h_HEADER_GUARD_
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+
+#include <TelepathyQt/BaseChannel>
+#include <TelepathyQt/BaseConnection>
+#include <TelepathyQt/BaseConnectionManager>
+#include <TelepathyQt/BaseProtocol>
+
+// A connection manager built on the service-side Base* classes, used by the benchmarks to generate
+// configurable amounts of traffic without depending on a real protocol backend.
+namespace SyntheticCM // The namespace is needed to avoid class name collisions with other tests
+{
+
+struct Config
+{
+    Config();
+
+    // Reads the TPQT_BENCH_* environment variables on top of the defaults.
+    static Config fromEnvironment();
+
+    int contacts;          // TPQT_BENCH_CONTACTS: roster size
+    int channels;          // TPQT_BENCH_CHANNELS: text channels announced per dispatch burst
+    int mucSize;           // TPQT_BENCH_MUC_SIZE: members of the largest chat room
+    int presenceChurnRate; // TPQT_BENCH_PRESENCE_RATE: presence changes per second
+    int messageRate;       // TPQT_BENCH_MESSAGE_RATE: received messages per second
+};
+
+class Connection;
+typedef Tp::SharedPtr<Connection> ConnectionPtr;
+
+class Connection : public Tp::BaseConnection
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(Connection)
+
+public:
+    Connection(const QDBusConnection &dbusConnection,
+            const QString &cmName, const QString &protocolName,
+            const QVariantMap &parameters);
+    virtual ~Connection();
+
+    Config config() const { return mConfig; }
+    void setConfig(const Config &config);
+
+    QStringList rosterIdentifiers() const;
+
+    // Emits one PresencesChanged per change, cycling through the roster.
+    void changePresences(int count);
+
+    // Each call announces new channels through Requests.NewChannels, as a CM does for
+    // incoming chats.
+    QList<Tp::BaseChannelPtr> announceTextChannels(int count);
+    Tp::BaseChannelPtr announceRoom(int members);
+
+    void receiveMessages(const Tp::BaseChannelPtr &channel, int count);
+
+    // Background traffic at config().presenceChurnRate and config().messageRate; messages go
+    // to the channel given, if any.
+    void startChurn(const Tp::BaseChannelPtr &messageChannel = Tp::BaseChannelPtr());
+    void stopChurn();
+
+private Q_SLOTS:
+    void onChurnTimeout();
+
+private:
+    void connectCB(Tp::DBusError *error);
+    Tp::BaseChannelPtr createChannelCB(const QVariantMap &request, Tp::DBusError *error);
+    QStringList inspectHandles(uint handleType, const Tp::UIntList &handles, Tp::DBusError *error);
+    Tp::UIntList requestHandles(uint handleType, const QStringList &identifiers, Tp::DBusError *error);
+    Tp::ContactAttributesMap getContactAttributes(const Tp::UIntList &handles,
+            const QStringList &interfaces, Tp::DBusError *error);
+    Tp::ContactAttributesMap getContactListAttributes(const QStringList &interfaces, bool hold,
+            Tp::DBusError *error);
+    uint setPresence(const QString &status, const QString &message, Tp::DBusError *error);
+
+    uint contactHandle(int index) const { return index + 2; }
+    uint ensureRoomHandle(const QString &identifier);
+
+    Config mConfig;
+
+    Tp::BaseConnectionContactsInterfacePtr mContactsIface;
+    Tp::BaseConnectionSimplePresenceInterfacePtr mPresenceIface;
+    Tp::BaseConnectionContactListInterfacePtr mContactListIface;
+    Tp::BaseConnectionRequestsInterfacePtr mRequestsIface;
+
+    QHash<uint, QString> mContactIds;
+    QHash<QString, uint> mContactHandles;
+    QHash<uint, QString> mRoomIds;
+    QHash<QString, uint> mRoomHandles;
+    QHash<uint, Tp::SimplePresence> mPresences;
+
+    uint mNextChannelTarget;
+    uint mPresenceCursor;
+    uint mMessageSerial;
+
+    QTimer mChurnTimer;
+    QElapsedTimer mChurnClock;
+    qint64 mChurnPresencesSent;
+    qint64 mChurnMessagesSent;
+    Tp::BaseChannelPtr mChurnChannel;
+};
+
+class Manager : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(Manager)
+
+public:
+    Manager(const Config &config, QObject *parent = 0);
+    virtual ~Manager();
+
+    bool registerObject(Tp::DBusError *error);
+
+    QString name() const;
+    QString protocolName() const;
+
+    // The most recently created connection.
+    ConnectionPtr connection() const { return mConnection; }
+
+private:
+    Tp::BaseConnectionPtr createConnectionCB(const QVariantMap &parameters, Tp::DBusError *error);
+
+    Config mConfig;
+    Tp::BaseProtocolPtr mProtocol;
+    Tp::BaseConnectionManagerPtr mConnectionManager;
+    ConnectionPtr mConnection;
+};
+
+} // namespace SyntheticCM
+
+#endif // _TelepathyQt_tests_benchmarks_synthetic_cm_h_HEADER_GUARD_
@@ -376,6 +376,26 @@ void TestCapabilities::testContactCapabilities()
     expectedSTubeServices << QLatin1String("service-foo") << QLatin1String("service-bar");
     expectedSTubeServices.sort();
     QCOMPARE(stubeServices, expectedSTubeServices);
+
+    QVERIFY(!contactCaps.dbusTubes(QString()));
+    QVERIFY(!contactCaps.dbusTubes(QLatin1String("org.example.Foo")));
+    QVERIFY(contactCaps.dbusTubeServices().isEmpty());
+
+    rccSpecs.append(RequestableChannelClassSpec::dbusTube(QLatin1String("org.example.Foo")));
+
+    contactCaps = TestBackdoors::createContactCapabilities(rccSpecs, true);
+    QVERIFY(!contactCaps.dbusTubes(QString()));
+    QVERIFY(contactCaps.dbusTubes(QLatin1String("org.example.Foo")));
+    QVERIFY(!contactCaps.dbusTubes(QLatin1String("org.example.Bar")));
+    QCOMPARE(contactCaps.dbusTubeServices(), QStringList() << QLatin1String("org.example.Foo"));
+
+    rccSpecs.append(RequestableChannelClassSpec::dbusTube());
+
+    contactCaps = TestBackdoors::createContactCapabilities(rccSpecs, true);
+    QVERIFY(contactCaps.dbusTubes(QString()));
+    QVERIFY(contactCaps.dbusTubes(QLatin1String("org.example.Foo")));
+    QVERIFY(!contactCaps.dbusTubes(QLatin1String("org.example.Bar")));
+    QCOMPARE(contactCaps.dbusTubeServices(), QStringList() << QLatin1String("org.example.Foo"));
 }
 
 QTEST_MAIN(TestCapabilities)
@@ -43,12 +43,17 @@ protected Q_SLOTS:
     void onAccountAutomaticPresenceChanged(const Tp::Presence &);
     void onAccountRequestedPresenceChanged(const Tp::Presence &);
     void onAccountCurrentPresenceChanged(const Tp::Presence &);
+    void onOrderedDisplayNameChanged(const QString &);
+    void onOrderedSetFinished(Tp::PendingOperation *);
 
 private Q_SLOTS:
     void initTestCase();
     void init();
 
     void testBasics();
+    void testLazyAccounts();
+    void testBatchedPropertyChanges();
+    void testPropertySignalOrdering();
 
     void cleanup();
     void cleanupTestCase();
@@ -63,6 +68,9 @@ private:
     bool mCreatingAccount;
 
     QHash<QString, QVariant> mProps;
+
+    AccountPtr mOrderedAccount;
+    QStringList mOrderedEvents;
 };
 
 #define TEST_VERIFY_PROPERTY_CHANGE(acc, Type, PropertyName, propertyName, expectedValue) \
@@ -129,6 +137,21 @@ TEST_IMPLEMENT_PROPERTY_CHANGE_SLOT(const Presence &, AutomaticPresence)
 TEST_IMPLEMENT_PROPERTY_CHANGE_SLOT(const Presence &, RequestedPresence)
 TEST_IMPLEMENT_PROPERTY_CHANGE_SLOT(const Presence &, CurrentPresence)
 
+void TestAccountBasics::onOrderedDisplayNameChanged(const QString &displayName)
+{
+    mOrderedEvents << QLatin1String("changed:") + displayName;
+}
+
+void TestAccountBasics::onOrderedSetFinished(Tp::PendingOperation *op)
+{
+    if (op->isError()) {
+        mOrderedEvents << QLatin1String("error:") + op->errorName();
+    } else {
+        mOrderedEvents << QLatin1String("finished:") + mOrderedAccount->displayName();
+    }
+    mLoop->exit(0);
+}
+
 QStringList TestAccountBasics::pathsForAccounts(const QList<AccountPtr> &list)
 {
     QStringList ret;
@@ -581,6 +604,166 @@ void TestAccountBasics::testBasics()
     processDBusQueue(mConn->client().data());
 }
 
+void TestAccountBasics::testLazyAccounts()
+{
+    // Lazy accounts with an account factory with no features make the account manager skip
+    // the per-account introspection
+    AccountManagerPtr am = AccountManager::create(
+            AccountFactory::create(QDBusConnection::sessionBus()));
+    QVERIFY(!am->isLazyAccountsEnabled());
+    am->setLazyAccountsEnabled(true);
+    QVERIFY(am->isLazyAccountsEnabled());
+    QVERIFY(connect(am->becomeReady(),
+                    SIGNAL(finished(Tp::PendingOperation *)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation *))));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(am->isReady());
+
+    QString accPath(QLatin1String("/org/freedesktop/Telepathy/Account/foo/bar/Account0"));
+    QCOMPARE(pathsForAccounts(am->allAccounts()), QStringList() << accPath);
+    AccountPtr acc = am->accountForObjectPath(accPath);
+    QVERIFY(!acc.isNull());
+    QVERIFY(!acc->isReady(Account::FeatureCore));
+
+    QVERIFY(connect(am->prefetchAccounts(am->allAccounts()),
+                    SIGNAL(finished(Tp::PendingOperation *)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation *))));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(acc->isReady(Account::FeatureCore));
+    QCOMPARE(acc->cmName(), QLatin1String("foo"));
+    QCOMPARE(acc->protocolName(), QLatin1String("bar"));
+
+    // Nothing left to introspect
+    QVERIFY(connect(am->prefetchAccounts(am->allAccounts()),
+                    SIGNAL(finished(Tp::PendingOperation *)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation *))));
+    QCOMPARE(mLoop->exec(), 0);
+
+    // Accounts created through a lazy account manager are still built by its factory
+    QVariantMap parameters;
+    parameters[QLatin1String("account")] = QLatin1String("lazy");
+    PendingAccount *pacc = am->createAccount(QLatin1String("foo"),
+            QLatin1String("baz"), QLatin1String("lazy"), parameters);
+    QVERIFY(connect(pacc,
+                    SIGNAL(finished(Tp::PendingOperation *)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation *))));
+    mCreatingAccount = true;
+    QCOMPARE(mLoop->exec(), 0);
+    mCreatingAccount = false;
+    QVERIFY(pacc->account());
+    // The factory hands out the same proxy to the account manager and to the PendingAccount
+    QCOMPARE(am->accountForObjectPath(pacc->account()->objectPath()), pacc->account());
+    QVERIFY(!pacc->account()->isReady(Account::FeatureCore));
+
+    // The eager account manager of the other tests gets it too
+    while (mAccountsCount != 2) {
+        QCOMPARE(mLoop->exec(), 0);
+    }
+
+    processDBusQueue(mConn->client().data());
+}
+
+void TestAccountBasics::testBatchedPropertyChanges()
+{
+    QVERIFY(mAM->isReady());
+    AccountPtr acc = mAM->accountForObjectPath(
+            QLatin1String("/org/freedesktop/Telepathy/Account/foo/bar/Account0"));
+    QVERIFY(!acc.isNull());
+    QVERIFY(acc->isReady(Account::FeatureCore));
+    processDBusQueue(acc.data());
+
+    Client::DBus::PropertiesInterface *accPropertiesInterface =
+        acc->interface<Client::DBus::PropertiesInterface>();
+
+    QSignalSpy displayNameSpy(acc.data(), SIGNAL(displayNameChanged(QString)));
+    QSignalSpy nicknameSpy(acc.data(), SIGNAL(nicknameChanged(QString)));
+    QSignalSpy iconNameSpy(acc.data(), SIGNAL(iconNameChanged(QString)));
+
+    // Wait for the service to handle every change without returning to the mainloop, so that
+    // all the AccountPropertyChanged signals are delivered in the same mainloop iteration
+    QList<QDBusPendingCall> calls;
+    calls << accPropertiesInterface->Set(TP_QT_IFACE_ACCOUNT,
+                QLatin1String("DisplayName"), QDBusVariant(QLatin1String("batched 1")));
+    calls << accPropertiesInterface->Set(TP_QT_IFACE_ACCOUNT,
+                QLatin1String("Nickname"), QDBusVariant(QLatin1String("nick 1")));
+    calls << accPropertiesInterface->Set(TP_QT_IFACE_ACCOUNT,
+                QLatin1String("DisplayName"), QDBusVariant(QLatin1String("batched 2")));
+    calls << accPropertiesInterface->Set(TP_QT_IFACE_ACCOUNT,
+                QLatin1String("Nickname"), QDBusVariant(QLatin1String("nick 2")));
+    calls << accPropertiesInterface->Set(TP_QT_IFACE_ACCOUNT,
+                QLatin1String("DisplayName"), QDBusVariant(QLatin1String("batched 3")));
+    Q_FOREACH (QDBusPendingCall call, calls) {
+        call.waitForFinished();
+        QVERIFY(!call.isError());
+    }
+
+    // Nothing is applied until the merged changes are processed from the mainloop
+    QCOMPARE(displayNameSpy.size(), 0);
+    QCOMPARE(nicknameSpy.size(), 0);
+
+    processDBusQueue(acc.data());
+
+    // Each changed property is signalled exactly once, with its final value
+    QCOMPARE(displayNameSpy.size(), 1);
+    QCOMPARE(displayNameSpy.first().first().toString(), QLatin1String("batched 3"));
+    QCOMPARE(acc->displayName(), QLatin1String("batched 3"));
+    QCOMPARE(nicknameSpy.size(), 1);
+    QCOMPARE(nicknameSpy.first().first().toString(), QLatin1String("nick 2"));
+    QCOMPARE(acc->nickname(), QLatin1String("nick 2"));
+
+    // and properties which didn't change are not signalled at all
+    QCOMPARE(iconNameSpy.size(), 0);
+
+    processDBusQueue(mConn->client().data());
+}
+
+void TestAccountBasics::testPropertySignalOrdering()
+{
+    QVERIFY(mAM->isReady());
+    mOrderedAccount = mAM->accountForObjectPath(
+            QLatin1String("/org/freedesktop/Telepathy/Account/foo/bar/Account0"));
+    QVERIFY(!mOrderedAccount.isNull());
+    QVERIFY(mOrderedAccount->isReady(Account::FeatureCore));
+    processDBusQueue(mOrderedAccount.data());
+
+    mOrderedEvents.clear();
+    QVERIFY(connect(mOrderedAccount.data(), SIGNAL(displayNameChanged(QString)),
+                SLOT(onOrderedDisplayNameChanged(QString))));
+
+    // The service signals the change before replying, so even though property changes are
+    // deferred, the change is signalled before the operation finishes and the operation's
+    // users already see the new value
+    QVERIFY(connect(mOrderedAccount->setDisplayName(QLatin1String("ordered 1")),
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(onOrderedSetFinished(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mOrderedEvents, QStringList()
+            << QLatin1String("changed:ordered 1")
+            << QLatin1String("finished:ordered 1"));
+
+    // The same holds when the changes of several operations are merged
+    mOrderedEvents.clear();
+    PendingOperation *first = mOrderedAccount->setDisplayName(QLatin1String("ordered 2"));
+    PendingOperation *second = mOrderedAccount->setDisplayName(QLatin1String("ordered 3"));
+    QVERIFY(connect(first, SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(onOrderedSetFinished(Tp::PendingOperation*))));
+    QVERIFY(connect(second, SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(onOrderedSetFinished(Tp::PendingOperation*))));
+    while (mOrderedEvents.filter(QLatin1String("finished:")).size() < 2 &&
+           mOrderedEvents.filter(QLatin1String("error:")).isEmpty()) {
+        QCOMPARE(mLoop->exec(), 0);
+    }
+    QVERIFY(mOrderedEvents.filter(QLatin1String("error:")).isEmpty());
+    QVERIFY(mOrderedEvents.first().startsWith(QLatin1String("changed:")));
+    QVERIFY(mOrderedEvents.contains(QLatin1String("changed:ordered 3")));
+    QCOMPARE(mOrderedEvents.last(), QLatin1String("finished:ordered 3"));
+
+    QVERIFY(disconnect(mOrderedAccount.data(), SIGNAL(displayNameChanged(QString)),
+                this, SLOT(onOrderedDisplayNameChanged(QString))));
+    processDBusQueue(mOrderedAccount.data());
+    mOrderedAccount.reset();
+}
+
 void TestAccountBasics::cleanup()
 {
     cleanupImpl();
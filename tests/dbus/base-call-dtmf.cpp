@@ -0,0 +1,288 @@
+#include <tests/lib/test.h>
+
+#include <TelepathyQt/BaseCall>
+#include <TelepathyQt/BaseChannel>
+#include <TelepathyQt/BaseConnection>
+#include <TelepathyQt/CallContentInterfaceDTMFInterface>
+#include <TelepathyQt/Constants>
+#include <TelepathyQt/DBusError>
+
+using namespace Tp;
+
+class ToneRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    ToneRecorder(QObject *parent = 0) : QObject(parent) { }
+
+    void startTone(uchar event, DBusError *error)
+    {
+        Q_UNUSED(error);
+        events.append(QString(QLatin1String("start:%1")).arg(event));
+        emit toneStarted();
+    }
+
+    void stopTone(DBusError *error)
+    {
+        Q_UNUSED(error);
+        events.append(QLatin1String("stop"));
+        emit toneStopped();
+    }
+
+    QStringList events;
+
+Q_SIGNALS:
+    void toneStarted();
+    void toneStopped();
+};
+
+class TestBaseCallDTMF : public Test
+{
+    Q_OBJECT
+
+public:
+    TestBaseCallDTMF(QObject *parent = 0)
+        : Test(parent), mStoppedTones(0)
+    { }
+
+protected Q_SLOTS:
+    void onStoppedTones(bool cancelled);
+    void onToneStoppedDeleteSecond();
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+
+    void testMultipleContents();
+    void testStopToneCancelsSequence();
+    void testDeleteContentWhileScheduled();
+
+    void cleanup();
+    void cleanupTestCase();
+
+private:
+    BaseCallContentPtr createContent(const QString &name, ToneRecorder *recorder,
+            BaseCallContentDTMFInterfacePtr *dtmf);
+    Client::CallContentInterfaceDTMFInterface *dtmfClient(const BaseCallContentPtr &content);
+    void waitForStoppedTones(int count);
+
+    BaseConnectionPtr mConn;
+    BaseChannelPtr mChannel;
+
+    BaseCallContentPtr mContents[2];
+    BaseCallContentDTMFInterfacePtr mDTMF[2];
+    ToneRecorder *mRecorders[2];
+    Client::CallContentInterfaceDTMFInterface *mClients[2];
+
+    int mStoppedTones;
+    QList<bool> mStoppedCancelled;
+    int mEventsAtDeletion;
+};
+
+void TestBaseCallDTMF::onStoppedTones(bool cancelled)
+{
+    mStoppedTones++;
+    mStoppedCancelled.append(cancelled);
+    mLoop->exit(0);
+}
+
+void TestBaseCallDTMF::onToneStoppedDeleteSecond()
+{
+    if (!mContents[1]) {
+        return;
+    }
+
+    // The second content still has its next step scheduled, possibly on this very timeout
+    mEventsAtDeletion = mRecorders[1]->events.size();
+    mDTMF[1].reset();
+    mContents[1].reset();
+}
+
+BaseCallContentPtr TestBaseCallDTMF::createContent(const QString &name,
+        ToneRecorder *recorder, BaseCallContentDTMFInterfacePtr *dtmf)
+{
+    BaseCallContentPtr content = BaseCallContent::create(QDBusConnection::sessionBus(),
+            mChannel.data(), name, MediaStreamTypeAudio, MediaStreamDirectionBidirectional);
+
+    *dtmf = BaseCallContentDTMFInterface::create();
+    (*dtmf)->setStartToneCallback(memFun(recorder, &ToneRecorder::startTone));
+    (*dtmf)->setStopToneCallback(memFun(recorder, &ToneRecorder::stopTone));
+    (*dtmf)->setToneDuration(20);
+    (*dtmf)->setGapDuration(10);
+    content->plugInterface(AbstractCallContentInterfacePtr::dynamicCast(*dtmf));
+
+    DBusError err;
+    content->registerObject(&err);
+    if (err.isValid()) {
+        qWarning() << "Unable to register content" << name << err.name() << err.message();
+        return BaseCallContentPtr();
+    }
+    return content;
+}
+
+Client::CallContentInterfaceDTMFInterface *TestBaseCallDTMF::dtmfClient(
+        const BaseCallContentPtr &content)
+{
+    Client::CallContentInterfaceDTMFInterface *client =
+        new Client::CallContentInterfaceDTMFInterface(content->busName(),
+                content->objectPath(), this);
+    connect(client, SIGNAL(StoppedTones(bool)), SLOT(onStoppedTones(bool)));
+    return client;
+}
+
+void TestBaseCallDTMF::waitForStoppedTones(int count)
+{
+    while (mStoppedTones < count) {
+        QCOMPARE(mLoop->exec(), 0);
+    }
+}
+
+void TestBaseCallDTMF::initTestCase()
+{
+    initTestCaseImpl();
+
+    mConn = BaseConnection::create(QLatin1String("dtmfcm"), QLatin1String("dtmf"), QVariantMap());
+    DBusError err;
+    QVERIFY(mConn->registerObject(&err));
+    QVERIFY(!err.isValid());
+
+    mChannel = BaseChannel::create(mConn.data(), TP_QT_IFACE_CHANNEL_TYPE_CALL);
+    QVERIFY(mChannel->registerObject(&err));
+    QVERIFY(!err.isValid());
+}
+
+void TestBaseCallDTMF::init()
+{
+    initImpl();
+
+    mStoppedTones = 0;
+    mStoppedCancelled.clear();
+    mEventsAtDeletion = -1;
+
+    for (int i = 0; i < 2; ++i) {
+        mRecorders[i] = new ToneRecorder(this);
+        mContents[i] = createContent(QString(QLatin1String("audio%1")).arg(i),
+                mRecorders[i], &mDTMF[i]);
+        QVERIFY(!mContents[i].isNull());
+        mClients[i] = dtmfClient(mContents[i]);
+    }
+}
+
+void TestBaseCallDTMF::testMultipleContents()
+{
+    // Both contents share the process-wide tone timer and play their sequences concurrently
+    connect(new QDBusPendingCallWatcher(mClients[0]->MultipleTones(QLatin1String("12")), this),
+            SIGNAL(finished(QDBusPendingCallWatcher*)),
+            SLOT(expectSuccessfulCall(QDBusPendingCallWatcher*)));
+    QCOMPARE(mLoop->exec(), 0);
+    connect(new QDBusPendingCallWatcher(mClients[1]->MultipleTones(QLatin1String("345")), this),
+            SIGNAL(finished(QDBusPendingCallWatcher*)),
+            SLOT(expectSuccessfulCall(QDBusPendingCallWatcher*)));
+    QCOMPARE(mLoop->exec(), 0);
+
+    waitForStoppedTones(2);
+    QCOMPARE(mStoppedCancelled, QList<bool>() << false << false);
+
+    QCOMPARE(mRecorders[0]->events, QStringList()
+            << QLatin1String("start:1") << QLatin1String("stop")
+            << QLatin1String("start:2") << QLatin1String("stop"));
+    QCOMPARE(mRecorders[1]->events, QStringList()
+            << QLatin1String("start:3") << QLatin1String("stop")
+            << QLatin1String("start:4") << QLatin1String("stop")
+            << QLatin1String("start:5") << QLatin1String("stop"));
+}
+
+void TestBaseCallDTMF::testStopToneCancelsSequence()
+{
+    mDTMF[0]->setToneDuration(5000);
+
+    connect(new QDBusPendingCallWatcher(mClients[0]->MultipleTones(QLatin1String("123")), this),
+            SIGNAL(finished(QDBusPendingCallWatcher*)),
+            SLOT(expectSuccessfulCall(QDBusPendingCallWatcher*)));
+    // The first tone is started before the call returns
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mRecorders[0]->events, QStringList() << QLatin1String("start:1"));
+    QVERIFY(mDTMF[0]->currentlySendingTones());
+
+    // Stop in the middle of the first tone
+    connect(new QDBusPendingCallWatcher(mClients[0]->StopTone(), this),
+            SIGNAL(finished(QDBusPendingCallWatcher*)),
+            SLOT(expectSuccessfulCall(QDBusPendingCallWatcher*)));
+    waitForStoppedTones(1);
+    QCOMPARE(mStoppedCancelled, QList<bool>() << true);
+    QVERIFY(!mDTMF[0]->currentlySendingTones());
+
+    // Nothing else is played from the cancelled sequence
+    QTimer::singleShot(100, mLoop, SLOT(quit()));
+    mLoop->exec();
+    QCOMPARE(mRecorders[0]->events, QStringList()
+            << QLatin1String("start:1") << QLatin1String("stop"));
+
+    // The content accepts a new sequence once the old one has been cancelled
+    mDTMF[0]->setToneDuration(20);
+    connect(new QDBusPendingCallWatcher(mClients[0]->MultipleTones(QLatin1String("4")), this),
+            SIGNAL(finished(QDBusPendingCallWatcher*)),
+            SLOT(expectSuccessfulCall(QDBusPendingCallWatcher*)));
+    waitForStoppedTones(2);
+    QCOMPARE(mStoppedCancelled, QList<bool>() << true << false);
+    QCOMPARE(mRecorders[0]->events.mid(2), QStringList()
+            << QLatin1String("start:4") << QLatin1String("stop"));
+}
+
+void TestBaseCallDTMF::testDeleteContentWhileScheduled()
+{
+    // Give both contents the same deadlines, so they are likely to expire on the same timeout,
+    // and destroy the second one from the first one's StopTone callback
+    connect(mRecorders[0], SIGNAL(toneStopped()), SLOT(onToneStoppedDeleteSecond()));
+
+    QDBusPendingCall first = mClients[0]->MultipleTones(QLatin1String("12"));
+    QDBusPendingCall second = mClients[1]->MultipleTones(QLatin1String("3456"));
+    connect(new QDBusPendingCallWatcher(first, this),
+            SIGNAL(finished(QDBusPendingCallWatcher*)),
+            SLOT(expectSuccessfulCall(QDBusPendingCallWatcher*)));
+    QCOMPARE(mLoop->exec(), 0);
+    connect(new QDBusPendingCallWatcher(second, this),
+            SIGNAL(finished(QDBusPendingCallWatcher*)),
+            SLOT(expectSuccessfulCall(QDBusPendingCallWatcher*)));
+    QCOMPARE(mLoop->exec(), 0);
+
+    // The first content finishes its own sequence normally
+    waitForStoppedTones(1);
+    QCOMPARE(mStoppedCancelled, QList<bool>() << false);
+    QCOMPARE(mRecorders[0]->events, QStringList()
+            << QLatin1String("start:1") << QLatin1String("stop")
+            << QLatin1String("start:2") << QLatin1String("stop"));
+
+    // The deleted content's callbacks are never called again
+    QVERIFY(mContents[1].isNull());
+    QVERIFY(mEventsAtDeletion >= 0);
+    QTimer::singleShot(100, mLoop, SLOT(quit()));
+    mLoop->exec();
+    QCOMPARE(mRecorders[1]->events.size(), mEventsAtDeletion);
+    QVERIFY(mEventsAtDeletion < 8);
+}
+
+void TestBaseCallDTMF::cleanup()
+{
+    for (int i = 0; i < 2; ++i) {
+        delete mClients[i];
+        mClients[i] = 0;
+        mDTMF[i].reset();
+        mContents[i].reset();
+        delete mRecorders[i];
+        mRecorders[i] = 0;
+    }
+
+    cleanupImpl();
+}
+
+void TestBaseCallDTMF::cleanupTestCase()
+{
+    mChannel.reset();
+    mConn.reset();
+
+    cleanupTestCaseImpl();
+}
+
+QTEST_MAIN(TestBaseCallDTMF)
+#include "_gen/base-call-dtmf.cpp.moc.hpp"
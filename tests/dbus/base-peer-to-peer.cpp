@@ -0,0 +1,367 @@
+#include <tests/lib/test.h>
+
+#define TP_QT_ENABLE_LOWLEVEL_API
+
+#include <TelepathyQt/BaseChannel>
+#include <TelepathyQt/BaseConnection>
+#include <TelepathyQt/BaseConnectionManager>
+#include <TelepathyQt/BaseProtocol>
+
+#include <TelepathyQt/Channel>
+#include <TelepathyQt/ChannelFactory>
+#include <TelepathyQt/Connection>
+#include <TelepathyQt/ConnectionFactory>
+#include <TelepathyQt/ConnectionInterfaceRequestsInterface>
+#include <TelepathyQt/ConnectionLowlevel>
+#include <TelepathyQt/ConnectionManager>
+#include <TelepathyQt/ConnectionManagerLowlevel>
+#include <TelepathyQt/ContactFactory>
+#include <TelepathyQt/DBus>
+#include <TelepathyQt/DBusError>
+#include <TelepathyQt/PendingChannel>
+#include <TelepathyQt/PendingConnection>
+#include <TelepathyQt/PendingReady>
+
+static Tp::RequestableChannelClass roomListChannelClass()
+{
+    Tp::RequestableChannelClass roomList;
+    roomList.fixedProperties[TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType")] = TP_QT_IFACE_CHANNEL_TYPE_ROOM_LIST;
+    roomList.fixedProperties[TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandleType")] = uint(Tp::HandleTypeNone);
+    return roomList;
+}
+
+namespace TestPeerToPeerCM // The namespace is needed to avoid class name collisions with other tests
+{
+
+class Connection;
+typedef Tp::SharedPtr<Connection> ConnectionPtr;
+
+class Connection : public Tp::BaseConnection
+{
+    Q_OBJECT
+public:
+    Connection(const QDBusConnection &dbusConnection,
+            const QString &cmName, const QString &protocolName,
+            const QVariantMap &parameters)
+        : Tp::BaseConnection(dbusConnection, cmName, protocolName, parameters)
+    {
+        mContactsIface = Tp::BaseConnectionContactsInterface::create();
+        mContactsIface->setGetContactAttributesCallback(Tp::memFun(this, &Connection::getContactAttributes));
+        mContactsIface->setContactAttributeInterfaces(QStringList() << TP_QT_IFACE_CONNECTION);
+        plugInterface(Tp::AbstractConnectionInterfacePtr::dynamicCast(mContactsIface));
+
+        mRequestsIface = Tp::BaseConnectionRequestsInterface::create(this);
+        mRequestsIface->requestableChannelClasses << roomListChannelClass();
+        plugInterface(Tp::AbstractConnectionInterfacePtr::dynamicCast(mRequestsIface));
+
+        setConnectCallback(Tp::memFun(this, &Connection::connectCB));
+        setCreateChannelCallback(Tp::memFun(this, &Connection::createChannelCB));
+        setInspectHandlesCallback(Tp::memFun(this, &Connection::inspectHandles));
+
+        setSelfContact(1, QLatin1String("self@example.com"));
+    }
+
+    Tp::BaseChannelPtr lastChannel;
+
+private:
+    void connectCB(Tp::DBusError *error)
+    {
+        Q_UNUSED(error)
+        setStatus(Tp::ConnectionStatusConnected, Tp::ConnectionStatusReasonRequested);
+    }
+
+    Tp::BaseChannelPtr createChannelCB(const QVariantMap &request, Tp::DBusError *error)
+    {
+        const QString channelType = request.value(TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType")).toString();
+        if (channelType != TP_QT_IFACE_CHANNEL_TYPE_ROOM_LIST) {
+            error->set(TP_QT_ERROR_NOT_IMPLEMENTED, QLatin1String("Only room lists are supported"));
+            return Tp::BaseChannelPtr();
+        }
+
+        lastChannel = Tp::BaseChannel::create(this, channelType);
+        lastChannel->plugInterface(Tp::AbstractChannelInterfacePtr::dynamicCast(
+                    Tp::BaseChannelRoomListType::create(QLatin1String("conference.example.com"))));
+        return lastChannel;
+    }
+
+    QStringList inspectHandles(uint handleType, const Tp::UIntList &handles, Tp::DBusError *error)
+    {
+        if (handleType != Tp::HandleTypeContact || handles != (Tp::UIntList() << selfHandle())) {
+            error->set(TP_QT_ERROR_INVALID_HANDLE, QLatin1String("Unknown handle"));
+            return QStringList();
+        }
+        return QStringList() << selfID();
+    }
+
+    Tp::ContactAttributesMap getContactAttributes(const Tp::UIntList &handles,
+            const QStringList &interfaces, Tp::DBusError *error)
+    {
+        Q_UNUSED(interfaces)
+        Q_UNUSED(error)
+
+        Tp::ContactAttributesMap attributes;
+        if (handles.contains(selfHandle())) {
+            attributes[selfHandle()][TP_QT_IFACE_CONNECTION + QLatin1String("/contact-id")] = selfID();
+        }
+        return attributes;
+    }
+
+    Tp::BaseConnectionContactsInterfacePtr mContactsIface;
+    Tp::BaseConnectionRequestsInterfacePtr mRequestsIface;
+};
+
+} // namespace TestPeerToPeerCM
+
+using namespace TestPeerToPeerCM;
+
+class TestBasePeerToPeer : public Test
+{
+    Q_OBJECT
+
+public:
+    TestBasePeerToPeer(QObject *parent = 0)
+        : Test(parent), mPeerToPeer(false)
+    { }
+
+protected Q_SLOTS:
+    void onChannelInvalidated(Tp::DBusProxy *proxy,
+            const QString &errorName, const QString &errorMessage);
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+
+    void testPeerToPeer();
+    void testOtherFactory();
+    void testNoPeerOffered();
+
+    void cleanup();
+    void cleanupTestCase();
+
+private:
+    Tp::BaseConnectionPtr createConnectionCB(const QVariantMap &parameters, Tp::DBusError *error);
+    Tp::ConnectionPtr requestConnection(bool peerToPeerOffered);
+    Tp::ChannelPtr createChannel(const Tp::ConnectionPtr &conn);
+    bool usesPeer(const QDBusAbstractInterface *iface) const;
+
+    Tp::BaseProtocolPtr mProtocol;
+    Tp::BaseConnectionManagerPtr mConnectionManager;
+    Tp::ConnectionManagerPtr mCliCM;
+    ConnectionPtr mSvcConnection;
+    bool mPeerToPeer;
+
+    Tp::ConnectionPtr mConn;
+    Tp::ChannelPtr mChan;
+    bool mChannelInvalidated;
+};
+
+Tp::BaseConnectionPtr TestBasePeerToPeer::createConnectionCB(const QVariantMap &parameters,
+        Tp::DBusError *error)
+{
+    Q_UNUSED(error)
+    mSvcConnection = Tp::BaseConnection::create<Connection>(mConnectionManager->name(),
+            mProtocol->name(), parameters);
+    mSvcConnection->setPeerToPeerEnabled(mPeerToPeer);
+    return Tp::BaseConnectionPtr::staticCast(mSvcConnection);
+}
+
+void TestBasePeerToPeer::onChannelInvalidated(Tp::DBusProxy *proxy,
+        const QString &errorName, const QString &errorMessage)
+{
+    Q_UNUSED(proxy)
+    Q_UNUSED(errorName)
+    Q_UNUSED(errorMessage)
+    mChannelInvalidated = true;
+    mLoop->exit(0);
+}
+
+Tp::ConnectionPtr TestBasePeerToPeer::requestConnection(bool peerToPeerOffered)
+{
+    mPeerToPeer = peerToPeerOffered;
+
+    Tp::PendingConnection *pc = mCliCM->lowlevel()->requestConnection(mProtocol->name(), QVariantMap());
+    connect(pc,
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    if (mLoop->exec() != 0) {
+        return Tp::ConnectionPtr();
+    }
+
+    Tp::ConnectionPtr conn = pc->connection();
+    connect(conn->lowlevel()->requestConnect(),
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    if (mLoop->exec() != 0 || conn->status() != Tp::ConnectionStatusConnected) {
+        return Tp::ConnectionPtr();
+    }
+    return conn;
+}
+
+Tp::ChannelPtr TestBasePeerToPeer::createChannel(const Tp::ConnectionPtr &conn)
+{
+    QVariantMap request;
+    request[TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType")] = TP_QT_IFACE_CHANNEL_TYPE_ROOM_LIST;
+    request[TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandleType")] = uint(Tp::HandleTypeNone);
+    Tp::PendingChannel *pc = conn->lowlevel()->createChannel(request);
+    connect(pc,
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    if (mLoop->exec() != 0) {
+        return Tp::ChannelPtr();
+    }
+    return pc->channel();
+}
+
+bool TestBasePeerToPeer::usesPeer(const QDBusAbstractInterface *iface) const
+{
+    // Peer connections have no bus name, and are never the bus the proxies were created for
+    return iface->connection().name() != QDBusConnection::sessionBus().name() &&
+        iface->connection().isConnected() && iface->service().isEmpty();
+}
+
+void TestBasePeerToPeer::initTestCase()
+{
+    initTestCaseImpl();
+
+    mProtocol = Tp::BaseProtocol::create(QLatin1String("p2p"));
+    mProtocol->setRequestableChannelClasses(Tp::RequestableChannelClassSpecList()
+            << roomListChannelClass());
+    mProtocol->setCreateConnectionCallback(Tp::memFun(this, &TestBasePeerToPeer::createConnectionCB));
+
+    mConnectionManager = Tp::BaseConnectionManager::create(QLatin1String("p2pcm"));
+    mConnectionManager->addProtocol(mProtocol);
+
+    Tp::DBusError err;
+    QVERIFY(mConnectionManager->registerObject(&err));
+    QVERIFY(!err.isValid());
+
+    // Only the proxies built by this connection factory opt in
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    Tp::ConnectionFactoryPtr connFactory = Tp::ConnectionFactory::create(bus,
+            Tp::Connection::FeatureCore);
+    QVERIFY(!connFactory->isPeerToPeerEnabled());
+    connFactory->setPeerToPeerEnabled(true);
+    QVERIFY(connFactory->isPeerToPeerEnabled());
+
+    mCliCM = Tp::ConnectionManager::create(bus, mConnectionManager->name(), connFactory,
+            Tp::ChannelFactory::create(bus), Tp::ContactFactory::create());
+    connect(mCliCM->becomeReady(),
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+}
+
+void TestBasePeerToPeer::init()
+{
+    initImpl();
+
+    mChannelInvalidated = false;
+}
+
+void TestBasePeerToPeer::testPeerToPeer()
+{
+    mConn = requestConnection(true);
+    QVERIFY(mConn);
+    QVERIFY(mSvcConnection->isPeerToPeerEnabled());
+    QVERIFY(!mSvcConnection->peerToPeerAddress().isEmpty());
+    QVERIFY(mConn->interfaces().contains(
+                QLatin1String("org.freedesktop.Telepathy.Connection.Interface.PeerToPeer.DRAFT")));
+
+    // The interfaces built once the connection is ready talk to the service directly, so the
+    // channel request below is a method call over the peer
+    Tp::Client::ConnectionInterfaceRequestsInterface *requests =
+        mConn->interface<Tp::Client::ConnectionInterfaceRequestsInterface>();
+    QVERIFY(requests);
+    QVERIFY(usesPeer(requests));
+
+    mChan = createChannel(mConn);
+    QVERIFY(mChan);
+    QVERIFY(mSvcConnection->lastChannel);
+
+    // Channels of the connection use its peer too, including to receive signals: Closed is
+    // only listened to on the peer
+    Tp::Client::DBus::PropertiesInterface *chanProperties =
+        mChan->interface<Tp::Client::DBus::PropertiesInterface>();
+    QVERIFY(usesPeer(chanProperties));
+
+    QVERIFY(connect(mChan.data(),
+                SIGNAL(invalidated(Tp::DBusProxy*,QString,QString)),
+                SLOT(onChannelInvalidated(Tp::DBusProxy*,QString,QString))));
+    mSvcConnection->lastChannel->close();
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(mChannelInvalidated);
+    QCOMPARE(mChan->invalidationReason(), TP_QT_ERROR_CANCELLED);
+}
+
+void TestBasePeerToPeer::testOtherFactory()
+{
+    mConn = requestConnection(true);
+    QVERIFY(mConn);
+    QVERIFY(usesPeer(mConn->interface<Tp::Client::ConnectionInterfaceRequestsInterface>()));
+
+    // A proxy for the same connection which didn't opt in keeps using the bus, even though a
+    // peer connection to the service exists in the process
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    Tp::ConnectionPtr other = Tp::Connection::create(bus, mConn->busName(), mConn->objectPath(),
+            Tp::ChannelFactory::create(bus), Tp::ContactFactory::create());
+    connect(other->becomeReady(),
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+
+    Tp::Client::ConnectionInterfaceRequestsInterface *requests =
+        other->interface<Tp::Client::ConnectionInterfaceRequestsInterface>();
+    QVERIFY(!usesPeer(requests));
+    QCOMPARE(requests->connection().name(), bus.name());
+    QCOMPARE(requests->service(), mConn->busName());
+
+    mChan = createChannel(other);
+    QVERIFY(mChan);
+    QVERIFY(!usesPeer(mChan->interface<Tp::Client::DBus::PropertiesInterface>()));
+    QCOMPARE(mChan->interface<Tp::Client::DBus::PropertiesInterface>()->connection().name(),
+            bus.name());
+}
+
+void TestBasePeerToPeer::testNoPeerOffered()
+{
+    // Opted in, but the service doesn't listen for peers: everything goes through the bus
+    mConn = requestConnection(false);
+    QVERIFY(mConn);
+    QVERIFY(!mSvcConnection->isPeerToPeerEnabled());
+    QVERIFY(mSvcConnection->peerToPeerAddress().isEmpty());
+
+    Tp::Client::ConnectionInterfaceRequestsInterface *requests =
+        mConn->interface<Tp::Client::ConnectionInterfaceRequestsInterface>();
+    QVERIFY(!usesPeer(requests));
+    QCOMPARE(requests->connection().name(), QDBusConnection::sessionBus().name());
+
+    mChan = createChannel(mConn);
+    QVERIFY(mChan);
+    QVERIFY(!usesPeer(mChan->interface<Tp::Client::DBus::PropertiesInterface>()));
+
+    QVERIFY(connect(mChan.data(),
+                SIGNAL(invalidated(Tp::DBusProxy*,QString,QString)),
+                SLOT(onChannelInvalidated(Tp::DBusProxy*,QString,QString))));
+    mSvcConnection->lastChannel->close();
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(mChannelInvalidated);
+}
+
+void TestBasePeerToPeer::cleanup()
+{
+    mChan.reset();
+    mConn.reset();
+    mSvcConnection.reset();
+
+    cleanupImpl();
+}
+
+void TestBasePeerToPeer::cleanupTestCase()
+{
+    mCliCM.reset();
+
+    cleanupTestCaseImpl();
+}
+
+QTEST_MAIN(TestBasePeerToPeer)
+#include "_gen/base-peer-to-peer.cpp.moc.hpp"
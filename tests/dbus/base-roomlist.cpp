@@ -0,0 +1,399 @@
+#include <tests/lib/test.h>
+
+#define TP_QT_ENABLE_LOWLEVEL_API
+
+#include <TelepathyQt/BaseChannel>
+#include <TelepathyQt/BaseConnection>
+#include <TelepathyQt/BaseConnectionManager>
+#include <TelepathyQt/BaseProtocol>
+
+#include <TelepathyQt/Connection>
+#include <TelepathyQt/ConnectionLowlevel>
+#include <TelepathyQt/ConnectionManager>
+#include <TelepathyQt/ConnectionManagerLowlevel>
+#include <TelepathyQt/DBusError>
+#include <TelepathyQt/PendingChannel>
+#include <TelepathyQt/PendingConnection>
+#include <TelepathyQt/PendingReady>
+#include <TelepathyQt/RoomListChannel>
+
+static Tp::RequestableChannelClass roomListChannelClass()
+{
+    Tp::RequestableChannelClass roomList;
+    roomList.fixedProperties[TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType")] = TP_QT_IFACE_CHANNEL_TYPE_ROOM_LIST;
+    roomList.fixedProperties[TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandleType")] = uint(Tp::HandleTypeNone);
+    roomList.allowedProperties.append(TP_QT_IFACE_CHANNEL_TYPE_ROOM_LIST + QLatin1String(".Server"));
+    return roomList;
+}
+
+static Tp::RoomInfo roomInfo(const QString &handleName, const QString &name = QString())
+{
+    Tp::RoomInfo room;
+    room.handle = 0;
+    room.channelType = TP_QT_IFACE_CHANNEL_TYPE_TEXT;
+    room.info[QLatin1String("handle-name")] = handleName;
+    if (!name.isEmpty()) {
+        room.info[QLatin1String("name")] = name;
+    }
+    return room;
+}
+
+namespace TestRoomListCM // The namespace is needed to avoid class name collisions with other tests
+{
+
+class Connection;
+typedef Tp::SharedPtr<Connection> ConnectionPtr;
+
+class Connection : public Tp::BaseConnection
+{
+    Q_OBJECT
+public:
+    Connection(const QDBusConnection &dbusConnection,
+            const QString &cmName, const QString &protocolName,
+            const QVariantMap &parameters)
+        : Tp::BaseConnection(dbusConnection, cmName, protocolName, parameters)
+    {
+        mContactsIface = Tp::BaseConnectionContactsInterface::create();
+        mContactsIface->setGetContactAttributesCallback(Tp::memFun(this, &Connection::getContactAttributes));
+        mContactsIface->setContactAttributeInterfaces(QStringList() << TP_QT_IFACE_CONNECTION);
+        plugInterface(Tp::AbstractConnectionInterfacePtr::dynamicCast(mContactsIface));
+
+        mRequestsIface = Tp::BaseConnectionRequestsInterface::create(this);
+        mRequestsIface->requestableChannelClasses << roomListChannelClass();
+        plugInterface(Tp::AbstractConnectionInterfacePtr::dynamicCast(mRequestsIface));
+
+        setConnectCallback(Tp::memFun(this, &Connection::connectCB));
+        setCreateChannelCallback(Tp::memFun(this, &Connection::createChannelCB));
+        setInspectHandlesCallback(Tp::memFun(this, &Connection::inspectHandles));
+
+        setSelfContact(1, QLatin1String("self@example.com"));
+    }
+
+    // The rooms signalled by ListRooms, as two gotRooms() calls
+    QList<Tp::RoomInfoList> batches;
+
+    Tp::BaseChannelRoomListTypePtr roomList;
+
+private:
+    void connectCB(Tp::DBusError *error)
+    {
+        Q_UNUSED(error)
+        setStatus(Tp::ConnectionStatusConnected, Tp::ConnectionStatusReasonRequested);
+    }
+
+    Tp::BaseChannelPtr createChannelCB(const QVariantMap &request, Tp::DBusError *error)
+    {
+        const QString channelType = request.value(TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType")).toString();
+        if (channelType != TP_QT_IFACE_CHANNEL_TYPE_ROOM_LIST) {
+            error->set(TP_QT_ERROR_NOT_IMPLEMENTED, QLatin1String("Only room lists are supported"));
+            return Tp::BaseChannelPtr();
+        }
+
+        Tp::BaseChannelPtr channel = Tp::BaseChannel::create(this, channelType);
+        roomList = Tp::BaseChannelRoomListType::create(QLatin1String("conference.example.com"));
+        roomList->setListRoomsCallback(Tp::memFun(this, &Connection::listRooms));
+        roomList->setStopListingCallback(Tp::memFun(this, &Connection::stopListing));
+        channel->plugInterface(Tp::AbstractChannelInterfacePtr::dynamicCast(roomList));
+        return channel;
+    }
+
+    void listRooms(Tp::DBusError *error)
+    {
+        Q_UNUSED(error)
+        roomList->setListingRooms(true);
+        foreach (const Tp::RoomInfoList &batch, batches) {
+            roomList->gotRooms(batch);
+        }
+        roomList->setListingRooms(false);
+    }
+
+    void stopListing(Tp::DBusError *error)
+    {
+        Q_UNUSED(error)
+        roomList->setListingRooms(false);
+    }
+
+    QStringList inspectHandles(uint handleType, const Tp::UIntList &handles, Tp::DBusError *error)
+    {
+        if (handleType != Tp::HandleTypeContact || handles != (Tp::UIntList() << selfHandle())) {
+            error->set(TP_QT_ERROR_INVALID_HANDLE, QLatin1String("Unknown handle"));
+            return QStringList();
+        }
+        return QStringList() << selfID();
+    }
+
+    Tp::ContactAttributesMap getContactAttributes(const Tp::UIntList &handles,
+            const QStringList &interfaces, Tp::DBusError *error)
+    {
+        Q_UNUSED(interfaces)
+        Q_UNUSED(error)
+
+        Tp::ContactAttributesMap attributes;
+        if (handles.contains(selfHandle())) {
+            attributes[selfHandle()][TP_QT_IFACE_CONNECTION + QLatin1String("/contact-id")] = selfID();
+        }
+        return attributes;
+    }
+
+    Tp::BaseConnectionContactsInterfacePtr mContactsIface;
+    Tp::BaseConnectionRequestsInterfacePtr mRequestsIface;
+};
+
+} // namespace TestRoomListCM
+
+using namespace TestRoomListCM;
+
+class TestBaseRoomList : public Test
+{
+    Q_OBJECT
+
+public:
+    TestBaseRoomList(QObject *parent = 0)
+        : Test(parent)
+    { }
+
+protected Q_SLOTS:
+    void onRoomsReceived(const Tp::RoomInfoList &rooms);
+    void onListingRoomsChanged(bool listing);
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+
+    void testListRooms();
+    void testListingWhileChunksPending();
+
+    void cleanup();
+    void cleanupTestCase();
+
+private:
+    Tp::BaseConnectionPtr createConnectionCB(const QVariantMap &parameters, Tp::DBusError *error);
+    void createChannel();
+
+    Tp::BaseProtocolPtr mProtocol;
+    Tp::BaseConnectionManagerPtr mConnectionManager;
+    ConnectionPtr mSvcConnection;
+
+    Tp::ConnectionPtr mConn;
+    Tp::RoomListChannelPtr mChan;
+
+    QList<int> mReceivedSizes;
+    QList<int> mPrefixMatches;
+    QList<bool> mListingChanges;
+    int mSignalsWhenListingStopped;
+};
+
+Tp::BaseConnectionPtr TestBaseRoomList::createConnectionCB(const QVariantMap &parameters,
+        Tp::DBusError *error)
+{
+    Q_UNUSED(error)
+    mSvcConnection = Tp::BaseConnection::create<Connection>(mConnectionManager->name(),
+            mProtocol->name(), parameters);
+    return Tp::BaseConnectionPtr::staticCast(mSvcConnection);
+}
+
+void TestBaseRoomList::onRoomsReceived(const Tp::RoomInfoList &rooms)
+{
+    mReceivedSizes << rooms.size();
+    // The directory must be searchable while the listing is still in progress
+    mPrefixMatches << mChan->roomsWithPrefix(QLatin1String("alpha")).size();
+}
+
+void TestBaseRoomList::onListingRoomsChanged(bool listing)
+{
+    mListingChanges << listing;
+    if (!listing) {
+        mSignalsWhenListingStopped = mReceivedSizes.size();
+        mLoop->exit(0);
+    }
+}
+
+void TestBaseRoomList::initTestCase()
+{
+    initTestCaseImpl();
+
+    mProtocol = Tp::BaseProtocol::create(QLatin1String("roomlist"));
+    mProtocol->setRequestableChannelClasses(Tp::RequestableChannelClassSpecList()
+            << roomListChannelClass());
+    mProtocol->setCreateConnectionCallback(Tp::memFun(this, &TestBaseRoomList::createConnectionCB));
+
+    mConnectionManager = Tp::BaseConnectionManager::create(QLatin1String("roomlistcm"));
+    mConnectionManager->addProtocol(mProtocol);
+
+    Tp::DBusError err;
+    QVERIFY(mConnectionManager->registerObject(&err));
+    QVERIFY(!err.isValid());
+
+    Tp::ConnectionManagerPtr cliCM = Tp::ConnectionManager::create(mConnectionManager->name());
+    connect(cliCM->becomeReady(),
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+
+    Tp::PendingConnection *pc = cliCM->lowlevel()->requestConnection(mProtocol->name(), QVariantMap());
+    connect(pc,
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+
+    mConn = pc->connection();
+    connect(mConn->lowlevel()->requestConnect(),
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mConn->status(), Tp::ConnectionStatusConnected);
+    QVERIFY(mSvcConnection);
+}
+
+void TestBaseRoomList::init()
+{
+    initImpl();
+
+    mReceivedSizes.clear();
+    mPrefixMatches.clear();
+    mListingChanges.clear();
+    mSignalsWhenListingStopped = -1;
+}
+
+void TestBaseRoomList::createChannel()
+{
+    QVariantMap request;
+    request[TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType")] = TP_QT_IFACE_CHANNEL_TYPE_ROOM_LIST;
+    request[TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandleType")] = uint(Tp::HandleTypeNone);
+    Tp::PendingChannel *pc = mConn->lowlevel()->createChannel(request);
+    connect(pc,
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+
+    mChan = Tp::RoomListChannelPtr::qObjectCast(pc->channel());
+    QVERIFY(mChan);
+    mSvcConnection->roomList->setMaxRoomsPerSignal(3);
+
+    // The room directory is only introspected on request
+    QVERIFY(!mChan->isReady(Tp::RoomListChannel::FeatureCore));
+    connect(mChan->becomeReady(Tp::RoomListChannel::FeatureCore),
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mChan->server(), QLatin1String("conference.example.com"));
+    QVERIFY(!mChan->isListingRooms());
+    QCOMPARE(mChan->roomCount(), 0);
+
+    connect(mChan.data(),
+            SIGNAL(roomsReceived(Tp::RoomInfoList)),
+            SLOT(onRoomsReceived(Tp::RoomInfoList)));
+    connect(mChan.data(),
+            SIGNAL(listingRoomsChanged(bool)),
+            SLOT(onListingRoomsChanged(bool)));
+}
+
+void TestBaseRoomList::testListRooms()
+{
+    // Rooms matching "alpha" are spread over every GotRooms chunk, either by handle name
+    // or, for zeta, by name only.
+    mSvcConnection->batches.clear();
+    mSvcConnection->batches << (Tp::RoomInfoList()
+            << roomInfo(QLatin1String("alpha-1@example.com"))
+            << roomInfo(QLatin1String("beta@example.com"))
+            << roomInfo(QLatin1String("gamma@example.com"))
+            << roomInfo(QLatin1String("delta@example.com"))
+            << roomInfo(QLatin1String("Alpha-2@example.com"))
+            << roomInfo(QLatin1String("epsilon@example.com"))
+            << roomInfo(QLatin1String("alpha-3@example.com")));
+    // The second batch repeats alpha-1 unchanged, which must not be stored twice
+    mSvcConnection->batches << (Tp::RoomInfoList()
+            << roomInfo(QLatin1String("alpha-1@example.com"))
+            << roomInfo(QLatin1String("zeta@example.com"), QLatin1String("Alpha lounge"))
+            << roomInfo(QLatin1String("eta@example.com"))
+            << roomInfo(QLatin1String("alpha-4@example.com")));
+
+    createChannel();
+    QVERIFY(mChan);
+
+    connect(mChan->listRooms(),
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+    if (mSignalsWhenListingStopped < 0) {
+        QCOMPARE(mLoop->exec(), 0);
+    }
+
+    // 7 rooms in chunks of 3, 3 and 1, then 4 rooms in chunks of 3 (of which one is a
+    // duplicate) and 1. ListingRooms(False) comes after the last chunk.
+    QCOMPARE(mReceivedSizes, QList<int>() << 3 << 3 << 1 << 2 << 1);
+    QCOMPARE(mPrefixMatches, QList<int>() << 1 << 2 << 3 << 4 << 5);
+    QCOMPARE(mSignalsWhenListingStopped, 5);
+    QVERIFY(!mChan->isListingRooms());
+
+    QCOMPARE(mChan->roomCount(), 10);
+    QVERIFY(mChan->hasRoom(QLatin1String("zeta@example.com")));
+    QCOMPARE(mChan->room(QLatin1String("zeta@example.com")).info.value(QLatin1String("name")).toString(),
+            QLatin1String("Alpha lounge"));
+    QVERIFY(!mChan->hasRoom(QLatin1String("omega@example.com")));
+
+    // Matches are ordered by the case-folded key: "alpha lounge" sorts before "alpha-1..."
+    QStringList matches;
+    foreach (const Tp::RoomInfo &room, mChan->roomsWithPrefix(QLatin1String("ALPHA"))) {
+        matches << room.info.value(QLatin1String("handle-name")).toString();
+    }
+    QCOMPARE(matches, QStringList()
+            << QLatin1String("zeta@example.com")
+            << QLatin1String("alpha-1@example.com")
+            << QLatin1String("Alpha-2@example.com")
+            << QLatin1String("alpha-3@example.com")
+            << QLatin1String("alpha-4@example.com"));
+
+    Tp::RoomInfoList page = mChan->roomsWithPrefix(QLatin1String("alpha-"), 1, 2);
+    QCOMPARE(page.size(), 2);
+    QCOMPARE(page.at(0).info.value(QLatin1String("handle-name")).toString(),
+            QLatin1String("Alpha-2@example.com"));
+    QCOMPARE(page.at(1).info.value(QLatin1String("handle-name")).toString(),
+            QLatin1String("alpha-3@example.com"));
+
+    QVERIFY(mChan->roomsWithPrefix(QLatin1String("omega")).isEmpty());
+    QCOMPARE(mChan->rooms(8).size(), 2);
+    QCOMPARE(mChan->rooms(0, 4).size(), 4);
+}
+
+void TestBaseRoomList::testListingWhileChunksPending()
+{
+    createChannel();
+    QVERIFY(mChan);
+
+    Tp::RoomInfoList rooms;
+    for (int i = 0; i < 7; ++i) {
+        rooms << roomInfo(QString(QLatin1String("room-%1@example.com")).arg(i));
+    }
+
+    // The listing starts while the chunks of rooms signalled before are still queued.
+    // ListingRooms(True) goes out right away, ListingRooms(False) after the last chunk.
+    mSvcConnection->roomList->gotRooms(rooms);
+    mSvcConnection->roomList->setListingRooms(true);
+    mSvcConnection->roomList->setListingRooms(false);
+    QCOMPARE(mLoop->exec(), 0);
+
+    QCOMPARE(mListingChanges, QList<bool>() << true << false);
+    QCOMPARE(mReceivedSizes, QList<int>() << 3 << 3 << 1);
+    QCOMPARE(mSignalsWhenListingStopped, 3);
+    QVERIFY(!mChan->isListingRooms());
+    QCOMPARE(mChan->roomCount(), 7);
+}
+
+void TestBaseRoomList::cleanup()
+{
+    mChan.reset();
+
+    cleanupImpl();
+}
+
+void TestBaseRoomList::cleanupTestCase()
+{
+    mConn.reset();
+    mSvcConnection.reset();
+
+    cleanupTestCaseImpl();
+}
+
+QTEST_MAIN(TestBaseRoomList)
+#include "_gen/base-roomlist.cpp.moc.hpp"
@@ -61,6 +61,7 @@ private Q_SLOTS:
     void testCallMembers();
     void testDTMF();
     void testFeatureCore();
+    void testLazyContents();
 
     void cleanup();
     void cleanupTestCase();
@@ -947,6 +948,88 @@ void TestCallChannel::testFeatureCore()
     QVERIFY(chan2->handlerStreamingRequired());
 }
 
+void TestCallChannel::testLazyContents()
+{
+    QList<ContactPtr> contacts = mConn->contacts(QStringList() << QLatin1String("alice"));
+    QCOMPARE(contacts.size(), 1);
+
+    ContactPtr otherContact = contacts.at(0);
+    QVERIFY(otherContact);
+
+    QVariantMap request;
+    request.insert(TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType"),
+                   TP_QT_IFACE_CHANNEL_TYPE_CALL);
+    request.insert(TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandleType"),
+                   (uint) Tp::HandleTypeContact);
+    request.insert(TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandle"),
+                   otherContact->handle()[0]);
+    request.insert(TP_QT_IFACE_CHANNEL_TYPE_CALL + QLatin1String(".InitialAudio"),
+                   true);
+    mChan = CallChannelPtr::qObjectCast(mConn->createChannel(request));
+    QVERIFY(mChan);
+
+    qDebug() << "making the channel ready with lazy contents";
+
+    QVERIFY(connect(mChan->becomeReady(CallChannel::FeatureLazyContents),
+                    SIGNAL(finished(Tp::PendingOperation*)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(mChan->isReady(Tp::CallChannel::FeatureLazyContents));
+    QVERIFY(!mChan->isReady(Tp::CallChannel::FeatureContents));
+
+    // The contents have their own properties, but their streams are not introspected
+    QCOMPARE(mChan->contents().size(), 1);
+    CallContentPtr content = mChan->contents().first();
+    QVERIFY(content->isReady(CallContent::FeatureCore));
+    QCOMPARE(content->name(), QString::fromLatin1("audio"));
+    QCOMPARE(content->type(), Tp::MediaStreamTypeAudio);
+    QCOMPARE(content->streams().size(), 1);
+    CallStreamPtr stream = content->streams().first();
+    QVERIFY(!stream->isReady());
+
+    // Let any introspection that would have been started by mistake finish
+    mLoop->processEvents();
+    QVERIFY(!stream->isReady());
+
+    qDebug() << "making a single stream ready on demand";
+
+    QVERIFY(connect(stream->becomeReady(),
+                    SIGNAL(finished(Tp::PendingOperation*)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(stream->isReady());
+    QVERIFY(!mChan->isReady(Tp::CallChannel::FeatureContents));
+
+    qDebug() << "requesting a second content";
+
+    mRequestContentReturn.reset();
+    QVERIFY(connect(mChan->requestContent(QLatin1String("content1"), Tp::MediaStreamTypeVideo,
+                                          Tp::MediaStreamDirectionBidirectional),
+                    SIGNAL(finished(Tp::PendingOperation*)),
+                    SLOT(expectRequestContentFinished(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(!mRequestContentReturn.isNull());
+    QCOMPARE(mRequestContentReturn->streams().size(), 1);
+    CallStreamPtr videoStream = mRequestContentReturn->streams().first();
+    QVERIFY(!videoStream->isReady());
+
+    qDebug() << "upgrading to FeatureContents";
+
+    // Requesting FeatureContents later readies the streams of every content
+    QVERIFY(connect(mChan->becomeReady(CallChannel::FeatureContents),
+                    SIGNAL(finished(Tp::PendingOperation*)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(mChan->isReady(Tp::CallChannel::FeatureContents));
+    QCOMPARE(mChan->contents().size(), 2);
+    foreach (const CallContentPtr &c, mChan->contents()) {
+        foreach (const CallStreamPtr &s, c->streams()) {
+            QVERIFY(s->isReady());
+        }
+    }
+    QVERIFY(videoStream->isReady());
+}
+
 void TestCallChannel::cleanup()
 {
     mChan.reset();
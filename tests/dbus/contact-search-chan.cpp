@@ -7,6 +7,7 @@
 
 #include <TelepathyQt/Connection>
 #include <TelepathyQt/ContactSearchChannel>
+#include <TelepathyQt/PendingContacts>
 #include <TelepathyQt/PendingReady>
 
 #include <telepathy-glib/debug.h>
@@ -21,13 +22,14 @@ public:
     TestContactSearchChan(QObject *parent = 0)
         : Test(parent),
           mConn(0),
-          mChan1Service(0), mChan2Service(0), mSearchReturned(false)
+          mChan1Service(0), mChan2Service(0), mChan3Service(0), mSearchReturned(false)
     { }
 
 protected Q_SLOTS:
     void onSearchStateChanged(Tp::ChannelContactSearchState state, const QString &errorName,
         const Tp::ContactSearchChannel::SearchStateChangeDetails &details);
     void onSearchResultReceived(const Tp::ContactSearchChannel::SearchResult &result);
+    void onSearchResultsAvailable(int count);
     void onSearchReturned(Tp::PendingOperation *op);
 
 private Q_SLOTS:
@@ -36,6 +38,7 @@ private Q_SLOTS:
 
     void testContactSearch();
     void testContactSearchEmptyResult();
+    void testContactSearchFetchResults();
 
     void cleanup();
     void cleanupTestCase();
@@ -47,13 +50,17 @@ private:
     ContactSearchChannelPtr mChan;
     ContactSearchChannelPtr mChan1;
     ContactSearchChannelPtr mChan2;
+    ContactSearchChannelPtr mChan3;
 
     QString mChan1Path;
     TpTestsContactSearchChannel *mChan1Service;
     QString mChan2Path;
     TpTestsContactSearchChannel *mChan2Service;
+    QString mChan3Path;
+    TpTestsContactSearchChannel *mChan3Service;
 
     ContactSearchChannel::SearchResult mSearchResult;
+    int mSearchResultsAvailable;
     bool mSearchReturned;
 
     struct SearchStateChangeInfo
@@ -87,6 +94,11 @@ void TestContactSearchChan::onSearchResultReceived(
     mLoop->exit(0);
 }
 
+void TestContactSearchChan::onSearchResultsAvailable(int count)
+{
+    mSearchResultsAvailable += count;
+}
+
 void TestContactSearchChan::onSearchReturned(Tp::PendingOperation *op)
 {
     TEST_VERIFY_OP(op);
@@ -129,12 +141,22 @@ void TestContactSearchChan::initTestCase()
                 "connection", mConn->service(),
                 "object-path", chan2Path.data(),
                 NULL));
+
+    QByteArray chan3Path;
+    mChan3Path = mConn->objectPath() + QLatin1String("/ContactSearchChannel/3");
+    chan3Path = mChan3Path.toLatin1();
+    mChan3Service = TP_TESTS_CONTACT_SEARCH_CHANNEL(g_object_new(
+                TP_TESTS_TYPE_CONTACT_SEARCH_CHANNEL,
+                "connection", mConn->service(),
+                "object-path", chan3Path.data(),
+                NULL));
 }
 
 void TestContactSearchChan::init()
 {
     initImpl();
     mSearchResult.clear();
+    mSearchResultsAvailable = 0;
     mSearchStateChangeInfoList.clear();
     mSearchReturned = false;
 }
@@ -283,6 +305,118 @@ void TestContactSearchChan::testContactSearchEmptyResult()
     mChan2.reset();
 }
 
+void TestContactSearchChan::testContactSearchFetchResults()
+{
+    mChan3 = ContactSearchChannel::create(mConn->client(), mChan3Path, QVariantMap());
+    mChan = mChan3;
+
+    // Results can only be fetched once the channel is ready
+    QVERIFY(connect(mChan3->fetchResults(1),
+                    SIGNAL(finished(Tp::PendingOperation*)),
+                    SLOT(expectFailure(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mLastError, TP_QT_ERROR_NOT_AVAILABLE);
+    QCOMPARE(mChan3->resultCursor(), 0);
+
+    QVERIFY(connect(mChan3->becomeReady(),
+                    SIGNAL(finished(Tp::PendingOperation*)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mChan3->isReady(ContactSearchChannel::FeatureCore), true);
+
+    mChan3->setResolveContactsOnReceipt(false);
+    QCOMPARE(mChan3->resolvesContactsOnReceipt(), false);
+    QCOMPARE(mChan3->autoContinueThreshold(), 0U);
+
+    QVERIFY(connect(mChan3.data(),
+                SIGNAL(searchStateChanged(Tp::ChannelContactSearchState, const QString &,
+                        const Tp::ContactSearchChannel::SearchStateChangeDetails &)),
+                SLOT(onSearchStateChanged(Tp::ChannelContactSearchState, const QString &,
+                        const Tp::ContactSearchChannel::SearchStateChangeDetails &))));
+    QVERIFY(connect(mChan3.data(),
+                SIGNAL(searchResultReceived(const Tp::ContactSearchChannel::SearchResult &)),
+                SLOT(onSearchResultReceived(const Tp::ContactSearchChannel::SearchResult &))));
+    QVERIFY(connect(mChan3.data(),
+                SIGNAL(searchResultsAvailable(int)),
+                SLOT(onSearchResultsAvailable(int))));
+
+    QVERIFY(connect(mChan3->search(QLatin1String("employer"), QLatin1String("Collabora")),
+                SIGNAL(finished(Tp::PendingOperation *)),
+                SLOT(onSearchReturned(Tp::PendingOperation *))));
+    while (!mSearchReturned) {
+        QCOMPARE(mLoop->exec(), 0);
+    }
+    while (mChan3->searchState() != ChannelContactSearchStateCompleted) {
+        QCOMPARE(mLoop->exec(), 0);
+    }
+
+    // Contacts are not resolved on receipt, so only the merged result set is updated
+    QCOMPARE(mSearchResult.isEmpty(), true);
+    QCOMPARE(mSearchResultsAvailable, 3);
+    QCOMPARE(mChan3->resultCount(), 3);
+
+    QStringList expectedIds;
+    expectedIds << QLatin1String("oggis") << QLatin1String("andrunko") <<
+        QLatin1String("wjt");
+    expectedIds.sort();
+    QStringList ids = mChan3->resultIdentifiers();
+    ids.sort();
+    QCOMPARE(ids, expectedIds);
+    QCOMPARE(mChan3->resultIdentifiers(1, 1).size(), 1);
+    Q_FOREACH (const QString &id, ids) {
+        QCOMPARE(mChan3->resultInfoFields(id).isValid(), true);
+        QCOMPARE(mChan3->resultInfoFields(id).fields(QLatin1String("fn")).size(), 1);
+    }
+    QCOMPARE(mChan3->resultInfoFields(QLatin1String("nobody")).isValid(), false);
+
+    QCOMPARE(mChan3->resultCursor(), 0);
+    PendingContacts *pc = mChan3->fetchResults(2);
+    QCOMPARE(mChan3->resultCursor(), 2);
+    QVERIFY(connect(pc,
+                    SIGNAL(finished(Tp::PendingOperation*)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(pc->contacts().size(), 2);
+    QCOMPARE(pc->identifiers(), mChan3->resultIdentifiers(0, 2));
+
+    pc = mChan3->fetchResults(2);
+    QCOMPARE(mChan3->resultCursor(), 3);
+    QVERIFY(connect(pc,
+                    SIGNAL(finished(Tp::PendingOperation*)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(pc->contacts().size(), 1);
+    QCOMPARE(pc->contacts().first()->id(), mChan3->resultIdentifiers().last());
+
+    mChan3->setResultCursor(10);
+    QCOMPARE(mChan3->resultCursor(), 3);
+
+    // Bounding the buffer drops the oldest fetched results, but positions are kept
+    QStringList allIds = mChan3->resultIdentifiers();
+    QCOMPARE(mChan3->resultBufferSize(), 0U);
+    mChan3->setResultBufferSize(1);
+    QCOMPARE(mChan3->resultBufferSize(), 1U);
+    QCOMPARE(mChan3->resultCount(), 3);
+    QCOMPARE(mChan3->resultIdentifiers(), allIds.mid(2));
+    QCOMPARE(mChan3->resultIdentifiers(1, 2), allIds.mid(2));
+    QCOMPARE(mChan3->resultIdentifiers(0, 2).isEmpty(), true);
+    QCOMPARE(mChan3->resultInfoFields(allIds.at(0)).isValid(), false);
+    QCOMPARE(mChan3->resultInfoFields(allIds.at(2)).isValid(), true);
+
+    mChan3->setResultCursor(0);
+    QCOMPARE(mChan3->resultCursor(), 2);
+    pc = mChan3->fetchResults(2);
+    QCOMPARE(mChan3->resultCursor(), 3);
+    QCOMPARE(pc->identifiers(), allIds.mid(2));
+    QVERIFY(connect(pc,
+                    SIGNAL(finished(Tp::PendingOperation*)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mChan3->resultIdentifiers(), allIds.mid(2));
+
+    mChan3.reset();
+}
+
 void TestContactSearchChan::cleanup()
 {
     cleanupImpl();
@@ -303,6 +437,11 @@ void TestContactSearchChan::cleanupTestCase()
         mChan2Service = 0;
     }
 
+    if (mChan3Service != 0) {
+        g_object_unref(mChan3Service);
+        mChan3Service = 0;
+    }
+
     cleanupTestCaseImpl();
 }
 
@@ -11,6 +11,7 @@
 #include <TelepathyQt/Connection>
 #include <TelepathyQt/ConnectionLowlevel>
 #include <TelepathyQt/Contact>
+#include <TelepathyQt/ContactCapabilities>
 #include <TelepathyQt/ContactFactory>
 #include <TelepathyQt/ContactManager>
 #include <TelepathyQt/PendingContacts>
@@ -19,9 +20,12 @@
 #include <TelepathyQt/Presence>
 #include <TelepathyQt/ReferencedHandles>
 #include <TelepathyQt/Debug>
+#include <TelepathyQt/LocationInfo>
 #include <TelepathyQt/Types>
+#include <TelepathyQt/test-backdoors.h>
 
 #include <telepathy-glib/debug.h>
+#include <telepathy-glib/telepathy-glib.h>
 
 #include <tests/lib/glib/contacts-conn.h>
 #include <tests/lib/glib/simple-conn.h>
@@ -51,12 +55,15 @@ private Q_SLOTS:
     void testSupport();
     void testSelfContact();
     void testForHandles();
+    void testForHandlesMerged();
     void testForIdentifiers();
     void testFeatures();
     void testFeaturesNotRequested();
     void testUpgrade();
     void testSelfContactFallback();
 
+    void testSharedContactData();
+
     void cleanup();
     void cleanupTestCase();
 
@@ -335,6 +342,58 @@ void TestContacts::testForHandles()
     processDBusQueue(mConn.data());
 }
 
+void TestContacts::testForHandlesMerged()
+{
+    Tp::UIntList handles;
+    TpHandleRepoIface *serviceRepo =
+        tp_base_connection_get_handles(TP_BASE_CONNECTION(mConnService), TP_HANDLE_TYPE_CONTACT);
+
+    handles << tp_handle_ensure(serviceRepo, "alice", NULL, NULL);
+    handles << tp_handle_ensure(serviceRepo, "bob", NULL, NULL);
+    handles << 31337;
+    handles << tp_handle_ensure(serviceRepo, "chris", NULL, NULL);
+    handles << tp_handle_ensure(serviceRepo, "dora", NULL, NULL);
+    QVERIFY(!tp_handle_is_valid(serviceRepo, handles[2], NULL));
+
+    // Two overlapping requests made in the same main loop iteration get merged, and split in
+    // calls of two contacts each
+    ContactManagerPtr manager = mConn->contactManager();
+    QCOMPARE(manager->contactAttributesChunkSize(), 500);
+    manager->setContactAttributesChunkSize(2);
+    QCOMPARE(manager->contactAttributesChunkSize(), 2);
+
+    PendingContacts *first = manager->contactsForHandles(handles.mid(0, 3));
+    PendingContacts *second = manager->contactsForHandles(handles.mid(1, 4));
+    QVERIFY(connect(first,
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectPendingContactsFinished(Tp::PendingOperation*))));
+    QVERIFY(connect(second,
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectPendingContactsFinished(Tp::PendingOperation*))));
+
+    // The first request only waits for the calls covering its own contacts
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mContacts.size(), 2);
+    QCOMPARE(mInvalidHandles, Tp::UIntList() << handles[2]);
+    QCOMPARE(mContacts[0]->id(), QString(QLatin1String("alice")));
+    QCOMPARE(mContacts[1]->id(), QString(QLatin1String("bob")));
+    QList<ContactPtr> saveContacts = mContacts;
+
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mContacts.size(), 3);
+    QCOMPARE(mInvalidHandles, Tp::UIntList() << handles[2]);
+    QCOMPARE(mContacts[0], saveContacts[1]);
+    QCOMPARE(mContacts[1]->id(), QString(QLatin1String("chris")));
+    QCOMPARE(mContacts[2]->id(), QString(QLatin1String("dora")));
+
+    manager->setContactAttributesChunkSize(500);
+
+    saveContacts.clear();
+    mContacts.clear();
+    mLoop->processEvents();
+    processDBusQueue(mConn.data());
+}
+
 void TestContacts::testForIdentifiers()
 {
     QStringList validIDs = QStringList() << QLatin1String("Alice")
@@ -775,6 +834,144 @@ void TestContacts::testSelfContactFallback()
     g_object_unref(connService);
 }
 
+static void addTextChatClass(GPtrArray *classes)
+{
+    GHashTable *fixed = tp_asv_new(
+        TP_PROP_CHANNEL_CHANNEL_TYPE, G_TYPE_STRING, TP_IFACE_CHANNEL_TYPE_TEXT,
+        TP_PROP_CHANNEL_TARGET_HANDLE_TYPE, G_TYPE_UINT, TP_HANDLE_TYPE_CONTACT,
+        NULL);
+
+    const gchar * const allowed[] = { NULL };
+    GValueArray *arr = tp_value_array_build(2,
+        TP_HASH_TYPE_STRING_VARIANT_MAP, fixed,
+        G_TYPE_STRV, allowed,
+        G_TYPE_INVALID);
+
+    g_hash_table_unref(fixed);
+
+    g_ptr_array_add(classes, arr);
+}
+
+static void freeRccList(GPtrArray *rccs)
+{
+    g_boxed_free(TP_ARRAY_TYPE_REQUESTABLE_CHANNEL_CLASS_LIST, rccs);
+}
+
+void TestContacts::testSharedContactData()
+{
+    QStringList ids = QStringList() << QLatin1String("shared-a")
+        << QLatin1String("shared-b") << QLatin1String("shared-c");
+
+    TpHandleRepoIface *serviceRepo =
+        tp_base_connection_get_handles(TP_BASE_CONNECTION(mConnService), TP_HANDLE_TYPE_CONTACT);
+    Tp::UIntList handles;
+    for (int i = 0; i < 3; i++) {
+        handles.push_back(tp_handle_ensure(serviceRepo, ids[i].toLatin1().constData(), NULL, NULL));
+        QVERIFY(handles[i] != 0);
+    }
+
+    // The first two contacts can do text chats, the third one can't do anything
+    GHashTable *capabilities = g_hash_table_new_full(NULL, NULL, NULL,
+        (GDestroyNotify) freeRccList);
+    for (int i = 0; i < 3; i++) {
+        GPtrArray *caps = g_ptr_array_new();
+        if (i < 2) {
+            addTextChatClass(caps);
+        }
+        g_hash_table_insert(capabilities, GUINT_TO_POINTER(handles[i]), caps);
+    }
+    tp_tests_contacts_connection_change_capabilities(mConnService, capabilities);
+    g_hash_table_destroy(capabilities);
+
+    // The first two contacts use the same client types, the third one is on another one
+    const gchar *clientTypes[] = { "phone", "pc", NULL };
+    const gchar *otherClientTypes[] = { "web", NULL };
+    for (int i = 0; i < 3; i++) {
+        tp_tests_contacts_connection_change_client_types(mConnService, handles[i],
+                g_strdupv((gchar **) (i < 2 ? clientTypes : otherClientTypes)));
+    }
+
+    // Only the third contact has an avatar, a location and contact info
+    const gchar *tokens[] = { "shared-c-token" };
+    tp_tests_contacts_connection_change_avatar_tokens(mConnService, 1,
+            handles.toVector().constData() + 2, tokens);
+    GHashTable *location = tp_asv_new(
+        "country", G_TYPE_STRING, "United Kingdom",
+        NULL);
+    tp_tests_contacts_connection_change_locations(mConnService, 1,
+            handles.toVector().constData() + 2, &location);
+    g_hash_table_unref(location);
+    GPtrArray *info = (GPtrArray *) dbus_g_type_specialized_construct(
+            TP_ARRAY_TYPE_CONTACT_INFO_FIELD_LIST);
+    const gchar * const fieldValues[] = { "Contact C", NULL };
+    g_ptr_array_add(info, tp_value_array_build(3,
+        G_TYPE_STRING, "fn",
+        G_TYPE_STRV, NULL,
+        G_TYPE_STRV, fieldValues,
+        G_TYPE_INVALID));
+    tp_tests_contacts_connection_change_contact_info(mConnService, handles[2], info);
+    mLoop->processEvents();
+
+    Features features = Features()
+        << Contact::FeatureAvatarToken
+        << Contact::FeatureCapabilities
+        << Contact::FeatureLocation
+        << Contact::FeatureInfo
+        << Contact::FeatureClientTypes;
+    PendingContacts *pending = mConn->contactManager()->contactsForHandles(handles, features);
+    QVERIFY(connect(pending,
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectPendingContactsFinished(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mContacts.size(), 3);
+    for (int i = 0; i < 3; i++) {
+        QCOMPARE(mContacts[i]->handle()[0], handles[i]);
+        QVERIFY(mContacts[i]->actualFeatures().contains(features));
+    }
+
+    // Contacts with equal capabilities share the same storage, others don't
+    const RequestableChannelClassSpecList specsA = mContacts[0]->capabilities().allClassSpecs();
+    const RequestableChannelClassSpecList specsB = mContacts[1]->capabilities().allClassSpecs();
+    QCOMPARE(specsA.size(), 1);
+    QVERIFY(mContacts[0]->capabilities().textChats());
+    QCOMPARE(&specsA.at(0), &specsB.at(0));
+    QVERIFY(!mContacts[2]->capabilities().textChats());
+
+    // So do contacts with equal client types
+    const QStringList typesA = mContacts[0]->clientTypes();
+    const QStringList typesB = mContacts[1]->clientTypes();
+    const QStringList typesC = mContacts[2]->clientTypes();
+    QCOMPARE(typesA, QStringList() << QLatin1String("phone") << QLatin1String("pc"));
+    QCOMPARE(&typesA.at(0), &typesB.at(0));
+    QCOMPARE(typesC, QStringList() << QLatin1String("web"));
+    QVERIFY(&typesA.at(0) != &typesC.at(0));
+
+    // Contacts without avatar, location or contact info don't allocate anything for them
+    for (int i = 0; i < 2; i++) {
+        QVERIFY(!mContacts[i]->isAvatarTokenKnown());
+        QVERIFY(!TestBackdoors::hasContactAvatarBlock(mContacts[i]));
+        QVERIFY(mContacts[i]->location().allDetails().isEmpty());
+        QVERIFY(!TestBackdoors::hasContactLocationBlock(mContacts[i]));
+        QVERIFY(!mContacts[i]->isContactInfoKnown());
+        QVERIFY(!TestBackdoors::hasContactInfoBlock(mContacts[i]));
+    }
+
+    // while the one which has them does
+    QCOMPARE(mContacts[2]->avatarToken(), QLatin1String("shared-c-token"));
+    QVERIFY(TestBackdoors::hasContactAvatarBlock(mContacts[2]));
+    QCOMPARE(mContacts[2]->location().country(), QLatin1String("United Kingdom"));
+    QVERIFY(TestBackdoors::hasContactLocationBlock(mContacts[2]));
+    QVERIFY(mContacts[2]->isContactInfoKnown());
+    QCOMPARE(mContacts[2]->infoFields().allFields().size(), 1);
+    QVERIFY(TestBackdoors::hasContactInfoBlock(mContacts[2]));
+
+    g_boxed_free(TP_ARRAY_TYPE_CONTACT_INFO_FIELD_LIST, info);
+
+    mContacts.clear();
+    mLoop->processEvents();
+    processDBusQueue(mConn.data());
+}
+
 void TestContacts::cleanup()
 {
     cleanupImpl();
@@ -1,6 +1,7 @@
 #include <QtTest/QtTest>
 
 #include <TelepathyQt/PendingReady>
+#include <TelepathyQt/Profile>
 #include <TelepathyQt/ProfileManager>
 
 #include <tests/lib/test.h>
@@ -11,10 +12,58 @@ class TestProfileManager : public Test
 {
     Q_OBJECT
 
+protected Q_SLOTS:
+    void onProfileAdded(const Tp::ProfilePtr &profile);
+    void onProfileRemoved(const Tp::ProfilePtr &profile);
+    void onProfileChanged(const Tp::ProfilePtr &profile);
+
 private Q_SLOTS:
     void testProfileManager();
+    void testWatching();
+    void testWatchingMissingDirectory();
+    void testWatchingFakeProfiles();
+
+private:
+    void writeProfile(const QString &fileName, const QString &serviceName,
+            const QString &name);
+
+    ProfilePtr mAddedProfile;
+    ProfilePtr mRemovedProfile;
+    ProfilePtr mChangedProfile;
 };
 
+void TestProfileManager::onProfileAdded(const Tp::ProfilePtr &profile)
+{
+    mAddedProfile = profile;
+    mLoop->exit(0);
+}
+
+void TestProfileManager::onProfileRemoved(const Tp::ProfilePtr &profile)
+{
+    mRemovedProfile = profile;
+    mLoop->exit(0);
+}
+
+void TestProfileManager::onProfileChanged(const Tp::ProfilePtr &profile)
+{
+    mChangedProfile = profile;
+    mLoop->exit(0);
+}
+
+void TestProfileManager::writeProfile(const QString &fileName, const QString &serviceName,
+        const QString &name)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QFile::WriteOnly | QFile::Truncate));
+    file.write(QString(QLatin1String(
+        "<service xmlns=\"http://telepathy.freedesktop.org/wiki/service-profile-v1\"\n"
+        "         id=\"%1\" type=\"IM\" manager=\"testprofilecm\"\n"
+        "         protocol=\"testprofileproto\">\n"
+        "  <name>%2</name>\n"
+        "</service>\n")).arg(serviceName).arg(name).toUtf8());
+    file.close();
+}
+
 void TestProfileManager::testProfileManager()
 {
     ProfileManagerPtr pm = ProfileManager::create(QDBusConnection::sessionBus());
@@ -81,6 +130,203 @@ void TestProfileManager::testProfileManager()
     mLoop->processEvents();
 }
 
+void TestProfileManager::testWatching()
+{
+    QString dataHome = QDir::tempPath() +
+        QString(QLatin1String("/tpqt-profile-manager-%1")).arg(QCoreApplication::applicationPid());
+    QString profilesDir = dataHome + QLatin1String("/telepathy/profiles");
+    QVERIFY(QDir().mkpath(profilesDir));
+
+    QByteArray oldDataHome = qgetenv("XDG_DATA_HOME");
+    qputenv("XDG_DATA_HOME", dataHome.toLocal8Bit());
+
+    ProfileManagerPtr pm = ProfileManager::create(QDBusConnection::sessionBus());
+    QVERIFY(connect(pm->becomeReady(ProfileManager::FeatureWatching),
+                    SIGNAL(finished(Tp::PendingOperation *)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation *))));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(pm->isReady(ProfileManager::FeatureWatching), true);
+    QCOMPARE(pm->profiles().count(), 2);
+
+    QVERIFY(connect(pm.data(),
+                    SIGNAL(profileAdded(Tp::ProfilePtr)),
+                    SLOT(onProfileAdded(Tp::ProfilePtr))));
+    QVERIFY(connect(pm.data(),
+                    SIGNAL(profileRemoved(Tp::ProfilePtr)),
+                    SLOT(onProfileRemoved(Tp::ProfilePtr))));
+    QVERIFY(connect(pm.data(),
+                    SIGNAL(profileChanged(Tp::ProfilePtr)),
+                    SLOT(onProfileChanged(Tp::ProfilePtr))));
+
+    // a new service
+    QString fileName = profilesDir + QLatin1String("/test-profile-watched.profile");
+    writeProfile(fileName, QLatin1String("test-profile-watched"), QLatin1String("Watched"));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(!mAddedProfile.isNull());
+    QCOMPARE(mAddedProfile->serviceName(), QLatin1String("test-profile-watched"));
+    QCOMPARE(mAddedProfile->name(), QLatin1String("Watched"));
+    QCOMPARE(pm->profiles().count(), 3);
+
+    // the profile is modified in place
+    writeProfile(fileName, QLatin1String("test-profile-watched"), QLatin1String("Watched again"));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(!mChangedProfile.isNull());
+    QCOMPARE(mChangedProfile->name(), QLatin1String("Watched again"));
+    QCOMPARE(pm->profileForService(QLatin1String("test-profile-watched")), mChangedProfile);
+
+    // XDG_DATA_HOME takes precedence over the profiles shipped with the tests
+    mChangedProfile.reset();
+    QString overrideFileName = profilesDir + QLatin1String("/test-profile.profile");
+    writeProfile(overrideFileName, QLatin1String("test-profile"), QLatin1String("Overridden"));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(!mChangedProfile.isNull());
+    QCOMPARE(mChangedProfile->name(), QLatin1String("Overridden"));
+
+    // and removing the override brings back the original profile
+    mChangedProfile.reset();
+    QVERIFY(QFile::remove(overrideFileName));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(!mChangedProfile.isNull());
+    QCOMPARE(mChangedProfile->name(), QLatin1String("TestProfile"));
+
+    QVERIFY(QFile::remove(fileName));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(!mRemovedProfile.isNull());
+    QCOMPARE(mRemovedProfile->serviceName(), QLatin1String("test-profile-watched"));
+    QCOMPARE(pm->profiles().count(), 2);
+
+    if (oldDataHome.isEmpty()) {
+        qunsetenv("XDG_DATA_HOME");
+    } else {
+        qputenv("XDG_DATA_HOME", oldDataHome);
+    }
+    QVERIFY(QDir().rmpath(profilesDir));
+
+    // Allow the PendingReadys to delete themselves
+    mLoop->processEvents();
+}
+
+void TestProfileManager::testWatchingMissingDirectory()
+{
+    // Only the data home exists, as for users who never installed a profile locally
+    QString dataHome = QDir::tempPath() +
+        QString(QLatin1String("/tpqt-profile-manager-missing-%1")).arg(QCoreApplication::applicationPid());
+    QString profilesDir = dataHome + QLatin1String("/telepathy/profiles");
+    QVERIFY(QDir().mkpath(dataHome));
+
+    QByteArray oldDataHome = qgetenv("XDG_DATA_HOME");
+    qputenv("XDG_DATA_HOME", dataHome.toLocal8Bit());
+
+    ProfileManagerPtr pm = ProfileManager::create(QDBusConnection::sessionBus());
+    QVERIFY(connect(pm->becomeReady(ProfileManager::FeatureWatching),
+                    SIGNAL(finished(Tp::PendingOperation *)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation *))));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(pm->isReady(ProfileManager::FeatureWatching), true);
+    QCOMPARE(pm->profiles().count(), 2);
+
+    QVERIFY(connect(pm.data(),
+                    SIGNAL(profileAdded(Tp::ProfilePtr)),
+                    SLOT(onProfileAdded(Tp::ProfilePtr))));
+    QVERIFY(connect(pm.data(),
+                    SIGNAL(profileRemoved(Tp::ProfilePtr)),
+                    SLOT(onProfileRemoved(Tp::ProfilePtr))));
+
+    // the search dir and its first profile are created at once
+    mAddedProfile.reset();
+    QVERIFY(QDir().mkpath(profilesDir));
+    QString fileName = profilesDir + QLatin1String("/test-profile-created.profile");
+    writeProfile(fileName, QLatin1String("test-profile-created"), QLatin1String("Created"));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(!mAddedProfile.isNull());
+    QCOMPARE(mAddedProfile->serviceName(), QLatin1String("test-profile-created"));
+    QCOMPARE(pm->profiles().count(), 3);
+
+    // the search dir is watched itself from now on
+    mAddedProfile.reset();
+    QString otherFileName = profilesDir + QLatin1String("/test-profile-created-too.profile");
+    writeProfile(otherFileName, QLatin1String("test-profile-created-too"), QLatin1String("Created too"));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(!mAddedProfile.isNull());
+    QCOMPARE(mAddedProfile->serviceName(), QLatin1String("test-profile-created-too"));
+    QCOMPARE(pm->profiles().count(), 4);
+
+    QVERIFY(QFile::remove(fileName));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(!mRemovedProfile.isNull());
+    QCOMPARE(mRemovedProfile->serviceName(), QLatin1String("test-profile-created"));
+    QVERIFY(QFile::remove(otherFileName));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(pm->profiles().count(), 2);
+
+    if (oldDataHome.isEmpty()) {
+        qunsetenv("XDG_DATA_HOME");
+    } else {
+        qputenv("XDG_DATA_HOME", oldDataHome);
+    }
+    QVERIFY(QDir().rmpath(profilesDir));
+
+    // Allow the PendingReadys to delete themselves
+    mLoop->processEvents();
+}
+
+void TestProfileManager::testWatchingFakeProfiles()
+{
+    QString dataHome = QDir::tempPath() +
+        QString(QLatin1String("/tpqt-profile-manager-fake-%1")).arg(QCoreApplication::applicationPid());
+    QString profilesDir = dataHome + QLatin1String("/telepathy/profiles");
+    QVERIFY(QDir().mkpath(profilesDir));
+
+    QByteArray oldDataHome = qgetenv("XDG_DATA_HOME");
+    qputenv("XDG_DATA_HOME", dataHome.toLocal8Bit());
+
+    ProfileManagerPtr pm = ProfileManager::create(QDBusConnection::sessionBus());
+    QVERIFY(connect(pm->becomeReady(Features() << ProfileManager::FeatureFakeProfiles
+                        << ProfileManager::FeatureWatching),
+                    SIGNAL(finished(Tp::PendingOperation *)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation *))));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(pm->isReady(ProfileManager::FeatureWatching), true);
+    QCOMPARE(pm->profiles().count(), 4);
+
+    ProfilePtr fakeProfile = pm->profileForService(QLatin1String("spurious-normal"));
+    QVERIFY(!fakeProfile.isNull());
+    QVERIFY(fakeProfile->isFake());
+
+    QVERIFY(connect(pm.data(),
+                    SIGNAL(profileChanged(Tp::ProfilePtr)),
+                    SLOT(onProfileChanged(Tp::ProfilePtr))));
+
+    // a real profile replaces the fake one
+    mChangedProfile.reset();
+    QString fileName = profilesDir + QLatin1String("/spurious-normal.profile");
+    writeProfile(fileName, QLatin1String("spurious-normal"), QLatin1String("Real"));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(!mChangedProfile.isNull());
+    QVERIFY(!mChangedProfile->isFake());
+    QCOMPARE(mChangedProfile->name(), QLatin1String("Real"));
+    QCOMPARE(pm->profiles().count(), 4);
+
+    // and removing it brings back the fake profile
+    mChangedProfile.reset();
+    QVERIFY(QFile::remove(fileName));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(!mChangedProfile.isNull());
+    QCOMPARE(mChangedProfile, fakeProfile);
+    QCOMPARE(pm->profileForService(QLatin1String("spurious-normal")), fakeProfile);
+    QCOMPARE(pm->profiles().count(), 4);
+
+    if (oldDataHome.isEmpty()) {
+        qunsetenv("XDG_DATA_HOME");
+    } else {
+        qputenv("XDG_DATA_HOME", oldDataHome);
+    }
+    QVERIFY(QDir().rmpath(profilesDir));
+
+    // Allow the PendingReadys to delete themselves
+    mLoop->processEvents();
+}
+
 QTEST_MAIN(TestProfileManager)
 
 #include "_gen/profile-manager.cpp.moc.hpp"
@@ -26,9 +26,20 @@
 
 #include <cstring>
 
+#include <QDir>
+#include <QFile>
 #include <QTcpServer>
 #include <QTcpSocket>
 
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
 using namespace Tp;
 using namespace Tp::Client;
 
@@ -254,6 +265,135 @@ GHashTable *createSupportedSocketTypesHash(bool supportMonitoring, bool unixOnly
     return ret;
 }
 
+// A plain non-blocking TCP listener, so that the test controls exactly when each end is closed,
+// which QTcpSocket doesn't allow
+int listenOnLocalhost(quint16 *port)
+{
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd == -1) {
+        return -1;
+    }
+
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (::bind(fd, reinterpret_cast<struct sockaddr *>(&addr), len) == -1 ||
+            ::listen(fd, 1) == -1 ||
+            ::getsockname(fd, reinterpret_cast<struct sockaddr *>(&addr), &len) == -1 ||
+            ::fcntl(fd, F_SETFL, O_NONBLOCK) == -1) {
+        ::close(fd);
+        return -1;
+    }
+
+    *port = ntohs(addr.sin_port);
+    return fd;
+}
+
+int connectToUnixSocket(const QString &path)
+{
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) {
+        return -1;
+    }
+
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    QByteArray encoded = QFile::encodeName(path);
+    if (encoded.size() >= int(sizeof(addr.sun_path))) {
+        ::close(fd);
+        return -1;
+    }
+    std::memcpy(addr.sun_path, encoded.constData(), encoded.size());
+
+    // The relay is listening already, so this completes without it running its event loop
+    if (::connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == -1) {
+        ::close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+class LocalConnectionRecorder : public StreamTubeClient::LocalConnectionHandler
+{
+public:
+    LocalConnectionRecorder() { }
+    virtual ~LocalConnectionRecorder()
+    {
+        foreach (int fd, fds) {
+            ::close(fd);
+        }
+    }
+
+    void handleLocalConnection(const AccountPtr &account,
+            const IncomingStreamTubeChannelPtr &tube, int socketDescriptor)
+    {
+        Q_UNUSED(account);
+        Q_UNUSED(tube);
+        fds.append(socketDescriptor);
+    }
+
+    void localConnectionFailed(const AccountPtr &account,
+            const IncomingStreamTubeChannelPtr &tube, const QString &error,
+            const QString &message)
+    {
+        Q_UNUSED(account);
+        Q_UNUSED(tube);
+        Q_UNUSED(message);
+        errors.append(error);
+    }
+
+    QList<int> fds;
+    QStringList errors;
+};
+
+// The test CM only gets here once it has received and checked the credential byte, if any
+void onServiceIncomingConnection(TpTestsStreamTubeChannel *chan, GIOStream *stream,
+        gpointer data)
+{
+    Q_UNUSED(chan);
+    Q_UNUSED(stream);
+    ++*static_cast<int *>(data);
+}
+
+// Runs the event loop until fd has something to read, as the relay moves data from there
+bool waitUntilReadable(QEventLoop *loop, int fd)
+{
+    for (int i = 0; i < 500; ++i) {
+        loop->processEvents();
+
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        if (::poll(&pfd, 1, 10) > 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+uint histogramTotal(const QList<uint> &histogram)
+{
+    uint total = 0;
+    foreach (uint count, histogram) {
+        total += count;
+    }
+    return total;
+}
+
+// The histogram bucket a duration is counted in, see StreamTubeMetrics::histogramBounds()
+int histogramBucket(qint64 msecs)
+{
+    QList<qint64> bounds = StreamTubeMetrics::histogramBounds();
+    int bucket = 0;
+    while (bucket < bounds.size() && msecs > bounds[bucket]) {
+        ++bucket;
+    }
+    return bucket;
+}
+
 }
 
 class TestStreamTubeHandlers : public Test
@@ -275,6 +415,11 @@ protected Q_SLOTS:
     void onServerConnectionClosed(const QHostAddress &, quint16, const Tp::AccountPtr &,
             const Tp::ContactPtr &, const QString &, const QString &,
             const Tp::OutgoingStreamTubeChannelPtr &);
+    void onServerConnectionOpened(const Tp::AccountPtr &, const Tp::OutgoingStreamTubeChannelPtr &,
+            uint, const Tp::ContactPtr &);
+    void onServerConnectionIdClosed(const Tp::AccountPtr &,
+            const Tp::OutgoingStreamTubeChannelPtr &, uint, const Tp::ContactPtr &,
+            const QString &, const QString &);
 
     void onTubeOffered(const Tp::AccountPtr &, const Tp::IncomingStreamTubeChannelPtr &);
     void onClientTubeClosed(const Tp::AccountPtr &, const Tp::IncomingStreamTubeChannelPtr &,
@@ -288,6 +433,8 @@ protected Q_SLOTS:
     void onClientConnectionClosed(const Tp::AccountPtr &, const Tp::IncomingStreamTubeChannelPtr &,
             uint, const QString &, const QString &);
 
+    void onMetricsUpdated(const Tp::StreamTubeMetrics &);
+
 private Q_SLOTS:
     void initTestCase();
     void init();
@@ -297,6 +444,10 @@ private Q_SLOTS:
     void testFailedExport();
     void testServerConnMonitoring();
     void testSSTHErrorPaths();
+    void testUnixExport_data();
+    void testUnixExport();
+    void testUnixConnMonitoring();
+    void testUnixRelay();
 
     void testClientBasicTcp();
     void testClientTcpGeneratorIgnore();
@@ -304,8 +455,10 @@ private Q_SLOTS:
 
     void testClientBasicUnix();
     void testClientUnixCredsIgnore();
+    void testClientUnixPool();
     // the unix AF unsupported codepaths are the same, so no need to test separately
     void testClientConnMonitoring();
+    void testClientMetricsReports();
 
     void cleanup();
     void cleanupTestCase();
@@ -315,6 +468,8 @@ private:
 
     QPair<QString, QVariantMap> createTubeChannel(bool requested, HandleType type,
             bool supportMonitoring, bool unixOnly = false);
+    void handleServerTube(const StreamTubeServerPtr &server,
+            const QPair<QString, QVariantMap> &chan);
 
     AccountManagerPtr mAM;
     AccountPtr mAcc;
@@ -334,6 +489,11 @@ private:
     OutgoingStreamTubeChannelPtr mNewServerConnectionTube, mServerConnectionCloseTube;
     QString mServerConnectionCloseError, mServerConnectionCloseMessage;
 
+    OutgoingStreamTubeChannelPtr mOpenedServerConnectionTube, mClosedServerConnectionIdTube;
+    uint mOpenedServerConnectionId, mClosedServerConnectionId;
+    ContactPtr mOpenedServerConnectionContact, mClosedServerConnectionIdContact;
+    QString mServerConnectionIdCloseError;
+
     IncomingStreamTubeChannelPtr mOfferedTube;
 
     IncomingStreamTubeChannelPtr mClientClosedTube;
@@ -350,6 +510,8 @@ private:
     IncomingStreamTubeChannelPtr mNewClientConnectionTube, mClosedClientConnectionTube;
     uint mNewClientConnectionId, mClosedClientConnectionId;
     QString mClientConnectionCloseError, mClientConnectionCloseMessage;
+
+    QList<StreamTubeMetrics> mMetricsReports;
 };
 
 QPair<QString, QVariantMap> TestStreamTubeHandlers::createTubeChannel(bool requested,
@@ -411,6 +573,42 @@ QPair<QString, QVariantMap> TestStreamTubeHandlers::createTubeChannel(bool reque
     return qMakePair(chanPath, chanProps);
 }
 
+void TestStreamTubeHandlers::handleServerTube(const StreamTubeServerPtr &server,
+        const QPair<QString, QVariantMap> &chan)
+{
+    QMap<QString, ClientHandlerInterface *> handlers = ourHandlers();
+    ClientHandlerInterface *handler = handlers.value(server->clientName());
+    QVERIFY(handler != 0);
+
+    QVERIFY(connect(server.data(),
+                SIGNAL(tubeRequested(Tp::AccountPtr,Tp::OutgoingStreamTubeChannelPtr,QDateTime,Tp::ChannelRequestHints)),
+                SLOT(onTubeRequested(Tp::AccountPtr,Tp::OutgoingStreamTubeChannelPtr,QDateTime,Tp::ChannelRequestHints))));
+
+    ChannelDetails details = { QDBusObjectPath(chan.first), chan.second };
+    handler->HandleChannels(
+            QDBusObjectPath(mAcc->objectPath()),
+            QDBusObjectPath(mConn->objectPath()),
+            ChannelDetailsList() << details,
+            ObjectPathList(),
+            QDateTime::currentDateTime().toTime_t(),
+            QVariantMap());
+
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(disconnect(server.data(),
+                SIGNAL(tubeRequested(Tp::AccountPtr,Tp::OutgoingStreamTubeChannelPtr,QDateTime,Tp::ChannelRequestHints)),
+                this,
+                SLOT(onTubeRequested(Tp::AccountPtr,Tp::OutgoingStreamTubeChannelPtr,QDateTime,Tp::ChannelRequestHints))));
+
+    QVERIFY(!mRequestedTube.isNull());
+    QCOMPARE(mRequestedTube->objectPath(), chan.first);
+
+    // Let's run until the tube has been offered
+    while (mRequestedTube->isValid() && mRequestedTube->state() != TubeChannelStateRemotePending) {
+        mLoop->processEvents();
+    }
+    QVERIFY(mRequestedTube->isValid());
+}
+
 QMap<QString, ClientHandlerInterface *> TestStreamTubeHandlers::ourHandlers()
 {
     QStringList registeredNames =
@@ -589,6 +787,59 @@ void TestStreamTubeHandlers::onServerConnectionClosed(
     mLoop->exit(0);
 }
 
+void TestStreamTubeHandlers::onServerConnectionOpened(
+        const Tp::AccountPtr &acc,
+        const Tp::OutgoingStreamTubeChannelPtr &tube,
+        uint id,
+        const Tp::ContactPtr &contact)
+{
+    qDebug() << "new conn" << id << "on tube" << tube->objectPath();
+    qDebug() << "from contact" << contact->id();
+
+    if (acc->objectPath() != mAcc->objectPath()) {
+        qWarning() << "account" << acc->objectPath() << "is not the expected" << mAcc->objectPath();
+        mLoop->exit(1);
+        return;
+    }
+
+    if (!tube->connections().contains(id)) {
+        qWarning() << "the signaled tube doesn't report having that particular connection";
+        mLoop->exit(2);
+        return;
+    }
+
+    mOpenedServerConnectionTube = tube;
+    mOpenedServerConnectionId = id;
+    mOpenedServerConnectionContact = contact;
+
+    mLoop->exit(0);
+}
+
+void TestStreamTubeHandlers::onServerConnectionIdClosed(
+        const Tp::AccountPtr &acc,
+        const Tp::OutgoingStreamTubeChannelPtr &tube,
+        uint id,
+        const Tp::ContactPtr &contact,
+        const QString &error,
+        const QString &message)
+{
+    qDebug() << "conn" << id << "closed on tube" << tube->objectPath();
+    qDebug() << "with error" << error << ':' << message;
+
+    if (acc->objectPath() != mAcc->objectPath()) {
+        qWarning() << "account" << acc->objectPath() << "is not the expected" << mAcc->objectPath();
+        mLoop->exit(1);
+        return;
+    }
+
+    mClosedServerConnectionIdTube = tube;
+    mClosedServerConnectionId = id;
+    mClosedServerConnectionIdContact = contact;
+    mServerConnectionIdCloseError = error;
+
+    mLoop->exit(0);
+}
+
 void TestStreamTubeHandlers::onTubeOffered(
         const Tp::AccountPtr &acc,
         const Tp::IncomingStreamTubeChannelPtr &tube)
@@ -706,6 +957,14 @@ void TestStreamTubeHandlers::onClientConnectionClosed(
     mLoop->exit(0);
 }
 
+void TestStreamTubeHandlers::onMetricsUpdated(const Tp::StreamTubeMetrics &metrics)
+{
+    qDebug() << "metrics updated for" << metrics.tubeCount() << "tubes";
+
+    // Reports are timer driven, so don't stop the loop the tests wait on for other signals
+    mMetricsReports.append(metrics);
+}
+
 void TestStreamTubeHandlers::initTestCase()
 {
     initTestCaseImpl();
@@ -1030,6 +1289,11 @@ void TestStreamTubeHandlers::testServerConnMonitoring()
     QVERIFY(server->isRegistered());
     QVERIFY(server->monitorsConnections());
 
+    QVERIFY(!server->isMetricsEnabled());
+    server->setMetricsReportInterval(0);
+    server->setMetricsEnabled(true);
+    QVERIFY(server->isMetricsEnabled());
+
     QMap<QString, ClientHandlerInterface *> handlers = ourHandlers();
 
     QVERIFY(!handlers.isEmpty());
@@ -1114,6 +1378,33 @@ void TestStreamTubeHandlers::testServerConnMonitoring()
     QCOMPARE(conns.value(qMakePair(expectedAddress, expectedPort)).account()->objectPath(), mAcc->objectPath());
     QCOMPARE(conns.value(qMakePair(expectedAddress, expectedPort)).contact(), mNewServerConnectionContact);
 
+    StreamTubeMetrics metrics = server->metrics();
+    QVERIFY(metrics.isValid());
+    QCOMPARE(metrics.tubeCount(), 1U);
+    QCOMPARE(metrics.openConnectionCount(), 1U);
+    QCOMPARE(metrics.totalConnectionCount(), 1U);
+    QVERIFY(!metrics.hasByteCounts());
+
+    // The tube was set up once offered, and the first connection came some time after that
+    StreamTubeServer::Tube serverTube = server->tubes().first();
+    metrics = server->metrics(serverTube);
+    QVERIFY(metrics.setupLatency() >= 0);
+    QCOMPARE(metrics.setupLatencyHistogram().at(histogramBucket(metrics.setupLatency())), 1U);
+    QVERIFY(metrics.firstConnectionLatency() >= 0);
+    QCOMPARE(metrics.firstConnectionLatencyHistogram().at(
+                histogramBucket(metrics.firstConnectionLatency())), 1U);
+
+    QHash<QPair<QHostAddress, quint16>, uint> connIds =
+        mRequestedTube->connectionsForSourceAddresses();
+    QCOMPARE(connIds.size(), 1);
+    uint firstId = connIds.value(qMakePair(expectedAddress, expectedPort));
+    StreamTubeConnectionMetrics connMetrics = server->connectionMetrics(serverTube, firstId);
+    QVERIFY(connMetrics.isValid());
+    QCOMPARE(connMetrics.connectionId(), firstId);
+    QCOMPARE(connMetrics.setupLatency(), metrics.firstConnectionLatency());
+    QVERIFY(connMetrics.age() >= 0);
+    QVERIFY(!server->connectionMetrics(serverTube, firstId + 1000).isValid());
+
     // Now, close the first connection
     tp_tests_stream_tube_channel_last_connection_disconnected(mChanServices.back(),
             TP_ERROR_STR_DISCONNECTED);
@@ -1124,6 +1415,7 @@ void TestStreamTubeHandlers::testServerConnMonitoring()
     QCOMPARE(mClosedServerConnectionContact, mNewServerConnectionContact);
     QCOMPARE(mServerConnectionCloseError, QString(TP_QT_ERROR_DISCONNECTED));
     QVERIFY(server->tcpConnections().isEmpty());
+    QVERIFY(!server->connectionMetrics(serverTube, firstId).isValid());
 
     // Fire up two new connections
     handle = tp_handle_ensure(contactRepo, "second", NULL, NULL);
@@ -1152,6 +1444,9 @@ void TestStreamTubeHandlers::testServerConnMonitoring()
     QCOMPARE(mNewServerConnectionTube, mRequestedTube);
     QCOMPARE(server->tcpConnections().size(), 2);
 
+    QCOMPARE(server->metrics(server->tubes().first()).openConnectionCount(), 2U);
+    QCOMPARE(server->metrics().totalConnectionCount(), 3U);
+
     // Close one of them, and check that we receive the signal for it
     tp_tests_stream_tube_channel_last_connection_disconnected(mChanServices.back(),
             TP_ERROR_STR_DISCONNECTED);
@@ -1184,6 +1479,19 @@ void TestStreamTubeHandlers::testServerConnMonitoring()
 
     QCOMPARE(mServerClosedTube, mRequestedTube);
     QCOMPARE(mServerCloseError, QString(TP_QT_ERROR_CANCELLED)); // == local close request
+
+    // The totals survive the tube
+    metrics = server->metrics();
+    QCOMPARE(metrics.tubeCount(), 1U);
+    QCOMPARE(metrics.openConnectionCount(), 0U);
+    QCOMPARE(metrics.totalConnectionCount(), 3U);
+    QCOMPARE(metrics.connectionLifetimeHistogram().size(),
+            StreamTubeMetrics::histogramBounds().size() + 1);
+    uint closedConnections = 0;
+    foreach (uint count, metrics.connectionLifetimeHistogram()) {
+        closedConnections += count;
+    }
+    QCOMPARE(closedConnections, 3U);
 }
 
 void TestStreamTubeHandlers::testSSTHErrorPaths()
@@ -1293,6 +1601,256 @@ void TestStreamTubeHandlers::testSSTHErrorPaths()
     g_object_unref(textChanService);
 }
 
+void TestStreamTubeHandlers::testUnixExport_data()
+{
+    QTest::addColumn<bool>("abstract");
+    QTest::addColumn<bool>("requireCredentials");
+
+    QTest::newRow("filesystem") << false << false;
+    QTest::newRow("filesystem with credentials") << false << true;
+    QTest::newRow("abstract") << true << false;
+    QTest::newRow("abstract with credentials") << true << true;
+}
+
+void TestStreamTubeHandlers::testUnixExport()
+{
+    QFETCH(bool, abstract);
+    QFETCH(bool, requireCredentials);
+
+    StreamTubeServerPtr server =
+        StreamTubeServer::create(QStringList() << QLatin1String("ftp"), QStringList(),
+                QLatin1String("vsftpd"), true);
+
+    QString address;
+    if (abstract) {
+        address = QString(QLatin1Char('\0')) + QLatin1String("tpqt-test-unix-export");
+    } else {
+        address = QDir::tempPath() + QLatin1String("/tpqt-test-unix-export");
+    }
+
+    QVariantMap params;
+    params.insert(QLatin1String("username"), QString::fromLatin1("user"));
+    server->exportUnixSocket(address, params, requireCredentials);
+
+    QVERIFY(server->isRegistered());
+    QCOMPARE(server->exportedUnixSocketAddress(), address);
+    QCOMPARE(server->exportedUnixSocketRequiresCredentials(), requireCredentials);
+    QCOMPARE(server->exportedTcpSocketAddress(), qMakePair(QHostAddress(), quint16(0)));
+    QCOMPARE(server->exportedParameters(), params);
+
+    // Credentials are only offered as an access control on channels supporting monitoring
+    handleServerTube(server, createTubeChannel(true, HandleTypeContact, true));
+    QVERIFY(!mRequestedTube.isNull());
+
+    // The CM has accepted the offer with the address type and access control checked against what
+    // it supports
+    QCOMPARE(mRequestedTube->addressType(),
+            abstract ? SocketAddressTypeAbstractUnix : SocketAddressTypeUnix);
+    QCOMPARE(mRequestedTube->localAddress(), address);
+    QCOMPARE(mRequestedTube->accessControl(),
+            requireCredentials ? SocketAccessControlCredentials : SocketAccessControlLocalhost);
+
+    QVERIFY(connect(server.data(),
+                SIGNAL(newConnection(Tp::AccountPtr,Tp::OutgoingStreamTubeChannelPtr,uint,Tp::ContactPtr)),
+                SLOT(onServerConnectionOpened(Tp::AccountPtr,Tp::OutgoingStreamTubeChannelPtr,uint,Tp::ContactPtr))));
+
+    // The CM passes the byte it got along with the credentials, or nothing useful otherwise
+    GValue *connParam = requireCredentials ?
+        tp_g_value_slice_new_byte(42) : tp_g_value_slice_new_static_string("dummy");
+    TpHandleRepoIface *contactRepo = tp_base_connection_get_handles(
+            TP_BASE_CONNECTION(mConn->service()), TP_HANDLE_TYPE_CONTACT);
+    TpHandle handle = tp_handle_ensure(contactRepo, "first", NULL, NULL);
+    tp_tests_stream_tube_channel_peer_connected_no_stream(mChanServices.back(), connParam, handle);
+    tp_g_value_slice_free(connParam);
+
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mOpenedServerConnectionTube, mRequestedTube);
+    QCOMPARE(mOpenedServerConnectionContact->id(), QLatin1String("first"));
+    QCOMPARE(mRequestedTube->parameters(), params);
+
+    if (requireCredentials) {
+        QCOMPARE(mRequestedTube->connectionsForCredentials().value(42, 0xffffffff),
+                mOpenedServerConnectionId);
+    } else {
+        QVERIFY(mRequestedTube->connectionsForCredentials().isEmpty());
+    }
+
+    // Unix connections are never reported as TCP ones
+    QVERIFY(server->tcpConnections().isEmpty());
+    QCOMPARE(server->connections().size(), 1);
+}
+
+void TestStreamTubeHandlers::testUnixConnMonitoring()
+{
+    StreamTubeServerPtr server =
+        StreamTubeServer::create(QStringList() << QLatin1String("ftp"),
+                QStringList() << QLatin1String("multiftp"), QLatin1String("warezd"), true);
+    server->exportUnixSocket(QDir::tempPath() + QLatin1String("/tpqt-test-unix-monitoring"));
+    QVERIFY(server->monitorsConnections());
+
+    // Two tubes, on which the CM numbers the connections independently
+    handleServerTube(server, createTubeChannel(true, HandleTypeContact, true));
+    QVERIFY(!mRequestedTube.isNull());
+    OutgoingStreamTubeChannelPtr firstTube = mRequestedTube;
+    TpTestsStreamTubeChannel *firstService = mChanServices.back();
+    handleServerTube(server, createTubeChannel(true, HandleTypeRoom, true));
+    OutgoingStreamTubeChannelPtr secondTube = mRequestedTube;
+    TpTestsStreamTubeChannel *secondService = mChanServices.back();
+    QVERIFY(firstTube != secondTube);
+
+    QVERIFY(server->connections().isEmpty());
+
+    QVERIFY(connect(server.data(),
+                SIGNAL(newConnection(Tp::AccountPtr,Tp::OutgoingStreamTubeChannelPtr,uint,Tp::ContactPtr)),
+                SLOT(onServerConnectionOpened(Tp::AccountPtr,Tp::OutgoingStreamTubeChannelPtr,uint,Tp::ContactPtr))));
+    QVERIFY(connect(server.data(),
+                SIGNAL(connectionClosed(Tp::AccountPtr,Tp::OutgoingStreamTubeChannelPtr,uint,Tp::ContactPtr,QString,QString)),
+                SLOT(onServerConnectionIdClosed(Tp::AccountPtr,Tp::OutgoingStreamTubeChannelPtr,uint,Tp::ContactPtr,QString,QString))));
+    QVERIFY(connect(server.data(),
+                SIGNAL(tubeClosed(Tp::AccountPtr,Tp::OutgoingStreamTubeChannelPtr,QString,QString)),
+                SLOT(onServerTubeClosed(Tp::AccountPtr,Tp::OutgoingStreamTubeChannelPtr,QString,QString))));
+
+    GValue *connParam = tp_g_value_slice_new_static_string("dummy");
+    TpHandleRepoIface *contactRepo = tp_base_connection_get_handles(
+            TP_BASE_CONNECTION(mConn->service()), TP_HANDLE_TYPE_CONTACT);
+
+    TpHandle handle = tp_handle_ensure(contactRepo, "first", NULL, NULL);
+    tp_tests_stream_tube_channel_peer_connected_no_stream(firstService, connParam, handle);
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mOpenedServerConnectionTube, firstTube);
+    QCOMPARE(mOpenedServerConnectionContact->id(), QLatin1String("first"));
+    uint firstId = mOpenedServerConnectionId;
+
+    handle = tp_handle_ensure(contactRepo, "second", NULL, NULL);
+    tp_tests_stream_tube_channel_peer_connected_no_stream(secondService, connParam, handle);
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mOpenedServerConnectionTube, secondTube);
+    QCOMPARE(mOpenedServerConnectionContact->id(), QLatin1String("second"));
+    uint secondId = mOpenedServerConnectionId;
+
+    tp_g_value_slice_free(connParam);
+
+    // Both are the first connection on their tube, and still kept apart
+    QCOMPARE(firstId, secondId);
+
+    QHash<StreamTubeServer::Tube, QHash<uint, StreamTubeServer::RemoteContact> > conns =
+        server->connections();
+    QCOMPARE(conns.size(), 2);
+    for (QHash<StreamTubeServer::Tube, QHash<uint, StreamTubeServer::RemoteContact> >::const_iterator i =
+            conns.constBegin(); i != conns.constEnd(); ++i) {
+        QCOMPARE(i.key().account()->objectPath(), mAcc->objectPath());
+        QCOMPARE(i.value().size(), 1);
+        QVERIFY(i.value().contains(firstId));
+        QCOMPARE(i.value().value(firstId).account()->objectPath(), mAcc->objectPath());
+        QCOMPARE(i.value().value(firstId).contact()->id(),
+                QLatin1String(i.key().channel() == firstTube ? "first" : "second"));
+    }
+    QVERIFY(server->tcpConnections().isEmpty());
+
+    // Closing a connection only drops it from its own tube
+    tp_tests_stream_tube_channel_last_connection_disconnected(firstService,
+            TP_ERROR_STR_DISCONNECTED);
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mClosedServerConnectionIdTube, firstTube);
+    QCOMPARE(mClosedServerConnectionId, firstId);
+    QCOMPARE(mClosedServerConnectionIdContact->id(), QLatin1String("first"));
+    QCOMPARE(mServerConnectionIdCloseError, QString(TP_QT_ERROR_DISCONNECTED));
+
+    conns = server->connections();
+    QCOMPARE(conns.size(), 1);
+    QCOMPARE(conns.constBegin().key().channel(), secondTube);
+    QVERIFY(conns.constBegin().value().contains(secondId));
+
+    // The connections left on a closed tube are reported closed before the tube
+    mClosedServerConnectionIdContact.reset();
+    secondTube->requestClose();
+    while (mClosedServerConnectionIdContact.isNull() || mServerClosedTube.isNull()) {
+        QVERIFY(mServerClosedTube.isNull());
+        QCOMPARE(mLoop->exec(), 0);
+    }
+
+    QCOMPARE(mClosedServerConnectionIdTube, secondTube);
+    QCOMPARE(mClosedServerConnectionId, secondId);
+    QCOMPARE(mClosedServerConnectionIdContact->id(), QLatin1String("second"));
+    QCOMPARE(mServerConnectionIdCloseError, TP_QT_ERROR_ORPHANED);
+    QCOMPARE(mServerClosedTube, secondTube);
+    QVERIFY(server->connections().isEmpty());
+
+    // Leave the first tube for cleanup() to close
+    mRequestedTube = firstTube;
+}
+
+void TestStreamTubeHandlers::testUnixRelay()
+{
+    quint16 port;
+    int listener = listenOnLocalhost(&port);
+    QVERIFY(listener != -1);
+
+    StreamTubeServerPtr server =
+        StreamTubeServer::create(QStringList() << QLatin1String("ftp"), QStringList(),
+                QLatin1String("vsftpd"), true);
+    server->setUnixRelayEnabled(true);
+    if (!server->isUnixRelayEnabled()) {
+        qDebug() << "The Unix socket relay isn't supported on this platform, skipping";
+        ::close(listener);
+        return;
+    }
+    server->exportTcpSocket(QHostAddress::LocalHost, port);
+
+    // The backend supports Unix sockets, so it's offered the relay instead of the TCP socket
+    handleServerTube(server, createTubeChannel(true, HandleTypeContact, true));
+    QVERIFY(!mRequestedTube.isNull());
+    QCOMPARE(mRequestedTube->addressType(), SocketAddressTypeUnix);
+    QCOMPARE(mRequestedTube->accessControl(), SocketAccessControlLocalhost);
+    QString relayAddress = mRequestedTube->localAddress();
+    QVERIFY(!relayAddress.isEmpty());
+
+    // Connect like the backend would, and pick up the connection the relay makes to the service
+    int local = connectToUnixSocket(relayAddress);
+    QVERIFY(local != -1);
+
+    int target = -1;
+    for (int i = 0; i < 500 && target == -1; ++i) {
+        mLoop->processEvents();
+        target = ::accept(listener, 0, 0);
+        if (target == -1) {
+            QVERIFY(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+            ::usleep(10000);
+        }
+    }
+    ::close(listener);
+    QVERIFY(target != -1);
+
+    char buf[16];
+
+    // Bytes go both ways
+    QCOMPARE(int(::send(local, "ping", 4, 0)), 4);
+    QVERIFY(waitUntilReadable(mLoop, target));
+    QCOMPARE(int(::recv(target, buf, sizeof(buf), 0)), 4);
+    QCOMPARE(QByteArray(buf, 4), QByteArray("ping"));
+
+    QCOMPARE(int(::send(target, "pong", 4, 0)), 4);
+    QVERIFY(waitUntilReadable(mLoop, local));
+    QCOMPARE(int(::recv(local, buf, sizeof(buf), 0)), 4);
+    QCOMPARE(QByteArray(buf, 4), QByteArray("pong"));
+
+    // Shutting down one direction passes on the end of the stream, but keeps the other one open
+    QCOMPARE(::shutdown(local, SHUT_WR), 0);
+    QVERIFY(waitUntilReadable(mLoop, target));
+    QCOMPARE(int(::recv(target, buf, sizeof(buf), 0)), 0);
+
+    QCOMPARE(int(::send(target, "late", 4, 0)), 4);
+    QVERIFY(waitUntilReadable(mLoop, local));
+    QCOMPARE(int(::recv(local, buf, sizeof(buf), 0)), 4);
+    QCOMPARE(QByteArray(buf, 4), QByteArray("late"));
+
+    // And closing the service end finishes the relayed connection
+    ::close(target);
+    QVERIFY(waitUntilReadable(mLoop, local));
+    QCOMPARE(int(::recv(local, buf, sizeof(buf), 0)), 0);
+    ::close(local);
+}
+
 void TestStreamTubeHandlers::testClientBasicTcp()
 {
     StreamTubeClientPtr client =
@@ -1701,6 +2259,102 @@ void TestStreamTubeHandlers::testClientUnixCredsIgnore()
     QCOMPARE(mClientCloseError, QString(TP_QT_ERROR_CANCELLED)); // == local close request
 }
 
+void TestStreamTubeHandlers::testClientUnixPool()
+{
+    StreamTubeClientPtr client =
+        StreamTubeClient::create(QStringList() << QLatin1String("ftp"), QStringList(),
+                QLatin1String("ncftp"), true);
+
+    LocalConnectionRecorder recorder;
+    client->setToAcceptAsUnix(true);
+    client->setLocalConnectionPool(&recorder, 2);
+    QVERIFY(client->isRegistered());
+    QCOMPARE(client->localConnectionHandler(),
+            static_cast<StreamTubeClient::LocalConnectionHandler *>(&recorder));
+    QCOMPARE(client->localConnectionPoolSize(), 2U);
+
+    QMap<QString, ClientHandlerInterface *> handlers = ourHandlers();
+    ClientHandlerInterface *handler = handlers.value(client->clientName());
+    QVERIFY(handler != 0);
+
+    QPair<QString, QVariantMap> chan = createTubeChannel(false, HandleTypeContact, true);
+
+    int serviceConnections = 0;
+    g_signal_connect(mChanServices.back(), "incoming-connection",
+            G_CALLBACK(onServiceIncomingConnection), &serviceConnections);
+
+    QVERIFY(connect(client.data(),
+                SIGNAL(tubeOffered(Tp::AccountPtr,Tp::IncomingStreamTubeChannelPtr)),
+                SLOT(onTubeOffered(Tp::AccountPtr,Tp::IncomingStreamTubeChannelPtr))));
+    QVERIFY(connect(client.data(),
+                SIGNAL(tubeAcceptedAsUnix(QString,bool,uchar,
+                        Tp::AccountPtr,Tp::IncomingStreamTubeChannelPtr)),
+                SLOT(onClientAcceptedAsUnix(QString,bool,uchar,
+                        Tp::AccountPtr,Tp::IncomingStreamTubeChannelPtr))));
+    QVERIFY(connect(client.data(),
+                SIGNAL(newConnection(Tp::AccountPtr,Tp::IncomingStreamTubeChannelPtr,uint)),
+                SLOT(onNewClientConnection(Tp::AccountPtr,Tp::IncomingStreamTubeChannelPtr,uint))));
+
+    ChannelDetails details = { QDBusObjectPath(chan.first), chan.second };
+    handler->HandleChannels(
+            QDBusObjectPath(mAcc->objectPath()),
+            QDBusObjectPath(mConn->objectPath()),
+            ChannelDetailsList() << details,
+            ObjectPathList(),
+            QDateTime::currentDateTime().toTime_t(),
+            QVariantMap());
+
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(!mOfferedTube.isNull());
+
+    // Let's run until we've accepted the tube
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(mOfferedTube->isValid());
+    QCOMPARE(mClientUnixAcceptTube, mOfferedTube);
+    QVERIFY(mClientUnixReqsCreds);
+
+    // The pool connects by itself, with nobody having asked for a connection yet
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mNewClientConnectionTube, mOfferedTube);
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mNewClientConnectionTube, mOfferedTube);
+
+    QHash<StreamTubeClient::Tube, QSet<uint> > conns = client->connections();
+    QCOMPARE(conns.size(), 1);
+    QCOMPARE(conns.values().first().size(), 2);
+    QVERIFY(recorder.fds.isEmpty());
+
+    // Both have sent the credential byte the CM was told about when accepting, as it checks that
+    QCOMPARE(serviceConnections, 2);
+
+    // A pooled connection is handed out right away, connected and ready to use
+    QCOMPARE(client->tubes().size(), 1);
+    QVERIFY(client->requestLocalConnection(client->tubes().first()));
+    QCOMPARE(recorder.fds.size(), 1);
+    QVERIFY(recorder.errors.isEmpty());
+
+    int fd = recorder.fds.first();
+    struct sockaddr_un peer;
+    socklen_t len = sizeof(peer);
+    QCOMPARE(::getpeername(fd, reinterpret_cast<struct sockaddr *>(&peer), &len), 0);
+    QCOMPARE(int(peer.sun_family), int(AF_UNIX));
+    QVERIFY(::fcntl(fd, F_GETFL) & O_NONBLOCK);
+    QCOMPARE(int(::send(fd, "x", 1, 0)), 1);
+
+    // The pool is topped up again in the background
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mNewClientConnectionTube, mOfferedTube);
+    QCOMPARE(client->connections().values().first().size(), 3);
+    QCOMPARE(serviceConnections, 3);
+
+    QVERIFY(client->requestLocalConnection(client->tubes().first()));
+    QCOMPARE(recorder.fds.size(), 2);
+    QVERIFY(recorder.fds[0] != recorder.fds[1]);
+
+    // Don't hand out connections to the recorder going out of scope
+    client->setLocalConnectionPool(0);
+}
+
 void TestStreamTubeHandlers::testClientConnMonitoring()
 {
     StreamTubeClientPtr client =
@@ -1712,6 +2366,12 @@ void TestStreamTubeHandlers::testClientConnMonitoring()
     QVERIFY(client->acceptsAsTcp());
     QVERIFY(client->monitorsConnections());
 
+    QVERIFY(!client->isMetricsEnabled());
+    QVERIFY(!client->metrics().isValid());
+    client->setMetricsReportInterval(0);
+    client->setMetricsEnabled(true);
+    QVERIFY(client->isMetricsEnabled());
+
     QMap<QString, ClientHandlerInterface *> handlers = ourHandlers();
 
     QVERIFY(!handlers.isEmpty());
@@ -1766,6 +2426,27 @@ void TestStreamTubeHandlers::testClientConnMonitoring()
     // Still no connections
     QVERIFY(client->connections().isEmpty());
 
+    // The tube has been set up, but nothing connected through it yet
+    QCOMPARE(client->tubes().size(), 1);
+    StreamTubeClient::Tube tube = client->tubes().first();
+    StreamTubeMetrics metrics = client->metrics(tube);
+    QVERIFY(metrics.isValid());
+    QCOMPARE(metrics.tubeCount(), 1U);
+    qint64 setupLatency = metrics.setupLatency();
+    QVERIFY(setupLatency >= 0);
+    QCOMPARE(histogramTotal(metrics.setupLatencyHistogram()), 1U);
+    QCOMPARE(metrics.setupLatencyHistogram().at(histogramBucket(setupLatency)), 1U);
+    QCOMPARE(metrics.firstConnectionLatency(), qint64(-1));
+    QCOMPARE(histogramTotal(metrics.firstConnectionLatencyHistogram()), 0U);
+    QVERIFY(!metrics.hasByteCounts());
+
+    // With a single tube, the aggregate is that tube
+    metrics = client->metrics();
+    QCOMPARE(metrics.tubeCount(), 1U);
+    QCOMPARE(metrics.setupLatency(), setupLatency);
+    QCOMPARE(metrics.firstConnectionLatency(), qint64(-1));
+    QCOMPARE(metrics.totalConnectionCount(), 0U);
+
     // Now, some connections actually start popping up
     QVERIFY(connect(client.data(),
                 SIGNAL(newConnection(Tp::AccountPtr,Tp::IncomingStreamTubeChannelPtr,uint)),
@@ -1774,6 +2455,9 @@ void TestStreamTubeHandlers::testClientConnMonitoring()
                 SIGNAL(connectionClosed(Tp::AccountPtr,Tp::IncomingStreamTubeChannelPtr,uint,QString,QString)),
                 SLOT(onClientConnectionClosed(Tp::AccountPtr,Tp::IncomingStreamTubeChannelPtr,uint,QString,QString))));
 
+    // Let some time pass, so that the first connection latency is known to be at least that
+    QTest::qWait(60);
+
     QTcpSocket first;
     first.connectToHost(mClientTcpAcceptAddr, mClientTcpAcceptPort);
     first.waitForConnected();
@@ -1790,6 +2474,26 @@ void TestStreamTubeHandlers::testClientConnMonitoring()
     QVERIFY(conns.values().first().contains(mNewClientConnectionId));
     uint firstId = mNewClientConnectionId;
 
+    metrics = client->metrics(tube);
+    qint64 firstConnectionLatency = metrics.firstConnectionLatency();
+    QVERIFY(firstConnectionLatency >= 60);
+    QCOMPARE(histogramTotal(metrics.firstConnectionLatencyHistogram()), 1U);
+    QCOMPARE(metrics.firstConnectionLatencyHistogram().at(
+                histogramBucket(firstConnectionLatency)), 1U);
+    QCOMPARE(metrics.setupLatency(), setupLatency);
+    QCOMPARE(metrics.openConnectionCount(), 1U);
+    QCOMPARE(metrics.totalConnectionCount(), 1U);
+    QCOMPARE(client->metrics().firstConnectionLatency(), firstConnectionLatency);
+
+    // The first connection is the one the first connection latency was measured for
+    StreamTubeConnectionMetrics connMetrics = client->connectionMetrics(tube, firstId);
+    QVERIFY(connMetrics.isValid());
+    QCOMPARE(connMetrics.connectionId(), firstId);
+    QCOMPARE(connMetrics.setupLatency(), firstConnectionLatency);
+    QTest::qWait(30);
+    QVERIFY(client->connectionMetrics(tube, firstId).age() >= 30);
+    QVERIFY(!client->connectionMetrics(tube, firstId + 1000).isValid());
+
     // Now, close the first connection
     tp_tests_stream_tube_channel_last_connection_disconnected(mChanServices.back(),
             TP_ERROR_STR_DISCONNECTED);
@@ -1799,6 +2503,13 @@ void TestStreamTubeHandlers::testClientConnMonitoring()
     QCOMPARE(mClientConnectionCloseError, QString(TP_QT_ERROR_DISCONNECTED));
     QVERIFY(client->connections().isEmpty());
 
+    // Closed connections only count in the totals, and no longer have metrics of their own
+    QVERIFY(!client->connectionMetrics(tube, firstId).isValid());
+    metrics = client->metrics(tube);
+    QCOMPARE(metrics.openConnectionCount(), 0U);
+    QCOMPARE(metrics.totalConnectionCount(), 1U);
+    QCOMPARE(histogramTotal(metrics.connectionLifetimeHistogram()), 1U);
+
     // Fire up two new connections
     QTcpSocket second;
     second.connectToHost(mClientTcpAcceptAddr, mClientTcpAcceptPort);
@@ -1830,6 +2541,13 @@ void TestStreamTubeHandlers::testClientConnMonitoring()
     QVERIFY(conns.values().first().contains(secondId));
     QVERIFY(conns.values().first().contains(thirdId));
 
+    // Later connections don't change the first connection latency
+    QCOMPARE(client->connectionMetrics(tube, secondId).connectionId(), secondId);
+    QVERIFY(client->connectionMetrics(tube, secondId).setupLatency() >= firstConnectionLatency);
+    QCOMPARE(client->metrics(tube).firstConnectionLatency(), firstConnectionLatency);
+    QCOMPARE(client->metrics(tube).openConnectionCount(), 2U);
+    QCOMPARE(client->metrics().totalConnectionCount(), 3U);
+
     // Close one of them, and check that we receive the signal for it
     tp_tests_stream_tube_channel_last_connection_disconnected(mChanServices.back(),
             TP_ERROR_STR_DISCONNECTED);
@@ -1867,12 +2585,123 @@ void TestStreamTubeHandlers::testClientConnMonitoring()
 
     QCOMPARE(mClientClosedTube, mOfferedTube);
     QCOMPARE(mClientCloseError, QString(TP_QT_ERROR_CANCELLED)); // == local close request
+
+    // The totals survive the tube, whose own metrics are gone with it
+    QVERIFY(!client->metrics(tube).isValid());
+    metrics = client->metrics();
+    QCOMPARE(metrics.tubeCount(), 1U);
+    QCOMPARE(metrics.setupLatency(), setupLatency);
+    QCOMPARE(metrics.firstConnectionLatency(), firstConnectionLatency);
+    QCOMPARE(metrics.openConnectionCount(), 0U);
+    QCOMPARE(metrics.totalConnectionCount(), 3U);
+    QCOMPARE(histogramTotal(metrics.connectionLifetimeHistogram()), 3U);
+    QVERIFY(!metrics.hasByteCounts());
+
+    // Disabling metrics discards them
+    client->setMetricsEnabled(false);
+    QVERIFY(!client->metrics().isValid());
+    QVERIFY(mMetricsReports.isEmpty());
+}
+
+void TestStreamTubeHandlers::testClientMetricsReports()
+{
+    StreamTubeClientPtr client =
+        StreamTubeClient::create(QStringList() << QLatin1String("ftp"), QStringList(),
+                QLatin1String("ncftp"), true);
+
+    client->setToAcceptAsTcp();
+    QVERIFY(client->isRegistered());
+
+    QCOMPARE(client->metricsReportInterval(), 1000);
+    client->setMetricsReportInterval(-5);
+    QCOMPARE(client->metricsReportInterval(), 0);
+    client->setMetricsReportInterval(500);
+    QCOMPARE(client->metricsReportInterval(), 500);
+
+    QVERIFY(connect(client.data(),
+                SIGNAL(metricsUpdated(Tp::StreamTubeMetrics)),
+                SLOT(onMetricsUpdated(Tp::StreamTubeMetrics))));
+    client->setMetricsEnabled(true);
+    QCOMPARE(client->metricsReportInterval(), 500);
+
+    QMap<QString, ClientHandlerInterface *> handlers = ourHandlers();
+
+    QVERIFY(!handlers.isEmpty());
+    ClientHandlerInterface *handler = handlers.value(client->clientName());
+    QVERIFY(handler != 0);
+
+    QPair<QString, QVariantMap> chan = createTubeChannel(false, HandleTypeContact, true);
+
+    QVERIFY(connect(client.data(),
+                SIGNAL(tubeOffered(Tp::AccountPtr,Tp::IncomingStreamTubeChannelPtr)),
+                SLOT(onTubeOffered(Tp::AccountPtr,Tp::IncomingStreamTubeChannelPtr))));
+    QVERIFY(connect(client.data(),
+                SIGNAL(tubeAcceptedAsTcp(QHostAddress,quint16,QHostAddress,quint16,
+                        Tp::AccountPtr,Tp::IncomingStreamTubeChannelPtr)),
+                SLOT(onClientAcceptedAsTcp(QHostAddress,quint16,QHostAddress,quint16,
+                        Tp::AccountPtr,Tp::IncomingStreamTubeChannelPtr))));
+    QVERIFY(connect(client.data(),
+                SIGNAL(newConnection(Tp::AccountPtr,Tp::IncomingStreamTubeChannelPtr,uint)),
+                SLOT(onNewClientConnection(Tp::AccountPtr,Tp::IncomingStreamTubeChannelPtr,uint))));
+
+    ChannelDetails details = { QDBusObjectPath(chan.first), chan.second };
+    handler->HandleChannels(
+            QDBusObjectPath(mAcc->objectPath()),
+            QDBusObjectPath(mConn->objectPath()),
+            ChannelDetailsList() << details,
+            ObjectPathList(),
+            QDateTime::currentDateTime().toTime_t(),
+            QVariantMap());
+
+    // Offering and accepting the tube and connecting through it are all well within the interval
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(!mOfferedTube.isNull());
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mClientTcpAcceptTube, mOfferedTube);
+
+    QTcpSocket first;
+    first.connectToHost(mClientTcpAcceptAddr, mClientTcpAcceptPort);
+    first.waitForConnected();
+    QCOMPARE(first.state(), QAbstractSocket::ConnectedState);
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mNewClientConnectionTube, mOfferedTube);
+
+    // The changes are coalesced into a single report once the interval has passed
+    QVERIFY(mMetricsReports.isEmpty());
+    for (int i = 0; i < 200 && mMetricsReports.isEmpty(); ++i) {
+        QTest::qWait(10);
+    }
+    QCOMPARE(mMetricsReports.size(), 1);
+    StreamTubeMetrics report = mMetricsReports.first();
+    QVERIFY(report.isValid());
+    QCOMPARE(report.tubeCount(), 1U);
+    QVERIFY(report.setupLatency() >= 0);
+    QVERIFY(report.firstConnectionLatency() >= 0);
+    QCOMPARE(report.openConnectionCount(), 1U);
+    QCOMPARE(report.totalConnectionCount(), 1U);
+
+    // Without changes, there is nothing to report
+    QTest::qWait(600);
+    QCOMPARE(mMetricsReports.size(), 1);
+
+    // A zero interval turns the reports off, while metrics keep being collected
+    client->setMetricsReportInterval(0);
+    QTcpSocket second;
+    second.connectToHost(mClientTcpAcceptAddr, mClientTcpAcceptPort);
+    second.waitForConnected();
+    QCOMPARE(second.state(), QAbstractSocket::ConnectedState);
+    QCOMPARE(mLoop->exec(), 0);
+    QTest::qWait(600);
+    QCOMPARE(mMetricsReports.size(), 1);
+    QCOMPARE(client->metrics().totalConnectionCount(), 2U);
 }
 
 void TestStreamTubeHandlers::cleanup()
 {
     cleanupImpl();
 
+    mMetricsReports.clear();
+
     mRequestHints = ChannelRequestHints();
 
     if (mRequestedTube && mRequestedTube->isValid()) {
@@ -1892,6 +2721,10 @@ void TestStreamTubeHandlers::cleanup()
     mClosedServerConnectionContact.reset();
     mNewServerConnectionTube.reset();
     mServerConnectionCloseTube.reset();
+    mOpenedServerConnectionTube.reset();
+    mClosedServerConnectionIdTube.reset();
+    mOpenedServerConnectionContact.reset();
+    mClosedServerConnectionIdContact.reset();
 
     if (mOfferedTube && mOfferedTube->isValid()) {
         qDebug() << "waiting for the ofrd tube to become invalidated";
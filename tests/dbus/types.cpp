@@ -6,6 +6,67 @@
 
 using namespace Tp;
 
+namespace
+{
+
+const uint numContacts = 1000;
+const uint numMessageParts = 200;
+
+ContactAttributesMap contactAttributes()
+{
+    ContactAttributesMap ret;
+    for (uint handle = 1; handle <= numContacts; ++handle) {
+        QVariantMap attributes;
+        attributes.insert(TP_QT_IFACE_CONNECTION + QLatin1String("/contact-id"),
+                QString(QLatin1String("contact%1@example.com")).arg(handle));
+        attributes.insert(TP_QT_IFACE_CONNECTION_INTERFACE_ALIASING + QLatin1String("/alias"),
+                QString(QLatin1String("Contact %1")).arg(handle));
+        attributes.insert(TP_QT_IFACE_CONNECTION_INTERFACE_AVATARS + QLatin1String("/token"),
+                QString::number(handle, 16));
+        ret.insert(handle, attributes);
+    }
+    return ret;
+}
+
+SimpleContactPresences presences()
+{
+    SimpleContactPresences ret;
+    for (uint handle = 1; handle <= numContacts; ++handle) {
+        SimplePresence presence;
+        presence.type = ConnectionPresenceTypeAvailable;
+        presence.status = QLatin1String("available");
+        presence.statusMessage = QString(QLatin1String("Status of contact %1")).arg(handle);
+        ret.insert(handle, presence);
+    }
+    return ret;
+}
+
+MessagePartList messageParts()
+{
+    MessagePartList ret;
+    for (uint i = 0; i < numMessageParts; ++i) {
+        MessagePart part;
+        part.insert(QLatin1String("content-type"),
+                QDBusVariant(QLatin1String("text/plain")));
+        part.insert(QLatin1String("alternative"),
+                QDBusVariant(QString::number(i)));
+        part.insert(QLatin1String("content"),
+                QDBusVariant(QString(QLatin1String("Part %1 of the message")).arg(i)));
+        ret.append(part);
+    }
+    return ret;
+}
+
+template<typename T>
+T demarshal(const QVariant &value)
+{
+    T ret;
+    qvariant_cast<QDBusArgument>(value) >> ret;
+    return ret;
+}
+
+}
+
 /* We need a interface returning a QVariantMap property where we will insert the various
  * combinations we are testing, so let's use Channel.Tube for that as we already have the
  * autogenerated interface for it */
@@ -43,6 +104,10 @@ public: // Properties
         ret.insert(QLatin1String("saIPv4"), qVariantFromValue(saIPv4));
         ret.insert(QLatin1String("saIPv6"), qVariantFromValue(saIPv6));
 
+        ret.insert(QLatin1String("ContactAttributes"), qVariantFromValue(contactAttributes()));
+        ret.insert(QLatin1String("Presences"), qVariantFromValue(presences()));
+        ret.insert(QLatin1String("MessageParts"), qVariantFromValue(messageParts()));
+
         return ret;
     }
 };
@@ -63,6 +128,7 @@ private Q_SLOTS:
     void init();
 
     void testParameters();
+    void testFastDemarshallers();
 
     void cleanup();
     void cleanupTestCase();
@@ -127,6 +193,39 @@ void TestTypes::testParameters()
     QCOMPARE(saIPv6.port, static_cast<ushort>(3333));
 }
 
+void TestTypes::testFastDemarshallers()
+{
+    // The specialized demarshallers must give the same results as the generic
+    // QtDBus ones
+    QVariant value = mParameters.value(QLatin1String("ContactAttributes"));
+    ContactAttributesMap attributes = demarshal<ContactAttributesMap>(value);
+    QCOMPARE(attributes.size(), static_cast<int>(numContacts));
+    QVERIFY(attributes == contactAttributes());
+    QVERIFY(attributes == demarshal<QMap<uint, QVariantMap> >(value));
+
+    value = mParameters.value(QLatin1String("Presences"));
+    SimpleContactPresences contactPresences = demarshal<SimpleContactPresences>(value);
+    QCOMPARE(contactPresences.size(), static_cast<int>(numContacts));
+    QVERIFY(contactPresences == presences());
+    QVERIFY(contactPresences == demarshal<QMap<uint, SimplePresence> >(value));
+
+    value = mParameters.value(QLatin1String("MessageParts"));
+    MessagePartList parts = demarshal<MessagePartList>(value);
+    QList<QMap<QString, QDBusVariant> > genericParts =
+        demarshal<QList<QMap<QString, QDBusVariant> > >(value);
+    MessagePartList expectedParts = messageParts();
+    QCOMPARE(parts.size(), static_cast<int>(numMessageParts));
+    QCOMPARE(genericParts.size(), parts.size());
+    for (int i = 0; i < parts.size(); ++i) {
+        QCOMPARE(parts[i].keys(), expectedParts[i].keys());
+        QCOMPARE(genericParts[i].keys(), parts[i].keys());
+        foreach (const QString &key, parts[i].keys()) {
+            QCOMPARE(parts[i].value(key).variant(), expectedParts[i].value(key).variant());
+            QCOMPARE(genericParts[i].value(key).variant(), parts[i].value(key).variant());
+        }
+    }
+}
+
 void TestTypes::cleanup()
 {
     cleanupImpl();
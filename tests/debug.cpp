@@ -0,0 +1,201 @@
+#include <QtTest/QtTest>
+
+#include <TelepathyQt/Debug>
+#include <TelepathyQt/Feature>
+#include <TelepathyQt/PendingReady>
+#include <TelepathyQt/PendingSuccess>
+#include <TelepathyQt/Profile>
+#include <TelepathyQt/ReadinessHelper>
+
+using namespace Tp;
+
+namespace {
+
+QStringList messages;
+QList<QtMsgType> messageTypes;
+
+void collectMessage(const QString &libraryName, const QString &libraryVersion,
+        QtMsgType type, const QString &msg)
+{
+    Q_UNUSED(libraryName);
+    Q_UNUSED(libraryVersion);
+    messages << msg;
+    messageTypes << type;
+}
+
+bool hasMessage(const QString &text)
+{
+    foreach (const QString &msg, messages) {
+        if (msg.contains(text)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Profile lookups log to the tp-qt.connections category, and missing services don't hit the disk
+// cache, so this is a cheap way to make the library produce debug output in a known category
+void lookupMissingProfile()
+{
+    Profile::createForServiceName(QLatin1String("debug-test-nonexistent"));
+}
+
+Feature testFeature()
+{
+    return Feature(QLatin1String("TestDebugObject"), 7);
+}
+
+void introspectTestFeature(void *data)
+{
+    static_cast<ReadinessHelper *>(data)->setIntrospectCompleted(testFeature(), true);
+}
+
+}
+
+class TestDebug : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestDebug(QObject *parent = 0);
+
+private Q_SLOTS:
+    void init();
+
+    void testCategories();
+    void testTrace();
+
+    void cleanup();
+};
+
+TestDebug::TestDebug(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void TestDebug::init()
+{
+    messages.clear();
+    messageTypes.clear();
+    Tp::setDebugCallback(collectMessage);
+}
+
+void TestDebug::testCategories()
+{
+    QStringList categories = Tp::debugCategories();
+    QVERIFY(categories.contains(QLatin1String("tp-qt")));
+    QVERIFY(categories.contains(QLatin1String("tp-qt.contacts")));
+    QVERIFY(categories.contains(QLatin1String("tp-qt.tubes")));
+
+#ifdef ENABLE_DEBUG
+    Tp::enableDebug(false);
+    Tp::enableWarnings(false);
+    lookupMissingProfile();
+    QCOMPARE(messages, QStringList());
+
+    // Enabling a single category makes its debug output come through
+    Tp::enableCategoryDebug(QLatin1String("tp-qt.connections"), true);
+    lookupMissingProfile();
+    QVERIFY(hasMessage(QLatin1String("Searching profile for service")));
+    QVERIFY(!messageTypes.contains(QtWarningMsg));
+
+    // Other categories don't affect it
+    messages.clear();
+    messageTypes.clear();
+    Tp::enableCategoryDebug(QLatin1String("tp-qt.connections"), false);
+    Tp::enableCategoryDebug(QLatin1String("tp-qt.contacts"), true);
+    lookupMissingProfile();
+    QCOMPARE(messages, QStringList());
+
+    // Unknown categories are reported and ignored, without enabling anything else
+    Tp::enableDebug(false);
+    Tp::enableWarnings(true);
+    Tp::enableCategoryDebug(QLatin1String("tp-qt.nonexistent"), true);
+    QCOMPARE(messages.size(), 1);
+    QCOMPARE(messageTypes.first(), QtWarningMsg);
+    QVERIFY(messages.first().contains(QLatin1String("Unknown debug category")));
+    QVERIFY(messages.first().contains(QLatin1String("tp-qt.nonexistent")));
+
+    messages.clear();
+    messageTypes.clear();
+    lookupMissingProfile();
+    QCOMPARE(messages, QStringList());
+
+    // Trying to disable the warnings of an unknown category doesn't disable the general ones
+    Tp::enableCategoryWarnings(QLatin1String("tp-qt.nonexistent"), false);
+    Tp::enableCategoryWarnings(QLatin1String("tp-qt.nonexistent"), false);
+    QCOMPARE(messages.size(), 2);
+    QCOMPARE(messageTypes, QList<QtMsgType>() << QtWarningMsg << QtWarningMsg);
+#endif
+}
+
+void TestDebug::testTrace()
+{
+#ifdef ENABLE_DEBUG
+    Tp::enableDebug(false);
+    Tp::enableTracing(true);
+
+    PendingOperation *op = new PendingSuccess(SharedPtr<RefCounted>());
+    Tp::enableTracing(false);
+
+    // Disabling tracing keeps the recorded events
+    PendingOperation *untracedOp = new PendingSuccess(SharedPtr<RefCounted>());
+
+    Tp::dumpTrace();
+    QVERIFY(!messages.isEmpty());
+    QVERIFY(messages.first().contains(QLatin1String("1 of 1")));
+    QCOMPARE(messages.size(), 2);
+    QVERIFY(messages.last().contains(QLatin1String("PendingOperation finished")));
+
+    delete op;
+    delete untracedOp;
+
+    // Feature introspection records say which feature they are about
+    SharedPtr<RefCounted> object(new RefCounted);
+    ReadinessHelper *helper = new ReadinessHelper(object.data());
+    ReadinessHelper::Introspectables introspectables;
+    introspectables[testFeature()] = ReadinessHelper::Introspectable(
+            QSet<uint>() << 0, Features(), QStringList(), introspectTestFeature, helper);
+    helper->addIntrospectables(introspectables);
+
+    Tp::enableTracing(true);
+    PendingReady *ready = helper->becomeReady(Features() << testFeature());
+    QEventLoop loop;
+    connect(ready, SIGNAL(finished(Tp::PendingOperation*)), &loop, SLOT(quit()));
+    loop.exec();
+    Tp::enableTracing(false);
+    QVERIFY(helper->isReady(testFeature()));
+
+    messages.clear();
+    Tp::dumpTrace();
+    bool found = false;
+    foreach (const QString &msg, messages) {
+        if (msg.contains(QLatin1String("Feature introspection completed"))) {
+            QVERIFY(msg.contains(QLatin1String(" 7 TestDebugObject")));
+            found = true;
+        }
+    }
+    QVERIFY(found);
+
+    // Restarting tracing forgets the events of the previous session
+    Tp::enableTracing(true);
+    Tp::enableTracing(false);
+    messages.clear();
+    Tp::dumpTrace();
+    QCOMPARE(messages.size(), 1);
+    QVERIFY(messages.first().contains(QLatin1String("0 of 0")));
+
+    delete helper;
+#endif
+}
+
+void TestDebug::cleanup()
+{
+    Tp::enableDebug(false);
+    Tp::enableWarnings(true);
+    Tp::setDebugCallback(0);
+}
+
+QTEST_MAIN(TestDebug)
+
+#include "_gen/debug.cpp.moc.hpp"
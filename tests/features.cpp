@@ -29,6 +29,7 @@ public:
 
 private Q_SLOTS:
     void testFeaturesHash();
+    void testFeatureAssignment();
 };
 
 TestFeatures::TestFeatures(QObject *parent)
@@ -68,6 +69,25 @@ void TestFeatures::testFeaturesHash()
     QVERIFY(qHash(fs1.toSet()) != qHash(fs2.toSet()));
 }
 
+void TestFeatures::testFeatureAssignment()
+{
+    Feature critical(QLatin1String("Foo"), 1, true);
+    Feature feature;
+    QVERIFY(!feature.isValid());
+    QVERIFY(!feature.isCritical());
+
+    feature = critical;
+    QVERIFY(feature.isValid());
+    QVERIFY(feature.isCritical());
+    QCOMPARE(feature, critical);
+
+    feature = Feature(QLatin1String("Foo"), 2);
+    QVERIFY(!feature.isCritical());
+    QVERIFY(feature != critical);
+    QCOMPARE(feature.first, QLatin1String("Foo"));
+    QCOMPARE(feature.second, 2U);
+}
+
 QTEST_MAIN(TestFeatures)
 
 #include "_gen/features.cpp.moc.hpp"
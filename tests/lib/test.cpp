@@ -2,6 +2,7 @@
 
 #include <cstdlib>
 
+#include <QtCore/QTemporaryDir>
 #include <QtCore/QTimer>
 
 #include <TelepathyQt/Types>
@@ -16,7 +17,7 @@ using Tp::PendingVoid;
 using Tp::Client::DBus::PeerInterface;
 
 Test::Test(QObject *parent)
-    : QObject(parent), mLoop(new QEventLoop(this))
+    : QObject(parent), mLoop(new QEventLoop(this)), mCacheDir(0)
 {
     QTimer::singleShot(10 * 60 * 1000, this, SLOT(onWatchdog()));
 }
@@ -24,6 +25,7 @@ Test::Test(QObject *parent)
 Test::~Test()
 {
     delete mLoop;
+    delete mCacheDir;
 }
 
 void Test::initTestCaseImpl()
@@ -32,6 +34,11 @@ void Test::initTestCaseImpl()
     Tp::enableDebug(true);
     Tp::enableWarnings(true);
 
+    mCacheDir = new QTemporaryDir();
+    QVERIFY(mCacheDir->isValid());
+    mOldCacheHome = qgetenv("XDG_CACHE_HOME");
+    qputenv("XDG_CACHE_HOME", QFile::encodeName(mCacheDir->path()));
+
     QVERIFY(QDBusConnection::sessionBus().isConnected());
 }
 
@@ -45,8 +52,15 @@ void Test::cleanupImpl()
 
 void Test::cleanupTestCaseImpl()
 {
-    // To allow for cleanup code to run (e.g. PendingOperation cleanup after they finish)
+    // To allow for cleanup code to run (e.g. PendingOperation cleanup after they finish),
+    // which also writes back the changes made to the parsed file caches
     mLoop->processEvents();
+
+    if (mOldCacheHome.isEmpty()) {
+        qunsetenv("XDG_CACHE_HOME");
+    } else {
+        qputenv("XDG_CACHE_HOME", mOldCacheHome);
+    }
 }
 
 void Test::expectSuccessfulCall(PendingOperation *op)
@@ -4,6 +4,8 @@
 #include <QtDBus>
 #include <QtTest>
 
+class QTemporaryDir;
+
 #include <TelepathyQt/PendingOperation>
 #include <TelepathyQt/PendingVariant>
 #include <TelepathyQt/Constants>
@@ -49,6 +51,10 @@ protected Q_SLOTS:
 private:
     // The property retrieved by expectSuccessfulProperty()
     QVariant mPropertyValue;
+
+    // Keeps the caches written by the library out of the user's cache directory
+    QTemporaryDir *mCacheDir;
+    QByteArray mOldCacheHome;
 };
 
 template<typename T>
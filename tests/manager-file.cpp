@@ -3,6 +3,9 @@
 #include <TelepathyQt/Constants>
 #include <TelepathyQt/Debug>
 #include "TelepathyQt/manager-file.h"
+#include "TelepathyQt/parsed-file-cache-internal.h"
+
+#include <QTemporaryDir>
 
 using namespace Tp;
 
@@ -49,7 +52,15 @@ public:
     TestManagerFile(QObject *parent = 0);
 
 private Q_SLOTS:
+    void initTestCase();
+
     void testManagerFile();
+
+    void cleanupTestCase();
+
+private:
+    QTemporaryDir mCacheDir;
+    QByteArray mOldCacheHome;
 };
 
 TestManagerFile::TestManagerFile(QObject *parent)
@@ -227,6 +238,25 @@ void TestManagerFile::testManagerFile()
              QStringList() << QString());
 }
 
+void TestManagerFile::initTestCase()
+{
+    // Keep the parsed file cache out of the user's cache directory
+    QVERIFY(mCacheDir.isValid());
+    mOldCacheHome = qgetenv("XDG_CACHE_HOME");
+    qputenv("XDG_CACHE_HOME", QFile::encodeName(mCacheDir.path()));
+}
+
+void TestManagerFile::cleanupTestCase()
+{
+    ParsedFileCache::managers()->save();
+
+    if (mOldCacheHome.isEmpty()) {
+        qunsetenv("XDG_CACHE_HOME");
+    } else {
+        qputenv("XDG_CACHE_HOME", mOldCacheHome);
+    }
+}
+
 QTEST_MAIN(TestManagerFile)
 
 #include "_gen/manager-file.cpp.moc.hpp"
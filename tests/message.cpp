@@ -0,0 +1,281 @@
+#include <QtTest/QtTest>
+
+#include <TelepathyQt/Constants>
+#include <TelepathyQt/Debug>
+#include <TelepathyQt/Message>
+#include <TelepathyQt/ReceivedMessage>
+#include <TelepathyQt/Types>
+
+#include "TelepathyQt/test-backdoors.h"
+
+using namespace Tp;
+
+class TestMessage : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestMessage(QObject *parent = 0);
+
+private Q_SLOTS:
+    void testTextMessage();
+    void testTextMessageParts();
+    void testTimestampMessage();
+    void testParseBody_data();
+    void testParseBody();
+    void testReceivedMessage();
+    void testReceivedMessageTimestamp();
+};
+
+namespace
+{
+
+MessagePart textPart(const QString &text, const QString &alternative = QString())
+{
+    MessagePart part;
+    part.insert(QLatin1String("content-type"), QDBusVariant(QLatin1String("text/plain")));
+    part.insert(QLatin1String("content"), QDBusVariant(text));
+    if (!alternative.isEmpty()) {
+        part.insert(QLatin1String("alternative"), QDBusVariant(alternative));
+    }
+    return part;
+}
+
+MessagePart htmlPart(const QString &html, const QString &alternative = QString())
+{
+    MessagePart part;
+    part.insert(QLatin1String("content-type"), QDBusVariant(QLatin1String("text/html")));
+    part.insert(QLatin1String("content"), QDBusVariant(html));
+    if (!alternative.isEmpty()) {
+        part.insert(QLatin1String("alternative"), QDBusVariant(alternative));
+    }
+    return part;
+}
+
+MessagePart headerPart()
+{
+    MessagePart header;
+    header.insert(QLatin1String("message-type"),
+            QDBusVariant(static_cast<uint>(ChannelTextMessageTypeNormal)));
+    return header;
+}
+
+}
+
+TestMessage::TestMessage(QObject *parent)
+    : QObject(parent)
+{
+    Tp::enableDebug(true);
+    Tp::enableWarnings(true);
+}
+
+void TestMessage::testTextMessage()
+{
+    Message m(ChannelTextMessageTypeAction, QLatin1String("waves"));
+
+    QCOMPARE(m.messageType(), ChannelTextMessageTypeAction);
+    QCOMPARE(m.text(), QString(QLatin1String("waves")));
+    QCOMPARE(m.sentTimestamp(), 0U);
+    QVERIFY(!m.sent().isValid());
+    QVERIFY(m.messageToken().isEmpty());
+    QVERIFY(!m.isSpecificToDBusInterface());
+    QVERIFY(!m.isTruncated());
+    QVERIFY(!m.hasNonTextContent());
+    QCOMPARE(m.size(), 2);
+
+    Message copy(m);
+    QVERIFY(copy == m);
+    QCOMPARE(copy.text(), m.text());
+}
+
+void TestMessage::testTextMessageParts()
+{
+    Message m(ChannelTextMessageTypeNormal, QLatin1String("hello"));
+
+    MessagePartList parts = m.parts();
+    QCOMPARE(parts.size(), 2);
+
+    QVERIFY(!parts[0].contains(QLatin1String("message-sent")));
+    QCOMPARE(parts[0].value(QLatin1String("message-type")).variant().toUInt(),
+            static_cast<uint>(ChannelTextMessageTypeNormal));
+
+    QCOMPARE(parts[1].value(QLatin1String("content-type")).variant().toString(),
+            QString(QLatin1String("text/plain")));
+    QCOMPARE(parts[1].value(QLatin1String("content")).variant().toString(),
+            QString(QLatin1String("hello")));
+
+    QCOMPARE(m.header().keys(), parts[0].keys());
+    QCOMPARE(m.part(1).value(QLatin1String("content")).variant().toString(),
+            QString(QLatin1String("hello")));
+    QVERIFY(m.forwardedHeader().isEmpty());
+}
+
+void TestMessage::testTimestampMessage()
+{
+    Message m = TestBackdoors::createMessage(1234567890U,
+            static_cast<uint>(ChannelTextMessageTypeNotice), QLatin1String("hi"));
+
+    QCOMPARE(m.messageType(), ChannelTextMessageTypeNotice);
+    QCOMPARE(m.text(), QString(QLatin1String("hi")));
+    QCOMPARE(m.sentTimestamp(), 1234567890U);
+    QCOMPARE(m.sent().toTime_t(), 1234567890U);
+    QVERIFY(!m.hasNonTextContent());
+    QCOMPARE(m.size(), 2);
+
+    // The parts are built from the typed fields, including the sent timestamp
+    MessagePart header = m.header();
+    QVERIFY(header.contains(QLatin1String("message-sent")));
+    QCOMPARE(header.value(QLatin1String("message-sent")).variant().toUInt(), 1234567890U);
+    QCOMPARE(header.value(QLatin1String("message-type")).variant().toUInt(),
+            static_cast<uint>(ChannelTextMessageTypeNotice));
+
+    // ... once, and the same parts are returned afterwards, also by the copies
+    Message copy(m);
+    QCOMPARE(copy.parts().size(), 2);
+    QCOMPARE(copy.header().keys(), header.keys());
+    QCOMPARE(m.part(0).keys(), header.keys());
+    QCOMPARE(copy.part(1).value(QLatin1String("content")).variant().toString(),
+            QString(QLatin1String("hi")));
+}
+
+void TestMessage::testParseBody_data()
+{
+    QTest::addColumn<MessagePartList>("parts");
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<bool>("nonText");
+    QTest::addColumn<bool>("truncated");
+
+    QTest::newRow("header only") << (MessagePartList() << headerPart())
+        << QString() << true << false;
+
+    QTest::newRow("text parts") << (MessagePartList() << headerPart()
+            << textPart(QLatin1String("Hello, ")) << textPart(QLatin1String("world")))
+        << QString(QLatin1String("Hello, world")) << false << false;
+
+    // Only the first text/plain alternative of a group is used, and the HTML one is
+    // rescued by it
+    QTest::newRow("alternative group") << (MessagePartList() << headerPart()
+            << htmlPart(QLatin1String("<b>bold</b>"), QLatin1String("main"))
+            << textPart(QLatin1String("bold"), QLatin1String("main"))
+            << textPart(QLatin1String("*bold*"), QLatin1String("main")))
+        << QString(QLatin1String("bold")) << false << false;
+
+    QTest::newRow("alternative group without text") << (MessagePartList() << headerPart()
+            << htmlPart(QLatin1String("<b>bold</b>"), QLatin1String("main"))
+            << textPart(QLatin1String("plain"), QLatin1String("other")))
+        << QString(QLatin1String("plain")) << true << false;
+
+    MessagePart image;
+    image.insert(QLatin1String("content-type"), QDBusVariant(QLatin1String("image/png")));
+    image.insert(QLatin1String("content"), QDBusVariant(QByteArray("\x89PNG")));
+    QTest::newRow("non-text part") << (MessagePartList() << headerPart()
+            << textPart(QLatin1String("look: ")) << image)
+        << QString(QLatin1String("look: ")) << true << false;
+
+    MessagePart specific = textPart(QLatin1String("not for display"));
+    specific.insert(QLatin1String("interface"),
+            QDBusVariant(QLatin1String("org.example.Interface")));
+    QTest::newRow("interface-specific part") << (MessagePartList() << headerPart()
+            << textPart(QLatin1String("shown")) << specific)
+        << QString(QLatin1String("shown")) << false << false;
+
+    MessagePart truncated = textPart(QLatin1String("cut sh"));
+    truncated.insert(QLatin1String("truncated"), QDBusVariant(true));
+    QTest::newRow("truncated part") << (MessagePartList() << headerPart() << truncated)
+        << QString(QLatin1String("cut sh")) << false << true;
+}
+
+void TestMessage::testParseBody()
+{
+    QFETCH(MessagePartList, parts);
+    QFETCH(QString, text);
+    QFETCH(bool, nonText);
+    QFETCH(bool, truncated);
+
+    Message m = TestBackdoors::createMessage(parts);
+
+    QCOMPARE(m.text(), text);
+    QCOMPARE(m.hasNonTextContent(), nonText);
+    QCOMPARE(m.isTruncated(), truncated);
+    QVERIFY(!m.isSpecificToDBusInterface());
+
+    // Messages created from parts return them unchanged
+    QCOMPARE(m.size(), parts.size());
+    for (int i = 0; i < parts.size(); ++i) {
+        QCOMPARE(m.part(i).keys(), parts[i].keys());
+        QCOMPARE(m.part(i).value(QLatin1String("content")).variant(),
+                parts[i].value(QLatin1String("content")).variant());
+    }
+}
+
+void TestMessage::testReceivedMessage()
+{
+    MessagePart header;
+    header.insert(QLatin1String("message-sent"), QDBusVariant(static_cast<qlonglong>(1000)));
+    header.insert(QLatin1String("message-received"), QDBusVariant(static_cast<qlonglong>(2000)));
+    header.insert(QLatin1String("message-type"),
+            QDBusVariant(static_cast<uint>(ChannelTextMessageTypeAction)));
+    header.insert(QLatin1String("message-token"), QDBusVariant(QLatin1String("token-1")));
+    header.insert(QLatin1String("message-sender"), QDBusVariant(42U));
+    header.insert(QLatin1String("message-sender-id"), QDBusVariant(QLatin1String("bob@example.com")));
+    header.insert(QLatin1String("pending-message-id"), QDBusVariant(7U));
+    header.insert(QLatin1String("sender-nickname"), QDBusVariant(QLatin1String("Bob")));
+    header.insert(QLatin1String("supersedes"), QDBusVariant(QLatin1String("token-0")));
+    header.insert(QLatin1String("scrollback"), QDBusVariant(true));
+    header.insert(QLatin1String("rescued"), QDBusVariant(true));
+    header.insert(QLatin1String("interface"), QDBusVariant(QLatin1String("org.example.Interface")));
+
+    ReceivedMessage m = TestBackdoors::createReceivedMessage(MessagePartList()
+            << header << textPart(QLatin1String("waves")));
+
+    QCOMPARE(m.sentTimestamp(), 1000U);
+    QCOMPARE(m.receivedTimestamp(), 2000U);
+    QCOMPARE(m.received().toTime_t(), 2000U);
+    QCOMPARE(m.messageType(), ChannelTextMessageTypeAction);
+    QCOMPARE(m.messageToken(), QString(QLatin1String("token-1")));
+    QCOMPARE(TestBackdoors::receivedMessageSenderHandle(m), 42U);
+    QCOMPARE(TestBackdoors::receivedMessageSenderId(m), QString(QLatin1String("bob@example.com")));
+    QCOMPARE(TestBackdoors::receivedMessagePendingId(m), 7U);
+    QCOMPARE(m.senderNickname(), QString(QLatin1String("Bob")));
+    QCOMPARE(m.supersededToken(), QString(QLatin1String("token-0")));
+    QVERIFY(m.isScrollback());
+    QVERIFY(m.isRescued());
+    QVERIFY(!m.isDeliveryReport());
+    QCOMPARE(m.text(), QString(QLatin1String("waves")));
+
+    // A message specific to an interface is never plain text
+    QVERIFY(m.isSpecificToDBusInterface());
+    QCOMPARE(m.dbusInterface(), QString(QLatin1String("org.example.Interface")));
+    QVERIFY(m.hasNonTextContent());
+
+    // Absent fields have their defaults
+    ReceivedMessage plain = TestBackdoors::createReceivedMessage(MessagePartList()
+            << headerPart() << textPart(QLatin1String("hi")));
+    QVERIFY(!plain.sent().isValid());
+    QCOMPARE(TestBackdoors::receivedMessageSenderHandle(plain), 0U);
+    QVERIFY(TestBackdoors::receivedMessageSenderId(plain).isEmpty());
+    QVERIFY(plain.senderNickname().isEmpty());
+    QVERIFY(plain.supersededToken().isEmpty());
+    QVERIFY(!plain.isScrollback());
+    QVERIFY(!plain.isRescued());
+    QVERIFY(!plain.hasNonTextContent());
+}
+
+void TestMessage::testReceivedMessageTimestamp()
+{
+    uint before = QDateTime::currentDateTime().toTime_t();
+    ReceivedMessage m = TestBackdoors::createReceivedMessage(MessagePartList()
+            << headerPart() << textPart(QLatin1String("hi")));
+    uint after = QDateTime::currentDateTime().toTime_t();
+
+    // Messages without a received timestamp get the current time, in the typed field and
+    // in the header
+    QVERIFY(m.receivedTimestamp() >= before);
+    QVERIFY(m.receivedTimestamp() <= after);
+    QCOMPARE(m.header().value(QLatin1String("message-received")).variant().toUInt(),
+            m.receivedTimestamp());
+}
+
+QTEST_MAIN(TestMessage)
+
+#include "_gen/message.cpp.moc.hpp"
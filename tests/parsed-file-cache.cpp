@@ -0,0 +1,285 @@
+#include <QtTest/QtTest>
+
+#include <TelepathyQt/Debug>
+#include "TelepathyQt/parsed-file-cache-internal.h"
+
+#include <QTemporaryDir>
+
+#include <utime.h>
+
+using namespace Tp;
+
+class TestParsedFileCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestParsedFileCache(QObject *parent = 0);
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+
+    void testRoundTrip();
+    void testStaleEntries();
+    void testStaleDirectory();
+    void testCorruptFile();
+    void testTruncatedFile();
+    void testVersionMismatch();
+    void testSaveLater();
+
+    void cleanupTestCase();
+
+private:
+    QString sourceFileName(const QString &name) const;
+    void writeSource(const QString &name, const QByteArray &contents, time_t mtime);
+    void setModificationTime(const QString &fileName, time_t mtime);
+
+    QTemporaryDir mDir;
+    QByteArray mOldCacheHome;
+};
+
+TestParsedFileCache::TestParsedFileCache(QObject *parent)
+    : QObject(parent)
+{
+    Tp::enableDebug(true);
+    Tp::enableWarnings(true);
+}
+
+QString TestParsedFileCache::sourceFileName(const QString &name) const
+{
+    return mDir.path() + QLatin1String("/sources/") + name;
+}
+
+void TestParsedFileCache::writeSource(const QString &name, const QByteArray &contents,
+        time_t mtime)
+{
+    QFile file(sourceFileName(name));
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(file.write(contents), (qint64) contents.size());
+    file.close();
+    setModificationTime(file.fileName(), mtime);
+}
+
+void TestParsedFileCache::setModificationTime(const QString &fileName, time_t mtime)
+{
+    // Don't rely on the file system having a fine-grained modification time
+    struct utimbuf times;
+    times.actime = mtime;
+    times.modtime = mtime;
+    QCOMPARE(::utime(QFile::encodeName(fileName).constData(), &times), 0);
+}
+
+void TestParsedFileCache::initTestCase()
+{
+    QVERIFY(mDir.isValid());
+
+    mOldCacheHome = qgetenv("XDG_CACHE_HOME");
+    qputenv("XDG_CACHE_HOME", QFile::encodeName(mDir.path() + QLatin1String("/cache")));
+}
+
+void TestParsedFileCache::init()
+{
+    QDir(mDir.path() + QLatin1String("/cache")).removeRecursively();
+    QDir(mDir.path() + QLatin1String("/sources")).removeRecursively();
+    QVERIFY(QDir().mkpath(mDir.path() + QLatin1String("/sources")));
+
+    writeSource(QLatin1String("a.manager"), "[ConnectionManager]\nName = a\n", 1000000000);
+    writeSource(QLatin1String("b.manager"), "[ConnectionManager]\nName = b\n", 1000000000);
+}
+
+void TestParsedFileCache::testRoundTrip()
+{
+    {
+        ParsedFileCache cache(QLatin1String("test"), 1);
+        QByteArray data;
+        QVERIFY(!cache.lookup(sourceFileName(QLatin1String("a.manager")), data));
+
+        cache.insert(sourceFileName(QLatin1String("a.manager")), "parsed a");
+        cache.insert(sourceFileName(QLatin1String("b.manager")), "parsed b");
+        QVERIFY(cache.lookup(sourceFileName(QLatin1String("a.manager")), data));
+        QCOMPARE(data, QByteArray("parsed a"));
+        cache.save();
+        QVERIFY(QFile::exists(cache.fileName()));
+    }
+
+    // Another process (or a later run) reads the entries back from the file
+    ParsedFileCache cache(QLatin1String("test"), 1);
+    QByteArray data;
+    QVERIFY(cache.lookup(sourceFileName(QLatin1String("a.manager")), data));
+    QCOMPARE(data, QByteArray("parsed a"));
+    QVERIFY(cache.lookup(sourceFileName(QLatin1String("b.manager")), data));
+    QCOMPARE(data, QByteArray("parsed b"));
+
+    // Only the cache file itself is left behind, no temporary files
+    QCOMPARE(QFileInfo(cache.fileName()).dir().entryList(QDir::Files),
+             QStringList() << QFileInfo(cache.fileName()).fileName());
+}
+
+void TestParsedFileCache::testStaleEntries()
+{
+    {
+        ParsedFileCache cache(QLatin1String("test"), 1);
+        cache.insert(sourceFileName(QLatin1String("a.manager")), "parsed a");
+        cache.insert(sourceFileName(QLatin1String("b.manager")), "parsed b");
+        cache.save();
+    }
+
+    // A different modification time invalidates the entry
+    setModificationTime(sourceFileName(QLatin1String("a.manager")), 1100000000);
+
+    // So does a different size, even with the same modification time
+    writeSource(QLatin1String("b.manager"), "[ConnectionManager]\nName = bb\n", 1000000000);
+
+    ParsedFileCache cache(QLatin1String("test"), 1);
+    QByteArray data;
+    QVERIFY(!cache.lookup(sourceFileName(QLatin1String("a.manager")), data));
+    QVERIFY(!cache.lookup(sourceFileName(QLatin1String("b.manager")), data));
+
+    // Entries of removed files are never found
+    cache.insert(sourceFileName(QLatin1String("a.manager")), "parsed a again");
+    QVERIFY(cache.lookup(sourceFileName(QLatin1String("a.manager")), data));
+    QVERIFY(QFile::remove(sourceFileName(QLatin1String("a.manager"))));
+    QVERIFY(!cache.lookup(sourceFileName(QLatin1String("a.manager")), data));
+}
+
+void TestParsedFileCache::testStaleDirectory()
+{
+    QString dirName = mDir.path() + QLatin1String("/sources");
+    QStringList fileNames = QStringList() << QLatin1String("a.manager") << QLatin1String("b.manager");
+    setModificationTime(dirName, 1000000000);
+
+    {
+        ParsedFileCache cache(QLatin1String("test"), 1);
+        cache.insertDirectory(dirName, fileNames);
+        cache.save();
+    }
+
+    {
+        ParsedFileCache cache(QLatin1String("test"), 1);
+        QStringList cached;
+        QVERIFY(cache.lookupDirectory(dirName, cached));
+        QCOMPARE(cached, fileNames);
+    }
+
+    // Adding a file changes the modification time of the directory
+    writeSource(QLatin1String("c.manager"), "[ConnectionManager]\nName = c\n", 1000000000);
+    setModificationTime(dirName, 1100000000);
+
+    ParsedFileCache cache(QLatin1String("test"), 1);
+    QStringList cached;
+    QVERIFY(!cache.lookupDirectory(dirName, cached));
+}
+
+void TestParsedFileCache::testCorruptFile()
+{
+    QString fileName;
+    {
+        ParsedFileCache cache(QLatin1String("test"), 1);
+        fileName = cache.fileName();
+    }
+
+    QVERIFY(QDir().mkpath(QFileInfo(fileName).absolutePath()));
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("this is not a cache file, just some garbage of a reasonable length");
+    file.close();
+
+    ParsedFileCache cache(QLatin1String("test"), 1);
+    QByteArray data;
+    QVERIFY(!cache.lookup(sourceFileName(QLatin1String("a.manager")), data));
+
+    // The broken file is replaced on the next save
+    cache.insert(sourceFileName(QLatin1String("a.manager")), "parsed a");
+    cache.save();
+
+    ParsedFileCache reloaded(QLatin1String("test"), 1);
+    QVERIFY(reloaded.lookup(sourceFileName(QLatin1String("a.manager")), data));
+    QCOMPARE(data, QByteArray("parsed a"));
+}
+
+void TestParsedFileCache::testTruncatedFile()
+{
+    QString fileName;
+    {
+        ParsedFileCache cache(QLatin1String("test"), 1);
+        fileName = cache.fileName();
+        cache.insert(sourceFileName(QLatin1String("a.manager")), QByteArray(1024, 'a'));
+        cache.insert(sourceFileName(QLatin1String("b.manager")), QByteArray(1024, 'b'));
+        cache.save();
+    }
+
+    QFile file(fileName);
+    qint64 size = file.size();
+    QVERIFY(size > 2048);
+    QVERIFY(file.resize(size - 512));
+
+    // A truncated index or entry makes the whole file be ignored
+    ParsedFileCache cache(QLatin1String("test"), 1);
+    QByteArray data;
+    QVERIFY(!cache.lookup(sourceFileName(QLatin1String("a.manager")), data));
+    QVERIFY(!cache.lookup(sourceFileName(QLatin1String("b.manager")), data));
+}
+
+void TestParsedFileCache::testVersionMismatch()
+{
+    {
+        ParsedFileCache cache(QLatin1String("test"), 1);
+        cache.insert(sourceFileName(QLatin1String("a.manager")), "parsed a with version 1");
+        cache.save();
+    }
+
+    // Entries written in another format are never handed out
+    {
+        ParsedFileCache cache(QLatin1String("test"), 2);
+        QByteArray data;
+        QVERIFY(!cache.lookup(sourceFileName(QLatin1String("a.manager")), data));
+
+        cache.insert(sourceFileName(QLatin1String("a.manager")), "parsed a with version 2");
+        cache.save();
+    }
+
+    ParsedFileCache oldCache(QLatin1String("test"), 1);
+    QByteArray data;
+    QVERIFY(!oldCache.lookup(sourceFileName(QLatin1String("a.manager")), data));
+
+    ParsedFileCache newCache(QLatin1String("test"), 2);
+    QVERIFY(newCache.lookup(sourceFileName(QLatin1String("a.manager")), data));
+    QCOMPARE(data, QByteArray("parsed a with version 2"));
+}
+
+void TestParsedFileCache::testSaveLater()
+{
+    ParsedFileCache cache(QLatin1String("test"), 1);
+
+    // Any number of changes are only written once control returns to the event loop
+    cache.insert(sourceFileName(QLatin1String("a.manager")), "parsed a");
+    cache.saveLater();
+    cache.insert(sourceFileName(QLatin1String("b.manager")), "parsed b");
+    cache.saveLater();
+    QVERIFY(!QFile::exists(cache.fileName()));
+
+    for (int i = 0; i < 100 && !QFile::exists(cache.fileName()); ++i) {
+        QTest::qWait(10);
+    }
+    QVERIFY(QFile::exists(cache.fileName()));
+
+    ParsedFileCache reloaded(QLatin1String("test"), 1);
+    QByteArray data;
+    QVERIFY(reloaded.lookup(sourceFileName(QLatin1String("a.manager")), data));
+    QCOMPARE(data, QByteArray("parsed a"));
+    QVERIFY(reloaded.lookup(sourceFileName(QLatin1String("b.manager")), data));
+    QCOMPARE(data, QByteArray("parsed b"));
+}
+
+void TestParsedFileCache::cleanupTestCase()
+{
+    if (mOldCacheHome.isEmpty()) {
+        qunsetenv("XDG_CACHE_HOME");
+    } else {
+        qputenv("XDG_CACHE_HOME", mOldCacheHome);
+    }
+}
+
+QTEST_MAIN(TestParsedFileCache)
+#include "_gen/parsed-file-cache.cpp.moc.hpp"
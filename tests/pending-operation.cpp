@@ -0,0 +1,141 @@
+#include <QtTest/QtTest>
+
+#include <TelepathyQt/Debug>
+#include <TelepathyQt/PendingSuccess>
+
+using namespace Tp;
+
+class TestPendingOperation : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestPendingOperation(QObject *parent = 0);
+
+protected Q_SLOTS:
+    void onFinished(Tp::PendingOperation *op);
+
+private Q_SLOTS:
+    void init();
+
+    void testFinishedIsAsync();
+    void testDeletedWhileQueued();
+    void testDeletedFromFinished();
+    void testDeletedAfterQueueReused();
+
+private:
+    QList<PendingOperation *> mFinished;
+    PendingOperation *mDeleteOnFinished;
+    int mRemaining;
+    QEventLoop *mLoop;
+};
+
+TestPendingOperation::TestPendingOperation(QObject *parent)
+    : QObject(parent),
+      mDeleteOnFinished(0),
+      mRemaining(0),
+      mLoop(new QEventLoop(this))
+{
+    Tp::enableDebug(false);
+    Tp::enableWarnings(true);
+}
+
+void TestPendingOperation::onFinished(Tp::PendingOperation *op)
+{
+    mFinished << op;
+    if (mDeleteOnFinished) {
+        delete mDeleteOnFinished;
+        mDeleteOnFinished = 0;
+    }
+    if (--mRemaining == 0) {
+        mLoop->exit(0);
+    }
+}
+
+void TestPendingOperation::init()
+{
+    mFinished.clear();
+    mDeleteOnFinished = 0;
+    mRemaining = 0;
+}
+
+void TestPendingOperation::testFinishedIsAsync()
+{
+    QList<PendingOperation *> ops;
+    for (int i = 0; i < 10; ++i) {
+        PendingOperation *op = new PendingSuccess(SharedPtr<RefCounted>());
+        QVERIFY(op->isFinished());
+        QVERIFY(connect(op, SIGNAL(finished(Tp::PendingOperation*)),
+                    SLOT(onFinished(Tp::PendingOperation*))));
+        ops << op;
+    }
+    QVERIFY(mFinished.isEmpty());
+
+    mRemaining = ops.size();
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mFinished, ops);
+}
+
+void TestPendingOperation::testDeletedWhileQueued()
+{
+    PendingOperation *deleted = new PendingSuccess(SharedPtr<RefCounted>());
+    PendingOperation *op = new PendingSuccess(SharedPtr<RefCounted>());
+    QVERIFY(connect(deleted, SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(onFinished(Tp::PendingOperation*))));
+    QVERIFY(connect(op, SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(onFinished(Tp::PendingOperation*))));
+    delete deleted;
+
+    mRemaining = 1;
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mFinished, QList<PendingOperation *>() << op);
+}
+
+void TestPendingOperation::testDeletedFromFinished()
+{
+    // Operations queued behind the one finishing can still be cancelled
+    PendingOperation *op = new PendingSuccess(SharedPtr<RefCounted>());
+    PendingOperation *deleted = new PendingSuccess(SharedPtr<RefCounted>());
+    PendingOperation *last = new PendingSuccess(SharedPtr<RefCounted>());
+    QVERIFY(connect(op, SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(onFinished(Tp::PendingOperation*))));
+    QVERIFY(connect(deleted, SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(onFinished(Tp::PendingOperation*))));
+    QVERIFY(connect(last, SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(onFinished(Tp::PendingOperation*))));
+    mDeleteOnFinished = deleted;
+
+    mRemaining = 2;
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mFinished, QList<PendingOperation *>() << op << last);
+    QVERIFY(!mDeleteOnFinished);
+}
+
+void TestPendingOperation::testDeletedAfterQueueReused()
+{
+    // Dispatch a first batch so the queue is emptied and starts over
+    for (int i = 0; i < 10; ++i) {
+        PendingOperation *op = new PendingSuccess(SharedPtr<RefCounted>());
+        QVERIFY(connect(op, SIGNAL(finished(Tp::PendingOperation*)),
+                    SLOT(onFinished(Tp::PendingOperation*))));
+    }
+    mRemaining = 10;
+    QCOMPARE(mLoop->exec(), 0);
+    mFinished.clear();
+
+    PendingOperation *deleted = new PendingSuccess(SharedPtr<RefCounted>());
+    PendingOperation *op = new PendingSuccess(SharedPtr<RefCounted>());
+    QVERIFY(connect(deleted, SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(onFinished(Tp::PendingOperation*))));
+    QVERIFY(connect(op, SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(onFinished(Tp::PendingOperation*))));
+    delete deleted;
+
+    mRemaining = 1;
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mFinished, QList<PendingOperation *>() << op);
+}
+
+QTEST_MAIN(TestPendingOperation)
+
+#include "_gen/pending-operation.cpp.moc.hpp"
@@ -3,6 +3,8 @@
 #include <TelepathyQt/Debug>
 #include <TelepathyQt/Profile>
 
+#include <QTemporaryDir>
+
 using namespace Tp;
 
 class TestProfile : public QObject
@@ -13,7 +15,15 @@ public:
     TestProfile(QObject *parent = 0);
 
 private Q_SLOTS:
+    void initTestCase();
+
     void testProfile();
+
+    void cleanupTestCase();
+
+private:
+    QTemporaryDir mCacheDir;
+    QByteArray mOldCacheHome;
 };
 
 TestProfile::TestProfile(QObject *parent)
@@ -23,6 +33,14 @@ TestProfile::TestProfile(QObject *parent)
     Tp::enableWarnings(true);
 }
 
+void TestProfile::initTestCase()
+{
+    // Keep the parsed file cache out of the user's cache directory
+    QVERIFY(mCacheDir.isValid());
+    mOldCacheHome = qgetenv("XDG_CACHE_HOME");
+    qputenv("XDG_CACHE_HOME", QFile::encodeName(mCacheDir.path()));
+}
+
 void TestProfile::testProfile()
 {
     QString top_srcdir = QString::fromLocal8Bit(::getenv("abs_top_srcdir"));
@@ -42,6 +60,29 @@ void TestProfile::testProfile()
     profile = Profile::createForServiceName(QLatin1String("test-profile-non-im-type"));
     QCOMPARE(profile->isValid(), false);
 
+    // Only the header is read up front, and a broken section doesn't take it away
+    profile = Profile::createForServiceName(QLatin1String("test-profile-malformed-parameters"));
+    QCOMPARE(profile->isValid(), true);
+    QCOMPARE(profile->name(), QLatin1String("TestProfileMalformedParameters"));
+    QVERIFY(profile->parameters().isEmpty());
+    QVERIFY(!profile->hasParameter(QLatin1String("server")));
+    QCOMPARE(profile->isValid(), true);
+    QCOMPARE(profile->name(), QLatin1String("TestProfileMalformedParameters"));
+    QCOMPARE(profile->cmName(), QLatin1String("testprofilecm"));
+
+    // The same goes when the header comes from the parsed file cache
+    profile = Profile::createForServiceName(QLatin1String("test-profile-malformed-parameters"));
+    QCOMPARE(profile->isValid(), true);
+    QVERIFY(profile->parameters().isEmpty());
+    QCOMPARE(profile->name(), QLatin1String("TestProfileMalformedParameters"));
+
+    // and when the sections are read before checking the validity
+    profile = Profile::createForFileName(
+            QLatin1String("telepathy/profiles/test-profile-malformed-parameters.profile"));
+    QVERIFY(profile->parameters().isEmpty());
+    QCOMPARE(profile->isValid(), true);
+    QCOMPARE(profile->serviceName(), QLatin1String("test-profile-malformed-parameters"));
+
     profile = Profile::createForFileName(QLatin1String("telepathy/profiles/test-profile-non-im-type.profile"));
     QCOMPARE(profile->isValid(), true);
 
@@ -130,6 +171,18 @@ void TestProfile::testProfile()
     QCOMPARE(profile->iconName().isEmpty(), true);
 }
 
+void TestProfile::cleanupTestCase()
+{
+    // Let the deferred cache save run while the directory is still there
+    QCoreApplication::processEvents();
+
+    if (mOldCacheHome.isEmpty()) {
+        qunsetenv("XDG_CACHE_HOME");
+    } else {
+        qputenv("XDG_CACHE_HOME", mOldCacheHome);
+    }
+}
+
 QTEST_MAIN(TestProfile)
 
 #include "_gen/profile.cpp.moc.hpp"
@@ -0,0 +1,210 @@
+#include <QtTest/QtTest>
+
+#include <TelepathyQt/Debug>
+#include <TelepathyQt/Profile>
+#include "TelepathyQt/shared-data-registry-internal.h"
+#include <TelepathyQt/test-backdoors.h>
+
+#include <QTemporaryDir>
+
+#include <utime.h>
+
+using namespace Tp;
+
+namespace
+{
+
+// The registry is not exported, so it is driven through the test backdoors
+class Registry
+{
+public:
+    Registry(int recheckInterval = SharedDataRegistry::DefaultRecheckInterval)
+        : mRegistry(TestBackdoors::createSharedDataRegistry(recheckInterval))
+    {
+    }
+
+    ~Registry()
+    {
+        TestBackdoors::destroySharedDataRegistry(mRegistry);
+    }
+
+    ProfilePtr profile(const QString &serviceName)
+    {
+        return TestBackdoors::sharedDataRegistryProfile(mRegistry, serviceName);
+    }
+
+    int size() const
+    {
+        return TestBackdoors::sharedDataRegistrySize(mRegistry);
+    }
+
+private:
+    Q_DISABLE_COPY(Registry)
+
+    SharedDataRegistry *mRegistry;
+};
+
+}
+
+class TestSharedDataRegistry : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestSharedDataRegistry(QObject *parent = 0);
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void testProfileReused();
+    void testProfileDropped();
+    void testProfileFileChanged();
+
+    void cleanupTestCase();
+
+private:
+    QString profileFileName(const QString &serviceName) const;
+    void writeProfile(const QString &serviceName, const QString &name, time_t mtime);
+
+    QTemporaryDir mDir;
+    QByteArray mOldDataHome;
+    QByteArray mOldDataDirs;
+    QByteArray mOldCacheHome;
+};
+
+TestSharedDataRegistry::TestSharedDataRegistry(QObject *parent)
+    : QObject(parent)
+{
+    Tp::enableDebug(true);
+    Tp::enableWarnings(true);
+}
+
+QString TestSharedDataRegistry::profileFileName(const QString &serviceName) const
+{
+    return mDir.path() + QLatin1String("/data/telepathy/profiles/") + serviceName +
+        QLatin1String(".profile");
+}
+
+void TestSharedDataRegistry::writeProfile(const QString &serviceName, const QString &name,
+        time_t mtime)
+{
+    QFile file(profileFileName(serviceName));
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(QString(QLatin1String(
+        "<service xmlns=\"http://telepathy.freedesktop.org/wiki/service-profile-v1\"\n"
+        "         id=\"%1\" type=\"IM\" manager=\"sharedcm\" protocol=\"sharedproto\">\n"
+        "  <name>%2</name>\n"
+        "</service>\n")).arg(serviceName, name).toUtf8());
+    file.close();
+
+    // Don't rely on the file system having a fine-grained modification time
+    struct utimbuf times;
+    times.actime = mtime;
+    times.modtime = mtime;
+    QCOMPARE(::utime(QFile::encodeName(file.fileName()).constData(), &times), 0);
+}
+
+void TestSharedDataRegistry::initTestCase()
+{
+    QVERIFY(mDir.isValid());
+    QVERIFY(QDir().mkpath(mDir.path() + QLatin1String("/data/telepathy/profiles")));
+
+    // Only see the profiles written by this test, and keep the parsed file cache out of $HOME
+    mOldDataHome = qgetenv("XDG_DATA_HOME");
+    mOldDataDirs = qgetenv("XDG_DATA_DIRS");
+    mOldCacheHome = qgetenv("XDG_CACHE_HOME");
+    qputenv("XDG_DATA_HOME", QFile::encodeName(mDir.path() + QLatin1String("/data")));
+    qputenv("XDG_DATA_DIRS", QFile::encodeName(mDir.path() + QLatin1String("/none")));
+    qputenv("XDG_CACHE_HOME", QFile::encodeName(mDir.path() + QLatin1String("/cache")));
+
+    writeProfile(QLatin1String("shared"), QLatin1String("Shared"), 1000000000);
+}
+
+void TestSharedDataRegistry::testProfileReused()
+{
+    Registry registry;
+
+    ProfilePtr profile = registry.profile(QLatin1String("shared"));
+    QVERIFY(profile->isValid());
+    QCOMPARE(profile->name(), QLatin1String("Shared"));
+    QCOMPARE(registry.size(), 1);
+
+    // Every user of the same service gets the same object while it is alive
+    QCOMPARE(registry.profile(QLatin1String("shared")).data(), profile.data());
+    QCOMPARE(registry.profile(QLatin1String("shared")).data(), profile.data());
+    QCOMPARE(registry.size(), 1);
+
+    // Services without a .profile file are not remembered
+    ProfilePtr missing = registry.profile(QLatin1String("missing"));
+    QVERIFY(!missing->isValid());
+    QCOMPARE(registry.size(), 1);
+}
+
+void TestSharedDataRegistry::testProfileDropped()
+{
+    Registry registry;
+
+    ProfilePtr profile = registry.profile(QLatin1String("shared"));
+    QVERIFY(profile->isValid());
+    QCOMPARE(registry.size(), 1);
+
+    // The registry only holds a weak reference, so the profile goes away with its last user
+    WeakPtr<Profile> weakProfile(profile);
+    profile.reset();
+    QVERIFY(ProfilePtr(weakProfile).isNull());
+
+    // The expired entry is dropped on the next lookup, for whichever service
+    registry.profile(QLatin1String("missing"));
+    QCOMPARE(registry.size(), 0);
+
+    profile = registry.profile(QLatin1String("shared"));
+    QVERIFY(profile->isValid());
+    QCOMPARE(profile->name(), QLatin1String("Shared"));
+    QCOMPARE(registry.size(), 1);
+}
+
+void TestSharedDataRegistry::testProfileFileChanged()
+{
+    Registry trustingRegistry(60 * 60 * 1000);
+    Registry checkingRegistry(0);
+
+    ProfilePtr trusted = trustingRegistry.profile(QLatin1String("shared"));
+    ProfilePtr checked = checkingRegistry.profile(QLatin1String("shared"));
+    QCOMPARE(trusted->name(), QLatin1String("Shared"));
+    QCOMPARE(checked->name(), QLatin1String("Shared"));
+
+    writeProfile(QLatin1String("shared"), QLatin1String("Shared again"), 1100000000);
+
+    // Within the recheck interval the cached modification time is trusted
+    QCOMPARE(trustingRegistry.profile(QLatin1String("shared")).data(), trusted.data());
+
+    // Once it is due, the changed file is noticed and parsed again
+    ProfilePtr reloaded = checkingRegistry.profile(QLatin1String("shared"));
+    QVERIFY(reloaded.data() != checked.data());
+    QVERIFY(reloaded->isValid());
+    QCOMPARE(reloaded->name(), QLatin1String("Shared again"));
+    QCOMPARE(checkingRegistry.size(), 1);
+
+    // Unchanged files keep being shared after a recheck
+    QCOMPARE(checkingRegistry.profile(QLatin1String("shared")).data(), reloaded.data());
+
+    writeProfile(QLatin1String("shared"), QLatin1String("Shared"), 1000000000);
+}
+
+void TestSharedDataRegistry::cleanupTestCase()
+{
+    QList<QPair<const char *, QByteArray> > vars;
+    vars << qMakePair("XDG_DATA_HOME", mOldDataHome)
+         << qMakePair("XDG_DATA_DIRS", mOldDataDirs)
+         << qMakePair("XDG_CACHE_HOME", mOldCacheHome);
+    for (int i = 0; i < vars.size(); ++i) {
+        if (vars[i].second.isEmpty()) {
+            qunsetenv(vars[i].first);
+        } else {
+            qputenv(vars[i].first, vars[i].second);
+        }
+    }
+}
+
+QTEST_MAIN(TestSharedDataRegistry)
+#include "_gen/shared-data-registry.cpp.moc.hpp"
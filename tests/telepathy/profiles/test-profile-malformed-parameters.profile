@@ -0,0 +1,13 @@
+<service xmlns="http://telepathy.freedesktop.org/wiki/service-profile-v1"
+         id="test-profile-malformed-parameters"
+         type="IM"
+         provider="TestProfileProvider"
+         manager="testprofilecm"
+         protocol="testprofileproto">
+  <name>TestProfileMalformedParameters</name>
+
+  <parameters>
+    <parameter name="server" type="s" mandatory="1">profile.com</parameter>
+    <parameter type="u" mandatory="1">1111</parameter>
+  </parameters>
+</service>
@@ -115,6 +115,8 @@ class Generator(object):
             self.extraincludes = opts.get('--extraincludes', None)
             self.must_define = opts.get('--must-define', None)
             self.visibility = opts.get('--visibility', '')
+            self.fast_marshallers = [name for name in
+                    opts.get('--fast-marshallers', '').split(',') if name]
             dom = xml.dom.minidom.parse(opts['--specxml'])
         except KeyError, k:
             assert False, 'Missing required parameter %s' % k.args[0]
@@ -405,6 +407,9 @@ TP_QT_NO_EXPORT void _registerTypes()
         if self.required_custom:
             raise MissingTypes(self.required_custom)
 
+        assert not self.fast_marshallers, \
+            'No mapping or array type to specialize named %s' % ', '.join(self.fast_marshallers)
+
     def provide(self, type):
         if type in self.required_custom:
             self.required_custom.remove(type)
@@ -524,6 +529,10 @@ struct %(visibility)s %(name)s
  */
 """ % (depinfo.binding.val, get_headerfile_cmd(self.realinclude, self.prettyinclude), realtype, format_docstring(depinfo.el, self.refs)))
             self.decl(self.faketype(depinfo.binding.val, realtype, init_list_type))
+
+            if depinfo.binding.val in self.fast_marshallers:
+                self.fast_marshallers.remove(depinfo.binding.val)
+                self.fast_map_demarshaller(depinfo.binding.val, bindings[0].val, bindings[1].val)
         else:
             raise WTF(depinfo.el.localName)
 
@@ -542,6 +551,10 @@ typedef %s %s;
 
 """ % (get_headerfile_cmd(self.realinclude, self.prettyinclude), depinfo.binding.val, 'QList<%s>' % depinfo.binding.val, depinfo.binding.array_val))
 
+            if depinfo.binding.array_val in self.fast_marshallers:
+                self.fast_marshallers.remove(depinfo.binding.array_val)
+                self.fast_list_demarshaller(depinfo.binding.array_val, depinfo.binding.val)
+
         i = depinfo.binding.array_depth
         while i > 1:
             i -= 1
@@ -558,6 +571,57 @@ typedef QList<%s> %sList;
 
 """ % (get_headerfile_cmd(self.realinclude, self.prettyinclude), list_of, list_of, list_of))
 
+    # The demarshallers QtDBus provides for QMap and QList read each entry into
+    # a temporary which is then copied into the container, and QMap ones do a
+    # full tree lookup per entry. The specialized ones below are emitted for
+    # the types given with --fast-marshallers, and read the entries in place,
+    # inserting map entries with an end hint as D-Bus peers usually send them
+    # in key order. They are plain overloads, so they take precedence over the
+    # QtDBus templates wherever the type is (de)marshalled.
+    def fast_map_demarshaller(self, name, key, value):
+        self.both('%s const QDBusArgument& operator>>(const QDBusArgument& arg, %s &map)' %
+                (self.visibility, name))
+        self.decl(';\n\n')
+        self.impl("""
+{
+    arg.beginMap();
+    map.clear();
+    while (!arg.atEnd()) {
+        arg.beginMapEntry();
+        %(key)s key;
+        arg >> key;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 1, 0)
+        %(name)s::iterator it = map.insert(map.constEnd(), key, %(value)s());
+#else
+        %(name)s::iterator it = map.insert(key, %(value)s());
+#endif
+        arg >> it.value();
+        arg.endMapEntry();
+    }
+    arg.endMap();
+    return arg;
+}
+
+""" % {'name': name, 'key': key, 'value': value})
+
+    def fast_list_demarshaller(self, name, element):
+        self.both('%s const QDBusArgument& operator>>(const QDBusArgument& arg, %s &list)' %
+                (self.visibility, name))
+        self.decl(';\n\n')
+        self.impl("""
+{
+    arg.beginArray();
+    list.clear();
+    while (!arg.atEnd()) {
+        list.append(%s());
+        arg >> list.last();
+    }
+    arg.endArray();
+    return arg;
+}
+
+""" % element)
+
     def faketype(self, fake, real, init_list_type):
         return """\
 struct %(visibility)s %(fake)s : public %(real)s
@@ -586,6 +650,7 @@ if __name__ == '__main__':
              'namespace=',
              'specxml=',
              'visibility=',
+             'fast-marshallers=',
              ])
 
     try: